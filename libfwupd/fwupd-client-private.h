@@ -19,6 +19,15 @@ fwupd_client_download_bytes2_async(FwupdClient *self,
 				   GCancellable *cancellable,
 				   GAsyncReadyCallback callback,
 				   gpointer callback_data);
+void
+fwupd_client_download_bytes_cached_async(FwupdClient *self,
+					 GPtrArray *urls,
+					 FwupdClientDownloadFlags flags,
+					 const gchar *checksum,
+					 gchar **mirror_uris,
+					 GCancellable *cancellable,
+					 GAsyncReadyCallback callback,
+					 gpointer callback_data);
 
 #ifdef HAVE_GIO_UNIX
 void
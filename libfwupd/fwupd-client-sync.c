@@ -951,7 +951,10 @@ fwupd_client_get_host_security_events_cb(GObject *source, GAsyncResult *res, gpo
  * @cancellable: (nullable): optional #GCancellable
  * @error: (nullable): optional return location for an error
  *
- * Gets all the host security events from the daemon.
+ * Gets all the host security events from the daemon, newest first.
+ *
+ * Since 1.8.0 @limit counts changed attributes rather than the boots where the attributes were
+ * recorded. Use fwupd_client_get_host_security_events_full() to get later pages.
  *
  * Returns: (element-type FwupdSecurityAttr) (transfer container): attributes
  *
@@ -988,6 +991,66 @@ fwupd_client_get_host_security_events(FwupdClient *self,
 	return g_steal_pointer(&helper->array);
 }
 
+static void
+fwupd_client_get_host_security_events_full_cb(GObject *source,
+					      GAsyncResult *res,
+					      gpointer user_data)
+{
+	FwupdClientHelper *helper = (FwupdClientHelper *)user_data;
+	helper->array = fwupd_client_get_host_security_events_full_finish(FWUPD_CLIENT(source),
+									  res,
+									  &helper->error);
+	g_main_loop_quit(helper->loop);
+}
+
+/**
+ * fwupd_client_get_host_security_events_full:
+ * @self: a #FwupdClient
+ * @limit: maximum number of events, or 0 for no limit
+ * @offset: number of newer events to skip
+ * @cancellable: (nullable): optional #GCancellable
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets a page of the host security events from the daemon, newest first.
+ *
+ * Returns: (element-type FwupdSecurityAttr) (transfer container): attributes
+ *
+ * Since: 1.8.0
+ **/
+GPtrArray *
+fwupd_client_get_host_security_events_full(FwupdClient *self,
+					   guint limit,
+					   guint offset,
+					   GCancellable *cancellable,
+					   GError **error)
+{
+	g_autoptr(FwupdClientHelper) helper = NULL;
+
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* connect */
+	if (!fwupd_client_connect(self, cancellable, error))
+		return NULL;
+
+	/* call async version and run loop until complete */
+	helper = fwupd_client_helper_new(self);
+	fwupd_client_get_host_security_events_full_async(
+	    self,
+	    limit,
+	    offset,
+	    cancellable,
+	    fwupd_client_get_host_security_events_full_cb,
+	    helper);
+	g_main_loop_run(helper->loop);
+	if (helper->array == NULL) {
+		g_propagate_error(error, g_steal_pointer(&helper->error));
+		return NULL;
+	}
+	return g_steal_pointer(&helper->array);
+}
+
 static void
 fwupd_client_get_device_by_id_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
@@ -1532,6 +1595,57 @@ fwupd_client_refresh_remote(FwupdClient *self,
 	return TRUE;
 }
 
+static void
+fwupd_client_refresh_remotes_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FwupdClientHelper *helper = (FwupdClientHelper *)user_data;
+	helper->ret =
+	    fwupd_client_refresh_remotes_finish(FWUPD_CLIENT(source), res, &helper->error);
+	g_main_loop_quit(helper->loop);
+}
+
+/**
+ * fwupd_client_refresh_remotes:
+ * @self: a #FwupdClient
+ * @remotes: (element-type FwupdRemote): remotes to refresh
+ * @cancellable: (nullable): optional #GCancellable
+ * @error: (nullable): optional return location for an error
+ *
+ * Refreshes several remotes by downloading new metadata, with some of the downloads running at
+ * the same time.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fwupd_client_refresh_remotes(FwupdClient *self,
+			     GPtrArray *remotes,
+			     GCancellable *cancellable,
+			     GError **error)
+{
+	g_autoptr(FwupdClientHelper) helper = NULL;
+
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), FALSE);
+	g_return_val_if_fail(remotes != NULL, FALSE);
+	g_return_val_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* call async version and run loop until complete */
+	helper = fwupd_client_helper_new(self);
+	fwupd_client_refresh_remotes_async(self,
+					   remotes,
+					   cancellable,
+					   fwupd_client_refresh_remotes_cb,
+					   helper);
+	g_main_loop_run(helper->loop);
+	if (!helper->ret) {
+		g_propagate_error(error, g_steal_pointer(&helper->error));
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static void
 fwupd_client_modify_remote_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
@@ -1643,6 +1757,54 @@ fwupd_client_get_report_metadata(FwupdClient *self, GCancellable *cancellable, G
 	return g_steal_pointer(&helper->hash);
 }
 
+static void
+fwupd_client_get_statistics_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FwupdClientHelper *helper = (FwupdClientHelper *)user_data;
+	helper->array =
+	    fwupd_client_get_statistics_finish(FWUPD_CLIENT(source), res, &helper->error);
+	g_main_loop_quit(helper->loop);
+}
+
+/**
+ * fwupd_client_get_statistics:
+ * @self: a #FwupdClient
+ * @cancellable: (nullable): optional #GCancellable
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the runtime statistics collected by the daemon.
+ *
+ * Returns: (element-type FwupdStatistic) (transfer container): statistics
+ *
+ * Since: 1.8.0
+ **/
+GPtrArray *
+fwupd_client_get_statistics(FwupdClient *self, GCancellable *cancellable, GError **error)
+{
+	g_autoptr(FwupdClientHelper) helper = NULL;
+
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* connect */
+	if (!fwupd_client_connect(self, cancellable, error))
+		return NULL;
+
+	/* call async version and run loop until complete */
+	helper = fwupd_client_helper_new(self);
+	fwupd_client_get_statistics_async(self,
+					  cancellable,
+					  fwupd_client_get_statistics_cb,
+					  helper);
+	g_main_loop_run(helper->loop);
+	if (helper->array == NULL) {
+		g_propagate_error(error, g_steal_pointer(&helper->error));
+		return NULL;
+	}
+	return g_steal_pointer(&helper->array);
+}
+
 static void
 fwupd_client_modify_device_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
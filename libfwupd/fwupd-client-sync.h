@@ -96,6 +96,12 @@ fwupd_client_get_host_security_events(FwupdClient *self,
 				      guint limit,
 				      GCancellable *cancellable,
 				      GError **error) G_GNUC_WARN_UNUSED_RESULT;
+GPtrArray *
+fwupd_client_get_host_security_events_full(FwupdClient *self,
+					   guint limit,
+					   guint offset,
+					   GCancellable *cancellable,
+					   GError **error) G_GNUC_WARN_UNUSED_RESULT;
 FwupdDevice *
 fwupd_client_get_device_by_id(FwupdClient *self,
 			      const gchar *device_id,
@@ -155,6 +161,11 @@ fwupd_client_refresh_remote(FwupdClient *self,
 			    GCancellable *cancellable,
 			    GError **error) G_GNUC_WARN_UNUSED_RESULT;
 gboolean
+fwupd_client_refresh_remotes(FwupdClient *self,
+			     GPtrArray *remotes,
+			     GCancellable *cancellable,
+			     GError **error) G_GNUC_WARN_UNUSED_RESULT;
+gboolean
 fwupd_client_modify_remote(FwupdClient *self,
 			   const gchar *remote_id,
 			   const gchar *key,
@@ -173,6 +184,10 @@ fwupd_client_get_report_metadata(FwupdClient *self,
 				 GCancellable *cancellable,
 				 GError **error) G_GNUC_WARN_UNUSED_RESULT;
 GPtrArray *
+fwupd_client_get_statistics(FwupdClient *self,
+			    GCancellable *cancellable,
+			    GError **error) G_GNUC_WARN_UNUSED_RESULT;
+GPtrArray *
 fwupd_client_get_remotes(FwupdClient *self,
 			 GCancellable *cancellable,
 			 GError **error) G_GNUC_WARN_UNUSED_RESULT;
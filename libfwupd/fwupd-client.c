@@ -8,6 +8,7 @@
 
 #include <gio/gio.h>
 #include <glib-object.h>
+#include <glib/gstdio.h>
 #include <gmodule.h>
 #ifdef HAVE_LIBCURL
 #include <curl/curl.h>
@@ -16,16 +17,20 @@
 #include <gio/gunixfdlist.h>
 #endif
 
+#include <errno.h>
 #include <fcntl.h>
+#include <jcat.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include "fwupd-client-private.h"
 #include "fwupd-client-sync.h"
 #include "fwupd-common-private.h"
 #include "fwupd-deprecated.h"
 #include "fwupd-device-private.h"
+#include "fwupd-enums-private.h"
 #include "fwupd-enums.h"
 #include "fwupd-error.h"
 #include "fwupd-plugin-private.h"
@@ -33,14 +38,41 @@
 #include "fwupd-remote-private.h"
 #include "fwupd-request-private.h"
 #include "fwupd-security-attr-private.h"
+#include "fwupd-statistic-private.h"
 
 static void
 fwupd_client_fixup_dbus_error(GError *error);
+static void
+fwupd_client_download_metadata_delta_async(FwupdClient *self,
+					   FwupdRemote *remote,
+					   GBytes *signature,
+					   GCancellable *cancellable,
+					   GAsyncReadyCallback callback,
+					   gpointer callback_data);
+static GBytes *
+fwupd_client_download_metadata_delta_finish(FwupdClient *self,
+					    GAsyncResult *res,
+					    GError **error);
 
 typedef GObject *(*FwupdClientObjectNewFunc)(void);
 
 #define FWUPD_CLIENT_DBUS_PROXY_TIMEOUT 180000 /* ms */
 
+/* the maximum depth of the device tree kept in the device cache */
+#define FWUPD_CLIENT_DEVICE_CACHE_DEPTH_MAX 16
+
+/* the number of remotes to refresh at the same time */
+#define FWUPD_CLIENT_REFRESH_REMOTES_MAX 4
+
+/* servers on the local network either answer quickly or not at all */
+#define FWUPD_CLIENT_MIRROR_CONNECT_TIMEOUT 2L /* s */
+
+/* the least recently used downloads are deleted when the cache is larger than this */
+#define FWUPD_CLIENT_DOWNLOAD_CACHE_SIZE_MAX (256 * 1024 * 1024) /* bytes */
+
+/* idle sessions kept so that later downloads can reuse their open connections */
+#define FWUPD_CLIENT_CURL_POOL_MAX FWUPD_CLIENT_REFRESH_REMOTES_MAX
+
 /**
  * FwupdClient:
  *
@@ -58,6 +90,8 @@ typedef struct {
 	gboolean tainted;
 	gboolean interactive;
 	guint percentage;
+	guint eta;
+	guint64 throughput;
 	GMutex idle_mutex; /* for @idle_id and @idle_sources */
 	guint idle_id;
 	GPtrArray *idle_sources; /* element-type FwupdClientContextHelper */
@@ -71,19 +105,51 @@ typedef struct {
 	GDBusProxy *proxy;
 	GProxyResolver *proxy_resolver;
 	gchar *user_agent;
+	gchar *download_cache_dir; /* (nullable) */
+	guint64 download_cache_size_max;
 	GHashTable *hints; /* str:str */
+	GMutex device_cache_mutex; /* for @device_cache_* */
+	gboolean device_cache_enabled;
+	GPtrArray *device_cache; /* (nullable) (element-type FwupdClientDeviceCacheItem) */
+	GHashTable *device_cache_by_id; /* (nullable) str:FwupdClientDeviceCacheItem */
+	guint64 device_cache_generation;
+#ifdef HAVE_LIBCURL
+	CURLSH *curlsh; /* DNS cache and TLS sessions shared by all downloads */
+	GMutex curlsh_mutexes[CURL_LOCK_DATA_LAST];
+	GMutex transfers_mutex; /* for @transfers, @transfers_done_* and @curl_pool */
+	GPtrArray *transfers;	/* element-type FwupdCurlHelper */
+	curl_off_t transfers_done_now;
+	curl_off_t transfers_done_total;
+	GPtrArray *curl_pool; /* element-type CURL, idle sessions with open connections */
+#endif
 #ifdef SOUP_SESSION_COMPAT
 	GObject *soup_session;
 	GModule *soup_module; /* we leak this */
 #endif
 } FwupdClientPrivate;
 
+/* the IDs are read from @value so that the cached devices do not have to be decoded */
+typedef struct {
+	gchar *id;
+	gchar *parent_id; /* (nullable) */
+	GVariant *value;  /* a{sv} */
+	FwupdDevice *device;
+} FwupdClientDeviceCacheItem;
+
 #ifdef HAVE_LIBCURL
 typedef struct {
 	GPtrArray *urls;
 	CURL *curl;
 	curl_mime *mime;
 	struct curl_slist *headers;
+	gchar *checksum;  /* (nullable): expected checksum of the download */
+	gchar *cache_dir; /* (nullable) */
+	gchar *cache_fn;  /* (nullable) */
+	guint64 cache_size_max;
+	guint mirror_cnt; /* the first URLs are servers on the local network */
+	FwupdClient *self;
+	curl_off_t now;	  /* bytes transferred, protected by the transfers_mutex */
+	curl_off_t total; /* bytes expected, or 0 for unknown */
 } FwupdCurlHelper;
 #endif
 
@@ -110,6 +176,8 @@ enum {
 	PROP_HOST_BKC,
 	PROP_INTERACTIVE,
 	PROP_ONLY_TRUSTED,
+	PROP_ETA,
+	PROP_THROUGHPUT,
 	PROP_LAST
 };
 
@@ -126,6 +194,28 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC(CURLU, curl_url_cleanup)
 static void
 fwupd_client_curl_helper_free(FwupdCurlHelper *helper)
 {
+	if (helper->self != NULL) {
+		FwupdClientPrivate *priv = GET_PRIVATE(helper->self);
+		g_mutex_lock(&priv->transfers_mutex);
+		g_ptr_array_remove(priv->transfers, helper);
+
+		/* keep the session so the next download can reuse the connection */
+		if (helper->curl != NULL && priv->curl_pool->len < FWUPD_CLIENT_CURL_POOL_MAX) {
+			curl_easy_reset(helper->curl);
+			g_ptr_array_add(priv->curl_pool, g_steal_pointer(&helper->curl));
+		}
+
+		/* finished transfers still count until all the concurrent ones are done */
+		if (priv->transfers->len == 0) {
+			priv->transfers_done_now = 0;
+			priv->transfers_done_total = 0;
+		} else if (helper->total > 0) {
+			priv->transfers_done_now += helper->total;
+			priv->transfers_done_total += helper->total;
+		}
+		g_mutex_unlock(&priv->transfers_mutex);
+		g_object_unref(helper->self);
+	}
 	if (helper->curl != NULL)
 		curl_easy_cleanup(helper->curl);
 	if (helper->mime != NULL)
@@ -134,6 +224,9 @@ fwupd_client_curl_helper_free(FwupdCurlHelper *helper)
 		curl_slist_free_all(helper->headers);
 	if (helper->urls != NULL)
 		g_ptr_array_unref(helper->urls);
+	g_free(helper->checksum);
+	g_free(helper->cache_dir);
+	g_free(helper->cache_fn);
 	g_free(helper);
 }
 
@@ -355,6 +448,26 @@ fwupd_client_set_percentage(FwupdClient *self, guint percentage)
 	fwupd_client_object_notify(self, "percentage");
 }
 
+static void
+fwupd_client_set_eta(FwupdClient *self, guint eta)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	if (priv->eta == eta)
+		return;
+	priv->eta = eta;
+	fwupd_client_object_notify(self, "eta");
+}
+
+static void
+fwupd_client_set_throughput(FwupdClient *self, guint64 throughput)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	if (priv->throughput == throughput)
+		return;
+	priv->throughput = throughput;
+	fwupd_client_object_notify(self, "throughput");
+}
+
 static void
 fwupd_client_properties_changed_cb(GDBusProxy *proxy,
 				   GVariant *changed_properties,
@@ -394,6 +507,18 @@ fwupd_client_properties_changed_cb(GDBusProxy *proxy,
 		if (val != NULL)
 			fwupd_client_set_percentage(self, g_variant_get_uint32(val));
 	}
+	if (g_variant_dict_contains(dict, "Eta")) {
+		g_autoptr(GVariant) val = NULL;
+		val = g_dbus_proxy_get_cached_property(proxy, "Eta");
+		if (val != NULL)
+			fwupd_client_set_eta(self, g_variant_get_uint32(val));
+	}
+	if (g_variant_dict_contains(dict, "Throughput")) {
+		g_autoptr(GVariant) val = NULL;
+		val = g_dbus_proxy_get_cached_property(proxy, "Throughput");
+		if (val != NULL)
+			fwupd_client_set_throughput(self, g_variant_get_uint64(val));
+	}
 	if (g_variant_dict_contains(dict, "DaemonVersion")) {
 		g_autoptr(GVariant) val = NULL;
 		val = g_dbus_proxy_get_cached_property(proxy, "DaemonVersion");
@@ -433,6 +558,238 @@ fwupd_client_properties_changed_cb(GDBusProxy *proxy,
 	}
 }
 
+static void
+fwupd_client_device_cache_item_free(FwupdClientDeviceCacheItem *item)
+{
+	g_free(item->id);
+	g_free(item->parent_id);
+	g_variant_unref(item->value);
+	g_object_unref(item->device);
+	g_free(item);
+}
+
+static FwupdClientDeviceCacheItem *
+fwupd_client_device_cache_item_new(GVariant *value)
+{
+	FwupdClientDeviceCacheItem *item;
+	const gchar *id = NULL;
+	const gchar *parent_id = NULL;
+
+	if (!g_variant_lookup(value, FWUPD_RESULT_KEY_DEVICE_ID, "&s", &id))
+		return NULL;
+	g_variant_lookup(value, FWUPD_RESULT_KEY_PARENT_DEVICE_ID, "&s", &parent_id);
+	item = g_new0(FwupdClientDeviceCacheItem, 1);
+	item->id = g_strdup(id);
+	item->parent_id = g_strdup(parent_id);
+	item->value = g_variant_ref_sink(value);
+	item->device = fwupd_device_from_variant(value);
+	return item;
+}
+
+/* the caller must hold device_cache_mutex */
+static void
+fwupd_client_device_cache_invalidate(FwupdClient *self)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_clear_pointer(&priv->device_cache_by_id, g_hash_table_unref);
+	g_clear_pointer(&priv->device_cache, g_ptr_array_unref);
+	priv->device_cache_generation++;
+}
+
+/* the caller must hold device_cache_mutex */
+static void
+fwupd_client_device_cache_set(FwupdClient *self, GVariant *val)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GPtrArray) devices = g_ptr_array_new();
+	g_autoptr(GVariant) untuple = g_variant_get_child_value(val, 0);
+	gsize sz = g_variant_n_children(untuple);
+
+	fwupd_client_device_cache_invalidate(self);
+	priv->device_cache =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fwupd_client_device_cache_item_free);
+	priv->device_cache_by_id = g_hash_table_new(g_str_hash, g_str_equal);
+	for (guint i = 0; i < sz; i++) {
+		FwupdClientDeviceCacheItem *item;
+		g_autoptr(GVariant) data = g_variant_get_child_value(untuple, i);
+		item = fwupd_client_device_cache_item_new(data);
+		if (item == NULL)
+			continue;
+		g_ptr_array_add(priv->device_cache, item);
+		g_hash_table_insert(priv->device_cache_by_id, item->id, item);
+		g_ptr_array_add(devices, item->device);
+	}
+
+	/* nothing has been shared yet, so this does not decode the devices */
+	fwupd_device_array_ensure_parents(devices);
+}
+
+/* the caller must hold device_cache_mutex */
+static GPtrArray *
+fwupd_client_device_cache_get_all(FwupdClient *self, GError **error)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	GPtrArray *devices;
+
+	/* same as the daemon */
+	if (priv->device_cache->len == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOTHING_TO_DO,
+				    "No detected devices");
+		return NULL;
+	}
+	devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	for (guint i = 0; i < priv->device_cache->len; i++) {
+		FwupdClientDeviceCacheItem *item = g_ptr_array_index(priv->device_cache, i);
+		g_ptr_array_add(devices, g_object_ref(item->device));
+	}
+	return devices;
+}
+
+/* the caller must hold device_cache_mutex */
+static void
+fwupd_client_device_cache_remove(FwupdClient *self, FwupdClientDeviceCacheItem *item)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_hash_table_remove(priv->device_cache_by_id, item->id);
+	g_ptr_array_remove(priv->device_cache, item);
+}
+
+/* the caller must hold device_cache_mutex; the old devices may have been returned to callers
+ * and must not be modified, so new ones are built for all the children of @parent_id */
+static void
+fwupd_client_device_cache_rebuild_children(FwupdClient *self,
+					   const gchar *parent_id,
+					   FwupdDevice *parent,
+					   guint depth)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+
+	/* the daemon sent a loop */
+	if (depth > FWUPD_CLIENT_DEVICE_CACHE_DEPTH_MAX)
+		return;
+	for (guint i = 0; i < priv->device_cache->len; i++) {
+		FwupdClientDeviceCacheItem *item_tmp = g_ptr_array_index(priv->device_cache, i);
+		if (g_strcmp0(item_tmp->parent_id, parent_id) != 0)
+			continue;
+		g_object_unref(item_tmp->device);
+		item_tmp->device = fwupd_device_from_variant(item_tmp->value);
+		if (parent != NULL)
+			fwupd_device_set_parent(item_tmp->device, parent);
+		fwupd_client_device_cache_rebuild_children(self,
+							   item_tmp->id,
+							   item_tmp->device,
+							   depth + 1);
+	}
+}
+
+/* the caller must hold device_cache_mutex */
+static void
+fwupd_client_device_cache_add(FwupdClient *self, FwupdClientDeviceCacheItem *item)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	FwupdClientDeviceCacheItem *item_old;
+	guint idx = priv->device_cache->len;
+
+	/* replace in place so that the order does not change */
+	item_old = g_hash_table_lookup(priv->device_cache_by_id, item->id);
+	if (item_old != NULL) {
+		for (guint i = 0; i < priv->device_cache->len; i++) {
+			if (g_ptr_array_index(priv->device_cache, i) == item_old) {
+				idx = i;
+				break;
+			}
+		}
+		fwupd_client_device_cache_remove(self, item_old);
+	}
+	g_ptr_array_insert(priv->device_cache, idx, item);
+	g_hash_table_insert(priv->device_cache_by_id, item->id, item);
+
+	/* set up the parent, which is safe as nobody has seen the new device yet */
+	if (item->parent_id != NULL) {
+		FwupdClientDeviceCacheItem *item_parent =
+		    g_hash_table_lookup(priv->device_cache_by_id, item->parent_id);
+		if (item_parent != NULL)
+			fwupd_device_set_parent(item->device, item_parent->device);
+	}
+	fwupd_client_device_cache_rebuild_children(self, item->id, item->device, 0);
+}
+
+/* the signals do not include the values only sent to trusted clients, so keep the old ones */
+static GVariant *
+fwupd_client_device_cache_merge_value(GVariant *value, GVariant *value_old)
+{
+	const gchar *keys[] = {FWUPD_RESULT_KEY_SERIAL, FWUPD_RESULT_KEY_INSTANCE_IDS, NULL};
+	g_autoptr(GVariantDict) dict = g_variant_dict_new(value);
+
+	for (guint i = 0; keys[i] != NULL; i++) {
+		g_autoptr(GVariant) tmp = NULL;
+		if (g_variant_dict_contains(dict, keys[i]))
+			continue;
+		tmp = g_variant_lookup_value(value_old, keys[i], NULL);
+		if (tmp != NULL)
+			g_variant_dict_insert_value(dict, keys[i], tmp);
+	}
+	return g_variant_ref_sink(g_variant_dict_end(dict));
+}
+
+/* keep the cache in sync with the daemon without calling GetDevices again */
+static void
+fwupd_client_device_cache_signal(FwupdClient *self,
+				 const gchar *signal_name,
+				 GVariant *parameters)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	FwupdClientDeviceCacheItem *item;
+	FwupdClientDeviceCacheItem *item_old;
+	const gchar *id = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->device_cache_mutex);
+	g_autoptr(GVariant) value = NULL;
+
+	g_assert(locker != NULL);
+
+	/* also makes any GetDevices in progress not update the cache */
+	if (!priv->device_cache_enabled)
+		return;
+	priv->device_cache_generation++;
+	if (priv->device_cache == NULL)
+		return;
+
+	value = g_variant_get_child_value(parameters, 0);
+	if (!g_variant_lookup(value, FWUPD_RESULT_KEY_DEVICE_ID, "&s", &id)) {
+		fwupd_client_device_cache_invalidate(self);
+		return;
+	}
+	item_old = g_hash_table_lookup(priv->device_cache_by_id, id);
+	if (g_strcmp0(signal_name, "DeviceRemoved") == 0) {
+		if (item_old != NULL) {
+			g_autofree gchar *id_old = g_strdup(item_old->id);
+			fwupd_client_device_cache_remove(self, item_old);
+			fwupd_client_device_cache_rebuild_children(self, id_old, NULL, 0);
+		}
+		return;
+	}
+	if (item_old != NULL) {
+		g_autoptr(GVariant) value_merged = NULL;
+		value_merged = fwupd_client_device_cache_merge_value(value, item_old->value);
+		item = fwupd_client_device_cache_item_new(value_merged);
+	} else {
+		item = fwupd_client_device_cache_item_new(value);
+	}
+	fwupd_client_device_cache_add(self, item);
+}
+
+/* the daemon has been restarted, so any signals in between have been missed */
+static void
+fwupd_client_name_owner_notify_cb(GObject *object, GParamSpec *pspec, FwupdClient *self)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->device_cache_mutex);
+	g_assert(locker != NULL);
+	fwupd_client_device_cache_invalidate(self);
+}
+
 static void
 fwupd_client_signal_cb(GDBusProxy *proxy,
 		       const gchar *sender_name,
@@ -441,6 +798,13 @@ fwupd_client_signal_cb(GDBusProxy *proxy,
 		       FwupdClient *self)
 {
 	g_autoptr(FwupdDevice) dev = NULL;
+
+	/* update the cache before any callers are told about the change */
+	if (g_strcmp0(signal_name, "DeviceAdded") == 0 ||
+	    g_strcmp0(signal_name, "DeviceRemoved") == 0 ||
+	    g_strcmp0(signal_name, "DeviceChanged") == 0)
+		fwupd_client_device_cache_signal(self, signal_name, parameters);
+
 	if (g_strcmp0(signal_name, "Changed") == 0) {
 		g_debug("Emitting ::changed()");
 		g_signal_emit(self, signals[SIGNAL_CHANGED], 0);
@@ -564,22 +928,58 @@ fwupd_client_progress_callback_cb(void *clientp,
 				  curl_off_t ultotal,
 				  curl_off_t ulnow)
 {
-	FwupdClient *self = FWUPD_CLIENT(clientp);
+	FwupdCurlHelper *helper = (FwupdCurlHelper *)clientp;
+	FwupdClientPrivate *priv = GET_PRIVATE(helper->self);
+	curl_off_t now;
+	curl_off_t total;
+	guint percentage;
 
-	/* calculate percentage */
+	/* ignore until the size is known */
 	if (dltotal > 0 && dlnow >= 0 && dlnow <= dltotal) {
-		guint percentage = (guint)((100 * dlnow) / dltotal);
-		g_debug("download progress: %u%%", percentage);
-		fwupd_client_set_percentage(self, percentage);
+		now = dlnow;
+		total = dltotal;
 	} else if (ultotal > 0 && ulnow >= 0 && ulnow <= ultotal) {
-		guint percentage = (guint)((100 * ulnow) / ultotal);
-		g_debug("upload progress: %u%%", percentage);
-		fwupd_client_set_percentage(self, percentage);
+		now = ulnow;
+		total = ultotal;
+	} else {
+		return 0;
 	}
 
+	/* concurrent transfers are combined into one percentage rather than interleaved */
+	g_mutex_lock(&priv->transfers_mutex);
+	helper->now = now;
+	helper->total = total;
+	now = priv->transfers_done_now;
+	total = priv->transfers_done_total;
+	for (guint i = 0; i < priv->transfers->len; i++) {
+		FwupdCurlHelper *helper_tmp = g_ptr_array_index(priv->transfers, i);
+		now += helper_tmp->now;
+		total += helper_tmp->total;
+	}
+	g_mutex_unlock(&priv->transfers_mutex);
+	percentage = (guint)((100 * now) / total);
+	g_debug("transfer progress: %u%%", percentage);
+	fwupd_client_set_percentage(helper->self, percentage);
 	return 0;
 }
 
+static void
+fwupd_client_curl_share_lock_cb(CURL *handle,
+				curl_lock_data data,
+				curl_lock_access access,
+				void *userptr)
+{
+	FwupdClientPrivate *priv = (FwupdClientPrivate *)userptr;
+	g_mutex_lock(&priv->curlsh_mutexes[data]);
+}
+
+static void
+fwupd_client_curl_share_unlock_cb(CURL *handle, curl_lock_data data, void *userptr)
+{
+	FwupdClientPrivate *priv = (FwupdClientPrivate *)userptr;
+	g_mutex_unlock(&priv->curlsh_mutexes[data]);
+}
+
 static void
 fwupd_client_curl_helper_set_proxy(FwupdClient *self, FwupdCurlHelper *helper, const gchar *url)
 {
@@ -606,8 +1006,15 @@ fwupd_client_curl_new(FwupdClient *self, GError **error)
 	if (!fwupd_client_ensure_networking(self, error))
 		return NULL;
 
-	/* create the session */
-	helper->curl = curl_easy_init();
+	/* reuse an idle session if there is one, otherwise create a new one */
+	g_mutex_lock(&priv->transfers_mutex);
+	if (priv->curl_pool->len > 0) {
+		helper->curl = g_ptr_array_index(priv->curl_pool, priv->curl_pool->len - 1);
+		g_ptr_array_remove_index(priv->curl_pool, priv->curl_pool->len - 1);
+	}
+	g_mutex_unlock(&priv->transfers_mutex);
+	if (helper->curl == NULL)
+		helper->curl = curl_easy_init();
 	if (helper->curl == NULL) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
@@ -615,10 +1022,14 @@ fwupd_client_curl_new(FwupdClient *self, GError **error)
 				    "failed to setup networking");
 		return NULL;
 	}
+	helper->self = g_object_ref(self);
+	g_mutex_lock(&priv->transfers_mutex);
+	g_ptr_array_add(priv->transfers, helper);
+	g_mutex_unlock(&priv->transfers_mutex);
 	if (g_getenv("FWUPD_CURL_VERBOSE") != NULL)
 		curl_easy_setopt(helper->curl, CURLOPT_VERBOSE, 1L);
 	curl_easy_setopt(helper->curl, CURLOPT_XFERINFOFUNCTION, fwupd_client_progress_callback_cb);
-	curl_easy_setopt(helper->curl, CURLOPT_XFERINFODATA, self);
+	curl_easy_setopt(helper->curl, CURLOPT_XFERINFODATA, helper);
 	curl_easy_setopt(helper->curl, CURLOPT_USERAGENT, priv->user_agent);
 	curl_easy_setopt(helper->curl, CURLOPT_CONNECTTIMEOUT, 60L);
 	curl_easy_setopt(helper->curl, CURLOPT_NOPROGRESS, 0L);
@@ -631,6 +1042,11 @@ fwupd_client_curl_new(FwupdClient *self, GError **error)
 
 	/* this disables the double-compression of the firmware.xml.gz file */
 	curl_easy_setopt(helper->curl, CURLOPT_HTTP_CONTENT_DECODING, 0L);
+
+	/* reuse lookups and TLS sessions from all downloads; the connection cache cannot be
+	 * shared between threads, so connections are only reused by the pooled sessions */
+	if (priv->curlsh != NULL)
+		curl_easy_setopt(helper->curl, CURLOPT_SHARE, priv->curlsh);
 	return g_steal_pointer(&helper);
 }
 #endif
@@ -704,6 +1120,10 @@ fwupd_client_connect_get_proxy_cb(GObject *source, GAsyncResult *res, gpointer u
 			 "g-signal",
 			 G_CALLBACK(fwupd_client_signal_cb),
 			 self);
+	g_signal_connect(G_DBUS_PROXY(priv->proxy),
+			 "notify::g-name-owner",
+			 G_CALLBACK(fwupd_client_name_owner_notify_cb),
+			 self);
 	val = g_dbus_proxy_get_cached_property(priv->proxy, "DaemonVersion");
 	if (val != NULL)
 		fwupd_client_set_daemon_version(self, g_variant_get_string(val, NULL));
@@ -892,6 +1312,11 @@ fwupd_client_disconnect(FwupdClient *self, GError **error)
 	g_signal_handlers_disconnect_by_data(priv->proxy, self);
 	g_clear_object(&priv->proxy);
 
+	/* signals are no longer being received */
+	g_mutex_lock(&priv->device_cache_mutex);
+	fwupd_client_device_cache_invalidate(self);
+	g_mutex_unlock(&priv->device_cache_mutex);
+
 	/* success */
 	return TRUE;
 }
@@ -1033,7 +1458,10 @@ fwupd_client_get_host_security_events_cb(GObject *source, GAsyncResult *res, gpo
  * @callback: the function to run on completion
  * @callback_data: the data to pass to @callback
  *
- * Gets all the host security events from the daemon.
+ * Gets all the host security events from the daemon, newest first.
+ *
+ * Since 1.8.0 @limit counts changed attributes rather than the boots where the attributes were
+ * recorded. Use fwupd_client_get_host_security_events_full_async() to get later pages.
  *
  * You must have called [method@Client.connect_async] on @self before using
  * this method.
@@ -1087,6 +1515,72 @@ fwupd_client_get_host_security_events_finish(FwupdClient *self, GAsyncResult *re
 	return g_task_propagate_pointer(G_TASK(res), error);
 }
 
+/**
+ * fwupd_client_get_host_security_events_full_async:
+ * @self: a #FwupdClient
+ * @limit: maximum number of events, or 0 for no limit
+ * @offset: number of newer events to skip
+ * @cancellable: (nullable): optional #GCancellable
+ * @callback: the function to run on completion
+ * @callback_data: the data to pass to @callback
+ *
+ * Gets a page of the host security events from the daemon, newest first.
+ *
+ * You must have called [method@Client.connect_async] on @self before using
+ * this method.
+ *
+ * Since: 1.8.0
+ **/
+void
+fwupd_client_get_host_security_events_full_async(FwupdClient *self,
+						 guint limit,
+						 guint offset,
+						 GCancellable *cancellable,
+						 GAsyncReadyCallback callback,
+						 gpointer callback_data)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+	g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable));
+	g_return_if_fail(priv->proxy != NULL);
+
+	/* call into daemon */
+	task = g_task_new(self, cancellable, callback, callback_data);
+	g_dbus_proxy_call(priv->proxy,
+			  "GetHostSecurityEventsFull",
+			  g_variant_new("(uu)", limit, offset),
+			  G_DBUS_CALL_FLAGS_NONE,
+			  FWUPD_CLIENT_DBUS_PROXY_TIMEOUT,
+			  cancellable,
+			  fwupd_client_get_host_security_events_cb,
+			  g_steal_pointer(&task));
+}
+
+/**
+ * fwupd_client_get_host_security_events_full_finish:
+ * @self: a #FwupdClient
+ * @res: the asynchronous result
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the result of fwupd_client_get_host_security_events_full_async().
+ *
+ * Returns: (element-type FwupdSecurityAttr) (transfer container): attributes
+ *
+ * Since: 1.8.0
+ **/
+GPtrArray *
+fwupd_client_get_host_security_events_full_finish(FwupdClient *self,
+						  GAsyncResult *res,
+						  GError **error)
+{
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(g_task_is_valid(res, self), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+	return g_task_propagate_pointer(G_TASK(res), error);
+}
+
 static GHashTable *
 fwupd_report_metadata_hash_from_variant(GVariant *value)
 {
@@ -1189,7 +1683,7 @@ fwupd_client_get_report_metadata_finish(FwupdClient *self, GAsyncResult *res, GE
 }
 
 static void
-fwupd_client_get_devices_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+fwupd_client_get_statistics_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
 	g_autoptr(GTask) task = G_TASK(user_data);
 	g_autoptr(GError) error = NULL;
@@ -1204,29 +1698,30 @@ fwupd_client_get_devices_cb(GObject *source, GAsyncResult *res, gpointer user_da
 
 	/* success */
 	g_task_return_pointer(task,
-			      fwupd_device_array_from_variant(val),
+			      fwupd_statistic_array_from_variant(val),
 			      (GDestroyNotify)g_ptr_array_unref);
 }
 
 /**
- * fwupd_client_get_devices_async:
+ * fwupd_client_get_statistics_async:
  * @self: a #FwupdClient
  * @cancellable: (nullable): optional #GCancellable
  * @callback: the function to run on completion
  * @callback_data: the data to pass to @callback
  *
- * Gets all the devices registered with the daemon.
+ * Gets the runtime statistics collected by the daemon, for instance the D-Bus method latency
+ * or the number of bytes written to each device.
  *
  * You must have called [method@Client.connect_async] on @self before using
  * this method.
  *
- * Since: 1.5.0
+ * Since: 1.8.0
  **/
 void
-fwupd_client_get_devices_async(FwupdClient *self,
-			       GCancellable *cancellable,
-			       GAsyncReadyCallback callback,
-			       gpointer callback_data)
+fwupd_client_get_statistics_async(FwupdClient *self,
+				  GCancellable *cancellable,
+				  GAsyncReadyCallback callback,
+				  gpointer callback_data)
 {
 	FwupdClientPrivate *priv = GET_PRIVATE(self);
 	g_autoptr(GTask) task = NULL;
@@ -1238,29 +1733,29 @@ fwupd_client_get_devices_async(FwupdClient *self,
 	/* call into daemon */
 	task = g_task_new(self, cancellable, callback, callback_data);
 	g_dbus_proxy_call(priv->proxy,
-			  "GetDevices",
+			  "GetStatistics",
 			  NULL,
 			  G_DBUS_CALL_FLAGS_NONE,
 			  FWUPD_CLIENT_DBUS_PROXY_TIMEOUT,
 			  cancellable,
-			  fwupd_client_get_devices_cb,
+			  fwupd_client_get_statistics_cb,
 			  g_steal_pointer(&task));
 }
 
 /**
- * fwupd_client_get_devices_finish:
+ * fwupd_client_get_statistics_finish:
  * @self: a #FwupdClient
  * @res: the asynchronous result
  * @error: (nullable): optional return location for an error
  *
- * Gets the result of fwupd_client_get_devices_async().
+ * Gets the result of fwupd_client_get_statistics_async().
  *
- * Returns: (element-type FwupdDevice) (transfer container): results
+ * Returns: (element-type FwupdStatistic) (transfer container): statistics
  *
- * Since: 1.5.0
+ * Since: 1.8.0
  **/
 GPtrArray *
-fwupd_client_get_devices_finish(FwupdClient *self, GAsyncResult *res, GError **error)
+fwupd_client_get_statistics_finish(FwupdClient *self, GAsyncResult *res, GError **error)
 {
 	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
 	g_return_val_if_fail(g_task_is_valid(res, self), NULL);
@@ -1269,33 +1764,75 @@ fwupd_client_get_devices_finish(FwupdClient *self, GAsyncResult *res, GError **e
 }
 
 static void
-fwupd_client_get_plugins_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+fwupd_client_get_devices_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
 	g_autoptr(GTask) task = G_TASK(user_data);
+	FwupdClient *self = g_task_get_source_object(task);
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	guint64 *generation = g_task_get_task_data(task);
+	gboolean cached = FALSE;
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GError) error_cache = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
 	g_autoptr(GVariant) val = NULL;
 
 	val = g_dbus_proxy_call_finish(G_DBUS_PROXY(source), res, &error);
-	if (val == NULL) {
+	if (val == NULL)
 		fwupd_client_fixup_dbus_error(error);
+
+	/* only use the result if no devices changed while the daemon was building it */
+	locker = g_mutex_locker_new(&priv->device_cache_mutex);
+	if (generation != NULL && priv->device_cache_enabled &&
+	    *generation == priv->device_cache_generation) {
+		if (val != NULL) {
+			fwupd_client_device_cache_set(self, val);
+		} else if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO)) {
+			g_autoptr(GVariant) val_empty = NULL;
+			val_empty = g_variant_ref_sink(g_variant_new_parsed("(@aa{sv} [],)"));
+			fwupd_client_device_cache_set(self, val_empty);
+		}
+		if (priv->device_cache != NULL) {
+			devices = fwupd_client_device_cache_get_all(self, &error_cache);
+			cached = TRUE;
+		}
+	}
+
+	/* the callback may call back into the client */
+	g_clear_pointer(&locker, g_mutex_locker_free);
+	if (cached) {
+		if (devices == NULL) {
+			g_task_return_error(task, g_steal_pointer(&error_cache));
+			return;
+		}
+		g_task_return_pointer(task,
+				      g_steal_pointer(&devices),
+				      (GDestroyNotify)g_ptr_array_unref);
+		return;
+	}
+
+	if (val == NULL) {
 		g_task_return_error(task, g_steal_pointer(&error));
 		return;
 	}
 
 	/* success */
 	g_task_return_pointer(task,
-			      fwupd_plugin_array_from_variant(val),
+			      fwupd_device_array_from_variant(val),
 			      (GDestroyNotify)g_ptr_array_unref);
 }
 
 /**
- * fwupd_client_get_plugins_async:
+ * fwupd_client_get_devices_async:
  * @self: a #FwupdClient
  * @cancellable: (nullable): optional #GCancellable
  * @callback: the function to run on completion
  * @callback_data: the data to pass to @callback
  *
- * Gets all the plugins being used by the daemon.
+ * Gets all the devices registered with the daemon.
+ *
+ * If fwupd_client_set_device_cache_enabled() has been used then the devices are only
+ * requested from the daemon once, and then returned from memory.
  *
  * You must have called [method@Client.connect_async] on @self before using
  * this method.
@@ -1303,26 +1840,131 @@ fwupd_client_get_plugins_cb(GObject *source, GAsyncResult *res, gpointer user_da
  * Since: 1.5.0
  **/
 void
-fwupd_client_get_plugins_async(FwupdClient *self,
+fwupd_client_get_devices_async(FwupdClient *self,
 			       GCancellable *cancellable,
 			       GAsyncReadyCallback callback,
 			       gpointer callback_data)
 {
 	FwupdClientPrivate *priv = GET_PRIVATE(self);
 	g_autoptr(GTask) task = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
 
 	g_return_if_fail(FWUPD_IS_CLIENT(self));
 	g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable));
 	g_return_if_fail(priv->proxy != NULL);
 
-	/* call into daemon */
 	task = g_task_new(self, cancellable, callback, callback_data);
-	g_dbus_proxy_call(priv->proxy,
-			  "GetPlugins",
-			  NULL,
-			  G_DBUS_CALL_FLAGS_NONE,
-			  FWUPD_CLIENT_DBUS_PROXY_TIMEOUT,
-			  cancellable,
+
+	/* already up to date */
+	locker = g_mutex_locker_new(&priv->device_cache_mutex);
+	if (priv->device_cache_enabled) {
+		if (priv->device_cache != NULL) {
+			g_autoptr(GError) error = NULL;
+			g_autoptr(GPtrArray) devices = NULL;
+			devices = fwupd_client_device_cache_get_all(self, &error);
+			g_clear_pointer(&locker, g_mutex_locker_free);
+			if (devices == NULL) {
+				g_task_return_error(task, g_steal_pointer(&error));
+				return;
+			}
+			g_task_return_pointer(task,
+					      g_steal_pointer(&devices),
+					      (GDestroyNotify)g_ptr_array_unref);
+			return;
+		}
+		g_task_set_task_data(task,
+				     g_memdup(&priv->device_cache_generation, sizeof(guint64)),
+				     g_free);
+	}
+	g_clear_pointer(&locker, g_mutex_locker_free);
+
+	/* call into daemon */
+	g_dbus_proxy_call(priv->proxy,
+			  "GetDevices",
+			  NULL,
+			  G_DBUS_CALL_FLAGS_NONE,
+			  FWUPD_CLIENT_DBUS_PROXY_TIMEOUT,
+			  cancellable,
+			  fwupd_client_get_devices_cb,
+			  g_steal_pointer(&task));
+}
+
+/**
+ * fwupd_client_get_devices_finish:
+ * @self: a #FwupdClient
+ * @res: the asynchronous result
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the result of fwupd_client_get_devices_async().
+ *
+ * Returns: (element-type FwupdDevice) (transfer container): results
+ *
+ * Since: 1.5.0
+ **/
+GPtrArray *
+fwupd_client_get_devices_finish(FwupdClient *self, GAsyncResult *res, GError **error)
+{
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(g_task_is_valid(res, self), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+	return g_task_propagate_pointer(G_TASK(res), error);
+}
+
+static void
+fwupd_client_get_plugins_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	g_autoptr(GTask) task = G_TASK(user_data);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) val = NULL;
+
+	val = g_dbus_proxy_call_finish(G_DBUS_PROXY(source), res, &error);
+	if (val == NULL) {
+		fwupd_client_fixup_dbus_error(error);
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+
+	/* success */
+	g_task_return_pointer(task,
+			      fwupd_plugin_array_from_variant(val),
+			      (GDestroyNotify)g_ptr_array_unref);
+}
+
+/**
+ * fwupd_client_get_plugins_async:
+ * @self: a #FwupdClient
+ * @cancellable: (nullable): optional #GCancellable
+ * @callback: the function to run on completion
+ * @callback_data: the data to pass to @callback
+ *
+ * Gets all the plugins being used by the daemon.
+ *
+ * You must have called [method@Client.connect_async] on @self before using
+ * this method.
+ *
+ * Since: 1.5.0
+ **/
+void
+fwupd_client_get_plugins_async(FwupdClient *self,
+			       GCancellable *cancellable,
+			       GAsyncReadyCallback callback,
+			       gpointer callback_data)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+	g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable));
+	g_return_if_fail(priv->proxy != NULL);
+
+	/* call into daemon */
+	task = g_task_new(self, cancellable, callback, callback_data);
+	g_dbus_proxy_call(priv->proxy,
+			  "GetPlugins",
+			  NULL,
+			  G_DBUS_CALL_FLAGS_NONE,
+			  FWUPD_CLIENT_DBUS_PROXY_TIMEOUT,
+			  cancellable,
 			  fwupd_client_get_plugins_cb,
 			  g_steal_pointer(&task));
 }
@@ -2893,12 +3535,15 @@ fwupd_client_install_release_remote_cb(GObject *source, GAsyncResult *res, gpoin
 	}
 
 	/* download file */
-	fwupd_client_download_bytes2_async(FWUPD_CLIENT(source),
-					   uris_built,
-					   data->download_flags,
-					   cancellable,
-					   fwupd_client_install_release_download_cb,
-					   g_steal_pointer(&task));
+	fwupd_client_download_bytes_cached_async(
+	    FWUPD_CLIENT(source),
+	    uris_built,
+	    data->download_flags,
+	    fwupd_checksum_get_best(fwupd_release_get_checksums(data->release)),
+	    fwupd_remote_get_mirror_uris(remote),
+	    cancellable,
+	    fwupd_client_install_release_download_cb,
+	    g_steal_pointer(&task));
 }
 
 #ifdef HAVE_LIBCURL
@@ -2982,12 +3627,15 @@ fwupd_client_install_release2_async(FwupdClient *self,
 	/* work out what remote-specific URI fields this should use */
 	remote_id = fwupd_release_get_remote_id(release);
 	if (remote_id == NULL) {
-		fwupd_client_download_bytes2_async(self,
-						   fwupd_release_get_locations(release),
-						   download_flags,
-						   cancellable,
-						   fwupd_client_install_release_download_cb,
-						   g_steal_pointer(&task));
+		fwupd_client_download_bytes_cached_async(
+		    self,
+		    fwupd_release_get_locations(release),
+		    download_flags,
+		    fwupd_checksum_get_best(fwupd_release_get_checksums(release)),
+		    NULL,
+		    cancellable,
+		    fwupd_client_install_release_download_cb,
+		    g_steal_pointer(&task));
 		return;
 	}
 
@@ -3208,6 +3856,42 @@ fwupd_client_get_percentage(FwupdClient *self)
 	return priv->percentage;
 }
 
+/**
+ * fwupd_client_get_eta:
+ * @self: a #FwupdClient
+ *
+ * Gets the last returned estimate of the time remaining for the daemon job.
+ *
+ * Returns: seconds, or 0 for unknown.
+ *
+ * Since: 1.8.0
+ **/
+guint
+fwupd_client_get_eta(FwupdClient *self)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), 0);
+	return priv->eta;
+}
+
+/**
+ * fwupd_client_get_throughput:
+ * @self: a #FwupdClient
+ *
+ * Gets the last returned transfer rate to the device being updated.
+ *
+ * Returns: bytes per second, or 0 for unknown.
+ *
+ * Since: 1.8.0
+ **/
+guint64
+fwupd_client_get_throughput(FwupdClient *self)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), 0);
+	return priv->throughput;
+}
+
 /**
  * fwupd_client_get_daemon_version:
  * @self: a #FwupdClient
@@ -3596,6 +4280,53 @@ fwupd_client_refresh_remote_metadata_cb(GObject *source, GAsyncResult *res, gpoi
 						 g_steal_pointer(&task));
 }
 
+static void
+fwupd_client_refresh_remote_download_metadata(GTask *task)
+{
+	FwupdClientRefreshRemoteData *data = g_task_get_task_data(task);
+	FwupdClient *self = g_task_get_source_object(task);
+	fwupd_client_download_bytes_async(self,
+					  fwupd_remote_get_metadata_uri(data->remote),
+					  FWUPD_CLIENT_DOWNLOAD_FLAG_NONE,
+					  g_task_get_cancellable(task),
+					  fwupd_client_refresh_remote_metadata_cb,
+					  task);
+}
+
+static void
+fwupd_client_refresh_remote_delta_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	g_autoptr(GError) error = NULL;
+	GTask *task = G_TASK(user_data);
+	FwupdClientRefreshRemoteData *data = g_task_get_task_data(task);
+	FwupdClient *self = g_task_get_source_object(task);
+
+	/* the server may not have the index, or too much has changed */
+	data->metadata =
+	    fwupd_client_download_metadata_delta_finish(FWUPD_CLIENT(source), res, &error);
+	if (data->metadata == NULL) {
+		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+			g_task_return_error(task, g_steal_pointer(&error));
+			g_object_unref(task);
+			return;
+		}
+		g_debug("downloading all metadata for %s: %s",
+			fwupd_remote_get_id(data->remote),
+			error->message);
+		fwupd_client_refresh_remote_download_metadata(task);
+		return;
+	}
+
+	/* send all this to fwupd */
+	fwupd_client_update_metadata_bytes_async(self,
+						 fwupd_remote_get_id(data->remote),
+						 data->metadata,
+						 data->signature,
+						 g_task_get_cancellable(task),
+						 fwupd_client_refresh_remote_update_cb,
+						 task);
+}
+
 static void
 fwupd_client_refresh_remote_signature_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
@@ -3605,6 +4336,7 @@ fwupd_client_refresh_remote_signature_cb(GObject *source, GAsyncResult *res, gpo
 	FwupdClientRefreshRemoteData *data = g_task_get_task_data(task);
 	FwupdClient *self = g_task_get_source_object(task);
 	GCancellable *cancellable = g_task_get_cancellable(task);
+	const gchar *filename_cache = fwupd_remote_get_filename_cache(data->remote);
 	GChecksumType checksum_kind;
 	g_autofree gchar *checksum = NULL;
 
@@ -3636,13 +4368,22 @@ fwupd_client_refresh_remote_signature_cb(GObject *source, GAsyncResult *res, gpo
 		return;
 	}
 
+	/* only download the chunks that are different to the old metadata */
+	if (fwupd_remote_get_metadata_delta(data->remote) &&
+	    fwupd_remote_get_keyring_kind(data->remote) == FWUPD_KEYRING_KIND_JCAT &&
+	    fwupd_client_is_url_http(fwupd_remote_get_metadata_uri(data->remote)) &&
+	    filename_cache != NULL && g_file_test(filename_cache, G_FILE_TEST_EXISTS)) {
+		fwupd_client_download_metadata_delta_async(self,
+							   data->remote,
+							   data->signature,
+							   cancellable,
+							   fwupd_client_refresh_remote_delta_cb,
+							   g_steal_pointer(&task));
+		return;
+	}
+
 	/* download metadata */
-	fwupd_client_download_bytes_async(self,
-					  fwupd_remote_get_metadata_uri(data->remote),
-					  FWUPD_CLIENT_DOWNLOAD_FLAG_NONE,
-					  cancellable,
-					  fwupd_client_refresh_remote_metadata_cb,
-					  g_steal_pointer(&task));
+	fwupd_client_refresh_remote_download_metadata(g_steal_pointer(&task));
 }
 
 /**
@@ -3712,6 +4453,145 @@ fwupd_client_refresh_remote_finish(FwupdClient *self, GAsyncResult *res, GError
 	return g_task_propagate_boolean(G_TASK(res), error);
 }
 
+typedef struct {
+	GPtrArray *remotes; /* element-type FwupdRemote */
+	guint idx_next;
+	guint in_flight;
+	GError *error; /* (nullable): the first failure */
+} FwupdClientRefreshRemotesData;
+
+static void
+fwupd_client_refresh_remotes_data_free(FwupdClientRefreshRemotesData *data)
+{
+	if (data->error != NULL)
+		g_error_free(data->error);
+	g_ptr_array_unref(data->remotes);
+	g_free(data);
+}
+
+static void
+fwupd_client_refresh_remotes_submit(GTask *task);
+
+static void
+fwupd_client_refresh_remotes_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	g_autoptr(GTask) task = G_TASK(user_data);
+	FwupdClientRefreshRemotesData *data = g_task_get_task_data(task);
+	FwupdClientRefreshRemoteData *data_remote = g_task_get_task_data(G_TASK(res));
+	g_autoptr(GError) error_local = NULL;
+
+	data->in_flight--;
+	if (!fwupd_client_refresh_remote_finish(FWUPD_CLIENT(source), res, &error_local) &&
+	    data->error == NULL) {
+		g_prefix_error(&error_local,
+			       "failed to refresh %s: ",
+			       fwupd_remote_get_id(data_remote->remote));
+		data->error = g_steal_pointer(&error_local);
+	}
+
+	/* refill, or wait for the others to finish */
+	fwupd_client_refresh_remotes_submit(task);
+	if (data->in_flight > 0)
+		return;
+	if (data->error != NULL) {
+		g_task_return_error(task, g_steal_pointer(&data->error));
+		return;
+	}
+
+	/* success */
+	g_task_return_boolean(task, TRUE);
+}
+
+static void
+fwupd_client_refresh_remotes_submit(GTask *task)
+{
+	FwupdClient *self = g_task_get_source_object(task);
+	FwupdClientRefreshRemotesData *data = g_task_get_task_data(task);
+
+	/* do not start any more after a failure */
+	while (data->error == NULL && data->in_flight < FWUPD_CLIENT_REFRESH_REMOTES_MAX &&
+	       data->idx_next < data->remotes->len) {
+		FwupdRemote *remote = g_ptr_array_index(data->remotes, data->idx_next++);
+		data->in_flight++;
+		fwupd_client_refresh_remote_async(self,
+						  remote,
+						  g_task_get_cancellable(task),
+						  fwupd_client_refresh_remotes_cb,
+						  g_object_ref(task));
+	}
+}
+
+/**
+ * fwupd_client_refresh_remotes_async:
+ * @self: a #FwupdClient
+ * @remotes: (element-type FwupdRemote): remotes to refresh
+ * @cancellable: (nullable): optional #GCancellable
+ * @callback: the function to run on completion
+ * @callback_data: the data to pass to @callback
+ *
+ * Refreshes several remotes by downloading new metadata, running a few of the downloads at the
+ * same time so that the total time is about the same as the slowest remote.
+ *
+ * If any remote fails then no more are started, and the first error is returned once the
+ * refreshes already in progress have completed. The percentage is that of all the downloads in
+ * progress combined.
+ *
+ * NOTE: This method is thread-safe, but progress signals will be
+ * emitted in the global default main context, if not explicitly set with
+ * [method@Client.set_main_context].
+ *
+ * Since: 1.8.0
+ **/
+void
+fwupd_client_refresh_remotes_async(FwupdClient *self,
+				   GPtrArray *remotes,
+				   GCancellable *cancellable,
+				   GAsyncReadyCallback callback,
+				   gpointer callback_data)
+{
+	FwupdClientRefreshRemotesData *data;
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+	g_return_if_fail(remotes != NULL);
+	g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable));
+
+	task = g_task_new(self, cancellable, callback, callback_data);
+	data = g_new0(FwupdClientRefreshRemotesData, 1);
+	data->remotes = g_ptr_array_ref(remotes);
+	g_task_set_task_data(task,
+			     g_steal_pointer(&data),
+			     (GDestroyNotify)fwupd_client_refresh_remotes_data_free);
+
+	/* nothing to do */
+	if (remotes->len == 0) {
+		g_task_return_boolean(task, TRUE);
+		return;
+	}
+	fwupd_client_refresh_remotes_submit(task);
+}
+
+/**
+ * fwupd_client_refresh_remotes_finish:
+ * @self: a #FwupdClient
+ * @res: the asynchronous result
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the result of fwupd_client_refresh_remotes_async().
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fwupd_client_refresh_remotes_finish(FwupdClient *self, GAsyncResult *res, GError **error)
+{
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), FALSE);
+	g_return_val_if_fail(g_task_is_valid(res, self), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	return g_task_propagate_boolean(G_TASK(res), error);
+}
+
 static void
 fwupd_client_get_remotes_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
@@ -4616,22 +5496,182 @@ fwupd_client_get_user_agent(FwupdClient *self)
 }
 
 /**
- * fwupd_client_set_user_agent_for_package:
+ * fwupd_client_set_download_cache_dir:
  * @self: a #FwupdClient
- * @package_name: (not nullable): client program name, e.g. `gnome-software`
- * @package_version: (not nullable): client program version, e.g. `3.28.1`
+ * @download_cache_dir: (nullable): a directory, or %NULL to disable the cache
  *
- * Builds a user-agent to use for the download.
+ * Sets the directory used to cache firmware downloaded when installing a release.
  *
- * Supplying harmless details to the server means it knows more about each
- * client. This allows the web service to respond in a different way, for
- * instance sending a different metadata file for old versions of fwupd, or
- * returning an error for Solaris machines.
+ * Files are named by the release checksum and are checked again before being used, so the
+ * same directory can be safely used by more than one program. Files that are symlinks or that
+ * are owned by a different user are never read, written or deleted. Interrupted downloads are
+ * continued from where they stopped when the server supports it.
  *
- * Before freaking out about theoretical privacy implications, much more data
- * than this is sent to each and every website you visit.
+ * The cache is disabled by default, unless the `FWUPD_DOWNLOAD_CACHE_DIR` environment variable
+ * is set.
  *
- * Since: 1.4.5
+ * Since: 1.8.0
+ **/
+void
+fwupd_client_set_download_cache_dir(FwupdClient *self, const gchar *download_cache_dir)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+
+	/* not changed */
+	if (g_strcmp0(priv->download_cache_dir, download_cache_dir) == 0)
+		return;
+
+	g_free(priv->download_cache_dir);
+	priv->download_cache_dir = g_strdup(download_cache_dir);
+}
+
+/**
+ * fwupd_client_get_download_cache_dir:
+ * @self: a #FwupdClient
+ *
+ * Gets the directory used to cache firmware downloads.
+ *
+ * Returns: a path, or %NULL if the cache is disabled
+ *
+ * Since: 1.8.0
+ **/
+const gchar *
+fwupd_client_get_download_cache_dir(FwupdClient *self)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	return priv->download_cache_dir;
+}
+
+/**
+ * fwupd_client_set_download_cache_size_max:
+ * @self: a #FwupdClient
+ * @download_cache_size_max: size in bytes
+ *
+ * Sets the maximum size of the download cache. When a new download makes the files owned by
+ * the current user larger than this, the least recently used ones are deleted.
+ *
+ * The default is 256MiB.
+ *
+ * Since: 1.8.0
+ **/
+void
+fwupd_client_set_download_cache_size_max(FwupdClient *self, guint64 download_cache_size_max)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+	priv->download_cache_size_max = download_cache_size_max;
+}
+
+/**
+ * fwupd_client_get_download_cache_size_max:
+ * @self: a #FwupdClient
+ *
+ * Gets the maximum size of the download cache.
+ *
+ * Returns: size in bytes
+ *
+ * Since: 1.8.0
+ **/
+guint64
+fwupd_client_get_download_cache_size_max(FwupdClient *self)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), 0);
+	return priv->download_cache_size_max;
+}
+
+/**
+ * fwupd_client_set_device_cache_enabled:
+ * @self: a #FwupdClient
+ * @device_cache_enabled: %TRUE to keep a copy of the devices
+ *
+ * Sets if the devices should be kept in memory and updated when the daemon emits the
+ * #FwupdClient::device-added, #FwupdClient::device-removed and #FwupdClient::device-changed
+ * signals.
+ *
+ * When enabled, fwupd_client_get_devices_async(), fwupd_client_get_device_by_id_async() and
+ * fwupd_client_get_devices_by_guid_async() only call into the daemon the first time, and the
+ * returned devices are shared with other callers and must not be modified.
+ *
+ * Since: 1.8.0
+ **/
+void
+fwupd_client_set_device_cache_enabled(FwupdClient *self, gboolean device_cache_enabled)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+
+	locker = g_mutex_locker_new(&priv->device_cache_mutex);
+	if (priv->device_cache_enabled == device_cache_enabled)
+		return;
+	priv->device_cache_enabled = device_cache_enabled;
+	fwupd_client_device_cache_invalidate(self);
+}
+
+/**
+ * fwupd_client_get_device_cache_enabled:
+ * @self: a #FwupdClient
+ *
+ * Gets if the devices are being kept in memory.
+ *
+ * Returns: %TRUE if enabled
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fwupd_client_get_device_cache_enabled(FwupdClient *self)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), FALSE);
+	return priv->device_cache_enabled;
+}
+
+/**
+ * fwupd_client_get_device_cache_generation:
+ * @self: a #FwupdClient
+ *
+ * Gets a number that is incremented every time the cached devices are changed, added, removed
+ * or thrown away, for instance when the daemon is restarted.
+ *
+ * Callers can compare this with the value from when they got the devices to find out if they
+ * need to get the devices again.
+ *
+ * Returns: an integer
+ *
+ * Since: 1.8.0
+ **/
+guint64
+fwupd_client_get_device_cache_generation(FwupdClient *self)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), 0);
+	locker = g_mutex_locker_new(&priv->device_cache_mutex);
+	return priv->device_cache_generation;
+}
+
+/**
+ * fwupd_client_set_user_agent_for_package:
+ * @self: a #FwupdClient
+ * @package_name: (not nullable): client program name, e.g. `gnome-software`
+ * @package_version: (not nullable): client program version, e.g. `3.28.1`
+ *
+ * Builds a user-agent to use for the download.
+ *
+ * Supplying harmless details to the server means it knows more about each
+ * client. This allows the web service to respond in a different way, for
+ * instance sending a different metadata file for old versions of fwupd, or
+ * returning an error for Solaris machines.
+ *
+ * Before freaking out about theoretical privacy implications, much more data
+ * than this is sent to each and every website you visit.
+ *
+ * Since: 1.4.5
  **/
 void
 fwupd_client_set_user_agent_for_package(FwupdClient *self,
@@ -4717,21 +5757,14 @@ fwupd_client_download_ipfs(FwupdClient *self,
 	return g_steal_pointer(&bstdout);
 }
 
-static GBytes *
-fwupd_client_download_http(FwupdClient *self, CURL *curl, const gchar *url, GError **error)
+static gboolean
+fwupd_client_download_http_check_result(CURL *curl,
+					CURLcode res,
+					const gchar *errbuf,
+					GError **error)
 {
-	CURLcode res;
-	gchar errbuf[CURL_ERROR_SIZE] = {'\0'};
 	glong status_code = 0;
-	g_autoptr(GByteArray) buf = g_byte_array_new();
 
-	fwupd_client_set_status(self, FWUPD_STATUS_DOWNLOADING);
-	curl_easy_setopt(curl, CURLOPT_URL, url);
-	curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errbuf);
-	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, fwupd_client_download_write_callback_cb);
-	curl_easy_setopt(curl, CURLOPT_WRITEDATA, buf);
-	res = curl_easy_perform(curl);
-	fwupd_client_set_status(self, FWUPD_STATUS_IDLE);
 	if (res != CURLE_OK) {
 		if (errbuf[0] != '\0') {
 			g_set_error(error,
@@ -4739,14 +5772,14 @@ fwupd_client_download_http(FwupdClient *self, CURL *curl, const gchar *url, GErr
 				    FWUPD_ERROR_INVALID_FILE,
 				    "failed to download file: %s",
 				    errbuf);
-			return NULL;
+			return FALSE;
 		}
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_FILE,
 			    "failed to download file: %s",
 			    curl_easy_strerror(res));
-		return NULL;
+		return FALSE;
 	}
 
 	/* check for server limit */
@@ -4757,7 +5790,7 @@ fwupd_client_download_http(FwupdClient *self, CURL *curl, const gchar *url, GErr
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "Failed to download due to server limit");
-		return NULL;
+		return FALSE;
 	}
 	if (status_code >= 400) {
 		g_set_error(error,
@@ -4765,12 +5798,373 @@ fwupd_client_download_http(FwupdClient *self, CURL *curl, const gchar *url, GErr
 			    FWUPD_ERROR_INVALID_FILE,
 			    "Failed to download, server response was %u",
 			    (guint)status_code);
-		return NULL;
+		return FALSE;
 	}
+	return TRUE;
+}
+
+static GBytes *
+fwupd_client_download_http(FwupdClient *self, CURL *curl, const gchar *url, GError **error)
+{
+	CURLcode res;
+	gchar errbuf[CURL_ERROR_SIZE] = {'\0'};
+	g_autoptr(GByteArray) buf = g_byte_array_new();
 
+	fwupd_client_set_status(self, FWUPD_STATUS_DOWNLOADING);
+	curl_easy_setopt(curl, CURLOPT_URL, url);
+	curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errbuf);
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, fwupd_client_download_write_callback_cb);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, buf);
+	res = curl_easy_perform(curl);
+	fwupd_client_set_status(self, FWUPD_STATUS_IDLE);
+	if (!fwupd_client_download_http_check_result(curl, res, errbuf, error))
+		return NULL;
 	return g_byte_array_free_to_bytes(g_steal_pointer(&buf));
 }
 
+typedef struct {
+	gchar *fn;
+	goffset size;
+	gint64 mtime;
+} FwupdClientDownloadCacheItem;
+
+static void
+fwupd_client_download_cache_item_free(FwupdClientDownloadCacheItem *item)
+{
+	g_free(item->fn);
+	g_free(item);
+}
+
+static gint
+fwupd_client_download_cache_item_sort_cb(gconstpointer a, gconstpointer b)
+{
+	FwupdClientDownloadCacheItem *item1 = *((FwupdClientDownloadCacheItem **)a);
+	FwupdClientDownloadCacheItem *item2 = *((FwupdClientDownloadCacheItem **)b);
+	if (item1->mtime < item2->mtime)
+		return -1;
+	if (item1->mtime > item2->mtime)
+		return 1;
+	return 0;
+}
+
+/* the cache directory may be shared, so never follow symlinks or use files owned by others */
+static gboolean
+fwupd_client_download_cache_is_owned(guint32 mode, guint32 uid)
+{
+	if (!S_ISREG(mode))
+		return FALSE;
+#ifdef HAVE_GETUID
+	if (uid != getuid())
+		return FALSE;
+#endif
+	return TRUE;
+}
+
+static gint
+fwupd_client_download_cache_open(const gchar *fn, gint flags, struct stat *st, GError **error)
+{
+	gint fd;
+
+#ifdef O_NOFOLLOW
+	flags |= O_NOFOLLOW;
+#endif
+#ifdef O_CLOEXEC
+	flags |= O_CLOEXEC;
+#endif
+	fd = g_open(fn, flags, 0600);
+	if (fd < 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_READ,
+			    "failed to open %s: %s",
+			    fn,
+			    g_strerror(errno));
+		return -1;
+	}
+	if (fstat(fd, st) != 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_READ,
+			    "failed to stat %s: %s",
+			    fn,
+			    g_strerror(errno));
+		g_close(fd, NULL);
+		return -1;
+	}
+	if (!fwupd_client_download_cache_is_owned(st->st_mode, st->st_uid)) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_PERMISSION_DENIED,
+			    "%s is not a regular file owned by the current user",
+			    fn);
+		g_close(fd, NULL);
+		return -1;
+	}
+	return fd;
+}
+
+/* delete the least recently used files until the cache is small enough */
+static void
+fwupd_client_download_cache_evict(FwupdCurlHelper *helper)
+{
+	const gchar *name;
+	guint64 total = 0;
+	g_autoptr(GDir) dir = NULL;
+	g_autoptr(GPtrArray) items = NULL;
+
+	dir = g_dir_open(helper->cache_dir, 0, NULL);
+	if (dir == NULL)
+		return;
+	items =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fwupd_client_download_cache_item_free);
+	while ((name = g_dir_read_name(dir)) != NULL) {
+		FwupdClientDownloadCacheItem *item;
+		GStatBuf st = {0};
+		g_autofree gchar *fn = g_build_filename(helper->cache_dir, name, NULL);
+
+		/* other users are responsible for their own files */
+		if (g_lstat(fn, &st) != 0)
+			continue;
+		if (!fwupd_client_download_cache_is_owned(st.st_mode, st.st_uid))
+			continue;
+		total += st.st_size;
+		if (g_strcmp0(fn, helper->cache_fn) == 0)
+			continue;
+		item = g_new0(FwupdClientDownloadCacheItem, 1);
+		item->fn = g_steal_pointer(&fn);
+		item->size = st.st_size;
+		item->mtime = st.st_mtime;
+		g_ptr_array_add(items, item);
+	}
+	g_ptr_array_sort(items, fwupd_client_download_cache_item_sort_cb);
+	for (guint i = 0; i < items->len && total > helper->cache_size_max; i++) {
+		FwupdClientDownloadCacheItem *item = g_ptr_array_index(items, i);
+		g_debug("evicting %s from the download cache", item->fn);
+		if (g_unlink(item->fn) != 0) {
+			g_debug("failed to delete %s", item->fn);
+			continue;
+		}
+		total -= item->size;
+	}
+}
+
+static gboolean
+fwupd_client_download_verify_checksum(FwupdCurlHelper *helper,
+				      const guint8 *buf,
+				      gsize bufsz,
+				      GError **error)
+{
+	g_autofree gchar *checksum = NULL;
+	checksum = g_compute_checksum_for_data(fwupd_checksum_guess_kind(helper->checksum),
+					       (const guchar *)buf,
+					       bufsz);
+	if (g_strcmp0(checksum, helper->checksum) != 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "checksum invalid, expected %s got %s",
+			    helper->checksum,
+			    checksum);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* returns the contents of the file only if it matches the expected checksum */
+static GBytes *
+fwupd_client_download_cache_load(FwupdCurlHelper *helper, const gchar *fn, GError **error)
+{
+	gint fd;
+	gsize bufsz;
+	gsize done = 0;
+	struct stat st = {0};
+	g_autofree guint8 *buf = NULL;
+
+	fd = fwupd_client_download_cache_open(fn, O_RDONLY, &st, error);
+	if (fd < 0)
+		return NULL;
+	bufsz = st.st_size;
+	buf = g_malloc(MAX(bufsz, 1));
+	while (done < bufsz) {
+		gssize rc = read(fd, buf + done, bufsz - done);
+		if (rc < 0 && errno == EINTR)
+			continue;
+		if (rc <= 0) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_READ,
+				    "failed to read %s: %s",
+				    fn,
+				    rc < 0 ? g_strerror(errno) : "file truncated");
+			g_close(fd, NULL);
+			return NULL;
+		}
+		done += rc;
+	}
+	g_close(fd, NULL);
+	if (!fwupd_client_download_verify_checksum(helper, buf, bufsz, error)) {
+		g_unlink(fn);
+		return NULL;
+	}
+	return g_bytes_new_take(g_steal_pointer(&buf), bufsz);
+}
+
+static GBytes *
+fwupd_client_download_cache_lookup(FwupdCurlHelper *helper)
+{
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	if (!g_file_test(helper->cache_fn, G_FILE_TEST_EXISTS | G_FILE_TEST_IS_SYMLINK))
+		return NULL;
+	blob = fwupd_client_download_cache_load(helper, helper->cache_fn, &error_local);
+	if (blob == NULL) {
+		g_debug("ignoring %s: %s", helper->cache_fn, error_local->message);
+		return NULL;
+	}
+
+	/* mark as recently used */
+	if (g_utime(helper->cache_fn, NULL) != 0)
+		g_debug("failed to update timestamp of %s", helper->cache_fn);
+	return g_steal_pointer(&blob);
+}
+
+static void
+fwupd_client_download_cache_store(FwupdCurlHelper *helper, GBytes *blob)
+{
+	g_autoptr(GError) error_local = NULL;
+
+	if (!g_file_set_contents(helper->cache_fn,
+				 g_bytes_get_data(blob, NULL),
+				 g_bytes_get_size(blob),
+				 &error_local)) {
+		g_debug("failed to save %s: %s", helper->cache_fn, error_local->message);
+		return;
+	}
+	fwupd_client_download_cache_evict(helper);
+}
+
+typedef struct {
+	CURL *curl;
+	FILE *fp; /* opened for appending */
+	curl_off_t offset;
+	glong status_code;
+} FwupdClientDownloadFileHelper;
+
+static size_t
+fwupd_client_download_file_write_callback_cb(char *ptr, size_t size, size_t nmemb, void *userdata)
+{
+	FwupdClientDownloadFileHelper *helper = (FwupdClientDownloadFileHelper *)userdata;
+	gsize realsize = size * nmemb;
+
+	/* first part of the body */
+	if (helper->status_code == 0) {
+		curl_easy_getinfo(helper->curl, CURLINFO_RESPONSE_CODE, &helper->status_code);
+		if (helper->offset > 0 && helper->status_code == 200) {
+			g_debug("server ignored the range request, restarting download");
+			if (fflush(helper->fp) != 0 || ftruncate(fileno(helper->fp), 0) != 0)
+				return 0;
+		}
+	}
+
+	/* do not append an error page to the partial download */
+	if (helper->status_code >= 400)
+		return realsize;
+	if (fwrite(ptr, 1, realsize, helper->fp) != realsize)
+		return 0;
+	return realsize;
+}
+
+/* downloads into the cache, continuing from any earlier partial download */
+static GBytes *
+fwupd_client_download_http_cached(FwupdClient *self,
+				  FwupdCurlHelper *helper,
+				  const gchar *url,
+				  GError **error)
+{
+	CURLcode res;
+	gint fd;
+	struct stat st = {0};
+	gchar errbuf[CURL_ERROR_SIZE] = {'\0'};
+	glong status_code = 0;
+	g_autofree gchar *fn_part = g_strdup_printf("%s.part", helper->cache_fn);
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error_local = NULL;
+	FwupdClientDownloadFileHelper fhelper = {.curl = helper->curl};
+
+	/* the partial download may be a symlink, or belong to someone else */
+	fd = fwupd_client_download_cache_open(fn_part,
+					      O_WRONLY | O_CREAT | O_APPEND,
+					      &st,
+					      &error_local);
+	if (fd < 0) {
+		g_debug("not using download cache: %s", error_local->message);
+		blob = fwupd_client_download_http(self, helper->curl, url, error);
+		if (blob == NULL)
+			return NULL;
+		if (!fwupd_client_download_verify_checksum(helper,
+							   g_bytes_get_data(blob, NULL),
+							   g_bytes_get_size(blob),
+							   error))
+			return NULL;
+		return g_steal_pointer(&blob);
+	}
+	fhelper.offset = st.st_size;
+	fhelper.fp = fdopen(fd, "ab");
+	if (fhelper.fp == NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_WRITE,
+			    "failed to open %s: %s",
+			    fn_part,
+			    g_strerror(errno));
+		g_close(fd, NULL);
+		return NULL;
+	}
+	if (fhelper.offset > 0)
+		g_debug("resuming %s at offset %" G_GINT64_FORMAT, url, (gint64)fhelper.offset);
+
+	fwupd_client_set_status(self, FWUPD_STATUS_DOWNLOADING);
+	curl_easy_setopt(helper->curl, CURLOPT_URL, url);
+	curl_easy_setopt(helper->curl, CURLOPT_ERRORBUFFER, errbuf);
+	curl_easy_setopt(helper->curl,
+			 CURLOPT_WRITEFUNCTION,
+			 fwupd_client_download_file_write_callback_cb);
+	curl_easy_setopt(helper->curl, CURLOPT_WRITEDATA, &fhelper);
+	curl_easy_setopt(helper->curl, CURLOPT_RESUME_FROM_LARGE, fhelper.offset);
+	res = curl_easy_perform(helper->curl);
+	curl_easy_setopt(helper->curl, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)0);
+	fwupd_client_set_status(self, FWUPD_STATUS_IDLE);
+	if (fhelper.fp != NULL && fclose(fhelper.fp) != 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_WRITE,
+			    "failed to write %s: %s",
+			    fn_part,
+			    g_strerror(errno));
+		return NULL;
+	}
+
+	/* the partial download may have been complete already */
+	curl_easy_getinfo(helper->curl, CURLINFO_RESPONSE_CODE, &status_code);
+	if (res != CURLE_OK || status_code != 416) {
+		if (!fwupd_client_download_http_check_result(helper->curl, res, errbuf, error))
+			return NULL;
+	}
+
+	/* a corrupt partial download is deleted so the next attempt starts again */
+	blob = fwupd_client_download_cache_load(helper, fn_part, error);
+	if (blob == NULL)
+		return NULL;
+	if (g_rename(fn_part, helper->cache_fn) != 0) {
+		g_debug("failed to rename %s: %s", fn_part, g_strerror(errno));
+		g_unlink(fn_part);
+		return g_steal_pointer(&blob);
+	}
+	fwupd_client_download_cache_evict(helper);
+	return g_steal_pointer(&blob);
+}
+
 static void
 fwupd_client_download_bytes_thread_cb(GTask *task,
 				      gpointer source_object,
@@ -4781,19 +6175,57 @@ fwupd_client_download_bytes_thread_cb(GTask *task,
 	FwupdCurlHelper *helper = g_task_get_task_data(task);
 	g_autoptr(GBytes) blob = NULL;
 
+	/* the cache is only used when the expected contents are known */
+	if (helper->cache_fn != NULL) {
+		if (g_mkdir_with_parents(helper->cache_dir, 0700) != 0) {
+			g_debug("not using download cache %s: %s",
+				helper->cache_dir,
+				g_strerror(errno));
+			g_clear_pointer(&helper->cache_fn, g_free);
+		}
+	}
+	if (helper->cache_fn != NULL) {
+		blob = fwupd_client_download_cache_lookup(helper);
+		if (blob != NULL) {
+			g_debug("using cached %s", helper->cache_fn);
+			g_task_return_pointer(task,
+					      g_steal_pointer(&blob),
+					      (GDestroyNotify)g_bytes_unref);
+			return;
+		}
+	}
+
 	for (guint i = 0; i < helper->urls->len; i++) {
 		const gchar *url = g_ptr_array_index(helper->urls, i);
+		glong connect_timeout = 60L;
 		g_autoptr(GError) error = NULL;
 		g_debug("downloading %s", url);
 		fwupd_client_curl_helper_set_proxy(self, helper, url);
+		if (i < helper->mirror_cnt)
+			connect_timeout = FWUPD_CLIENT_MIRROR_CONNECT_TIMEOUT;
+		curl_easy_setopt(helper->curl, CURLOPT_CONNECTTIMEOUT, connect_timeout);
 		if (fwupd_client_is_url_http(url)) {
-			blob = fwupd_client_download_http(self, helper->curl, url, &error);
+			if (helper->cache_fn != NULL) {
+				blob = fwupd_client_download_http_cached(self, helper, url, &error);
+			} else {
+				blob = fwupd_client_download_http(self, helper->curl, url, &error);
+				if (blob != NULL && helper->checksum != NULL &&
+				    !fwupd_client_download_verify_checksum(
+					helper,
+					g_bytes_get_data(blob, NULL),
+					g_bytes_get_size(blob),
+					&error))
+					g_clear_pointer(&blob, g_bytes_unref);
+			}
 			if (blob != NULL)
 				break;
 		} else if (fwupd_client_is_url_ipfs(url)) {
 			blob = fwupd_client_download_ipfs(self, url, cancellable, &error);
-			if (blob != NULL)
+			if (blob != NULL) {
+				if (helper->cache_fn != NULL)
+					fwupd_client_download_cache_store(helper, blob);
 				break;
+			}
 		} else {
 			g_set_error(&error,
 				    FWUPD_ERROR,
@@ -4813,14 +6245,31 @@ fwupd_client_download_bytes_thread_cb(GTask *task,
 }
 #endif
 
-/* private */
+#ifdef HAVE_LIBCURL
+static gboolean
+fwupd_client_download_cache_checksum_valid(const gchar *checksum)
+{
+	if (checksum == NULL || checksum[0] == '\0')
+		return FALSE;
+	for (guint i = 0; checksum[i] != '\0'; i++) {
+		if (!g_ascii_isxdigit(checksum[i]))
+			return FALSE;
+	}
+	return TRUE;
+}
+#endif
+
+/* private: @checksum is used as the key into the download cache, and to find the file on
+ * @mirror_uris -- this does not need the daemon, and is used by the self tests directly */
 void
-fwupd_client_download_bytes2_async(FwupdClient *self,
-				   GPtrArray *urls,
-				   FwupdClientDownloadFlags flags,
-				   GCancellable *cancellable,
-				   GAsyncReadyCallback callback,
-				   gpointer callback_data)
+fwupd_client_download_bytes_cached_async(FwupdClient *self,
+					 GPtrArray *urls,
+					 FwupdClientDownloadFlags flags,
+					 const gchar *checksum,
+					 gchar **mirror_uris,
+					 GCancellable *cancellable,
+					 GAsyncReadyCallback callback,
+					 gpointer callback_data)
 {
 	FwupdClientPrivate *priv = GET_PRIVATE(self);
 	g_autoptr(GTask) task = NULL;
@@ -4832,7 +6281,6 @@ fwupd_client_download_bytes2_async(FwupdClient *self,
 	g_return_if_fail(FWUPD_IS_CLIENT(self));
 	g_return_if_fail(urls != NULL);
 	g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable));
-	g_return_if_fail(priv->proxy != NULL);
 
 	/* ensure networking set up */
 	task = g_task_new(self, cancellable, callback, callback_data);
@@ -4847,6 +6295,27 @@ fwupd_client_download_bytes2_async(FwupdClient *self,
 		g_task_return_error(task, g_steal_pointer(&error));
 		return;
 	}
+	if (fwupd_client_download_cache_checksum_valid(checksum))
+		helper->checksum = g_strdup(checksum);
+
+	/* servers on the local network are tried first, as served by `fwupdtool serve-mirror` */
+	if (mirror_uris != NULL && helper->checksum != NULL &&
+	    (flags & FWUPD_CLIENT_DOWNLOAD_FLAG_ONLY_IPFS) == 0) {
+		for (guint i = 0; mirror_uris[i] != NULL; i++) {
+			g_autofree gchar *base = g_strdup(mirror_uris[i]);
+			g_autofree gchar *url = NULL;
+			while (g_str_has_suffix(base, "/"))
+				base[strlen(base) - 1] = '\0';
+			url = g_strdup_printf("%s/checksum/%s", base, helper->checksum);
+			g_ptr_array_insert(helper->urls, helper->mirror_cnt, g_steal_pointer(&url));
+			helper->mirror_cnt++;
+		}
+	}
+	if (priv->download_cache_dir != NULL && helper->checksum != NULL) {
+		helper->cache_dir = g_strdup(priv->download_cache_dir);
+		helper->cache_fn = g_build_filename(priv->download_cache_dir, checksum, NULL);
+		helper->cache_size_max = priv->download_cache_size_max;
+	}
 	g_task_set_task_data(task,
 			     g_steal_pointer(&helper),
 			     (GDestroyNotify)fwupd_client_curl_helper_free);
@@ -4858,6 +6327,385 @@ fwupd_client_download_bytes2_async(FwupdClient *self,
 #endif
 }
 
+#ifdef HAVE_LIBCURL
+typedef struct {
+	gchar *checksum;
+	gsize offset;
+	gsize size;
+	GBytes *blob; /* (nullable): set when found locally or downloaded */
+} FwupdClientMetadataChunk;
+
+typedef struct {
+	FwupdCurlHelper *curl_helper;
+	gchar *metadata_uri;
+	gchar *filename_old;
+	gchar *checksum; /* from the signature */
+} FwupdClientMetadataDeltaHelper;
+
+static void
+fwupd_client_metadata_chunk_free(FwupdClientMetadataChunk *chunk)
+{
+	if (chunk->blob != NULL)
+		g_bytes_unref(chunk->blob);
+	g_free(chunk->checksum);
+	g_free(chunk);
+}
+
+static void
+fwupd_client_metadata_delta_helper_free(FwupdClientMetadataDeltaHelper *helper)
+{
+	if (helper->curl_helper != NULL)
+		fwupd_client_curl_helper_free(helper->curl_helper);
+	g_free(helper->metadata_uri);
+	g_free(helper->filename_old);
+	g_free(helper->checksum);
+	g_free(helper);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FwupdClientMetadataDeltaHelper,
+			      fwupd_client_metadata_delta_helper_free)
+
+static GPtrArray *
+fwupd_client_metadata_chunks_parse(GBytes *index, GError **error)
+{
+	gsize offset = 0;
+	g_autofree gchar *str = g_strndup(g_bytes_get_data(index, NULL), g_bytes_get_size(index));
+	g_auto(GStrv) lines = g_strsplit(str, "\n", -1);
+	g_autoptr(GPtrArray) chunks =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fwupd_client_metadata_chunk_free);
+
+	if (g_strcmp0(lines[0], FWUPD_CHUNK_INDEX_HEADER) != 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "chunk index format not supported");
+		return NULL;
+	}
+	for (guint i = 1; lines[i] != NULL; i++) {
+		FwupdClientMetadataChunk *chunk;
+		gchar *endptr = NULL;
+		guint64 size;
+		g_auto(GStrv) split = NULL;
+
+		if (lines[i][0] == '\0')
+			continue;
+		split = g_strsplit(lines[i], " ", -1);
+		if (g_strv_length(split) != 2 || strlen(split[0]) != 64 ||
+		    !fwupd_client_download_cache_checksum_valid(split[0])) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "invalid chunk index line %u",
+				    i + 1);
+			return NULL;
+		}
+		size = g_ascii_strtoull(split[1], &endptr, 10);
+		if (endptr == split[1] || *endptr != '\0' || size == 0 || size > G_MAXUINT32) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "invalid chunk size on line %u",
+				    i + 1);
+			return NULL;
+		}
+		chunk = g_new0(FwupdClientMetadataChunk, 1);
+		chunk->checksum = g_ascii_strdown(split[0], -1);
+		chunk->offset = offset;
+		chunk->size = size;
+		g_ptr_array_add(chunks, chunk);
+		offset += size;
+	}
+	if (chunks->len == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "chunk index is empty");
+		return NULL;
+	}
+	return g_steal_pointer(&chunks);
+}
+
+static GBytes *
+fwupd_client_download_http_range(FwupdClient *self,
+				 CURL *curl,
+				 const gchar *url,
+				 gsize offset,
+				 gsize length,
+				 GError **error)
+{
+	glong status_code = 0;
+	g_autofree gchar *range = NULL;
+	g_autoptr(GBytes) blob = NULL;
+
+	range = g_strdup_printf("%" G_GSIZE_FORMAT "-%" G_GSIZE_FORMAT,
+				offset,
+				offset + length - 1);
+	curl_easy_setopt(curl, CURLOPT_RANGE, range);
+	blob = fwupd_client_download_http(self, curl, url, error);
+	curl_easy_setopt(curl, CURLOPT_RANGE, NULL);
+	if (blob == NULL)
+		return NULL;
+	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status_code);
+	if (status_code != 206 || g_bytes_get_size(blob) != length) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "server did not return bytes %s of %s",
+			    range,
+			    url);
+		return NULL;
+	}
+	return g_steal_pointer(&blob);
+}
+
+static void
+fwupd_client_download_metadata_delta_thread_cb(GTask *task,
+					       gpointer source_object,
+					       gpointer task_data,
+					       GCancellable *cancellable)
+{
+	FwupdClient *self = FWUPD_CLIENT(source_object);
+	FwupdClientMetadataDeltaHelper *helper = g_task_get_task_data(task);
+	CURL *curl = helper->curl_helper->curl;
+	gsize size_missing = 0;
+	gsize size_total = 0;
+	gchar *data_old = NULL;
+	gsize datasz_old = 0;
+	g_autofree gchar *checksum = NULL;
+	g_autofree gchar *index_uri = g_strdup_printf("%s.chunks", helper->metadata_uri);
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) blob_old = NULL;
+	g_autoptr(GBytes) index = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) chunks_old = NULL;
+	g_autoptr(GPtrArray) chunks = NULL;
+	g_autoptr(GPtrArray) chunks_old_array = NULL;
+
+	/* what we already have, which the daemon saved when it was last refreshed */
+	if (!g_file_get_contents(helper->filename_old, &data_old, &datasz_old, &error)) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+	blob_old = g_bytes_new_take(data_old, datasz_old);
+	chunks_old_array = fwupd_common_chunk_bytes(blob_old);
+	chunks_old = g_hash_table_new_full(g_str_hash,
+					   g_str_equal,
+					   g_free,
+					   (GDestroyNotify)g_bytes_unref);
+	for (guint i = 0; i < chunks_old_array->len; i++) {
+		GBytes *chunk_old = g_ptr_array_index(chunks_old_array, i);
+		g_hash_table_insert(chunks_old,
+				    g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, chunk_old),
+				    g_bytes_ref(chunk_old));
+	}
+
+	/* what the new metadata is made from */
+	fwupd_client_curl_helper_set_proxy(self, helper->curl_helper, index_uri);
+	index = fwupd_client_download_http(self, curl, index_uri, &error);
+	if (index == NULL) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+	chunks = fwupd_client_metadata_chunks_parse(index, &error);
+	if (chunks == NULL) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+	for (guint i = 0; i < chunks->len; i++) {
+		FwupdClientMetadataChunk *chunk = g_ptr_array_index(chunks, i);
+		GBytes *chunk_old = g_hash_table_lookup(chunks_old, chunk->checksum);
+		if (chunk_old != NULL && g_bytes_get_size(chunk_old) == chunk->size)
+			chunk->blob = g_bytes_ref(chunk_old);
+		else
+			size_missing += chunk->size;
+		size_total += chunk->size;
+	}
+
+	/* one request for the whole file is better than lots of small ones */
+	if (size_missing * 2 > size_total) {
+		g_set_error(&error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "%" G_GSIZE_FORMAT " of %" G_GSIZE_FORMAT " bytes have changed",
+			    size_missing,
+			    size_total);
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+
+	/* download each run of missing chunks using one range request */
+	for (guint i = 0; i < chunks->len; i++) {
+		FwupdClientMetadataChunk *chunk = g_ptr_array_index(chunks, i);
+		FwupdClientMetadataChunk *chunk_last = chunk;
+		gsize length;
+		guint j;
+		g_autoptr(GBytes) blob = NULL;
+
+		if (chunk->blob != NULL)
+			continue;
+		for (j = i + 1; j < chunks->len; j++) {
+			FwupdClientMetadataChunk *chunk_tmp = g_ptr_array_index(chunks, j);
+			if (chunk_tmp->blob != NULL)
+				break;
+			chunk_last = chunk_tmp;
+		}
+		length = chunk_last->offset + chunk_last->size - chunk->offset;
+		blob = fwupd_client_download_http_range(self,
+							curl,
+							helper->metadata_uri,
+							chunk->offset,
+							length,
+							&error);
+		if (blob == NULL) {
+			g_task_return_error(task, g_steal_pointer(&error));
+			return;
+		}
+		for (guint k = i; k < j; k++) {
+			FwupdClientMetadataChunk *chunk_tmp = g_ptr_array_index(chunks, k);
+			g_autofree gchar *checksum_tmp = NULL;
+			chunk_tmp->blob = g_bytes_new_from_bytes(blob,
+								 chunk_tmp->offset - chunk->offset,
+								 chunk_tmp->size);
+			checksum_tmp =
+			    g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, chunk_tmp->blob);
+			if (g_strcmp0(checksum_tmp, chunk_tmp->checksum) != 0) {
+				g_task_return_new_error(task,
+							FWUPD_ERROR,
+							FWUPD_ERROR_INVALID_FILE,
+							"chunk %u checksum was %s, expected %s",
+							k,
+							checksum_tmp,
+							chunk_tmp->checksum);
+				return;
+			}
+		}
+		i = j - 1;
+	}
+
+	/* the index is not signed, so check the result against the signature */
+	for (guint i = 0; i < chunks->len; i++) {
+		FwupdClientMetadataChunk *chunk = g_ptr_array_index(chunks, i);
+		g_byte_array_append(buf,
+				    g_bytes_get_data(chunk->blob, NULL),
+				    g_bytes_get_size(chunk->blob));
+	}
+	checksum = g_compute_checksum_for_data(G_CHECKSUM_SHA256, buf->data, buf->len);
+	if (g_ascii_strcasecmp(checksum, helper->checksum) != 0) {
+		g_task_return_new_error(task,
+					FWUPD_ERROR,
+					FWUPD_ERROR_INVALID_FILE,
+					"reconstructed metadata checksum was %s, expected %s",
+					checksum,
+					helper->checksum);
+		return;
+	}
+	g_debug("reused %" G_GSIZE_FORMAT " of %" G_GSIZE_FORMAT " bytes of metadata",
+		size_total - size_missing,
+		size_total);
+	g_task_return_pointer(task,
+			      g_byte_array_free_to_bytes(g_steal_pointer(&buf)),
+			      (GDestroyNotify)g_bytes_unref);
+}
+
+/* the checksum of the metadata that was signed, which is only included by JCat */
+static gchar *
+fwupd_client_download_metadata_delta_get_checksum(FwupdRemote *remote,
+						  GBytes *signature,
+						  GError **error)
+{
+	g_autofree gchar *basename = NULL;
+	g_autoptr(GInputStream) istr = g_memory_input_stream_new_from_bytes(signature);
+	g_autoptr(GPtrArray) blobs = NULL;
+	g_autoptr(JcatFile) jcat_file = jcat_file_new();
+	g_autoptr(JcatItem) jcat_item = NULL;
+
+	if (!jcat_file_import_stream(jcat_file, istr, JCAT_IMPORT_FLAG_NONE, NULL, error))
+		return NULL;
+	basename = g_path_get_basename(fwupd_remote_get_metadata_uri(remote));
+	jcat_item = jcat_file_get_item_by_id(jcat_file, basename, NULL);
+	if (jcat_item == NULL) {
+		jcat_item = jcat_file_get_item_default(jcat_file, error);
+		if (jcat_item == NULL)
+			return NULL;
+	}
+	blobs = jcat_item_get_blobs_by_kind(jcat_item, JCAT_BLOB_KIND_SHA256);
+	if (blobs->len == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "signature has no SHA256 checksum");
+		return NULL;
+	}
+	return jcat_blob_get_data_as_string(g_ptr_array_index(blobs, 0));
+}
+#endif
+
+/* rebuilds the metadata using the chunks of the copy saved by the daemon, only downloading
+ * the chunks that have changed -- the index is published at `${MetadataURI}.chunks` */
+static void
+fwupd_client_download_metadata_delta_async(FwupdClient *self,
+					   FwupdRemote *remote,
+					   GBytes *signature,
+					   GCancellable *cancellable,
+					   GAsyncReadyCallback callback,
+					   gpointer callback_data)
+{
+	g_autoptr(GTask) task = g_task_new(self, cancellable, callback, callback_data);
+#ifdef HAVE_LIBCURL
+	g_autoptr(FwupdClientMetadataDeltaHelper) helper = NULL;
+	g_autoptr(GError) error = NULL;
+
+	helper = g_new0(FwupdClientMetadataDeltaHelper, 1);
+	helper->checksum =
+	    fwupd_client_download_metadata_delta_get_checksum(remote, signature, &error);
+	if (helper->checksum == NULL) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+	helper->curl_helper = fwupd_client_curl_new(self, &error);
+	if (helper->curl_helper == NULL) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+	helper->metadata_uri = g_strdup(fwupd_remote_get_metadata_uri(remote));
+	helper->filename_old = g_strdup(fwupd_remote_get_filename_cache(remote));
+	g_task_set_task_data(task,
+			     g_steal_pointer(&helper),
+			     (GDestroyNotify)fwupd_client_metadata_delta_helper_free);
+	g_task_run_in_thread(task, fwupd_client_download_metadata_delta_thread_cb);
+#else
+	g_task_return_new_error(task, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no libcurl support");
+#endif
+}
+
+static GBytes *
+fwupd_client_download_metadata_delta_finish(FwupdClient *self, GAsyncResult *res, GError **error)
+{
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(g_task_is_valid(res, self), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+	return g_task_propagate_pointer(G_TASK(res), error);
+}
+
+/* private */
+void
+fwupd_client_download_bytes2_async(FwupdClient *self,
+				   GPtrArray *urls,
+				   FwupdClientDownloadFlags flags,
+				   GCancellable *cancellable,
+				   GAsyncReadyCallback callback,
+				   gpointer callback_data)
+{
+	fwupd_client_download_bytes_cached_async(self,
+						 urls,
+						 flags,
+						 NULL,
+						 NULL,
+						 cancellable,
+						 callback,
+						 callback_data);
+}
+
 /**
  * fwupd_client_download_bytes_async:
  * @self: a #FwupdClient
@@ -5163,6 +7011,12 @@ fwupd_client_get_property(GObject *object, guint prop_id, GValue *value, GParamS
 	case PROP_PERCENTAGE:
 		g_value_set_uint(value, priv->percentage);
 		break;
+	case PROP_ETA:
+		g_value_set_uint(value, priv->eta);
+		break;
+	case PROP_THROUGHPUT:
+		g_value_set_uint64(value, priv->throughput);
+		break;
 	case PROP_DAEMON_VERSION:
 		g_value_set_string(value, priv->daemon_version);
 		break;
@@ -5406,6 +7260,38 @@ fwupd_client_class_init(FwupdClientClass *klass)
 				  G_PARAM_READWRITE | G_PARAM_STATIC_NAME);
 	g_object_class_install_property(object_class, PROP_PERCENTAGE, pspec);
 
+	/**
+	 * FwupdClient:eta:
+	 *
+	 * The last-reported estimate of the seconds remaining for the daemon job.
+	 *
+	 * Since: 1.8.0
+	 */
+	pspec = g_param_spec_uint("eta",
+				  NULL,
+				  NULL,
+				  0,
+				  G_MAXUINT,
+				  0,
+				  G_PARAM_READABLE | G_PARAM_STATIC_NAME);
+	g_object_class_install_property(object_class, PROP_ETA, pspec);
+
+	/**
+	 * FwupdClient:throughput:
+	 *
+	 * The last-reported transfer rate of the daemon job in bytes per second.
+	 *
+	 * Since: 1.8.0
+	 */
+	pspec = g_param_spec_uint64("throughput",
+				    NULL,
+				    NULL,
+				    0,
+				    G_MAXUINT64,
+				    0,
+				    G_PARAM_READABLE | G_PARAM_STATIC_NAME);
+	g_object_class_install_property(object_class, PROP_THROUGHPUT, pspec);
+
 	/**
 	 * FwupdClient:daemon-version:
 	 *
@@ -5515,6 +7401,28 @@ fwupd_client_init(FwupdClient *self)
 	    g_ptr_array_new_with_free_func((GDestroyNotify)fwupd_client_context_helper_free);
 	priv->proxy_resolver = g_proxy_resolver_get_default();
 	priv->hints = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	g_mutex_init(&priv->device_cache_mutex);
+	priv->download_cache_size_max = FWUPD_CLIENT_DOWNLOAD_CACHE_SIZE_MAX;
+	priv->download_cache_dir = g_strdup(g_getenv("FWUPD_DOWNLOAD_CACHE_DIR"));
+#ifdef HAVE_LIBCURL
+	for (guint i = 0; i < CURL_LOCK_DATA_LAST; i++)
+		g_mutex_init(&priv->curlsh_mutexes[i]);
+	priv->curlsh = curl_share_init();
+	if (priv->curlsh != NULL) {
+		curl_share_setopt(priv->curlsh,
+				  CURLSHOPT_LOCKFUNC,
+				  fwupd_client_curl_share_lock_cb);
+		curl_share_setopt(priv->curlsh,
+				  CURLSHOPT_UNLOCKFUNC,
+				  fwupd_client_curl_share_unlock_cb);
+		curl_share_setopt(priv->curlsh, CURLSHOPT_USERDATA, priv);
+		curl_share_setopt(priv->curlsh, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+		curl_share_setopt(priv->curlsh, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+	}
+	g_mutex_init(&priv->transfers_mutex);
+	priv->transfers = g_ptr_array_new();
+	priv->curl_pool = g_ptr_array_new();
+#endif
 
 	/* we get this one for free */
 	fwupd_client_add_hint(self, "locale", g_getenv("LANG"));
@@ -5528,12 +7436,18 @@ fwupd_client_finalize(GObject *object)
 
 	g_clear_pointer(&priv->main_ctx, g_main_context_unref);
 	g_free(priv->user_agent);
+	g_free(priv->download_cache_dir);
 	g_free(priv->daemon_version);
 	g_free(priv->host_bkc);
 	g_free(priv->host_product);
 	g_free(priv->host_machine_id);
 	g_free(priv->host_security_id);
 	g_hash_table_unref(priv->hints);
+	if (priv->device_cache_by_id != NULL)
+		g_hash_table_unref(priv->device_cache_by_id);
+	if (priv->device_cache != NULL)
+		g_ptr_array_unref(priv->device_cache);
+	g_mutex_clear(&priv->device_cache_mutex);
 	g_mutex_clear(&priv->idle_mutex);
 	if (priv->idle_id != 0)
 		g_source_remove(priv->idle_id);
@@ -5541,6 +7455,17 @@ fwupd_client_finalize(GObject *object)
 	g_mutex_clear(&priv->proxy_mutex);
 	if (priv->proxy != NULL)
 		g_object_unref(priv->proxy);
+#ifdef HAVE_LIBCURL
+	for (guint i = 0; i < priv->curl_pool->len; i++)
+		curl_easy_cleanup(g_ptr_array_index(priv->curl_pool, i));
+	g_ptr_array_unref(priv->curl_pool);
+	if (priv->curlsh != NULL)
+		curl_share_cleanup(priv->curlsh);
+	for (guint i = 0; i < CURL_LOCK_DATA_LAST; i++)
+		g_mutex_clear(&priv->curlsh_mutexes[i]);
+	g_ptr_array_unref(priv->transfers);
+	g_mutex_clear(&priv->transfers_mutex);
+#endif
 #ifdef SOUP_SESSION_COMPAT
 	if (priv->soup_session != NULL)
 		g_object_unref(priv->soup_session);
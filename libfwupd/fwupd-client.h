@@ -14,6 +14,7 @@
 #include "fwupd-plugin.h"
 #include "fwupd-remote.h"
 #include "fwupd-request.h"
+#include "fwupd-statistic.h"
 
 G_BEGIN_DECLS
 
@@ -240,6 +241,17 @@ fwupd_client_get_host_security_events_finish(FwupdClient *self,
 					     GAsyncResult *res,
 					     GError **error) G_GNUC_WARN_UNUSED_RESULT;
 void
+fwupd_client_get_host_security_events_full_async(FwupdClient *self,
+						 guint limit,
+						 guint offset,
+						 GCancellable *cancellable,
+						 GAsyncReadyCallback callback,
+						 gpointer callback_data);
+GPtrArray *
+fwupd_client_get_host_security_events_full_finish(FwupdClient *self,
+						  GAsyncResult *res,
+						  GError **error) G_GNUC_WARN_UNUSED_RESULT;
+void
 fwupd_client_get_device_by_id_async(FwupdClient *self,
 				    const gchar *device_id,
 				    GCancellable *cancellable,
@@ -328,6 +340,16 @@ fwupd_client_refresh_remote_finish(FwupdClient *self,
 				   GAsyncResult *res,
 				   GError **error) G_GNUC_WARN_UNUSED_RESULT;
 void
+fwupd_client_refresh_remotes_async(FwupdClient *self,
+				   GPtrArray *remotes,
+				   GCancellable *cancellable,
+				   GAsyncReadyCallback callback,
+				   gpointer callback_data);
+gboolean
+fwupd_client_refresh_remotes_finish(FwupdClient *self,
+				    GAsyncResult *res,
+				    GError **error) G_GNUC_WARN_UNUSED_RESULT;
+void
 fwupd_client_modify_remote_async(FwupdClient *self,
 				 const gchar *remote_id,
 				 const gchar *key,
@@ -360,6 +382,15 @@ GHashTable *
 fwupd_client_get_report_metadata_finish(FwupdClient *self,
 					GAsyncResult *res,
 					GError **error) G_GNUC_WARN_UNUSED_RESULT;
+void
+fwupd_client_get_statistics_async(FwupdClient *self,
+				  GCancellable *cancellable,
+				  GAsyncReadyCallback callback,
+				  gpointer callback_data);
+GPtrArray *
+fwupd_client_get_statistics_finish(FwupdClient *self,
+				   GAsyncResult *res,
+				   GError **error) G_GNUC_WARN_UNUSED_RESULT;
 
 FwupdStatus
 fwupd_client_get_status(FwupdClient *self);
@@ -371,6 +402,10 @@ gboolean
 fwupd_client_get_daemon_interactive(FwupdClient *self);
 guint
 fwupd_client_get_percentage(FwupdClient *self);
+guint
+fwupd_client_get_eta(FwupdClient *self);
+guint64
+fwupd_client_get_throughput(FwupdClient *self);
 const gchar *
 fwupd_client_get_daemon_version(FwupdClient *self);
 const gchar *
@@ -464,6 +499,20 @@ const gchar *
 fwupd_client_get_user_agent(FwupdClient *self);
 void
 fwupd_client_set_user_agent(FwupdClient *self, const gchar *user_agent);
+const gchar *
+fwupd_client_get_download_cache_dir(FwupdClient *self);
+void
+fwupd_client_set_download_cache_dir(FwupdClient *self, const gchar *download_cache_dir);
+guint64
+fwupd_client_get_download_cache_size_max(FwupdClient *self);
+void
+fwupd_client_set_download_cache_size_max(FwupdClient *self, guint64 download_cache_size_max);
+gboolean
+fwupd_client_get_device_cache_enabled(FwupdClient *self);
+void
+fwupd_client_set_device_cache_enabled(FwupdClient *self, gboolean device_cache_enabled);
+guint64
+fwupd_client_get_device_cache_generation(FwupdClient *self);
 void
 fwupd_client_set_user_agent_for_package(FwupdClient *self,
 					const gchar *package_name,
@@ -18,6 +18,9 @@
 
 G_BEGIN_DECLS
 
+/* the first line of the index published next to the metadata */
+#define FWUPD_CHUNK_INDEX_HEADER "# fwupd-chunk-index 1"
+
 GVariant *
 fwupd_hash_kv_to_variant(GHashTable *hash);
 GHashTable *
@@ -44,6 +47,11 @@ fwupd_common_json_add_int(JsonBuilder *builder, const gchar *key, guint64 value)
 void
 fwupd_common_json_add_boolean(JsonBuilder *builder, const gchar *key, gboolean value);
 
+GPtrArray *
+fwupd_common_chunk_bytes(GBytes *blob);
+gchar *
+fwupd_common_chunk_index_build(GBytes *blob);
+
 #ifdef HAVE_GIO_UNIX
 GUnixInputStream *
 fwupd_unix_input_stream_from_bytes(GBytes *bytes, GError **error) G_GNUC_WARN_UNUSED_RESULT;
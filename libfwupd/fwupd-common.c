@@ -1202,3 +1202,94 @@ fwupd_common_json_add_stringv(JsonBuilder *builder, const gchar *key, gchar **va
 		json_builder_add_string_value(builder, value[i]);
 	json_builder_end_array(builder);
 }
+
+/* the boundaries only depend on the previous 32 bytes, so an edit only changes the chunks
+ * either side of it -- these values can never change as the index is built by the publisher */
+#define FWUPD_CHUNK_SIZE_MIN 0x800	 /* 2 KiB */
+#define FWUPD_CHUNK_SIZE_MAX 0x10000	 /* 64 KiB */
+#define FWUPD_CHUNK_MASK     0xFFF80000u /* about 8 KiB after the minimum */
+
+static void
+fwupd_common_chunk_gear_init(guint32 *gear)
+{
+	guint32 seed = 0x2545F491;
+	for (guint i = 0; i < 256; i++) {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		gear[i] = seed;
+	}
+}
+
+/**
+ * fwupd_common_chunk_bytes:
+ * @blob: a #GBytes
+ *
+ * Splits a blob into content-defined chunks, so that a small change to the blob only changes
+ * one or two chunks. For compressed metadata this only works if the file was created with the
+ * `--rsyncable` option of `gzip` or `zstd`.
+ *
+ * Returns: (transfer container) (element-type GBytes): chunks that reference @blob
+ *
+ * Since: 1.8.0
+ **/
+GPtrArray *
+fwupd_common_chunk_bytes(GBytes *blob)
+{
+	const guint8 *buf;
+	gsize bufsz = 0;
+	gsize offset = 0;
+	guint32 gear[256];
+	GPtrArray *chunks = g_ptr_array_new_with_free_func((GDestroyNotify)g_bytes_unref);
+
+	g_return_val_if_fail(blob != NULL, NULL);
+
+	fwupd_common_chunk_gear_init(gear);
+	buf = g_bytes_get_data(blob, &bufsz);
+	while (offset < bufsz) {
+		gsize len = MIN(bufsz - offset, FWUPD_CHUNK_SIZE_MAX);
+		gsize i;
+		guint32 hash = 0;
+		for (i = 0; i < len; i++) {
+			hash = (hash << 1) + gear[buf[offset + i]];
+			if (i + 1 >= FWUPD_CHUNK_SIZE_MIN && (hash & FWUPD_CHUNK_MASK) == 0) {
+				i++;
+				break;
+			}
+		}
+		g_ptr_array_add(chunks, g_bytes_new_from_bytes(blob, offset, i));
+		offset += i;
+	}
+	return chunks;
+}
+
+/**
+ * fwupd_common_chunk_index_build:
+ * @blob: a #GBytes
+ *
+ * Builds the index that is published next to the metadata, which has one line with the SHA-256
+ * checksum and size of each chunk.
+ *
+ * Returns: (transfer full): the index text
+ *
+ * Since: 1.8.0
+ **/
+gchar *
+fwupd_common_chunk_index_build(GBytes *blob)
+{
+	GString *str = g_string_new(FWUPD_CHUNK_INDEX_HEADER "\n");
+	g_autoptr(GPtrArray) chunks = NULL;
+
+	g_return_val_if_fail(blob != NULL, NULL);
+
+	chunks = fwupd_common_chunk_bytes(blob);
+	for (guint i = 0; i < chunks->len; i++) {
+		GBytes *chunk = g_ptr_array_index(chunks, i);
+		g_autofree gchar *checksum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, chunk);
+		g_string_append_printf(str,
+				       "%s %" G_GSIZE_FORMAT "\n",
+				       checksum,
+				       g_bytes_get_size(chunk));
+	}
+	return g_string_free(str, FALSE);
+}
@@ -28,6 +28,8 @@ static void
 fwupd_device_finalize(GObject *object);
 
 typedef struct {
+	GVariant *value; /* (nullable): serialized data that has not been decoded yet */
+	gboolean value_decoding;
 	gchar *id;
 	gchar *parent_id;
 	gchar *composite_id;
@@ -86,7 +88,42 @@ enum {
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE(FwupdDevice, fwupd_device, G_TYPE_OBJECT)
-#define GET_PRIVATE(o) (fwupd_device_get_instance_private(o))
+#define GET_PRIVATE(o) (fwupd_device_get_private(o))
+
+/* protects decoding the serialized data of all devices, which only happens once for each */
+static GRecMutex fwupd_device_value_mutex;
+
+static void
+fwupd_device_set_from_variant_iter(FwupdDevice *self, GVariantIter *iter);
+
+/* devices created from a variant are decoded the first time any property is used */
+static FwupdDevicePrivate *
+fwupd_device_get_private(FwupdDevice *self)
+{
+	FwupdDevicePrivate *priv;
+	GVariant *value;
+
+	if (self == NULL)
+		return NULL;
+	priv = fwupd_device_get_instance_private(self);
+	if (G_LIKELY(g_atomic_pointer_get(&priv->value) == NULL))
+		return priv;
+
+	/* the adders used when decoding get here too */
+	g_rec_mutex_lock(&fwupd_device_value_mutex);
+	value = priv->value;
+	if (value != NULL && !priv->value_decoding) {
+		GVariantIter iter;
+		priv->value_decoding = TRUE;
+		g_variant_iter_init(&iter, value);
+		fwupd_device_set_from_variant_iter(self, &iter);
+		priv->value_decoding = FALSE;
+		g_atomic_pointer_set(&priv->value, NULL);
+		g_variant_unref(value);
+	}
+	g_rec_mutex_unlock(&fwupd_device_value_mutex);
+	return priv;
+}
 
 /**
  * fwupd_device_get_checksums:
@@ -481,6 +518,19 @@ fwupd_device_get_root(FwupdDevice *self)
 	return self;
 }
 
+/* the parent is not part of the serialized data, so this does not decode the device */
+static void
+fwupd_device_set_parent_internal(FwupdDevice *self, FwupdDevice *parent)
+{
+	FwupdDevicePrivate *priv = fwupd_device_get_instance_private(self);
+
+	if (priv->parent != NULL)
+		g_object_remove_weak_pointer(G_OBJECT(priv->parent), (gpointer *)&priv->parent);
+	if (parent != NULL)
+		g_object_add_weak_pointer(G_OBJECT(parent), (gpointer *)&priv->parent);
+	priv->parent = parent;
+}
+
 /**
  * fwupd_device_set_parent:
  * @self: a #FwupdDevice
@@ -493,14 +543,9 @@ fwupd_device_get_root(FwupdDevice *self)
 void
 fwupd_device_set_parent(FwupdDevice *self, FwupdDevice *parent)
 {
-	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
 
-	if (priv->parent != NULL)
-		g_object_remove_weak_pointer(G_OBJECT(priv->parent), (gpointer *)&priv->parent);
-	if (parent != NULL)
-		g_object_add_weak_pointer(G_OBJECT(parent), (gpointer *)&priv->parent);
-	priv->parent = parent;
+	fwupd_device_set_parent_internal(self, parent);
 
 	/* this is what goes over D-Bus */
 	fwupd_device_set_parent_id(self, parent != NULL ? fwupd_device_get_id(parent) : NULL);
@@ -2025,8 +2070,13 @@ fwupd_device_to_variant(FwupdDevice *self)
 	return fwupd_device_to_variant_full(self, FWUPD_DEVICE_FLAG_NONE);
 }
 
+/* fields are assigned directly as this runs with the decoding lock held, and so must not
+ * emit ::notify -- the device is only just being decoded so nothing has changed anyway */
 static void
-fwupd_device_from_key_value(FwupdDevice *self, const gchar *key, GVariant *value)
+fwupd_device_from_key_value(FwupdDevice *self,
+			    FwupdDevicePrivate *priv,
+			    const gchar *key,
+			    GVariant *value)
 {
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_RELEASE) == 0) {
 		GVariantIter iter;
@@ -2041,31 +2091,34 @@ fwupd_device_from_key_value(FwupdDevice *self, const gchar *key, GVariant *value
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_DEVICE_ID) == 0) {
-		fwupd_device_set_id(self, g_variant_get_string(value, NULL));
+		g_free(priv->id);
+		priv->id = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_PARENT_DEVICE_ID) == 0) {
-		fwupd_device_set_parent_id(self, g_variant_get_string(value, NULL));
+		g_free(priv->parent_id);
+		priv->parent_id = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_COMPOSITE_ID) == 0) {
-		fwupd_device_set_composite_id(self, g_variant_get_string(value, NULL));
+		g_free(priv->composite_id);
+		priv->composite_id = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_FLAGS) == 0) {
-		fwupd_device_set_flags(self, g_variant_get_uint64(value));
+		priv->flags = g_variant_get_uint64(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_CREATED) == 0) {
-		fwupd_device_set_created(self, g_variant_get_uint64(value));
+		priv->created = g_variant_get_uint64(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_MODIFIED) == 0) {
-		fwupd_device_set_modified(self, g_variant_get_uint64(value));
+		priv->modified = g_variant_get_uint64(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_BUILD_DATE) == 0) {
-		fwupd_device_set_version_build_date(self, g_variant_get_uint64(value));
+		priv->version_build_date = g_variant_get_uint64(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_GUID) == 0) {
@@ -2087,11 +2140,13 @@ fwupd_device_from_key_value(FwupdDevice *self, const gchar *key, GVariant *value
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_NAME) == 0) {
-		fwupd_device_set_name(self, g_variant_get_string(value, NULL));
+		g_free(priv->name);
+		priv->name = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_VENDOR) == 0) {
-		fwupd_device_set_vendor(self, g_variant_get_string(value, NULL));
+		g_free(priv->vendor);
+		priv->vendor = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_VENDOR_ID) == 0) {
@@ -2102,19 +2157,23 @@ fwupd_device_from_key_value(FwupdDevice *self, const gchar *key, GVariant *value
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_SERIAL) == 0) {
-		fwupd_device_set_serial(self, g_variant_get_string(value, NULL));
+		g_free(priv->serial);
+		priv->serial = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_SUMMARY) == 0) {
-		fwupd_device_set_summary(self, g_variant_get_string(value, NULL));
+		g_free(priv->summary);
+		priv->summary = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_BRANCH) == 0) {
-		fwupd_device_set_branch(self, g_variant_get_string(value, NULL));
+		g_free(priv->branch);
+		priv->branch = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_DESCRIPTION) == 0) {
-		fwupd_device_set_description(self, g_variant_get_string(value, NULL));
+		g_free(priv->description);
+		priv->description = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_CHECKSUM) == 0) {
@@ -2127,7 +2186,8 @@ fwupd_device_from_key_value(FwupdDevice *self, const gchar *key, GVariant *value
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_PLUGIN) == 0) {
-		fwupd_device_set_plugin(self, g_variant_get_string(value, NULL));
+		g_free(priv->plugin);
+		priv->plugin = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_PROTOCOL) == 0) {
@@ -2144,59 +2204,65 @@ fwupd_device_from_key_value(FwupdDevice *self, const gchar *key, GVariant *value
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION) == 0) {
-		fwupd_device_set_version(self, g_variant_get_string(value, NULL));
+		g_free(priv->version);
+		priv->version = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_LOWEST) == 0) {
-		fwupd_device_set_version_lowest(self, g_variant_get_string(value, NULL));
+		g_free(priv->version_lowest);
+		priv->version_lowest = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_BOOTLOADER) == 0) {
-		fwupd_device_set_version_bootloader(self, g_variant_get_string(value, NULL));
+		g_free(priv->version_bootloader);
+		priv->version_bootloader = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_FLASHES_LEFT) == 0) {
-		fwupd_device_set_flashes_left(self, g_variant_get_uint32(value));
+		priv->flashes_left = g_variant_get_uint32(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_INSTALL_DURATION) == 0) {
-		fwupd_device_set_install_duration(self, g_variant_get_uint32(value));
+		priv->install_duration = g_variant_get_uint32(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_UPDATE_ERROR) == 0) {
-		fwupd_device_set_update_error(self, g_variant_get_string(value, NULL));
+		g_free(priv->update_error);
+		priv->update_error = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_UPDATE_MESSAGE) == 0) {
-		fwupd_device_set_update_message(self, g_variant_get_string(value, NULL));
+		g_free(priv->update_message);
+		priv->update_message = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_UPDATE_IMAGE) == 0) {
-		fwupd_device_set_update_image(self, g_variant_get_string(value, NULL));
+		g_free(priv->update_image);
+		priv->update_image = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_UPDATE_STATE) == 0) {
-		fwupd_device_set_update_state(self, g_variant_get_uint32(value));
+		priv->update_state = g_variant_get_uint32(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_STATUS) == 0) {
-		fwupd_device_set_status(self, g_variant_get_uint32(value));
+		priv->status = g_variant_get_uint32(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_FORMAT) == 0) {
-		fwupd_device_set_version_format(self, g_variant_get_uint32(value));
+		priv->version_format = g_variant_get_uint32(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_RAW) == 0) {
-		fwupd_device_set_version_raw(self, g_variant_get_uint64(value));
+		priv->version_raw = g_variant_get_uint64(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_LOWEST_RAW) == 0) {
-		fwupd_device_set_version_lowest_raw(self, g_variant_get_uint64(value));
+		priv->version_lowest_raw = g_variant_get_uint64(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION_BOOTLOADER_RAW) == 0) {
-		fwupd_device_set_version_bootloader_raw(self, g_variant_get_uint64(value));
+		priv->version_bootloader_raw = g_variant_get_uint64(value);
 		return;
 	}
 }
@@ -3188,7 +3254,7 @@ fwupd_device_class_init(FwupdDeviceClass *klass)
 static void
 fwupd_device_init(FwupdDevice *self)
 {
-	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+	FwupdDevicePrivate *priv = fwupd_device_get_instance_private(self);
 	priv->guids = g_ptr_array_new_with_free_func(g_free);
 	priv->instance_ids = g_ptr_array_new_with_free_func(g_free);
 	priv->icons = g_ptr_array_new_with_free_func(g_free);
@@ -3204,8 +3270,10 @@ static void
 fwupd_device_finalize(GObject *object)
 {
 	FwupdDevice *self = FWUPD_DEVICE(object);
-	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+	FwupdDevicePrivate *priv = fwupd_device_get_instance_private(self);
 
+	if (priv->value != NULL)
+		g_variant_unref(priv->value);
 	if (priv->parent != NULL)
 		g_object_remove_weak_pointer(G_OBJECT(priv->parent), (gpointer *)&priv->parent);
 	for (guint i = 0; i < priv->children->len; i++) {
@@ -3247,10 +3315,11 @@ fwupd_device_finalize(GObject *object)
 static void
 fwupd_device_set_from_variant_iter(FwupdDevice *self, GVariantIter *iter)
 {
+	FwupdDevicePrivate *priv = fwupd_device_get_instance_private(self);
 	GVariant *value;
 	const gchar *key;
 	while (g_variant_iter_next(iter, "{&sv}", &key, &value)) {
-		fwupd_device_from_key_value(self, key, value);
+		fwupd_device_from_key_value(self, priv, key, value);
 		g_variant_unref(value);
 	}
 }
@@ -3269,25 +3338,48 @@ FwupdDevice *
 fwupd_device_from_variant(GVariant *value)
 {
 	FwupdDevice *dev = NULL;
+	FwupdDevicePrivate *priv;
 	const gchar *type_string;
-	g_autoptr(GVariantIter) iter = NULL;
 
 	/* format from GetDetails */
 	type_string = g_variant_get_type_string(value);
 	if (g_strcmp0(type_string, "(a{sv})") == 0) {
 		dev = fwupd_device_new();
-		g_variant_get(value, "(a{sv})", &iter);
-		fwupd_device_set_from_variant_iter(dev, iter);
+		priv = fwupd_device_get_instance_private(dev);
+		priv->value = g_variant_get_child_value(value, 0);
 	} else if (g_strcmp0(type_string, "a{sv}") == 0) {
 		dev = fwupd_device_new();
-		g_variant_get(value, "a{sv}", &iter);
-		fwupd_device_set_from_variant_iter(dev, iter);
+		priv = fwupd_device_get_instance_private(dev);
+		priv->value = g_variant_ref_sink(value);
 	} else {
 		g_warning("type %s not known", type_string);
 	}
 	return dev;
 }
 
+/* these do not decode the whole device, which is only safe before it is shared */
+static const gchar *
+fwupd_device_peek_id(FwupdDevice *self)
+{
+	FwupdDevicePrivate *priv = fwupd_device_get_instance_private(self);
+	const gchar *str = NULL;
+	if (priv->value == NULL)
+		return priv->id;
+	g_variant_lookup(priv->value, FWUPD_RESULT_KEY_DEVICE_ID, "&s", &str);
+	return str;
+}
+
+static const gchar *
+fwupd_device_peek_parent_id(FwupdDevice *self)
+{
+	FwupdDevicePrivate *priv = fwupd_device_get_instance_private(self);
+	const gchar *str = NULL;
+	if (priv->value == NULL)
+		return priv->parent_id;
+	g_variant_lookup(priv->value, FWUPD_RESULT_KEY_PARENT_DEVICE_ID, "&s", &str);
+	return str;
+}
+
 /**
  * fwupd_device_array_ensure_parents:
  * @devices: (element-type FwupdDevice): devices
@@ -3305,22 +3397,21 @@ fwupd_device_array_ensure_parents(GPtrArray *devices)
 	devices_by_id = g_hash_table_new(g_str_hash, g_str_equal);
 	for (guint i = 0; i < devices->len; i++) {
 		FwupdDevice *dev = g_ptr_array_index(devices, i);
-		if (fwupd_device_get_id(dev) == NULL)
+		const gchar *id = fwupd_device_peek_id(dev);
+		if (id == NULL)
 			continue;
-		g_hash_table_insert(devices_by_id,
-				    (gpointer)fwupd_device_get_id(dev),
-				    (gpointer)dev);
+		g_hash_table_insert(devices_by_id, (gpointer)id, (gpointer)dev);
 	}
 
 	/* set the parent on each child */
 	for (guint i = 0; i < devices->len; i++) {
 		FwupdDevice *dev = g_ptr_array_index(devices, i);
-		const gchar *parent_id = fwupd_device_get_parent_id(dev);
+		const gchar *parent_id = fwupd_device_peek_parent_id(dev);
 		if (parent_id != NULL) {
 			FwupdDevice *dev_tmp;
 			dev_tmp = g_hash_table_lookup(devices_by_id, parent_id);
 			if (dev_tmp != NULL)
-				fwupd_device_set_parent(dev, dev_tmp);
+				fwupd_device_set_parent_internal(dev, dev_tmp);
 		}
 	}
 }
@@ -338,6 +338,46 @@ G_BEGIN_DECLS
  * The D-Bus type signature string is 'u' i.e. a unsigned 32 bit integer.
  **/
 #define FWUPD_RESULT_KEY_STATUS "Status"
+/**
+ * FWUPD_RESULT_KEY_STATISTIC_KIND:
+ *
+ * Result key to represent StatisticKind
+ *
+ * The D-Bus type signature string is 'u' i.e. a unsigned 32 bit integer.
+ **/
+#define FWUPD_RESULT_KEY_STATISTIC_KIND "StatisticKind"
+/**
+ * FWUPD_RESULT_KEY_STATISTIC_LABELS:
+ *
+ * Result key to represent StatisticLabels
+ *
+ * The D-Bus type signature string is 'a{ss}' i.e. a dictionary of strings.
+ **/
+#define FWUPD_RESULT_KEY_STATISTIC_LABELS "StatisticLabels"
+/**
+ * FWUPD_RESULT_KEY_STATISTIC_VALUE:
+ *
+ * Result key to represent StatisticValue
+ *
+ * The D-Bus type signature string is 't' i.e. a unsigned 64 bit integer.
+ **/
+#define FWUPD_RESULT_KEY_STATISTIC_VALUE "StatisticValue"
+/**
+ * FWUPD_RESULT_KEY_STATISTIC_COUNT:
+ *
+ * Result key to represent StatisticCount
+ *
+ * The D-Bus type signature string is 't' i.e. a unsigned 64 bit integer.
+ **/
+#define FWUPD_RESULT_KEY_STATISTIC_COUNT "StatisticCount"
+/**
+ * FWUPD_RESULT_KEY_STATISTIC_BUCKETS:
+ *
+ * Result key to represent StatisticBuckets
+ *
+ * The D-Bus type signature string is 'a(tt)' i.e. an array of upper bounds and counts.
+ **/
+#define FWUPD_RESULT_KEY_STATISTIC_BUCKETS "StatisticBuckets"
 /**
  * FWUPD_RESULT_KEY_SUMMARY:
  *
@@ -30,6 +30,8 @@ static void
 fwupd_release_finalize(GObject *object);
 
 typedef struct {
+	GVariant *value; /* (nullable): serialized data that has not been decoded yet */
+	gboolean value_decoding;
 	GPtrArray *checksums;
 	GPtrArray *tags;
 	GPtrArray *categories;
@@ -66,7 +68,43 @@ typedef struct {
 enum { PROP_0, PROP_REMOTE_ID, PROP_LAST };
 
 G_DEFINE_TYPE_WITH_PRIVATE(FwupdRelease, fwupd_release, G_TYPE_OBJECT)
-#define GET_PRIVATE(o) (fwupd_release_get_instance_private(o))
+#define GET_PRIVATE(o) (fwupd_release_get_private(o))
+
+/* protects decoding the serialized data of all releases, which only happens once for each */
+static GRecMutex fwupd_release_value_mutex;
+
+static void
+fwupd_release_set_from_variant_iter(FwupdRelease *self, GVariantIter *iter);
+
+/* releases created from a variant are decoded the first time any property is used, as callers
+ * often only look at a few of the releases, and the descriptions can be large */
+static FwupdReleasePrivate *
+fwupd_release_get_private(FwupdRelease *self)
+{
+	FwupdReleasePrivate *priv;
+	GVariant *value;
+
+	if (self == NULL)
+		return NULL;
+	priv = fwupd_release_get_instance_private(self);
+	if (G_LIKELY(g_atomic_pointer_get(&priv->value) == NULL))
+		return priv;
+
+	/* the adders used when decoding get here too */
+	g_rec_mutex_lock(&fwupd_release_value_mutex);
+	value = priv->value;
+	if (value != NULL && !priv->value_decoding) {
+		GVariantIter iter;
+		priv->value_decoding = TRUE;
+		g_variant_iter_init(&iter, value);
+		fwupd_release_set_from_variant_iter(self, &iter);
+		priv->value_decoding = FALSE;
+		g_atomic_pointer_set(&priv->value, NULL);
+		g_variant_unref(value);
+	}
+	g_rec_mutex_unlock(&fwupd_release_value_mutex);
+	return priv;
+}
 
 /* the deprecated fwupd_release_get_trust_flags() function should only
  * return the last two bits of the #FwupdReleaseFlags */
@@ -1797,68 +1835,85 @@ fwupd_release_to_variant(FwupdRelease *self)
 	return g_variant_new("a{sv}", &builder);
 }
 
+/* fields are assigned directly as this runs with the decoding lock held, and so must not
+ * emit ::notify -- the release is only just being decoded so nothing has changed anyway */
 static void
-fwupd_release_from_key_value(FwupdRelease *self, const gchar *key, GVariant *value)
+fwupd_release_from_key_value(FwupdRelease *self,
+			     FwupdReleasePrivate *priv,
+			     const gchar *key,
+			     GVariant *value)
 {
-	FwupdReleasePrivate *priv = GET_PRIVATE(self);
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_REMOTE_ID) == 0) {
-		fwupd_release_set_remote_id(self, g_variant_get_string(value, NULL));
+		g_free(priv->remote_id);
+		priv->remote_id = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_APPSTREAM_ID) == 0) {
-		fwupd_release_set_appstream_id(self, g_variant_get_string(value, NULL));
+		g_free(priv->appstream_id);
+		priv->appstream_id = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_RELEASE_ID) == 0) {
-		fwupd_release_set_id(self, g_variant_get_string(value, NULL));
+		g_free(priv->id);
+		priv->id = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_DETACH_CAPTION) == 0) {
-		fwupd_release_set_detach_caption(self, g_variant_get_string(value, NULL));
+		g_free(priv->detach_caption);
+		priv->detach_caption = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_DETACH_IMAGE) == 0) {
-		fwupd_release_set_detach_image(self, g_variant_get_string(value, NULL));
+		g_free(priv->detach_image);
+		priv->detach_image = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_FILENAME) == 0) {
-		fwupd_release_set_filename(self, g_variant_get_string(value, NULL));
+		g_free(priv->filename);
+		priv->filename = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_PROTOCOL) == 0) {
-		fwupd_release_set_protocol(self, g_variant_get_string(value, NULL));
+		g_free(priv->protocol);
+		priv->protocol = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_LICENSE) == 0) {
-		fwupd_release_set_license(self, g_variant_get_string(value, NULL));
+		g_free(priv->license);
+		priv->license = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_NAME) == 0) {
-		fwupd_release_set_name(self, g_variant_get_string(value, NULL));
+		g_free(priv->name);
+		priv->name = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_NAME_VARIANT_SUFFIX) == 0) {
-		fwupd_release_set_name_variant_suffix(self, g_variant_get_string(value, NULL));
+		g_free(priv->name_variant_suffix);
+		priv->name_variant_suffix = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_SIZE) == 0) {
-		fwupd_release_set_size(self, g_variant_get_uint64(value));
+		priv->size = g_variant_get_uint64(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_CREATED) == 0) {
-		fwupd_release_set_created(self, g_variant_get_uint64(value));
+		priv->created = g_variant_get_uint64(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_SUMMARY) == 0) {
-		fwupd_release_set_summary(self, g_variant_get_string(value, NULL));
+		g_free(priv->summary);
+		priv->summary = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_BRANCH) == 0) {
-		fwupd_release_set_branch(self, g_variant_get_string(value, NULL));
+		g_free(priv->branch);
+		priv->branch = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_DESCRIPTION) == 0) {
-		fwupd_release_set_description(self, g_variant_get_string(value, NULL));
+		g_free(priv->description);
+		priv->description = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_CATEGORIES) == 0) {
@@ -1897,43 +1952,50 @@ fwupd_release_from_key_value(FwupdRelease *self, const gchar *key, GVariant *val
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_HOMEPAGE) == 0) {
-		fwupd_release_set_homepage(self, g_variant_get_string(value, NULL));
+		g_free(priv->homepage);
+		priv->homepage = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_DETAILS_URL) == 0) {
-		fwupd_release_set_details_url(self, g_variant_get_string(value, NULL));
+		g_free(priv->details_url);
+		priv->details_url = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_SOURCE_URL) == 0) {
-		fwupd_release_set_source_url(self, g_variant_get_string(value, NULL));
+		g_free(priv->source_url);
+		priv->source_url = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_VERSION) == 0) {
-		fwupd_release_set_version(self, g_variant_get_string(value, NULL));
+		g_free(priv->version);
+		priv->version = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_VENDOR) == 0) {
-		fwupd_release_set_vendor(self, g_variant_get_string(value, NULL));
+		g_free(priv->vendor);
+		priv->vendor = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_TRUST_FLAGS) == 0) {
-		fwupd_release_set_flags(self, g_variant_get_uint64(value));
+		priv->flags = g_variant_get_uint64(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_URGENCY) == 0) {
-		fwupd_release_set_urgency(self, g_variant_get_uint32(value));
+		priv->urgency = g_variant_get_uint32(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_INSTALL_DURATION) == 0) {
-		fwupd_release_set_install_duration(self, g_variant_get_uint32(value));
+		priv->install_duration = g_variant_get_uint32(value);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_UPDATE_MESSAGE) == 0) {
-		fwupd_release_set_update_message(self, g_variant_get_string(value, NULL));
+		g_free(priv->update_message);
+		priv->update_message = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_UPDATE_IMAGE) == 0) {
-		fwupd_release_set_update_image(self, g_variant_get_string(value, NULL));
+		g_free(priv->update_image);
+		priv->update_image = g_variant_dup_string(value, NULL);
 		return;
 	}
 	if (g_strcmp0(key, FWUPD_RESULT_KEY_METADATA) == 0) {
@@ -2274,7 +2336,7 @@ fwupd_release_class_init(FwupdReleaseClass *klass)
 static void
 fwupd_release_init(FwupdRelease *self)
 {
-	FwupdReleasePrivate *priv = GET_PRIVATE(self);
+	FwupdReleasePrivate *priv = fwupd_release_get_instance_private(self);
 	priv->categories = g_ptr_array_new_with_free_func(g_free);
 	priv->issues = g_ptr_array_new_with_free_func(g_free);
 	priv->checksums = g_ptr_array_new_with_free_func(g_free);
@@ -2287,8 +2349,10 @@ static void
 fwupd_release_finalize(GObject *object)
 {
 	FwupdRelease *self = FWUPD_RELEASE(object);
-	FwupdReleasePrivate *priv = GET_PRIVATE(self);
+	FwupdReleasePrivate *priv = fwupd_release_get_instance_private(self);
 
+	if (priv->value != NULL)
+		g_variant_unref(priv->value);
 	g_free(priv->description);
 	g_free(priv->filename);
 	g_free(priv->protocol);
@@ -2322,10 +2386,11 @@ fwupd_release_finalize(GObject *object)
 static void
 fwupd_release_set_from_variant_iter(FwupdRelease *self, GVariantIter *iter)
 {
+	FwupdReleasePrivate *priv = fwupd_release_get_instance_private(self);
 	GVariant *value;
 	const gchar *key;
 	while (g_variant_iter_next(iter, "{&sv}", &key, &value)) {
-		fwupd_release_from_key_value(self, key, value);
+		fwupd_release_from_key_value(self, priv, key, value);
 		g_variant_unref(value);
 	}
 }
@@ -2344,19 +2409,19 @@ FwupdRelease *
 fwupd_release_from_variant(GVariant *value)
 {
 	FwupdRelease *self = NULL;
+	FwupdReleasePrivate *priv;
 	const gchar *type_string;
-	g_autoptr(GVariantIter) iter = NULL;
 
 	/* format from GetDetails */
 	type_string = g_variant_get_type_string(value);
 	if (g_strcmp0(type_string, "(a{sv})") == 0) {
 		self = fwupd_release_new();
-		g_variant_get(value, "(a{sv})", &iter);
-		fwupd_release_set_from_variant_iter(self, iter);
+		priv = fwupd_release_get_instance_private(self);
+		priv->value = g_variant_get_child_value(value, 0);
 	} else if (g_strcmp0(type_string, "a{sv}") == 0) {
 		self = fwupd_release_new();
-		g_variant_get(value, "a{sv}", &iter);
-		fwupd_release_set_from_variant_iter(self, iter);
+		priv = fwupd_release_get_instance_private(self);
+		priv->value = g_variant_ref_sink(value);
 	} else {
 		g_warning("type %s not known", type_string);
 	}
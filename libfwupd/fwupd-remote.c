@@ -50,10 +50,12 @@ typedef struct {
 	gchar *filename_source;
 	gboolean enabled;
 	gboolean approval_required;
+	gboolean metadata_delta;
 	gint priority;
 	guint64 mtime;
 	gchar **order_after;
 	gchar **order_before;
+	gchar **mirror_uris;
 	gchar *remotes_dir;
 	gboolean automatic_reports;
 	gboolean automatic_security_reports;
@@ -121,6 +123,7 @@ fwupd_remote_to_json(FwupdRemote *self, JsonBuilder *builder)
 	fwupd_common_json_add_string(builder, "FilenameSource", priv->filename_source);
 	fwupd_common_json_add_boolean(builder, "Enabled", priv->enabled);
 	fwupd_common_json_add_boolean(builder, "ApprovalRequired", priv->approval_required);
+	fwupd_common_json_add_boolean(builder, "MetadataDelta", priv->metadata_delta);
 	fwupd_common_json_add_boolean(builder, "AutomaticReports", priv->automatic_reports);
 	fwupd_common_json_add_boolean(builder,
 				      "AutomaticSecurityReports",
@@ -130,6 +133,7 @@ fwupd_remote_to_json(FwupdRemote *self, JsonBuilder *builder)
 	fwupd_common_json_add_string(builder, "RemotesDir", priv->remotes_dir);
 	fwupd_common_json_add_stringv(builder, "OrderAfter", priv->order_after);
 	fwupd_common_json_add_stringv(builder, "OrderBefore", priv->order_before);
+	fwupd_common_json_add_stringv(builder, "MirrorUris", priv->mirror_uris);
 }
 
 static gchar *
@@ -494,6 +498,30 @@ fwupd_remote_set_order_before(FwupdRemote *self, const gchar *order_before)
 		priv->order_before = g_strsplit_set(order_before, ",:;", -1);
 }
 
+/* URIs contain a colon, so unlike the remote IDs this is not used as a separator */
+static void
+fwupd_remote_set_mirror_uris(FwupdRemote *self, const gchar *mirror_uris)
+{
+	FwupdRemotePrivate *priv = GET_PRIVATE(self);
+	g_auto(GStrv) split = NULL;
+	g_autoptr(GPtrArray) array = g_ptr_array_new_with_free_func(g_free);
+
+	g_clear_pointer(&priv->mirror_uris, g_strfreev);
+	if (mirror_uris == NULL)
+		return;
+	split = g_strsplit_set(mirror_uris, ",;", -1);
+	for (guint i = 0; split[i] != NULL; i++) {
+		g_strstrip(split[i]);
+		if (split[i][0] == '\0')
+			continue;
+		g_ptr_array_add(array, g_strdup(split[i]));
+	}
+	if (array->len == 0)
+		return;
+	g_ptr_array_add(array, NULL);
+	priv->mirror_uris = (gchar **)g_ptr_array_free(g_steal_pointer(&array), FALSE);
+}
+
 static void
 fwupd_remote_set_order_after(FwupdRemote *self, const gchar *order_after)
 {
@@ -666,6 +694,8 @@ fwupd_remote_load_from_filename(FwupdRemote *self,
 	if (g_key_file_has_key(kf, group, "ApprovalRequired", NULL))
 		priv->approval_required =
 		    g_key_file_get_boolean(kf, group, "ApprovalRequired", NULL);
+	if (g_key_file_has_key(kf, group, "MetadataDelta", NULL))
+		priv->metadata_delta = g_key_file_get_boolean(kf, group, "MetadataDelta", NULL);
 	if (g_key_file_has_key(kf, group, "Title", NULL)) {
 		g_autofree gchar *tmp = g_key_file_get_string(kf, group, "Title", NULL);
 		fwupd_remote_set_title(self, tmp);
@@ -698,6 +728,10 @@ fwupd_remote_load_from_filename(FwupdRemote *self,
 		g_autofree gchar *tmp = g_key_file_get_string(kf, group, "OrderAfter", NULL);
 		fwupd_remote_set_order_after(self, tmp);
 	}
+	if (g_key_file_has_key(kf, group, "MirrorURIs", NULL)) {
+		g_autofree gchar *tmp = g_key_file_get_string(kf, group, "MirrorURIs", NULL);
+		fwupd_remote_set_mirror_uris(self, tmp);
+	}
 	if (g_key_file_has_key(kf, group, "AutomaticReports", NULL))
 		priv->automatic_reports =
 		    g_key_file_get_boolean(kf, group, "AutomaticReports", NULL);
@@ -746,6 +780,26 @@ fwupd_remote_get_order_before(FwupdRemote *self)
 	return priv->order_before;
 }
 
+/**
+ * fwupd_remote_get_mirror_uris:
+ * @self: a #FwupdRemote
+ *
+ * Gets the base URIs of servers on the local network that share firmware, for instance using
+ * `fwupdtool serve-mirror`. These are tried before the locations in the metadata, and the
+ * firmware is requested using the checksum of the release.
+ *
+ * Returns: (transfer none) (nullable): an array of URIs, or %NULL for unset
+ *
+ * Since: 1.8.0
+ **/
+gchar **
+fwupd_remote_get_mirror_uris(FwupdRemote *self)
+{
+	FwupdRemotePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_REMOTE(self), NULL);
+	return priv->mirror_uris;
+}
+
 /**
  * fwupd_remote_get_filename_cache:
  * @self: a #FwupdRemote
@@ -1338,6 +1392,25 @@ fwupd_remote_get_approval_required(FwupdRemote *self)
 	return priv->approval_required;
 }
 
+/**
+ * fwupd_remote_get_metadata_delta:
+ * @self: a #FwupdRemote
+ *
+ * Gets if the server publishes a chunk index next to the metadata, so that a refresh only has
+ * to download the parts of the metadata that have changed.
+ *
+ * Returns: %TRUE if only changed chunks should be downloaded
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fwupd_remote_get_metadata_delta(FwupdRemote *self)
+{
+	FwupdRemotePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_REMOTE(self), FALSE);
+	return priv->metadata_delta;
+}
+
 /**
  * fwupd_remote_get_id:
  * @self: a #FwupdRemote
@@ -1402,12 +1475,17 @@ fwupd_remote_set_from_variant_iter(FwupdRemote *self, GVariantIter *iter)
 			priv->enabled = g_variant_get_boolean(value);
 		} else if (g_strcmp0(key, "ApprovalRequired") == 0) {
 			priv->approval_required = g_variant_get_boolean(value);
+		} else if (g_strcmp0(key, "MetadataDelta") == 0) {
+			priv->metadata_delta = g_variant_get_boolean(value);
 		} else if (g_strcmp0(key, "Priority") == 0) {
 			priv->priority = g_variant_get_int32(value);
 		} else if (g_strcmp0(key, "ModificationTime") == 0) {
 			priv->mtime = g_variant_get_uint64(value);
 		} else if (g_strcmp0(key, "FirmwareBaseUri") == 0) {
 			fwupd_remote_set_firmware_base_uri(self, g_variant_get_string(value, NULL));
+		} else if (g_strcmp0(key, "MirrorUris") == 0) {
+			g_strfreev(priv->mirror_uris);
+			priv->mirror_uris = g_variant_dup_strv(value, NULL);
 		} else if (g_strcmp0(key, "AutomaticReports") == 0) {
 			priv->automatic_reports = g_variant_get_boolean(value);
 		} else if (g_strcmp0(key, "AutomaticSecurityReports") == 0) {
@@ -1493,6 +1571,13 @@ fwupd_remote_to_variant(FwupdRemote *self)
 				      "FirmwareBaseUri",
 				      g_variant_new_string(priv->firmware_base_uri));
 	}
+	if (priv->mirror_uris != NULL) {
+		const gchar *const *tmp = (const gchar *const *)priv->mirror_uris;
+		g_variant_builder_add(&builder,
+				      "{sv}",
+				      "MirrorUris",
+				      g_variant_new_strv(tmp, -1));
+	}
 	if (priv->priority != 0) {
 		g_variant_builder_add(&builder,
 				      "{sv}",
@@ -1537,6 +1622,12 @@ fwupd_remote_to_variant(FwupdRemote *self)
 			      "{sv}",
 			      "ApprovalRequired",
 			      g_variant_new_boolean(priv->approval_required));
+	if (priv->metadata_delta) {
+		g_variant_builder_add(&builder,
+				      "{sv}",
+				      "MetadataDelta",
+				      g_variant_new_boolean(priv->metadata_delta));
+	}
 	g_variant_builder_add(&builder,
 			      "{sv}",
 			      "AutomaticReports",
@@ -1712,6 +1803,7 @@ fwupd_remote_finalize(GObject *obj)
 	g_free(priv->filename_source);
 	g_strfreev(priv->order_after);
 	g_strfreev(priv->order_before);
+	g_strfreev(priv->mirror_uris);
 
 	G_OBJECT_CLASS(fwupd_remote_parent_class)->finalize(obj);
 }
@@ -72,6 +72,8 @@ const gchar *
 fwupd_remote_get_filename_source(FwupdRemote *self);
 const gchar *
 fwupd_remote_get_firmware_base_uri(FwupdRemote *self);
+gchar **
+fwupd_remote_get_mirror_uris(FwupdRemote *self);
 const gchar *
 fwupd_remote_get_report_uri(FwupdRemote *self);
 const gchar *
@@ -85,6 +87,8 @@ fwupd_remote_get_enabled(FwupdRemote *self);
 gboolean
 fwupd_remote_get_approval_required(FwupdRemote *self);
 gboolean
+fwupd_remote_get_metadata_delta(FwupdRemote *self);
+gboolean
 fwupd_remote_get_automatic_reports(FwupdRemote *self);
 gboolean
 fwupd_remote_get_automatic_security_reports(FwupdRemote *self);
@@ -6,22 +6,32 @@
 
 #include "config.h"
 
+#include <gio/gio.h>
 #include <glib-object.h>
+#include <glib/gstdio.h>
 #include <string.h>
 #ifdef HAVE_FNMATCH_H
 #include <fnmatch.h>
 #endif
+#ifndef _WIN32
+#include <unistd.h>
+#include <utime.h>
+#endif
 
+#include "fwupd-client-private.h"
 #include "fwupd-client-sync.h"
 #include "fwupd-client.h"
+#include "fwupd-common-private.h"
 #include "fwupd-common.h"
 #include "fwupd-device-private.h"
+#include "fwupd-enums-private.h"
 #include "fwupd-enums.h"
 #include "fwupd-error.h"
 #include "fwupd-release-private.h"
 #include "fwupd-remote-private.h"
 #include "fwupd-request-private.h"
 #include "fwupd-security-attr-private.h"
+#include "fwupd-statistic-private.h"
 
 static gboolean
 fu_test_compare_lines(const gchar *txt1, const gchar *txt2, GError **error)
@@ -137,6 +147,11 @@ fwupd_enums_func(void)
 		g_assert_cmpstr(tmp, !=, NULL);
 		g_assert_cmpint(fwupd_request_kind_from_string(tmp), ==, i);
 	}
+	for (guint i = 0; i < FWUPD_STATISTIC_KIND_LAST; i++) {
+		const gchar *tmp = fwupd_statistic_kind_to_string(i);
+		g_assert_cmpstr(tmp, !=, NULL);
+		g_assert_cmpint(fwupd_statistic_kind_from_string(tmp), ==, i);
+	}
 	for (guint i = FWUPD_RELEASE_URGENCY_UNKNOWN + 1; i < FWUPD_RELEASE_URGENCY_LAST; i++) {
 		const gchar *tmp = fwupd_release_urgency_to_string(i);
 		g_assert_cmpstr(tmp, !=, NULL);
@@ -243,6 +258,58 @@ fwupd_remote_baseuri_func(void)
 	g_assert_cmpstr(firmware_uri, ==, "https://my.fancy.cdn/firmware.cab");
 }
 
+static void
+fwupd_remote_mirror_func(void)
+{
+	gboolean ret;
+	gchar **mirror_uris;
+	g_autofree gchar *fn = NULL;
+	g_autoptr(FwupdRemote) remote = fwupd_remote_new();
+	g_autoptr(FwupdRemote) remote2 = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) data = NULL;
+
+	fn = g_test_build_filename(G_TEST_DIST, "tests", "mirror.conf", NULL);
+	ret = fwupd_remote_load_from_filename(remote, fn, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	mirror_uris = fwupd_remote_get_mirror_uris(remote);
+	g_assert_nonnull(mirror_uris);
+	g_assert_cmpint(g_strv_length(mirror_uris), ==, 2);
+	g_assert_cmpstr(mirror_uris[0], ==, "http://192.168.1.10:8080/");
+	g_assert_cmpstr(mirror_uris[1], ==, "http://192.168.1.11:8080/");
+
+	/* the client gets these from the daemon */
+	data = fwupd_remote_to_variant(remote);
+	remote2 = fwupd_remote_from_variant(data);
+	mirror_uris = fwupd_remote_get_mirror_uris(remote2);
+	g_assert_nonnull(mirror_uris);
+	g_assert_cmpint(g_strv_length(mirror_uris), ==, 2);
+	g_assert_cmpstr(mirror_uris[1], ==, "http://192.168.1.11:8080/");
+}
+
+static void
+fwupd_remote_delta_func(void)
+{
+	gboolean ret;
+	g_autofree gchar *fn = NULL;
+	g_autoptr(FwupdRemote) remote = fwupd_remote_new();
+	g_autoptr(FwupdRemote) remote2 = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) data = NULL;
+
+	fn = g_test_build_filename(G_TEST_DIST, "tests", "delta.conf", NULL);
+	ret = fwupd_remote_load_from_filename(remote, fn, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_true(fwupd_remote_get_metadata_delta(remote));
+
+	/* the client gets this from the daemon */
+	data = fwupd_remote_to_variant(remote);
+	remote2 = fwupd_remote_from_variant(data);
+	g_assert_true(fwupd_remote_get_metadata_delta(remote2));
+}
+
 static void
 fwupd_remote_duplicate_func(void)
 {
@@ -340,20 +407,63 @@ fwupd_remote_local_func(void)
 	g_assert_cmpstr(fwupd_remote_get_checksum(remote), ==, NULL);
 }
 
+static void
+fwupd_notify_cb(GObject *object, GParamSpec *pspec, gpointer user_data)
+{
+	guint *cnt = (guint *)user_data;
+	(*cnt)++;
+}
+
 static void
 fwupd_release_func(void)
 {
+	guint notify_cnt = 0;
 	g_autoptr(FwupdRelease) release1 = NULL;
 	g_autoptr(FwupdRelease) release2 = NULL;
 	g_autoptr(GVariant) data = NULL;
 
 	release1 = fwupd_release_new();
+	fwupd_release_set_remote_id(release1, "lvfs");
 	fwupd_release_add_metadata_item(release1, "foo", "bar");
 	fwupd_release_add_metadata_item(release1, "baz", "bam");
 	data = fwupd_release_to_variant(release1);
 	release2 = fwupd_release_from_variant(data);
+
+	/* decoding on first use is not a change */
+	g_signal_connect(release2, "notify", G_CALLBACK(fwupd_notify_cb), &notify_cnt);
+	g_assert_cmpstr(fwupd_release_get_remote_id(release2), ==, "lvfs");
 	g_assert_cmpstr(fwupd_release_get_metadata_item(release2, "foo"), ==, "bar");
 	g_assert_cmpstr(fwupd_release_get_metadata_item(release2, "baz"), ==, "bam");
+	g_assert_cmpint(notify_cnt, ==, 0);
+}
+
+static void
+fwupd_device_decode_func(void)
+{
+	guint notify_cnt = 0;
+	g_autoptr(FwupdDevice) device1 = fwupd_device_new();
+	g_autoptr(FwupdDevice) device2 = NULL;
+	g_autoptr(GVariant) data = NULL;
+
+	fwupd_device_set_id(device1, "0000000000000000000000000000000000000000");
+	fwupd_device_add_flag(device1, FWUPD_DEVICE_FLAG_UPDATABLE);
+	fwupd_device_set_status(device1, FWUPD_STATUS_DEVICE_WRITE);
+	fwupd_device_set_update_state(device1, FWUPD_UPDATE_STATE_SUCCESS);
+	fwupd_device_set_update_message(device1, "Unplug the device");
+	data = fwupd_device_to_variant(device1);
+	device2 = fwupd_device_from_variant(data);
+
+	/* decoding on first use is not a change */
+	g_signal_connect(device2, "notify", G_CALLBACK(fwupd_notify_cb), &notify_cnt);
+	g_assert_true(fwupd_device_has_flag(device2, FWUPD_DEVICE_FLAG_UPDATABLE));
+	g_assert_cmpint(fwupd_device_get_status(device2), ==, FWUPD_STATUS_DEVICE_WRITE);
+	g_assert_cmpint(fwupd_device_get_update_state(device2), ==, FWUPD_UPDATE_STATE_SUCCESS);
+	g_assert_cmpstr(fwupd_device_get_update_message(device2), ==, "Unplug the device");
+	g_assert_cmpint(notify_cnt, ==, 0);
+
+	/* real changes still notify */
+	fwupd_device_set_status(device2, FWUPD_STATUS_IDLE);
+	g_assert_cmpint(notify_cnt, ==, 1);
 }
 
 static void
@@ -385,6 +495,44 @@ fwupd_request_func(void)
 	g_assert_cmpstr(fwupd_request_get_image(request2), ==, "bar");
 }
 
+static void
+fwupd_statistic_func(void)
+{
+	guint64 upper = 0;
+	guint64 count = 0;
+	g_autofree gchar *str = NULL;
+	g_autoptr(FwupdStatistic) statistic = fwupd_statistic_new();
+	g_autoptr(FwupdStatistic) statistic2 = NULL;
+	g_autoptr(GVariant) data = NULL;
+
+	/* create dummy */
+	fwupd_statistic_set_name(statistic, "fwupd_dbus_method_duration_microseconds");
+	fwupd_statistic_set_kind(statistic, FWUPD_STATISTIC_KIND_HISTOGRAM);
+	fwupd_statistic_add_label(statistic, "method", "GetDevices");
+	fwupd_statistic_set_value(statistic, 1500);
+	fwupd_statistic_set_count(statistic, 3);
+	fwupd_statistic_add_bucket(statistic, 256, 1);
+	fwupd_statistic_add_bucket(statistic, 512, 2);
+	str = fwupd_statistic_to_string(statistic);
+	g_debug("%s", str);
+
+	/* to serialized and back again */
+	data = fwupd_statistic_to_variant(statistic);
+	statistic2 = fwupd_statistic_from_variant(data);
+	g_assert_cmpstr(fwupd_statistic_get_name(statistic2),
+			==,
+			"fwupd_dbus_method_duration_microseconds");
+	g_assert_cmpint(fwupd_statistic_get_kind(statistic2), ==, FWUPD_STATISTIC_KIND_HISTOGRAM);
+	g_assert_cmpstr(fwupd_statistic_get_label(statistic2, "method"), ==, "GetDevices");
+	g_assert_cmpint(fwupd_statistic_get_value(statistic2), ==, 1500);
+	g_assert_cmpint(fwupd_statistic_get_count(statistic2), ==, 3);
+	g_assert_cmpint(fwupd_statistic_get_n_buckets(statistic2), ==, 2);
+	g_assert_true(fwupd_statistic_get_bucket(statistic2, 1, &upper, &count));
+	g_assert_cmpint(upper, ==, 512);
+	g_assert_cmpint(count, ==, 2);
+	g_assert_false(fwupd_statistic_get_bucket(statistic2, 2, NULL, NULL));
+}
+
 static void
 fwupd_device_func(void)
 {
@@ -697,6 +845,63 @@ fwupd_common_device_id_func(void)
 	g_assert_true(fwupd_device_id_is_valid("d3fae86d95e5d56626129d00e332c4b8dac95442"));
 }
 
+static void
+fwupd_common_chunks_func(void)
+{
+	gsize total = 0;
+	guint shared = 0;
+	guint32 seed = 1;
+	g_autofree gchar *index = NULL;
+	g_auto(GStrv) lines = NULL;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) blob2 = NULL;
+	g_autoptr(GHashTable) checksums = NULL;
+	g_autoptr(GPtrArray) chunks = NULL;
+	g_autoptr(GPtrArray) chunks2 = NULL;
+
+	/* something that does not compress */
+	for (guint i = 0; i < 0x40000; i++) {
+		guint8 tmp;
+		seed = seed * 1103515245 + 12345;
+		tmp = seed >> 16;
+		g_byte_array_append(buf, &tmp, 1);
+	}
+	blob = g_bytes_new(buf->data, buf->len);
+	chunks = fwupd_common_chunk_bytes(blob);
+	checksums = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	g_assert_cmpint(chunks->len, >, 4);
+	for (guint i = 0; i < chunks->len; i++) {
+		GBytes *chunk = g_ptr_array_index(chunks, i);
+		g_assert_cmpint(g_bytes_get_size(chunk), <=, 0x10000);
+		if (i != chunks->len - 1)
+			g_assert_cmpint(g_bytes_get_size(chunk), >=, 0x800);
+		total += g_bytes_get_size(chunk);
+		g_hash_table_add(checksums,
+				 g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, chunk));
+	}
+	g_assert_cmpint(total, ==, buf->len);
+
+	/* an edit only changes the chunks around it */
+	g_byte_array_remove_range(buf, 0x20000, 0x10);
+	blob2 = g_bytes_new(buf->data, buf->len);
+	chunks2 = fwupd_common_chunk_bytes(blob2);
+	for (guint i = 0; i < chunks2->len; i++) {
+		GBytes *chunk = g_ptr_array_index(chunks2, i);
+		g_autofree gchar *checksum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, chunk);
+		if (g_hash_table_contains(checksums, checksum))
+			shared++;
+	}
+	g_assert_cmpint(shared, >=, chunks2->len - 2);
+
+	/* a header, then one line for each chunk */
+	index = fwupd_common_chunk_index_build(blob2);
+	g_assert_true(g_str_has_prefix(index, FWUPD_CHUNK_INDEX_HEADER "\n"));
+	g_assert_true(g_str_has_suffix(index, "\n"));
+	lines = g_strsplit(index, "\n", -1);
+	g_assert_cmpint(g_strv_length(lines), ==, chunks2->len + 2);
+}
+
 static void
 fwupd_common_guid_func(void)
 {
@@ -909,6 +1114,668 @@ fwupd_security_attr_func(void)
 	g_assert_true(ret);
 }
 
+static void
+fu_test_async_result_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	GAsyncResult **result = (GAsyncResult **)user_data;
+	*result = g_object_ref(res);
+}
+
+/* the mock servers use the default main context */
+static void
+fu_test_wait_for_result(GAsyncResult **res)
+{
+	while (*res == NULL)
+		g_main_context_iteration(NULL, TRUE);
+}
+
+#ifdef HAVE_GIO_UNIX
+/* a peer-to-peer daemon that only knows about devices */
+typedef struct {
+	GDBusServer *server;
+	GDBusNodeInfo *info;
+	GPtrArray *connections; /* (element-type GDBusConnection) */
+	GPtrArray *devices;	/* (element-type FwupdDevice) */
+	guint get_devices_cnt;
+	guint update_metadata_cnt;
+	gchar *tmpdir;
+} FuTestDaemon;
+
+static const gchar *fu_test_daemon_xml =
+    "<node>"
+    "  <interface name='" FWUPD_DBUS_INTERFACE "'>"
+    "    <method name='GetDevices'>"
+    "      <arg type='aa{sv}' name='devices' direction='out'/>"
+    "    </method>"
+    "    <method name='SetHints'>"
+    "      <arg type='a{ss}' name='hints' direction='in'/>"
+    "    </method>"
+    "    <method name='UpdateMetadata'>"
+    "      <arg type='s' name='remote_id' direction='in'/>"
+    "      <arg type='h' name='data' direction='in'/>"
+    "      <arg type='h' name='signature' direction='in'/>"
+    "    </method>"
+    "    <signal name='DeviceAdded'><arg type='a{sv}' name='device'/></signal>"
+    "    <signal name='DeviceRemoved'><arg type='a{sv}' name='device'/></signal>"
+    "    <signal name='DeviceChanged'><arg type='a{sv}' name='device'/></signal>"
+    "  </interface>"
+    "</node>";
+
+static void
+fu_test_daemon_method_call_cb(GDBusConnection *connection,
+			      const gchar *sender,
+			      const gchar *object_path,
+			      const gchar *interface_name,
+			      const gchar *method_name,
+			      GVariant *parameters,
+			      GDBusMethodInvocation *invocation,
+			      gpointer user_data)
+{
+	FuTestDaemon *mock = (FuTestDaemon *)user_data;
+	if (g_strcmp0(method_name, "GetDevices") == 0) {
+		GVariantBuilder builder;
+		mock->get_devices_cnt++;
+		g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+		for (guint i = 0; i < mock->devices->len; i++) {
+			FwupdDevice *device = g_ptr_array_index(mock->devices, i);
+			g_variant_builder_add_value(&builder, fwupd_device_to_variant(device));
+		}
+		g_dbus_method_invocation_return_value(invocation,
+						      g_variant_new("(aa{sv})", &builder));
+		return;
+	}
+	if (g_strcmp0(method_name, "UpdateMetadata") == 0)
+		mock->update_metadata_cnt++;
+	g_dbus_method_invocation_return_value(invocation, NULL);
+}
+
+static gboolean
+fu_test_daemon_new_connection_cb(GDBusServer *server,
+				 GDBusConnection *connection,
+				 gpointer user_data)
+{
+	FuTestDaemon *mock = (FuTestDaemon *)user_data;
+	guint registration_id;
+	GDBusInterfaceVTable vtable = {fu_test_daemon_method_call_cb, NULL, NULL};
+	g_autoptr(GError) error = NULL;
+
+	registration_id = g_dbus_connection_register_object(connection,
+							     FWUPD_DBUS_PATH,
+							     mock->info->interfaces[0],
+							     &vtable,
+							     mock,
+							     NULL,
+							     &error);
+	g_assert_no_error(error);
+	g_assert_cmpint(registration_id, >, 0);
+	g_ptr_array_add(mock->connections, g_object_ref(connection));
+	return TRUE;
+}
+
+static void
+fu_test_daemon_emit(FuTestDaemon *mock, const gchar *signal_name, FwupdDevice *device)
+{
+	GVariant *value = fwupd_device_to_variant(device);
+	g_variant_ref_sink(value);
+	for (guint i = 0; i < mock->connections->len; i++) {
+		GDBusConnection *connection = g_ptr_array_index(mock->connections, i);
+		g_autoptr(GError) error = NULL;
+		g_dbus_connection_emit_signal(connection,
+					      NULL,
+					      FWUPD_DBUS_PATH,
+					      FWUPD_DBUS_INTERFACE,
+					      signal_name,
+					      g_variant_new_tuple(&value, 1),
+					      &error);
+		g_assert_no_error(error);
+	}
+	g_variant_unref(value);
+}
+
+static FuTestDaemon *
+fu_test_daemon_new(void)
+{
+	FuTestDaemon *mock = g_new0(FuTestDaemon, 1);
+	g_autofree gchar *address = NULL;
+	g_autofree gchar *guid = g_dbus_generate_guid();
+	g_autofree gchar *socket_filename = NULL;
+	g_autoptr(GError) error = NULL;
+
+	mock->connections = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	mock->devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	mock->info = g_dbus_node_info_new_for_xml(fu_test_daemon_xml, &error);
+	g_assert_no_error(error);
+	mock->tmpdir = g_dir_make_tmp("fwupd-self-test-XXXXXX", &error);
+	g_assert_no_error(error);
+	socket_filename = g_build_filename(mock->tmpdir, "fwupd.sock", NULL);
+	address = g_strdup_printf("unix:path=%s", socket_filename);
+	mock->server =
+	    g_dbus_server_new_sync(address, G_DBUS_SERVER_FLAGS_NONE, guid, NULL, NULL, &error);
+	g_assert_no_error(error);
+	g_signal_connect(mock->server,
+			 "new-connection",
+			 G_CALLBACK(fu_test_daemon_new_connection_cb),
+			 mock);
+	g_dbus_server_start(mock->server);
+	g_setenv("FWUPD_DBUS_SOCKET", socket_filename, TRUE);
+	return mock;
+}
+
+static void
+fu_test_daemon_free(FuTestDaemon *mock)
+{
+	g_autofree gchar *socket_filename = g_build_filename(mock->tmpdir, "fwupd.sock", NULL);
+	g_unsetenv("FWUPD_DBUS_SOCKET");
+	g_dbus_server_stop(mock->server);
+	g_object_unref(mock->server);
+	g_ptr_array_unref(mock->connections);
+	g_ptr_array_unref(mock->devices);
+	g_dbus_node_info_unref(mock->info);
+	g_unlink(socket_filename);
+	g_rmdir(mock->tmpdir);
+	g_free(mock->tmpdir);
+	g_free(mock);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuTestDaemon, fu_test_daemon_free)
+
+static FwupdDevice *
+fu_test_daemon_add_device(FuTestDaemon *mock,
+			  const gchar *id,
+			  const gchar *parent_id,
+			  const gchar *name)
+{
+	g_autoptr(FwupdDevice) device = fwupd_device_new();
+	fwupd_device_set_id(device, id);
+	fwupd_device_set_parent_id(device, parent_id);
+	fwupd_device_set_name(device, name);
+	g_ptr_array_add(mock->devices, g_object_ref(device));
+	return g_steal_pointer(&device);
+}
+
+static GPtrArray *
+fu_test_client_get_devices(FwupdClient *client, GError **error)
+{
+	g_autoptr(GAsyncResult) res = NULL;
+	fwupd_client_get_devices_async(client, NULL, fu_test_async_result_cb, &res);
+	fu_test_wait_for_result(&res);
+	return fwupd_client_get_devices_finish(client, res, error);
+}
+
+static void
+fu_test_client_device_signal_cb(FwupdClient *client, FwupdDevice *device, gpointer user_data)
+{
+	guint *cnt = (guint *)user_data;
+	(*cnt)++;
+}
+
+/* calling back into the client must not deadlock */
+static void
+fu_test_client_get_devices_reentrant_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	GAsyncResult **result = (GAsyncResult **)user_data;
+	fwupd_client_get_device_cache_generation(FWUPD_CLIENT(source));
+	*result = g_object_ref(res);
+}
+
+static void
+fwupd_client_device_cache_func(void)
+{
+	gboolean ret;
+	guint signal_cnt = 0;
+	guint64 generation;
+	FwupdDevice *parent_old;
+	FwupdDevice *child_old;
+	g_autoptr(FuTestDaemon) mock = fu_test_daemon_new();
+	g_autoptr(FwupdClient) client = fwupd_client_new();
+	g_autoptr(FwupdDevice) parent = NULL;
+	g_autoptr(FwupdDevice) child = NULL;
+	g_autoptr(FwupdDevice) device_new = NULL;
+	g_autoptr(GAsyncResult) res = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) devices2 = NULL;
+	g_autoptr(GPtrArray) devices3 = NULL;
+
+	parent = fu_test_daemon_add_device(mock, "aaaa", NULL, "Parent");
+	child = fu_test_daemon_add_device(mock, "bbbb", "aaaa", "Child");
+	fwupd_client_connect_async(client, NULL, fu_test_async_result_cb, &res);
+	fu_test_wait_for_result(&res);
+	ret = fwupd_client_connect_finish(client, res, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_clear_object(&res);
+	fwupd_client_set_device_cache_enabled(client, TRUE);
+	g_signal_connect(client,
+			 "device-added",
+			 G_CALLBACK(fu_test_client_device_signal_cb),
+			 &signal_cnt);
+	g_signal_connect(client,
+			 "device-removed",
+			 G_CALLBACK(fu_test_client_device_signal_cb),
+			 &signal_cnt);
+	g_signal_connect(client,
+			 "device-changed",
+			 G_CALLBACK(fu_test_client_device_signal_cb),
+			 &signal_cnt);
+
+	/* the callback is not run with the cache locked */
+	fwupd_client_get_devices_async(client, NULL, fu_test_client_get_devices_reentrant_cb, &res);
+	fu_test_wait_for_result(&res);
+	devices = fwupd_client_get_devices_finish(client, res, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices);
+	g_assert_cmpint(devices->len, ==, 2);
+	g_assert_cmpint(mock->get_devices_cnt, ==, 1);
+	parent_old = g_ptr_array_index(devices, 0);
+	child_old = g_ptr_array_index(devices, 1);
+	g_assert_true(fwupd_device_get_parent(child_old) == parent_old);
+
+	/* the second call does not need the daemon */
+	devices2 = fu_test_client_get_devices(client, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices2);
+	g_assert_cmpint(devices2->len, ==, 2);
+	g_assert_cmpint(mock->get_devices_cnt, ==, 1);
+	g_assert_true(g_ptr_array_index(devices2, 0) == parent_old);
+	g_clear_pointer(&devices2, g_ptr_array_unref);
+
+	/* changed: new objects are built, and the old ones are not modified */
+	generation = fwupd_client_get_device_cache_generation(client);
+	fwupd_device_set_name(parent, "Parent2");
+	fu_test_daemon_emit(mock, "DeviceChanged", parent);
+	while (signal_cnt < 1)
+		g_main_context_iteration(NULL, TRUE);
+	g_assert_cmpint(fwupd_client_get_device_cache_generation(client), >, generation);
+	devices2 = fu_test_client_get_devices(client, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices2);
+	g_assert_cmpint(devices2->len, ==, 2);
+	g_assert_cmpint(mock->get_devices_cnt, ==, 1);
+	g_assert_cmpstr(fwupd_device_get_name(g_ptr_array_index(devices2, 0)), ==, "Parent2");
+	g_assert_cmpstr(fwupd_device_get_name(parent_old), ==, "Parent");
+	g_assert_true(fwupd_device_get_parent(child_old) == parent_old);
+	g_assert_true(fwupd_device_get_parent(g_ptr_array_index(devices2, 1)) ==
+		      g_ptr_array_index(devices2, 0));
+	g_clear_pointer(&devices2, g_ptr_array_unref);
+
+	/* added */
+	generation = fwupd_client_get_device_cache_generation(client);
+	device_new = fu_test_daemon_add_device(mock, "cccc", "aaaa", "New");
+	fu_test_daemon_emit(mock, "DeviceAdded", device_new);
+	while (signal_cnt < 2)
+		g_main_context_iteration(NULL, TRUE);
+	g_assert_cmpint(fwupd_client_get_device_cache_generation(client), >, generation);
+	devices2 = fu_test_client_get_devices(client, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices2);
+	g_assert_cmpint(devices2->len, ==, 3);
+	g_assert_cmpint(mock->get_devices_cnt, ==, 1);
+
+	/* removed */
+	generation = fwupd_client_get_device_cache_generation(client);
+	fu_test_daemon_emit(mock, "DeviceRemoved", child);
+	while (signal_cnt < 3)
+		g_main_context_iteration(NULL, TRUE);
+	g_assert_cmpint(fwupd_client_get_device_cache_generation(client), >, generation);
+	devices3 = fu_test_client_get_devices(client, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices3);
+	g_assert_cmpint(devices3->len, ==, 2);
+	g_assert_cmpint(mock->get_devices_cnt, ==, 1);
+	g_assert_cmpstr(fwupd_device_get_id(g_ptr_array_index(devices3, 1)), ==, "cccc");
+}
+#endif
+
+#if defined(HAVE_LIBCURL) && !defined(_WIN32)
+/* a minimal HTTP server that supports Range requests */
+typedef struct {
+	GSocketService *service;
+	guint16 port;
+	GBytes *blob;
+	gboolean keep_alive; /* serve more than one request per connection */
+	gint connections;    /* atomic */
+	gint requests;	     /* atomic */
+	gint range_start;    /* atomic, -1 for none */
+} FuTestHttpServer;
+
+static gboolean
+fu_test_http_server_run_cb(GThreadedSocketService *service,
+			   GSocketConnection *connection,
+			   GObject *source_object,
+			   gpointer user_data)
+{
+	FuTestHttpServer *server = (FuTestHttpServer *)user_data;
+	GInputStream *istream = g_io_stream_get_input_stream(G_IO_STREAM(connection));
+	GOutputStream *ostream = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+	const guint8 *buf = g_bytes_get_data(server->blob, NULL);
+	gsize bufsz = g_bytes_get_size(server->blob);
+	gboolean keep_alive = server->keep_alive;
+	g_autoptr(GDataInputStream) dstream = g_data_input_stream_new(istream);
+
+	g_atomic_int_inc(&server->connections);
+	g_data_input_stream_set_newline_type(dstream, G_DATA_STREAM_NEWLINE_TYPE_CR_LF);
+	do {
+		gsize offset = 0;
+		guint status_code = 200;
+		g_autofree gchar *header = NULL;
+		g_autofree gchar *request = NULL;
+
+		/* the client closed the connection */
+		request = g_data_input_stream_read_line(dstream, NULL, NULL, NULL);
+		if (request == NULL || request[0] == '\0')
+			break;
+
+		/* only the Range header is interesting */
+		while (TRUE) {
+			g_autofree gchar *line =
+			    g_data_input_stream_read_line(dstream, NULL, NULL, NULL);
+			if (line == NULL || line[0] == '\0')
+				break;
+			if (g_str_has_prefix(line, "Range: bytes="))
+				offset = g_ascii_strtoull(line + 13, NULL, 10);
+		}
+		g_atomic_int_inc(&server->requests);
+		g_atomic_int_set(&server->range_start, offset > 0 ? (gint)offset : -1);
+		if (offset >= bufsz && offset > 0) {
+			status_code = 416;
+			offset = bufsz;
+		} else if (offset > 0) {
+			status_code = 206;
+		}
+		header = g_strdup_printf("HTTP/1.1 %u Status\r\n"
+					 "Content-Length: %" G_GSIZE_FORMAT "\r\n"
+					 "Connection: %s\r\n\r\n",
+					 status_code,
+					 bufsz - offset,
+					 keep_alive ? "keep-alive" : "close");
+		g_output_stream_write_all(ostream, header, strlen(header), NULL, NULL, NULL);
+		g_output_stream_write_all(ostream, buf + offset, bufsz - offset, NULL, NULL, NULL);
+	} while (keep_alive);
+	g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
+	return TRUE;
+}
+
+static FuTestHttpServer *
+fu_test_http_server_new(GBytes *blob)
+{
+	FuTestHttpServer *server = g_new0(FuTestHttpServer, 1);
+	g_autoptr(GError) error = NULL;
+
+	server->blob = g_bytes_ref(blob);
+	server->range_start = -1;
+	server->service = g_threaded_socket_service_new(4);
+	server->port = g_socket_listener_add_any_inet_port(G_SOCKET_LISTENER(server->service),
+							   NULL,
+							   &error);
+	g_assert_no_error(error);
+	g_assert_cmpint(server->port, !=, 0);
+	g_signal_connect(server->service, "run", G_CALLBACK(fu_test_http_server_run_cb), server);
+	g_socket_service_start(server->service);
+	return server;
+}
+
+static void
+fu_test_http_server_free(FuTestHttpServer *server)
+{
+	g_socket_service_stop(server->service);
+	g_socket_listener_close(G_SOCKET_LISTENER(server->service));
+	g_object_unref(server->service);
+	g_bytes_unref(server->blob);
+	g_free(server);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuTestHttpServer, fu_test_http_server_free)
+
+static GBytes *
+fu_test_download_cached(FwupdClient *client,
+			FuTestHttpServer *server,
+			const gchar *checksum,
+			GError **error)
+{
+	g_autoptr(GAsyncResult) res = NULL;
+	g_autoptr(GPtrArray) urls = g_ptr_array_new_with_free_func(g_free);
+
+	g_ptr_array_add(urls, g_strdup_printf("http://127.0.0.1:%u/firmware.bin", server->port));
+	fwupd_client_download_bytes_cached_async(client,
+						 urls,
+						 FWUPD_CLIENT_DOWNLOAD_FLAG_NONE,
+						 checksum,
+						 NULL,
+						 NULL,
+						 fu_test_async_result_cb,
+						 &res);
+	fu_test_wait_for_result(&res);
+	return fwupd_client_download_bytes_finish(client, res, error);
+}
+
+static void
+fwupd_client_download_reuse_func(void)
+{
+	const gchar *data = "firmware payload";
+	g_autofree gchar *url = NULL;
+	g_autoptr(GBytes) blob = g_bytes_new_static(data, strlen(data));
+	g_autoptr(FuTestHttpServer) server = NULL;
+	g_autoptr(FwupdClient) client = fwupd_client_new(); /* closes the connection first */
+
+	server = fu_test_http_server_new(blob);
+	server->keep_alive = TRUE;
+	url = g_strdup_printf("http://127.0.0.1:%u/firmware.bin", server->port);
+	fwupd_client_set_user_agent(client, "fwupd/" PACKAGE_VERSION);
+
+	/* the second download uses the connection left open by the first */
+	for (guint i = 0; i < 2; i++) {
+		g_autoptr(GAsyncResult) res = NULL;
+		g_autoptr(GBytes) blob_tmp = NULL;
+		g_autoptr(GError) error = NULL;
+
+		fwupd_client_download_bytes_async(client,
+						  url,
+						  FWUPD_CLIENT_DOWNLOAD_FLAG_NONE,
+						  NULL,
+						  fu_test_async_result_cb,
+						  &res);
+		fu_test_wait_for_result(&res);
+		blob_tmp = fwupd_client_download_bytes_finish(client, res, &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(blob_tmp);
+		g_assert_cmpint(g_bytes_compare(blob_tmp, blob), ==, 0);
+	}
+	g_assert_cmpint(g_atomic_int_get(&server->requests), ==, 2);
+	g_assert_cmpint(g_atomic_int_get(&server->connections), ==, 1);
+}
+
+static void
+fu_test_rmtree(const gchar *path)
+{
+	const gchar *name;
+	g_autoptr(GDir) dir = g_dir_open(path, 0, NULL);
+	if (dir == NULL)
+		return;
+	while ((name = g_dir_read_name(dir)) != NULL) {
+		g_autofree gchar *fn = g_build_filename(path, name, NULL);
+		g_unlink(fn);
+	}
+	g_rmdir(path);
+}
+
+static void
+fwupd_client_download_cache_func(void)
+{
+	gboolean ret;
+	const gchar *data = "firmware payload that is long enough to be resumed";
+	struct utimbuf utb = {0};
+	g_autofree gchar *checksum = NULL;
+	g_autofree gchar *checksum_bad = NULL;
+	g_autofree gchar *fn = NULL;
+	g_autofree gchar *fn_bad = NULL;
+	g_autofree gchar *fn_old = NULL;
+	g_autofree gchar *fn_part = NULL;
+	g_autofree gchar *tmpdir = g_dir_make_tmp("fwupd-self-test-XXXXXX", NULL);
+	g_autoptr(FwupdClient) client = fwupd_client_new();
+	g_autoptr(FuTestHttpServer) server = NULL;
+	g_autoptr(GBytes) blob = g_bytes_new_static(data, strlen(data));
+	g_autoptr(GBytes) blob2 = NULL;
+	g_autoptr(GBytes) blob3 = NULL;
+	g_autoptr(GBytes) blob4 = NULL;
+	g_autoptr(GError) error = NULL;
+
+	g_assert_nonnull(tmpdir);
+	checksum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, blob);
+	checksum_bad = g_compute_checksum_for_string(G_CHECKSUM_SHA256, "something else", -1);
+	fn = g_build_filename(tmpdir, checksum, NULL);
+	fn_part = g_strdup_printf("%s.part", fn);
+	fn_bad = g_build_filename(tmpdir, checksum_bad, NULL);
+	server = fu_test_http_server_new(blob);
+	fwupd_client_set_user_agent(client, "fwupd/" PACKAGE_VERSION);
+	fwupd_client_set_download_cache_dir(client, tmpdir);
+
+	/* disabled by default */
+	g_unsetenv("FWUPD_DOWNLOAD_CACHE_DIR");
+	{
+		g_autoptr(FwupdClient) client_tmp = fwupd_client_new();
+		g_assert_null(fwupd_client_get_download_cache_dir(client_tmp));
+	}
+
+	/* an interrupted download is continued from where it stopped */
+	ret = g_file_set_contents(fn_part, data, 10, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	blob2 = fu_test_download_cached(client, server, checksum, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob2);
+	g_assert_true(g_bytes_equal(blob, blob2));
+	g_assert_cmpint(g_atomic_int_get(&server->range_start), ==, 10);
+	g_assert_true(g_file_test(fn, G_FILE_TEST_EXISTS));
+	g_assert_false(g_file_test(fn_part, G_FILE_TEST_EXISTS));
+
+	/* the cached file is used without asking the server */
+	blob3 = fu_test_download_cached(client, server, checksum, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob3);
+	g_assert_cmpint(g_atomic_int_get(&server->requests), ==, 1);
+
+	/* a download that does not match the checksum is not cached */
+	blob4 = fu_test_download_cached(client, server, checksum_bad, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
+	g_assert_null(blob4);
+	g_clear_error(&error);
+	g_assert_false(g_file_test(fn_bad, G_FILE_TEST_EXISTS));
+
+	/* the least recently used file is evicted */
+	fn_old = g_build_filename(tmpdir, "0000", NULL);
+	ret = g_file_set_contents(fn_old, data, -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	utb.actime = 1;
+	utb.modtime = 1;
+	g_assert_cmpint(g_utime(fn_old, &utb), ==, 0);
+	g_unlink(fn);
+	fwupd_client_set_download_cache_size_max(client, g_bytes_get_size(blob) + 1);
+	g_clear_pointer(&blob2, g_bytes_unref);
+	blob2 = fu_test_download_cached(client, server, checksum, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob2);
+	g_assert_true(g_file_test(fn, G_FILE_TEST_EXISTS));
+	g_assert_false(g_file_test(fn_old, G_FILE_TEST_EXISTS));
+
+	/* a symlink is never written through */
+	g_unlink(fn);
+	g_assert_cmpint(symlink(fn_old, fn_part), ==, 0);
+	g_clear_pointer(&blob2, g_bytes_unref);
+	blob2 = fu_test_download_cached(client, server, checksum, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob2);
+	g_assert_false(g_file_test(fn_old, G_FILE_TEST_EXISTS));
+
+	fu_test_rmtree(tmpdir);
+}
+#endif
+
+#if defined(HAVE_GIO_UNIX) && defined(HAVE_LIBCURL)
+static void
+fu_test_client_percentage_notify_cb(FwupdClient *client, GParamSpec *pspec, gpointer user_data)
+{
+	guint *cnt = (guint *)user_data;
+	g_assert_cmpint(fwupd_client_get_percentage(client), <=, 100);
+	(*cnt)++;
+}
+
+static FwupdRemote *
+fu_test_remote_new(const gchar *id, FuTestHttpServer *server)
+{
+	GVariantBuilder builder;
+	g_autofree gchar *uri = NULL;
+	g_autoptr(GVariant) value = NULL;
+
+	/* the keyring kind has to be set before the URI */
+	uri = g_strdup_printf("http://127.0.0.1:%u/%s/firmware.xml.gz", server->port, id);
+	g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+	g_variant_builder_add(&builder,
+			      "{sv}",
+			      FWUPD_RESULT_KEY_REMOTE_ID,
+			      g_variant_new_string(id));
+	g_variant_builder_add(&builder,
+			      "{sv}",
+			      "Type",
+			      g_variant_new_uint32(FWUPD_REMOTE_KIND_DOWNLOAD));
+	g_variant_builder_add(&builder,
+			      "{sv}",
+			      "Keyring",
+			      g_variant_new_uint32(FWUPD_KEYRING_KIND_GPG));
+	g_variant_builder_add(&builder, "{sv}", FWUPD_RESULT_KEY_URI, g_variant_new_string(uri));
+	value = g_variant_ref_sink(g_variant_builder_end(&builder));
+	return fwupd_remote_from_variant(value);
+}
+
+static void
+fwupd_client_refresh_remotes_func(void)
+{
+	gboolean ret;
+	guint percentage_cnt = 0;
+	const gchar *data = "metadata that is the same for every remote";
+	g_autoptr(FuTestDaemon) mock = fu_test_daemon_new();
+	g_autoptr(FuTestHttpServer) server = NULL;
+	g_autoptr(FwupdClient) client = fwupd_client_new();
+	g_autoptr(GAsyncResult) res = NULL;
+	g_autoptr(GBytes) blob = g_bytes_new_static(data, strlen(data));
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) remotes = g_ptr_array_new_with_free_func(g_object_unref);
+
+	server = fu_test_http_server_new(blob);
+	fwupd_client_connect_async(client, NULL, fu_test_async_result_cb, &res);
+	fu_test_wait_for_result(&res);
+	ret = fwupd_client_connect_finish(client, res, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_clear_object(&res);
+	fwupd_client_set_user_agent(client, "fwupd/" PACKAGE_VERSION);
+	g_signal_connect(client,
+			 "notify::percentage",
+			 G_CALLBACK(fu_test_client_percentage_notify_cb),
+			 &percentage_cnt);
+
+	/* more remotes than are refreshed at the same time */
+	for (guint i = 0; i < 6; i++) {
+		g_autofree gchar *id = g_strdup_printf("remote%u", i);
+		g_ptr_array_add(remotes, fu_test_remote_new(id, server));
+	}
+	fwupd_client_refresh_remotes_async(client, remotes, NULL, fu_test_async_result_cb, &res);
+	fu_test_wait_for_result(&res);
+	ret = fwupd_client_refresh_remotes_finish(client, res, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* signature and metadata for each remote, and all sent to the daemon */
+	g_assert_cmpint(g_atomic_int_get(&server->requests), ==, remotes->len * 2);
+	g_assert_cmpint(mock->update_metadata_cnt, ==, remotes->len);
+
+	/* the concurrent downloads are reported as one */
+	g_assert_cmpint(percentage_cnt, >, 0);
+	g_assert_cmpint(fwupd_client_get_percentage(client), ==, 100);
+}
+#endif
+
 int
 main(int argc, char **argv)
 {
@@ -923,15 +1790,30 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/common{machine-hash}", fwupd_common_machine_hash_func);
 	g_test_add_func("/fwupd/common{device-id}", fwupd_common_device_id_func);
 	g_test_add_func("/fwupd/common{guid}", fwupd_common_guid_func);
+	g_test_add_func("/fwupd/common{chunks}", fwupd_common_chunks_func);
 	g_test_add_func("/fwupd/release", fwupd_release_func);
 	g_test_add_func("/fwupd/request", fwupd_request_func);
+	g_test_add_func("/fwupd/statistic", fwupd_statistic_func);
 	g_test_add_func("/fwupd/device", fwupd_device_func);
+	g_test_add_func("/fwupd/device{decode}", fwupd_device_decode_func);
 	g_test_add_func("/fwupd/security-attr", fwupd_security_attr_func);
 	g_test_add_func("/fwupd/remote{download}", fwupd_remote_download_func);
 	g_test_add_func("/fwupd/remote{base-uri}", fwupd_remote_baseuri_func);
+	g_test_add_func("/fwupd/remote{mirror}", fwupd_remote_mirror_func);
+	g_test_add_func("/fwupd/remote{delta}", fwupd_remote_delta_func);
 	g_test_add_func("/fwupd/remote{no-path}", fwupd_remote_nopath_func);
 	g_test_add_func("/fwupd/remote{local}", fwupd_remote_local_func);
 	g_test_add_func("/fwupd/remote{duplicate}", fwupd_remote_duplicate_func);
+#ifdef HAVE_GIO_UNIX
+	g_test_add_func("/fwupd/client{device-cache}", fwupd_client_device_cache_func);
+#endif
+#if defined(HAVE_LIBCURL) && !defined(_WIN32)
+	g_test_add_func("/fwupd/client{download-cache}", fwupd_client_download_cache_func);
+	g_test_add_func("/fwupd/client{download-reuse}", fwupd_client_download_reuse_func);
+#endif
+#if defined(HAVE_GIO_UNIX) && defined(HAVE_LIBCURL)
+	g_test_add_func("/fwupd/client{refresh-remotes}", fwupd_client_refresh_remotes_func);
+#endif
 	if (fwupd_has_system_bus()) {
 		g_test_add_func("/fwupd/client{remotes}", fwupd_client_remotes_func);
 		g_test_add_func("/fwupd/client{devices}", fwupd_client_devices_func);
@@ -0,0 +1,20 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include <json-glib/json-glib.h>
+
+#include "fwupd-statistic.h"
+
+G_BEGIN_DECLS
+
+GVariant *
+fwupd_statistic_to_variant(FwupdStatistic *self);
+void
+fwupd_statistic_to_json(FwupdStatistic *self, JsonBuilder *builder);
+
+G_END_DECLS
@@ -0,0 +1,836 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include "fwupd-common-private.h"
+#include "fwupd-enums-private.h"
+#include "fwupd-statistic-private.h"
+
+/**
+ * FwupdStatistic:
+ *
+ * A runtime statistic collected by the daemon, for instance the time taken to handle a D-Bus
+ * method call or the number of bytes written to a device.
+ *
+ * Histograms store the number of observations in the count, the sum of all the observations in
+ * the value, and have cumulative buckets in the same way as OpenMetrics.
+ */
+
+static void
+fwupd_statistic_finalize(GObject *object);
+
+typedef struct {
+	guint64 upper;
+	guint64 count;
+} FwupdStatisticBucket;
+
+typedef struct {
+	gchar *name;
+	FwupdStatisticKind kind;
+	GHashTable *labels; /* (element-type utf8 utf8) */
+	guint64 value;
+	guint64 count;
+	GArray *buckets; /* (element-type FwupdStatisticBucket) */
+} FwupdStatisticPrivate;
+
+enum { PROP_0, PROP_NAME, PROP_KIND, PROP_VALUE, PROP_COUNT, PROP_LAST };
+
+G_DEFINE_TYPE_WITH_PRIVATE(FwupdStatistic, fwupd_statistic, G_TYPE_OBJECT)
+#define GET_PRIVATE(o) (fwupd_statistic_get_instance_private(o))
+
+/**
+ * fwupd_statistic_kind_to_string:
+ * @kind: a statistic kind, e.g. %FWUPD_STATISTIC_KIND_COUNTER
+ *
+ * Converts a enumerated statistic kind to a string.
+ *
+ * Returns: identifier string
+ *
+ * Since: 1.8.0
+ **/
+const gchar *
+fwupd_statistic_kind_to_string(FwupdStatisticKind kind)
+{
+	if (kind == FWUPD_STATISTIC_KIND_UNKNOWN)
+		return "unknown";
+	if (kind == FWUPD_STATISTIC_KIND_COUNTER)
+		return "counter";
+	if (kind == FWUPD_STATISTIC_KIND_GAUGE)
+		return "gauge";
+	if (kind == FWUPD_STATISTIC_KIND_HISTOGRAM)
+		return "histogram";
+	return NULL;
+}
+
+/**
+ * fwupd_statistic_kind_from_string:
+ * @kind: (nullable): a string, e.g. `counter`
+ *
+ * Converts a string to an enumerated statistic kind.
+ *
+ * Returns: enumerated value
+ *
+ * Since: 1.8.0
+ **/
+FwupdStatisticKind
+fwupd_statistic_kind_from_string(const gchar *kind)
+{
+	if (g_strcmp0(kind, "counter") == 0)
+		return FWUPD_STATISTIC_KIND_COUNTER;
+	if (g_strcmp0(kind, "gauge") == 0)
+		return FWUPD_STATISTIC_KIND_GAUGE;
+	if (g_strcmp0(kind, "histogram") == 0)
+		return FWUPD_STATISTIC_KIND_HISTOGRAM;
+	return FWUPD_STATISTIC_KIND_UNKNOWN;
+}
+
+/**
+ * fwupd_statistic_get_name:
+ * @self: a #FwupdStatistic
+ *
+ * Gets the statistic name.
+ *
+ * Returns: the name, or %NULL if unset
+ *
+ * Since: 1.8.0
+ **/
+const gchar *
+fwupd_statistic_get_name(FwupdStatistic *self)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_STATISTIC(self), NULL);
+	return priv->name;
+}
+
+/**
+ * fwupd_statistic_set_name:
+ * @self: a #FwupdStatistic
+ * @name: the statistic name, e.g. `fwupd_dbus_method_duration_microseconds`
+ *
+ * Sets the statistic name.
+ *
+ * Since: 1.8.0
+ **/
+void
+fwupd_statistic_set_name(FwupdStatistic *self, const gchar *name)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_STATISTIC(self));
+
+	/* not changed */
+	if (g_strcmp0(priv->name, name) == 0)
+		return;
+
+	g_free(priv->name);
+	priv->name = g_strdup(name);
+	g_object_notify(G_OBJECT(self), "name");
+}
+
+/**
+ * fwupd_statistic_get_kind:
+ * @self: a #FwupdStatistic
+ *
+ * Gets the kind of statistic.
+ *
+ * Returns: the kind, e.g. %FWUPD_STATISTIC_KIND_HISTOGRAM
+ *
+ * Since: 1.8.0
+ **/
+FwupdStatisticKind
+fwupd_statistic_get_kind(FwupdStatistic *self)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_STATISTIC(self), FWUPD_STATISTIC_KIND_UNKNOWN);
+	return priv->kind;
+}
+
+/**
+ * fwupd_statistic_set_kind:
+ * @self: a #FwupdStatistic
+ * @kind: the kind, e.g. %FWUPD_STATISTIC_KIND_HISTOGRAM
+ *
+ * Sets the kind of statistic.
+ *
+ * Since: 1.8.0
+ **/
+void
+fwupd_statistic_set_kind(FwupdStatistic *self, FwupdStatisticKind kind)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_STATISTIC(self));
+	if (priv->kind == kind)
+		return;
+	priv->kind = kind;
+	g_object_notify(G_OBJECT(self), "kind");
+}
+
+/**
+ * fwupd_statistic_get_labels:
+ * @self: a #FwupdStatistic
+ *
+ * Gets all the labels that distinguish this statistic from others with the same name.
+ *
+ * Returns: (transfer none) (element-type utf8 utf8): labels
+ *
+ * Since: 1.8.0
+ **/
+GHashTable *
+fwupd_statistic_get_labels(FwupdStatistic *self)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_STATISTIC(self), NULL);
+	return priv->labels;
+}
+
+/**
+ * fwupd_statistic_get_label:
+ * @self: a #FwupdStatistic
+ * @key: a label key, e.g. `method`
+ *
+ * Gets a specific label value.
+ *
+ * Returns: the label value, or %NULL if unset
+ *
+ * Since: 1.8.0
+ **/
+const gchar *
+fwupd_statistic_get_label(FwupdStatistic *self, const gchar *key)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_STATISTIC(self), NULL);
+	g_return_val_if_fail(key != NULL, NULL);
+	return g_hash_table_lookup(priv->labels, key);
+}
+
+/**
+ * fwupd_statistic_add_label:
+ * @self: a #FwupdStatistic
+ * @key: a label key, e.g. `method`
+ * @value: a label value, e.g. `GetDevices`
+ *
+ * Adds a label, replacing any existing value with the same key.
+ *
+ * Since: 1.8.0
+ **/
+void
+fwupd_statistic_add_label(FwupdStatistic *self, const gchar *key, const gchar *value)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_STATISTIC(self));
+	g_return_if_fail(key != NULL);
+	g_return_if_fail(value != NULL);
+	g_hash_table_insert(priv->labels, g_strdup(key), g_strdup(value));
+}
+
+/**
+ * fwupd_statistic_get_value:
+ * @self: a #FwupdStatistic
+ *
+ * Gets the statistic value. For histograms this is the sum of all the observations.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.0
+ **/
+guint64
+fwupd_statistic_get_value(FwupdStatistic *self)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_STATISTIC(self), 0);
+	return priv->value;
+}
+
+/**
+ * fwupd_statistic_set_value:
+ * @self: a #FwupdStatistic
+ * @value: integer
+ *
+ * Sets the statistic value.
+ *
+ * Since: 1.8.0
+ **/
+void
+fwupd_statistic_set_value(FwupdStatistic *self, guint64 value)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_STATISTIC(self));
+	if (priv->value == value)
+		return;
+	priv->value = value;
+	g_object_notify(G_OBJECT(self), "value");
+}
+
+/**
+ * fwupd_statistic_get_count:
+ * @self: a #FwupdStatistic
+ *
+ * Gets the number of observations, which is only set for histograms.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.0
+ **/
+guint64
+fwupd_statistic_get_count(FwupdStatistic *self)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_STATISTIC(self), 0);
+	return priv->count;
+}
+
+/**
+ * fwupd_statistic_set_count:
+ * @self: a #FwupdStatistic
+ * @count: integer
+ *
+ * Sets the number of observations.
+ *
+ * Since: 1.8.0
+ **/
+void
+fwupd_statistic_set_count(FwupdStatistic *self, guint64 count)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_STATISTIC(self));
+	if (priv->count == count)
+		return;
+	priv->count = count;
+	g_object_notify(G_OBJECT(self), "count");
+}
+
+/**
+ * fwupd_statistic_get_n_buckets:
+ * @self: a #FwupdStatistic
+ *
+ * Gets the number of histogram buckets.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.0
+ **/
+guint
+fwupd_statistic_get_n_buckets(FwupdStatistic *self)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_STATISTIC(self), 0);
+	return priv->buckets->len;
+}
+
+/**
+ * fwupd_statistic_get_bucket:
+ * @self: a #FwupdStatistic
+ * @idx: bucket index
+ * @upper: (out) (optional): the inclusive upper bound of the bucket
+ * @count: (out) (optional): the number of observations less than or equal to @upper
+ *
+ * Gets a histogram bucket.
+ *
+ * Returns: %TRUE if @idx was valid
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fwupd_statistic_get_bucket(FwupdStatistic *self, guint idx, guint64 *upper, guint64 *count)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	FwupdStatisticBucket *bucket;
+
+	g_return_val_if_fail(FWUPD_IS_STATISTIC(self), FALSE);
+
+	if (idx >= priv->buckets->len)
+		return FALSE;
+	bucket = &g_array_index(priv->buckets, FwupdStatisticBucket, idx);
+	if (upper != NULL)
+		*upper = bucket->upper;
+	if (count != NULL)
+		*count = bucket->count;
+	return TRUE;
+}
+
+/**
+ * fwupd_statistic_add_bucket:
+ * @self: a #FwupdStatistic
+ * @upper: the inclusive upper bound of the bucket
+ * @count: the number of observations less than or equal to @upper
+ *
+ * Adds a histogram bucket. Buckets are cumulative and have to be added in increasing order, and
+ * the implicit `+Inf` bucket is the same as the number of observations.
+ *
+ * Since: 1.8.0
+ **/
+void
+fwupd_statistic_add_bucket(FwupdStatistic *self, guint64 upper, guint64 count)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	FwupdStatisticBucket bucket = {.upper = upper, .count = count};
+	g_return_if_fail(FWUPD_IS_STATISTIC(self));
+	g_array_append_val(priv->buckets, bucket);
+}
+
+/**
+ * fwupd_statistic_to_variant:
+ * @self: a #FwupdStatistic
+ *
+ * Serialize the statistic data.
+ *
+ * Returns: the serialized data, or %NULL for error
+ *
+ * Since: 1.8.0
+ **/
+GVariant *
+fwupd_statistic_to_variant(FwupdStatistic *self)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	GVariantBuilder builder;
+
+	g_return_val_if_fail(FWUPD_IS_STATISTIC(self), NULL);
+
+	/* create an array with all the metadata in */
+	g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+	if (priv->name != NULL) {
+		g_variant_builder_add(&builder,
+				      "{sv}",
+				      FWUPD_RESULT_KEY_NAME,
+				      g_variant_new_string(priv->name));
+	}
+	if (priv->kind != FWUPD_STATISTIC_KIND_UNKNOWN) {
+		g_variant_builder_add(&builder,
+				      "{sv}",
+				      FWUPD_RESULT_KEY_STATISTIC_KIND,
+				      g_variant_new_uint32(priv->kind));
+	}
+	if (g_hash_table_size(priv->labels) > 0) {
+		GHashTableIter iter;
+		GVariantBuilder builder_labels;
+		const gchar *key;
+		const gchar *value;
+		g_variant_builder_init(&builder_labels, G_VARIANT_TYPE("a{ss}"));
+		g_hash_table_iter_init(&iter, priv->labels);
+		while (g_hash_table_iter_next(&iter, (gpointer *)&key, (gpointer *)&value))
+			g_variant_builder_add(&builder_labels, "{ss}", key, value);
+		g_variant_builder_add(&builder,
+				      "{sv}",
+				      FWUPD_RESULT_KEY_STATISTIC_LABELS,
+				      g_variant_builder_end(&builder_labels));
+	}
+	g_variant_builder_add(&builder,
+			      "{sv}",
+			      FWUPD_RESULT_KEY_STATISTIC_VALUE,
+			      g_variant_new_uint64(priv->value));
+	if (priv->kind == FWUPD_STATISTIC_KIND_HISTOGRAM) {
+		GVariantBuilder builder_buckets;
+		g_variant_builder_add(&builder,
+				      "{sv}",
+				      FWUPD_RESULT_KEY_STATISTIC_COUNT,
+				      g_variant_new_uint64(priv->count));
+		g_variant_builder_init(&builder_buckets, G_VARIANT_TYPE("a(tt)"));
+		for (guint i = 0; i < priv->buckets->len; i++) {
+			FwupdStatisticBucket *bucket =
+			    &g_array_index(priv->buckets, FwupdStatisticBucket, i);
+			g_variant_builder_add(&builder_buckets,
+					      "(tt)",
+					      bucket->upper,
+					      bucket->count);
+		}
+		g_variant_builder_add(&builder,
+				      "{sv}",
+				      FWUPD_RESULT_KEY_STATISTIC_BUCKETS,
+				      g_variant_builder_end(&builder_buckets));
+	}
+	return g_variant_new("a{sv}", &builder);
+}
+
+static void
+fwupd_statistic_from_key_value(FwupdStatistic *self, const gchar *key, GVariant *value)
+{
+	if (g_strcmp0(key, FWUPD_RESULT_KEY_NAME) == 0) {
+		fwupd_statistic_set_name(self, g_variant_get_string(value, NULL));
+		return;
+	}
+	if (g_strcmp0(key, FWUPD_RESULT_KEY_STATISTIC_KIND) == 0) {
+		fwupd_statistic_set_kind(self, g_variant_get_uint32(value));
+		return;
+	}
+	if (g_strcmp0(key, FWUPD_RESULT_KEY_STATISTIC_LABELS) == 0) {
+		GVariantIter iter;
+		const gchar *label_key;
+		const gchar *label_value;
+		g_variant_iter_init(&iter, value);
+		while (g_variant_iter_next(&iter, "{&s&s}", &label_key, &label_value))
+			fwupd_statistic_add_label(self, label_key, label_value);
+		return;
+	}
+	if (g_strcmp0(key, FWUPD_RESULT_KEY_STATISTIC_VALUE) == 0) {
+		fwupd_statistic_set_value(self, g_variant_get_uint64(value));
+		return;
+	}
+	if (g_strcmp0(key, FWUPD_RESULT_KEY_STATISTIC_COUNT) == 0) {
+		fwupd_statistic_set_count(self, g_variant_get_uint64(value));
+		return;
+	}
+	if (g_strcmp0(key, FWUPD_RESULT_KEY_STATISTIC_BUCKETS) == 0) {
+		GVariantIter iter;
+		guint64 upper = 0;
+		guint64 count = 0;
+		g_variant_iter_init(&iter, value);
+		while (g_variant_iter_next(&iter, "(tt)", &upper, &count))
+			fwupd_statistic_add_bucket(self, upper, count);
+		return;
+	}
+}
+
+static void
+fwupd_pad_kv_str(GString *str, const gchar *key, const gchar *value)
+{
+	/* ignore */
+	if (key == NULL || value == NULL)
+		return;
+	g_string_append_printf(str, "  %s: ", key);
+	for (gsize i = strlen(key); i < 20; i++)
+		g_string_append(str, " ");
+	g_string_append_printf(str, "%s\n", value);
+}
+
+static void
+fwupd_pad_kv_int(GString *str, const gchar *key, guint64 value)
+{
+	g_autofree gchar *tmp = g_strdup_printf("%" G_GUINT64_FORMAT, value);
+	fwupd_pad_kv_str(str, key, tmp);
+}
+
+/**
+ * fwupd_statistic_to_json:
+ * @self: a #FwupdStatistic
+ * @builder: a JSON builder
+ *
+ * Adds a fwupd statistic to a JSON builder
+ *
+ * Since: 1.8.0
+ **/
+void
+fwupd_statistic_to_json(FwupdStatistic *self, JsonBuilder *builder)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+
+	g_return_if_fail(FWUPD_IS_STATISTIC(self));
+	g_return_if_fail(builder != NULL);
+
+	fwupd_common_json_add_string(builder, FWUPD_RESULT_KEY_NAME, priv->name);
+	fwupd_common_json_add_string(builder,
+				     FWUPD_RESULT_KEY_STATISTIC_KIND,
+				     fwupd_statistic_kind_to_string(priv->kind));
+	if (g_hash_table_size(priv->labels) > 0) {
+		g_autoptr(GList) keys = g_hash_table_get_keys(priv->labels);
+		keys = g_list_sort(keys, (GCompareFunc)g_strcmp0);
+		json_builder_set_member_name(builder, FWUPD_RESULT_KEY_STATISTIC_LABELS);
+		json_builder_begin_object(builder);
+		for (GList *l = keys; l != NULL; l = l->next) {
+			const gchar *key = l->data;
+			fwupd_common_json_add_string(builder,
+						     key,
+						     g_hash_table_lookup(priv->labels, key));
+		}
+		json_builder_end_object(builder);
+	}
+	fwupd_common_json_add_int(builder, FWUPD_RESULT_KEY_STATISTIC_VALUE, priv->value);
+	if (priv->kind == FWUPD_STATISTIC_KIND_HISTOGRAM) {
+		fwupd_common_json_add_int(builder, FWUPD_RESULT_KEY_STATISTIC_COUNT, priv->count);
+		json_builder_set_member_name(builder, FWUPD_RESULT_KEY_STATISTIC_BUCKETS);
+		json_builder_begin_array(builder);
+		for (guint i = 0; i < priv->buckets->len; i++) {
+			FwupdStatisticBucket *bucket =
+			    &g_array_index(priv->buckets, FwupdStatisticBucket, i);
+			json_builder_begin_object(builder);
+			fwupd_common_json_add_int(builder, "Upper", bucket->upper);
+			fwupd_common_json_add_int(builder, "Count", bucket->count);
+			json_builder_end_object(builder);
+		}
+		json_builder_end_array(builder);
+	}
+}
+
+/**
+ * fwupd_statistic_to_string:
+ * @self: a #FwupdStatistic
+ *
+ * Builds a text representation of the object.
+ *
+ * Returns: text, or %NULL for invalid
+ *
+ * Since: 1.8.0
+ **/
+gchar *
+fwupd_statistic_to_string(FwupdStatistic *self)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	GHashTableIter iter;
+	const gchar *key;
+	const gchar *value;
+	g_autoptr(GString) str = g_string_new(NULL);
+
+	g_return_val_if_fail(FWUPD_IS_STATISTIC(self), NULL);
+
+	fwupd_pad_kv_str(str, FWUPD_RESULT_KEY_NAME, priv->name);
+	fwupd_pad_kv_str(str,
+			 FWUPD_RESULT_KEY_STATISTIC_KIND,
+			 fwupd_statistic_kind_to_string(priv->kind));
+	g_hash_table_iter_init(&iter, priv->labels);
+	while (g_hash_table_iter_next(&iter, (gpointer *)&key, (gpointer *)&value)) {
+		g_autofree gchar *tmp = g_strdup_printf("%s=%s", key, value);
+		fwupd_pad_kv_str(str, FWUPD_RESULT_KEY_STATISTIC_LABELS, tmp);
+	}
+	fwupd_pad_kv_int(str, FWUPD_RESULT_KEY_STATISTIC_VALUE, priv->value);
+	if (priv->kind == FWUPD_STATISTIC_KIND_HISTOGRAM) {
+		fwupd_pad_kv_int(str, FWUPD_RESULT_KEY_STATISTIC_COUNT, priv->count);
+		for (guint i = 0; i < priv->buckets->len; i++) {
+			FwupdStatisticBucket *bucket =
+			    &g_array_index(priv->buckets, FwupdStatisticBucket, i);
+			g_autofree gchar *tmp = NULL;
+			tmp = g_strdup_printf("%" G_GUINT64_FORMAT "=%" G_GUINT64_FORMAT,
+					      bucket->upper,
+					      bucket->count);
+			fwupd_pad_kv_str(str, FWUPD_RESULT_KEY_STATISTIC_BUCKETS, tmp);
+		}
+	}
+	return g_string_free(g_steal_pointer(&str), FALSE);
+}
+
+static void
+fwupd_statistic_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+	FwupdStatistic *self = FWUPD_STATISTIC(object);
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	switch (prop_id) {
+	case PROP_NAME:
+		g_value_set_string(value, priv->name);
+		break;
+	case PROP_KIND:
+		g_value_set_uint(value, priv->kind);
+		break;
+	case PROP_VALUE:
+		g_value_set_uint64(value, priv->value);
+		break;
+	case PROP_COUNT:
+		g_value_set_uint64(value, priv->count);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+		break;
+	}
+}
+
+static void
+fwupd_statistic_set_property(GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+	FwupdStatistic *self = FWUPD_STATISTIC(object);
+	switch (prop_id) {
+	case PROP_NAME:
+		fwupd_statistic_set_name(self, g_value_get_string(value));
+		break;
+	case PROP_KIND:
+		fwupd_statistic_set_kind(self, g_value_get_uint(value));
+		break;
+	case PROP_VALUE:
+		fwupd_statistic_set_value(self, g_value_get_uint64(value));
+		break;
+	case PROP_COUNT:
+		fwupd_statistic_set_count(self, g_value_get_uint64(value));
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+		break;
+	}
+}
+
+static void
+fwupd_statistic_finalize(GObject *object)
+{
+	FwupdStatistic *self = FWUPD_STATISTIC(object);
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+
+	g_free(priv->name);
+	g_hash_table_unref(priv->labels);
+	g_array_unref(priv->buckets);
+
+	G_OBJECT_CLASS(fwupd_statistic_parent_class)->finalize(object);
+}
+
+static void
+fwupd_statistic_init(FwupdStatistic *self)
+{
+	FwupdStatisticPrivate *priv = GET_PRIVATE(self);
+	priv->labels = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	priv->buckets = g_array_new(FALSE, FALSE, sizeof(FwupdStatisticBucket));
+}
+
+static void
+fwupd_statistic_class_init(FwupdStatisticClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	GParamSpec *pspec;
+
+	object_class->finalize = fwupd_statistic_finalize;
+	object_class->get_property = fwupd_statistic_get_property;
+	object_class->set_property = fwupd_statistic_set_property;
+
+	/**
+	 * FwupdStatistic:name:
+	 *
+	 * The statistic name.
+	 *
+	 * Since: 1.8.0
+	 */
+	pspec =
+	    g_param_spec_string("name", NULL, NULL, NULL, G_PARAM_READWRITE | G_PARAM_STATIC_NAME);
+	g_object_class_install_property(object_class, PROP_NAME, pspec);
+
+	/**
+	 * FwupdStatistic:kind:
+	 *
+	 * The kind of the statistic.
+	 *
+	 * Since: 1.8.0
+	 */
+	pspec = g_param_spec_uint("kind",
+				  NULL,
+				  NULL,
+				  FWUPD_STATISTIC_KIND_UNKNOWN,
+				  FWUPD_STATISTIC_KIND_LAST,
+				  FWUPD_STATISTIC_KIND_UNKNOWN,
+				  G_PARAM_READWRITE | G_PARAM_STATIC_NAME);
+	g_object_class_install_property(object_class, PROP_KIND, pspec);
+
+	/**
+	 * FwupdStatistic:value:
+	 *
+	 * The statistic value, or the sum of all observations for histograms.
+	 *
+	 * Since: 1.8.0
+	 */
+	pspec = g_param_spec_uint64("value",
+				    NULL,
+				    NULL,
+				    0,
+				    G_MAXUINT64,
+				    0,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_NAME);
+	g_object_class_install_property(object_class, PROP_VALUE, pspec);
+
+	/**
+	 * FwupdStatistic:count:
+	 *
+	 * The number of observations for histograms.
+	 *
+	 * Since: 1.8.0
+	 */
+	pspec = g_param_spec_uint64("count",
+				    NULL,
+				    NULL,
+				    0,
+				    G_MAXUINT64,
+				    0,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_NAME);
+	g_object_class_install_property(object_class, PROP_COUNT, pspec);
+}
+
+static void
+fwupd_statistic_set_from_variant_iter(FwupdStatistic *self, GVariantIter *iter)
+{
+	GVariant *value;
+	const gchar *key;
+	while (g_variant_iter_next(iter, "{&sv}", &key, &value)) {
+		fwupd_statistic_from_key_value(self, key, value);
+		g_variant_unref(value);
+	}
+}
+
+/**
+ * fwupd_statistic_from_variant:
+ * @value: (not nullable): the serialized data
+ *
+ * Creates a new statistic using serialized data.
+ *
+ * Returns: (transfer full): a new #FwupdStatistic, or %NULL if @value was invalid
+ *
+ * Since: 1.8.0
+ **/
+FwupdStatistic *
+fwupd_statistic_from_variant(GVariant *value)
+{
+	FwupdStatistic *self = NULL;
+	const gchar *type_string;
+	g_autoptr(GVariantIter) iter = NULL;
+
+	g_return_val_if_fail(value != NULL, NULL);
+
+	type_string = g_variant_get_type_string(value);
+	if (g_strcmp0(type_string, "(a{sv})") == 0) {
+		self = fwupd_statistic_new();
+		g_variant_get(value, "(a{sv})", &iter);
+		fwupd_statistic_set_from_variant_iter(self, iter);
+	} else if (g_strcmp0(type_string, "a{sv}") == 0) {
+		self = fwupd_statistic_new();
+		g_variant_get(value, "a{sv}", &iter);
+		fwupd_statistic_set_from_variant_iter(self, iter);
+	} else {
+		g_warning("type %s not known", type_string);
+	}
+	return self;
+}
+
+/**
+ * fwupd_statistic_array_from_variant:
+ * @value: (not nullable): the serialized data
+ *
+ * Creates an array of new statistics using serialized data.
+ *
+ * Returns: (transfer container) (element-type FwupdStatistic): statistics
+ *
+ * Since: 1.8.0
+ **/
+GPtrArray *
+fwupd_statistic_array_from_variant(GVariant *value)
+{
+	GPtrArray *array = NULL;
+	gsize sz;
+	g_autoptr(GVariant) untuple = NULL;
+
+	g_return_val_if_fail(value != NULL, NULL);
+
+	array = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	untuple = g_variant_get_child_value(value, 0);
+	sz = g_variant_n_children(untuple);
+	for (guint i = 0; i < sz; i++) {
+		FwupdStatistic *self;
+		g_autoptr(GVariant) data = NULL;
+		data = g_variant_get_child_value(untuple, i);
+		self = fwupd_statistic_from_variant(data);
+		if (self == NULL)
+			continue;
+		g_ptr_array_add(array, self);
+	}
+	return array;
+}
+
+/**
+ * fwupd_statistic_new:
+ *
+ * Creates a new statistic.
+ *
+ * Returns: a new #FwupdStatistic
+ *
+ * Since: 1.8.0
+ **/
+FwupdStatistic *
+fwupd_statistic_new(void)
+{
+	FwupdStatistic *self;
+	self = g_object_new(FWUPD_TYPE_STATISTIC, NULL);
+	return FWUPD_STATISTIC(self);
+}
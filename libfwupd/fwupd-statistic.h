@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define FWUPD_TYPE_STATISTIC (fwupd_statistic_get_type())
+G_DECLARE_DERIVABLE_TYPE(FwupdStatistic, fwupd_statistic, FWUPD, STATISTIC, GObject)
+
+struct _FwupdStatisticClass {
+	GObjectClass parent_class;
+	/*< private >*/
+	void (*_fwupd_reserved1)(void);
+	void (*_fwupd_reserved2)(void);
+	void (*_fwupd_reserved3)(void);
+	void (*_fwupd_reserved4)(void);
+	void (*_fwupd_reserved5)(void);
+	void (*_fwupd_reserved6)(void);
+	void (*_fwupd_reserved7)(void);
+};
+
+/**
+ * FwupdStatisticKind:
+ * @FWUPD_STATISTIC_KIND_UNKNOWN:	Unknown kind
+ * @FWUPD_STATISTIC_KIND_COUNTER:	A value that only ever increases
+ * @FWUPD_STATISTIC_KIND_GAUGE:		A value that can go up and down
+ * @FWUPD_STATISTIC_KIND_HISTOGRAM:	A distribution of observed values
+ *
+ * The kind of statistic, using the OpenMetrics terminology.
+ **/
+typedef enum {
+	FWUPD_STATISTIC_KIND_UNKNOWN,   /* Since: 1.8.0 */
+	FWUPD_STATISTIC_KIND_COUNTER,   /* Since: 1.8.0 */
+	FWUPD_STATISTIC_KIND_GAUGE,     /* Since: 1.8.0 */
+	FWUPD_STATISTIC_KIND_HISTOGRAM, /* Since: 1.8.0 */
+	/*< private >*/
+	FWUPD_STATISTIC_KIND_LAST
+} FwupdStatisticKind;
+
+const gchar *
+fwupd_statistic_kind_to_string(FwupdStatisticKind kind);
+FwupdStatisticKind
+fwupd_statistic_kind_from_string(const gchar *kind);
+
+FwupdStatistic *
+fwupd_statistic_new(void);
+gchar *
+fwupd_statistic_to_string(FwupdStatistic *self);
+
+const gchar *
+fwupd_statistic_get_name(FwupdStatistic *self);
+void
+fwupd_statistic_set_name(FwupdStatistic *self, const gchar *name);
+FwupdStatisticKind
+fwupd_statistic_get_kind(FwupdStatistic *self);
+void
+fwupd_statistic_set_kind(FwupdStatistic *self, FwupdStatisticKind kind);
+GHashTable *
+fwupd_statistic_get_labels(FwupdStatistic *self);
+const gchar *
+fwupd_statistic_get_label(FwupdStatistic *self, const gchar *key);
+void
+fwupd_statistic_add_label(FwupdStatistic *self, const gchar *key, const gchar *value);
+guint64
+fwupd_statistic_get_value(FwupdStatistic *self);
+void
+fwupd_statistic_set_value(FwupdStatistic *self, guint64 value);
+guint64
+fwupd_statistic_get_count(FwupdStatistic *self);
+void
+fwupd_statistic_set_count(FwupdStatistic *self, guint64 count);
+guint
+fwupd_statistic_get_n_buckets(FwupdStatistic *self);
+gboolean
+fwupd_statistic_get_bucket(FwupdStatistic *self, guint idx, guint64 *upper, guint64 *count);
+void
+fwupd_statistic_add_bucket(FwupdStatistic *self, guint64 upper, guint64 count);
+
+FwupdStatistic *
+fwupd_statistic_from_variant(GVariant *value);
+GPtrArray *
+fwupd_statistic_array_from_variant(GVariant *value);
+
+G_END_DECLS
@@ -19,6 +19,7 @@
 #include <libfwupd/fwupd-remote.h>
 #include <libfwupd/fwupd-request.h>
 #include <libfwupd/fwupd-security-attr.h>
+#include <libfwupd/fwupd-statistic.h>
 #include <libfwupd/fwupd-version.h>
 
 #ifndef FWUPD_DISABLE_DEPRECATED
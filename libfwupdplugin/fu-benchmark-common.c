@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define G_LOG_DOMAIN "FuBenchmark"
+
+#include "config.h"
+
+#include <json-glib/json-glib.h>
+
+#include "fu-benchmark-common.h"
+
+struct FuBenchmark {
+	gchar *suite;
+	JsonBuilder *builder;
+};
+
+typedef struct {
+	gchar *name;
+	guint iterations;
+	gint64 total;
+	gint64 min;
+	gint64 max;
+	gint64 median;
+} FuBenchmarkResult;
+
+/**
+ * fu_benchmark_new:
+ * @suite: a suite name, e.g. `libfwupdplugin`
+ *
+ * Creates a new benchmark runner. Results are written as JSON to stdout, or to the file
+ * specified by the `FWUPD_BENCHMARK_JSON` environment variable.
+ *
+ * Returns: (transfer full): a #FuBenchmark
+ **/
+FuBenchmark *
+fu_benchmark_new(const gchar *suite)
+{
+	FuBenchmark *self = g_new0(FuBenchmark, 1);
+	self->suite = g_strdup(suite);
+	self->builder = json_builder_new();
+	json_builder_begin_object(self->builder);
+	json_builder_set_member_name(self->builder, "Suite");
+	json_builder_add_string_value(self->builder, suite);
+	json_builder_set_member_name(self->builder, "Version");
+	json_builder_add_string_value(self->builder, PACKAGE_VERSION);
+	json_builder_set_member_name(self->builder, "Results");
+	json_builder_begin_array(self->builder);
+	return self;
+}
+
+/**
+ * fu_benchmark_free:
+ * @self: a #FuBenchmark
+ *
+ * Destroys the benchmark runner.
+ **/
+void
+fu_benchmark_free(FuBenchmark *self)
+{
+	g_free(self->suite);
+	g_object_unref(self->builder);
+	g_free(self);
+}
+
+static gint
+fu_benchmark_sort_cb(gconstpointer a, gconstpointer b)
+{
+	gint64 val_a = *((const gint64 *)a);
+	gint64 val_b = *((const gint64 *)b);
+	if (val_a < val_b)
+		return -1;
+	if (val_a > val_b)
+		return 1;
+	return 0;
+}
+
+static void
+fu_benchmark_add_result(FuBenchmark *self, FuBenchmarkResult *result)
+{
+	json_builder_begin_object(self->builder);
+	json_builder_set_member_name(self->builder, "Name");
+	json_builder_add_string_value(self->builder, result->name);
+	json_builder_set_member_name(self->builder, "Iterations");
+	json_builder_add_int_value(self->builder, result->iterations);
+	json_builder_set_member_name(self->builder, "Total");
+	json_builder_add_int_value(self->builder, result->total);
+	json_builder_set_member_name(self->builder, "Mean");
+	json_builder_add_int_value(self->builder, result->total / result->iterations);
+	json_builder_set_member_name(self->builder, "Median");
+	json_builder_add_int_value(self->builder, result->median);
+	json_builder_set_member_name(self->builder, "Min");
+	json_builder_add_int_value(self->builder, result->min);
+	json_builder_set_member_name(self->builder, "Max");
+	json_builder_add_int_value(self->builder, result->max);
+	json_builder_end_object(self->builder);
+}
+
+/**
+ * fu_benchmark_run:
+ * @self: a #FuBenchmark
+ * @name: a benchmark name, e.g. `crc32:1MiB`
+ * @iterations: number of times to run @func
+ * @func: the function to time
+ * @user_data: user data passed to @func
+ * @error: (nullable): optional return location for an error
+ *
+ * Runs @func once to warm any caches, and then @iterations times, recording the duration of each
+ * run in µs. Benchmarks not matching the `FWUPD_BENCHMARK_FILTER` glob are skipped.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_benchmark_run(FuBenchmark *self,
+		 const gchar *name,
+		 guint iterations,
+		 FuBenchmarkFunc func,
+		 gpointer user_data,
+		 GError **error)
+{
+	const gchar *filter = g_getenv("FWUPD_BENCHMARK_FILTER");
+	FuBenchmarkResult result = {.name = (gchar *)name, .iterations = iterations};
+	g_autoptr(GArray) durations = g_array_sized_new(FALSE, FALSE, sizeof(gint64), iterations);
+
+	g_return_val_if_fail(self != NULL, FALSE);
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(iterations > 0, FALSE);
+	g_return_val_if_fail(func != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* not interesting */
+	if (filter != NULL && !g_pattern_match_simple(filter, name))
+		return TRUE;
+
+	/* warm up */
+	if (!func(user_data, error)) {
+		g_prefix_error(error, "failed to run %s: ", name);
+		return FALSE;
+	}
+
+	for (guint i = 0; i < iterations; i++) {
+		gint64 start = g_get_monotonic_time();
+		gint64 duration;
+		if (!func(user_data, error)) {
+			g_prefix_error(error, "failed to run %s: ", name);
+			return FALSE;
+		}
+		duration = g_get_monotonic_time() - start;
+		g_array_append_val(durations, duration);
+		result.total += duration;
+	}
+	g_array_sort(durations, fu_benchmark_sort_cb);
+	result.min = g_array_index(durations, gint64, 0);
+	result.max = g_array_index(durations, gint64, iterations - 1);
+	result.median = g_array_index(durations, gint64, iterations / 2);
+	g_debug("%s: %" G_GINT64_FORMAT "µs", name, result.median);
+	fu_benchmark_add_result(self, &result);
+	return TRUE;
+}
+
+/**
+ * fu_benchmark_save:
+ * @self: a #FuBenchmark
+ * @error: (nullable): optional return location for an error
+ *
+ * Writes all the results as JSON.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_benchmark_save(FuBenchmark *self, GError **error)
+{
+	const gchar *filename = g_getenv("FWUPD_BENCHMARK_JSON");
+	g_autofree gchar *data = NULL;
+	g_autoptr(JsonGenerator) json_generator = json_generator_new();
+	g_autoptr(JsonNode) json_root = NULL;
+
+	g_return_val_if_fail(self != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	json_builder_end_array(self->builder);
+	json_builder_end_object(self->builder);
+	json_root = json_builder_get_root(self->builder);
+	json_generator_set_pretty(json_generator, TRUE);
+	json_generator_set_root(json_generator, json_root);
+	data = json_generator_to_data(json_generator, NULL);
+	if (filename == NULL) {
+		g_print("%s\n", data);
+		return TRUE;
+	}
+	return g_file_set_contents(filename, data, -1, error);
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include <glib.h>
+
+typedef struct FuBenchmark FuBenchmark;
+
+typedef gboolean (*FuBenchmarkFunc)(gpointer user_data, GError **error);
+
+FuBenchmark *
+fu_benchmark_new(const gchar *suite);
+void
+fu_benchmark_free(FuBenchmark *self);
+gboolean
+fu_benchmark_run(FuBenchmark *self,
+		 const gchar *name,
+		 guint iterations,
+		 FuBenchmarkFunc func,
+		 gpointer user_data,
+		 GError **error) G_GNUC_WARN_UNUSED_RESULT;
+gboolean
+fu_benchmark_save(FuBenchmark *self, GError **error) G_GNUC_WARN_UNUSED_RESULT;
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuBenchmark, fu_benchmark_free)
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#include "config.h"
+
+#include <fwupdplugin.h>
+
+#include "fu-benchmark-common.h"
+#include "fu-context-private.h"
+#include "fu-coswid-firmware.h"
+#include "fu-efi-firmware-file.h"
+#include "fu-efi-firmware-filesystem.h"
+#include "fu-efi-firmware-section.h"
+#include "fu-efi-firmware-volume.h"
+#include "fu-smbios.h"
+#include "fu-uswid-firmware.h"
+
+#define FU_BENCHMARK_QUIRK_COUNT 10000
+
+typedef struct {
+	GBytes *blob;
+	FuContext *ctx;
+	GType gtype;
+	guint idx;
+	guint32 checksum;
+} FuBenchmarkHelper;
+
+static void
+fu_benchmark_helper_free(FuBenchmarkHelper *helper)
+{
+	if (helper->blob != NULL)
+		g_bytes_unref(helper->blob);
+	if (helper->ctx != NULL)
+		g_object_unref(helper->ctx);
+	g_free(helper);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuBenchmarkHelper, fu_benchmark_helper_free)
+
+static GBytes *
+fu_benchmark_blob_new(gsize bufsz)
+{
+	guint8 *buf = g_malloc(bufsz);
+	for (gsize i = 0; i < bufsz; i++)
+		buf[i] = (guint8)g_random_int_range(0x00, 0x100);
+	return g_bytes_new_take(buf, bufsz);
+}
+
+static gboolean
+fu_benchmark_crc8_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	gsize bufsz = 0;
+	const guint8 *buf = g_bytes_get_data(helper->blob, &bufsz);
+	helper->checksum = fu_common_crc8(buf, bufsz);
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_crc16_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	gsize bufsz = 0;
+	const guint8 *buf = g_bytes_get_data(helper->blob, &bufsz);
+	helper->checksum = fu_common_crc16(buf, bufsz);
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_crc32_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	gsize bufsz = 0;
+	const guint8 *buf = g_bytes_get_data(helper->blob, &bufsz);
+	helper->checksum = fu_common_crc32(buf, bufsz);
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_sum8_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	helper->checksum = fu_common_sum8_bytes(helper->blob);
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_sum16_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	helper->checksum = fu_common_sum16_bytes(helper->blob);
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_sum32w_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	helper->checksum = fu_common_sum32w_bytes(helper->blob, G_LITTLE_ENDIAN);
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_chunks_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	gsize bufsz = 0;
+	const guint8 *buf = g_bytes_get_data(helper->blob, &bufsz);
+	g_autoptr(GPtrArray) chunks = fu_chunk_array_new(buf, bufsz, 0x0, 0x1000, 64);
+	return chunks->len > 0;
+}
+
+static gboolean
+fu_benchmark_quirks_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	const gchar *tmp;
+	g_autofree gchar *instance_id = NULL;
+	g_autofree gchar *guid = NULL;
+
+	/* vary the lookup so the result is not cached */
+	helper->idx = (helper->idx + 7919) % FU_BENCHMARK_QUIRK_COUNT;
+	instance_id = g_strdup_printf("USB\\VID_273F&PID_%04X", helper->idx);
+	guid = fwupd_guid_hash_string(instance_id);
+	tmp = fu_context_lookup_quirk_by_id(helper->ctx, guid, FU_QUIRKS_NAME);
+	if (tmp == NULL) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_NOT_FOUND,
+			    "no quirk for %s",
+			    instance_id);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_firmware_parse_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	g_autoptr(FuFirmware) firmware = g_object_new(helper->gtype, NULL);
+	return fu_firmware_parse(firmware, helper->blob, FWUPD_INSTALL_FLAG_NO_SEARCH, error);
+}
+
+static gboolean
+fu_benchmark_checksums(FuBenchmark *benchmark, GError **error)
+{
+	g_autoptr(FuBenchmarkHelper) helper = g_new0(FuBenchmarkHelper, 1);
+	struct {
+		const gchar *name;
+		FuBenchmarkFunc func;
+	} map[] = {{"crc8", fu_benchmark_crc8_cb},
+		   {"crc16", fu_benchmark_crc16_cb},
+		   {"crc32", fu_benchmark_crc32_cb},
+		   {"sum8", fu_benchmark_sum8_cb},
+		   {"sum16", fu_benchmark_sum16_cb},
+		   {"sum32w", fu_benchmark_sum32w_cb},
+		   {"chunks", fu_benchmark_chunks_cb},
+		   {NULL, NULL}};
+
+	helper->blob = fu_benchmark_blob_new(4 * 1024 * 1024);
+	for (guint i = 0; map[i].name != NULL; i++) {
+		g_autofree gchar *name = g_strdup_printf("%s:4MiB", map[i].name);
+		if (!fu_benchmark_run(benchmark, name, 20, map[i].func, helper, error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_quirks(FuBenchmark *benchmark, GError **error)
+{
+	g_autofree gchar *fn = NULL;
+	g_autofree gchar *localstatedir = NULL;
+	g_autofree gchar *tmpdir = NULL;
+	g_autoptr(FuBenchmarkHelper) helper = g_new0(FuBenchmarkHelper, 1);
+	g_autoptr(GString) str = g_string_new(NULL);
+
+	/* synthetic quirk file with one group per device */
+	tmpdir = g_dir_make_tmp("fwupd-benchmark-XXXXXX", error);
+	if (tmpdir == NULL)
+		return FALSE;
+	for (guint i = 0; i < FU_BENCHMARK_QUIRK_COUNT; i++) {
+		g_string_append_printf(str, "[USB\\VID_273F&PID_%04X]\n", i);
+		g_string_append_printf(str, "Name = Device %u\n", i);
+		g_string_append(str, "Flags = is-bootloader,no-probe\n\n");
+	}
+	fn = g_build_filename(tmpdir, "benchmark.quirk", NULL);
+	if (!g_file_set_contents(fn, str->str, str->len, error))
+		return FALSE;
+	localstatedir = g_build_filename(tmpdir, "empty", NULL);
+	g_setenv("FWUPD_DATADIR_QUIRKS", tmpdir, TRUE);
+	g_setenv("FWUPD_LOCALSTATEDIR_QUIRKS", localstatedir, TRUE);
+
+	helper->ctx = fu_context_new();
+	if (!fu_context_load_quirks(helper->ctx,
+				    FU_QUIRKS_LOAD_FLAG_NO_CACHE | FU_QUIRKS_LOAD_FLAG_NO_VERIFY,
+				    error))
+		return FALSE;
+	if (!fu_benchmark_run(benchmark,
+			      "quirks:lookup",
+			      10000,
+			      fu_benchmark_quirks_cb,
+			      helper,
+			      error))
+		return FALSE;
+
+	/* clean up */
+	g_unsetenv("FWUPD_DATADIR_QUIRKS");
+	g_unsetenv("FWUPD_LOCALSTATEDIR_QUIRKS");
+	return fu_common_rmtree(tmpdir, error);
+}
+
+static gboolean
+fu_benchmark_firmware(FuBenchmark *benchmark, GError **error)
+{
+	GType gtypes[] = {FU_TYPE_FIRMWARE,
+			  FU_TYPE_ARCHIVE_FIRMWARE,
+			  FU_TYPE_CFU_OFFER,
+			  FU_TYPE_CFU_PAYLOAD,
+			  FU_TYPE_COSWID_FIRMWARE,
+			  FU_TYPE_DFU_FIRMWARE,
+			  FU_TYPE_DFUSE_FIRMWARE,
+			  FU_TYPE_EFI_FIRMWARE_FILE,
+			  FU_TYPE_EFI_FIRMWARE_FILESYSTEM,
+			  FU_TYPE_EFI_FIRMWARE_SECTION,
+			  FU_TYPE_EFI_FIRMWARE_VOLUME,
+			  FU_TYPE_FMAP_FIRMWARE,
+			  FU_TYPE_IFD_BIOS,
+			  FU_TYPE_IFD_FIRMWARE,
+			  FU_TYPE_IHEX_FIRMWARE,
+			  FU_TYPE_SFDP_FIRMWARE,
+			  FU_TYPE_SMBIOS,
+			  FU_TYPE_SREC_FIRMWARE,
+			  FU_TYPE_USWID_FIRMWARE,
+			  G_TYPE_INVALID};
+	g_autoptr(GBytes) payload = fu_benchmark_blob_new(1024 * 1024);
+
+	for (guint i = 0; gtypes[i] != G_TYPE_INVALID; i++) {
+		const gchar *gtype_name = g_type_name(gtypes[i]);
+		g_autofree gchar *name = g_strdup_printf("firmware-parse:%s", gtype_name);
+		g_autoptr(FuBenchmarkHelper) helper = g_new0(FuBenchmarkHelper, 1);
+		g_autoptr(FuFirmware) firmware = g_object_new(gtypes[i], NULL);
+		g_autoptr(FuFirmware) firmware_tmp = g_object_new(gtypes[i], NULL);
+		g_autoptr(GError) error_local = NULL;
+
+		/* build a large image in the native format, where the type can write one */
+		fu_firmware_set_bytes(firmware, payload);
+		helper->gtype = gtypes[i];
+		helper->blob = fu_firmware_write(firmware, &error_local);
+		if (helper->blob == NULL) {
+			g_debug("skipping %s: %s", gtype_name, error_local->message);
+			continue;
+		}
+		if (!fu_firmware_parse(firmware_tmp,
+				       helper->blob,
+				       FWUPD_INSTALL_FLAG_NO_SEARCH,
+				       &error_local)) {
+			g_debug("skipping %s: %s", gtype_name, error_local->message);
+			continue;
+		}
+		if (!fu_benchmark_run(benchmark,
+				      name,
+				      10,
+				      fu_benchmark_firmware_parse_cb,
+				      helper,
+				      error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+int
+main(int argc, char **argv)
+{
+	g_autoptr(FuBenchmark) benchmark = fu_benchmark_new("libfwupdplugin");
+	g_autoptr(GError) error = NULL;
+
+	/* only critical and error are fatal */
+	g_log_set_fatal_mask(NULL, G_LOG_LEVEL_ERROR | G_LOG_LEVEL_CRITICAL);
+
+	if (!fu_benchmark_checksums(benchmark, &error) ||
+	    !fu_benchmark_quirks(benchmark, &error) ||
+	    !fu_benchmark_firmware(benchmark, &error) ||
+	    !fu_benchmark_save(benchmark, &error)) {
+		g_printerr("%s\n", error->message);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -371,6 +371,7 @@ GByteArray *
 fu_bluez_device_read(FuBluezDevice *self, const gchar *uuid, GError **error)
 {
 	FuBluezDeviceUuidHelper *uuid_helper;
+	gint64 start;
 	guint8 byte;
 	g_autoptr(GByteArray) buf = g_byte_array_new();
 	g_autoptr(GVariantBuilder) builder = NULL;
@@ -394,6 +395,7 @@ fu_bluez_device_read(FuBluezDevice *self, const gchar *uuid, GError **error)
 	builder = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
 	g_variant_builder_add(builder, "{sv}", "offset", g_variant_new("q", 0));
 
+	start = g_get_monotonic_time();
 	val = g_dbus_proxy_call_sync(uuid_helper->proxy,
 				     "ReadValue",
 				     g_variant_new("(a{sv})", builder),
@@ -408,6 +410,10 @@ fu_bluez_device_read(FuBluezDevice *self, const gchar *uuid, GError **error)
 	g_variant_get(val, "(ay)", &iter);
 	while (g_variant_iter_loop(iter, "y", &byte))
 		g_byte_array_append(buf, &byte, 1);
+	fu_device_add_io_stats(FU_DEVICE(self),
+			       "BluezRead",
+			       buf->len,
+			       g_get_monotonic_time() - start);
 
 	/* success */
 	return g_steal_pointer(&buf);
@@ -451,6 +457,7 @@ gboolean
 fu_bluez_device_write(FuBluezDevice *self, const gchar *uuid, GByteArray *buf, GError **error)
 {
 	FuBluezDeviceUuidHelper *uuid_helper;
+	gint64 start;
 	g_autoptr(GVariantBuilder) opt_builder = NULL;
 	g_autoptr(GVariantBuilder) val_builder = NULL;
 	g_autoptr(GVariant) ret = NULL;
@@ -474,6 +481,7 @@ fu_bluez_device_write(FuBluezDevice *self, const gchar *uuid, GByteArray *buf, G
 	g_variant_builder_add(opt_builder, "{sv}", "offset", g_variant_new_uint16(0));
 	opt_variant = g_variant_new("a{sv}", opt_builder);
 
+	start = g_get_monotonic_time();
 	ret = g_dbus_proxy_call_sync(uuid_helper->proxy,
 				     "WriteValue",
 				     g_variant_new("(@ay@a{sv})", val_variant, opt_variant),
@@ -485,6 +493,10 @@ fu_bluez_device_write(FuBluezDevice *self, const gchar *uuid, GByteArray *buf, G
 		g_prefix_error(error, "Failed to write GattCharacteristic1: ");
 		return FALSE;
 	}
+	fu_device_add_io_stats(FU_DEVICE(self),
+			       "BluezWrite",
+			       buf->len,
+			       g_get_monotonic_time() - start);
 
 	/* success */
 	return TRUE;
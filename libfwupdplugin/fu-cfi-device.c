@@ -8,7 +8,11 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include "fu-cfi-device.h"
+#include "fu-common.h"
+#include "fu-sfdp-firmware.h"
 
 /**
  * FuCfiDevice:
@@ -23,6 +27,11 @@
  * * `SectorSize`: 0x1000
  * * `BlockSize`: 0x10000
  *
+ * If the subclass implements `->send_command()` then the JEDEC SFDP table is read in ->setup() and
+ * used to set the flash size, page size, erase commands and address size. The 4-byte address
+ * commands are only used when the chip advertises them. Any quirk values override the values
+ * from the SFDP table, although a 4-byte address size with a 3-byte command is refused.
+ *
  * See also: [class@FuDevice]
  */
 
@@ -32,6 +41,8 @@ typedef struct {
 	guint32 page_size;
 	guint32 sector_size;
 	guint32 block_size;
+	guint8 address_size;
+	gboolean address_4byte_only;
 	FuCfiDeviceCmd cmds[FU_CFI_DEVICE_CMD_LAST];
 } FuCfiDevicePrivate;
 
@@ -43,6 +54,7 @@ enum { PROP_0, PROP_FLASH_ID, PROP_LAST };
 #define FU_CFI_DEVICE_PAGE_SIZE_DEFAULT	  0x100
 #define FU_CFI_DEVICE_SECTOR_SIZE_DEFAULT 0x1000
 #define FU_CFI_DEVICE_BLOCK_SIZE_DEFAULT  0x10000
+#define FU_CFI_DEVICE_SFDP_SIZE_MAX	  0x1000
 
 static const gchar *
 fu_cfi_device_cmd_to_string(FuCfiDeviceCmd cmd)
@@ -65,6 +77,8 @@ fu_cfi_device_cmd_to_string(FuCfiDeviceCmd cmd)
 		return "WriteStatus";
 	if (cmd == FU_CFI_DEVICE_CMD_BLOCK_ERASE)
 		return "BlockErase";
+	if (cmd == FU_CFI_DEVICE_CMD_READ_SFDP)
+		return "ReadSfdp";
 	return NULL;
 }
 
@@ -179,6 +193,170 @@ fu_cfi_device_finalize(GObject *object)
 	G_OBJECT_CLASS(fu_cfi_device_parent_class)->finalize(object);
 }
 
+static gboolean
+fu_cfi_device_read_sfdp(FuCfiDevice *self, guint8 *buf, gsize bufsz, GError **error)
+{
+	FuCfiDevicePrivate *priv = GET_PRIVATE(self);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+
+	/* cmd, then 24 bit address, then one dummy byte */
+	guint8 wbuf[5] = {priv->cmds[FU_CFI_DEVICE_CMD_READ_SFDP], 0x0, 0x0, 0x0, 0x0};
+	return fu_cfi_device_send_command(self, wbuf, sizeof(wbuf), buf, bufsz, progress, error);
+}
+
+/* the read, program and erase commands that take a 24 bit address */
+static gboolean
+fu_cfi_device_cmd_is_3byte(guint8 cmd)
+{
+	return cmd == 0x03 || cmd == 0x02 || cmd == 0x20 || cmd == 0x52 || cmd == 0xD8;
+}
+
+static FuFirmware *
+fu_cfi_device_read_sfdp_table(FuCfiDevice *self, GError **error)
+{
+	gsize bufsz = 0;
+	guint8 buf[8] = {0x0};
+	guint8 nph;
+	g_autofree guint8 *hdrs = NULL;
+	g_autofree guint8 *tbl = NULL;
+	g_autoptr(FuFirmware) firmware = fu_sfdp_firmware_new();
+	g_autoptr(GBytes) blob = NULL;
+
+	/* header, to get the number of parameter headers */
+	if (!fu_cfi_device_read_sfdp(self, buf, sizeof(buf), error))
+		return NULL;
+	if (memcmp(buf, "SFDP", 4) != 0) {
+		g_set_error_literal(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_NOT_SUPPORTED,
+				    "no SFDP signature");
+		return NULL;
+	}
+	nph = buf[6] + 1;
+
+	/* find the end of the last parameter table */
+	hdrs = g_malloc0(sizeof(buf) + nph * 8);
+	if (!fu_cfi_device_read_sfdp(self, hdrs, sizeof(buf) + nph * 8, error))
+		return NULL;
+	for (guint i = 0; i < nph; i++) {
+		const guint8 *hdr = hdrs + sizeof(buf) + i * 8;
+		gsize ptr = fu_common_read_uint32(hdr + 4, G_LITTLE_ENDIAN) & 0xFFFFFF;
+		bufsz = MAX(bufsz, ptr + (gsize)hdr[3] * sizeof(guint32));
+	}
+	if (bufsz > FU_CFI_DEVICE_SFDP_SIZE_MAX) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_INVALID_DATA,
+			    "SFDP table too large, got 0x%x",
+			    (guint)bufsz);
+		return NULL;
+	}
+
+	/* read and parse everything */
+	tbl = g_malloc0(bufsz);
+	if (!fu_cfi_device_read_sfdp(self, tbl, bufsz, error))
+		return NULL;
+	blob = g_bytes_new_take(g_steal_pointer(&tbl), bufsz);
+	if (!fu_firmware_parse(firmware, blob, FWUPD_INSTALL_FLAG_NONE, error))
+		return NULL;
+	return g_steal_pointer(&firmware);
+}
+
+static gboolean
+fu_cfi_device_apply_sfdp(FuCfiDevice *self, FuSfdpFirmware *sfdp, GError **error)
+{
+	FuCfiDevicePrivate *priv = GET_PRIVATE(self);
+	guint32 page_size = priv->page_size;
+	guint32 sector_size = priv->sector_size;
+	guint32 block_size = priv->block_size;
+	guint8 address_size = priv->address_size;
+	FuCfiDeviceCmd cmds[FU_CFI_DEVICE_CMD_LAST];
+
+	/* geometry */
+	memcpy(cmds, priv->cmds, sizeof(cmds));
+	if (fu_sfdp_firmware_get_page_size(sfdp) > 0)
+		page_size = fu_sfdp_firmware_get_page_size(sfdp);
+	if (fu_sfdp_firmware_get_sector_size(sfdp) > 0) {
+		sector_size = fu_sfdp_firmware_get_sector_size(sfdp);
+		cmds[FU_CFI_DEVICE_CMD_SECTOR_ERASE] = fu_sfdp_firmware_get_sector_erase_cmd(sfdp);
+	}
+	if (fu_sfdp_firmware_get_block_size(sfdp) > 0) {
+		block_size = fu_sfdp_firmware_get_block_size(sfdp);
+		cmds[FU_CFI_DEVICE_CMD_BLOCK_ERASE] = fu_sfdp_firmware_get_block_erase_cmd(sfdp);
+	}
+
+	/* use the 32 bit address commands to reach above 16MiB, but only if advertised */
+	if (fu_sfdp_firmware_get_address_size(sfdp) != 0)
+		address_size = fu_sfdp_firmware_get_address_size(sfdp);
+	if (address_size == 4 && !fu_sfdp_firmware_get_address_4byte_only(sfdp)) {
+		struct {
+			FuCfiDeviceCmd cmd;
+			guint8 value;
+		} map[] = {
+		    {FU_CFI_DEVICE_CMD_READ_DATA, fu_sfdp_firmware_get_read_4byte_cmd(sfdp)},
+		    {FU_CFI_DEVICE_CMD_PAGE_PROG, fu_sfdp_firmware_get_page_prog_4byte_cmd(sfdp)},
+		    {FU_CFI_DEVICE_CMD_SECTOR_ERASE,
+		     fu_sfdp_firmware_get_sector_erase_4byte_cmd(sfdp)},
+		    {FU_CFI_DEVICE_CMD_BLOCK_ERASE,
+		     fu_sfdp_firmware_get_block_erase_4byte_cmd(sfdp)},
+		};
+		for (guint i = 0; i < G_N_ELEMENTS(map); i++) {
+			if (cmds[map[i].cmd] == 0x0)
+				continue;
+			if (map[i].value == 0x0) {
+				g_set_error(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_NOT_SUPPORTED,
+					    "SFDP requires 4 byte addressing but no 32 bit "
+					    "address version of %s 0x%02x is advertised",
+					    fu_cfi_device_cmd_to_string(map[i].cmd),
+					    cmds[map[i].cmd]);
+				return FALSE;
+			}
+			cmds[map[i].cmd] = map[i].value;
+		}
+	}
+
+	/* only commit the values now everything is valid */
+	if (fu_sfdp_firmware_get_flash_size(sfdp) > 0)
+		fu_cfi_device_set_size(self, fu_sfdp_firmware_get_flash_size(sfdp));
+	priv->page_size = page_size;
+	priv->sector_size = sector_size;
+	priv->block_size = block_size;
+	priv->address_size = address_size;
+	priv->address_4byte_only = fu_sfdp_firmware_get_address_4byte_only(sfdp);
+	memcpy(priv->cmds, cmds, sizeof(cmds));
+
+	/* success */
+	return TRUE;
+}
+
+/* a quirk may have set the address size or a command that does not match the other */
+static gboolean
+fu_cfi_device_ensure_address_size(FuCfiDevice *self, GError **error)
+{
+	FuCfiDevicePrivate *priv = GET_PRIVATE(self);
+	FuCfiDeviceCmd cmds[] = {FU_CFI_DEVICE_CMD_READ_DATA,
+				 FU_CFI_DEVICE_CMD_PAGE_PROG,
+				 FU_CFI_DEVICE_CMD_SECTOR_ERASE,
+				 FU_CFI_DEVICE_CMD_BLOCK_ERASE};
+
+	if (priv->address_size != 4 || priv->address_4byte_only)
+		return TRUE;
+	for (guint i = 0; i < G_N_ELEMENTS(cmds); i++) {
+		if (fu_cfi_device_cmd_is_3byte(priv->cmds[cmds[i]])) {
+			g_set_error(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_NOT_SUPPORTED,
+				    "4 byte address size is inconsistent with %s 0x%02x",
+				    fu_cfi_device_cmd_to_string(cmds[i]),
+				    priv->cmds[cmds[i]]);
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
 static gboolean
 fu_cfi_device_setup(FuDevice *device, GError **error)
 {
@@ -197,6 +375,17 @@ fu_cfi_device_setup(FuDevice *device, GError **error)
 		return FALSE;
 	}
 
+	/* the quirks added below override anything from SFDP */
+	if (FU_CFI_DEVICE_GET_CLASS(self)->send_command != NULL) {
+		g_autoptr(GError) error_local = NULL;
+		g_autoptr(FuFirmware) sfdp = fu_cfi_device_read_sfdp_table(self, &error_local);
+		if (sfdp == NULL) {
+			g_debug("no SFDP table: %s", error_local->message);
+		} else if (!fu_cfi_device_apply_sfdp(self, FU_SFDP_FIRMWARE(sfdp), error)) {
+			return FALSE;
+		}
+	}
+
 	/* typically this will add quirk strings of 2, 4, then 6 bytes */
 	for (guint i = 0; i < flash_idsz; i += 2) {
 		g_autofree gchar *flash_id = g_strndup(priv->flash_id, i + 2);
@@ -204,6 +393,8 @@ fu_cfi_device_setup(FuDevice *device, GError **error)
 		if (!fu_device_build_instance_id_quirk(device, error, "CFI", "FLASHID", NULL))
 			return FALSE;
 	}
+	if (!fu_cfi_device_ensure_address_size(self, error))
+		return FALSE;
 
 	/* success */
 	return TRUE;
@@ -358,6 +549,26 @@ fu_cfi_device_set_sector_size(FuCfiDevice *self, guint32 sector_size)
 	priv->sector_size = sector_size;
 }
 
+/**
+ * fu_cfi_device_get_address_size:
+ * @self: a #FuCfiDevice
+ *
+ * Gets the number of address bytes sent with the read, program and erase commands.
+ *
+ * This is typically set from the SFDP table, or with the `CfiDeviceAddressSize` quirk key.
+ *
+ * Returns: 3 or 4
+ *
+ * Since: 1.8.0
+ **/
+guint8
+fu_cfi_device_get_address_size(FuCfiDevice *self)
+{
+	FuCfiDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_CFI_DEVICE(self), G_MAXUINT8);
+	return priv->address_size;
+}
+
 static gboolean
 fu_cfi_device_set_quirk_kv(FuDevice *device, const gchar *key, const gchar *value, GError **error)
 {
@@ -425,6 +636,18 @@ fu_cfi_device_set_quirk_kv(FuDevice *device, const gchar *key, const gchar *valu
 		priv->cmds[FU_CFI_DEVICE_CMD_WRITE_EN] = tmp;
 		return TRUE;
 	}
+	if (g_strcmp0(key, "CfiDeviceCmdReadSfdp") == 0) {
+		if (!fu_common_strtoull_full(value, &tmp, 0, G_MAXUINT8, error))
+			return FALSE;
+		priv->cmds[FU_CFI_DEVICE_CMD_READ_SFDP] = tmp;
+		return TRUE;
+	}
+	if (g_strcmp0(key, "CfiDeviceAddressSize") == 0) {
+		if (!fu_common_strtoull_full(value, &tmp, 3, 4, error))
+			return FALSE;
+		priv->address_size = tmp;
+		return TRUE;
+	}
 	if (g_strcmp0(key, "CfiDevicePageSize") == 0) {
 		if (!fu_common_strtoull_full(value, &tmp, 0, G_MAXUINT32, error))
 			return FALSE;
@@ -465,6 +688,7 @@ fu_cfi_device_to_string(FuDevice *device, guint idt, GString *str)
 		fu_common_string_append_kx(str, idt, "SectorSize", priv->sector_size);
 	if (priv->block_size > 0)
 		fu_common_string_append_kx(str, idt, "BlockSize", priv->block_size);
+	fu_common_string_append_ku(str, idt, "AddressSize", priv->address_size);
 }
 
 /**
@@ -492,6 +716,42 @@ fu_cfi_device_chip_select(FuCfiDevice *self, gboolean value, GError **error)
 	return klass->chip_select(self, value, error);
 }
 
+/**
+ * fu_cfi_device_send_command:
+ * @self: a #FuCfiDevice
+ * @wbuf: buffer to send
+ * @wbufsz: size of @wbuf
+ * @rbuf: (nullable): buffer to receive
+ * @rbufsz: size of @rbuf
+ * @progress: a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Sends @wbuf to the chip and then reads @rbufsz bytes back, all with the chip selected.
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fu_cfi_device_send_command(FuCfiDevice *self,
+			   const guint8 *wbuf,
+			   gsize wbufsz,
+			   guint8 *rbuf,
+			   gsize rbufsz,
+			   FuProgress *progress,
+			   GError **error)
+{
+	FuCfiDeviceClass *klass = FU_CFI_DEVICE_GET_CLASS(self);
+	g_return_val_if_fail(FU_IS_CFI_DEVICE(self), FALSE);
+	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	if (klass->send_command == NULL) {
+		g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "not supported");
+		return FALSE;
+	}
+	return klass->send_command(self, wbuf, wbufsz, rbuf, rbufsz, progress, error);
+}
+
 static gboolean
 fu_cfi_device_chip_select_assert(GObject *device, GError **error)
 {
@@ -525,6 +785,395 @@ fu_cfi_device_chip_select_locker_new(FuCfiDevice *self, GError **error)
 					 error);
 }
 
+typedef struct {
+	guint8 *buf_old;
+	guint8 *buf_new;
+	guint32 addr_start;
+	guint32 sector_size;
+	guint sectors_total;
+	gboolean *sectors_dirty;
+	gboolean *sectors_erase;
+} FuCfiDeviceDiffHelper;
+
+static gboolean
+fu_cfi_device_write_diff_erase(FuCfiDevice *self,
+			       FuDevice *device,
+			       const FuCfiDeviceFuncs *funcs,
+			       FuCfiDeviceDiffHelper *helper,
+			       FuProgress *progress,
+			       GError **error)
+{
+	FuCfiDevicePrivate *priv = GET_PRIVATE(self);
+	gboolean use_block = funcs->erase_block != NULL && priv->block_size > helper->sector_size &&
+			     priv->block_size % helper->sector_size == 0;
+	guint sectors_per_block = use_block ? priv->block_size / helper->sector_size : 1;
+	guint sectors_done = 0;
+	guint sectors_erase = 0;
+
+	for (guint i = 0; i < helper->sectors_total; i++) {
+		if (helper->sectors_erase[i])
+			sectors_erase++;
+	}
+	for (guint i = 0; i < helper->sectors_total; i++) {
+		guint32 addr = helper->addr_start + i * helper->sector_size;
+
+		/* use one block erase if every sector in the block needs erasing */
+		if (use_block && addr % priv->block_size == 0 &&
+		    i + sectors_per_block <= helper->sectors_total) {
+			gboolean erase_all = TRUE;
+			for (guint j = i; j < i + sectors_per_block; j++) {
+				if (!helper->sectors_erase[j]) {
+					erase_all = FALSE;
+					break;
+				}
+			}
+			if (erase_all) {
+				g_autoptr(GError) error_local = NULL;
+				if (funcs->erase_block(device, addr, &error_local)) {
+					i += sectors_per_block - 1;
+					sectors_done += sectors_per_block;
+					fu_progress_set_percentage_full(progress,
+									sectors_done,
+									sectors_erase);
+					continue;
+				}
+				if (!g_error_matches(error_local,
+						     G_IO_ERROR,
+						     G_IO_ERROR_NOT_SUPPORTED)) {
+					g_propagate_prefixed_error(error,
+								   g_steal_pointer(&error_local),
+								   "failed to erase block @0x%x: ",
+								   addr);
+					return FALSE;
+				}
+				g_debug("falling back to sector erase: %s", error_local->message);
+				use_block = FALSE;
+			}
+		}
+
+		/* erase sector */
+		if (!helper->sectors_erase[i])
+			continue;
+		if (!funcs->erase_sector(device, addr, error)) {
+			g_prefix_error(error, "failed to erase sector @0x%x: ", addr);
+			return FALSE;
+		}
+		fu_progress_set_percentage_full(progress, ++sectors_done, sectors_erase);
+	}
+
+	/* success */
+	return TRUE;
+}
+
+/* an erased sector that should be blank does not need programming */
+static gboolean
+fu_cfi_device_write_diff_is_blank(FuCfiDeviceDiffHelper *helper, guint idx)
+{
+	const guint8 *buf = helper->buf_new + (gsize)idx * helper->sector_size;
+	if (!helper->sectors_erase[idx])
+		return FALSE;
+	for (guint32 i = 0; i < helper->sector_size; i++) {
+		if (buf[i] != 0xFF)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_cfi_device_write_diff_write(FuDevice *device,
+			       const FuCfiDeviceFuncs *funcs,
+			       FuCfiDeviceDiffHelper *helper,
+			       guint sectors_dirty,
+			       FuProgress *progress,
+			       GError **error)
+{
+	guint idx_first = G_MAXUINT;
+
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, sectors_dirty);
+
+	/* the lowest changed sector is written last so that any header is only valid once the
+	 * rest of the image is in place */
+	for (guint i = 0; i < helper->sectors_total; i++) {
+		guint32 offset = i * helper->sector_size;
+		if (!helper->sectors_dirty[i])
+			continue;
+		if (fu_cfi_device_write_diff_is_blank(helper, i)) {
+			fu_progress_step_done(progress);
+			continue;
+		}
+		if (idx_first == G_MAXUINT) {
+			idx_first = i;
+			continue;
+		}
+		if (!funcs->write(device,
+				  helper->addr_start + offset,
+				  helper->buf_new + offset,
+				  helper->sector_size,
+				  fu_progress_get_child(progress),
+				  error)) {
+			g_prefix_error(error,
+				       "failed to write sector @0x%x: ",
+				       helper->addr_start + offset);
+			return FALSE;
+		}
+		fu_progress_step_done(progress);
+	}
+	if (idx_first != G_MAXUINT) {
+		guint32 offset = idx_first * helper->sector_size;
+		if (!funcs->write(device,
+				  helper->addr_start + offset,
+				  helper->buf_new + offset,
+				  helper->sector_size,
+				  fu_progress_get_child(progress),
+				  error)) {
+			g_prefix_error(error,
+				       "failed to write sector @0x%x: ",
+				       helper->addr_start + offset);
+			return FALSE;
+		}
+		fu_progress_step_done(progress);
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static gboolean
+fu_cfi_device_write_diff_verify(FuDevice *device,
+				const FuCfiDeviceFuncs *funcs,
+				FuCfiDeviceDiffHelper *helper,
+				FuProgress *progress,
+				GError **error)
+{
+	g_autoptr(GArray) runs = g_array_new(FALSE, FALSE, sizeof(guint));
+
+	/* read back each run of contiguous changed sectors in one go */
+	for (guint i = 0; i < helper->sectors_total; i++) {
+		if (helper->sectors_dirty[i] && (i == 0 || !helper->sectors_dirty[i - 1]))
+			g_array_append_val(runs, i);
+	}
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, runs->len);
+	for (guint i = 0; i < runs->len; i++) {
+		guint idx = g_array_index(runs, guint, i);
+		guint idx_end = idx;
+		guint32 offset = idx * helper->sector_size;
+		gsize bufsz;
+
+		while (idx_end < helper->sectors_total && helper->sectors_dirty[idx_end])
+			idx_end++;
+		bufsz = (idx_end - idx) * helper->sector_size;
+		if (!funcs->read(device,
+				 helper->addr_start + offset,
+				 helper->buf_old + offset,
+				 bufsz,
+				 fu_progress_get_child(progress),
+				 error)) {
+			g_prefix_error(error,
+				       "failed to read @0x%x: ",
+				       helper->addr_start + offset);
+			return FALSE;
+		}
+		if (!fu_common_bytes_compare_raw(helper->buf_old + offset,
+						 bufsz,
+						 helper->buf_new + offset,
+						 bufsz,
+						 error)) {
+			g_prefix_error(error,
+				       "failed to verify @0x%x: ",
+				       helper->addr_start + offset);
+			return FALSE;
+		}
+		fu_progress_step_done(progress);
+	}
+
+	/* success */
+	return TRUE;
+}
+
+/**
+ * fu_cfi_device_write_diff:
+ * @self: a #FuCfiDevice
+ * @device: the #FuDevice passed to the @funcs
+ * @funcs: the low level flash operations
+ * @address: flash address to write @fw to
+ * @fw: data to write
+ * @progress: a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Writes @fw to the flash chip, only erasing and programming the sectors that have changed.
+ *
+ * Each sector covered by @fw is read first, and sectors that already hold the new data are
+ * skipped. Sectors that can be programmed without clearing any bits are not erased, and if
+ * every sector of a block needs erasing then a single block erase is used instead. Sectors that
+ * are only being blanked are erased but not programmed. Only the sectors that changed are read
+ * back to be verified. Any data before or after @fw in the
+ * first and last sector is preserved.
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fu_cfi_device_write_diff(FuCfiDevice *self,
+			 FuDevice *device,
+			 const FuCfiDeviceFuncs *funcs,
+			 guint32 address,
+			 GBytes *fw,
+			 FuProgress *progress,
+			 GError **error)
+{
+	FuCfiDevicePrivate *priv = GET_PRIVATE(self);
+	FuCfiDeviceDiffHelper helper = {.sector_size = priv->sector_size};
+	guint64 size = fu_cfi_device_get_size(self);
+	gsize bufsz;
+	gsize fwsz = 0;
+	const guint8 *fwbuf;
+	guint sectors_dirty = 0;
+	guint sectors_erase = 0;
+	g_autofree guint8 *buf_old = NULL;
+	g_autofree guint8 *buf_new = NULL;
+	g_autofree gboolean *dirty = NULL;
+	g_autofree gboolean *erase = NULL;
+
+	g_return_val_if_fail(FU_IS_CFI_DEVICE(self), FALSE);
+	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
+	g_return_val_if_fail(funcs != NULL, FALSE);
+	g_return_val_if_fail(fw != NULL, FALSE);
+	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* sanity check */
+	if (priv->sector_size == 0) {
+		g_set_error_literal(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_NOT_SUPPORTED,
+				    "sector size not set");
+		return FALSE;
+	}
+	fwbuf = g_bytes_get_data(fw, &fwsz);
+	if (fwsz == 0) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "no data to write");
+		return FALSE;
+	}
+
+	/* work on whole sectors */
+	helper.addr_start = address - (address % priv->sector_size);
+	bufsz = address + fwsz - helper.addr_start;
+	if (bufsz % priv->sector_size != 0)
+		bufsz += priv->sector_size - (bufsz % priv->sector_size);
+	if (size > 0 && helper.addr_start + bufsz > size) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_INVALID_DATA,
+			    "0x%x bytes @0x%x is larger than flash size 0x%x",
+			    (guint)fwsz,
+			    address,
+			    (guint)size);
+		return FALSE;
+	}
+	helper.sectors_total = bufsz / priv->sector_size;
+
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_GUESSED);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_READ, 20);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 30);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 40);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_VERIFY, 10);
+
+	/* read the existing contents */
+	buf_old = g_malloc0(bufsz);
+	if (!funcs->read(device,
+			 helper.addr_start,
+			 buf_old,
+			 bufsz,
+			 fu_progress_get_child(progress),
+			 error)) {
+		g_prefix_error(error, "failed to read @0x%x: ", helper.addr_start);
+		return FALSE;
+	}
+	fu_progress_step_done(progress);
+
+	/* merge in the new data */
+	buf_new = fu_memdup_safe(buf_old, bufsz, error);
+	if (buf_new == NULL)
+		return FALSE;
+	if (!fu_memcpy_safe(buf_new,
+			    bufsz,
+			    address - helper.addr_start, /* dst */
+			    fwbuf,
+			    fwsz,
+			    0x0, /* src */
+			    fwsz,
+			    error))
+		return FALSE;
+
+	/* find the sectors that changed, and if any bits need to go from 0 to 1 */
+	dirty = g_new0(gboolean, helper.sectors_total);
+	erase = g_new0(gboolean, helper.sectors_total);
+	for (guint i = 0; i < helper.sectors_total; i++) {
+		gsize offset = (gsize)i * priv->sector_size;
+		if (memcmp(buf_old + offset, buf_new + offset, priv->sector_size) == 0)
+			continue;
+		dirty[i] = TRUE;
+		sectors_dirty++;
+		for (gsize j = offset; j < offset + priv->sector_size; j++) {
+			if ((buf_old[j] & buf_new[j]) != buf_new[j]) {
+				erase[i] = TRUE;
+				sectors_erase++;
+				break;
+			}
+		}
+	}
+	g_debug("%u of %u sectors changed, %u need erasing",
+		sectors_dirty,
+		helper.sectors_total,
+		sectors_erase);
+	if (sectors_dirty == 0) {
+		fu_progress_finished(progress);
+		return TRUE;
+	}
+	helper.buf_old = buf_old;
+	helper.buf_new = buf_new;
+	helper.sectors_dirty = dirty;
+	helper.sectors_erase = erase;
+
+	/* erase */
+	if (!fu_cfi_device_write_diff_erase(self,
+					    device,
+					    funcs,
+					    &helper,
+					    fu_progress_get_child(progress),
+					    error))
+		return FALSE;
+	fu_progress_step_done(progress);
+
+	/* write */
+	if (!fu_cfi_device_write_diff_write(device,
+					    funcs,
+					    &helper,
+					    sectors_dirty,
+					    fu_progress_get_child(progress),
+					    error))
+		return FALSE;
+	fu_progress_step_done(progress);
+
+	/* verify */
+	if (!fu_cfi_device_write_diff_verify(device,
+					     funcs,
+					     &helper,
+					     fu_progress_get_child(progress),
+					     error))
+		return FALSE;
+	fu_progress_step_done(progress);
+
+	/* success */
+	return TRUE;
+}
+
 static void
 fu_cfi_device_init(FuCfiDevice *self)
 {
@@ -532,6 +1181,7 @@ fu_cfi_device_init(FuCfiDevice *self)
 	priv->page_size = FU_CFI_DEVICE_PAGE_SIZE_DEFAULT;
 	priv->sector_size = FU_CFI_DEVICE_SECTOR_SIZE_DEFAULT;
 	priv->block_size = FU_CFI_DEVICE_BLOCK_SIZE_DEFAULT;
+	priv->address_size = 3;
 	priv->cmds[FU_CFI_DEVICE_CMD_WRITE_STATUS] = 0x01;
 	priv->cmds[FU_CFI_DEVICE_CMD_PAGE_PROG] = 0x02;
 	priv->cmds[FU_CFI_DEVICE_CMD_READ_DATA] = 0x03;
@@ -539,6 +1189,7 @@ fu_cfi_device_init(FuCfiDevice *self)
 	priv->cmds[FU_CFI_DEVICE_CMD_WRITE_EN] = 0x06;
 	priv->cmds[FU_CFI_DEVICE_CMD_SECTOR_ERASE] = 0x20;
 	priv->cmds[FU_CFI_DEVICE_CMD_CHIP_ERASE] = 0x60;
+	priv->cmds[FU_CFI_DEVICE_CMD_READ_SFDP] = 0x5A;
 	priv->cmds[FU_CFI_DEVICE_CMD_READ_ID] = 0x9f;
 	fu_device_set_summary(FU_DEVICE(self), "CFI flash chip");
 }
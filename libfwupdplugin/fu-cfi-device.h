@@ -16,7 +16,14 @@ G_DECLARE_DERIVABLE_TYPE(FuCfiDevice, fu_cfi_device, FU, CFI_DEVICE, FuDevice)
 struct _FuCfiDeviceClass {
 	FuDeviceClass parent_class;
 	gboolean (*chip_select)(FuCfiDevice *self, gboolean value, GError **error);
-	gpointer __reserved[30];
+	gboolean (*send_command)(FuCfiDevice *self,
+				 const guint8 *wbuf,
+				 gsize wbufsz,
+				 guint8 *rbuf,
+				 gsize rbufsz,
+				 FuProgress *progress,
+				 GError **error);
+	gpointer __reserved[29];
 };
 
 /**
@@ -30,6 +37,7 @@ struct _FuCfiDeviceClass {
  * @FU_CFI_DEVICE_CMD_WRITE_EN:		Write enable
  * @FU_CFI_DEVICE_CMD_WRITE_STATUS:	Write status
  * @FU_CFI_DEVICE_CMD_BLOCK_ERASE:	Block erase
+ * @FU_CFI_DEVICE_CMD_READ_SFDP:	Read the JEDEC SFDP table
  *
  * Commands used when calling fu_cfi_device_get_cmd().
  **/
@@ -43,10 +51,79 @@ typedef enum {
 	FU_CFI_DEVICE_CMD_WRITE_EN,
 	FU_CFI_DEVICE_CMD_WRITE_STATUS,
 	FU_CFI_DEVICE_CMD_BLOCK_ERASE,
+	FU_CFI_DEVICE_CMD_READ_SFDP,
 	/*< private >*/
 	FU_CFI_DEVICE_CMD_LAST
 } FuCfiDeviceCmd;
 
+/**
+ * FuCfiDeviceReadFunc:
+ * @device: a #FuDevice
+ * @addr: flash address
+ * @buf: (out): buffer to fill
+ * @bufsz: size of @buf
+ * @progress: a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Reads a range of the flash chip.
+ *
+ * Returns: %TRUE on success
+ */
+typedef gboolean (*FuCfiDeviceReadFunc)(FuDevice *device,
+					guint32 addr,
+					guint8 *buf,
+					gsize bufsz,
+					FuProgress *progress,
+					GError **error);
+
+/**
+ * FuCfiDeviceWriteFunc:
+ * @device: a #FuDevice
+ * @addr: flash address
+ * @buf: data to program
+ * @bufsz: size of @buf
+ * @progress: a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Programs a range of the flash chip that has already been erased.
+ *
+ * Returns: %TRUE on success
+ */
+typedef gboolean (*FuCfiDeviceWriteFunc)(FuDevice *device,
+					 guint32 addr,
+					 const guint8 *buf,
+					 gsize bufsz,
+					 FuProgress *progress,
+					 GError **error);
+
+/**
+ * FuCfiDeviceEraseFunc:
+ * @device: a #FuDevice
+ * @addr: flash address, aligned to the erase size
+ * @error: (nullable): optional return location for an error
+ *
+ * Erases one sector or block of the flash chip.
+ *
+ * Returns: %TRUE on success
+ */
+typedef gboolean (*FuCfiDeviceEraseFunc)(FuDevice *device, guint32 addr, GError **error);
+
+/**
+ * FuCfiDeviceFuncs:
+ * @read:		Read a range of the flash
+ * @write:		Program an erased range of the flash
+ * @erase_sector:	Erase one sector
+ * @erase_block:	Erase one block, or %NULL if unsupported
+ *
+ * Low level flash operations used by fu_cfi_device_write_diff().
+ **/
+typedef struct {
+	FuCfiDeviceReadFunc read;
+	FuCfiDeviceWriteFunc write;
+	FuCfiDeviceEraseFunc erase_sector;
+	FuCfiDeviceEraseFunc erase_block;
+} FuCfiDeviceFuncs;
+
 FuCfiDevice *
 fu_cfi_device_new(FuContext *ctx, const gchar *flash_id);
 const gchar *
@@ -69,6 +146,8 @@ guint32
 fu_cfi_device_get_block_size(FuCfiDevice *self);
 void
 fu_cfi_device_set_block_size(FuCfiDevice *self, guint32 block_size);
+guint8
+fu_cfi_device_get_address_size(FuCfiDevice *self);
 gboolean
 fu_cfi_device_get_cmd(FuCfiDevice *self, FuCfiDeviceCmd cmd, guint8 *value, GError **error);
 
@@ -76,3 +155,19 @@ gboolean
 fu_cfi_device_chip_select(FuCfiDevice *self, gboolean value, GError **error);
 FuDeviceLocker *
 fu_cfi_device_chip_select_locker_new(FuCfiDevice *self, GError **error);
+gboolean
+fu_cfi_device_send_command(FuCfiDevice *self,
+			   const guint8 *wbuf,
+			   gsize wbufsz,
+			   guint8 *rbuf,
+			   gsize rbufsz,
+			   FuProgress *progress,
+			   GError **error) G_GNUC_WARN_UNUSED_RESULT;
+gboolean
+fu_cfi_device_write_diff(FuCfiDevice *self,
+			 FuDevice *device,
+			 const FuCfiDeviceFuncs *funcs,
+			 guint32 address,
+			 GBytes *fw,
+			 FuProgress *progress,
+			 GError **error) G_GNUC_WARN_UNUSED_RESULT;
@@ -32,9 +32,10 @@ typedef struct {
 	FuLidState lid_state;
 	guint battery_level;
 	guint battery_threshold;
+	FuContextFlags flags;
 } FuContextPrivate;
 
-enum { SIGNAL_SECURITY_CHANGED, SIGNAL_LAST };
+enum { SIGNAL_SECURITY_CHANGED, SIGNAL_SECURITY_CHANGED_FULL, SIGNAL_LAST };
 
 enum {
 	PROP_0,
@@ -486,6 +487,9 @@ fu_context_lookup_quirk_by_id_iter(FuContext *self,
  *
  * Informs the daemon that the HSI state may have changed.
  *
+ * All the security attributes are refreshed, so plugins should prefer
+ * fu_context_security_changed_full() where the cause of the change is known.
+ *
  * Since: 1.6.0
  **/
 void
@@ -495,6 +499,30 @@ fu_context_security_changed(FuContext *self)
 	g_signal_emit(self, signals[SIGNAL_SECURITY_CHANGED], 0);
 }
 
+/**
+ * fu_context_security_changed_full:
+ * @self: a #FuContext
+ * @plugin_name: (nullable): the plugin that added the attributes, e.g. `linux_swap`
+ *
+ * Informs the daemon that the HSI state may have changed for a specific plugin.
+ *
+ * Only the security attributes added by @plugin_name (or by devices it created) are
+ * refreshed using the #FuContext::security-changed-full signal, or all of them using
+ * #FuContext::security-changed if @plugin_name is %NULL.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_context_security_changed_full(FuContext *self, const gchar *plugin_name)
+{
+	g_return_if_fail(FU_IS_CONTEXT(self));
+	if (plugin_name == NULL) {
+		g_signal_emit(self, signals[SIGNAL_SECURITY_CHANGED], 0);
+		return;
+	}
+	g_signal_emit(self, signals[SIGNAL_SECURITY_CHANGED_FULL], 0, plugin_name);
+}
+
 /**
  * fu_context_load_hwinfo:
  * @self: a #FuContext
@@ -748,6 +776,59 @@ fu_context_set_battery_threshold(FuContext *self, guint battery_threshold)
 	g_object_notify(G_OBJECT(self), "battery-threshold");
 }
 
+/**
+ * fu_context_add_flag:
+ * @self: a #FuContext
+ * @flag: the context flag, e.g. %FU_CONTEXT_FLAG_SAVE_EVENTS
+ *
+ * Adds a specific context flag.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_context_add_flag(FuContext *self, FuContextFlags flag)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_CONTEXT(self));
+	priv->flags |= flag;
+}
+
+/**
+ * fu_context_remove_flag:
+ * @self: a #FuContext
+ * @flag: the context flag, e.g. %FU_CONTEXT_FLAG_REPORT_IO_STATS
+ *
+ * Removes a specific context flag.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_context_remove_flag(FuContext *self, FuContextFlags flag)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_CONTEXT(self));
+	priv->flags &= ~flag;
+}
+
+/**
+ * fu_context_has_flag:
+ * @self: a #FuContext
+ * @flag: the context flag, e.g. %FU_CONTEXT_FLAG_SAVE_EVENTS
+ *
+ * Finds if the context has a specific flag.
+ *
+ * Returns: %TRUE if the flag is set
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fu_context_has_flag(FuContext *self, FuContextFlags flag)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_CONTEXT(self), FALSE);
+	return (priv->flags & flag) > 0;
+}
+
 static void
 fu_context_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
 {
@@ -908,6 +989,28 @@ fu_context_class_init(FuContextClass *klass)
 			 G_TYPE_NONE,
 			 0);
 
+	/**
+	 * FuContext::security-changed-full:
+	 * @self: the #FuContext instance that emitted the signal
+	 * @plugin_name: the plugin that added the attributes that may have changed
+	 *
+	 * The ::security-changed-full signal is emitted when some system state has changed that
+	 * could have affected the security attributes added by one plugin.
+	 *
+	 * Since: 1.8.0
+	 **/
+	signals[SIGNAL_SECURITY_CHANGED_FULL] =
+	    g_signal_new("security-changed-full",
+			 G_TYPE_FROM_CLASS(object_class),
+			 G_SIGNAL_RUN_LAST,
+			 0,
+			 NULL,
+			 NULL,
+			 g_cclosure_marshal_VOID__STRING,
+			 G_TYPE_NONE,
+			 1,
+			 G_TYPE_STRING);
+
 	object_class->finalize = fu_context_finalize;
 }
 
@@ -21,6 +21,24 @@ struct _FuContextClass {
 	gpointer padding[30];
 };
 
+/**
+ * FuContextFlags:
+ * @FU_CONTEXT_FLAG_NONE:			No flags set
+ * @FU_CONTEXT_FLAG_SAVE_EVENTS:		Save every hardware interaction as a device event
+ * @FU_CONTEXT_FLAG_EMULATION_REALTIME:	Replay emulated device events with the recorded timing
+ * @FU_CONTEXT_FLAG_REPORT_IO_STATS:	Include device transfer counts in the report metadata
+ *
+ * The context flags.
+ **/
+typedef enum {
+	FU_CONTEXT_FLAG_NONE = 0,
+	FU_CONTEXT_FLAG_SAVE_EVENTS = 1 << 0,
+	FU_CONTEXT_FLAG_EMULATION_REALTIME = 1 << 1,
+	FU_CONTEXT_FLAG_REPORT_IO_STATS = 1 << 2,
+	/*< private >*/
+	FU_CONTEXT_FLAG_LAST
+} FuContextFlags;
+
 /**
  * FuContextLookupIter:
  * @self: a #FuContext
@@ -68,6 +86,8 @@ void
 fu_context_add_quirk_key(FuContext *self, const gchar *key);
 void
 fu_context_security_changed(FuContext *self);
+void
+fu_context_security_changed_full(FuContext *self, const gchar *plugin_name);
 
 FuBatteryState
 fu_context_get_battery_state(FuContext *self);
@@ -85,3 +105,9 @@ guint
 fu_context_get_battery_threshold(FuContext *self);
 void
 fu_context_set_battery_threshold(FuContext *self, guint battery_threshold);
+void
+fu_context_add_flag(FuContext *self, FuContextFlags flag);
+void
+fu_context_remove_flag(FuContext *self, FuContextFlags flag);
+gboolean
+fu_context_has_flag(FuContext *self, FuContextFlags flag);
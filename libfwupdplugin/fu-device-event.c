@@ -0,0 +1,371 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define G_LOG_DOMAIN "FuDeviceEvent"
+
+#include "config.h"
+
+#include "fwupd-error.h"
+
+#include "fu-common.h"
+#include "fu-device-event.h"
+
+/**
+ * FuDeviceEvent:
+ *
+ * A single recorded interaction with the hardware, e.g. an ioctl or a USB transfer.
+ *
+ * The ID encodes the request, including a checksum of any data sent to the device, and the event
+ * stores the data and return code sent back. Events are saved when the context has
+ * %FU_CONTEXT_FLAG_SAVE_EVENTS set, and are loaded instead of using the hardware when the device
+ * has %FU_DEVICE_INTERNAL_FLAG_EMULATED set.
+ *
+ * See also: [class@FuDevice]
+ */
+
+struct _FuDeviceEvent {
+	GObject parent_instance;
+	gchar *id;
+	gint64 timestamp; /* µs since the first event */
+	gint64 rc;
+	GBytes *data;
+	GError *error; /* (nullable) */
+};
+
+G_DEFINE_TYPE(FuDeviceEvent, fu_device_event, G_TYPE_OBJECT)
+
+/**
+ * fu_device_event_get_id:
+ * @self: a #FuDeviceEvent
+ *
+ * Gets the event ID, e.g. `Pread:Port=0x1000,Length=0x100`.
+ *
+ * Returns: string
+ *
+ * Since: 1.8.0
+ **/
+const gchar *
+fu_device_event_get_id(FuDeviceEvent *self)
+{
+	g_return_val_if_fail(FU_IS_DEVICE_EVENT(self), NULL);
+	return self->id;
+}
+
+/**
+ * fu_device_event_get_timestamp:
+ * @self: a #FuDeviceEvent
+ *
+ * Gets the time of the event, relative to the first event saved on the device.
+ *
+ * Returns: time in µs
+ *
+ * Since: 1.8.0
+ **/
+gint64
+fu_device_event_get_timestamp(FuDeviceEvent *self)
+{
+	g_return_val_if_fail(FU_IS_DEVICE_EVENT(self), 0);
+	return self->timestamp;
+}
+
+/**
+ * fu_device_event_set_timestamp:
+ * @self: a #FuDeviceEvent
+ * @timestamp: time in µs
+ *
+ * Sets the time of the event, relative to the first event saved on the device.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_device_event_set_timestamp(FuDeviceEvent *self, gint64 timestamp)
+{
+	g_return_if_fail(FU_IS_DEVICE_EVENT(self));
+	self->timestamp = timestamp;
+}
+
+/**
+ * fu_device_event_get_rc:
+ * @self: a #FuDeviceEvent
+ *
+ * Gets the raw return code of the request, e.g. from `ioctl()`.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.0
+ **/
+gint64
+fu_device_event_get_rc(FuDeviceEvent *self)
+{
+	g_return_val_if_fail(FU_IS_DEVICE_EVENT(self), 0);
+	return self->rc;
+}
+
+/**
+ * fu_device_event_set_rc:
+ * @self: a #FuDeviceEvent
+ * @rc: integer
+ *
+ * Sets the raw return code of the request.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_device_event_set_rc(FuDeviceEvent *self, gint64 rc)
+{
+	g_return_if_fail(FU_IS_DEVICE_EVENT(self));
+	self->rc = rc;
+}
+
+/**
+ * fu_device_event_get_data:
+ * @self: a #FuDeviceEvent
+ *
+ * Gets the data returned from the device.
+ *
+ * Returns: (transfer none) (nullable): a #GBytes
+ *
+ * Since: 1.8.0
+ **/
+GBytes *
+fu_device_event_get_data(FuDeviceEvent *self)
+{
+	g_return_val_if_fail(FU_IS_DEVICE_EVENT(self), NULL);
+	return self->data;
+}
+
+/**
+ * fu_device_event_set_data:
+ * @self: a #FuDeviceEvent
+ * @data: (nullable): a #GBytes
+ *
+ * Sets the data returned from the device.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_device_event_set_data(FuDeviceEvent *self, GBytes *data)
+{
+	g_return_if_fail(FU_IS_DEVICE_EVENT(self));
+	if (self->data != NULL)
+		g_bytes_unref(self->data);
+	self->data = data != NULL ? g_bytes_ref(data) : NULL;
+}
+
+/**
+ * fu_device_event_set_data_raw:
+ * @self: a #FuDeviceEvent
+ * @buf: (nullable): a buffer
+ * @bufsz: size of @buf
+ *
+ * Sets the data returned from the device, copying it from @buf.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_device_event_set_data_raw(FuDeviceEvent *self, const guint8 *buf, gsize bufsz)
+{
+	g_autoptr(GBytes) data = g_bytes_new(buf, bufsz);
+	g_return_if_fail(FU_IS_DEVICE_EVENT(self));
+	fu_device_event_set_data(self, data);
+}
+
+/**
+ * fu_device_event_copy_data:
+ * @self: a #FuDeviceEvent
+ * @buf: (nullable): a buffer
+ * @bufsz: size of @buf
+ * @error: (nullable): optional return location for an error
+ *
+ * Copies the data returned from the device into @buf.
+ *
+ * Returns: %TRUE if the data was copied
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fu_device_event_copy_data(FuDeviceEvent *self, guint8 *buf, gsize bufsz, GError **error)
+{
+	gsize datasz = 0;
+	const guint8 *data = NULL;
+
+	g_return_val_if_fail(FU_IS_DEVICE_EVENT(self), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (self->data != NULL)
+		data = g_bytes_get_data(self->data, &datasz);
+	if (datasz == 0)
+		return TRUE;
+	return fu_memcpy_safe(buf, bufsz, 0x0, data, datasz, 0x0, datasz, error);
+}
+
+/**
+ * fu_device_event_get_error:
+ * @self: a #FuDeviceEvent
+ *
+ * Gets the error returned when the request failed.
+ *
+ * Returns: (transfer none) (nullable): a #GError, or %NULL if the request succeeded
+ *
+ * Since: 1.8.0
+ **/
+const GError *
+fu_device_event_get_error(FuDeviceEvent *self)
+{
+	g_return_val_if_fail(FU_IS_DEVICE_EVENT(self), NULL);
+	return self->error;
+}
+
+/**
+ * fu_device_event_set_error:
+ * @self: a #FuDeviceEvent
+ * @error: (nullable): a #GError
+ *
+ * Sets the error returned when the request failed, so that the failure can be replayed too.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_device_event_set_error(FuDeviceEvent *self, const GError *error)
+{
+	g_return_if_fail(FU_IS_DEVICE_EVENT(self));
+	g_clear_error(&self->error);
+	if (error != NULL)
+		self->error = g_error_copy(error);
+}
+
+/**
+ * fu_device_event_to_variant:
+ * @self: a #FuDeviceEvent
+ *
+ * Serializes the event.
+ *
+ * Returns: (transfer floating): a #GVariant of type `(sxxaysis)`
+ *
+ * Since: 1.8.0
+ **/
+GVariant *
+fu_device_event_to_variant(FuDeviceEvent *self)
+{
+	gsize datasz = 0;
+	const guint8 *data = NULL;
+
+	g_return_val_if_fail(FU_IS_DEVICE_EVENT(self), NULL);
+
+	if (self->data != NULL)
+		data = g_bytes_get_data(self->data, &datasz);
+
+	/* the error domain is saved as a string as quarks are only valid in one process */
+	return g_variant_new("(sxx@aysis)",
+			     self->id,
+			     self->timestamp,
+			     self->rc,
+			     g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, data, datasz, 1),
+			     self->error != NULL ? g_quark_to_string(self->error->domain) : "",
+			     self->error != NULL ? self->error->code : 0,
+			     self->error != NULL ? self->error->message : "");
+}
+
+/**
+ * fu_device_event_from_variant:
+ * @value: a #GVariant of type `(sxxaysis)`
+ * @error: (nullable): optional return location for an error
+ *
+ * Creates an event from a value created with fu_device_event_to_variant().
+ *
+ * Returns: (transfer full): a #FuDeviceEvent, or %NULL on error
+ *
+ * Since: 1.8.0
+ **/
+FuDeviceEvent *
+fu_device_event_from_variant(GVariant *value, GError **error)
+{
+	const gchar *id = NULL;
+	const gchar *error_domain = NULL;
+	const gchar *error_message = NULL;
+	const guint8 *data;
+	gint error_code = 0;
+	gsize datasz = 0;
+	gint64 rc = 0;
+	gint64 timestamp = 0;
+	g_autoptr(FuDeviceEvent) self = NULL;
+	g_autoptr(GVariant) data_value = NULL;
+
+	g_return_val_if_fail(value != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	if (!g_variant_is_of_type(value, G_VARIANT_TYPE("(sxxaysis)"))) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "event has invalid type %s",
+			    g_variant_get_type_string(value));
+		return NULL;
+	}
+	g_variant_get(value,
+		      "(&sxx@ay&si&s)",
+		      &id,
+		      &timestamp,
+		      &rc,
+		      &data_value,
+		      &error_domain,
+		      &error_code,
+		      &error_message);
+	self = fu_device_event_new(id);
+	self->timestamp = timestamp;
+	self->rc = rc;
+	data = g_variant_get_fixed_array(data_value, &datasz, 1);
+	if (datasz > 0)
+		fu_device_event_set_data_raw(self, data, datasz);
+	if (error_domain[0] != '\0') {
+		self->error = g_error_new_literal(g_quark_from_string(error_domain),
+						  error_code,
+						  error_message);
+	}
+	return g_steal_pointer(&self);
+}
+
+static void
+fu_device_event_finalize(GObject *object)
+{
+	FuDeviceEvent *self = FU_DEVICE_EVENT(object);
+	g_free(self->id);
+	if (self->data != NULL)
+		g_bytes_unref(self->data);
+	if (self->error != NULL)
+		g_error_free(self->error);
+	G_OBJECT_CLASS(fu_device_event_parent_class)->finalize(object);
+}
+
+static void
+fu_device_event_class_init(FuDeviceEventClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_device_event_finalize;
+}
+
+static void
+fu_device_event_init(FuDeviceEvent *self)
+{
+}
+
+/**
+ * fu_device_event_new:
+ * @id: an event ID, e.g. `Ioctl:Request=0x5401,Length=0x4,Crc=0x12345678`
+ *
+ * Creates a new device event.
+ *
+ * Returns: (transfer full): a #FuDeviceEvent
+ *
+ * Since: 1.8.0
+ **/
+FuDeviceEvent *
+fu_device_event_new(const gchar *id)
+{
+	FuDeviceEvent *self = g_object_new(FU_TYPE_DEVICE_EVENT, NULL);
+	self->id = g_strdup(id);
+	return self;
+}
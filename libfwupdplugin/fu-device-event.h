@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+#define FU_TYPE_DEVICE_EVENT (fu_device_event_get_type())
+
+G_DECLARE_FINAL_TYPE(FuDeviceEvent, fu_device_event, FU, DEVICE_EVENT, GObject)
+
+FuDeviceEvent *
+fu_device_event_new(const gchar *id);
+FuDeviceEvent *
+fu_device_event_from_variant(GVariant *value, GError **error) G_GNUC_WARN_UNUSED_RESULT;
+GVariant *
+fu_device_event_to_variant(FuDeviceEvent *self);
+const gchar *
+fu_device_event_get_id(FuDeviceEvent *self);
+gint64
+fu_device_event_get_timestamp(FuDeviceEvent *self);
+void
+fu_device_event_set_timestamp(FuDeviceEvent *self, gint64 timestamp);
+gint64
+fu_device_event_get_rc(FuDeviceEvent *self);
+void
+fu_device_event_set_rc(FuDeviceEvent *self, gint64 rc);
+GBytes *
+fu_device_event_get_data(FuDeviceEvent *self);
+void
+fu_device_event_set_data(FuDeviceEvent *self, GBytes *data);
+void
+fu_device_event_set_data_raw(FuDeviceEvent *self, const guint8 *buf, gsize bufsz);
+const GError *
+fu_device_event_get_error(FuDeviceEvent *self);
+void
+fu_device_event_set_error(FuDeviceEvent *self, const GError *error);
+gboolean
+fu_device_event_copy_data(FuDeviceEvent *self,
+			  guint8 *buf,
+			  gsize bufsz,
+			  GError **error) G_GNUC_WARN_UNUSED_RESULT;
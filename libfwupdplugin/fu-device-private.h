@@ -56,3 +56,7 @@ FuDeviceInternalFlags
 fu_device_get_internal_flags(FuDevice *self);
 void
 fu_device_set_internal_flags(FuDevice *self, FuDeviceInternalFlags flags);
+gboolean
+fu_device_has_save_events(FuDevice *self);
+void
+fu_device_incorporate_io_stats(FuDevice *self, FuDevice *donor);
@@ -20,12 +20,16 @@
 #include "fu-device-private.h"
 #include "fu-mutex.h"
 #include "fu-quirks.h"
+#include "fu-trace-private.h"
 
 #define FU_DEVICE_RETRY_OPEN_COUNT 5
 #define FU_DEVICE_RETRY_OPEN_DELAY 500 /* ms */
 
 #define FU_DEVICE_DEFAULT_BATTERY_THRESHOLD 10 /* % */
 
+/* bucket N holds latencies of up to 2^N µs */
+#define FU_DEVICE_IO_STATS_BUCKETS_MAX 32
+
 /**
  * FuDevice:
  *
@@ -77,6 +81,12 @@ typedef struct {
 	gchar *custom_flags;
 	gulong notify_flags_handler_id;
 	GHashTable *instance_hash;
+	GPtrArray *events; /* (nullable) (element-type FuDeviceEvent) */
+	guint event_idx;
+	gint64 event_start; /* µs */
+	GPtrArray *io_stats; /* (nullable) (element-type FuDeviceIoStats) */
+	guint64 io_retries;
+	GRWLock io_stats_mutex; /* io_stats and io_retries */
 } FuDevicePrivate;
 
 typedef struct {
@@ -90,6 +100,16 @@ typedef struct {
 	gchar *reason;
 } FuDeviceInhibit;
 
+typedef struct {
+	gchar *kind;
+	guint64 transfers;
+	guint64 bytes;
+	gint64 latency_min; /* µs */
+	gint64 latency_max; /* µs */
+	gint64 latency_sum; /* µs */
+	guint64 buckets[FU_DEVICE_IO_STATS_BUCKETS_MAX];
+} FuDeviceIoStats;
+
 enum {
 	PROP_0,
 	PROP_BATTERY_LEVEL,
@@ -242,6 +262,8 @@ fu_device_internal_flag_to_string(FuDeviceInternalFlags flag)
 		return "no-probe";
 	if (flag == FU_DEVICE_INTERNAL_FLAG_MD_SET_SIGNED)
 		return "md-set-signed";
+	if (flag == FU_DEVICE_INTERNAL_FLAG_EMULATED)
+		return "emulated";
 	return NULL;
 }
 
@@ -306,6 +328,8 @@ fu_device_internal_flag_from_string(const gchar *flag)
 		return FU_DEVICE_INTERNAL_FLAG_NO_PROBE;
 	if (g_strcmp0(flag, "md-set-signed") == 0)
 		return FU_DEVICE_INTERNAL_FLAG_MD_SET_SIGNED;
+	if (g_strcmp0(flag, "emulated") == 0)
+		return FU_DEVICE_INTERNAL_FLAG_EMULATED;
 	return FU_DEVICE_INTERNAL_FLAG_UNKNOWN;
 }
 
@@ -657,6 +681,9 @@ fu_device_retry_full(FuDevice *self,
 						   count);
 			return FALSE;
 		}
+		g_rw_lock_writer_lock(&priv->io_stats_mutex);
+		priv->io_retries++;
+		g_rw_lock_writer_unlock(&priv->io_stats_mutex);
 
 		/* show recoverable error on the console */
 		if (priv->retry_recs->len == 0) {
@@ -1740,6 +1767,23 @@ fu_device_set_firmware_gtype(FuDevice *self, GType firmware_gtype)
 	priv->firmware_gtype = firmware_gtype;
 }
 
+/**
+ * fu_device_set_specialized_gtype:
+ * @self: a #FuDevice
+ * @gtype: a #GType
+ *
+ * Sets the specialized type of the device, which is normally set using the `GType` quirk.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_device_set_specialized_gtype(FuDevice *self, GType gtype)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_DEVICE(self));
+	priv->specialized_gtype = gtype;
+}
+
 static void
 fu_device_quirks_iter_cb(FuContext *ctx, const gchar *key, const gchar *value, gpointer user_data)
 {
@@ -3384,6 +3428,115 @@ fu_device_set_battery_threshold(FuDevice *self, guint battery_threshold)
 	fu_device_ensure_battery_inhibit(self);
 }
 
+/* all the io_stats helpers have to be called with io_stats_mutex held */
+static FuDeviceIoStats *
+fu_device_io_stats_find(FuDevice *self, const gchar *kind)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	if (priv->io_stats == NULL)
+		return NULL;
+	for (guint i = 0; i < priv->io_stats->len; i++) {
+		FuDeviceIoStats *item = g_ptr_array_index(priv->io_stats, i);
+		if (g_strcmp0(item->kind, kind) == 0)
+			return item;
+	}
+	return NULL;
+}
+
+static void
+fu_device_io_stats_free(FuDeviceIoStats *item)
+{
+	g_free(item->kind);
+	g_free(item);
+}
+
+static FuDeviceIoStats *
+fu_device_io_stats_ensure(FuDevice *self, const gchar *kind)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuDeviceIoStats *item = fu_device_io_stats_find(self, kind);
+	if (item != NULL)
+		return item;
+	if (priv->io_stats == NULL) {
+		priv->io_stats =
+		    g_ptr_array_new_with_free_func((GDestroyNotify)fu_device_io_stats_free);
+	}
+	item = g_new0(FuDeviceIoStats, 1);
+	item->kind = g_strdup(kind);
+	item->latency_min = G_MAXINT64;
+	g_ptr_array_add(priv->io_stats, item);
+	return item;
+}
+
+static void
+fu_device_io_stats_merge(FuDeviceIoStats *item, FuDeviceIoStats *donor)
+{
+	item->transfers += donor->transfers;
+	item->bytes += donor->bytes;
+	item->latency_min = MIN(item->latency_min, donor->latency_min);
+	item->latency_max = MAX(item->latency_max, donor->latency_max);
+	item->latency_sum += donor->latency_sum;
+	for (guint i = 0; i < FU_DEVICE_IO_STATS_BUCKETS_MAX; i++)
+		item->buckets[i] += donor->buckets[i];
+}
+
+/* the upper bound of the bucket holding the 99th percentile, clamped to the slowest transfer */
+static gint64
+fu_device_io_stats_get_p99(FuDeviceIoStats *item)
+{
+	guint64 cumulative = 0;
+	guint64 rank = (item->transfers * 99 + 99) / 100;
+
+	for (guint i = 0; i < FU_DEVICE_IO_STATS_BUCKETS_MAX; i++) {
+		cumulative += item->buckets[i];
+		if (cumulative >= rank)
+			return MIN((gint64)1 << i, item->latency_max);
+	}
+	return item->latency_max;
+}
+
+static gchar *
+fu_device_io_stats_to_string(FuDeviceIoStats *item)
+{
+	return g_strdup_printf("transfers:%" G_GUINT64_FORMAT ",bytes:%" G_GUINT64_FORMAT
+			       ",min:%" G_GINT64_FORMAT "us,avg:%" G_GINT64_FORMAT
+			       "us,p99:%" G_GINT64_FORMAT "us",
+			       item->transfers,
+			       item->bytes,
+			       item->latency_min,
+			       item->latency_sum / (gint64)item->transfers,
+			       fu_device_io_stats_get_p99(item));
+}
+
+static gboolean
+fu_device_has_io_stats(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new(&priv->io_stats_mutex);
+	return priv->io_stats != NULL || priv->io_retries > 0;
+}
+
+static void
+fu_device_io_stats_to_metadata(FuDeviceIoStats *item, GHashTable *metadata)
+{
+	g_hash_table_insert(metadata,
+			    g_strdup_printf("Io%sTransfers", item->kind),
+			    g_strdup_printf("%" G_GUINT64_FORMAT, item->transfers));
+	g_hash_table_insert(metadata,
+			    g_strdup_printf("Io%sBytes", item->kind),
+			    g_strdup_printf("%" G_GUINT64_FORMAT, item->bytes));
+	g_hash_table_insert(metadata,
+			    g_strdup_printf("Io%sLatencyMin", item->kind),
+			    g_strdup_printf("%" G_GINT64_FORMAT, item->latency_min));
+	g_hash_table_insert(metadata,
+			    g_strdup_printf("Io%sLatencyAvg", item->kind),
+			    g_strdup_printf("%" G_GINT64_FORMAT,
+					    item->latency_sum / (gint64)item->transfers));
+	g_hash_table_insert(metadata,
+			    g_strdup_printf("Io%sLatencyP99", item->kind),
+			    g_strdup_printf("%" G_GINT64_FORMAT, fu_device_io_stats_get_p99(item)));
+}
+
 /**
  * fu_device_add_string:
  * @self: a #FuDevice
@@ -3507,6 +3660,20 @@ fu_device_add_string(FuDevice *self, guint idt, GString *str)
 			fu_common_string_append_kv(str, idt + 1, "Inhibit", val);
 		}
 	}
+	g_rw_lock_reader_lock(&priv->io_stats_mutex);
+	if (priv->io_stats != NULL) {
+		for (guint i = 0; i < priv->io_stats->len; i++) {
+			FuDeviceIoStats *item = g_ptr_array_index(priv->io_stats, i);
+			g_autofree gchar *key = g_strdup_printf("Io%s", item->kind);
+			g_autofree gchar *val = fu_device_io_stats_to_string(item);
+			fu_common_string_append_kv(str, idt + 1, key, val);
+		}
+	}
+	if (priv->io_retries > 0) {
+		g_autofree gchar *val = g_strdup_printf("%" G_GUINT64_FORMAT, priv->io_retries);
+		fu_common_string_append_kv(str, idt + 1, "IoRetries", val);
+	}
+	g_rw_lock_reader_unlock(&priv->io_stats_mutex);
 
 	/* subclassed */
 	if (klass->to_string != NULL)
@@ -3668,6 +3835,7 @@ fu_device_write_firmware(FuDevice *self,
 {
 	FuDeviceClass *klass = FU_DEVICE_GET_CLASS(self);
 	FuDevicePrivate *priv = GET_PRIVATE(self);
+	gboolean ret;
 	g_autoptr(FuFirmware) firmware = NULL;
 	g_autofree gchar *str = NULL;
 
@@ -3690,7 +3858,10 @@ fu_device_write_firmware(FuDevice *self,
 	g_debug("installing onto %s:\n%s", fu_device_get_id(self), str);
 
 	/* call vfunc */
-	if (!klass->write_firmware(self, firmware, progress, flags, error))
+	FU_TRACE2(device_vfunc_entry, fu_device_get_id(self), "write_firmware");
+	ret = klass->write_firmware(self, firmware, progress, flags, error);
+	FU_TRACE3(device_vfunc_exit, fu_device_get_id(self), "write_firmware", ret);
+	if (!ret)
 		return FALSE;
 
 	/* the device set an UpdateMessage (possibly from a quirk, or XML file)
@@ -3895,6 +4066,7 @@ gboolean
 fu_device_detach_full(FuDevice *self, FuProgress *progress, GError **error)
 {
 	FuDeviceClass *klass = FU_DEVICE_GET_CLASS(self);
+	gboolean ret;
 
 	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
@@ -3905,7 +4077,10 @@ fu_device_detach_full(FuDevice *self, FuProgress *progress, GError **error)
 		return TRUE;
 
 	/* call vfunc */
-	return klass->detach(self, progress, error);
+	FU_TRACE2(device_vfunc_entry, fu_device_get_id(self), "detach");
+	ret = klass->detach(self, progress, error);
+	FU_TRACE3(device_vfunc_exit, fu_device_get_id(self), "detach", ret);
+	return ret;
 }
 
 /**
@@ -3942,6 +4117,7 @@ gboolean
 fu_device_attach_full(FuDevice *self, FuProgress *progress, GError **error)
 {
 	FuDeviceClass *klass = FU_DEVICE_GET_CLASS(self);
+	gboolean ret;
 
 	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
@@ -3952,7 +4128,10 @@ fu_device_attach_full(FuDevice *self, FuProgress *progress, GError **error)
 		return TRUE;
 
 	/* call vfunc */
-	return klass->attach(self, progress, error);
+	FU_TRACE2(device_vfunc_entry, fu_device_get_id(self), "attach");
+	ret = klass->attach(self, progress, error);
+	FU_TRACE3(device_vfunc_exit, fu_device_get_id(self), "attach", ret);
+	return ret;
 }
 
 /**
@@ -4122,22 +4301,27 @@ fu_device_open_internal(FuDevice *self, GError **error)
 gboolean
 fu_device_open(FuDevice *self, GError **error)
 {
+	FuDevice *device = self;
+	gboolean ret;
+
 	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
 	/* use parent */
 	if (fu_device_has_internal_flag(self, FU_DEVICE_INTERNAL_FLAG_USE_PARENT_FOR_OPEN)) {
-		FuDevice *parent = fu_device_get_parent(self);
-		if (parent == NULL) {
+		device = fu_device_get_parent(self);
+		if (device == NULL) {
 			g_set_error_literal(error,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_NOT_SUPPORTED,
 					    "no parent device");
 			return FALSE;
 		}
-		return fu_device_open_internal(parent, error);
 	}
-	return fu_device_open_internal(self, error);
+	FU_TRACE2(device_vfunc_entry, fu_device_get_id(device), "open");
+	ret = fu_device_open_internal(device, error);
+	FU_TRACE3(device_vfunc_exit, fu_device_get_id(device), "open", ret);
+	return ret;
 }
 
 static gboolean
@@ -4244,6 +4428,12 @@ fu_device_probe(FuDevice *self, GError **error)
 		return FALSE;
 	}
 
+	/* the saved device already has everything the probe would have found */
+	if (fu_device_has_internal_flag(self, FU_DEVICE_INTERNAL_FLAG_EMULATED)) {
+		priv->done_probe = TRUE;
+		return TRUE;
+	}
+
 	/* subclassed */
 	if (klass->probe != NULL) {
 		if (!klass->probe(self, error))
@@ -4383,7 +4573,11 @@ fu_device_setup(FuDevice *self, GError **error)
 
 	/* subclassed */
 	if (klass->setup != NULL) {
-		if (!klass->setup(self, error))
+		gboolean ret;
+		FU_TRACE2(device_vfunc_entry, fu_device_get_id(self), "setup");
+		ret = klass->setup(self, error);
+		FU_TRACE3(device_vfunc_exit, fu_device_get_id(self), "setup", ret);
+		if (!ret)
 			return FALSE;
 	}
 
@@ -4504,6 +4698,9 @@ fu_device_report_metadata_pre(FuDevice *self)
  *
  * Collects metadata that would be useful for debugging a failed update report.
  *
+ * Any transfer and retry counts recorded with fu_device_add_io_stats() are also included if the
+ * context has %FU_CONTEXT_FLAG_REPORT_IO_STATS set.
+ *
  * Returns: (transfer full) (nullable): a #GHashTable, or %NULL if there is no data
  *
  * Since: 1.5.0
@@ -4512,17 +4709,40 @@ GHashTable *
 fu_device_report_metadata_post(FuDevice *self)
 {
 	FuDeviceClass *klass = FU_DEVICE_GET_CLASS(self);
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	gboolean report_io_stats = FALSE;
 	g_autoptr(GHashTable) metadata = NULL;
 
 	g_return_val_if_fail(FU_IS_DEVICE(self), NULL);
 
+	/* the transfer counts are only sent if the admin opted in */
+	if (priv->ctx != NULL && fu_context_has_flag(priv->ctx, FU_CONTEXT_FLAG_REPORT_IO_STATS))
+		report_io_stats = fu_device_has_io_stats(self);
+
 	/* not implemented */
-	if (klass->report_metadata_post == NULL)
+	if (klass->report_metadata_post == NULL && !report_io_stats)
 		return NULL;
 
 	/* metadata for all devices */
 	metadata = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
-	klass->report_metadata_post(self, metadata);
+	if (report_io_stats) {
+		g_rw_lock_reader_lock(&priv->io_stats_mutex);
+		if (priv->io_stats != NULL) {
+			for (guint i = 0; i < priv->io_stats->len; i++) {
+				FuDeviceIoStats *item = g_ptr_array_index(priv->io_stats, i);
+				fu_device_io_stats_to_metadata(item, metadata);
+			}
+		}
+		if (priv->io_retries > 0) {
+			g_hash_table_insert(metadata,
+					    g_strdup("IoRetries"),
+					    g_strdup_printf("%" G_GUINT64_FORMAT,
+							    priv->io_retries));
+		}
+		g_rw_lock_reader_unlock(&priv->io_stats_mutex);
+	}
+	if (klass->report_metadata_post != NULL)
+		klass->report_metadata_post(self, metadata);
 	return g_steal_pointer(&metadata);
 }
 
@@ -4533,6 +4753,9 @@ fu_device_report_metadata_post(FuDevice *self)
  *
  * Adds HSI security attributes.
  *
+ * The daemon calls this from a worker thread, at the same time as devices created by
+ * other plugins are adding their own attributes.
+ *
  * Since: 1.6.0
  **/
 void
@@ -4614,6 +4837,302 @@ fu_device_unbind_driver(FuDevice *self, GError **error)
 	return klass->unbind_driver(self, error);
 }
 
+/**
+ * fu_device_add_event:
+ * @self: a #FuDevice
+ * @event: a #FuDeviceEvent
+ *
+ * Adds a previously saved event to the device, typically when loading an emulated device.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_device_add_event(FuDevice *self, FuDeviceEvent *event)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_DEVICE(self));
+	g_return_if_fail(FU_IS_DEVICE_EVENT(event));
+	if (priv->events == NULL)
+		priv->events = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	g_ptr_array_add(priv->events, g_object_ref(event));
+}
+
+static gboolean
+fu_device_has_event(FuDevice *self, FuDeviceEvent *event)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	if (priv->events == NULL)
+		return FALSE;
+	for (guint i = 0; i < priv->events->len; i++) {
+		if (g_ptr_array_index(priv->events, i) == event)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+/**
+ * fu_device_get_events:
+ * @self: a #FuDevice
+ *
+ * Gets all the events saved or loaded for the device.
+ *
+ * Returns: (transfer none) (element-type FuDeviceEvent) (nullable): events
+ *
+ * Since: 1.8.0
+ **/
+GPtrArray *
+fu_device_get_events(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_DEVICE(self), NULL);
+	return priv->events;
+}
+
+/**
+ * fu_device_clear_events:
+ * @self: a #FuDevice
+ *
+ * Removes all the saved events, and resets the position used for loading events.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_device_clear_events(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_DEVICE(self));
+	if (priv->events != NULL)
+		g_ptr_array_set_size(priv->events, 0);
+	priv->event_idx = 0;
+	priv->event_start = 0;
+}
+
+/**
+ * fu_device_add_io_stats:
+ * @self: a #FuDevice
+ * @kind: a transfer kind, e.g. `Pwrite` or `UsbBulk`
+ * @length: the number of bytes transferred
+ * @duration: the time taken for the transfer in µs
+ *
+ * Records a successful hardware transfer. The totals and latencies for each kind are shown in
+ * fu_device_to_string() and are included in fu_device_report_metadata_post() when the context
+ * has %FU_CONTEXT_FLAG_REPORT_IO_STATS set.
+ *
+ * This is called automatically by the #FuUdevDevice, #FuUsbDevice, #FuHidDevice and
+ * #FuBluezDevice helpers, so plugins only need to call it for transfers done by hand.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_device_add_io_stats(FuDevice *self, const gchar *kind, gsize length, gint64 duration)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuDeviceIoStats *item;
+	guint idx = 0;
+	g_autoptr(GRWLockWriterLocker) locker = NULL;
+
+	g_return_if_fail(FU_IS_DEVICE(self));
+	g_return_if_fail(kind != NULL);
+
+	if (duration < 0)
+		duration = 0;
+	locker = g_rw_lock_writer_locker_new(&priv->io_stats_mutex);
+	item = fu_device_io_stats_ensure(self, kind);
+	item->transfers++;
+	item->bytes += length;
+	item->latency_min = MIN(item->latency_min, duration);
+	item->latency_max = MAX(item->latency_max, duration);
+	item->latency_sum += duration;
+	if (duration > 1)
+		idx = g_bit_storage((guint64)duration - 1);
+	item->buckets[MIN(idx, FU_DEVICE_IO_STATS_BUCKETS_MAX - 1)]++;
+}
+
+/**
+ * fu_device_clear_io_stats:
+ * @self: a #FuDevice
+ *
+ * Resets the transfer and retry counts recorded on the device.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_device_clear_io_stats(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	g_return_if_fail(FU_IS_DEVICE(self));
+	locker = g_rw_lock_writer_locker_new(&priv->io_stats_mutex);
+	g_clear_pointer(&priv->io_stats, g_ptr_array_unref);
+	priv->io_retries = 0;
+}
+
+/**
+ * fu_device_incorporate_io_stats:
+ * @self: a #FuDevice
+ * @donor: another device
+ *
+ * Moves the transfer and retry counts from @donor, for instance when a device replugs into
+ * bootloader mode. The counts are reset on @donor so they are not added twice if the device
+ * is later swapped back.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_device_incorporate_io_stats(FuDevice *self, FuDevice *donor)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuDevicePrivate *priv_donor = GET_PRIVATE(donor);
+	guint64 io_retries_donor;
+	g_autoptr(GPtrArray) io_stats_donor = NULL;
+
+	g_return_if_fail(FU_IS_DEVICE(self));
+	g_return_if_fail(FU_IS_DEVICE(donor));
+
+	if (self == donor)
+		return;
+
+	/* take the counts from the donor first so that both locks are never held at once */
+	g_rw_lock_writer_lock(&priv_donor->io_stats_mutex);
+	io_stats_donor = g_steal_pointer(&priv_donor->io_stats);
+	io_retries_donor = priv_donor->io_retries;
+	priv_donor->io_retries = 0;
+	g_rw_lock_writer_unlock(&priv_donor->io_stats_mutex);
+
+	g_rw_lock_writer_lock(&priv->io_stats_mutex);
+	if (io_stats_donor != NULL) {
+		for (guint i = 0; i < io_stats_donor->len; i++) {
+			FuDeviceIoStats *item = g_ptr_array_index(io_stats_donor, i);
+			fu_device_io_stats_merge(fu_device_io_stats_ensure(self, item->kind), item);
+		}
+	}
+	priv->io_retries += io_retries_donor;
+	g_rw_lock_writer_unlock(&priv->io_stats_mutex);
+}
+
+/**
+ * fu_device_has_save_events:
+ * @self: a #FuDevice
+ *
+ * Finds out if hardware access should be saved as device events, i.e. if the context has
+ * %FU_CONTEXT_FLAG_SAVE_EVENTS set and the device is not already emulated.
+ *
+ * Returns: %TRUE if events should be saved
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fu_device_has_save_events(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
+	if (priv->ctx == NULL)
+		return FALSE;
+	if (fu_device_has_internal_flag(self, FU_DEVICE_INTERNAL_FLAG_EMULATED))
+		return FALSE;
+	return fu_context_has_flag(priv->ctx, FU_CONTEXT_FLAG_SAVE_EVENTS);
+}
+
+/**
+ * fu_device_save_event:
+ * @self: a #FuDevice
+ * @id: an event ID, e.g. `Pread:Port=0x1000,Length=0x100`
+ *
+ * Saves a new event on the device. The caller should set the data and return code on the returned
+ * event once the request has completed.
+ *
+ * This should only be called when the context has %FU_CONTEXT_FLAG_SAVE_EVENTS set.
+ *
+ * Returns: (transfer none): a #FuDeviceEvent
+ *
+ * Since: 1.8.0
+ **/
+FuDeviceEvent *
+fu_device_save_event(FuDevice *self, const gchar *id)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	gint64 now = g_get_monotonic_time();
+	g_autoptr(FuDeviceEvent) event = fu_device_event_new(id);
+
+	g_return_val_if_fail(FU_IS_DEVICE(self), NULL);
+	g_return_val_if_fail(id != NULL, NULL);
+
+	/* timestamps are relative to the first event */
+	if (priv->event_start == 0)
+		priv->event_start = now;
+	fu_device_event_set_timestamp(event, now - priv->event_start);
+	fu_device_add_event(self, event);
+	return event;
+}
+
+/**
+ * fu_device_load_event:
+ * @self: a #FuDevice
+ * @id: an event ID, e.g. `Pread:Port=0x1000,Length=0x100`
+ * @error: (nullable): optional return location for an error
+ *
+ * Loads the next saved event, which must have the given ID. Events are replayed strictly in the
+ * order they were saved, so a request that is missing, repeated or reordered fails.
+ *
+ * If the context has %FU_CONTEXT_FLAG_EMULATION_REALTIME set then this function will also sleep
+ * until the time the event was originally saved.
+ *
+ * If the request failed when it was saved then the saved error is returned.
+ *
+ * Returns: (transfer none): a #FuDeviceEvent, or %NULL if not found or the request failed
+ *
+ * Since: 1.8.0
+ **/
+FuDeviceEvent *
+fu_device_load_event(FuDevice *self, const gchar *id, GError **error)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuDeviceEvent *event;
+
+	g_return_val_if_fail(FU_IS_DEVICE(self), NULL);
+	g_return_val_if_fail(id != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* the device has to make exactly the same requests in the same order */
+	if (priv->events == NULL || priv->event_idx >= priv->events->len) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_FOUND,
+			    "no saved event left for %s",
+			    id);
+		return NULL;
+	}
+	event = g_ptr_array_index(priv->events, priv->event_idx);
+	if (g_strcmp0(fu_device_event_get_id(event), id) != 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "saved event %u is %s, but got %s",
+			    priv->event_idx,
+			    fu_device_event_get_id(event),
+			    id);
+		return NULL;
+	}
+	priv->event_idx++;
+
+	/* replay with the original timing */
+	if (priv->ctx != NULL &&
+	    fu_context_has_flag(priv->ctx, FU_CONTEXT_FLAG_EMULATION_REALTIME)) {
+		gint64 now = g_get_monotonic_time();
+		gint64 delay;
+		if (priv->event_start == 0)
+			priv->event_start = now - fu_device_event_get_timestamp(event);
+		delay = priv->event_start + fu_device_event_get_timestamp(event) - now;
+		if (delay > 0)
+			g_usleep(delay);
+	}
+	if (fu_device_event_get_error(event) != NULL) {
+		g_propagate_error(error, g_error_copy(fu_device_event_get_error(event)));
+		return NULL;
+	}
+	return event;
+}
+
 /**
  * fu_device_incorporate:
  * @self: a #FuDevice
@@ -4677,6 +5196,15 @@ fu_device_incorporate(FuDevice *self, FuDevice *donor)
 		}
 	}
 	g_rw_lock_reader_unlock(&priv_donor->metadata_mutex);
+	if (fu_device_has_internal_flag(donor, FU_DEVICE_INTERNAL_FLAG_EMULATED))
+		fu_device_add_internal_flag(self, FU_DEVICE_INTERNAL_FLAG_EMULATED);
+	if (priv_donor->events != NULL) {
+		for (guint i = 0; i < priv_donor->events->len; i++) {
+			FuDeviceEvent *event = g_ptr_array_index(priv_donor->events, i);
+			if (!fu_device_has_event(self, event))
+				fu_device_add_event(self, event);
+		}
+	}
 
 	/* now the base class, where all the interesting bits are */
 	fwupd_device_incorporate(FWUPD_DEVICE(self), FWUPD_DEVICE(donor));
@@ -5253,6 +5781,7 @@ fu_device_init(FuDevice *self)
 	priv->instance_hash = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	g_rw_lock_init(&priv->parent_guids_mutex);
 	g_rw_lock_init(&priv->metadata_mutex);
+	g_rw_lock_init(&priv->io_stats_mutex);
 	priv->notify_flags_handler_id = g_signal_connect(FWUPD_DEVICE(self),
 							 "notify::flags",
 							 G_CALLBACK(fu_device_flags_notify_cb),
@@ -5267,6 +5796,7 @@ fu_device_finalize(GObject *object)
 
 	g_rw_lock_clear(&priv->metadata_mutex);
 	g_rw_lock_clear(&priv->parent_guids_mutex);
+	g_rw_lock_clear(&priv->io_stats_mutex);
 
 	if (priv->alternate != NULL)
 		g_object_unref(priv->alternate);
@@ -5284,6 +5814,10 @@ fu_device_finalize(GObject *object)
 		g_ptr_array_unref(priv->parent_physical_ids);
 	if (priv->private_flag_items != NULL)
 		g_ptr_array_unref(priv->private_flag_items);
+	if (priv->events != NULL)
+		g_ptr_array_unref(priv->events);
+	if (priv->io_stats != NULL)
+		g_ptr_array_unref(priv->io_stats);
 	g_ptr_array_unref(priv->parent_guids);
 	g_ptr_array_unref(priv->possible_plugins);
 	g_ptr_array_unref(priv->retry_recs);
@@ -11,6 +11,7 @@
 
 #include "fu-common-version.h"
 #include "fu-context.h"
+#include "fu-device-event.h"
 #include "fu-firmware.h"
 #include "fu-progress.h"
 #include "fu-security-attrs.h"
@@ -447,6 +448,16 @@ typedef guint64 FuDeviceInternalFlags;
  */
 #define FU_DEVICE_INTERNAL_FLAG_MD_SET_SIGNED (1ull << 23)
 
+/**
+ * FU_DEVICE_INTERNAL_FLAG_EMULATED:
+ *
+ * The device is being emulated, and all hardware access should be replaced by the saved device
+ * events.
+ *
+ * Since: 1.8.0
+ */
+#define FU_DEVICE_INTERNAL_FLAG_EMULATED (1ull << 24)
+
 /* accessors */
 gchar *
 fu_device_to_string(FuDevice *self);
@@ -595,6 +606,8 @@ fu_device_get_firmware_gtype(FuDevice *self);
 void
 fu_device_set_firmware_gtype(FuDevice *self, GType firmware_gtype);
 void
+fu_device_set_specialized_gtype(FuDevice *self, GType gtype);
+void
 fu_device_add_internal_flag(FuDevice *self, FuDeviceInternalFlags flag);
 void
 fu_device_remove_internal_flag(FuDevice *self, FuDeviceInternalFlags flag);
@@ -720,3 +733,17 @@ gboolean
 fu_device_build_instance_id(FuDevice *self, GError **error, const gchar *subsystem, ...);
 gboolean
 fu_device_build_instance_id_quirk(FuDevice *self, GError **error, const gchar *subsystem, ...);
+FuDeviceEvent *
+fu_device_save_event(FuDevice *self, const gchar *id);
+FuDeviceEvent *
+fu_device_load_event(FuDevice *self, const gchar *id, GError **error) G_GNUC_WARN_UNUSED_RESULT;
+void
+fu_device_add_event(FuDevice *self, FuDeviceEvent *event);
+GPtrArray *
+fu_device_get_events(FuDevice *self);
+void
+fu_device_clear_events(FuDevice *self);
+void
+fu_device_add_io_stats(FuDevice *self, const gchar *kind, gsize length, gint64 duration);
+void
+fu_device_clear_io_stats(FuDevice *self);
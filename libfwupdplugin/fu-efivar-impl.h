@@ -37,3 +37,5 @@ gboolean
 fu_efivar_delete_with_glob_impl(const gchar *guid, const gchar *name_glob, GError **error);
 GPtrArray *
 fu_efivar_get_names_impl(const gchar *guid, GError **error);
+void
+fu_efivar_get_cache_stats_impl(guint64 *hits, guint64 *misses);
@@ -14,12 +14,121 @@
 #include <linux/fs.h>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "fwupd-error.h"
 
 #include "fu-common.h"
 #include "fu-efivar-impl.h"
 
+/* the kernel asks the firmware for the whole variable on each read(), which can take a few ms */
+typedef struct {
+	guint32 attr;
+	GBytes *blob;
+	ino_t ino;
+	off_t size;
+	struct timespec mtime;
+} FuEfivarCacheItem;
+
+G_LOCK_DEFINE_STATIC(fu_efivar_cache);
+static GHashTable *fu_efivar_cache_items = NULL; /* (element-type utf8 FuEfivarCacheItem) */
+static guint64 fu_efivar_cache_hits = 0;
+static guint64 fu_efivar_cache_misses = 0;
+
+static void
+fu_efivar_cache_item_free(FuEfivarCacheItem *item)
+{
+	g_bytes_unref(item->blob);
+	g_free(item);
+}
+
+static void
+fu_efivar_cache_invalidate(const gchar *fn)
+{
+	G_LOCK(fu_efivar_cache);
+	if (fu_efivar_cache_items != NULL)
+		g_hash_table_remove(fu_efivar_cache_items, fn);
+	G_UNLOCK(fu_efivar_cache);
+}
+
+static void
+fu_efivar_cache_insert(const gchar *fn, const struct stat *st, guint32 attr, GBytes *blob)
+{
+	FuEfivarCacheItem *item = g_new0(FuEfivarCacheItem, 1);
+
+	item->attr = attr;
+	item->blob = g_bytes_ref(blob);
+	item->ino = st->st_ino;
+	item->size = st->st_size;
+	item->mtime = st->st_mtim;
+	G_LOCK(fu_efivar_cache);
+	if (fu_efivar_cache_items == NULL) {
+		fu_efivar_cache_items =
+		    g_hash_table_new_full(g_str_hash,
+					  g_str_equal,
+					  g_free,
+					  (GDestroyNotify)fu_efivar_cache_item_free);
+	}
+	g_hash_table_insert(fu_efivar_cache_items, g_strdup(fn), item);
+	G_UNLOCK(fu_efivar_cache);
+}
+
+/* only returns the value if the file has not been written since it was read */
+static GBytes *
+fu_efivar_cache_lookup(const gchar *fn, guint32 *attr)
+{
+	FuEfivarCacheItem *item = NULL;
+	GBytes *blob = NULL;
+	struct stat st;
+	gboolean valid;
+
+	/* the inode is kept in memory by the kernel so this does not touch the firmware */
+	valid = stat(fn, &st) == 0;
+	G_LOCK(fu_efivar_cache);
+	if (fu_efivar_cache_items != NULL) {
+		item = g_hash_table_lookup(fu_efivar_cache_items, fn);
+		if (item != NULL && valid) {
+			valid = item->ino == st.st_ino && item->size == st.st_size &&
+				item->mtime.tv_sec == st.st_mtim.tv_sec &&
+				item->mtime.tv_nsec == st.st_mtim.tv_nsec;
+		}
+		if (item != NULL && !valid)
+			g_hash_table_remove(fu_efivar_cache_items, fn);
+	}
+	if (item != NULL && valid) {
+		*attr = item->attr;
+		blob = g_bytes_ref(item->blob);
+		fu_efivar_cache_hits++;
+	} else {
+		fu_efivar_cache_misses++;
+	}
+	G_UNLOCK(fu_efivar_cache);
+	return blob;
+}
+
+static void
+fu_efivar_cache_monitor_changed_cb(GFileMonitor *monitor,
+				   GFile *file,
+				   GFile *other_file,
+				   GFileMonitorEvent event_type,
+				   gpointer user_data)
+{
+	g_autofree gchar *fn = g_file_get_path(file);
+	fu_efivar_cache_invalidate(fn);
+}
+
+void
+fu_efivar_get_cache_stats_impl(guint64 *hits, guint64 *misses)
+{
+	G_LOCK(fu_efivar_cache);
+	if (hits != NULL)
+		*hits = fu_efivar_cache_hits;
+	if (misses != NULL)
+		*misses = fu_efivar_cache_misses;
+	G_UNLOCK(fu_efivar_cache);
+}
+
 static gchar *
 fu_efivar_get_path(void)
 {
@@ -143,6 +252,7 @@ fu_efivar_delete_impl(const gchar *guid, const gchar *name, GError **error)
 		g_prefix_error(error, "failed to set %s as mutable: ", fn);
 		return FALSE;
 	}
+	fu_efivar_cache_invalidate(fn);
 	return g_file_delete(file, NULL, error);
 }
 
@@ -166,6 +276,7 @@ fu_efivar_delete_with_glob_impl(const gchar *guid, const gchar *name_glob, GErro
 				g_prefix_error(error, "failed to set %s as mutable: ", keyfn);
 				return FALSE;
 			}
+			fu_efivar_cache_invalidate(keyfn);
 			if (!g_file_delete(file, NULL, error))
 				return FALSE;
 		}
@@ -203,6 +314,59 @@ fu_efivar_exists_impl(const gchar *guid, const gchar *name)
 	return g_file_test(fn, G_FILE_TEST_EXISTS);
 }
 
+static GBytes *
+fu_efivar_read_fd(gint fd, const gchar *fn, struct stat *st, guint32 *attr, GError **error)
+{
+	gsize bufsz = 0;
+	g_autofree guint8 *buf = NULL;
+	g_autoptr(GBytes) blob = NULL;
+
+	if (fstat(fd, st) < 0) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    g_io_error_from_errno(errno),
+			    "failed to stat %s: %s",
+			    fn,
+			    strerror(errno));
+		return NULL;
+	}
+	if (st->st_size < (off_t)sizeof(*attr)) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_INVALID_DATA,
+			    "efivars file too small: %" G_GUINT64_FORMAT,
+			    (guint64)st->st_size);
+		return NULL;
+	}
+
+	/* read the attributes and data in one go, as each read() goes to the firmware */
+	buf = g_malloc0(st->st_size);
+	while (bufsz < (gsize)st->st_size) {
+		gssize rc = read(fd, buf + bufsz, st->st_size - bufsz);
+		if (rc < 0 && errno == EINTR)
+			continue;
+		if (rc < 0) {
+			g_set_error(error,
+				    G_IO_ERROR,
+				    g_io_error_from_errno(errno),
+				    "failed to read %s: %s",
+				    fn,
+				    strerror(errno));
+			return NULL;
+		}
+		if (rc == 0)
+			break;
+		bufsz += rc;
+	}
+	if (bufsz <= sizeof(*attr)) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "no data to read");
+		return NULL;
+	}
+	memcpy(attr, buf, sizeof(*attr));
+	blob = g_bytes_new_take(g_steal_pointer(&buf), bufsz);
+	return g_bytes_new_from_bytes(blob, sizeof(*attr), bufsz - sizeof(*attr));
+}
+
 gboolean
 fu_efivar_get_data_impl(const gchar *guid,
 			const gchar *name,
@@ -211,65 +375,42 @@ fu_efivar_get_data_impl(const gchar *guid,
 			guint32 *attr,
 			GError **error)
 {
-	gssize attr_sz;
-	gssize data_sz_tmp;
-	guint32 attr_tmp;
-	guint64 sz;
-	g_autofree gchar *fn = NULL;
-	g_autoptr(GFile) file = NULL;
-	g_autoptr(GFileInfo) info = NULL;
-	g_autoptr(GInputStream) istr = NULL;
+	guint32 attr_tmp = 0;
+	g_autofree gchar *fn = fu_efivar_get_filename(guid, name);
+	g_autoptr(GBytes) blob = NULL;
 
-	/* open file as stream */
-	fn = fu_efivar_get_filename(guid, name);
-	file = g_file_new_for_path(fn);
-	istr = G_INPUT_STREAM(g_file_read(file, NULL, error));
-	if (istr == NULL)
-		return FALSE;
-	info = g_file_input_stream_query_info(G_FILE_INPUT_STREAM(istr),
-					      G_FILE_ATTRIBUTE_STANDARD_SIZE,
-					      NULL,
-					      error);
-	if (info == NULL) {
-		g_prefix_error(error, "failed to get stream info: ");
-		return FALSE;
-	}
+	/* read from the file if the variable is not cached or has changed */
+	blob = fu_efivar_cache_lookup(fn, &attr_tmp);
+	if (blob == NULL) {
+		gint fd;
+		struct stat st;
 
-	/* get total stream size */
-	sz = g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_STANDARD_SIZE);
-	if (sz < 4) {
-		g_set_error(error,
-			    G_IO_ERROR,
-			    G_IO_ERROR_INVALID_DATA,
-			    "efivars file too small: %" G_GUINT64_FORMAT,
-			    sz);
-		return FALSE;
+		fd = open(fn, O_RDONLY | O_CLOEXEC);
+		if (fd < 0) {
+			g_set_error(error,
+				    G_IO_ERROR,
+				    g_io_error_from_errno(errno),
+				    "failed to open %s: %s",
+				    fn,
+				    strerror(errno));
+			return FALSE;
+		}
+		blob = fu_efivar_read_fd(fd, fn, &st, &attr_tmp, error);
+		close(fd);
+		if (blob == NULL)
+			return FALSE;
+		fu_efivar_cache_insert(fn, &st, attr_tmp, blob);
 	}
 
-	/* read out the attributes */
-	attr_sz = g_input_stream_read(istr, &attr_tmp, sizeof(attr_tmp), NULL, error);
-	if (attr_sz == -1) {
-		g_prefix_error(error, "failed to read attr: ");
-		return FALSE;
-	}
+	/* success */
 	if (attr != NULL)
 		*attr = attr_tmp;
-
-	/* read out the data */
-	data_sz_tmp = sz - sizeof(attr_tmp);
-	if (data_sz_tmp == 0) {
-		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "no data to read");
-		return FALSE;
-	}
 	if (data_sz != NULL)
-		*data_sz = data_sz_tmp;
+		*data_sz = g_bytes_get_size(blob);
 	if (data != NULL) {
-		g_autofree guint8 *data_tmp = g_malloc0(data_sz_tmp);
-		if (!g_input_stream_read_all(istr, data_tmp, data_sz_tmp, NULL, NULL, error)) {
-			g_prefix_error(error, "failed to read data: ");
+		*data = fu_memdup_safe(g_bytes_get_data(blob, NULL), g_bytes_get_size(blob), error);
+		if (*data == NULL)
 			return FALSE;
-		}
-		*data = g_steal_pointer(&data_tmp);
 	}
 	return TRUE;
 }
@@ -318,6 +459,10 @@ fu_efivar_get_monitor_impl(const gchar *guid, const gchar *name, GError **error)
 	if (monitor == NULL)
 		return NULL;
 	g_file_monitor_set_rate_limit(monitor, 5000);
+	g_signal_connect(G_FILE_MONITOR(monitor),
+			 "changed",
+			 G_CALLBACK(fu_efivar_cache_monitor_changed_cb),
+			 NULL);
 	return g_steal_pointer(&monitor);
 }
 
@@ -369,6 +514,7 @@ fu_efivar_set_data_impl(const gchar *guid,
 	int fd;
 	int open_wflags;
 	gboolean was_immutable;
+	gssize wrote;
 	g_autofree gchar *fn = fu_efivar_get_filename(guid, name);
 	g_autofree guint8 *buf = g_malloc0(sizeof(guint32) + sz);
 	g_autoptr(GFile) file = g_file_new_for_path(fn);
@@ -407,7 +553,12 @@ fu_efivar_set_data_impl(const gchar *guid,
 	ostr = g_unix_output_stream_new(fd, TRUE);
 	memcpy(buf, &attr, sizeof(attr));
 	memcpy(buf + sizeof(attr), data, sz);
-	if (g_output_stream_write(ostr, buf, sizeof(attr) + sz, NULL, error) < 0) {
+	fu_efivar_cache_invalidate(fn);
+	wrote = g_output_stream_write(ostr, buf, sizeof(attr) + sz, NULL, error);
+
+	/* drop anything another thread cached while the write was in progress */
+	fu_efivar_cache_invalidate(fn);
+	if (wrote < 0) {
 		g_prefix_error(error, "failed to write data to efivarfs: ");
 		return FALSE;
 	}
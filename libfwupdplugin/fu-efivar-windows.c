@@ -106,3 +106,13 @@ fu_efivar_set_data_impl(const gchar *guid,
 			    "efivarfs not currently supported on Windows");
 	return FALSE;
 }
+
+void
+fu_efivar_get_cache_stats_impl(guint64 *hits, guint64 *misses)
+{
+	/* not cached */
+	if (hits != NULL)
+		*hits = 0;
+	if (misses != NULL)
+		*misses = 0;
+}
@@ -184,6 +184,22 @@ fu_efivar_get_monitor(const gchar *guid, const gchar *name, GError **error)
 	return fu_efivar_get_monitor_impl(guid, name, error);
 }
 
+/**
+ * fu_efivar_get_cache_stats:
+ * @hits: (out) (nullable): number of reads answered from the cache
+ * @misses: (out) (nullable): number of reads that had to go to the firmware
+ *
+ * Gets how effective the process-wide variable cache has been. Cached values are dropped when
+ * the variable is written, deleted or changed on disk.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_efivar_get_cache_stats(guint64 *hits, guint64 *misses)
+{
+	fu_efivar_get_cache_stats_impl(hits, misses);
+}
+
 /**
  * fu_efivar_space_used:
  * @error: (nullable): optional return location for an error
@@ -63,6 +63,8 @@ fu_efivar_delete_with_glob(const gchar *guid,
 			   GError **error) G_GNUC_WARN_UNUSED_RESULT;
 GPtrArray *
 fu_efivar_get_names(const gchar *guid, GError **error) G_GNUC_WARN_UNUSED_RESULT;
+void
+fu_efivar_get_cache_stats(guint64 *hits, guint64 *misses);
 gboolean
 fu_efivar_secure_boot_enabled(void);
 gboolean
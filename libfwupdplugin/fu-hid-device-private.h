@@ -0,0 +1,13 @@
+/*
+ * Copyright (C) 2017 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include "fu-hid-device.h"
+
+/* only used by the self tests, as the endpoints are normally autodetected */
+void
+fu_hid_device_set_ep_addr_out(FuHidDevice *self, guint8 ep_addr_out);
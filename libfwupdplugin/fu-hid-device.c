@@ -8,7 +8,9 @@
 
 #include "config.h"
 
-#include "fu-hid-device.h"
+#include "fu-device-private.h"
+#include "fu-hid-device-private.h"
+#include "fu-trace-private.h"
 
 #define FU_HID_REPORT_GET 0x01
 #define FU_HID_REPORT_SET 0x09
@@ -19,11 +21,23 @@
 
 #define FU_HID_DEVICE_RETRIES 10
 
+#define FU_HID_DEVICE_STATUS_INTERVAL_DEFAULT 1
+#define FU_HID_DEVICE_PIPELINE_DEPTH_DEFAULT  4
+
 /**
  * FuHidDevice:
  *
  * A Human Interface Device (HID) device.
  *
+ * When sending a stream of reports with fu_hid_device_set_reports() the flow control can be
+ * changed using these quirk keys:
+ *
+ * * `HidStatusInterval`: the number of reports to send before checking the device status, where
+ *   `0` only checks the status once all the reports have been sent; default `1`
+ * * `HidPipelineDepth`: the number of interrupt transfers to keep in flight; default `4`
+ *
+ * Subclasses that implement `->set_quirk_kv()` have to chain up for any keys they do not handle.
+ *
  * See also: [class@FuDevice], [class@FuUsbDevice]
  */
 
@@ -33,6 +47,8 @@ typedef struct {
 	guint8 ep_addr_out; /* only for _USE_INTERRUPT_TRANSFER */
 	gboolean interface_autodetect;
 	FuHidDeviceFlags flags;
+	guint status_interval;
+	guint pipeline_depth;
 } FuHidDevicePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuHidDevice, fu_hid_device, FU_TYPE_USB_DEVICE)
@@ -52,6 +68,33 @@ fu_hid_device_to_string(FuDevice *device, guint idt, GString *str)
 		fu_common_string_append_kx(str, idt, "EpAddrIn", priv->ep_addr_in);
 	if (priv->ep_addr_out != 0)
 		fu_common_string_append_kx(str, idt, "EpAddrOut", priv->ep_addr_out);
+	fu_common_string_append_ku(str, idt, "StatusInterval", priv->status_interval);
+	fu_common_string_append_ku(str, idt, "PipelineDepth", priv->pipeline_depth);
+}
+
+static gboolean
+fu_hid_device_set_quirk_kv(FuDevice *device, const gchar *key, const gchar *value, GError **error)
+{
+	FuHidDevice *self = FU_HID_DEVICE(device);
+	FuHidDevicePrivate *priv = GET_PRIVATE(self);
+	guint64 tmp = 0;
+
+	if (g_strcmp0(key, "HidStatusInterval") == 0) {
+		if (!fu_common_strtoull_full(value, &tmp, 0, G_MAXUINT, error))
+			return FALSE;
+		priv->status_interval = tmp;
+		return TRUE;
+	}
+	if (g_strcmp0(key, "HidPipelineDepth") == 0) {
+		if (!fu_common_strtoull_full(value, &tmp, 1, 64, error))
+			return FALSE;
+		priv->pipeline_depth = tmp;
+		return TRUE;
+	}
+
+	/* failed */
+	g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "quirk key not supported");
+	return FALSE;
 }
 
 static void
@@ -134,6 +177,10 @@ fu_hid_device_open(FuDevice *device, GError **error)
 	if (!FU_DEVICE_CLASS(fu_hid_device_parent_class)->open(device, error))
 		return FALSE;
 
+	/* all reports are loaded from the saved events */
+	if (fu_device_has_internal_flag(device, FU_DEVICE_INTERNAL_FLAG_EMULATED))
+		return TRUE;
+
 	/* auto-detect */
 	if (priv->interface_autodetect) {
 		g_autoptr(GPtrArray) ifaces = NULL;
@@ -187,6 +234,8 @@ fu_hid_device_close(FuDevice *device, GError **error)
 
 #ifdef HAVE_GUSB
 	/* release */
+	if (fu_device_has_internal_flag(device, FU_DEVICE_INTERNAL_FLAG_EMULATED))
+		return FU_DEVICE_CLASS(fu_hid_device_parent_class)->close(device, error);
 	if ((priv->flags & FU_HID_DEVICE_FLAG_NO_KERNEL_REBIND) == 0)
 		flags |= G_USB_DEVICE_CLAIM_INTERFACE_BIND_KERNEL_DRIVER;
 	if (!g_usb_device_release_interface(usb_device, priv->interface, flags, &error_local)) {
@@ -248,6 +297,15 @@ fu_hid_device_get_interface(FuHidDevice *self)
 	return priv->interface;
 }
 
+/* used by the self tests instead of autodetecting the endpoints */
+void
+fu_hid_device_set_ep_addr_out(FuHidDevice *self, guint8 ep_addr_out)
+{
+	FuHidDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_HID_DEVICE(self));
+	priv->ep_addr_out = ep_addr_out;
+}
+
 /**
  * fu_hid_device_add_flag:
  * @self: a #FuHidDevice
@@ -273,13 +331,15 @@ typedef struct {
 	FuHidDeviceFlags flags;
 } FuHidDeviceRetryHelper;
 
+#ifdef HAVE_GUSB
 static gboolean
-fu_hid_device_set_report_internal(FuHidDevice *self, FuHidDeviceRetryHelper *helper, GError **error)
+fu_hid_device_set_report_transfer(FuHidDevice *self,
+				  FuHidDeviceRetryHelper *helper,
+				  gsize *actual_len,
+				  GError **error)
 {
-#ifdef HAVE_GUSB
 	FuHidDevicePrivate *priv = GET_PRIVATE(self);
 	GUsbDevice *usb_device = fu_usb_device_get_dev(FU_USB_DEVICE(self));
-	gsize actual_len = 0;
 
 	/* what method do we use? */
 	if (priv->flags & FU_HID_DEVICE_FLAG_USE_INTERRUPT_TRANSFER) {
@@ -292,7 +352,7 @@ fu_hid_device_set_report_internal(FuHidDevice *self, FuHidDeviceRetryHelper *hel
 						     priv->ep_addr_out,
 						     helper->buf,
 						     helper->bufsz,
-						     &actual_len,
+						     actual_len,
 						     helper->timeout,
 						     NULL, /* cancellable */
 						     error)) {
@@ -321,7 +381,7 @@ fu_hid_device_set_report_internal(FuHidDevice *self, FuHidDeviceRetryHelper *hel
 						   priv->interface,
 						   helper->buf,
 						   helper->bufsz,
-						   &actual_len,
+						   actual_len,
 						   helper->timeout,
 						   NULL,
 						   error)) {
@@ -329,15 +389,61 @@ fu_hid_device_set_report_internal(FuHidDevice *self, FuHidDeviceRetryHelper *hel
 			return FALSE;
 		}
 	}
-	if ((helper->flags & FU_HID_DEVICE_FLAG_ALLOW_TRUNC) == 0 && actual_len != helper->bufsz) {
+	if ((helper->flags & FU_HID_DEVICE_FLAG_ALLOW_TRUNC) == 0 && *actual_len != helper->bufsz) {
 		g_set_error(error,
 			    G_IO_ERROR,
 			    G_IO_ERROR_INVALID_DATA,
 			    "wrote %" G_GSIZE_FORMAT ", requested %" G_GSIZE_FORMAT " bytes",
-			    actual_len,
+			    *actual_len,
 			    helper->bufsz);
 		return FALSE;
 	}
+	return TRUE;
+}
+#endif
+
+static gboolean
+fu_hid_device_set_report_internal(FuHidDevice *self, FuHidDeviceRetryHelper *helper, GError **error)
+{
+#ifdef HAVE_GUSB
+	gboolean ret;
+	gint64 start;
+	gsize actual_len = 0;
+	g_autofree gchar *event_id = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	/* emulated */
+	if (fu_device_has_internal_flag(FU_DEVICE(self), FU_DEVICE_INTERNAL_FLAG_EMULATED) ||
+	    fu_device_has_save_events(FU_DEVICE(self))) {
+		event_id = g_strdup_printf("HidSetReport:Value=0x%02x,Length=0x%x,Crc=0x%08x",
+					   helper->value,
+					   (guint)helper->bufsz,
+					   fu_common_crc32(helper->buf, helper->bufsz));
+	}
+	if (fu_device_has_internal_flag(FU_DEVICE(self), FU_DEVICE_INTERNAL_FLAG_EMULATED))
+		return fu_device_load_event(FU_DEVICE(self), event_id, error) != NULL;
+
+	FU_TRACE2(hid_set_report_entry, helper->value, helper->bufsz);
+	start = g_get_monotonic_time();
+	ret = fu_hid_device_set_report_transfer(self, helper, &actual_len, &error_local);
+	FU_TRACE3(hid_set_report_exit, helper->value, helper->bufsz, ret);
+	if (ret) {
+		fu_device_add_io_stats(FU_DEVICE(self),
+				       "HidSetReport",
+				       actual_len,
+				       g_get_monotonic_time() - start);
+	}
+
+	/* save, including any failure so that it is replayed too */
+	if (event_id != NULL) {
+		FuDeviceEvent *event = fu_device_save_event(FU_DEVICE(self), event_id);
+		fu_device_event_set_rc(event, actual_len);
+		fu_device_event_set_error(event, error_local);
+	}
+	if (error_local != NULL) {
+		g_propagate_error(error, g_steal_pointer(&error_local));
+		return FALSE;
+	}
 #endif
 	return TRUE;
 }
@@ -404,12 +510,128 @@ fu_hid_device_set_report(FuHidDevice *self,
 }
 
 static gboolean
-fu_hid_device_get_report_internal(FuHidDevice *self, FuHidDeviceRetryHelper *helper, GError **error)
+fu_hid_device_set_reports_window(FuHidDevice *self,
+				 guint8 value,
+				 GPtrArray *reports,
+				 guint timeout,
+				 FuHidDeviceFlags flags,
+				 FuProgress *progress,
+				 GError **error)
 {
+	FuHidDevicePrivate *priv = GET_PRIVATE(self);
+
+	/* stream them all without waiting for each to complete, unless each report has to be
+	 * saved or loaded as a device event */
+	if ((flags & FU_HID_DEVICE_FLAG_USE_INTERRUPT_TRANSFER) && priv->ep_addr_out != 0 &&
+	    (flags & FU_HID_DEVICE_FLAG_RETRY_FAILURE) == 0 &&
+	    !fu_device_has_internal_flag(FU_DEVICE(self), FU_DEVICE_INTERNAL_FLAG_EMULATED) &&
+	    !fu_device_has_save_events(FU_DEVICE(self))) {
+		return fu_usb_device_interrupt_transfer_chunks(FU_USB_DEVICE(self),
+							       priv->ep_addr_out,
+							       reports,
+							       priv->pipeline_depth,
+							       timeout,
+							       NULL,
+							       NULL,
+							       progress,
+							       error);
+	}
+
+	/* one at a time */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, reports->len);
+	for (guint i = 0; i < reports->len; i++) {
+		FuChunk *chk = g_ptr_array_index(reports, i);
+		if (!fu_hid_device_set_report(self,
+					      value,
+					      (guint8 *)fu_chunk_get_data(chk),
+					      fu_chunk_get_data_sz(chk),
+					      timeout,
+					      flags,
+					      error))
+			return FALSE;
+		fu_progress_step_done(progress);
+	}
+	return TRUE;
+}
+
+/**
+ * fu_hid_device_set_reports:
+ * @self: a #FuHidDevice
+ * @value: low byte of wValue, but unused when using %FU_HID_DEVICE_FLAG_USE_INTERRUPT_TRANSFER
+ * @reports: (element-type FuChunk): reports to send
+ * @timeout: timeout in ms
+ * @flags: HID device flags e.g. %FU_HID_DEVICE_FLAG_ALLOW_TRUNC
+ * @func: (scope call) (nullable): function to check the device status
+ * @user_data: user data for @func
+ * @progress: a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Calls SetReport on the hardware for each report, calling @func after every `HidStatusInterval`
+ * reports and once more for any remaining reports.
+ *
+ * If using %FU_HID_DEVICE_FLAG_USE_INTERRUPT_TRANSFER then the reports between each status check
+ * are queued without waiting for the previous report to complete.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fu_hid_device_set_reports(FuHidDevice *self,
+			  guint8 value,
+			  GPtrArray *reports,
+			  guint timeout,
+			  FuHidDeviceFlags flags,
+			  FuHidDeviceStatusFunc func,
+			  gpointer user_data,
+			  FuProgress *progress,
+			  GError **error)
+{
+	FuHidDevicePrivate *priv = GET_PRIVATE(self);
+	guint interval;
+	guint windows;
+
+	g_return_val_if_fail(FU_IS_HID_DEVICE(self), FALSE);
+	g_return_val_if_fail(reports != NULL, FALSE);
+	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* split into windows, with a status check after each */
+	interval = priv->status_interval > 0 ? priv->status_interval : MAX(reports->len, 1);
+	windows = (reports->len + interval - 1) / interval;
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, windows);
+	for (guint i = 0; i < windows; i++) {
+		g_autoptr(GPtrArray) window = g_ptr_array_new();
+		for (guint j = i * interval; j < MIN((i + 1) * interval, reports->len); j++)
+			g_ptr_array_add(window, g_ptr_array_index(reports, j));
+		if (!fu_hid_device_set_reports_window(self,
+						      value,
+						      window,
+						      timeout,
+						      priv->flags | flags,
+						      fu_progress_get_child(progress),
+						      error))
+			return FALSE;
+		if (func != NULL && !func(self, window->len, user_data, error))
+			return FALSE;
+		fu_progress_step_done(progress);
+	}
+
+	/* success */
+	return TRUE;
+}
+
 #ifdef HAVE_GUSB
+static gboolean
+fu_hid_device_get_report_transfer(FuHidDevice *self,
+				  FuHidDeviceRetryHelper *helper,
+				  gsize *actual_len,
+				  GError **error)
+{
 	FuHidDevicePrivate *priv = GET_PRIVATE(self);
 	GUsbDevice *usb_device = fu_usb_device_get_dev(FU_USB_DEVICE(self));
-	gsize actual_len = 0;
 
 	/* what method do we use? */
 	if (priv->flags & FU_HID_DEVICE_FLAG_USE_INTERRUPT_TRANSFER) {
@@ -417,7 +639,7 @@ fu_hid_device_get_report_internal(FuHidDevice *self, FuHidDeviceRetryHelper *hel
 						     priv->ep_addr_in,
 						     helper->buf,
 						     helper->bufsz,
-						     &actual_len,
+						     actual_len,
 						     helper->timeout,
 						     NULL, /* cancellable */
 						     error)) {
@@ -440,7 +662,7 @@ fu_hid_device_get_report_internal(FuHidDevice *self, FuHidDeviceRetryHelper *hel
 			title = g_strdup_printf("HID::GetReport [wValue=0x%04x, wIndex=%u]",
 						wvalue,
 						priv->interface);
-			fu_common_dump_raw(G_LOG_DOMAIN, title, helper->buf, actual_len);
+			fu_common_dump_raw(G_LOG_DOMAIN, title, helper->buf, *actual_len);
 		}
 		if (!g_usb_device_control_transfer(usb_device,
 						   G_USB_DEVICE_DIRECTION_DEVICE_TO_HOST,
@@ -451,7 +673,7 @@ fu_hid_device_get_report_internal(FuHidDevice *self, FuHidDeviceRetryHelper *hel
 						   priv->interface,
 						   helper->buf,
 						   helper->bufsz,
-						   &actual_len, /* actual length */
+						   actual_len, /* actual length */
 						   helper->timeout,
 						   NULL,
 						   error)) {
@@ -463,18 +685,69 @@ fu_hid_device_get_report_internal(FuHidDevice *self, FuHidDeviceRetryHelper *hel
 			title = g_strdup_printf("HID::GetReport [wValue=0x%04x, wIndex=%u]",
 						wvalue,
 						priv->interface);
-			fu_common_dump_raw(G_LOG_DOMAIN, title, helper->buf, actual_len);
+			fu_common_dump_raw(G_LOG_DOMAIN, title, helper->buf, *actual_len);
 		}
 	}
-	if ((helper->flags & FU_HID_DEVICE_FLAG_ALLOW_TRUNC) == 0 && actual_len != helper->bufsz) {
+	if ((helper->flags & FU_HID_DEVICE_FLAG_ALLOW_TRUNC) == 0 && *actual_len != helper->bufsz) {
 		g_set_error(error,
 			    G_IO_ERROR,
 			    G_IO_ERROR_INVALID_DATA,
 			    "read %" G_GSIZE_FORMAT ", requested %" G_GSIZE_FORMAT " bytes",
-			    actual_len,
+			    *actual_len,
 			    helper->bufsz);
 		return FALSE;
 	}
+	return TRUE;
+}
+#endif
+
+static gboolean
+fu_hid_device_get_report_internal(FuHidDevice *self, FuHidDeviceRetryHelper *helper, GError **error)
+{
+#ifdef HAVE_GUSB
+	gboolean ret;
+	gint64 start;
+	gsize actual_len = 0;
+	g_autofree gchar *event_id = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	/* emulated */
+	if (fu_device_has_internal_flag(FU_DEVICE(self), FU_DEVICE_INTERNAL_FLAG_EMULATED) ||
+	    fu_device_has_save_events(FU_DEVICE(self))) {
+		event_id = g_strdup_printf("HidGetReport:Value=0x%02x,Length=0x%x",
+					   helper->value,
+					   (guint)helper->bufsz);
+	}
+	if (fu_device_has_internal_flag(FU_DEVICE(self), FU_DEVICE_INTERNAL_FLAG_EMULATED)) {
+		FuDeviceEvent *event = fu_device_load_event(FU_DEVICE(self), event_id, error);
+		if (event == NULL)
+			return FALSE;
+		return fu_device_event_copy_data(event, helper->buf, helper->bufsz, error);
+	}
+
+	FU_TRACE2(hid_get_report_entry, helper->value, helper->bufsz);
+	start = g_get_monotonic_time();
+	ret = fu_hid_device_get_report_transfer(self, helper, &actual_len, &error_local);
+	FU_TRACE3(hid_get_report_exit, helper->value, helper->bufsz, ret);
+	if (ret) {
+		fu_device_add_io_stats(FU_DEVICE(self),
+				       "HidGetReport",
+				       actual_len,
+				       g_get_monotonic_time() - start);
+	}
+
+	/* save, including any failure so that it is replayed too */
+	if (event_id != NULL) {
+		FuDeviceEvent *event = fu_device_save_event(FU_DEVICE(self), event_id);
+		fu_device_event_set_rc(event, actual_len);
+		if (error_local == NULL)
+			fu_device_event_set_data_raw(event, helper->buf, actual_len);
+		fu_device_event_set_error(event, error_local);
+	}
+	if (error_local != NULL) {
+		g_propagate_error(error, g_steal_pointer(&error_local));
+		return FALSE;
+	}
 #endif
 	return TRUE;
 }
@@ -545,6 +818,8 @@ fu_hid_device_init(FuHidDevice *self)
 {
 	FuHidDevicePrivate *priv = GET_PRIVATE(self);
 	priv->interface_autodetect = TRUE;
+	priv->status_interval = FU_HID_DEVICE_STATUS_INTERVAL_DEFAULT;
+	priv->pipeline_depth = FU_HID_DEVICE_PIPELINE_DEPTH_DEFAULT;
 }
 
 /**
@@ -577,6 +852,7 @@ fu_hid_device_class_init(FuHidDeviceClass *klass)
 	klass_device->open = fu_hid_device_open;
 	klass_device->close = fu_hid_device_close;
 	klass_device->to_string = fu_hid_device_to_string;
+	klass_device->set_quirk_kv = fu_hid_device_set_quirk_kv;
 
 	/**
 	 * FuHidDevice:interface:
@@ -42,6 +42,22 @@ typedef enum {
 	FU_HID_DEVICE_FLAG_LAST
 } FuHidDeviceFlags;
 
+/**
+ * FuHidDeviceStatusFunc:
+ * @self: a #FuHidDevice
+ * @count: the number of reports sent since the last status check
+ * @user_data: user data
+ * @error: (nullable): optional return location for an error
+ *
+ * The callback used to check the device status after a number of reports have been sent.
+ *
+ * Returns: %TRUE on success
+ */
+typedef gboolean (*FuHidDeviceStatusFunc)(FuHidDevice *self,
+					  guint count,
+					  gpointer user_data,
+					  GError **error) G_GNUC_WARN_UNUSED_RESULT;
+
 FuHidDevice *
 fu_hid_device_new(GUsbDevice *usb_device);
 void
@@ -59,6 +75,16 @@ fu_hid_device_set_report(FuHidDevice *self,
 			 FuHidDeviceFlags flags,
 			 GError **error) G_GNUC_WARN_UNUSED_RESULT;
 gboolean
+fu_hid_device_set_reports(FuHidDevice *self,
+			  guint8 value,
+			  GPtrArray *reports,
+			  guint timeout,
+			  FuHidDeviceFlags flags,
+			  FuHidDeviceStatusFunc func,
+			  gpointer user_data,
+			  FuProgress *progress,
+			  GError **error) G_GNUC_WARN_UNUSED_RESULT;
+gboolean
 fu_hid_device_get_report(FuHidDevice *self,
 			 guint8 value,
 			 guint8 *buf,
@@ -21,6 +21,7 @@
 #include "fwupd-error.h"
 
 #include "fu-common.h"
+#include "fu-device.h"
 #include "fu-io-channel.h"
 
 /**
@@ -32,10 +33,41 @@
 struct _FuIOChannel {
 	GObject parent_instance;
 	gint fd;
+	FuDevice *device; /* (nullable) (noref) */
 };
 
 G_DEFINE_TYPE(FuIOChannel, fu_io_channel, G_TYPE_OBJECT)
 
+static void
+fu_io_channel_add_io_stats(FuIOChannel *self, const gchar *kind, gsize length, gint64 start)
+{
+	if (self->device == NULL)
+		return;
+	fu_device_add_io_stats(self->device, kind, length, g_get_monotonic_time() - start);
+}
+
+/**
+ * fu_io_channel_set_device:
+ * @self: a #FuIOChannel
+ * @device: (nullable): a #FuDevice
+ *
+ * Sets the device that owns the channel, so that the number of bytes and the latency of each
+ * read and write can be recorded using fu_device_add_io_stats().
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_io_channel_set_device(FuIOChannel *self, FuDevice *device)
+{
+	g_return_if_fail(FU_IS_IO_CHANNEL(self));
+	g_return_if_fail(device == NULL || FU_IS_DEVICE(device));
+	if (self->device != NULL)
+		g_object_remove_weak_pointer(G_OBJECT(self->device), (gpointer *)&self->device);
+	self->device = device;
+	if (self->device != NULL)
+		g_object_add_weak_pointer(G_OBJECT(self->device), (gpointer *)&self->device);
+}
+
 /**
  * fu_io_channel_unix_get_fd:
  * @self: a #FuIOChannel
@@ -164,6 +196,7 @@ fu_io_channel_write_raw(FuIOChannel *self,
 			FuIOChannelFlags flags,
 			GError **error)
 {
+	gint64 start = g_get_monotonic_time();
 	gsize idx = 0;
 
 	g_return_val_if_fail(FU_IS_IO_CHANNEL(self), FALSE);
@@ -196,6 +229,7 @@ fu_io_channel_write_raw(FuIOChannel *self,
 				    datasz);
 			return FALSE;
 		}
+		fu_io_channel_add_io_stats(self, "IoChannelWrite", datasz, start);
 		return TRUE;
 	}
 
@@ -251,6 +285,7 @@ fu_io_channel_write_raw(FuIOChannel *self,
 		}
 	}
 
+	fu_io_channel_add_io_stats(self, "IoChannelWrite", idx, start);
 	return TRUE;
 }
 
@@ -306,6 +341,7 @@ fu_io_channel_read_byte_array(FuIOChannel *self,
 	    .fd = self->fd,
 	    .events = G_IO_IN | G_IO_PRI | G_IO_ERR,
 	};
+	gint64 start = g_get_monotonic_time();
 	g_autoptr(GByteArray) buf2 = g_byte_array_new();
 
 	g_return_val_if_fail(FU_IS_IO_CHANNEL(self), NULL);
@@ -325,6 +361,7 @@ fu_io_channel_read_byte_array(FuIOChannel *self,
 		}
 		if (len > 0)
 			g_byte_array_append(buf2, buf, len);
+		fu_io_channel_add_io_stats(self, "IoChannelRead", buf2->len, start);
 		return g_steal_pointer(&buf2);
 	}
 
@@ -408,6 +445,7 @@ fu_io_channel_read_byte_array(FuIOChannel *self,
 	}
 
 	/* return blob */
+	fu_io_channel_add_io_stats(self, "IoChannelRead", buf2->len, start);
 	return g_steal_pointer(&buf2);
 }
 
@@ -457,6 +495,8 @@ static void
 fu_io_channel_finalize(GObject *object)
 {
 	FuIOChannel *self = FU_IO_CHANNEL(object);
+	if (self->device != NULL)
+		g_object_remove_weak_pointer(G_OBJECT(self->device), (gpointer *)&self->device);
 	if (self->fd != -1)
 		g_close(self->fd, NULL);
 	G_OBJECT_CLASS(fu_io_channel_parent_class)->finalize(object);
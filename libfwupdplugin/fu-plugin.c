@@ -19,6 +19,7 @@
 #include "fu-device-private.h"
 #include "fu-mutex.h"
 #include "fu-plugin-private.h"
+#include "fu-trace-private.h"
 
 /**
  * FuPlugin:
@@ -794,6 +795,7 @@ fu_plugin_device_read_firmware(FuPlugin *self,
 gboolean
 fu_plugin_runner_startup(FuPlugin *self, GError **error)
 {
+	gboolean ret;
 	FuPluginPrivate *priv = GET_PRIVATE(self);
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
 	g_autofree gchar *config_filename = fu_plugin_get_config_filename(self);
@@ -808,7 +810,10 @@ fu_plugin_runner_startup(FuPlugin *self, GError **error)
 	if (vfuncs->startup == NULL)
 		return TRUE;
 	g_debug("startup(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->startup(self, &error_local)) {
+	FU_TRACE2(plugin_vfunc_entry, fu_plugin_get_name(self), "startup");
+	ret = vfuncs->startup(self, &error_local);
+	FU_TRACE3(plugin_vfunc_exit, fu_plugin_get_name(self), "startup", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in startup(%s)", fu_plugin_get_name(self));
 			g_set_error_literal(&error_local,
@@ -843,6 +848,7 @@ fu_plugin_runner_device_generic(FuPlugin *self,
 				FuPluginDeviceFunc device_func,
 				GError **error)
 {
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	/* not enabled */
@@ -853,7 +859,10 @@ fu_plugin_runner_device_generic(FuPlugin *self,
 	if (device_func == NULL)
 		return TRUE;
 	g_debug("%s(%s)", symbol_name + 10, fu_plugin_get_name(self));
-	if (!device_func(self, device, &error_local)) {
+	FU_TRACE2(plugin_vfunc_entry, fu_plugin_get_name(self), symbol_name + 10);
+	ret = device_func(self, device, &error_local);
+	FU_TRACE3(plugin_vfunc_exit, fu_plugin_get_name(self), symbol_name + 10, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in %s(%s)",
 				   fu_plugin_get_name(self),
@@ -881,6 +890,7 @@ fu_plugin_runner_device_generic_progress(FuPlugin *self,
 					 FuPluginDeviceProgressFunc device_func,
 					 GError **error)
 {
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	/* not enabled */
@@ -891,7 +901,10 @@ fu_plugin_runner_device_generic_progress(FuPlugin *self,
 	if (device_func == NULL)
 		return TRUE;
 	g_debug("%s(%s)", symbol_name + 10, fu_plugin_get_name(self));
-	if (!device_func(self, device, progress, &error_local)) {
+	FU_TRACE2(plugin_vfunc_entry, fu_plugin_get_name(self), symbol_name + 10);
+	ret = device_func(self, device, progress, &error_local);
+	FU_TRACE3(plugin_vfunc_exit, fu_plugin_get_name(self), symbol_name + 10, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in %s(%s)",
 				   fu_plugin_get_name(self),
@@ -919,6 +932,7 @@ fu_plugin_runner_flagged_device_generic(FuPlugin *self,
 					FuPluginFlaggedDeviceFunc func,
 					GError **error)
 {
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	/* not enabled */
@@ -929,7 +943,10 @@ fu_plugin_runner_flagged_device_generic(FuPlugin *self,
 	if (func == NULL)
 		return TRUE;
 	g_debug("%s(%s)", symbol_name + 10, fu_plugin_get_name(self));
-	if (!func(self, device, flags, &error_local)) {
+	FU_TRACE2(plugin_vfunc_entry, fu_plugin_get_name(self), symbol_name + 10);
+	ret = func(self, device, flags, &error_local);
+	FU_TRACE3(plugin_vfunc_exit, fu_plugin_get_name(self), symbol_name + 10, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in %s(%s)",
 				   fu_plugin_get_name(self),
@@ -956,6 +973,7 @@ fu_plugin_runner_device_array_generic(FuPlugin *self,
 				      FuPluginDeviceArrayFunc func,
 				      GError **error)
 {
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	/* not enabled */
@@ -966,7 +984,10 @@ fu_plugin_runner_device_array_generic(FuPlugin *self,
 	if (func == NULL)
 		return TRUE;
 	g_debug("%s(%s)", symbol_name + 10, fu_plugin_get_name(self));
-	if (!func(self, devices, &error_local)) {
+	FU_TRACE2(plugin_vfunc_entry, fu_plugin_get_name(self), symbol_name + 10);
+	ret = func(self, devices, &error_local);
+	FU_TRACE3(plugin_vfunc_exit, fu_plugin_get_name(self), symbol_name + 10, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in for %s(%s)",
 				   fu_plugin_get_name(self),
@@ -1000,6 +1021,7 @@ fu_plugin_runner_device_array_generic(FuPlugin *self,
 gboolean
 fu_plugin_runner_coldplug(FuPlugin *self, GError **error)
 {
+	gboolean ret;
 	FuPluginPrivate *priv = GET_PRIVATE(self);
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
 	g_autoptr(GError) error_local = NULL;
@@ -1016,7 +1038,10 @@ fu_plugin_runner_coldplug(FuPlugin *self, GError **error)
 	if (vfuncs->coldplug == NULL)
 		return TRUE;
 	g_debug("coldplug(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->coldplug(self, &error_local)) {
+	FU_TRACE2(plugin_vfunc_entry, fu_plugin_get_name(self), "coldplug");
+	ret = vfuncs->coldplug(self, &error_local);
+	FU_TRACE3(plugin_vfunc_exit, fu_plugin_get_name(self), "coldplug", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in coldplug(%s)", fu_plugin_get_name(self));
 			g_set_error_literal(&error_local,
@@ -1453,6 +1478,7 @@ fu_plugin_backend_device_added(FuPlugin *self, FuDevice *device, GError **error)
 gboolean
 fu_plugin_runner_backend_device_added(FuPlugin *self, FuDevice *device, GError **error)
 {
+	gboolean ret;
 	FuPluginPrivate *priv = GET_PRIVATE(self);
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
 	g_autoptr(GError) error_local = NULL;
@@ -1478,7 +1504,10 @@ fu_plugin_runner_backend_device_added(FuPlugin *self, FuDevice *device, GError *
 		return FALSE;
 	}
 	g_debug("backend_device_added(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->backend_device_added(self, device, &error_local)) {
+	FU_TRACE2(plugin_vfunc_entry, fu_plugin_get_name(self), "backend_device_added");
+	ret = vfuncs->backend_device_added(self, device, &error_local);
+	FU_TRACE3(plugin_vfunc_exit, fu_plugin_get_name(self), "backend_device_added", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in backend_device_added(%s)",
 				   fu_plugin_get_name(self));
@@ -1511,6 +1540,7 @@ fu_plugin_runner_backend_device_added(FuPlugin *self, FuDevice *device, GError *
 gboolean
 fu_plugin_runner_backend_device_changed(FuPlugin *self, FuDevice *device, GError **error)
 {
+	gboolean ret;
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
 	g_autoptr(GError) error_local = NULL;
 
@@ -1526,7 +1556,10 @@ fu_plugin_runner_backend_device_changed(FuPlugin *self, FuDevice *device, GError
 	if (vfuncs->backend_device_changed == NULL)
 		return TRUE;
 	g_debug("udev_device_changed(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->backend_device_changed(self, device, &error_local)) {
+	FU_TRACE2(plugin_vfunc_entry, fu_plugin_get_name(self), "backend_device_changed");
+	ret = vfuncs->backend_device_changed(self, device, &error_local);
+	FU_TRACE3(plugin_vfunc_exit, fu_plugin_get_name(self), "backend_device_changed", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in udev_device_changed(%s)",
 				   fu_plugin_get_name(self));
@@ -1633,6 +1666,7 @@ gboolean
 fu_plugin_runner_device_created(FuPlugin *self, FuDevice *device, GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
 	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
@@ -1646,7 +1680,10 @@ fu_plugin_runner_device_created(FuPlugin *self, FuDevice *device, GError **error
 	if (vfuncs->device_created == NULL)
 		return TRUE;
 	g_debug("fu_plugin_device_created(%s)", fu_plugin_get_name(self));
-	return vfuncs->device_created(self, device, error);
+	FU_TRACE2(plugin_vfunc_entry, fu_plugin_get_name(self), "device_created");
+	ret = vfuncs->device_created(self, device, error);
+	FU_TRACE3(plugin_vfunc_exit, fu_plugin_get_name(self), "device_created", ret);
+	return ret;
 }
 
 /**
@@ -1670,6 +1707,7 @@ fu_plugin_runner_verify(FuPlugin *self,
 			FuPluginVerifyFlags flags,
 			GError **error)
 {
+	gboolean ret;
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
 	GPtrArray *checksums;
 	g_autoptr(GError) error_local = NULL;
@@ -1712,7 +1750,10 @@ fu_plugin_runner_verify(FuPlugin *self,
 
 	/* run vfunc */
 	g_debug("verify(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->verify(self, device, flags, &error_local)) {
+	FU_TRACE2(plugin_vfunc_entry, fu_plugin_get_name(self), "verify");
+	ret = vfuncs->verify(self, device, flags, &error_local);
+	FU_TRACE3(plugin_vfunc_exit, fu_plugin_get_name(self), "verify", ret);
+	if (!ret) {
 		g_autoptr(GError) error_attach = NULL;
 		if (error_local == NULL) {
 			g_critical("unset plugin error in verify(%s)", fu_plugin_get_name(self));
@@ -1874,6 +1915,7 @@ fu_plugin_runner_write_firmware(FuPlugin *self,
 				FwupdInstallFlags flags,
 				GError **error)
 {
+	gboolean ret;
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
 	g_autoptr(GError) error_local = NULL;
 
@@ -1900,7 +1942,10 @@ fu_plugin_runner_write_firmware(FuPlugin *self,
 	}
 
 	/* online */
-	if (!vfuncs->write_firmware(self, device, blob_fw, progress, flags, &error_local)) {
+	FU_TRACE2(plugin_vfunc_entry, fu_plugin_get_name(self), "write_firmware");
+	ret = vfuncs->write_firmware(self, device, blob_fw, progress, flags, &error_local);
+	FU_TRACE3(plugin_vfunc_exit, fu_plugin_get_name(self), "write_firmware", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in update(%s)", fu_plugin_get_name(self));
 			g_set_error_literal(&error_local,
@@ -1940,6 +1985,7 @@ fu_plugin_runner_write_firmware(FuPlugin *self,
 gboolean
 fu_plugin_runner_clear_results(FuPlugin *self, FuDevice *device, GError **error)
 {
+	gboolean ret;
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
 	g_autoptr(GError) error_local = NULL;
 
@@ -1955,7 +2001,10 @@ fu_plugin_runner_clear_results(FuPlugin *self, FuDevice *device, GError **error)
 	if (vfuncs->clear_results == NULL)
 		return TRUE;
 	g_debug("clear_result(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->clear_results(self, device, &error_local)) {
+	FU_TRACE2(plugin_vfunc_entry, fu_plugin_get_name(self), "clear_results");
+	ret = vfuncs->clear_results(self, device, &error_local);
+	FU_TRACE3(plugin_vfunc_exit, fu_plugin_get_name(self), "clear_results", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in clear_result(%s)",
 				   fu_plugin_get_name(self));
@@ -1988,6 +2037,7 @@ fu_plugin_runner_clear_results(FuPlugin *self, FuDevice *device, GError **error)
 gboolean
 fu_plugin_runner_get_results(FuPlugin *self, FuDevice *device, GError **error)
 {
+	gboolean ret;
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
 	g_autoptr(GError) error_local = NULL;
 
@@ -2005,7 +2055,10 @@ fu_plugin_runner_get_results(FuPlugin *self, FuDevice *device, GError **error)
 		return fu_plugin_device_get_results(self, device, error);
 	}
 	g_debug("get_results(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->get_results(self, device, &error_local)) {
+	FU_TRACE2(plugin_vfunc_entry, fu_plugin_get_name(self), "get_results");
+	ret = vfuncs->get_results(self, device, &error_local);
+	FU_TRACE3(plugin_vfunc_exit, fu_plugin_get_name(self), "get_results", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in get_results(%s)",
 				   fu_plugin_get_name(self));
@@ -240,6 +240,9 @@ typedef struct {
 	 *
 	 * Function that asks plugins to add Host Security Attributes.
 	 *
+	 * This is called from a worker thread, at the same time as other plugins are
+	 * adding their own attributes.
+	 *
 	 * Since: 1.7.2
 	 **/
 	void (*add_security_attrs)(FuPlugin *self, FuSecurityAttrs *attrs);
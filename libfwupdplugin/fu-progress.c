@@ -34,6 +34,13 @@
  * There are a few nice touches in this module, so that if a module only has
  * one progress step, the child progress is used for parent updates.
  *
+ * The percentage is updated atomically and the step state is protected by a mutex, so
+ * fu_progress_set_percentage() and fu_progress_set_percentage_full() can be called from worker
+ * threads while another thread is reading the progress. The signals are emitted in the calling
+ * thread, and each #FuProgress should only have steps added and done by one thread at a time.
+ * Callers updating the progress very frequently may want to use
+ * fu_progress_set_throttle() to limit how often the signal is emitted.
+ *
  *    static void
  *    _do_something(FuProgress *self)
  *    {
@@ -59,10 +66,17 @@
 typedef struct {
 	gchar *id;
 	FuProgressFlags flags;
-	guint percentage;
+	guint percentage;	  /* atomic */
+	guint percentage_emitted; /* atomic */
 	FwupdStatus status;
+	GMutex mutex; /* protects the steps, child, times and bytes */
 	GPtrArray *steps;
 	gboolean profile;
+	guint throttle;	  /* ms */
+	guint emitted_ms; /* atomic */
+	gint64 started;	  /* us */
+	gsize bytes_done;
+	gsize bytes_total;
 	GTimer *timer;
 	guint step_now;
 	guint step_max;
@@ -75,7 +89,9 @@ typedef struct {
 typedef struct {
 	FwupdStatus status;
 	guint value;
+	guint value_cumulative; /* including this step */
 	gdouble profile;
+	gsize bytes;
 } FuProgressStep;
 
 enum { SIGNAL_PERCENTAGE_CHANGED, SIGNAL_STATUS_CHANGED, SIGNAL_LAST };
@@ -275,10 +291,12 @@ guint
 fu_progress_get_percentage(FuProgress *self)
 {
 	FuProgressPrivate *priv = GET_PRIVATE(self);
+	guint percentage;
 	g_return_val_if_fail(FU_IS_PROGRESS(self), G_MAXUINT);
-	if (priv->percentage == G_MAXUINT)
+	percentage = g_atomic_int_get(&priv->percentage);
+	if (percentage == G_MAXUINT)
 		return 0;
-	return priv->percentage;
+	return percentage;
 }
 
 static void
@@ -295,6 +313,35 @@ fu_progress_build_parent_chain(FuProgress *self, GString *str, guint level)
 			       priv->step_max);
 }
 
+static void
+fu_progress_emit_percentage(FuProgress *self, guint percentage)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	guint percentage_emitted;
+
+	/* only one thread emits each value, and never one older than already emitted */
+	do {
+		percentage_emitted = g_atomic_int_get(&priv->percentage_emitted);
+		if (percentage_emitted != G_MAXUINT && percentage <= percentage_emitted)
+			return;
+	} while (!g_atomic_int_compare_and_exchange(&priv->percentage_emitted,
+						    percentage_emitted,
+						    percentage));
+	if (priv->throttle > 0)
+		g_atomic_int_set(&priv->emitted_ms, (guint)(g_get_monotonic_time() / 1000));
+	g_signal_emit(self, signals[SIGNAL_PERCENTAGE_CHANGED], 0, percentage);
+}
+
+/* emit the last percentage if it was held back by the throttle */
+static void
+fu_progress_flush(FuProgress *self)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	guint percentage = g_atomic_int_get(&priv->percentage);
+	if (percentage != G_MAXUINT)
+		fu_progress_emit_percentage(self, percentage);
+}
+
 /**
  * fu_progress_set_percentage:
  * @self: a #FuProgress
@@ -310,29 +357,49 @@ void
 fu_progress_set_percentage(FuProgress *self, guint percentage)
 {
 	FuProgressPrivate *priv = GET_PRIVATE(self);
+	guint percentage_old;
+
 	g_return_if_fail(FU_IS_PROGRESS(self));
 	g_return_if_fail(percentage <= 100);
 
-	/* is it the same */
-	if (percentage == priv->percentage)
-		return;
-
-	/* is it less */
-	if (priv->percentage != G_MAXUINT && percentage < priv->percentage) {
-		if (priv->profile) {
-			g_autoptr(GString) str = g_string_new(NULL);
-			fu_progress_build_parent_chain(self, str, 0);
-			g_warning("percentage should not go down from %u to %u: %s",
-				  priv->percentage,
-				  percentage,
-				  str->str);
+	/* save, retrying if another thread got there first */
+	do {
+		percentage_old = g_atomic_int_get(&priv->percentage);
+
+		/* is it the same */
+		if (percentage == percentage_old)
+			return;
+
+		/* is it less */
+		if (percentage_old != G_MAXUINT && percentage < percentage_old) {
+			if (priv->profile) {
+				g_autoptr(GString) str = g_string_new(NULL);
+				fu_progress_build_parent_chain(self, str, 0);
+				g_warning("percentage should not go down from %u to %u: %s",
+					  percentage_old,
+					  percentage,
+					  str->str);
+			}
+			return;
 		}
-		return;
+	} while (!g_atomic_int_compare_and_exchange(&priv->percentage, percentage_old, percentage));
+
+	/* used for the ETA and throughput */
+	if (percentage_old == G_MAXUINT) {
+		g_mutex_lock(&priv->mutex);
+		priv->started = g_get_monotonic_time();
+		g_mutex_unlock(&priv->mutex);
 	}
 
-	/* save */
-	priv->percentage = percentage;
-	g_signal_emit(self, signals[SIGNAL_PERCENTAGE_CHANGED], 0, percentage);
+	/* the first and last values are always emitted, and anything held back is emitted by
+	 * fu_progress_flush() when the step is done */
+	if (priv->throttle > 0 && percentage != 0 && percentage != 100) {
+		guint now_ms = (guint)(g_get_monotonic_time() / 1000);
+		guint emitted_ms = g_atomic_int_get(&priv->emitted_ms);
+		if (now_ms - emitted_ms < priv->throttle)
+			return;
+	}
+	fu_progress_emit_percentage(self, percentage);
 }
 
 /**
@@ -348,14 +415,104 @@ fu_progress_set_percentage(FuProgress *self, guint percentage)
 void
 fu_progress_set_percentage_full(FuProgress *self, gsize progress_done, gsize progress_total)
 {
+	FuProgressPrivate *priv = GET_PRIVATE(self);
 	gdouble percentage = 0.f;
 	g_return_if_fail(FU_IS_PROGRESS(self));
 	g_return_if_fail(progress_done <= progress_total);
 	if (progress_total > 0)
 		percentage = (100.f * (gdouble)progress_done) / (gdouble)progress_total;
+	g_mutex_lock(&priv->mutex);
+	priv->bytes_done = progress_done;
+	priv->bytes_total = progress_total;
+	g_mutex_unlock(&priv->mutex);
 	fu_progress_set_percentage(self, (guint)percentage);
 }
 
+/**
+ * fu_progress_get_bytes:
+ * @self: a #FuProgress
+ *
+ * Gets the number of bytes transferred, either set using fu_progress_set_percentage_full() or
+ * accumulated from the children of each completed step.
+ *
+ * Returns: bytes, or 0 if unknown
+ *
+ * Since: 1.8.0
+ **/
+gsize
+fu_progress_get_bytes(FuProgress *self)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_return_val_if_fail(FU_IS_PROGRESS(self), 0);
+	locker = g_mutex_locker_new(&priv->mutex);
+	return priv->bytes_total;
+}
+
+/**
+ * fu_progress_get_throughput:
+ * @self: a #FuProgress
+ *
+ * Gets the current transfer rate of the deepest child reporting the number of bytes
+ * using fu_progress_set_percentage_full().
+ *
+ * Returns: bytes per second, or 0 if unknown
+ *
+ * Since: 1.8.0
+ **/
+guint64
+fu_progress_get_throughput(FuProgress *self)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	gint64 elapsed;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_PROGRESS(self), 0);
+
+	/* prefer the child as it is the one currently doing the work */
+	locker = g_mutex_locker_new(&priv->mutex);
+	if (priv->child != NULL) {
+		guint64 throughput = fu_progress_get_throughput(priv->child);
+		if (throughput > 0)
+			return throughput;
+	}
+	if (priv->bytes_done == 0 || priv->started == 0)
+		return 0;
+	elapsed = g_get_monotonic_time() - priv->started;
+	if (elapsed <= 0)
+		return 0;
+	return ((guint64)priv->bytes_done * G_USEC_PER_SEC) / (guint64)elapsed;
+}
+
+/**
+ * fu_progress_get_eta:
+ * @self: a #FuProgress
+ *
+ * Gets the estimated time remaining, extrapolated from the time taken to get to the current
+ * percentage. This is only accurate when the step weights are correct.
+ *
+ * Returns: seconds, or 0 if unknown
+ *
+ * Since: 1.8.0
+ **/
+guint
+fu_progress_get_eta(FuProgress *self)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	guint percentage;
+	gint64 elapsed;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_PROGRESS(self), 0);
+
+	percentage = g_atomic_int_get(&priv->percentage);
+	locker = g_mutex_locker_new(&priv->mutex);
+	if (percentage == 0 || percentage >= 100 || priv->started == 0)
+		return 0;
+	elapsed = g_get_monotonic_time() - priv->started;
+	return (guint)((elapsed * (100 - percentage)) / ((gint64)percentage * G_USEC_PER_SEC));
+}
+
 /**
  * fu_progress_set_profile:
  * @self: A #FuProgress
@@ -374,6 +531,26 @@ fu_progress_set_profile(FuProgress *self, gboolean profile)
 	priv->profile = profile;
 }
 
+/**
+ * fu_progress_set_throttle:
+ * @self: A #FuProgress
+ * @throttle: minimum time between signals in ms, or 0 for no limit
+ *
+ * Limits how often the ::percentage-changed signal is emitted, which is useful when the
+ * progress is being updated for every small chunk of a large transfer. The values of 0% and
+ * 100% are always emitted, and any value held back is emitted when the step is done, so the
+ * last value is never lost. Any child created after this call inherits the value.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_progress_set_throttle(FuProgress *self, guint throttle)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_PROGRESS(self));
+	priv->throttle = throttle;
+}
+
 /**
  * fu_progress_get_profile:
  * @self: A #FuProgress
@@ -405,12 +582,19 @@ void
 fu_progress_reset(FuProgress *self)
 {
 	FuProgressPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = NULL;
+
 	g_return_if_fail(FU_IS_PROGRESS(self));
 
 	/* reset values */
+	locker = g_mutex_locker_new(&priv->mutex);
 	priv->step_max = 0;
 	priv->step_now = 0;
-	priv->percentage = G_MAXUINT;
+	priv->started = 0;
+	priv->bytes_done = 0;
+	priv->bytes_total = 0;
+	g_atomic_int_set(&priv->percentage, G_MAXUINT);
+	g_atomic_int_set(&priv->percentage_emitted, G_MAXUINT);
 
 	/* only use the timer if profiling; it's expensive */
 	if (priv->profile)
@@ -450,12 +634,14 @@ fu_progress_set_steps(FuProgress *self, guint step_max)
 	g_return_if_fail(FU_IS_PROGRESS(self));
 	g_return_if_fail(priv->id != NULL);
 
-	/* only use the timer if profiling; it's expensive */
-	if (priv->profile)
+	/* only use the timer if profiling or using weighted steps; it's expensive */
+	if (priv->profile || priv->steps->len > 0)
 		g_timer_start(priv->timer);
 
 	/* set step_max */
+	g_mutex_lock(&priv->mutex);
 	priv->step_max = step_max;
+	g_mutex_unlock(&priv->mutex);
 
 	/* show that the sub-progress has been created */
 	fu_progress_set_percentage(self, 0);
@@ -507,11 +693,18 @@ fu_progress_add_step(FuProgress *self, FwupdStatus status, guint value)
 		fu_progress_set_status(self, status);
 
 	/* save data */
+	g_mutex_lock(&priv->mutex);
 	step = g_new0(FuProgressStep, 1);
 	step->status = status;
 	step->value = value;
+	step->value_cumulative = value;
 	step->profile = .0;
+	if (priv->steps->len > 0) {
+		FuProgressStep *step_last = g_ptr_array_index(priv->steps, priv->steps->len - 1);
+		step->value_cumulative += step_last->value_cumulative;
+	}
 	g_ptr_array_add(priv->steps, step);
+	g_mutex_unlock(&priv->mutex);
 
 	/* in case anything is not using ->steps */
 	fu_progress_set_steps(self, priv->steps->len);
@@ -534,14 +727,129 @@ fu_progress_finished(FuProgress *self)
 	g_return_if_fail(priv->id != NULL);
 
 	/* is already at 100%? */
-	if (priv->step_now == priv->step_max)
+	g_mutex_lock(&priv->mutex);
+	if (priv->step_now == priv->step_max) {
+		g_mutex_unlock(&priv->mutex);
 		return;
+	}
 
 	/* all done */
 	priv->step_now = priv->step_max;
+	g_mutex_unlock(&priv->mutex);
 	fu_progress_set_percentage(self, 100);
 }
 
+/**
+ * fu_progress_get_step_status:
+ * @self: A #FuProgress
+ * @idx: step index
+ *
+ * Gets the status of a step added using fu_progress_add_step().
+ *
+ * Return value: a #FwupdStatus, or %FWUPD_STATUS_UNKNOWN if invalid
+ *
+ * Since: 1.8.0
+ **/
+FwupdStatus
+fu_progress_get_step_status(FuProgress *self, guint idx)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	FuProgressStep *step;
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_return_val_if_fail(FU_IS_PROGRESS(self), FWUPD_STATUS_UNKNOWN);
+	locker = g_mutex_locker_new(&priv->mutex);
+	if (idx >= priv->steps->len)
+		return FWUPD_STATUS_UNKNOWN;
+	step = g_ptr_array_index(priv->steps, idx);
+	return step->status;
+}
+
+/**
+ * fu_progress_get_step_duration:
+ * @self: A #FuProgress
+ * @idx: step index
+ *
+ * Gets how long a completed step added using fu_progress_add_step() took.
+ *
+ * Return value: duration in seconds, or 0.0 if not yet done
+ *
+ * Since: 1.8.0
+ **/
+gdouble
+fu_progress_get_step_duration(FuProgress *self, guint idx)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	FuProgressStep *step;
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_return_val_if_fail(FU_IS_PROGRESS(self), 0.f);
+	locker = g_mutex_locker_new(&priv->mutex);
+	if (idx >= priv->steps->len)
+		return 0.f;
+	step = g_ptr_array_index(priv->steps, idx);
+	return step->profile;
+}
+
+/**
+ * fu_progress_get_step_bytes:
+ * @self: A #FuProgress
+ * @idx: step index
+ *
+ * Gets how many bytes the child transferred in a completed step added using
+ * fu_progress_add_step().
+ *
+ * Return value: bytes, or 0 if unknown
+ *
+ * Since: 1.8.0
+ **/
+gsize
+fu_progress_get_step_bytes(FuProgress *self, guint idx)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	FuProgressStep *step;
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_return_val_if_fail(FU_IS_PROGRESS(self), 0);
+	locker = g_mutex_locker_new(&priv->mutex);
+	if (idx >= priv->steps->len)
+		return 0;
+	step = g_ptr_array_index(priv->steps, idx);
+	return step->bytes;
+}
+
+/**
+ * fu_progress_set_step_value:
+ * @self: A #FuProgress
+ * @idx: step index
+ * @value: new step weighting
+ *
+ * Changes the weighting of a step added using fu_progress_add_step(), typically using the
+ * durations measured on a previous run.
+ *
+ * This must be called before any of the steps are done.
+ *
+ * Since: 1.8.0
+ **/
+void
+fu_progress_set_step_value(FuProgress *self, guint idx, guint value)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	guint value_cumulative = 0;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail(FU_IS_PROGRESS(self));
+	g_return_if_fail(idx < priv->steps->len);
+	g_return_if_fail(priv->step_now == 0);
+
+	/* rebuild the running totals */
+	locker = g_mutex_locker_new(&priv->mutex);
+	for (guint i = 0; i < priv->steps->len; i++) {
+		FuProgressStep *step = g_ptr_array_index(priv->steps, i);
+		if (i == idx)
+			step->value = value;
+		value_cumulative += step->value;
+		step->value_cumulative = value_cumulative;
+	}
+}
+
 static gdouble
 fu_progress_discrete_to_percent(guint discrete, guint step_max)
 {
@@ -559,18 +867,17 @@ static gdouble
 fu_progress_get_step_percentage(FuProgress *self, guint idx)
 {
 	FuProgressPrivate *priv = GET_PRIVATE(self);
-	guint current = 0;
-	guint total = 0;
+	FuProgressStep *step_idx;
+	FuProgressStep *step_last;
 
-	for (guint i = 0; i < priv->steps->len; i++) {
-		FuProgressStep *step = g_ptr_array_index(priv->steps, i);
-		if (i <= idx)
-			current += step->value;
-		total += step->value;
-	}
-	if (total == 0)
+	/* use the running totals so this is not O(n) for every step */
+	if (priv->steps->len == 0)
+		return 0;
+	step_idx = g_ptr_array_index(priv->steps, MIN(idx, priv->steps->len - 1));
+	step_last = g_ptr_array_index(priv->steps, priv->steps->len - 1);
+	if (step_last->value_cumulative == 0)
 		return 0;
-	return ((gdouble)current * 100.f) / (gdouble)total;
+	return ((gdouble)step_idx->value_cumulative * 100.f) / (gdouble)step_last->value_cumulative;
 }
 
 static void
@@ -579,35 +886,35 @@ fu_progress_child_status_changed_cb(FuProgress *child, FwupdStatus status, FuPro
 	fu_progress_set_status(self, status);
 }
 
-static void
-fu_progress_child_percentage_changed_cb(FuProgress *child, guint percentage, FuProgress *self)
+/* called with the mutex held, and returns %G_MAXUINT if the parent should not be changed */
+static guint
+fu_progress_child_to_parent_percentage(FuProgress *self, guint percentage, FwupdStatus *status)
 {
 	FuProgressPrivate *priv = GET_PRIVATE(self);
 	gdouble offset;
 	gdouble range;
 	gdouble extra;
-	guint parent_percentage;
+	gdouble pc1;
+	gdouble pc2;
 
 	/* propagate up the stack if FuProgress has only one step */
-	if (priv->step_max == 1) {
-		fu_progress_set_percentage(self, percentage);
-		return;
-	}
+	if (priv->step_max == 1)
+		return percentage;
 
 	/* did we call done on a self that did not have a size set? */
 	if (priv->step_max == 0)
-		return;
+		return G_MAXUINT;
 
 	/* already at >= 100% */
 	if (priv->step_now >= priv->step_max) {
 		g_warning("already at %u/%u step_max", priv->step_now, priv->step_max);
-		return;
+		return G_MAXUINT;
 	}
 
 	/* if the child finished, set the status back to the last parent status */
 	if (percentage == 100 && priv->steps->len > 0) {
 		FuProgressStep *step = g_ptr_array_index(priv->steps, priv->step_now);
-		fu_progress_set_status(self, step->status);
+		*status = step->status;
 	}
 
 	/* we have to deal with non-linear step_max */
@@ -615,14 +922,13 @@ fu_progress_child_percentage_changed_cb(FuProgress *child, guint percentage, FuP
 		/* we don't store zero */
 		if (priv->step_now == 0) {
 			gdouble pc = fu_progress_get_step_percentage(self, 0);
-			parent_percentage = percentage * pc / 100;
-		} else {
-			gdouble pc1 = fu_progress_get_step_percentage(self, priv->step_now - 1);
-			gdouble pc2 = fu_progress_get_step_percentage(self, priv->step_now);
-			/* bi-linearly interpolate */
-			parent_percentage = (((100 - percentage) * pc1) + (percentage * pc2)) / 100;
+			return percentage * pc / 100;
 		}
-		goto out;
+		pc1 = fu_progress_get_step_percentage(self, priv->step_now - 1);
+		pc2 = fu_progress_get_step_percentage(self, priv->step_now);
+
+		/* bi-linearly interpolate */
+		return (((100 - percentage) * pc1) + (percentage * pc2)) / 100;
 	}
 
 	/* get the offset */
@@ -631,15 +937,30 @@ fu_progress_child_percentage_changed_cb(FuProgress *child, guint percentage, FuP
 	/* get the range between the parent step and the next parent step */
 	range = fu_progress_discrete_to_percent(priv->step_now + 1, priv->step_max) - offset;
 	if (range < 0.01)
-		return;
+		return G_MAXUINT;
 
 	/* get the extra contributed by the child */
 	extra = ((gdouble)percentage / 100.0f) * range;
+	return (guint)(offset + extra);
+}
+
+static void
+fu_progress_child_percentage_changed_cb(FuProgress *child, guint percentage, FuProgress *self)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	FwupdStatus status = FWUPD_STATUS_LAST;
+	guint parent_percentage;
+
+	/* the child may be in a different thread to the one doing the steps */
+	g_mutex_lock(&priv->mutex);
+	parent_percentage = fu_progress_child_to_parent_percentage(self, percentage, &status);
+	g_mutex_unlock(&priv->mutex);
 
 	/* emit from the parent */
-	parent_percentage = (guint)(offset + extra);
-out:
-	fu_progress_set_percentage(self, parent_percentage);
+	if (status != FWUPD_STATUS_LAST)
+		fu_progress_set_status(self, status);
+	if (parent_percentage != G_MAXUINT)
+		fu_progress_set_percentage(self, parent_percentage);
 }
 
 static void
@@ -649,6 +970,7 @@ fu_progress_set_parent(FuProgress *self, FuProgress *parent)
 	g_return_if_fail(FU_IS_PROGRESS(self));
 	priv->parent = parent; /* no ref! */
 	priv->profile = fu_progress_get_profile(parent);
+	priv->throttle = GET_PRIVATE(parent)->throttle;
 }
 
 /**
@@ -665,11 +987,13 @@ FuProgress *
 fu_progress_get_child(FuProgress *self)
 {
 	FuProgressPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_PROGRESS(self), NULL);
 	g_return_val_if_fail(priv->id != NULL, NULL);
 
 	/* already created child */
+	locker = g_mutex_locker_new(&priv->mutex);
 	if (priv->child != NULL)
 		return priv->child;
 
@@ -751,46 +1075,42 @@ fu_progress_show_profile(FuProgress *self)
 	}
 }
 
-/**
- * fu_progress_step_done:
- * @self: A #FuProgress
- *
- * Called when the step_now sub-task has finished.
- *
- * Since: 1.7.0
- **/
-void
-fu_progress_step_done(FuProgress *self)
+/* called with the mutex held */
+static gboolean
+fu_progress_step_done_locked(FuProgress *self, FwupdStatus *status, gdouble *percentage)
 {
 	FuProgressPrivate *priv = GET_PRIVATE(self);
-	gdouble percentage;
-
-	g_return_if_fail(FU_IS_PROGRESS(self));
-	g_return_if_fail(priv->id != NULL);
 
 	/* did we call done on a self that did not have a size set? */
 	if (priv->step_max == 0) {
 		g_autoptr(GString) str = g_string_new(NULL);
 		fu_progress_build_parent_chain(self, str, 0);
 		g_warning("progress done when no size set! [%s]: %s", priv->id, str->str);
-		return;
+		return FALSE;
 	}
 
-	/* save the duration in the array */
-	if (priv->profile) {
-		if (priv->steps->len > 0) {
+	/* save the duration in the array -- there are only a few weighted steps so this
+	 * is always done so that the engine can record them */
+	if (priv->profile || priv->steps->len > 0) {
+		if (priv->steps->len > 0 && priv->step_now < priv->steps->len) {
 			FuProgressStep *step = g_ptr_array_index(priv->steps, priv->step_now);
 			step->profile = g_timer_elapsed(priv->timer, NULL);
+			if (priv->child != NULL)
+				step->bytes = fu_progress_get_bytes(priv->child);
 		}
 		g_timer_start(priv->timer);
 	}
 
+	/* accumulate the bytes transferred by the child */
+	if (priv->child != NULL)
+		priv->bytes_total += fu_progress_get_bytes(priv->child);
+
 	/* is already at 100%? */
 	if (priv->step_now >= priv->step_max) {
 		g_autoptr(GString) str = g_string_new(NULL);
 		fu_progress_build_parent_chain(self, str, 0);
 		g_warning("already at 100%% [%s]: %s", priv->id, str->str);
-		return;
+		return FALSE;
 	}
 
 	/* is child not at 100%? */
@@ -811,24 +1131,59 @@ fu_progress_step_done(FuProgress *self)
 	/* another */
 	priv->step_now++;
 
-	/* update status */
-	if (priv->steps->len > 0) {
-		if (priv->step_now == priv->step_max) {
-			fu_progress_set_status(self, FWUPD_STATUS_UNKNOWN);
-		} else {
-			FuProgressStep *step = g_ptr_array_index(priv->steps, priv->step_now);
-			fu_progress_set_status(self, step->status);
-		}
+	/* new status */
+	if (priv->steps->len > 0 && priv->step_now < priv->step_max) {
+		FuProgressStep *step = g_ptr_array_index(priv->steps, priv->step_now);
+		*status = step->status;
 	}
 
 	/* find new percentage */
 	if (priv->steps->len == 0) {
-		percentage = fu_progress_discrete_to_percent(priv->step_now, priv->step_max);
+		*percentage = fu_progress_discrete_to_percent(priv->step_now, priv->step_max);
 	} else {
-		percentage = fu_progress_get_step_percentage(self, priv->step_now - 1);
+		*percentage = fu_progress_get_step_percentage(self, priv->step_now - 1);
+	}
+	return TRUE;
+}
+
+/**
+ * fu_progress_step_done:
+ * @self: A #FuProgress
+ *
+ * Called when the step_now sub-task has finished.
+ *
+ * Since: 1.7.0
+ **/
+void
+fu_progress_step_done(FuProgress *self)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	FwupdStatus status = FWUPD_STATUS_UNKNOWN;
+	gdouble percentage;
+
+	g_return_if_fail(FU_IS_PROGRESS(self));
+	g_return_if_fail(priv->id != NULL);
+
+	/* the child may have a value held back by the throttle */
+	if (priv->child != NULL)
+		fu_progress_flush(priv->child);
+
+	g_mutex_lock(&priv->mutex);
+	if (!fu_progress_step_done_locked(self, &status, &percentage)) {
+		g_mutex_unlock(&priv->mutex);
+		return;
 	}
+	g_mutex_unlock(&priv->mutex);
+
+	/* update status */
+	if (priv->steps->len > 0)
+		fu_progress_set_status(self, status);
 	fu_progress_set_percentage(self, (guint)percentage);
 
+	/* nothing above will flush a value held back by the throttle */
+	if (priv->parent == NULL)
+		fu_progress_flush(self);
+
 	/* show any profiling stats */
 	if (priv->profile && priv->step_now == priv->step_max && priv->steps->len > 0)
 		fu_progress_show_profile(self);
@@ -867,7 +1222,9 @@ fu_progress_init(FuProgress *self)
 {
 	FuProgressPrivate *priv = GET_PRIVATE(self);
 	priv->percentage = G_MAXUINT;
+	priv->percentage_emitted = G_MAXUINT;
 	priv->timer = g_timer_new();
+	g_mutex_init(&priv->mutex);
 	priv->steps = g_ptr_array_new_with_free_func(g_free);
 }
 
@@ -881,6 +1238,7 @@ fu_progress_finalize(GObject *object)
 	g_free(priv->id);
 	g_ptr_array_unref(priv->steps);
 	g_timer_destroy(priv->timer);
+	g_mutex_clear(&priv->mutex);
 
 	G_OBJECT_CLASS(fu_progress_parent_class)->finalize(object);
 }
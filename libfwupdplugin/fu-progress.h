@@ -90,9 +90,17 @@ void
 fu_progress_set_percentage_full(FuProgress *self, gsize progress_done, gsize progress_total);
 guint
 fu_progress_get_percentage(FuProgress *self);
+gsize
+fu_progress_get_bytes(FuProgress *self);
+guint64
+fu_progress_get_throughput(FuProgress *self);
+guint
+fu_progress_get_eta(FuProgress *self);
 void
 fu_progress_set_profile(FuProgress *self, gboolean profile);
 void
+fu_progress_set_throttle(FuProgress *self, guint throttle);
+void
 fu_progress_reset(FuProgress *self);
 void
 fu_progress_set_steps(FuProgress *self, guint step_max);
@@ -100,6 +108,14 @@ guint
 fu_progress_get_steps(FuProgress *self);
 void
 fu_progress_add_step(FuProgress *self, FwupdStatus status, guint value);
+FwupdStatus
+fu_progress_get_step_status(FuProgress *self, guint idx);
+gdouble
+fu_progress_get_step_duration(FuProgress *self, guint idx);
+gsize
+fu_progress_get_step_bytes(FuProgress *self, guint idx);
+void
+fu_progress_set_step_value(FuProgress *self, guint idx, guint value);
 void
 fu_progress_finished(FuProgress *self);
 void
@@ -591,9 +591,13 @@ fu_quirks_init(FuQuirks *self)
 	fu_quirks_add_possible_key(self, "CfiDeviceCmdReadIdSz");
 	fu_quirks_add_possible_key(self, "CfiDeviceCmdChipErase");
 	fu_quirks_add_possible_key(self, "CfiDeviceCmdSectorErase");
+	fu_quirks_add_possible_key(self, "CfiDeviceCmdReadSfdp");
+	fu_quirks_add_possible_key(self, "CfiDeviceAddressSize");
 	fu_quirks_add_possible_key(self, "CfiDeviceBlockSize");
 	fu_quirks_add_possible_key(self, "CfiDevicePageSize");
 	fu_quirks_add_possible_key(self, "CfiDeviceSectorSize");
+	fu_quirks_add_possible_key(self, "HidStatusInterval");
+	fu_quirks_add_possible_key(self, "HidPipelineDepth");
 }
 
 static void
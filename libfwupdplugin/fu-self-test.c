@@ -23,10 +23,12 @@
 #include "fu-efi-firmware-filesystem.h"
 #include "fu-efi-firmware-section.h"
 #include "fu-efi-firmware-volume.h"
+#include "fu-hid-device-private.h"
 #include "fu-ifd-image.h"
 #include "fu-plugin-private.h"
 #include "fu-security-attrs-private.h"
 #include "fu-smbios-private.h"
+#include "fu-usb-device-private.h"
 
 static GMainLoop *_test_loop = NULL;
 static guint _test_loop_timeout_id = 0;
@@ -315,6 +317,194 @@ fu_device_cfi_device_func(void)
 	g_assert_cmpint(fu_cfi_device_get_block_size(cfi_device), ==, 0x8000);
 }
 
+static void
+fu_device_cfi_device_address_size_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuCfiDevice) cfi_device1 = NULL;
+	g_autoptr(FuCfiDevice) cfi_device2 = NULL;
+	g_autoptr(GError) error = NULL;
+
+	ret = fu_context_load_quirks(ctx, FU_QUIRKS_LOAD_FLAG_NO_CACHE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* 4 byte addresses with the default 3 byte commands */
+	cfi_device1 = fu_cfi_device_new(ctx, "3731");
+	ret = fu_device_setup(FU_DEVICE(cfi_device1), &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED);
+	g_assert_false(ret);
+	g_clear_error(&error);
+
+	/* 4 byte addresses with the matching commands */
+	cfi_device2 = fu_cfi_device_new(ctx, "3732");
+	ret = fu_device_setup(FU_DEVICE(cfi_device2), &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_cfi_device_get_address_size(cfi_device2), ==, 4);
+}
+
+typedef struct {
+	GByteArray *flash;
+	guint erase_sector_cnt;
+	guint erase_block_cnt;
+	guint write_cnt;
+} FuCfiDeviceDiffHelper;
+
+static gboolean
+fu_cfi_device_diff_read_cb(FuDevice *device,
+			   guint32 addr,
+			   guint8 *buf,
+			   gsize bufsz,
+			   FuProgress *progress,
+			   GError **error)
+{
+	FuCfiDeviceDiffHelper *helper = g_object_get_data(G_OBJECT(device), "helper");
+	return fu_memcpy_safe(buf,
+			      bufsz,
+			      0x0, /* dst */
+			      helper->flash->data,
+			      helper->flash->len,
+			      addr, /* src */
+			      bufsz,
+			      error);
+}
+
+static gboolean
+fu_cfi_device_diff_write_cb(FuDevice *device,
+			    guint32 addr,
+			    const guint8 *buf,
+			    gsize bufsz,
+			    FuProgress *progress,
+			    GError **error)
+{
+	FuCfiDeviceDiffHelper *helper = g_object_get_data(G_OBJECT(device), "helper");
+
+	/* like NOR flash, programming can only clear bits */
+	g_assert_cmpint(addr + bufsz, <=, helper->flash->len);
+	for (gsize i = 0; i < bufsz; i++)
+		helper->flash->data[addr + i] &= buf[i];
+	helper->write_cnt++;
+	return TRUE;
+}
+
+static gboolean
+fu_cfi_device_diff_erase_sector_cb(FuDevice *device, guint32 addr, GError **error)
+{
+	FuCfiDeviceDiffHelper *helper = g_object_get_data(G_OBJECT(device), "helper");
+	g_assert_cmpint(addr % 0x1000, ==, 0x0);
+	memset(helper->flash->data + addr, 0xFF, 0x1000);
+	helper->erase_sector_cnt++;
+	return TRUE;
+}
+
+static gboolean
+fu_cfi_device_diff_erase_block_cb(FuDevice *device, guint32 addr, GError **error)
+{
+	FuCfiDeviceDiffHelper *helper = g_object_get_data(G_OBJECT(device), "helper");
+	g_assert_cmpint(addr % 0x10000, ==, 0x0);
+	memset(helper->flash->data + addr, 0xFF, 0x10000);
+	helper->erase_block_cnt++;
+	return TRUE;
+}
+
+static void
+fu_device_cfi_device_write_diff_func(void)
+{
+	gboolean ret;
+	guint8 tmp[] = {0x12, 0x34, 0x56, 0x78};
+	FuCfiDeviceDiffHelper helper = {0x0};
+	const FuCfiDeviceFuncs funcs = {
+	    .read = fu_cfi_device_diff_read_cb,
+	    .write = fu_cfi_device_diff_write_cb,
+	    .erase_sector = fu_cfi_device_diff_erase_sector_cb,
+	    .erase_block = fu_cfi_device_diff_erase_block_cb,
+	};
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuCfiDevice) cfi_device = fu_cfi_device_new(ctx, NULL);
+	g_autoptr(FuDevice) device = fu_device_new();
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GByteArray) blank = g_byte_array_new();
+	g_autoptr(GByteArray) flash = g_byte_array_new();
+	g_autoptr(GBytes) fw = NULL;
+	g_autoptr(GBytes) fw2 = NULL;
+	g_autoptr(GBytes) fw3 = NULL;
+	g_autoptr(GBytes) fw4 = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* blank 192KB flash chip */
+	fu_cfi_device_set_size(cfi_device, 0x30000);
+	fu_byte_array_set_size_full(flash, 0x30000, 0xFF);
+	helper.flash = flash;
+	g_object_set_data(G_OBJECT(device), "helper", &helper);
+
+	/* blank sectors do not need erasing */
+	for (guint i = 0; i < 0x21000; i++)
+		fu_byte_array_append_uint8(buf, i & 0xFF);
+	fw = g_bytes_new(buf->data, buf->len);
+	ret = fu_cfi_device_write_diff(cfi_device, device, &funcs, 0x0, fw, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(helper.erase_sector_cnt, ==, 0);
+	g_assert_cmpint(helper.erase_block_cnt, ==, 0);
+	g_assert_cmpint(helper.write_cnt, ==, 0x21);
+	g_assert_cmpint(memcmp(flash->data, buf->data, buf->len), ==, 0);
+
+	/* change one sector, and all of the second block */
+	buf->data[0x3010] = 0xFF;
+	for (guint i = 0x10000; i < 0x20000; i++)
+		buf->data[i] = ~buf->data[i];
+	fw2 = g_bytes_new(buf->data, buf->len);
+	fu_progress_reset(progress);
+	helper.write_cnt = 0;
+	ret = fu_cfi_device_write_diff(cfi_device, device, &funcs, 0x0, fw2, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(helper.erase_sector_cnt, ==, 1);
+	g_assert_cmpint(helper.erase_block_cnt, ==, 1);
+	g_assert_cmpint(helper.write_cnt, ==, 0x11);
+	g_assert_cmpint(memcmp(flash->data, buf->data, buf->len), ==, 0);
+
+	/* nothing changed */
+	fu_progress_reset(progress);
+	helper.write_cnt = 0;
+	ret = fu_cfi_device_write_diff(cfi_device, device, &funcs, 0x0, fw2, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(helper.write_cnt, ==, 0);
+
+	/* unaligned write preserves the rest of the sector */
+	fw3 = g_bytes_new_static(tmp, sizeof(tmp));
+	fu_progress_reset(progress);
+	ret = fu_cfi_device_write_diff(cfi_device, device, &funcs, 0x20010, fw3, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(helper.erase_sector_cnt, ==, 2);
+	g_assert_cmpint(flash->data[0x2000F], ==, buf->data[0x2000F]);
+	g_assert_cmpint(flash->data[0x20010], ==, 0x12);
+	g_assert_cmpint(flash->data[0x20014], ==, buf->data[0x20014]);
+
+	/* blanking a sector erases it without programming it */
+	fu_byte_array_set_size_full(blank, 0x1000, 0xFF);
+	fw4 = g_bytes_new(blank->data, blank->len);
+	fu_progress_reset(progress);
+	helper.write_cnt = 0;
+	ret = fu_cfi_device_write_diff(cfi_device, device, &funcs, 0x0, fw4, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(helper.erase_sector_cnt, ==, 3);
+	g_assert_cmpint(helper.write_cnt, ==, 0);
+	g_assert_cmpint(memcmp(flash->data, blank->data, blank->len), ==, 0);
+
+	/* too large */
+	fu_progress_reset(progress);
+	ret = fu_cfi_device_write_diff(cfi_device, device, &funcs, 0x2FFFE, fw3, progress, &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+	g_assert_false(ret);
+}
+
 static void
 fu_device_metadata_func(void)
 {
@@ -1968,6 +2158,505 @@ fu_device_parent_func(void)
 	g_assert_true(grandparent_root == grandparent);
 }
 
+static void
+fu_device_events_func(void)
+{
+	FuDeviceEvent *event;
+	GPtrArray *events;
+	guint8 buf[3] = {0x0};
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuDevice) device = fu_device_new_with_context(ctx);
+	g_autoptr(FuDevice) device_emulated = fu_device_new_with_context(ctx);
+	g_autoptr(FuDeviceEvent) event_copy = NULL;
+	g_autoptr(FuDeviceEvent) event_copy2 = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GError) error_saved = NULL;
+	g_autoptr(GVariant) value = NULL;
+	g_autoptr(GVariant) value2 = NULL;
+
+	/* not saved unless the context asks for it */
+	g_assert_false(fu_device_has_save_events(device));
+	fu_context_add_flag(ctx, FU_CONTEXT_FLAG_SAVE_EVENTS);
+	g_assert_true(fu_device_has_save_events(device));
+
+	/* save */
+	event = fu_device_save_event(device, "Pread:Port=0x0,Length=0x3");
+	fu_device_event_set_data_raw(event, (const guint8 *)"abc", 3);
+	event = fu_device_save_event(device, "Pwrite:Port=0x0,Length=0x1,Crc=0x12345678");
+	fu_device_event_set_rc(event, 1);
+	event = fu_device_save_event(device, "Pread:Port=0x0,Length=0x3");
+	fu_device_event_set_data_raw(event, (const guint8 *)"def", 3);
+	events = fu_device_get_events(device);
+	g_assert_nonnull(events);
+	g_assert_cmpint(events->len, ==, 3);
+
+	/* round trip */
+	value = g_variant_ref_sink(fu_device_event_to_variant(g_ptr_array_index(events, 1)));
+	event_copy = fu_device_event_from_variant(value, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(event_copy);
+	g_assert_cmpstr(fu_device_event_get_id(event_copy),
+			==,
+			"Pwrite:Port=0x0,Length=0x1,Crc=0x12345678");
+	g_assert_cmpint(fu_device_event_get_rc(event_copy), ==, 1);
+
+	/* emulated devices never save more events */
+	fu_device_add_internal_flag(device_emulated, FU_DEVICE_INTERNAL_FLAG_EMULATED);
+	fu_device_incorporate(device_emulated, device);
+	g_assert_false(fu_device_has_save_events(device_emulated));
+
+	/* load in order */
+	event = fu_device_load_event(device_emulated, "Pread:Port=0x0,Length=0x3", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(event);
+	g_assert_true(fu_device_event_copy_data(event, buf, sizeof(buf), &error));
+	g_assert_no_error(error);
+	g_assert_cmpint(memcmp(buf, "abc", 3), ==, 0);
+
+	/* a repeated or reordered request does not match */
+	event = fu_device_load_event(device_emulated, "Pread:Port=0x0,Length=0x3", &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
+	g_assert_null(event);
+	g_clear_error(&error);
+	event = fu_device_load_event(device_emulated,
+				     "Pwrite:Port=0x0,Length=0x1,Crc=0x12345678",
+				     &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(event);
+	g_assert_cmpint(fu_device_event_get_rc(event), ==, 1);
+	event = fu_device_load_event(device_emulated, "Pread:Port=0x0,Length=0x3", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(event);
+	g_assert_true(fu_device_event_copy_data(event, buf, sizeof(buf), &error));
+	g_assert_no_error(error);
+	g_assert_cmpint(memcmp(buf, "def", 3), ==, 0);
+
+	/* no more saved */
+	event = fu_device_load_event(device_emulated, "Pread:Port=0x0,Length=0x3", &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(event);
+	g_clear_error(&error);
+
+	/* failures are saved too */
+	g_set_error_literal(&error_saved, G_IO_ERROR, G_IO_ERROR_TIMED_OUT, "timed out");
+	event = fu_device_save_event(device, "Ioctl:Request=0x1234,Length=0x4");
+	fu_device_event_set_rc(event, -1);
+	fu_device_event_set_error(event, error_saved);
+	value2 = g_variant_ref_sink(fu_device_event_to_variant(event));
+	event_copy2 = fu_device_event_from_variant(value2, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(event_copy2);
+	g_assert_cmpint(fu_device_event_get_rc(event_copy2), ==, -1);
+	g_assert_true(g_error_matches(fu_device_event_get_error(event_copy2),
+				      G_IO_ERROR,
+				      G_IO_ERROR_TIMED_OUT));
+	g_assert_cmpstr(fu_device_event_get_error(event_copy2)->message, ==, "timed out");
+
+	/* events added to the donor later are still copied */
+	fu_device_incorporate(device_emulated, device);
+	g_assert_cmpint(fu_device_get_events(device_emulated)->len, ==, 4);
+
+	/* and the failure is replayed */
+	event = fu_device_load_event(device_emulated, "Ioctl:Request=0x1234,Length=0x4", &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT);
+	g_assert_null(event);
+}
+
+#ifdef HAVE_GUSB
+/* pretends to be the hardware, completing transfers in the reverse order they were submitted */
+typedef struct {
+	GPtrArray *tasks; /* (element-type GTask) */
+	GSource *source;
+	guint submitted;
+	guint finished;
+	guint cancelled;
+	guint8 endpoint; /* of the last transfer */
+	guint fail_idx;	 /* this transfer fails */
+	guint stall_idx; /* this transfer and later ones only complete when cancelled */
+} FuUsbDeviceTransferFake;
+
+typedef struct {
+	guint idx;
+	gsize length;
+} FuUsbDeviceTransferFakeItem;
+
+static gboolean
+fu_usb_device_transfer_fake_complete_cb(gpointer user_data)
+{
+	FuUsbDeviceTransferFake *fake = (FuUsbDeviceTransferFake *)user_data;
+	g_autoptr(GPtrArray) tasks = fake->tasks;
+
+	fake->tasks = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	for (guint i = tasks->len; i > 0; i--) {
+		GTask *task = g_ptr_array_index(tasks, i - 1);
+		FuUsbDeviceTransferFakeItem *item = g_task_get_task_data(task);
+		if (g_task_return_error_if_cancelled(task)) {
+			fake->cancelled++;
+			continue;
+		}
+		if (item->idx >= fake->stall_idx) {
+			g_ptr_array_add(fake->tasks, g_object_ref(task));
+			continue;
+		}
+		if (item->idx == fake->fail_idx) {
+			g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_FAILED, "failed");
+			continue;
+		}
+		g_task_return_int(task, item->length);
+	}
+
+	/* poll until the stalled transfers are cancelled */
+	if (fake->tasks->len > 0)
+		return G_SOURCE_CONTINUE;
+	g_clear_pointer(&fake->source, g_source_unref);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+fu_usb_device_transfer_fake_async(FuUsbDevice *self,
+				  guint8 endpoint,
+				  guint8 *data,
+				  gsize length,
+				  guint timeout,
+				  GCancellable *cancellable,
+				  GAsyncReadyCallback callback,
+				  gpointer user_data)
+{
+	FuUsbDeviceTransferFake *fake = g_object_get_data(G_OBJECT(self), "fake");
+	FuUsbDeviceTransferFakeItem *item = g_new0(FuUsbDeviceTransferFakeItem, 1);
+	GTask *task = g_task_new(self, cancellable, callback, user_data);
+
+	item->idx = fake->submitted++;
+	item->length = length;
+	fake->endpoint = endpoint;
+	g_task_set_task_data(task, item, g_free);
+	g_ptr_array_add(fake->tasks, task);
+
+	/* the transfers have to complete on the context the caller is waiting on */
+	if (fake->source == NULL) {
+		fake->source = g_timeout_source_new(1);
+		g_source_set_callback(fake->source,
+				      fu_usb_device_transfer_fake_complete_cb,
+				      fake,
+				      NULL);
+		g_source_attach(fake->source, g_main_context_get_thread_default());
+	}
+}
+
+static gssize
+fu_usb_device_transfer_fake_finish(FuUsbDevice *self, GAsyncResult *res, GError **error)
+{
+	FuUsbDeviceTransferFake *fake = g_object_get_data(G_OBJECT(self), "fake");
+	fake->finished++;
+	return g_task_propagate_int(G_TASK(res), error);
+}
+
+static void
+fu_usb_device_transfer_fake_reset(FuUsbDeviceTransferFake *fake)
+{
+	g_ptr_array_set_size(fake->tasks, 0);
+	fake->submitted = 0;
+	fake->finished = 0;
+	fake->cancelled = 0;
+	fake->fail_idx = G_MAXUINT;
+	fake->stall_idx = G_MAXUINT;
+}
+
+static gboolean
+fu_usb_device_transfer_chunks_chunk_cb(FuUsbDevice *self,
+				       FuChunk *chk,
+				       gsize actual_length,
+				       gpointer user_data,
+				       GError **error)
+{
+	GArray *idxs = (GArray *)user_data;
+	guint idx = fu_chunk_get_idx(chk);
+
+	g_assert_cmpint(actual_length, ==, fu_chunk_get_data_sz(chk));
+	if (g_object_get_data(G_OBJECT(self), "fail-func") != NULL) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "bad reply");
+		return FALSE;
+	}
+	g_array_append_val(idxs, idx);
+	return TRUE;
+}
+
+static void
+fu_usb_device_transfer_chunks_func(void)
+{
+	gboolean ret;
+	const guint8 data[] = "0123456789abcdefghijklmnopqrstuv";
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuUsbDevice) device = fu_usb_device_new_with_context(ctx, NULL);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GArray) idxs = g_array_new(FALSE, FALSE, sizeof(guint));
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) chunks = fu_chunk_array_new(data, 32, 0x0, 0x0, 4);
+	FuUsbDeviceTransferFake fake = {
+	    .tasks = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref),
+	};
+
+	g_object_set_data(G_OBJECT(device), "fake", &fake);
+	fu_usb_device_set_transfer_funcs(device,
+					 fu_usb_device_transfer_fake_async,
+					 fu_usb_device_transfer_fake_finish);
+
+	/* reported in order even though the transfers complete in reverse */
+	fu_usb_device_transfer_fake_reset(&fake);
+	ret = fu_usb_device_bulk_transfer_chunks(device,
+						 0x01,
+						 chunks,
+						 3,
+						 1000,
+						 fu_usb_device_transfer_chunks_chunk_cb,
+						 idxs,
+						 progress,
+						 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(idxs->len, ==, chunks->len);
+	for (guint i = 0; i < idxs->len; i++)
+		g_assert_cmpint(g_array_index(idxs, guint, i), ==, i);
+	g_assert_cmpint(fake.submitted, ==, chunks->len);
+	g_assert_cmpint(fake.finished, ==, chunks->len);
+	g_assert_cmpint(fake.cancelled, ==, 0);
+
+	/* the callback failing cancels the transfers still in flight */
+	fu_usb_device_transfer_fake_reset(&fake);
+	fake.stall_idx = 1;
+	g_array_set_size(idxs, 0);
+	fu_progress_reset(progress);
+	g_object_set_data(G_OBJECT(device), "fail-func", GINT_TO_POINTER(TRUE));
+	ret = fu_usb_device_bulk_transfer_chunks(device,
+						 0x01,
+						 chunks,
+						 3,
+						 1000,
+						 fu_usb_device_transfer_chunks_chunk_cb,
+						 idxs,
+						 progress,
+						 &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+	g_assert_false(ret);
+	g_clear_error(&error);
+	g_assert_cmpint(fake.submitted, ==, 3);
+	g_assert_cmpint(fake.finished, ==, 3);
+	g_assert_cmpint(fake.cancelled, ==, 2);
+	g_object_set_data(G_OBJECT(device), "fail-func", NULL);
+
+	/* the first failure is returned once the rest have drained, and nothing more is sent */
+	fu_usb_device_transfer_fake_reset(&fake);
+	fake.fail_idx = 1;
+	fake.stall_idx = 2;
+	g_array_set_size(idxs, 0);
+	fu_progress_reset(progress);
+	ret = fu_usb_device_bulk_transfer_chunks(device,
+						 0x01,
+						 chunks,
+						 3,
+						 1000,
+						 fu_usb_device_transfer_chunks_chunk_cb,
+						 idxs,
+						 progress,
+						 &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_FAILED);
+	g_assert_false(ret);
+	g_assert_cmpint(idxs->len, ==, 0);
+	g_assert_cmpint(fake.submitted, ==, 3);
+	g_assert_cmpint(fake.finished, ==, 3);
+	g_assert_cmpint(fake.cancelled, >=, 1);
+	g_ptr_array_unref(fake.tasks);
+}
+
+static gboolean
+fu_hid_device_set_reports_status_cb(FuHidDevice *self,
+				    guint count,
+				    gpointer user_data,
+				    GError **error)
+{
+	GArray *counts = (GArray *)user_data;
+	g_array_append_val(counts, count);
+	return TRUE;
+}
+
+static void
+fu_hid_device_set_reports_func(void)
+{
+	gboolean ret;
+	const guint8 data[] = "abcdefghij";
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuHidDevice) device = NULL;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GArray) counts = g_array_new(FALSE, FALSE, sizeof(guint));
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) reports = NULL;
+
+	ret = fu_context_load_quirks(ctx, FU_QUIRKS_LOAD_FLAG_NO_CACHE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* each report is replayed from a saved event */
+	device = g_object_new(FU_TYPE_HID_DEVICE, "context", ctx, NULL);
+	fu_device_add_internal_flag(FU_DEVICE(device), FU_DEVICE_INTERNAL_FLAG_EMULATED);
+	reports = fu_chunk_array_new(data, 10, 0x0, 0x0, 2);
+	for (guint i = 0; i < reports->len; i++) {
+		FuChunk *chk = g_ptr_array_index(reports, i);
+		guint32 crc = fu_common_crc32(fu_chunk_get_data(chk), fu_chunk_get_data_sz(chk));
+		g_autofree gchar *id = NULL;
+		g_autoptr(FuDeviceEvent) event = NULL;
+
+		id = g_strdup_printf("HidSetReport:Value=0x00,Length=0x2,Crc=0x%08x", crc);
+		event = fu_device_event_new(id);
+		fu_device_add_event(FU_DEVICE(device), event);
+	}
+
+	/* the status is checked after every report by default */
+	ret = fu_hid_device_set_reports(device,
+					0x0,
+					reports,
+					0,
+					FU_HID_DEVICE_FLAG_NONE,
+					fu_hid_device_set_reports_status_cb,
+					counts,
+					progress,
+					&error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(counts->len, ==, 5);
+
+	/* every two reports as set by the quirk, and once more for the last report */
+	g_array_set_size(counts, 0);
+	fu_progress_reset(progress);
+	fu_device_add_instance_id(FU_DEVICE(device), "USB\\VID_273F&PID_10FF");
+	fu_device_convert_instance_ids(FU_DEVICE(device));
+	ret = fu_hid_device_set_reports(device,
+					0x0,
+					reports,
+					0,
+					FU_HID_DEVICE_FLAG_NONE,
+					fu_hid_device_set_reports_status_cb,
+					counts,
+					progress,
+					&error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(counts->len, ==, 3);
+	g_assert_cmpint(g_array_index(counts, guint, 0), ==, 2);
+	g_assert_cmpint(g_array_index(counts, guint, 1), ==, 2);
+	g_assert_cmpint(g_array_index(counts, guint, 2), ==, 1);
+
+	/* the status is not checked after a report fails */
+	g_array_set_size(counts, 0);
+	fu_progress_reset(progress);
+	fu_device_clear_events(FU_DEVICE(device));
+	ret = fu_hid_device_set_reports(device,
+					0x0,
+					reports,
+					0,
+					FU_HID_DEVICE_FLAG_NONE,
+					fu_hid_device_set_reports_status_cb,
+					counts,
+					progress,
+					&error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_false(ret);
+	g_assert_cmpint(counts->len, ==, 0);
+}
+
+static void
+fu_hid_device_set_reports_interrupt_func(void)
+{
+	gboolean ret;
+	const guint8 data[] = "abcdefghij";
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuHidDevice) device = NULL;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GArray) counts = g_array_new(FALSE, FALSE, sizeof(guint));
+	g_autoptr(GArray) idxs = g_array_new(FALSE, FALSE, sizeof(guint));
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) reports = fu_chunk_array_new(data, 10, 0x0, 0x0, 2);
+	FuUsbDeviceTransferFake fake = {
+	    .tasks = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref),
+	};
+
+	ret = fu_context_load_quirks(ctx, FU_QUIRKS_LOAD_FLAG_NO_CACHE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* uses HidStatusInterval=2 and a fake OUT endpoint */
+	device = g_object_new(FU_TYPE_HID_DEVICE, "context", ctx, NULL);
+	fu_device_add_instance_id(FU_DEVICE(device), "USB\\VID_273F&PID_10FF");
+	fu_device_convert_instance_ids(FU_DEVICE(device));
+	fu_hid_device_set_ep_addr_out(device, 0x02);
+	g_object_set_data(G_OBJECT(device), "fake", &fake);
+	fu_usb_device_set_transfer_funcs(FU_USB_DEVICE(device),
+					 fu_usb_device_transfer_fake_async,
+					 fu_usb_device_transfer_fake_finish);
+
+	/* sent on the interrupt endpoint and reported in order */
+	fu_usb_device_transfer_fake_reset(&fake);
+	ret = fu_usb_device_interrupt_transfer_chunks(FU_USB_DEVICE(device),
+						      0x02,
+						      reports,
+						      4,
+						      1000,
+						      fu_usb_device_transfer_chunks_chunk_cb,
+						      idxs,
+						      progress,
+						      &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(idxs->len, ==, reports->len);
+	for (guint i = 0; i < idxs->len; i++)
+		g_assert_cmpint(g_array_index(idxs, guint, i), ==, i);
+	g_assert_cmpint(fake.endpoint, ==, 0x02);
+	g_assert_cmpint(fake.submitted, ==, reports->len);
+	g_assert_cmpint(fake.finished, ==, reports->len);
+
+	/* each window is queued as interrupt transfers before the status is checked */
+	fu_usb_device_transfer_fake_reset(&fake);
+	fu_progress_reset(progress);
+	ret = fu_hid_device_set_reports(device,
+					0x0,
+					reports,
+					1000,
+					FU_HID_DEVICE_FLAG_USE_INTERRUPT_TRANSFER,
+					fu_hid_device_set_reports_status_cb,
+					counts,
+					progress,
+					&error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fake.endpoint, ==, 0x02);
+	g_assert_cmpint(fake.submitted, ==, reports->len);
+	g_assert_cmpint(fake.finished, ==, reports->len);
+	g_assert_cmpint(counts->len, ==, 3);
+	g_assert_cmpint(g_array_index(counts, guint, 0), ==, 2);
+	g_assert_cmpint(g_array_index(counts, guint, 1), ==, 2);
+	g_assert_cmpint(g_array_index(counts, guint, 2), ==, 1);
+
+	/* a failed transfer in the second window stops before its status check */
+	fu_usb_device_transfer_fake_reset(&fake);
+	fake.fail_idx = 2;
+	g_array_set_size(counts, 0);
+	fu_progress_reset(progress);
+	ret = fu_hid_device_set_reports(device,
+					0x0,
+					reports,
+					1000,
+					FU_HID_DEVICE_FLAG_USE_INTERRUPT_TRANSFER,
+					fu_hid_device_set_reports_status_cb,
+					counts,
+					progress,
+					&error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_FAILED);
+	g_assert_false(ret);
+	g_assert_cmpint(fake.submitted, ==, 4);
+	g_assert_cmpint(counts->len, ==, 1);
+	g_ptr_array_unref(fake.tasks);
+}
+#endif
+
 static void
 fu_device_incorporate_func(void)
 {
@@ -2629,6 +3318,98 @@ fu_firmware_srec_func(void)
 	g_assert_true(ret);
 }
 
+static void
+fu_firmware_sfdp_func(void)
+{
+	FuSfdpFirmware *sfdp;
+	gboolean ret;
+	guint8 buf[0x50] = {'S', 'F', 'D', 'P', 0x06, 0x01, 0x00, 0xFF};
+	guint32 bfpt[16] = {0xFFF120E5, /* 4KiB erase, 3 byte address */
+			    0x07FFFFFF, /* 128Mbit */
+			    0x6B08EB44,
+			    0xBB423B08,
+			    0xFFFFFFEE,
+			    0xFF00FFFF,
+			    0xEB40FFFF,
+			    0x520F200C, /* 4KiB 0x20, 32KiB 0x52 */
+			    0xFF00D810, /* 64KiB 0xD8 */
+			    0x00000000,
+			    0x00000080}; /* 256 byte page */
+	g_autoptr(FuFirmware) firmware = fu_sfdp_firmware_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* one parameter header pointing at the basic flash parameter table */
+	buf[0x8] = 0x00;
+	buf[0xB] = G_N_ELEMENTS(bfpt);
+	buf[0xC] = 0x10;
+	buf[0xF] = 0xFF;
+	for (guint i = 0; i < G_N_ELEMENTS(bfpt); i++)
+		fu_common_write_uint32(buf + 0x10 + i * 4, bfpt[i], G_LITTLE_ENDIAN);
+	blob = g_bytes_new(buf, sizeof(buf));
+	ret = fu_firmware_parse(firmware, blob, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	sfdp = FU_SFDP_FIRMWARE(firmware);
+	g_assert_cmpint(fu_sfdp_firmware_get_flash_size(sfdp), ==, 0x1000000);
+	g_assert_cmpint(fu_sfdp_firmware_get_page_size(sfdp), ==, 0x100);
+	g_assert_cmpint(fu_sfdp_firmware_get_sector_size(sfdp), ==, 0x1000);
+	g_assert_cmpint(fu_sfdp_firmware_get_sector_erase_cmd(sfdp), ==, 0x20);
+	g_assert_cmpint(fu_sfdp_firmware_get_block_size(sfdp), ==, 0x10000);
+	g_assert_cmpint(fu_sfdp_firmware_get_block_erase_cmd(sfdp), ==, 0xD8);
+	g_assert_cmpint(fu_sfdp_firmware_get_address_size(sfdp), ==, 3);
+}
+
+static void
+fu_firmware_sfdp_4bait_func(void)
+{
+	FuSfdpFirmware *sfdp;
+	gboolean ret;
+	guint8 buf[0x60] = {'S', 'F', 'D', 'P', 0x06, 0x01, 0x01, 0xFF};
+	guint32 bfpt[16] = {0xFFF320E5, /* 4KiB erase, 3 or 4 byte address */
+			    0x0FFFFFFF, /* 256Mbit */
+			    0x6B08EB44,
+			    0xBB423B08,
+			    0xFFFFFFEE,
+			    0xFF00FFFF,
+			    0xEB40FFFF,
+			    0x520F200C, /* 4KiB 0x20, 32KiB 0x52 */
+			    0xFF00D810, /* 64KiB 0xD8 */
+			    0x00000000,
+			    0x00000080}; /* 256 byte page */
+	guint32 bait[2] = {0x00000A41,	/* read, page program, erase types 1 and 3 */
+			   0xFFDC5C21}; /* 4-byte erase commands */
+	g_autoptr(FuFirmware) firmware = fu_sfdp_firmware_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* the basic flash parameter table and the 4-byte address instruction table */
+	buf[0x8] = 0x00;
+	buf[0xB] = G_N_ELEMENTS(bfpt);
+	buf[0xC] = 0x18;
+	buf[0xF] = 0xFF;
+	buf[0x10] = 0x84;
+	buf[0x13] = G_N_ELEMENTS(bait);
+	buf[0x14] = 0x58;
+	buf[0x17] = 0xFF;
+	for (guint i = 0; i < G_N_ELEMENTS(bfpt); i++)
+		fu_common_write_uint32(buf + 0x18 + i * 4, bfpt[i], G_LITTLE_ENDIAN);
+	for (guint i = 0; i < G_N_ELEMENTS(bait); i++)
+		fu_common_write_uint32(buf + 0x58 + i * 4, bait[i], G_LITTLE_ENDIAN);
+	blob = g_bytes_new(buf, sizeof(buf));
+	ret = fu_firmware_parse(firmware, blob, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	sfdp = FU_SFDP_FIRMWARE(firmware);
+	g_assert_cmpint(fu_sfdp_firmware_get_flash_size(sfdp), ==, 0x2000000);
+	g_assert_cmpint(fu_sfdp_firmware_get_address_size(sfdp), ==, 4);
+	g_assert_false(fu_sfdp_firmware_get_address_4byte_only(sfdp));
+	g_assert_cmpint(fu_sfdp_firmware_get_read_4byte_cmd(sfdp), ==, 0x13);
+	g_assert_cmpint(fu_sfdp_firmware_get_page_prog_4byte_cmd(sfdp), ==, 0x12);
+	g_assert_cmpint(fu_sfdp_firmware_get_sector_erase_4byte_cmd(sfdp), ==, 0x21);
+	g_assert_cmpint(fu_sfdp_firmware_get_block_erase_4byte_cmd(sfdp), ==, 0xDC);
+}
+
 static void
 fu_firmware_srec_tokenization_func(void)
 {
@@ -3111,7 +3892,13 @@ fu_efivar_func(void)
 	gboolean ret;
 	gsize sz = 0;
 	guint32 attr = 0;
+	guint64 hits = 0;
+	guint64 hits_new = 0;
+	guint64 misses = 0;
+	guint64 misses_new = 0;
 	guint64 total;
+	const guint8 buf[] = {0x07, 0x00, 0x00, 0x00, '3', '3', '3'};
+	g_autofree gchar *fn = NULL;
 	g_autofree gchar *sysfsfwdir = NULL;
 	g_autofree guint8 *data = NULL;
 	g_autoptr(GError) error = NULL;
@@ -3162,6 +3949,47 @@ fu_efivar_func(void)
 	g_assert_cmpint(attr, ==, FU_EFIVAR_ATTR_NON_VOLATILE | FU_EFIVAR_ATTR_RUNTIME_ACCESS);
 	g_assert_cmpint(data[0], ==, '1');
 
+	/* read it again from the cache */
+	fu_efivar_get_cache_stats(&hits, NULL);
+	ret = fu_efivar_get_data(FU_EFIVAR_GUID_EFI_GLOBAL, "Test", NULL, &sz, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(sz, ==, 1);
+	fu_efivar_get_cache_stats(&hits_new, NULL);
+	g_assert_cmpint(hits_new, ==, hits + 1);
+
+	/* writing invalidates the cache */
+	ret = fu_efivar_set_data(FU_EFIVAR_GUID_EFI_GLOBAL, "Test", (guint8 *)"22", 2, 0, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_clear_pointer(&data, g_free);
+	ret = fu_efivar_get_data(FU_EFIVAR_GUID_EFI_GLOBAL, "Test", &data, &sz, &attr, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(sz, ==, 2);
+	g_assert_cmpint(attr, ==, 0);
+	g_assert_cmpint(data[0], ==, '2');
+
+	/* changing the file behind the back of the cache invalidates it too */
+	fn = g_build_filename(sysfsfwdir,
+			      "efi",
+			      "efivars",
+			      "Test-" FU_EFIVAR_GUID_EFI_GLOBAL,
+			      NULL);
+	ret = g_file_set_contents(fn, (const gchar *)buf, sizeof(buf), &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_efivar_get_cache_stats(NULL, &misses);
+	g_clear_pointer(&data, g_free);
+	ret = fu_efivar_get_data(FU_EFIVAR_GUID_EFI_GLOBAL, "Test", &data, &sz, &attr, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(sz, ==, 3);
+	g_assert_cmpint(attr, ==, 0x07);
+	g_assert_cmpint(data[0], ==, '3');
+	fu_efivar_get_cache_stats(NULL, &misses_new);
+	g_assert_cmpint(misses_new, ==, misses + 1);
+
 	/* delete single key */
 	ret = fu_efivar_delete(FU_EFIVAR_GUID_EFI_GLOBAL, "Test", &error);
 	g_assert_no_error(error);
@@ -3286,6 +4114,59 @@ fu_device_retry_hardware_func(void)
 	g_assert_cmpint(helper.cnt_failed, ==, 2);
 }
 
+static void
+fu_device_io_stats_func(void)
+{
+	gboolean ret;
+	g_autofree gchar *str = NULL;
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuDevice) device = fu_device_new_with_context(ctx);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) metadata = NULL;
+	FuDeviceRetryHelper helper = {
+	    .cnt_success = 0,
+	    .cnt_failed = 0,
+	};
+
+	/* nothing recorded */
+	metadata = fu_device_report_metadata_post(device);
+	g_assert_null(metadata);
+
+	fu_device_add_io_stats(device, "Pwrite", 64, 10);
+	fu_device_add_io_stats(device, "Pwrite", 64, 20);
+	fu_device_add_io_stats(device, "Pwrite", 64, 300);
+	fu_device_add_io_stats(device, "Pread", 4, 5);
+	ret = fu_device_retry(device, fu_device_retry_success_3rd_try, 3, &helper, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* not reported unless enabled */
+	metadata = fu_device_report_metadata_post(device);
+	g_assert_null(metadata);
+	fu_context_add_flag(ctx, FU_CONTEXT_FLAG_REPORT_IO_STATS);
+
+	metadata = fu_device_report_metadata_post(device);
+	g_assert_nonnull(metadata);
+	g_assert_cmpstr(g_hash_table_lookup(metadata, "IoPwriteTransfers"), ==, "3");
+	g_assert_cmpstr(g_hash_table_lookup(metadata, "IoPwriteBytes"), ==, "192");
+	g_assert_cmpstr(g_hash_table_lookup(metadata, "IoPwriteLatencyMin"), ==, "10");
+	g_assert_cmpstr(g_hash_table_lookup(metadata, "IoPwriteLatencyAvg"), ==, "110");
+	g_assert_cmpstr(g_hash_table_lookup(metadata, "IoPwriteLatencyP99"), ==, "300");
+	g_assert_cmpstr(g_hash_table_lookup(metadata, "IoPreadTransfers"), ==, "1");
+	g_assert_cmpstr(g_hash_table_lookup(metadata, "IoRetries"), ==, "2");
+
+	str = fu_device_to_string(device);
+	g_debug("%s", str);
+	g_assert_nonnull(
+	    g_strstr_len(str, -1, "transfers:3,bytes:192,min:10us,avg:110us,p99:300us"));
+
+	/* reset */
+	fu_device_clear_io_stats(device);
+	g_clear_pointer(&metadata, g_hash_table_unref);
+	metadata = fu_device_report_metadata_post(device);
+	g_assert_null(metadata);
+}
+
 static void
 fu_security_attrs_hsi_func(void)
 {
@@ -3927,6 +4808,217 @@ fu_progress_finish_func(void)
 	fu_progress_step_done(progress);
 }
 
+static void
+fu_progress_throttle_func(void)
+{
+	FuProgress *child;
+	FuProgressHelper helper = {0};
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+
+	g_signal_connect(FU_PROGRESS(progress),
+			 "percentage-changed",
+			 G_CALLBACK(fu_progress_percentage_changed_cb),
+			 &helper);
+	fu_progress_set_throttle(progress, 10000);
+	fu_progress_set_steps(progress, 1);
+
+	/* only the first and last values get through */
+	child = fu_progress_get_child(progress);
+	fu_progress_set_id(child, G_STRLOC);
+	fu_progress_set_steps(child, 100);
+	for (guint i = 0; i < 100; i++)
+		fu_progress_step_done(child);
+	g_assert_cmpint(fu_progress_get_percentage(child), ==, 100);
+	fu_progress_step_done(progress);
+	g_assert_cmpint(helper.last_percentage, ==, 100);
+	g_assert_cmpint(helper.updates, ==, 2);
+}
+
+static void
+fu_progress_throttle_flush_func(void)
+{
+	FuProgress *child;
+	FuProgressHelper helper = {0};
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+
+	g_signal_connect(FU_PROGRESS(progress),
+			 "percentage-changed",
+			 G_CALLBACK(fu_progress_percentage_changed_cb),
+			 &helper);
+	fu_progress_set_throttle(progress, 10000);
+	fu_progress_set_steps(progress, 2);
+	g_assert_cmpint(helper.last_percentage, ==, 0);
+
+	/* the child stops short of 100%, and the value held back is emitted when done */
+	child = fu_progress_get_child(progress);
+	fu_progress_set_id(child, G_STRLOC);
+	fu_progress_set_percentage_full(child, 30, 100);
+	fu_progress_set_percentage_full(child, 60, 100);
+	g_assert_cmpint(helper.updates, ==, 1);
+	fu_progress_step_done(progress);
+	g_assert_cmpint(helper.last_percentage, ==, 50);
+	g_assert_cmpint(helper.updates, ==, 2);
+
+	/* last step */
+	child = fu_progress_get_child(progress);
+	fu_progress_set_id(child, G_STRLOC);
+	fu_progress_set_percentage_full(child, 60, 100);
+	fu_progress_step_done(progress);
+	g_assert_cmpint(helper.last_percentage, ==, 100);
+	g_assert_cmpint(helper.updates, ==, 3);
+}
+
+static void
+fu_progress_benchmark_steps(FuProgress *progress, guint depth)
+{
+	guint steps = depth == 0 ? 100 : 10;
+	fu_progress_set_steps(progress, steps);
+	for (guint i = 0; i < steps; i++) {
+		if (depth > 0) {
+			FuProgress *child = fu_progress_get_child(progress);
+			fu_progress_set_id(child, G_STRLOC);
+			fu_progress_benchmark_steps(child, depth - 1);
+		}
+		fu_progress_step_done(progress);
+	}
+}
+
+static void
+fu_progress_benchmark_func(void)
+{
+	FuProgressHelper helper = {0};
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+
+	if (!g_test_perf()) {
+		g_test_skip("only run in perf mode");
+		return;
+	}
+
+	/* 1M updates of the leaf through a 5-deep tree */
+	g_signal_connect(FU_PROGRESS(progress),
+			 "percentage-changed",
+			 G_CALLBACK(fu_progress_percentage_changed_cb),
+			 &helper);
+	fu_progress_set_throttle(progress, 100);
+	g_test_timer_start();
+	fu_progress_benchmark_steps(progress, 4);
+	g_test_minimized_result(g_test_timer_elapsed(), "1M steps in %.3fs", g_test_timer_last());
+	g_assert_cmpint(helper.last_percentage, ==, 100);
+}
+
+static FuUdevDevice *
+fu_udev_device_iov_new_tmpfile(gchar **filename)
+{
+	gint fd;
+	g_autoptr(FuUdevDevice) device = g_object_new(FU_TYPE_UDEV_DEVICE, NULL);
+	g_autoptr(GError) error = NULL;
+
+	/* prefer tmpfs so that we are not measuring the disk */
+	if (g_file_test("/dev/shm", G_FILE_TEST_IS_DIR)) {
+		*filename = g_build_filename("/dev/shm", "fwupd-self-test-XXXXXX", NULL);
+		fd = g_mkstemp(*filename);
+	} else {
+		fd = g_file_open_tmp("fwupd-self-test-XXXXXX", filename, &error);
+		g_assert_no_error(error);
+	}
+	g_assert_cmpint(fd, >, 0);
+	fu_udev_device_set_fd(device, fd);
+	return g_steal_pointer(&device);
+}
+
+static void
+fu_udev_device_iov_func(void)
+{
+	gboolean ret;
+	gsize bufsz = 0x100000;
+	g_autofree gchar *filename = NULL;
+	g_autofree guint8 *buf1 = g_malloc0(bufsz);
+	g_autofree guint8 *buf2 = g_malloc0(bufsz);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(FuUdevDevice) device = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) chunks1 = NULL;
+	g_autoptr(GPtrArray) chunks2 = NULL;
+
+#ifndef HAVE_PWRITE
+	g_test_skip("no pwrite support");
+	return;
+#endif
+
+	/* write with chunk sizes that do not align */
+	device = fu_udev_device_iov_new_tmpfile(&filename);
+	for (gsize i = 0; i < bufsz; i++)
+		buf1[i] = i & 0xff;
+	chunks1 = fu_chunk_array_new(buf1, bufsz, 0x0, 0x0, 10 * 1024);
+	ret = fu_udev_device_pwritev(device, chunks1, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* read back */
+	chunks2 = fu_chunk_array_mutable_new(buf2, bufsz, 0x0, 0x0, 10 * 1024);
+	ret = fu_udev_device_preadv(device, chunks2, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(memcmp(buf1, buf2, bufsz), ==, 0);
+	g_assert_cmpint(fu_progress_get_percentage(progress), ==, 100);
+	g_unlink(filename);
+}
+
+static void
+fu_udev_device_iov_benchmark_func(void)
+{
+	gboolean ret;
+	gdouble elapsed;
+	gsize bufsz = 64 * 0x100000;
+	g_autofree gchar *filename = NULL;
+	g_autofree guint8 *buf = NULL;
+	g_autoptr(FuUdevDevice) device = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) chunks = NULL;
+
+#ifndef HAVE_PWRITE
+	g_test_skip("no pwrite support");
+	return;
+#endif
+	if (!g_test_perf()) {
+		g_test_skip("only run in perf mode");
+		return;
+	}
+
+	/* create a 64MiB fake flash device */
+	buf = g_malloc0(bufsz);
+	device = fu_udev_device_iov_new_tmpfile(&filename);
+	chunks = fu_chunk_array_mutable_new(buf, bufsz, 0x0, 0x0, 10 * 1024);
+	ret = fu_udev_device_pwritev(device, chunks, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* one syscall per chunk */
+	g_test_timer_start();
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
+		ret = fu_udev_device_pread_full(device,
+						fu_chunk_get_address(chk),
+						fu_chunk_get_data_out(chk),
+						fu_chunk_get_data_sz(chk),
+						&error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+	}
+	elapsed = g_test_timer_elapsed();
+	g_test_message("pread of 64MiB in 10KiB chunks took %.3fs", elapsed);
+
+	/* batched */
+	g_test_timer_start();
+	ret = fu_udev_device_preadv(device, chunks, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_test_minimized_result(g_test_timer_elapsed(),
+				"preadv of 64MiB in 10KiB chunks took %.3fs",
+				g_test_timer_last());
+	g_unlink(filename);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -3953,6 +5045,11 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/progress{parent-1-step}", fu_progress_parent_one_step_proxy_func);
 	g_test_add_func("/fwupd/progress{no-equal}", fu_progress_non_equal_steps_func);
 	g_test_add_func("/fwupd/progress{finish}", fu_progress_finish_func);
+	g_test_add_func("/fwupd/progress{throttle}", fu_progress_throttle_func);
+	g_test_add_func("/fwupd/progress{throttle-flush}", fu_progress_throttle_flush_func);
+	g_test_add_func("/fwupd/progress{benchmark}", fu_progress_benchmark_func);
+	g_test_add_func("/fwupd/udev-device{iov}", fu_udev_device_iov_func);
+	g_test_add_func("/fwupd/udev-device{iov-benchmark}", fu_udev_device_iov_benchmark_func);
 	g_test_add_func("/fwupd/security-attrs{hsi}", fu_security_attrs_hsi_func);
 	g_test_add_func("/fwupd/plugin{devices}", fu_plugin_devices_func);
 	g_test_add_func("/fwupd/plugin{device-inhibit-children}",
@@ -4013,6 +5110,8 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/firmware{ihex-xml}", fu_firmware_ihex_xml_func);
 	g_test_add_func("/fwupd/firmware{ihex-offset}", fu_firmware_ihex_offset_func);
 	g_test_add_func("/fwupd/firmware{ihex-signed}", fu_firmware_ihex_signed_func);
+	g_test_add_func("/fwupd/firmware{sfdp}", fu_firmware_sfdp_func);
+	g_test_add_func("/fwupd/firmware{sfdp-4bait}", fu_firmware_sfdp_4bait_func);
 	g_test_add_func("/fwupd/firmware{srec-tokenization}", fu_firmware_srec_tokenization_func);
 	g_test_add_func("/fwupd/firmware{srec}", fu_firmware_srec_func);
 	g_test_add_func("/fwupd/firmware{srec-xml}", fu_firmware_srec_xml_func);
@@ -4035,6 +5134,13 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/device{parent}", fu_device_parent_func);
 	g_test_add_func("/fwupd/device{children}", fu_device_children_func);
 	g_test_add_func("/fwupd/device{incorporate}", fu_device_incorporate_func);
+	g_test_add_func("/fwupd/device{events}", fu_device_events_func);
+#ifdef HAVE_GUSB
+	g_test_add_func("/fwupd/usb-device{transfer-chunks}", fu_usb_device_transfer_chunks_func);
+	g_test_add_func("/fwupd/hid-device{set-reports}", fu_hid_device_set_reports_func);
+	g_test_add_func("/fwupd/hid-device{set-reports-interrupt}",
+			fu_hid_device_set_reports_interrupt_func);
+#endif
 	if (g_test_slow())
 		g_test_add_func("/fwupd/device{poll}", fu_device_poll_func);
 	g_test_add_func("/fwupd/device-locker{success}", fu_device_locker_func);
@@ -4046,7 +5152,12 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/device{retry-success}", fu_device_retry_success_func);
 	g_test_add_func("/fwupd/device{retry-failed}", fu_device_retry_failed_func);
 	g_test_add_func("/fwupd/device{retry-hardware}", fu_device_retry_hardware_func);
+	g_test_add_func("/fwupd/device{io-stats}", fu_device_io_stats_func);
 	g_test_add_func("/fwupd/device{cfi-device}", fu_device_cfi_device_func);
+	g_test_add_func("/fwupd/device{cfi-device-address-size}",
+			fu_device_cfi_device_address_size_func);
+	g_test_add_func("/fwupd/device{cfi-device-write-diff}",
+			fu_device_cfi_device_write_diff_func);
 	g_test_add_func("/efi/firmware-section{xml}", fu_efi_firmware_section_xml_func);
 	g_test_add_func("/efi/firmware-file{xml}", fu_efi_firmware_file_xml_func);
 	g_test_add_func("/efi/firmware-filesystem{xml}", fu_efi_firmware_filesystem_xml_func);
@@ -0,0 +1,581 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define G_LOG_DOMAIN "FuFirmware"
+
+#include "config.h"
+
+#include "fu-common.h"
+#include "fu-sfdp-firmware.h"
+
+/**
+ * FuSfdpFirmware:
+ *
+ * A JEDEC Serial Flash Discoverable Parameters table, as defined in JESD216.
+ *
+ * Only the Basic Flash Parameter Table and the 4-byte Address Instruction Table are parsed.
+ *
+ * See also: [class@FuFirmware]
+ */
+
+typedef struct {
+	guint64 flash_size;
+	guint32 page_size;
+	guint32 sector_size;
+	guint8 sector_erase_cmd;
+	guint32 block_size;
+	guint8 block_erase_cmd;
+	guint8 address_size;
+	gboolean address_4byte_only;
+	guint8 sector_erase_type;
+	guint8 block_erase_type;
+	guint8 read_4byte_cmd;
+	guint8 page_prog_4byte_cmd;
+	guint8 sector_erase_4byte_cmd;
+	guint8 block_erase_4byte_cmd;
+} FuSfdpFirmwarePrivate;
+
+G_DEFINE_TYPE_WITH_PRIVATE(FuSfdpFirmware, fu_sfdp_firmware, FU_TYPE_FIRMWARE)
+#define GET_PRIVATE(o) (fu_sfdp_firmware_get_instance_private(o))
+
+#define FU_SFDP_FIRMWARE_SIGNATURE  0x50444653 /* "SFDP" */
+#define FU_SFDP_FIRMWARE_HEADER_SZ  0x08
+#define FU_SFDP_FIRMWARE_PARAM_SZ   0x08
+#define FU_SFDP_FIRMWARE_BFPT_ID    0xFF00
+#define FU_SFDP_FIRMWARE_BFPT_DWMIN 9
+#define FU_SFDP_FIRMWARE_BFPT_DWMAX 16
+#define FU_SFDP_FIRMWARE_4BAIT_ID    0xFF84
+#define FU_SFDP_FIRMWARE_4BAIT_DWMIN 2
+
+/* erase type from dword 1, rather than from the erase type table */
+#define FU_SFDP_FIRMWARE_ERASE_TYPE_UNIFORM 0xFF
+
+static void
+fu_sfdp_firmware_export(FuFirmware *firmware, FuFirmwareExportFlags flags, XbBuilderNode *bn)
+{
+	FuSfdpFirmware *self = FU_SFDP_FIRMWARE(firmware);
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	fu_xmlb_builder_insert_kx(bn, "flash_size", priv->flash_size);
+	fu_xmlb_builder_insert_kx(bn, "page_size", priv->page_size);
+	fu_xmlb_builder_insert_kx(bn, "sector_size", priv->sector_size);
+	fu_xmlb_builder_insert_kx(bn, "sector_erase_cmd", priv->sector_erase_cmd);
+	fu_xmlb_builder_insert_kx(bn, "block_size", priv->block_size);
+	fu_xmlb_builder_insert_kx(bn, "block_erase_cmd", priv->block_erase_cmd);
+	fu_xmlb_builder_insert_kx(bn, "address_size", priv->address_size);
+	fu_xmlb_builder_insert_kb(bn, "address_4byte_only", priv->address_4byte_only);
+	fu_xmlb_builder_insert_kx(bn, "read_4byte_cmd", priv->read_4byte_cmd);
+	fu_xmlb_builder_insert_kx(bn, "page_prog_4byte_cmd", priv->page_prog_4byte_cmd);
+	fu_xmlb_builder_insert_kx(bn, "sector_erase_4byte_cmd", priv->sector_erase_4byte_cmd);
+	fu_xmlb_builder_insert_kx(bn, "block_erase_4byte_cmd", priv->block_erase_4byte_cmd);
+}
+
+/* the same erase and program commands, but using a 32 bit address */
+static guint8
+fu_sfdp_firmware_cmd_to_4byte(guint8 cmd)
+{
+	if (cmd == 0x03) /* read */
+		return 0x13;
+	if (cmd == 0x02) /* page program */
+		return 0x12;
+	if (cmd == 0x20) /* 4KiB erase */
+		return 0x21;
+	if (cmd == 0x52) /* 32KiB erase */
+		return 0x5C;
+	if (cmd == 0xD8) /* 64KiB erase */
+		return 0xDC;
+	return 0x0;
+}
+
+static gboolean
+fu_sfdp_firmware_parse_bfpt(FuSfdpFirmware *self, const guint32 *dw, guint dwsz, GError **error)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+
+	/* density is either the number of bits minus one, or a power of two */
+	if (dw[1] & 0x80000000) {
+		guint32 exp = dw[1] & 0x7FFFFFFF;
+		if (exp < 3 || exp > 63 + 3) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "flash density 2^%u invalid",
+				    exp);
+			return FALSE;
+		}
+		priv->flash_size = (guint64)1 << (exp - 3);
+	} else {
+		priv->flash_size = ((guint64)dw[1] + 1) / 8;
+	}
+
+	/* 3 byte only, 3 or 4 byte, 4 byte only */
+	switch ((dw[0] >> 17) & 0b11) {
+	case 0b00:
+		priv->address_size = 3;
+		break;
+	case 0b01:
+		priv->address_size = priv->flash_size > 0x1000000 ? 4 : 3;
+		break;
+	case 0b10:
+		priv->address_size = 4;
+		break;
+	default:
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "address bytes invalid");
+		return FALSE;
+	}
+
+	/* the smallest erase type is the sector, and the largest the block */
+	for (guint i = 0; i < 4; i++) {
+		guint32 tmp = dw[7 + i / 2] >> ((i % 2) * 16);
+		guint8 exp = tmp & 0xFF;
+		guint8 cmd = (tmp >> 8) & 0xFF;
+		guint32 size;
+		if (exp == 0 || exp > 31)
+			continue;
+		size = (guint32)1 << exp;
+		if (priv->sector_size == 0 || size < priv->sector_size) {
+			priv->sector_size = size;
+			priv->sector_erase_cmd = cmd;
+			priv->sector_erase_type = i;
+		}
+		if (size > priv->block_size) {
+			priv->block_size = size;
+			priv->block_erase_cmd = cmd;
+			priv->block_erase_type = i;
+		}
+	}
+
+	/* fall back to the uniform 4KiB erase */
+	if (priv->sector_size == 0 && (dw[0] & 0b11) == 0b01) {
+		priv->sector_size = 0x1000;
+		priv->sector_erase_cmd = (dw[0] >> 8) & 0xFF;
+		priv->sector_erase_type = FU_SFDP_FIRMWARE_ERASE_TYPE_UNIFORM;
+	}
+	if (priv->block_size == priv->sector_size) {
+		priv->block_size = 0;
+		priv->block_erase_cmd = 0x0;
+	}
+
+	/* page size was only added in JESD216A */
+	if (dwsz >= 11) {
+		guint8 exp = (dw[10] >> 4) & 0x0F;
+		priv->page_size = (guint32)1 << exp;
+	}
+
+	/* 4-byte address entry methods were only added in JESD216B */
+	if (priv->address_size == 4 && ((dw[0] >> 17) & 0b11) == 0b10)
+		priv->address_4byte_only = TRUE;
+	if (priv->address_size == 4 && dwsz >= 16) {
+		guint8 enter = dw[15] >> 24;
+		if (enter & (1 << 6)) {
+			/* always operates in 4-byte address mode */
+			priv->address_4byte_only = TRUE;
+		} else if (enter & (1 << 5)) {
+			/* dedicated 4-byte address instruction set */
+			priv->read_4byte_cmd = fu_sfdp_firmware_cmd_to_4byte(0x03);
+			priv->page_prog_4byte_cmd = fu_sfdp_firmware_cmd_to_4byte(0x02);
+			priv->sector_erase_4byte_cmd =
+			    fu_sfdp_firmware_cmd_to_4byte(priv->sector_erase_cmd);
+			priv->block_erase_4byte_cmd =
+			    fu_sfdp_firmware_cmd_to_4byte(priv->block_erase_cmd);
+		}
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static guint8
+fu_sfdp_firmware_4bait_erase_cmd(const guint32 *dw, guint8 erase_type)
+{
+	if (erase_type >= 4)
+		return 0x0;
+	if ((dw[0] & (1u << (9 + erase_type))) == 0)
+		return 0x0;
+	return (dw[1] >> (erase_type * 8)) & 0xFF;
+}
+
+static void
+fu_sfdp_firmware_parse_4bait(FuSfdpFirmware *self, const guint32 *dw)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+
+	/* the table overrides anything inferred from the BFPT */
+	priv->read_4byte_cmd = dw[0] & (1 << 0) ? 0x13 : 0x0;
+	priv->page_prog_4byte_cmd = dw[0] & (1 << 6) ? 0x12 : 0x0;
+	priv->sector_erase_4byte_cmd = 0x0;
+	if (priv->sector_erase_cmd != 0x0)
+		priv->sector_erase_4byte_cmd =
+		    fu_sfdp_firmware_4bait_erase_cmd(dw, priv->sector_erase_type);
+	priv->block_erase_4byte_cmd = 0x0;
+	if (priv->block_erase_cmd != 0x0)
+		priv->block_erase_4byte_cmd =
+		    fu_sfdp_firmware_4bait_erase_cmd(dw, priv->block_erase_type);
+}
+
+static gboolean
+fu_sfdp_firmware_read_table(const guint8 *buf,
+			    gsize bufsz,
+			    gsize offset,
+			    guint32 *dw,
+			    guint dwmax,
+			    guint *dwsz,
+			    GError **error)
+{
+	guint8 dwsz_tmp = 0;
+	guint32 ptr = 0;
+
+	if (!fu_common_read_uint8_safe(buf, bufsz, offset + 0x3, &dwsz_tmp, error))
+		return FALSE;
+	if (!fu_common_read_uint32_safe(buf, bufsz, offset + 0x4, &ptr, G_LITTLE_ENDIAN, error))
+		return FALSE;
+	ptr &= 0xFFFFFF;
+	*dwsz = MIN(dwsz_tmp, dwmax);
+	for (guint j = 0; j < *dwsz; j++) {
+		if (!fu_common_read_uint32_safe(buf,
+						bufsz,
+						ptr + j * sizeof(guint32),
+						&dw[j],
+						G_LITTLE_ENDIAN,
+						error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_sfdp_firmware_parse(FuFirmware *firmware,
+		       GBytes *fw,
+		       guint64 addr_start,
+		       guint64 addr_end,
+		       FwupdInstallFlags flags,
+		       GError **error)
+{
+	FuSfdpFirmware *self = FU_SFDP_FIRMWARE(firmware);
+	gsize bufsz = 0;
+	const guint8 *buf = g_bytes_get_data(fw, &bufsz);
+	guint8 nph = 0;
+	guint32 sig = 0;
+	guint bfptsz = 0;
+	guint baitsz = 0;
+	guint32 bfpt[FU_SFDP_FIRMWARE_BFPT_DWMAX] = {0x0};
+	guint32 bait[FU_SFDP_FIRMWARE_4BAIT_DWMIN] = {0x0};
+
+	/* header */
+	if (!fu_common_read_uint32_safe(buf, bufsz, 0x0, &sig, G_LITTLE_ENDIAN, error))
+		return FALSE;
+	if (sig != FU_SFDP_FIRMWARE_SIGNATURE) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "signature invalid, got 0x%08x",
+			    sig);
+		return FALSE;
+	}
+	if (!fu_common_read_uint8_safe(buf, bufsz, 0x6, &nph, error))
+		return FALSE;
+
+	/* find the basic flash parameter table, and optionally the 4-byte address table */
+	for (guint i = 0; i < (guint)nph + 1; i++) {
+		gsize offset = FU_SFDP_FIRMWARE_HEADER_SZ + i * FU_SFDP_FIRMWARE_PARAM_SZ;
+		guint8 id_lsb = 0;
+		guint8 id_msb = 0;
+		guint16 id;
+
+		if (!fu_common_read_uint8_safe(buf, bufsz, offset + 0x0, &id_lsb, error))
+			return FALSE;
+		if (!fu_common_read_uint8_safe(buf, bufsz, offset + 0x7, &id_msb, error))
+			return FALSE;
+		id = ((guint16)id_msb << 8) | id_lsb;
+		if (id == FU_SFDP_FIRMWARE_BFPT_ID && bfptsz == 0) {
+			if (!fu_sfdp_firmware_read_table(buf,
+							 bufsz,
+							 offset,
+							 bfpt,
+							 G_N_ELEMENTS(bfpt),
+							 &bfptsz,
+							 error))
+				return FALSE;
+			if (bfptsz < FU_SFDP_FIRMWARE_BFPT_DWMIN) {
+				g_set_error(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INVALID_FILE,
+					    "basic flash parameter table too small, got %u dwords",
+					    bfptsz);
+				return FALSE;
+			}
+		} else if (id == FU_SFDP_FIRMWARE_4BAIT_ID && baitsz == 0) {
+			if (!fu_sfdp_firmware_read_table(buf,
+							 bufsz,
+							 offset,
+							 bait,
+							 G_N_ELEMENTS(bait),
+							 &baitsz,
+							 error))
+				return FALSE;
+		}
+	}
+	if (bfptsz == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "no basic flash parameter table");
+		return FALSE;
+	}
+	if (!fu_sfdp_firmware_parse_bfpt(self, bfpt, bfptsz, error))
+		return FALSE;
+	if (baitsz >= FU_SFDP_FIRMWARE_4BAIT_DWMIN)
+		fu_sfdp_firmware_parse_4bait(self, bait);
+
+	/* success */
+	return TRUE;
+}
+
+/**
+ * fu_sfdp_firmware_get_flash_size:
+ * @self: a #FuSfdpFirmware
+ *
+ * Gets the flash chip size.
+ *
+ * Returns: size in bytes, or 0 if unset
+ *
+ * Since: 1.8.0
+ **/
+guint64
+fu_sfdp_firmware_get_flash_size(FuSfdpFirmware *self)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_SFDP_FIRMWARE(self), 0);
+	return priv->flash_size;
+}
+
+/**
+ * fu_sfdp_firmware_get_page_size:
+ * @self: a #FuSfdpFirmware
+ *
+ * Gets the page program size.
+ *
+ * Returns: size in bytes, or 0 if unset
+ *
+ * Since: 1.8.0
+ **/
+guint32
+fu_sfdp_firmware_get_page_size(FuSfdpFirmware *self)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_SFDP_FIRMWARE(self), 0);
+	return priv->page_size;
+}
+
+/**
+ * fu_sfdp_firmware_get_sector_size:
+ * @self: a #FuSfdpFirmware
+ *
+ * Gets the smallest erase size.
+ *
+ * Returns: size in bytes, or 0 if unset
+ *
+ * Since: 1.8.0
+ **/
+guint32
+fu_sfdp_firmware_get_sector_size(FuSfdpFirmware *self)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_SFDP_FIRMWARE(self), 0);
+	return priv->sector_size;
+}
+
+/**
+ * fu_sfdp_firmware_get_sector_erase_cmd:
+ * @self: a #FuSfdpFirmware
+ *
+ * Gets the command used to erase one sector.
+ *
+ * Returns: opcode, or 0x0 if unset
+ *
+ * Since: 1.8.0
+ **/
+guint8
+fu_sfdp_firmware_get_sector_erase_cmd(FuSfdpFirmware *self)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_SFDP_FIRMWARE(self), 0x0);
+	return priv->sector_erase_cmd;
+}
+
+/**
+ * fu_sfdp_firmware_get_block_size:
+ * @self: a #FuSfdpFirmware
+ *
+ * Gets the largest erase size, if different to the sector size.
+ *
+ * Returns: size in bytes, or 0 if unset
+ *
+ * Since: 1.8.0
+ **/
+guint32
+fu_sfdp_firmware_get_block_size(FuSfdpFirmware *self)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_SFDP_FIRMWARE(self), 0);
+	return priv->block_size;
+}
+
+/**
+ * fu_sfdp_firmware_get_block_erase_cmd:
+ * @self: a #FuSfdpFirmware
+ *
+ * Gets the command used to erase one block.
+ *
+ * Returns: opcode, or 0x0 if unset
+ *
+ * Since: 1.8.0
+ **/
+guint8
+fu_sfdp_firmware_get_block_erase_cmd(FuSfdpFirmware *self)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_SFDP_FIRMWARE(self), 0x0);
+	return priv->block_erase_cmd;
+}
+
+/**
+ * fu_sfdp_firmware_get_address_size:
+ * @self: a #FuSfdpFirmware
+ *
+ * Gets the number of address bytes required to access the whole chip.
+ *
+ * Returns: 3 or 4, or 0 if unset
+ *
+ * Since: 1.8.0
+ **/
+guint8
+fu_sfdp_firmware_get_address_size(FuSfdpFirmware *self)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_SFDP_FIRMWARE(self), 0);
+	return priv->address_size;
+}
+
+/**
+ * fu_sfdp_firmware_get_address_4byte_only:
+ * @self: a #FuSfdpFirmware
+ *
+ * Gets if the chip always uses 4 address bytes, even for the standard 3-byte commands.
+ *
+ * Returns: %TRUE if the standard commands take a 32 bit address
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fu_sfdp_firmware_get_address_4byte_only(FuSfdpFirmware *self)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_SFDP_FIRMWARE(self), FALSE);
+	return priv->address_4byte_only;
+}
+
+/**
+ * fu_sfdp_firmware_get_read_4byte_cmd:
+ * @self: a #FuSfdpFirmware
+ *
+ * Gets the command used to read data using a 32 bit address.
+ *
+ * Returns: opcode, or 0x0 if the chip does not advertise one
+ *
+ * Since: 1.8.0
+ **/
+guint8
+fu_sfdp_firmware_get_read_4byte_cmd(FuSfdpFirmware *self)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_SFDP_FIRMWARE(self), 0x0);
+	return priv->read_4byte_cmd;
+}
+
+/**
+ * fu_sfdp_firmware_get_page_prog_4byte_cmd:
+ * @self: a #FuSfdpFirmware
+ *
+ * Gets the command used to program one page using a 32 bit address.
+ *
+ * Returns: opcode, or 0x0 if the chip does not advertise one
+ *
+ * Since: 1.8.0
+ **/
+guint8
+fu_sfdp_firmware_get_page_prog_4byte_cmd(FuSfdpFirmware *self)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_SFDP_FIRMWARE(self), 0x0);
+	return priv->page_prog_4byte_cmd;
+}
+
+/**
+ * fu_sfdp_firmware_get_sector_erase_4byte_cmd:
+ * @self: a #FuSfdpFirmware
+ *
+ * Gets the command used to erase one sector using a 32 bit address.
+ *
+ * Returns: opcode, or 0x0 if the chip does not advertise one
+ *
+ * Since: 1.8.0
+ **/
+guint8
+fu_sfdp_firmware_get_sector_erase_4byte_cmd(FuSfdpFirmware *self)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_SFDP_FIRMWARE(self), 0x0);
+	return priv->sector_erase_4byte_cmd;
+}
+
+/**
+ * fu_sfdp_firmware_get_block_erase_4byte_cmd:
+ * @self: a #FuSfdpFirmware
+ *
+ * Gets the command used to erase one block using a 32 bit address.
+ *
+ * Returns: opcode, or 0x0 if the chip does not advertise one
+ *
+ * Since: 1.8.0
+ **/
+guint8
+fu_sfdp_firmware_get_block_erase_4byte_cmd(FuSfdpFirmware *self)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_SFDP_FIRMWARE(self), 0x0);
+	return priv->block_erase_4byte_cmd;
+}
+
+static void
+fu_sfdp_firmware_init(FuSfdpFirmware *self)
+{
+	FuSfdpFirmwarePrivate *priv = GET_PRIVATE(self);
+	priv->page_size = 0x100;
+}
+
+static void
+fu_sfdp_firmware_class_init(FuSfdpFirmwareClass *klass)
+{
+	FuFirmwareClass *klass_firmware = FU_FIRMWARE_CLASS(klass);
+	klass_firmware->parse = fu_sfdp_firmware_parse;
+	klass_firmware->export = fu_sfdp_firmware_export;
+}
+
+/**
+ * fu_sfdp_firmware_new:
+ *
+ * Creates a new #FuFirmware of sub type SFDP
+ *
+ * Since: 1.8.0
+ **/
+FuFirmware *
+fu_sfdp_firmware_new(void)
+{
+	return FU_FIRMWARE(g_object_new(FU_TYPE_SFDP_FIRMWARE, NULL));
+}
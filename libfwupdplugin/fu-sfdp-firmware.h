@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include "fu-firmware.h"
+
+#define FU_TYPE_SFDP_FIRMWARE (fu_sfdp_firmware_get_type())
+G_DECLARE_DERIVABLE_TYPE(FuSfdpFirmware, fu_sfdp_firmware, FU, SFDP_FIRMWARE, FuFirmware)
+
+struct _FuSfdpFirmwareClass {
+	FuFirmwareClass parent_class;
+};
+
+FuFirmware *
+fu_sfdp_firmware_new(void);
+guint64
+fu_sfdp_firmware_get_flash_size(FuSfdpFirmware *self);
+guint32
+fu_sfdp_firmware_get_page_size(FuSfdpFirmware *self);
+guint32
+fu_sfdp_firmware_get_sector_size(FuSfdpFirmware *self);
+guint8
+fu_sfdp_firmware_get_sector_erase_cmd(FuSfdpFirmware *self);
+guint32
+fu_sfdp_firmware_get_block_size(FuSfdpFirmware *self);
+guint8
+fu_sfdp_firmware_get_block_erase_cmd(FuSfdpFirmware *self);
+guint8
+fu_sfdp_firmware_get_address_size(FuSfdpFirmware *self);
+gboolean
+fu_sfdp_firmware_get_address_4byte_only(FuSfdpFirmware *self);
+guint8
+fu_sfdp_firmware_get_read_4byte_cmd(FuSfdpFirmware *self);
+guint8
+fu_sfdp_firmware_get_page_prog_4byte_cmd(FuSfdpFirmware *self);
+guint8
+fu_sfdp_firmware_get_sector_erase_4byte_cmd(FuSfdpFirmware *self);
+guint8
+fu_sfdp_firmware_get_block_erase_4byte_cmd(FuSfdpFirmware *self);
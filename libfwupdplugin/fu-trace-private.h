@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+/*
+ * Static tracepoints for systemtap and bpftrace, e.g.
+ *
+ *   bpftrace -l 'usdt:/usr/libexec/fwupd/fwupd:fwupd:*'
+ *
+ * Each probe is a single `nop` in the hot path and nothing is recorded unless a tracer attaches
+ * to it. Only pass values that are already computed or are trivial to get, as the arguments are
+ * evaluated even when no tracer is attached.
+ *
+ * See contrib/bpftrace for scripts that use these probes.
+ */
+
+#ifdef HAVE_SDT_H
+#include <sys/sdt.h>
+#define FU_TRACE1(name, a) DTRACE_PROBE1(fwupd, name, a)
+#define FU_TRACE2(name, a, b) DTRACE_PROBE2(fwupd, name, a, b)
+#define FU_TRACE3(name, a, b, c) DTRACE_PROBE3(fwupd, name, a, b, c)
+#define FU_TRACE4(name, a, b, c, d) DTRACE_PROBE4(fwupd, name, a, b, c, d)
+#else
+#define FU_TRACE1(name, a) G_STMT_START {} G_STMT_END
+#define FU_TRACE2(name, a, b) G_STMT_START {} G_STMT_END
+#define FU_TRACE3(name, a, b, c) G_STMT_START {} G_STMT_END
+#define FU_TRACE4(name, a, b, c, d) G_STMT_START {} G_STMT_END
+#endif
@@ -19,10 +19,20 @@
 #include <glib/gstdio.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#ifdef HAVE_PREADV
+#include <limits.h>
+#include <sys/uio.h>
+#endif
 #include <unistd.h>
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
 
+#include "fu-chunk.h"
+#include "fu-common.h"
 #include "fu-device-private.h"
 #include "fu-i2c-device.h"
+#include "fu-trace-private.h"
 #include "fu-udev-device-private.h"
 
 /**
@@ -66,6 +76,8 @@ static guint signals[SIGNAL_LAST] = {0};
 
 #define GET_PRIVATE(o) (fu_udev_device_get_instance_private(o))
 
+#define FU_UDEV_DEVICE_IO_URING_DEPTH 32
+
 /**
  * fu_udev_device_emit_changed:
  * @self: a #FuUdevDevice
@@ -1284,6 +1296,10 @@ fu_udev_device_open(FuDevice *device, GError **error)
 	FuUdevDevice *self = FU_UDEV_DEVICE(device);
 	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
 
+	/* all requests are loaded from the saved events */
+	if (fu_device_has_internal_flag(device, FU_DEVICE_INTERNAL_FLAG_EMULATED))
+		return TRUE;
+
 	/* open device */
 	if (priv->device_file != NULL && priv->flags != FU_UDEV_DEVICE_FLAG_NONE) {
 		gint flags;
@@ -1374,6 +1390,18 @@ fu_udev_device_close(FuDevice *device, GError **error)
 	return TRUE;
 }
 
+#ifdef HAVE_IOCTL_H
+/* the CRC of the request buffer is included so that replay checks what was sent */
+static gchar *
+fu_udev_device_ioctl_event_id(gulong request, const guint8 *buf, gsize bufsz)
+{
+	return g_strdup_printf("Ioctl:Request=0x%lx,Length=0x%x,Crc=0x%08x",
+			       request,
+			       (guint)bufsz,
+			       fu_common_crc32(buf, bufsz));
+}
+#endif
+
 /**
  * fu_udev_device_ioctl:
  * @self: a #FuUdevDevice
@@ -1394,12 +1422,34 @@ fu_udev_device_ioctl(FuUdevDevice *self, gulong request, guint8 *buf, gint *rc,
 #ifdef HAVE_IOCTL_H
 	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
 	gint rc_tmp;
+	gint64 start;
+	gsize bufsz = 0;
+	g_autofree gchar *event_id = NULL;
+	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_UDEV_DEVICE(self), FALSE);
 	g_return_val_if_fail(request != 0x0, FALSE);
 	g_return_val_if_fail(buf != NULL, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
+	/* only the buffer size encoded in the request can be saved */
+#ifdef _IOC_SIZE
+	bufsz = _IOC_SIZE(request);
+#endif
+
+	/* emulated */
+	if (fu_device_has_internal_flag(FU_DEVICE(self), FU_DEVICE_INTERNAL_FLAG_EMULATED)) {
+		FuDeviceEvent *event;
+
+		event_id = fu_udev_device_ioctl_event_id(request, buf, bufsz);
+		event = fu_device_load_event(FU_DEVICE(self), event_id, error);
+		if (event == NULL)
+			return FALSE;
+		if (rc != NULL)
+			*rc = fu_device_event_get_rc(event);
+		return fu_device_event_copy_data(event, buf, bufsz, error);
+	}
+
 	/* not open! */
 	if (priv->fd == 0) {
 		g_set_error(error,
@@ -1411,26 +1461,50 @@ fu_udev_device_ioctl(FuUdevDevice *self, gulong request, guint8 *buf, gint *rc,
 		return FALSE;
 	}
 
+	if (fu_device_has_save_events(FU_DEVICE(self)))
+		event_id = fu_udev_device_ioctl_event_id(request, buf, bufsz);
+	FU_TRACE3(udev_ioctl_entry, priv->fd, request, bufsz);
+	start = g_get_monotonic_time();
 	rc_tmp = ioctl(priv->fd, request, buf);
+	FU_TRACE3(udev_ioctl_exit, priv->fd, request, rc_tmp);
 	if (rc != NULL)
 		*rc = rc_tmp;
 	if (rc_tmp < 0) {
 #ifdef HAVE_ERRNO_H
 		if (errno == EPERM) {
-			g_set_error_literal(error,
+			g_set_error_literal(&error_local,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_PERMISSION_DENIED,
 					    "permission denied");
-			return FALSE;
+		} else {
+			g_set_error(&error_local,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "ioctl error: %s",
+				    strerror(errno));
 		}
-		g_set_error(error,
+#else
+		g_set_error(&error_local,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
-			    "ioctl error: %s",
-			    strerror(errno));
-#else
-		g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "unspecified ioctl error");
+			    "unspecified ioctl error");
 #endif
+	} else {
+		fu_device_add_io_stats(FU_DEVICE(self),
+				       "Ioctl",
+				       bufsz,
+				       g_get_monotonic_time() - start);
+	}
+
+	/* save, including any failure so that it is replayed too */
+	if (event_id != NULL) {
+		FuDeviceEvent *event = fu_device_save_event(FU_DEVICE(self), event_id);
+		fu_device_event_set_rc(event, rc_tmp);
+		fu_device_event_set_data_raw(event, buf, bufsz);
+		fu_device_event_set_error(event, error_local);
+	}
+	if (error_local != NULL) {
+		g_propagate_error(error, g_steal_pointer(&error_local));
 		return FALSE;
 	}
 	return TRUE;
@@ -1465,11 +1539,30 @@ fu_udev_device_pread_full(FuUdevDevice *self,
 			  GError **error)
 {
 	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
+#ifdef HAVE_PWRITE
+	gssize rc_tmp;
+	gint64 start;
+	g_autoptr(GError) error_local = NULL;
+#endif
+	g_autofree gchar *event_id = NULL;
 
 	g_return_val_if_fail(FU_IS_UDEV_DEVICE(self), FALSE);
 	g_return_val_if_fail(buf != NULL, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
+	/* emulated */
+	if (fu_device_has_internal_flag(FU_DEVICE(self), FU_DEVICE_INTERNAL_FLAG_EMULATED) ||
+	    fu_device_has_save_events(FU_DEVICE(self))) {
+		event_id =
+		    g_strdup_printf("Pread:Port=0x%x,Length=0x%x", (guint)port, (guint)bufsz);
+	}
+	if (fu_device_has_internal_flag(FU_DEVICE(self), FU_DEVICE_INTERNAL_FLAG_EMULATED)) {
+		FuDeviceEvent *event = fu_device_load_event(FU_DEVICE(self), event_id, error);
+		if (event == NULL)
+			return FALSE;
+		return fu_device_event_copy_data(event, buf, bufsz, error);
+	}
+
 	/* not open! */
 	if (priv->fd == 0) {
 		g_set_error(error,
@@ -1482,13 +1575,33 @@ fu_udev_device_pread_full(FuUdevDevice *self,
 	}
 
 #ifdef HAVE_PWRITE
-	if (pread(priv->fd, buf, bufsz, port) != (gssize)bufsz) {
-		g_set_error(error,
+	FU_TRACE3(udev_pread_entry, priv->fd, port, bufsz);
+	start = g_get_monotonic_time();
+	rc_tmp = pread(priv->fd, buf, bufsz, port);
+	FU_TRACE3(udev_pread_exit, priv->fd, port, rc_tmp);
+	if (rc_tmp != (gssize)bufsz) {
+		g_set_error(&error_local,
 			    G_IO_ERROR,
 			    G_IO_ERROR_FAILED,
 			    "failed to read from port 0x%04x: %s",
 			    (guint)port,
 			    strerror(errno));
+	} else {
+		fu_device_add_io_stats(FU_DEVICE(self),
+				       "Pread",
+				       bufsz,
+				       g_get_monotonic_time() - start);
+	}
+
+	/* save, including any failure so that it is replayed too */
+	if (event_id != NULL) {
+		FuDeviceEvent *event = fu_device_save_event(FU_DEVICE(self), event_id);
+		if (error_local == NULL)
+			fu_device_event_set_data_raw(event, buf, bufsz);
+		fu_device_event_set_error(event, error_local);
+	}
+	if (error_local != NULL) {
+		g_propagate_error(error, g_steal_pointer(&error_local));
 		return FALSE;
 	}
 	return TRUE;
@@ -1501,6 +1614,422 @@ fu_udev_device_pread_full(FuUdevDevice *self,
 #endif
 }
 
+#ifdef HAVE_LIBURING
+/* the requests use &iov[idx] as the user data, and cancel requests use NULL */
+static void
+fu_udev_device_io_uring_cancel(struct io_uring *ring,
+			       struct iovec *iov,
+			       gboolean *inflight,
+			       guint iovsz,
+			       guint *completed,
+			       guint submitted)
+{
+	gint rc;
+
+	/* ask the kernel to stop everything still in flight */
+	for (guint i = 0; i < iovsz; i++) {
+		struct io_uring_sqe *sqe;
+		if (!inflight[i])
+			continue;
+		sqe = io_uring_get_sqe(ring);
+		if (sqe == NULL) {
+			io_uring_submit(ring);
+			sqe = io_uring_get_sqe(ring);
+			if (sqe == NULL)
+				break;
+		}
+		io_uring_prep_cancel(sqe, &iov[i], 0);
+		io_uring_sqe_set_data(sqe, NULL);
+	}
+	io_uring_submit(ring);
+
+	/* the buffers belong to the caller, so reap every request before returning */
+	while (*completed < submitted) {
+		struct io_uring_cqe *cqe = NULL;
+		struct iovec *iov_done;
+		rc = io_uring_wait_cqe(ring, &cqe);
+		if (rc == -EINTR)
+			continue;
+		if (rc < 0) {
+			g_debug("failed to reap cancelled io_uring requests: %s", strerror(-rc));
+			break;
+		}
+		iov_done = io_uring_cqe_get_data(cqe);
+		io_uring_cqe_seen(ring, cqe);
+		if (iov_done == NULL)
+			continue;
+		inflight[iov_done - iov] = FALSE;
+		(*completed)++;
+	}
+}
+
+static gboolean
+fu_udev_device_io_uring_read_chunks(FuUdevDevice *self,
+				    GPtrArray *chunks,
+				    FuProgress *progress,
+				    GError **error)
+{
+	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
+	gboolean ret = TRUE;
+	gint rc;
+	gint64 start = g_get_monotonic_time();
+	gsize done = 0;
+	gsize total = 0;
+	guint completed = 0;
+	guint submitted = 0;
+	struct io_uring ring;
+	g_autofree struct iovec *iov = g_new0(struct iovec, chunks->len);
+	g_autofree gboolean *inflight = g_new0(gboolean, chunks->len);
+
+	rc = io_uring_queue_init(FU_UDEV_DEVICE_IO_URING_DEPTH, &ring, 0);
+	if (rc < 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "failed to set up io_uring: %s",
+			    strerror(-rc));
+		return FALSE;
+	}
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
+		iov[i].iov_base = fu_chunk_get_data_out(chk);
+		iov[i].iov_len = fu_chunk_get_data_sz(chk);
+		total += iov[i].iov_len;
+	}
+
+	/* keep up to FU_UDEV_DEVICE_IO_URING_DEPTH requests in flight */
+	while (completed < submitted || (ret && submitted < chunks->len)) {
+		guint queued = 0;
+		struct io_uring_cqe *cqe = NULL;
+
+		while (ret && submitted + queued < chunks->len &&
+		       submitted + queued - completed < FU_UDEV_DEVICE_IO_URING_DEPTH) {
+			guint idx = submitted + queued;
+			FuChunk *chk = g_ptr_array_index(chunks, idx);
+			struct io_uring_sqe *sqe = io_uring_get_sqe(&ring);
+			if (sqe == NULL)
+				break;
+			io_uring_prep_readv(sqe, priv->fd, &iov[idx], 1, fu_chunk_get_address(chk));
+			io_uring_sqe_set_data(sqe, &iov[idx]);
+			queued++;
+		}
+		if (queued > 0) {
+			rc = io_uring_submit(&ring);
+			if (rc < 0) {
+				g_set_error(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_FAILED,
+					    "failed to submit io_uring requests: %s",
+					    strerror(-rc));
+				ret = FALSE;
+			} else {
+				for (guint i = 0; i < queued; i++)
+					inflight[submitted + i] = TRUE;
+				submitted += queued;
+			}
+		}
+		if (completed == submitted)
+			continue;
+
+		/* the buffers belong to the caller, so wait for everything in flight */
+		rc = io_uring_wait_cqe(&ring, &cqe);
+		if (rc == -EINTR)
+			continue;
+		if (rc < 0) {
+			if (ret) {
+				g_set_error(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_FAILED,
+					    "failed to wait for io_uring: %s",
+					    strerror(-rc));
+			}
+			ret = FALSE;
+			fu_udev_device_io_uring_cancel(&ring,
+						       iov,
+						       inflight,
+						       chunks->len,
+						       &completed,
+						       submitted);
+			break;
+		}
+
+		/* reap everything that has completed */
+		while (io_uring_peek_cqe(&ring, &cqe) == 0) {
+			struct iovec *iov_done = io_uring_cqe_get_data(cqe);
+			guint idx = iov_done - iov;
+			FuChunk *chk = g_ptr_array_index(chunks, idx);
+			gint res = cqe->res;
+			io_uring_cqe_seen(&ring, cqe);
+			inflight[idx] = FALSE;
+			completed++;
+			if (!ret)
+				continue;
+			if (res < 0) {
+				g_set_error(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_FAILED,
+					    "failed to read @0x%x: %s",
+					    (guint)fu_chunk_get_address(chk),
+					    strerror(-res));
+				ret = FALSE;
+				continue;
+			}
+			if ((guint32)res != fu_chunk_get_data_sz(chk)) {
+				g_set_error(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_PARTIAL_INPUT,
+					    "incomplete read @0x%x, got 0x%x bytes",
+					    (guint)fu_chunk_get_address(chk),
+					    (guint)res);
+				ret = FALSE;
+				continue;
+			}
+			done += res;
+		}
+		if (ret && progress != NULL)
+			fu_progress_set_percentage_full(progress, done, total);
+	}
+	io_uring_queue_exit(&ring);
+
+	/* the requests complete out of order, so account for the whole batch */
+	if (ret) {
+		fu_device_add_io_stats(FU_DEVICE(self),
+				       "IoUringRead",
+				       total,
+				       g_get_monotonic_time() - start);
+	}
+	return ret;
+}
+#endif
+
+#ifdef HAVE_PREADV
+static guint
+fu_udev_device_get_iov_max(void)
+{
+#ifdef _SC_IOV_MAX
+	glong rc = sysconf(_SC_IOV_MAX);
+	if (rc > 0)
+		return (guint)MIN(rc, G_MAXINT);
+#endif
+#ifdef IOV_MAX
+	return IOV_MAX;
+#else
+	return _XOPEN_IOV_MAX;
+#endif
+}
+
+static gboolean
+fu_udev_device_iov_chunks(FuUdevDevice *self,
+			  GPtrArray *chunks,
+			  gboolean write,
+			  FuProgress *progress,
+			  GError **error)
+{
+	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
+	gsize done = 0;
+	gsize total = 0;
+	guint idx = 0;
+	guint iov_max = fu_udev_device_get_iov_max();
+	g_autofree struct iovec *iov = g_new0(struct iovec, MIN(chunks->len, iov_max));
+
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
+		total += fu_chunk_get_data_sz(chk);
+	}
+	while (idx < chunks->len) {
+		FuChunk *chk_first = g_ptr_array_index(chunks, idx);
+		goffset offset = fu_chunk_get_address(chk_first);
+		gsize iovsz = 0;
+		guint iovcnt = 0;
+		struct iovec *iov_ptr = iov;
+
+		/* batch up as many contiguous chunks as possible */
+		while (idx < chunks->len && iovcnt < iov_max) {
+			FuChunk *chk = g_ptr_array_index(chunks, idx);
+			if (fu_chunk_get_address(chk) != offset + iovsz)
+				break;
+			iov[iovcnt].iov_base =
+			    write ? (gpointer)fu_chunk_get_data(chk) : fu_chunk_get_data_out(chk);
+			iov[iovcnt].iov_len = fu_chunk_get_data_sz(chk);
+			iovsz += iov[iovcnt].iov_len;
+			iovcnt++;
+			idx++;
+		}
+
+		/* the kernel is allowed to transfer less than requested */
+		while (iovcnt > 0) {
+			gint64 start = g_get_monotonic_time();
+			gssize rc = write ? pwritev(priv->fd, iov_ptr, iovcnt, offset)
+					  : preadv(priv->fd, iov_ptr, iovcnt, offset);
+			if (rc < 0 && errno == EINTR)
+				continue;
+			if (rc <= 0) {
+				g_set_error(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_FAILED,
+					    "failed to %s @0x%x: %s",
+					    write ? "write" : "read",
+					    (guint)offset,
+					    rc < 0 ? strerror(errno) : "no data");
+				return FALSE;
+			}
+			fu_device_add_io_stats(FU_DEVICE(self),
+					       write ? "Pwritev" : "Preadv",
+					       rc,
+					       g_get_monotonic_time() - start);
+			offset += rc;
+			done += rc;
+
+			/* skip over the buffers that have been completed */
+			while (iovcnt > 0 && (gsize)rc >= iov_ptr->iov_len) {
+				rc -= iov_ptr->iov_len;
+				iov_ptr++;
+				iovcnt--;
+			}
+			if (iovcnt > 0) {
+				iov_ptr->iov_base = (guint8 *)iov_ptr->iov_base + rc;
+				iov_ptr->iov_len -= rc;
+			}
+		}
+		if (progress != NULL)
+			fu_progress_set_percentage_full(progress, done, total);
+	}
+	return TRUE;
+}
+#endif
+
+static gboolean
+fu_udev_device_io_chunks_serial(FuUdevDevice *self,
+				GPtrArray *chunks,
+				gboolean write,
+				FuProgress *progress,
+				GError **error)
+{
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
+		if (write) {
+			if (!fu_udev_device_pwrite_full(self,
+							fu_chunk_get_address(chk),
+							fu_chunk_get_data(chk),
+							fu_chunk_get_data_sz(chk),
+							error))
+				return FALSE;
+		} else {
+			if (!fu_udev_device_pread_full(self,
+						       fu_chunk_get_address(chk),
+						       fu_chunk_get_data_out(chk),
+						       fu_chunk_get_data_sz(chk),
+						       error))
+				return FALSE;
+		}
+		if (progress != NULL)
+			fu_progress_set_percentage_full(progress, i + 1, chunks->len);
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_udev_device_io_chunks(FuUdevDevice *self,
+			 GPtrArray *chunks,
+			 gboolean write,
+			 FuProgress *progress,
+			 GError **error)
+{
+	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
+
+	/* each chunk is saved or loaded as a separate event */
+	if (fu_device_has_internal_flag(FU_DEVICE(self), FU_DEVICE_INTERNAL_FLAG_EMULATED) ||
+	    fu_device_has_save_events(FU_DEVICE(self)))
+		return fu_udev_device_io_chunks_serial(self, chunks, write, progress, error);
+
+	/* not open! */
+	if (priv->fd == 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "%s [%s] has not been opened",
+			    fu_device_get_id(FU_DEVICE(self)),
+			    fu_device_get_name(FU_DEVICE(self)));
+		return FALSE;
+	}
+	if (chunks->len == 0)
+		return TRUE;
+
+#ifdef HAVE_LIBURING
+	/* the requests complete out of order, which is only safe when reading -- the kernel may
+	 * also not support it, or it may be blocked by seccomp */
+	if (!write && chunks->len > 1) {
+		g_autoptr(GError) error_local = NULL;
+		if (fu_udev_device_io_uring_read_chunks(self, chunks, progress, &error_local))
+			return TRUE;
+		if (!g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
+			g_propagate_error(error, g_steal_pointer(&error_local));
+			return FALSE;
+		}
+		g_debug("falling back to vectored I/O: %s", error_local->message);
+	}
+#endif
+#ifdef HAVE_PREADV
+	return fu_udev_device_iov_chunks(self, chunks, write, progress, error);
+#else
+	return fu_udev_device_io_chunks_serial(self, chunks, write, progress, error);
+#endif
+}
+
+/**
+ * fu_udev_device_preadv:
+ * @self: a #FuUdevDevice
+ * @chunks: (element-type FuChunk): chunks created with fu_chunk_array_mutable_new()
+ * @progress: (nullable): a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Reads each chunk from the file descriptor at the chunk address, submitting many chunks
+ * for each syscall rather than calling fu_udev_device_pread_full() in a loop.
+ *
+ * If @progress is set then the percentage is updated as each batch completes.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fu_udev_device_preadv(FuUdevDevice *self, GPtrArray *chunks, FuProgress *progress, GError **error)
+{
+	g_return_val_if_fail(FU_IS_UDEV_DEVICE(self), FALSE);
+	g_return_val_if_fail(chunks != NULL, FALSE);
+	g_return_val_if_fail(progress == NULL || FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	return fu_udev_device_io_chunks(self, chunks, FALSE, progress, error);
+}
+
+/**
+ * fu_udev_device_pwritev:
+ * @self: a #FuUdevDevice
+ * @chunks: (element-type FuChunk): chunks of data
+ * @progress: (nullable): a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Writes each chunk to the file descriptor at the chunk address, submitting many chunks
+ * for each syscall rather than calling fu_udev_device_pwrite_full() in a loop.
+ *
+ * The chunks are always written in order.
+ *
+ * If @progress is set then the percentage is updated as each batch completes.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fu_udev_device_pwritev(FuUdevDevice *self, GPtrArray *chunks, FuProgress *progress, GError **error)
+{
+	g_return_val_if_fail(FU_IS_UDEV_DEVICE(self), FALSE);
+	g_return_val_if_fail(chunks != NULL, FALSE);
+	g_return_val_if_fail(progress == NULL || FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	return fu_udev_device_io_chunks(self, chunks, TRUE, progress, error);
+}
+
 /**
  * fu_udev_device_seek:
  * @self: a #FuUdevDevice
@@ -1574,10 +2103,27 @@ fu_udev_device_pwrite_full(FuUdevDevice *self,
 			   GError **error)
 {
 	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
+#ifdef HAVE_PWRITE
+	gssize rc_tmp;
+	gint64 start;
+	g_autoptr(GError) error_local = NULL;
+#endif
+	g_autofree gchar *event_id = NULL;
 
 	g_return_val_if_fail(FU_IS_UDEV_DEVICE(self), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
+	/* emulated */
+	if (fu_device_has_internal_flag(FU_DEVICE(self), FU_DEVICE_INTERNAL_FLAG_EMULATED) ||
+	    fu_device_has_save_events(FU_DEVICE(self))) {
+		event_id = g_strdup_printf("Pwrite:Port=0x%x,Length=0x%x,Crc=0x%08x",
+					   (guint)port,
+					   (guint)bufsz,
+					   fu_common_crc32(buf, bufsz));
+	}
+	if (fu_device_has_internal_flag(FU_DEVICE(self), FU_DEVICE_INTERNAL_FLAG_EMULATED))
+		return fu_device_load_event(FU_DEVICE(self), event_id, error) != NULL;
+
 	/* not open! */
 	if (priv->fd == 0) {
 		g_set_error(error,
@@ -1590,13 +2136,31 @@ fu_udev_device_pwrite_full(FuUdevDevice *self,
 	}
 
 #ifdef HAVE_PWRITE
-	if (pwrite(priv->fd, buf, bufsz, port) != (gssize)bufsz) {
-		g_set_error(error,
+	FU_TRACE3(udev_pwrite_entry, priv->fd, port, bufsz);
+	start = g_get_monotonic_time();
+	rc_tmp = pwrite(priv->fd, buf, bufsz, port);
+	FU_TRACE3(udev_pwrite_exit, priv->fd, port, rc_tmp);
+	if (rc_tmp != (gssize)bufsz) {
+		g_set_error(&error_local,
 			    G_IO_ERROR,
 			    G_IO_ERROR_FAILED,
 			    "failed to write to port %04x: %s",
 			    (guint)port,
 			    strerror(errno));
+	} else {
+		fu_device_add_io_stats(FU_DEVICE(self),
+				       "Pwrite",
+				       bufsz,
+				       g_get_monotonic_time() - start);
+	}
+
+	/* save, including any failure so that it is replayed too */
+	if (event_id != NULL) {
+		FuDeviceEvent *event = fu_device_save_event(FU_DEVICE(self), event_id);
+		fu_device_event_set_error(event, error_local);
+	}
+	if (error_local != NULL) {
+		g_propagate_error(error, g_steal_pointer(&error_local));
 		return FALSE;
 	}
 	return TRUE;
@@ -120,6 +120,12 @@ fu_udev_device_pread_full(FuUdevDevice *self,
 			  gsize bufsz,
 			  GError **error) G_GNUC_WARN_UNUSED_RESULT;
 gboolean
+fu_udev_device_preadv(FuUdevDevice *self, GPtrArray *chunks, FuProgress *progress, GError **error)
+    G_GNUC_WARN_UNUSED_RESULT;
+gboolean
+fu_udev_device_pwritev(FuUdevDevice *self, GPtrArray *chunks, FuProgress *progress, GError **error)
+    G_GNUC_WARN_UNUSED_RESULT;
+gboolean
 fu_udev_device_seek(FuUdevDevice *self, goffset offset, GError **error) G_GNUC_WARN_UNUSED_RESULT;
 const gchar *
 fu_udev_device_get_sysfs_attr(FuUdevDevice *self, const gchar *attr, GError **error);
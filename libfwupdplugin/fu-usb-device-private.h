@@ -8,5 +8,22 @@
 
 #include "fu-usb-device.h"
 
+/* only used by the self tests to pretend to be the hardware */
+typedef void (*FuUsbDeviceTransferAsyncFunc)(FuUsbDevice *self,
+					     guint8 endpoint,
+					     guint8 *data,
+					     gsize length,
+					     guint timeout,
+					     GCancellable *cancellable,
+					     GAsyncReadyCallback callback,
+					     gpointer user_data);
+typedef gssize (*FuUsbDeviceTransferFinishFunc)(FuUsbDevice *self,
+						GAsyncResult *res,
+						GError **error);
+
 const gchar *
 fu_usb_device_get_platform_id(FuUsbDevice *self);
+void
+fu_usb_device_set_transfer_funcs(FuUsbDevice *self,
+				 FuUsbDeviceTransferAsyncFunc async_func,
+				 FuUsbDeviceTransferFinishFunc finish_func);
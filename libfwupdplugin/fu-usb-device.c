@@ -9,6 +9,7 @@
 #include "config.h"
 
 #include "fu-device-private.h"
+#include "fu-trace-private.h"
 #include "fu-usb-device-private.h"
 
 /**
@@ -24,6 +25,8 @@ typedef struct {
 	gint configuration;
 	GPtrArray *interfaces; /* nullable, element-type FuUsbDeviceInterface */
 	FuDeviceLocker *usb_device_locker;
+	FuUsbDeviceTransferAsyncFunc transfer_async_func;   /* nullable */
+	FuUsbDeviceTransferFinishFunc transfer_finish_func; /* nullable */
 } FuUsbDevicePrivate;
 
 typedef struct {
@@ -233,6 +236,10 @@ fu_usb_device_open(FuDevice *device, GError **error)
 	if (priv->usb_device_locker != NULL)
 		return TRUE;
 
+	/* all transfers are loaded from the saved events */
+	if (fu_device_has_internal_flag(device, FU_DEVICE_INTERNAL_FLAG_EMULATED))
+		return TRUE;
+
 	/* open */
 	locker = fu_device_locker_new(priv->usb_device, error);
 	if (locker == NULL)
@@ -274,6 +281,10 @@ fu_usb_device_setup(FuDevice *device, GError **error)
 	g_return_val_if_fail(FU_IS_USB_DEVICE(self), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
+	/* the strings were saved with the emulated device */
+	if (fu_device_has_internal_flag(device, FU_DEVICE_INTERNAL_FLAG_EMULATED))
+		return TRUE;
+
 	/* get vendor */
 	if (fu_device_get_vendor(device) == NULL) {
 		idx = g_usb_device_get_manufacturer_index(priv->usb_device);
@@ -664,6 +675,440 @@ fu_usb_device_get_dev(FuUsbDevice *device)
 	return priv->usb_device;
 }
 
+#ifdef HAVE_GUSB
+#define FU_USB_DEVICE_ENDPOINT_IN 0x80
+
+typedef struct {
+	FuUsbDevice *device;
+	GPtrArray *chunks;
+	guint8 endpoint;
+	gboolean interrupt;
+	guint depth;
+	guint timeout;
+	FuUsbDeviceChunkFunc func;
+	gpointer user_data;
+	FuProgress *progress;
+	GMainLoop *loop;
+	GCancellable *cancellable;
+	GError *error;
+	gssize *actual_lengths; /* -1 for not yet complete */
+	guint idx_submit;
+	guint idx_complete;
+	guint in_flight;
+} FuUsbDeviceTransferHelper;
+
+typedef struct {
+	FuUsbDeviceTransferHelper *helper;
+	guint idx;
+	gint64 start; /* µs */
+} FuUsbDeviceTransfer;
+
+static gchar *
+fu_usb_device_transfer_event_id(guint8 endpoint, gboolean interrupt, FuChunk *chk)
+{
+	const gchar *kind = interrupt ? "InterruptTransfer" : "BulkTransfer";
+
+	/* OUT transfers also include the checksum of the data sent */
+	if (endpoint & FU_USB_DEVICE_ENDPOINT_IN) {
+		return g_strdup_printf("%s:Endpoint=0x%02x,Length=0x%x",
+				       kind,
+				       endpoint,
+				       fu_chunk_get_data_sz(chk));
+	}
+	return g_strdup_printf("%s:Endpoint=0x%02x,Length=0x%x,Crc=0x%08x",
+			       kind,
+			       endpoint,
+			       fu_chunk_get_data_sz(chk),
+			       fu_common_crc32(fu_chunk_get_data(chk), fu_chunk_get_data_sz(chk)));
+}
+
+static gboolean
+fu_usb_device_transfer_chunks_emulated(FuUsbDevice *device,
+				       guint8 endpoint,
+				       gboolean interrupt,
+				       GPtrArray *chunks,
+				       FuUsbDeviceChunkFunc func,
+				       gpointer user_data,
+				       FuProgress *progress,
+				       GError **error)
+{
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
+		FuDeviceEvent *event;
+		g_autofree gchar *event_id = NULL;
+
+		event_id = fu_usb_device_transfer_event_id(endpoint, interrupt, chk);
+		event = fu_device_load_event(FU_DEVICE(device), event_id, error);
+		if (event == NULL)
+			return FALSE;
+		if (endpoint & FU_USB_DEVICE_ENDPOINT_IN) {
+			if (!fu_device_event_copy_data(event,
+						       fu_chunk_get_data_out(chk),
+						       fu_chunk_get_data_sz(chk),
+						       error))
+				return FALSE;
+		}
+		if (func != NULL &&
+		    !func(device, chk, (gsize)fu_device_event_get_rc(event), user_data, error))
+			return FALSE;
+		fu_progress_step_done(progress);
+	}
+	return TRUE;
+}
+
+static void
+fu_usb_device_transfer_helper_fail(FuUsbDeviceTransferHelper *helper, GError *error)
+{
+	/* only the first error is interesting, the rest are just cancelled */
+	if (helper->error != NULL) {
+		g_error_free(error);
+		return;
+	}
+	helper->error = error;
+	g_cancellable_cancel(helper->cancellable);
+}
+
+static void fu_usb_device_transfer_helper_submit(FuUsbDeviceTransferHelper *helper);
+
+static void
+fu_usb_device_transfer_chunk_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FuUsbDeviceTransfer *xfer = (FuUsbDeviceTransfer *)user_data;
+	FuUsbDeviceTransferHelper *helper = xfer->helper;
+	FuUsbDevicePrivate *priv = GET_PRIVATE(helper->device);
+	FuChunk *chk = g_ptr_array_index(helper->chunks, xfer->idx);
+	gssize actual_length;
+	g_autoptr(GError) error_local = NULL;
+
+	helper->in_flight--;
+	if (priv->transfer_finish_func != NULL) {
+		actual_length = priv->transfer_finish_func(helper->device, res, &error_local);
+	} else if (helper->interrupt) {
+		actual_length = g_usb_device_interrupt_transfer_finish(G_USB_DEVICE(source),
+								       res,
+								       &error_local);
+	} else {
+		actual_length =
+		    g_usb_device_bulk_transfer_finish(G_USB_DEVICE(source), res, &error_local);
+	}
+	FU_TRACE3(usb_transfer_complete, helper->endpoint, xfer->idx, actual_length);
+	if (actual_length < 0) {
+		g_prefix_error(&error_local, "failed to transfer chunk %u: ", xfer->idx);
+		fu_usb_device_transfer_helper_fail(helper, g_steal_pointer(&error_local));
+	} else if ((helper->endpoint & FU_USB_DEVICE_ENDPOINT_IN) == 0 &&
+		   (gsize)actual_length != fu_chunk_get_data_sz(chk)) {
+		g_set_error(&error_local,
+			    G_IO_ERROR,
+			    G_IO_ERROR_INVALID_DATA,
+			    "only wrote 0x%x of 0x%x bytes for chunk %u",
+			    (guint)actual_length,
+			    fu_chunk_get_data_sz(chk),
+			    xfer->idx);
+		fu_usb_device_transfer_helper_fail(helper, g_steal_pointer(&error_local));
+	} else {
+		const gchar *kind;
+		if (helper->interrupt) {
+			kind = helper->endpoint & FU_USB_DEVICE_ENDPOINT_IN ? "UsbInterruptIn"
+									    : "UsbInterruptOut";
+		} else {
+			kind = helper->endpoint & FU_USB_DEVICE_ENDPOINT_IN ? "UsbBulkIn"
+									    : "UsbBulkOut";
+		}
+		fu_device_add_io_stats(FU_DEVICE(helper->device),
+				       kind,
+				       actual_length,
+				       g_get_monotonic_time() - xfer->start);
+		helper->actual_lengths[xfer->idx] = actual_length;
+	}
+	g_free(xfer);
+
+	/* report completions in order */
+	while (helper->error == NULL && helper->idx_complete < helper->chunks->len &&
+	       helper->actual_lengths[helper->idx_complete] >= 0) {
+		FuChunk *chk_done = g_ptr_array_index(helper->chunks, helper->idx_complete);
+		if (fu_device_has_save_events(FU_DEVICE(helper->device))) {
+			FuDeviceEvent *event;
+			g_autofree gchar *event_id = NULL;
+			event_id = fu_usb_device_transfer_event_id(helper->endpoint,
+								   helper->interrupt,
+								   chk_done);
+			event = fu_device_save_event(FU_DEVICE(helper->device), event_id);
+			fu_device_event_set_rc(event, helper->actual_lengths[helper->idx_complete]);
+			if (helper->endpoint & FU_USB_DEVICE_ENDPOINT_IN) {
+				fu_device_event_set_data_raw(
+				    event,
+				    fu_chunk_get_data(chk_done),
+				    helper->actual_lengths[helper->idx_complete]);
+			}
+		}
+		if (helper->func != NULL &&
+		    !helper->func(helper->device,
+				  chk_done,
+				  helper->actual_lengths[helper->idx_complete],
+				  helper->user_data,
+				  &error_local)) {
+			fu_usb_device_transfer_helper_fail(helper, g_steal_pointer(&error_local));
+			break;
+		}
+		fu_progress_step_done(helper->progress);
+		helper->idx_complete++;
+	}
+
+	/* keep the pipeline full, or wait for the cancelled transfers to drain */
+	fu_usb_device_transfer_helper_submit(helper);
+	if (helper->in_flight == 0)
+		g_main_loop_quit(helper->loop);
+}
+
+static void
+fu_usb_device_transfer_helper_submit(FuUsbDeviceTransferHelper *helper)
+{
+	FuUsbDevicePrivate *priv = GET_PRIVATE(helper->device);
+	while (helper->error == NULL && helper->in_flight < helper->depth &&
+	       helper->idx_submit < helper->chunks->len) {
+		FuChunk *chk = g_ptr_array_index(helper->chunks, helper->idx_submit);
+		FuUsbDeviceTransfer *xfer = g_new0(FuUsbDeviceTransfer, 1);
+		guint8 *data;
+
+		/* IN transfers need somewhere to put the data */
+		if (helper->endpoint & FU_USB_DEVICE_ENDPOINT_IN)
+			data = fu_chunk_get_data_out(chk);
+		else
+			data = (guint8 *)fu_chunk_get_data(chk);
+		xfer->helper = helper;
+		xfer->idx = helper->idx_submit++;
+		xfer->start = g_get_monotonic_time();
+		helper->in_flight++;
+		FU_TRACE3(usb_transfer_submit,
+			  helper->endpoint,
+			  xfer->idx,
+			  fu_chunk_get_data_sz(chk));
+		if (priv->transfer_async_func != NULL) {
+			priv->transfer_async_func(helper->device,
+						  helper->endpoint,
+						  data,
+						  fu_chunk_get_data_sz(chk),
+						  helper->timeout,
+						  helper->cancellable,
+						  fu_usb_device_transfer_chunk_cb,
+						  xfer);
+		} else if (helper->interrupt) {
+			g_usb_device_interrupt_transfer_async(priv->usb_device,
+							      helper->endpoint,
+							      data,
+							      fu_chunk_get_data_sz(chk),
+							      helper->timeout,
+							      helper->cancellable,
+							      fu_usb_device_transfer_chunk_cb,
+							      xfer);
+		} else {
+			g_usb_device_bulk_transfer_async(priv->usb_device,
+							 helper->endpoint,
+							 data,
+							 fu_chunk_get_data_sz(chk),
+							 helper->timeout,
+							 helper->cancellable,
+							 fu_usb_device_transfer_chunk_cb,
+							 xfer);
+		}
+	}
+}
+#endif
+
+static gboolean
+fu_usb_device_transfer_chunks(FuUsbDevice *device,
+			      guint8 endpoint,
+			      gboolean interrupt,
+			      GPtrArray *chunks,
+			      guint depth,
+			      guint timeout,
+			      FuUsbDeviceChunkFunc func,
+			      gpointer user_data,
+			      FuProgress *progress,
+			      GError **error)
+{
+#ifdef HAVE_GUSB
+	FuUsbDevicePrivate *priv = GET_PRIVATE(device);
+	g_autofree gssize *actual_lengths = NULL;
+	g_autoptr(GCancellable) cancellable = g_cancellable_new();
+	g_autoptr(GMainContext) context = g_main_context_new();
+	g_autoptr(GMainLoop) loop = g_main_loop_new(context, FALSE);
+	FuUsbDeviceTransferHelper helper = {
+	    .device = device,
+	    .chunks = chunks,
+	    .endpoint = endpoint,
+	    .interrupt = interrupt,
+	    .depth = MAX(depth, 1),
+	    .timeout = timeout,
+	    .func = func,
+	    .user_data = user_data,
+	    .progress = progress,
+	    .loop = loop,
+	    .cancellable = cancellable,
+	};
+
+	g_return_val_if_fail(FU_IS_USB_DEVICE(device), FALSE);
+	g_return_val_if_fail(chunks != NULL, FALSE);
+	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* nothing to do */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, chunks->len);
+	if (chunks->len == 0)
+		return TRUE;
+
+	/* emulated */
+	if (fu_device_has_internal_flag(FU_DEVICE(device), FU_DEVICE_INTERNAL_FLAG_EMULATED)) {
+		return fu_usb_device_transfer_chunks_emulated(device,
+							      endpoint,
+							      interrupt,
+							      chunks,
+							      func,
+							      user_data,
+							      progress,
+							      error);
+	}
+
+	if (priv->usb_device == NULL && priv->transfer_async_func == NULL) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "no GUsbDevice");
+		return FALSE;
+	}
+
+	/* queue up to depth transfers, and then refill as each one completes -- the completions
+	 * are dispatched on a private context so the daemon does not handle D-Bus requests here */
+	actual_lengths = g_new(gssize, chunks->len);
+	for (guint i = 0; i < chunks->len; i++)
+		actual_lengths[i] = -1;
+	helper.actual_lengths = actual_lengths;
+	g_main_context_push_thread_default(context);
+	fu_usb_device_transfer_helper_submit(&helper);
+	g_main_loop_run(loop);
+	g_main_context_pop_thread_default(context);
+	if (helper.error != NULL) {
+		g_propagate_error(error, helper.error);
+		return FALSE;
+	}
+
+	/* success */
+	return TRUE;
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "Not supported as <gusb.h> is unavailable");
+	return FALSE;
+#endif
+}
+
+/**
+ * fu_usb_device_bulk_transfer_chunks:
+ * @device: a #FuUsbDevice
+ * @endpoint: the endpoint address, e.g. `0x01` or `0x81`
+ * @chunks: (element-type FuChunk): chunks to transfer
+ * @depth: the maximum number of transfers in flight, e.g. 4
+ * @timeout: timeout for each transfer in ms
+ * @func: (scope call) (nullable): function called as each chunk completes
+ * @user_data: user data for @func
+ * @progress: a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Transfers each chunk using a bulk endpoint, keeping up to @depth asynchronous transfers queued
+ * so that the device never waits for the host between packets.
+ *
+ * For IN endpoints the chunks must have been created with fu_chunk_array_mutable_new(), and
+ * short reads are allowed. For OUT endpoints each chunk must be completely written.
+ *
+ * If any transfer fails, or @func returns %FALSE, the transfers still in flight are cancelled and
+ * the first error is returned.
+ *
+ * The completions are dispatched on a private #GMainContext, so other sources attached to the
+ * default context are not run until this function returns.
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fu_usb_device_bulk_transfer_chunks(FuUsbDevice *device,
+				   guint8 endpoint,
+				   GPtrArray *chunks,
+				   guint depth,
+				   guint timeout,
+				   FuUsbDeviceChunkFunc func,
+				   gpointer user_data,
+				   FuProgress *progress,
+				   GError **error)
+{
+	return fu_usb_device_transfer_chunks(device,
+					     endpoint,
+					     FALSE,
+					     chunks,
+					     depth,
+					     timeout,
+					     func,
+					     user_data,
+					     progress,
+					     error);
+}
+
+/**
+ * fu_usb_device_interrupt_transfer_chunks:
+ * @device: a #FuUsbDevice
+ * @endpoint: the endpoint address, e.g. `0x01` or `0x81`
+ * @chunks: (element-type FuChunk): chunks to transfer
+ * @depth: the maximum number of transfers in flight, e.g. 4
+ * @timeout: timeout for each transfer in ms
+ * @func: (scope call) (nullable): function called as each chunk completes
+ * @user_data: user data for @func
+ * @progress: a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Transfers each chunk using an interrupt endpoint, in the same way as
+ * fu_usb_device_bulk_transfer_chunks().
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fu_usb_device_interrupt_transfer_chunks(FuUsbDevice *device,
+					guint8 endpoint,
+					GPtrArray *chunks,
+					guint depth,
+					guint timeout,
+					FuUsbDeviceChunkFunc func,
+					gpointer user_data,
+					FuProgress *progress,
+					GError **error)
+{
+	return fu_usb_device_transfer_chunks(device,
+					     endpoint,
+					     TRUE,
+					     chunks,
+					     depth,
+					     timeout,
+					     func,
+					     user_data,
+					     progress,
+					     error);
+}
+
+/* used by the self tests instead of the GUsbDevice */
+void
+fu_usb_device_set_transfer_funcs(FuUsbDevice *self,
+				 FuUsbDeviceTransferAsyncFunc async_func,
+				 FuUsbDeviceTransferFinishFunc finish_func)
+{
+	FuUsbDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_USB_DEVICE(self));
+	priv->transfer_async_func = async_func;
+	priv->transfer_finish_func = finish_func;
+}
+
 static void
 fu_usb_device_incorporate(FuDevice *self, FuDevice *donor)
 {
@@ -17,6 +17,7 @@
 #endif
 #endif
 
+#include "fu-chunk.h"
 #include "fu-plugin.h"
 #include "fu-udev-device.h"
 
@@ -28,6 +29,25 @@ struct _FuUsbDeviceClass {
 	gpointer __reserved[31];
 };
 
+/**
+ * FuUsbDeviceChunkFunc:
+ * @self: a #FuUsbDevice
+ * @chk: a #FuChunk
+ * @actual_length: the number of bytes transferred
+ * @user_data: user data
+ * @error: (nullable): optional return location for an error
+ *
+ * The callback used when a chunk transfer has completed. Callbacks are always made in the same
+ * order as the chunks array, even if the transfers complete out of order.
+ *
+ * Returns: %TRUE on success
+ */
+typedef gboolean (*FuUsbDeviceChunkFunc)(FuUsbDevice *self,
+					 FuChunk *chk,
+					 gsize actual_length,
+					 gpointer user_data,
+					 GError **error) G_GNUC_WARN_UNUSED_RESULT;
+
 FuUsbDevice *
 fu_usb_device_new(GUsbDevice *usb_device) G_DEPRECATED_FOR(fu_usb_device_new_with_context);
 FuUsbDevice *
@@ -50,3 +70,23 @@ void
 fu_usb_device_set_configuration(FuUsbDevice *device, gint configuration);
 void
 fu_usb_device_add_interface(FuUsbDevice *device, guint8 number);
+gboolean
+fu_usb_device_bulk_transfer_chunks(FuUsbDevice *device,
+				   guint8 endpoint,
+				   GPtrArray *chunks,
+				   guint depth,
+				   guint timeout,
+				   FuUsbDeviceChunkFunc func,
+				   gpointer user_data,
+				   FuProgress *progress,
+				   GError **error) G_GNUC_WARN_UNUSED_RESULT;
+gboolean
+fu_usb_device_interrupt_transfer_chunks(FuUsbDevice *device,
+					guint8 endpoint,
+					GPtrArray *chunks,
+					guint depth,
+					guint timeout,
+					FuUsbDeviceChunkFunc func,
+					gpointer user_data,
+					FuProgress *progress,
+					GError **error) G_GNUC_WARN_UNUSED_RESULT;
@@ -26,6 +26,71 @@ fu_ch341a_cfi_device_chip_select(FuCfiDevice *self, gboolean value, GError **err
 	return fu_ch341a_device_chip_select(proxy, value, error);
 }
 
+/* cmd, then 24 or 32 bit address, returning the number of bytes used in @buf */
+static gsize
+fu_ch341a_cfi_device_build_cmd(FuCh341aCfiDevice *self,
+			       FuCfiDeviceCmd cmd,
+			       guint32 addr,
+			       guint8 *buf,
+			       GError **error)
+{
+	guint8 address_size = fu_cfi_device_get_address_size(FU_CFI_DEVICE(self));
+	if (!fu_cfi_device_get_cmd(FU_CFI_DEVICE(self), cmd, &buf[0], error))
+		return 0;
+	if (address_size == 4) {
+		fu_common_write_uint32(buf + 1, addr, G_BIG_ENDIAN);
+		return 5;
+	}
+	buf[1] = (addr >> 16) & 0xFF;
+	buf[2] = (addr >> 8) & 0xFF;
+	buf[3] = addr & 0xFF;
+	return 4;
+}
+
+static gboolean
+fu_ch341a_cfi_device_send_command(FuCfiDevice *self,
+				  const guint8 *wbuf,
+				  gsize wbufsz,
+				  guint8 *rbuf,
+				  gsize rbufsz,
+				  FuProgress *progress,
+				  GError **error)
+{
+	FuCh341aDevice *proxy = FU_CH341A_DEVICE(fu_device_get_proxy(FU_DEVICE(self)));
+	gsize bufsz = wbufsz + rbufsz;
+	g_autofree guint8 *buf = g_malloc0(bufsz);
+	g_autoptr(FuDeviceLocker) cslocker = NULL;
+	g_autoptr(GPtrArray) chunks = NULL;
+
+	/* enable chip */
+	cslocker = fu_cfi_device_chip_select_locker_new(self, error);
+	if (cslocker == NULL)
+		return FALSE;
+
+	/* the transfer is full duplex, so the reply follows the command */
+	if (!fu_memcpy_safe(buf, bufsz, 0x0, wbuf, wbufsz, 0x0, wbufsz, error))
+		return FALSE;
+	chunks = fu_chunk_array_mutable_new(buf, bufsz, 0x0, 0x0, CH341A_PAYLOAD_SIZE);
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, chunks->len);
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
+		if (!fu_ch341a_device_spi_transfer(proxy,
+						   fu_chunk_get_data_out(chk),
+						   fu_chunk_get_data_sz(chk),
+						   error))
+			return FALSE;
+		fu_progress_step_done(progress);
+	}
+	if (rbuf != NULL) {
+		if (!fu_memcpy_safe(rbuf, rbufsz, 0x0, buf, bufsz, wbufsz, rbufsz, error))
+			return FALSE;
+	}
+
+	/* success */
+	return TRUE;
+}
+
 typedef struct {
 	guint8 mask;
 	guint8 value;
@@ -165,37 +230,56 @@ fu_ch341a_cfi_device_write_enable(FuCh341aCfiDevice *self, GError **error)
 }
 
 static gboolean
-fu_ch341a_cfi_device_chip_erase(FuCh341aCfiDevice *self, GError **error)
+fu_ch341a_cfi_device_erase(FuCh341aCfiDevice *self,
+			   FuCfiDeviceCmd cmd,
+			   guint32 addr,
+			   GError **error)
 {
 	FuCh341aDevice *proxy = FU_CH341A_DEVICE(fu_device_get_proxy(FU_DEVICE(self)));
-	guint8 buf[] = {0x0};
+	gsize bufsz;
+	guint8 buf[5] = {0x0};
 	g_autoptr(FuDeviceLocker) cslocker = NULL;
 
+	/* cmd, then starting address */
+	bufsz = fu_ch341a_cfi_device_build_cmd(self, cmd, addr, buf, error);
+	if (bufsz == 0)
+		return FALSE;
+	if (!fu_ch341a_cfi_device_write_enable(self, error))
+		return FALSE;
+
 	/* enable chip */
 	cslocker = fu_cfi_device_chip_select_locker_new(FU_CFI_DEVICE(self), error);
 	if (cslocker == NULL)
 		return FALSE;
-
-	/* erase */
-	if (!fu_cfi_device_get_cmd(FU_CFI_DEVICE(self),
-				   FU_CFI_DEVICE_CMD_CHIP_ERASE,
-				   &buf[0],
-				   error))
-		return FALSE;
-	if (!fu_ch341a_device_spi_transfer(proxy, buf, sizeof(buf), error))
+	if (!fu_ch341a_device_spi_transfer(proxy, buf, bufsz, error))
 		return FALSE;
 	if (!fu_device_locker_close(cslocker, error))
 		return FALSE;
 
 	/* poll Read Status register BUSY */
-	return fu_ch341a_cfi_device_wait_for_status(self, 0b1, 0b0, 100, 500, error);
+	return fu_ch341a_cfi_device_wait_for_status(self, 0b1, 0b0, 100, 50, error);
+}
+
+static gboolean
+fu_ch341a_cfi_device_erase_sector_cb(FuDevice *device, guint32 addr, GError **error)
+{
+	FuCh341aCfiDevice *self = FU_CH341A_CFI_DEVICE(device);
+	return fu_ch341a_cfi_device_erase(self, FU_CFI_DEVICE_CMD_SECTOR_ERASE, addr, error);
+}
+
+static gboolean
+fu_ch341a_cfi_device_erase_block_cb(FuDevice *device, guint32 addr, GError **error)
+{
+	FuCh341aCfiDevice *self = FU_CH341A_CFI_DEVICE(device);
+	return fu_ch341a_cfi_device_erase(self, FU_CFI_DEVICE_CMD_BLOCK_ERASE, addr, error);
 }
 
 static gboolean
 fu_ch341a_cfi_device_write_page(FuCh341aCfiDevice *self, FuChunk *page, GError **error)
 {
 	FuCh341aDevice *proxy = FU_CH341A_DEVICE(fu_device_get_proxy(FU_DEVICE(self)));
-	guint8 buf[4] = {0x0};
+	gsize bufsz;
+	guint8 buf[5] = {0x0};
 	g_autoptr(GPtrArray) chunks = NULL;
 	g_autoptr(FuDeviceLocker) cslocker = NULL;
 
@@ -206,14 +290,15 @@ fu_ch341a_cfi_device_write_page(FuCh341aCfiDevice *self, FuChunk *page, GError *
 	if (cslocker == NULL)
 		return FALSE;
 
-	/* cmd, then 24 bit starting address */
-	fu_common_write_uint32(buf, fu_chunk_get_address(page), G_BIG_ENDIAN);
-	if (!fu_cfi_device_get_cmd(FU_CFI_DEVICE(self),
-				   FU_CFI_DEVICE_CMD_PAGE_PROG,
-				   &buf[0],
-				   error))
+	/* cmd, then starting address */
+	bufsz = fu_ch341a_cfi_device_build_cmd(self,
+					       FU_CFI_DEVICE_CMD_PAGE_PROG,
+					       fu_chunk_get_address(page),
+					       buf,
+					       error);
+	if (bufsz == 0)
 		return FALSE;
-	if (!fu_ch341a_device_spi_transfer(proxy, buf, sizeof(buf), error))
+	if (!fu_ch341a_device_spi_transfer(proxy, buf, bufsz, error))
 		return FALSE;
 
 	/* send data */
@@ -245,12 +330,22 @@ fu_ch341a_cfi_device_write_page(FuCh341aCfiDevice *self, FuChunk *page, GError *
 }
 
 static gboolean
-fu_ch341a_cfi_device_write_pages(FuCh341aCfiDevice *self,
-				 GPtrArray *pages,
-				 FuProgress *progress,
-				 GError **error)
+fu_ch341a_cfi_device_write_cb(FuDevice *device,
+			      guint32 addr,
+			      const guint8 *buf,
+			      gsize bufsz,
+			      FuProgress *progress,
+			      GError **error)
 {
-	/* progress */
+	FuCh341aCfiDevice *self = FU_CH341A_CFI_DEVICE(device);
+	g_autoptr(GPtrArray) pages = NULL;
+
+	/* write each page */
+	pages = fu_chunk_array_new(buf,
+				   bufsz,
+				   addr,
+				   0x0,
+				   fu_cfi_device_get_page_size(FU_CFI_DEVICE(self)));
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, pages->len);
 	for (guint i = 0; i < pages->len; i++) {
@@ -259,60 +354,75 @@ fu_ch341a_cfi_device_write_pages(FuCh341aCfiDevice *self,
 			return FALSE;
 		fu_progress_step_done(progress);
 	}
+
 	/* success */
 	return TRUE;
 }
 
-static GBytes *
-fu_ch341a_cfi_device_read_firmware(FuCh341aCfiDevice *self,
-				   gsize bufsz,
-				   FuProgress *progress,
-				   GError **error)
+static gboolean
+fu_ch341a_cfi_device_read_cb(FuDevice *device,
+			     guint32 addr,
+			     guint8 *data,
+			     gsize datasz,
+			     FuProgress *progress,
+			     GError **error)
 {
+	FuCh341aCfiDevice *self = FU_CH341A_CFI_DEVICE(device);
 	FuCh341aDevice *proxy = FU_CH341A_DEVICE(fu_device_get_proxy(FU_DEVICE(self)));
+	gsize offset = 0;
+	gsize hdrsz;
 	guint8 buf[CH341A_PAYLOAD_SIZE] = {0x0};
 	g_autoptr(FuDeviceLocker) cslocker = NULL;
-	g_autoptr(GByteArray) blob = g_byte_array_new();
 	g_autoptr(GPtrArray) chunks = NULL;
 
+	/* cmd, then starting address */
+	hdrsz = fu_ch341a_cfi_device_build_cmd(self, FU_CFI_DEVICE_CMD_READ_DATA, addr, buf, error);
+	if (hdrsz == 0)
+		return FALSE;
+
 	/* enable chip */
 	cslocker = fu_cfi_device_chip_select_locker_new(FU_CFI_DEVICE(self), error);
 	if (cslocker == NULL)
-		return NULL;
+		return FALSE;
 
 	/* read each block */
-	chunks = fu_chunk_array_new(NULL, bufsz + 0x4, 0x0, 0x0, CH341A_PAYLOAD_SIZE);
+	chunks = fu_chunk_array_new(NULL, datasz + hdrsz, 0x0, 0x0, CH341A_PAYLOAD_SIZE);
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, chunks->len);
 	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_READ);
-
-	/* cmd, then 24 bit starting address */
-	fu_common_write_uint32(buf, 0x0, G_BIG_ENDIAN);
-	if (!fu_cfi_device_get_cmd(FU_CFI_DEVICE(self),
-				   FU_CFI_DEVICE_CMD_READ_DATA,
-				   &buf[0],
-				   error))
-		return NULL;
 	for (guint i = 0; i < chunks->len; i++) {
 		FuChunk *chk = g_ptr_array_index(chunks, i);
+		gsize bufoff = i == 0 ? hdrsz : 0x0;
 
 		/* the first package has cmd and address info */
 		if (!fu_ch341a_device_spi_transfer(proxy, buf, sizeof(buf), error))
-			return NULL;
-		if (i == 0) {
-			g_byte_array_append(blob, buf + 0x4, fu_chunk_get_data_sz(chk) - 0x4);
-		} else {
-			g_byte_array_append(blob, buf + 0x0, fu_chunk_get_data_sz(chk));
-		}
+			return FALSE;
+		if (!fu_memcpy_safe(data,
+				    datasz,
+				    offset, /* dst */
+				    buf,
+				    sizeof(buf),
+				    bufoff, /* src */
+				    fu_chunk_get_data_sz(chk) - bufoff,
+				    error))
+			return FALSE;
+		offset += fu_chunk_get_data_sz(chk) - bufoff;
 
 		/* done */
 		fu_progress_step_done(progress);
 	}
 
 	/* success */
-	return g_byte_array_free_to_bytes(g_steal_pointer(&blob));
+	return TRUE;
 }
 
+static const FuCfiDeviceFuncs fu_ch341a_cfi_device_funcs = {
+    .read = fu_ch341a_cfi_device_read_cb,
+    .write = fu_ch341a_cfi_device_write_cb,
+    .erase_sector = fu_ch341a_cfi_device_erase_sector_cb,
+    .erase_block = fu_ch341a_cfi_device_erase_block_cb,
+};
+
 static gboolean
 fu_ch341a_cfi_device_write_firmware(FuDevice *device,
 				    FuFirmware *firmware,
@@ -323,9 +433,6 @@ fu_ch341a_cfi_device_write_firmware(FuDevice *device,
 	FuCh341aCfiDevice *self = FU_CH341A_CFI_DEVICE(device);
 	FuCh341aDevice *proxy = FU_CH341A_DEVICE(fu_device_get_proxy(FU_DEVICE(self)));
 	g_autoptr(GBytes) fw = NULL;
-	g_autoptr(GBytes) fw_verify = NULL;
-	g_autoptr(GPtrArray) pages = NULL;
-	g_autoptr(FuDeviceLocker) cslocker = NULL;
 	g_autoptr(FuDeviceLocker) locker = NULL;
 
 	/* open programmer */
@@ -333,58 +440,19 @@ fu_ch341a_cfi_device_write_firmware(FuDevice *device,
 	if (locker == NULL)
 		return FALSE;
 
-	/* progress */
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_GUESSED);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 33);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 44);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_VERIFY, 35);
-
 	/* get default image */
 	fw = fu_firmware_get_bytes(firmware, error);
 	if (fw == NULL)
 		return FALSE;
 
-	/* erase */
-	if (!fu_ch341a_cfi_device_write_enable(self, error)) {
-		g_prefix_error(error, "failed to enable writes: ");
-		return FALSE;
-	}
-	if (!fu_ch341a_cfi_device_chip_erase(self, error)) {
-		g_prefix_error(error, "failed to erase: ");
-		return FALSE;
-	}
-	fu_progress_step_done(progress);
-
-	/* write each block */
-	pages = fu_chunk_array_new_from_bytes(fw,
-					      0x0,
-					      0x0,
-					      fu_cfi_device_get_page_size(FU_CFI_DEVICE(self)));
-	if (!fu_ch341a_cfi_device_write_pages(self,
-					      pages,
-					      fu_progress_get_child(progress),
-					      error)) {
-		g_prefix_error(error, "failed to write pages: ");
-		return FALSE;
-	}
-	fu_progress_step_done(progress);
-
-	/* verify each block */
-	fw_verify = fu_ch341a_cfi_device_read_firmware(self,
-						       g_bytes_get_size(fw),
-						       fu_progress_get_child(progress),
-						       error);
-	if (fw_verify == NULL) {
-		g_prefix_error(error, "failed to verify blocks: ");
-		return FALSE;
-	}
-	if (!fu_common_bytes_compare(fw, fw_verify, error))
-		return FALSE;
-	fu_progress_step_done(progress);
-
-	/* success! */
-	return TRUE;
+	/* only erase and write the sectors that changed */
+	return fu_cfi_device_write_diff(FU_CFI_DEVICE(self),
+					device,
+					&fu_ch341a_cfi_device_funcs,
+					0x0,
+					fw,
+					progress,
+					error);
 }
 
 static GBytes *
@@ -393,6 +461,7 @@ fu_ch341a_cfi_device_dump_firmware(FuDevice *device, FuProgress *progress, GErro
 	FuCh341aCfiDevice *self = FU_CH341A_CFI_DEVICE(device);
 	FuCh341aDevice *proxy = FU_CH341A_DEVICE(fu_device_get_proxy(FU_DEVICE(self)));
 	gsize bufsz = fu_device_get_firmware_size_max(device);
+	g_autofree guint8 *buf = NULL;
 	g_autoptr(FuDeviceLocker) locker = NULL;
 
 	/* open programmer */
@@ -408,7 +477,10 @@ fu_ch341a_cfi_device_dump_firmware(FuDevice *device, FuProgress *progress, GErro
 				    "device firmware size not set");
 		return NULL;
 	}
-	return fu_ch341a_cfi_device_read_firmware(self, bufsz, progress, error);
+	buf = g_malloc0(bufsz);
+	if (!fu_ch341a_cfi_device_read_cb(device, 0x0, buf, bufsz, progress, error))
+		return NULL;
+	return g_bytes_new_take(g_steal_pointer(&buf), bufsz);
 }
 
 static void
@@ -436,6 +508,7 @@ fu_ch341a_cfi_device_class_init(FuCh341aCfiDeviceClass *klass)
 	FuCfiDeviceClass *klass_cfi = FU_CFI_DEVICE_CLASS(klass);
 
 	klass_cfi->chip_select = fu_ch341a_cfi_device_chip_select;
+	klass_cfi->send_command = fu_ch341a_cfi_device_send_command;
 
 	klass_device->setup = fu_ch341a_cfi_device_setup;
 	klass_device->write_firmware = fu_ch341a_cfi_device_write_firmware;
@@ -173,9 +173,9 @@ fu_dell_dock_hub_set_quirk_kv(FuDevice *device,
 		return TRUE;
 	}
 
-	/* failed */
-	g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "quirk key not supported");
-	return FALSE;
+	/* FuHidDevice->set_quirk_kv */
+	return FU_DEVICE_CLASS(fu_dell_dock_hub_parent_class)
+	    ->set_quirk_kv(device, key, value, error);
 }
 
 static void
@@ -20,6 +20,7 @@
 #define FASTBOOT_EP_OUT			   0x01
 #define FASTBOOT_CMD_BUFSZ		   64 /* bytes */
 #define FASTBOOT_US_TO_MS		   1000
+#define FASTBOOT_TRANSFER_DEPTH		   8 /* transfers in flight */
 
 struct _FuFastbootDevice {
 	FuUsbDevice parent_instance;
@@ -289,15 +290,30 @@ fu_fastboot_device_download(FuDevice *device, GBytes *fw, FuProgress *progress,
 					       0x00, /* start addr */
 					       0x00, /* page_sz */
 					       self->blocksz);
-	fu_progress_set_steps(progress, chunks->len);
-	for (guint i = 0; i < chunks->len; i++) {
-		FuChunk *chk = g_ptr_array_index(chunks, i);
-		if (!fu_fastboot_device_write(device,
-					      fu_chunk_get_data(chk),
-					      fu_chunk_get_data_sz(chk),
-					      error))
+
+	/* the device does not need a delay between packets, so keep the bus busy */
+	if (self->operation_delay == 0) {
+		if (!fu_usb_device_bulk_transfer_chunks(FU_USB_DEVICE(self),
+							FASTBOOT_EP_OUT,
+							chunks,
+							FASTBOOT_TRANSFER_DEPTH,
+							FASTBOOT_TRANSACTION_TIMEOUT,
+							NULL,
+							NULL,
+							progress,
+							error))
 			return FALSE;
-		fu_progress_step_done(progress);
+	} else {
+		fu_progress_set_steps(progress, chunks->len);
+		for (guint i = 0; i < chunks->len; i++) {
+			FuChunk *chk = g_ptr_array_index(chunks, i);
+			if (!fu_fastboot_device_write(device,
+						      fu_chunk_get_data(chk),
+						      fu_chunk_get_data_sz(chk),
+						      error))
+				return FALSE;
+			fu_progress_step_done(progress);
+		}
 	}
 	if (!fu_fastboot_device_read(device,
 				     NULL,
@@ -1229,58 +1229,42 @@ fu_genesys_usbhub_device_prepare_firmware(FuDevice *device,
 }
 
 static gboolean
-fu_genesys_usbhub_device_erase_flash(FuGenesysUsbhubDevice *self,
-				     guint start_addr,
-				     guint len,
-				     FuProgress *progress,
-				     GError **error)
+fu_genesys_usbhub_device_erase_sector_cb(FuDevice *device, guint32 addr, GError **error)
 {
+	FuGenesysUsbhubDevice *self = FU_GENESYS_USBHUB_DEVICE(device);
 	GUsbDevice *usb_device = fu_usb_device_get_dev(FU_USB_DEVICE(self));
 	FuGenesysWaitFlashRegisterHelper helper = {.reg = 5, .expected_val = 0};
-	g_autoptr(GPtrArray) chunks = NULL;
-
-	chunks = fu_chunk_array_new(NULL,
-				    len,
-				    start_addr,
-				    self->flash_block_size,
-				    self->flash_sector_size);
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, chunks->len);
-	for (guint i = 0; i < chunks->len; i++) {
-		FuChunk *chk = g_ptr_array_index(chunks, i);
-		guint16 sectornum = fu_chunk_get_address(chk) / self->flash_sector_size;
-		guint16 blocknum = fu_chunk_get_page(chk);
-		guint16 index = (0x01 << 8) | (sectornum << 4) | blocknum;
+	guint16 sectornum = (addr % self->flash_block_size) / self->flash_sector_size;
+	guint16 blocknum = addr / self->flash_block_size;
+	guint16 index = (0x01 << 8) | (sectornum << 4) | blocknum;
 
-		if (!g_usb_device_control_transfer(usb_device,
-						   G_USB_DEVICE_DIRECTION_HOST_TO_DEVICE,
-						   G_USB_DEVICE_REQUEST_TYPE_VENDOR,
-						   G_USB_DEVICE_RECIPIENT_DEVICE,
-						   self->vcs.req_write,
-						   0x2001, /* value */
-						   index,  /* idx */
-						   NULL,   /* data */
-						   0,	   /* data length */
-						   NULL,   /* actual length */
-						   GENESYS_USBHUB_USB_TIMEOUT,
-						   NULL,
-						   error)) {
-			g_prefix_error(error,
-				       "error erasing flash at sector 0x%02x in block 0x%02x",
-				       sectornum,
-				       blocknum);
-			return FALSE;
-		}
+	if (!g_usb_device_control_transfer(usb_device,
+					   G_USB_DEVICE_DIRECTION_HOST_TO_DEVICE,
+					   G_USB_DEVICE_REQUEST_TYPE_VENDOR,
+					   G_USB_DEVICE_RECIPIENT_DEVICE,
+					   self->vcs.req_write,
+					   0x2001, /* value */
+					   index,  /* idx */
+					   NULL,   /* data */
+					   0,	   /* data length */
+					   NULL,   /* actual length */
+					   GENESYS_USBHUB_USB_TIMEOUT,
+					   NULL,
+					   error)) {
+		g_prefix_error(error,
+			       "error erasing flash at sector 0x%02x in block 0x%02x",
+			       sectornum,
+			       blocknum);
+		return FALSE;
+	}
 
-		if (!fu_device_retry(FU_DEVICE(self),
-				     fu_genesys_usbhub_device_wait_flash_status_register_cb,
-				     self->flash_erase_delay / 30,
-				     &helper,
-				     error)) {
-			g_prefix_error(error, "error erasing flash: ");
-			return FALSE;
-		}
-		fu_progress_step_done(progress);
+	if (!fu_device_retry(FU_DEVICE(self),
+			     fu_genesys_usbhub_device_wait_flash_status_register_cb,
+			     self->flash_erase_delay / 30,
+			     &helper,
+			     error)) {
+		g_prefix_error(error, "error erasing flash: ");
+		return FALSE;
 	}
 
 	/* success */
@@ -1347,6 +1331,54 @@ fu_genesys_usbhub_device_write_flash(FuGenesysUsbhubDevice *self,
 	return TRUE;
 }
 
+static gboolean
+fu_genesys_usbhub_device_read_cb(FuDevice *device,
+				 guint32 addr,
+				 guint8 *buf,
+				 gsize bufsz,
+				 FuProgress *progress,
+				 GError **error)
+{
+	FuGenesysUsbhubDevice *self = FU_GENESYS_USBHUB_DEVICE(device);
+	return fu_genesys_usbhub_device_read_flash(self, addr, buf, bufsz, progress, error);
+}
+
+static gboolean
+fu_genesys_usbhub_device_write_cb(FuDevice *device,
+				  guint32 addr,
+				  const guint8 *buf,
+				  gsize bufsz,
+				  FuProgress *progress,
+				  GError **error)
+{
+	FuGenesysUsbhubDevice *self = FU_GENESYS_USBHUB_DEVICE(device);
+	return fu_genesys_usbhub_device_write_flash(self, addr, buf, bufsz, progress, error);
+}
+
+static const FuCfiDeviceFuncs fu_genesys_usbhub_device_flash_funcs = {
+    .read = fu_genesys_usbhub_device_read_cb,
+    .write = fu_genesys_usbhub_device_write_cb,
+    .erase_sector = fu_genesys_usbhub_device_erase_sector_cb,
+};
+
+static gboolean
+fu_genesys_usbhub_device_write_bank(FuGenesysUsbhubDevice *self,
+				    guint32 addr,
+				    const guint8 *buf,
+				    gsize bufsz,
+				    FuProgress *progress,
+				    GError **error)
+{
+	g_autoptr(GBytes) blob = g_bytes_new_static(buf, bufsz);
+	return fu_cfi_device_write_diff(self->cfi_device,
+					FU_DEVICE(self),
+					&fu_genesys_usbhub_device_flash_funcs,
+					addr,
+					blob,
+					progress,
+					error);
+}
+
 static gboolean
 fu_genesys_usbhub_device_write_recovery(FuGenesysUsbhubDevice *self,
 					GBytes *blob,
@@ -1355,15 +1387,12 @@ fu_genesys_usbhub_device_write_recovery(FuGenesysUsbhubDevice *self,
 {
 	gsize bufsz = 0;
 	g_autofree guint8 *buf = NULL;
-	g_autofree guint8 *buf_verify = NULL;
 
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	if (self->read_first_bank)
 		fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_READ, 20);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 30);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 50);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_VERIFY, 20);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 100);
 
 	/* reuse fw on first bank for GL3523 */
 	if (self->read_first_bank) {
@@ -1392,36 +1421,14 @@ fu_genesys_usbhub_device_write_recovery(FuGenesysUsbhubDevice *self,
 			return FALSE;
 	}
 
-	/* erase */
-	if (!fu_genesys_usbhub_device_erase_flash(self,
-						  self->fw_bank_addr[1],
-						  bufsz,
-						  fu_progress_get_child(progress),
-						  error))
-		return FALSE;
-	fu_progress_step_done(progress);
-
-	/* write */
-	if (!fu_genesys_usbhub_device_write_flash(self,
-						  self->fw_bank_addr[1],
-						  buf,
-						  bufsz,
-						  fu_progress_get_child(progress),
-						  error))
-		return FALSE;
-	fu_progress_step_done(progress);
-
-	/* verify */
-	buf_verify = g_malloc0(bufsz);
-	if (!fu_genesys_usbhub_device_read_flash(self,
+	/* erase and write the sectors that changed */
+	if (!fu_genesys_usbhub_device_write_bank(self,
 						 self->fw_bank_addr[1],
-						 buf_verify,
+						 buf,
 						 bufsz,
 						 fu_progress_get_child(progress),
 						 error))
 		return FALSE;
-	if (!fu_common_bytes_compare_raw(buf_verify, bufsz, buf, bufsz, error))
-		return FALSE;
 	fu_progress_step_done(progress);
 
 	/* success */
@@ -1437,7 +1444,6 @@ fu_genesys_usbhub_device_write_firmware(FuDevice *device,
 {
 	FuGenesysUsbhubDevice *self = FU_GENESYS_USBHUB_DEVICE(device);
 	g_autoptr(GBytes) blob = NULL;
-	g_autofree guint8 *buf_verify = NULL;
 
 	blob = fu_firmware_get_bytes(firmware, error);
 	if (blob == NULL)
@@ -1451,9 +1457,7 @@ fu_genesys_usbhub_device_write_firmware(FuDevice *device,
 		else
 			fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 100);
 	}
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 30);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 50);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_VERIFY, 20);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 100);
 
 	/* write fw to recovery bank first? */
 	if (self->write_recovery_bank) {
@@ -1466,38 +1470,13 @@ fu_genesys_usbhub_device_write_firmware(FuDevice *device,
 	}
 
 	/* write fw to first bank then */
-	if (!fu_genesys_usbhub_device_erase_flash(self,
-						  self->fw_bank_addr[0],
-						  g_bytes_get_size(blob),
-						  fu_progress_get_child(progress),
-						  error))
-		return FALSE;
-	fu_progress_step_done(progress);
-
-	if (!fu_genesys_usbhub_device_write_flash(self,
-						  self->fw_bank_addr[0],
-						  g_bytes_get_data(blob, NULL),
-						  g_bytes_get_size(blob),
-						  fu_progress_get_child(progress),
-						  error))
-		return FALSE;
-	fu_progress_step_done(progress);
-
-	/* verify */
-	buf_verify = g_malloc0(g_bytes_get_size(blob));
-	if (!fu_genesys_usbhub_device_read_flash(self,
+	if (!fu_genesys_usbhub_device_write_bank(self,
 						 self->fw_bank_addr[0],
-						 buf_verify,
+						 g_bytes_get_data(blob, NULL),
 						 g_bytes_get_size(blob),
 						 fu_progress_get_child(progress),
 						 error))
 		return FALSE;
-	if (!fu_common_bytes_compare_raw(buf_verify,
-					 g_bytes_get_size(blob),
-					 g_bytes_get_data(blob, NULL),
-					 g_bytes_get_size(blob),
-					 error))
-		return FALSE;
 	fu_progress_step_done(progress);
 
 	/* success */
@@ -42,7 +42,7 @@ fu_plugin_linux_swap_changed_cb(GFileMonitor *monitor,
 {
 	FuPlugin *plugin = FU_PLUGIN(user_data);
 	FuContext *ctx = fu_plugin_get_context(plugin);
-	fu_context_security_changed(ctx);
+	fu_context_security_changed_full(ctx, fu_plugin_get_name(plugin));
 }
 
 static gboolean
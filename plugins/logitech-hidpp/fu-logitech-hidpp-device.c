@@ -291,6 +291,7 @@ fu_logitech_hidpp_device_open(FuDevice *device, GError **error)
 	priv->io_channel = fu_io_channel_new_file(devpath, error);
 	if (priv->io_channel == NULL)
 		return FALSE;
+	fu_io_channel_set_device(priv->io_channel, device);
 
 	return TRUE;
 }
@@ -160,6 +160,7 @@ fu_logitech_hidpp_runtime_open(FuDevice *device, GError **error)
 	priv->io_channel = fu_io_channel_new_file(devpath, error);
 	if (priv->io_channel == NULL)
 		return FALSE;
+	fu_io_channel_set_device(priv->io_channel, device);
 
 	/* poll for notifications */
 	fu_device_set_poll_interval(device, FU_HIDPP_RECEIVER_RUNTIME_POLLING_INTERVAL);
@@ -6,12 +6,24 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #ifdef HAVE_MTD_USER_H
 #include <mtd/mtd-user.h>
 #endif
 
 #include "fu-mtd-device.h"
 
+/**
+ * FU_MTD_DEVICE_FLAG_SKIP_UNCHANGED:
+ *
+ * Read back each erase block before writing, and only erase, write and verify the blocks that
+ * differ from the new image. This reduces flash wear when only part of the image changes.
+ *
+ * Since: 1.8.0
+ */
+#define FU_MTD_DEVICE_FLAG_SKIP_UNCHANGED (1 << 0)
+
 struct _FuMtdDevice {
 	FuUdevDevice parent_instance;
 	guint64 erasesize;
@@ -163,11 +175,9 @@ fu_mtd_device_probe(FuDevice *device, GError **error)
 }
 
 static gboolean
-fu_mtd_device_erase(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError **error)
+fu_mtd_device_erase(FuMtdDevice *self, GPtrArray *chunks, FuProgress *progress, GError **error)
 {
 #ifdef HAVE_MTD_USER_H
-	g_autoptr(GPtrArray) chunks = fu_chunk_array_new_from_bytes(fw, 0x0, 0x0, self->erasesize);
-
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, chunks->len);
@@ -200,30 +210,16 @@ fu_mtd_device_erase(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError
 static gboolean
 fu_mtd_device_write(FuMtdDevice *self, GPtrArray *chunks, FuProgress *progress, GError **error)
 {
-	/* progress */
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, chunks->len);
-
 	/* rewind */
 	if (!fu_udev_device_seek(FU_UDEV_DEVICE(self), 0x0, error)) {
 		g_prefix_error(error, "failed to rewind: ");
 		return FALSE;
 	}
 
-	/* write each chunk */
-	for (guint i = 0; i < chunks->len; i++) {
-		FuChunk *chk = g_ptr_array_index(chunks, i);
-		if (!fu_udev_device_pwrite_full(FU_UDEV_DEVICE(self),
-						fu_chunk_get_address(chk),
-						fu_chunk_get_data(chk),
-						fu_chunk_get_data_sz(chk),
-						error)) {
-			g_prefix_error(error,
-				       "failed to write @0x%x: ",
-				       (guint)fu_chunk_get_address(chk));
-			return FALSE;
-		}
-		fu_progress_step_done(progress);
+	/* write all the chunks in as few syscalls as possible */
+	if (!fu_udev_device_pwritev(FU_UDEV_DEVICE(self), chunks, progress, error)) {
+		g_prefix_error(error, "failed to write: ");
+		return FALSE;
 	}
 
 	/* success */
@@ -231,43 +227,50 @@ fu_mtd_device_write(FuMtdDevice *self, GPtrArray *chunks, FuProgress *progress,
 }
 
 static gboolean
-fu_mtd_device_verify(FuMtdDevice *self, GPtrArray *chunks, FuProgress *progress, GError **error)
+fu_mtd_device_compare(GPtrArray *chunks, const guint8 *buf, GError **error)
 {
-	/* progress */
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, chunks->len);
-
-	/* verify each chunk */
 	for (guint i = 0; i < chunks->len; i++) {
 		FuChunk *chk = g_ptr_array_index(chunks, i);
-		g_autofree guint8 *buf = g_malloc0(fu_chunk_get_data_sz(chk));
 		g_autoptr(GBytes) blob1 = fu_chunk_get_bytes(chk);
 		g_autoptr(GBytes) blob2 = NULL;
 
-		if (!fu_udev_device_pread_full(FU_UDEV_DEVICE(self),
-					       fu_chunk_get_address(chk),
-					       buf,
-					       fu_chunk_get_data_sz(chk),
-					       error)) {
-			g_prefix_error(error,
-				       "failed to read @0x%x: ",
-				       (guint)fu_chunk_get_address(chk));
-			return FALSE;
-		}
-		blob2 = g_bytes_new_static(buf, fu_chunk_get_data_sz(chk));
+		blob2 = g_bytes_new_static(buf + fu_chunk_get_address(chk),
+					   fu_chunk_get_data_sz(chk));
 		if (!fu_common_bytes_compare(blob1, blob2, error)) {
 			g_prefix_error(error,
 				       "failed to verify @0x%x: ",
 				       (guint)fu_chunk_get_address(chk));
 			return FALSE;
 		}
-		fu_progress_step_done(progress);
 	}
 
 	/* success */
 	return TRUE;
 }
 
+static gboolean
+fu_mtd_device_verify(FuMtdDevice *self, GPtrArray *chunks, FuProgress *progress, GError **error)
+{
+	gsize bufsz = 0;
+	g_autofree guint8 *buf = NULL;
+	g_autoptr(GPtrArray) chunks_read = NULL;
+
+	/* read back everything that was written */
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
+		bufsz = MAX(bufsz, fu_chunk_get_address(chk) + fu_chunk_get_data_sz(chk));
+	}
+	buf = g_malloc0(bufsz);
+	chunks_read = fu_chunk_array_mutable_new(buf, bufsz, 0x0, 0x0, 10 * 1024);
+	if (!fu_udev_device_preadv(FU_UDEV_DEVICE(self), chunks_read, progress, error)) {
+		g_prefix_error(error, "failed to read: ");
+		return FALSE;
+	}
+
+	/* verify each chunk */
+	return fu_mtd_device_compare(chunks, buf, error);
+}
+
 static gboolean
 fu_mtd_device_write_verify(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError **error)
 {
@@ -293,6 +296,78 @@ fu_mtd_device_write_verify(FuMtdDevice *self, GBytes *fw, FuProgress *progress,
 	return TRUE;
 }
 
+static gboolean
+fu_mtd_device_write_unchanged(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError **error)
+{
+	gsize bufsz = g_bytes_get_size(fw);
+	g_autofree guint8 *buf = g_malloc0(bufsz);
+	g_autoptr(GPtrArray) blocks = NULL;
+	g_autoptr(GPtrArray) blocks_dirty = g_ptr_array_new_with_free_func(g_object_unref);
+	g_autoptr(GPtrArray) blocks_old = NULL;
+	g_autoptr(GPtrArray) blocks_new = g_ptr_array_new_with_free_func(g_object_unref);
+
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_GUESSED);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_READ, 15);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 35);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 40);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_VERIFY, 10);
+
+	/* read the old contents of every erase block the image covers */
+	blocks = fu_chunk_array_new_from_bytes(fw, 0x0, 0x0, self->erasesize);
+	blocks_old = fu_chunk_array_mutable_new(buf, bufsz, 0x0, 0x0, self->erasesize);
+	if (!fu_udev_device_preadv(FU_UDEV_DEVICE(self),
+				   blocks_old,
+				   fu_progress_get_child(progress),
+				   error)) {
+		g_prefix_error(error, "failed to read: ");
+		return FALSE;
+	}
+	fu_progress_step_done(progress);
+
+	/* only the blocks that differ need to be erased and written */
+	for (guint i = 0; i < blocks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(blocks, i);
+		if (memcmp(fu_chunk_get_data(chk),
+			   buf + fu_chunk_get_address(chk),
+			   fu_chunk_get_data_sz(chk)) == 0)
+			continue;
+		g_ptr_array_add(blocks_new, g_object_ref(chk));
+		g_ptr_array_add(blocks_dirty, g_object_ref(g_ptr_array_index(blocks_old, i)));
+	}
+	g_debug("%u of %u erase blocks changed", blocks_new->len, blocks->len);
+	if (blocks_new->len == 0) {
+		fu_progress_finished(progress);
+		return TRUE;
+	}
+
+	/* erase */
+	if (!fu_mtd_device_erase(self, blocks_new, fu_progress_get_child(progress), error))
+		return FALSE;
+	fu_progress_step_done(progress);
+
+	/* write */
+	if (!fu_mtd_device_write(self, blocks_new, fu_progress_get_child(progress), error))
+		return FALSE;
+	fu_progress_step_done(progress);
+
+	/* read back just the blocks that were written */
+	if (!fu_udev_device_preadv(FU_UDEV_DEVICE(self),
+				   blocks_dirty,
+				   fu_progress_get_child(progress),
+				   error)) {
+		g_prefix_error(error, "failed to read: ");
+		return FALSE;
+	}
+	if (!fu_mtd_device_compare(blocks_new, buf, error))
+		return FALSE;
+	fu_progress_step_done(progress);
+
+	/* success */
+	return TRUE;
+}
+
 static GBytes *
 fu_mtd_device_dump_firmware(FuDevice *device, FuProgress *progress, GError **error)
 {
@@ -305,22 +380,11 @@ fu_mtd_device_dump_firmware(FuDevice *device, FuProgress *progress, GError **err
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_READ);
 
-	/* read each chunk */
+	/* read all the chunks in as few syscalls as possible */
 	chunks = fu_chunk_array_mutable_new(buf, bufsz, 0x0, 0x0, 10 * 1024);
-	fu_progress_set_steps(progress, chunks->len);
-	for (guint i = 0; i < chunks->len; i++) {
-		FuChunk *chk = g_ptr_array_index(chunks, i);
-		if (!fu_udev_device_pread_full(FU_UDEV_DEVICE(self),
-					       fu_chunk_get_address(chk),
-					       fu_chunk_get_data_out(chk),
-					       fu_chunk_get_data_sz(chk),
-					       error)) {
-			g_prefix_error(error,
-				       "failed to read @0x%x: ",
-				       (guint)fu_chunk_get_address(chk));
-			return NULL;
-		}
-		fu_progress_step_done(progress);
+	if (!fu_udev_device_preadv(FU_UDEV_DEVICE(self), chunks, progress, error)) {
+		g_prefix_error(error, "failed to read: ");
+		return NULL;
 	}
 
 	/* success */
@@ -336,6 +400,7 @@ fu_mtd_device_write_firmware(FuDevice *device,
 {
 	FuMtdDevice *self = FU_MTD_DEVICE(device);
 	g_autoptr(GBytes) fw = NULL;
+	g_autoptr(GPtrArray) chunks = NULL;
 
 	/* get data to write */
 	fw = fu_firmware_get_bytes(firmware, error);
@@ -355,6 +420,10 @@ fu_mtd_device_write_firmware(FuDevice *device,
 	if (self->erasesize == 0)
 		return fu_mtd_device_write_verify(self, fw, progress, error);
 
+	/* only touch the erase blocks that changed */
+	if (fu_device_has_private_flag(device, FU_MTD_DEVICE_FLAG_SKIP_UNCHANGED))
+		return fu_mtd_device_write_unchanged(self, fw, progress, error);
+
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_GUESSED);
@@ -362,7 +431,8 @@ fu_mtd_device_write_firmware(FuDevice *device,
 	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 50);
 
 	/* erase */
-	if (!fu_mtd_device_erase(self, fw, fu_progress_get_child(progress), error))
+	chunks = fu_chunk_array_new_from_bytes(fw, 0x0, 0x0, self->erasesize);
+	if (!fu_mtd_device_erase(self, chunks, fu_progress_get_child(progress), error))
 		return FALSE;
 	fu_progress_step_done(progress);
 
@@ -388,6 +458,9 @@ fu_mtd_device_init(FuMtdDevice *self)
 	fu_udev_device_set_flags(FU_UDEV_DEVICE(self),
 				 FU_UDEV_DEVICE_FLAG_OPEN_READ | FU_UDEV_DEVICE_FLAG_OPEN_WRITE |
 				     FU_UDEV_DEVICE_FLAG_OPEN_SYNC);
+	fu_device_register_private_flag(FU_DEVICE(self),
+					FU_MTD_DEVICE_FLAG_SKIP_UNCHANGED,
+					"skip-unchanged");
 }
 
 static void
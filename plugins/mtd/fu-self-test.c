@@ -13,16 +13,22 @@ static void
 fu_test_mtd_device_func(void)
 {
 #ifdef HAVE_GUDEV
+	const gchar *written;
 	gsize bufsz;
 	gboolean ret;
+	guint64 erasesize = 0;
+	g_autofree gchar *erasesize_str = NULL;
 	g_autoptr(FuContext) ctx = fu_context_new();
 	g_autoptr(FuDevice) device = NULL;
 	g_autoptr(FuDeviceLocker) locker = NULL;
 	g_autoptr(FuProgress) progress = fu_progress_new(NULL);
 	g_autoptr(GByteArray) buf = g_byte_array_new();
 	g_autoptr(GBytes) fw2 = NULL;
+	g_autoptr(GBytes) fw3 = NULL;
+	g_autoptr(GBytes) fw4 = NULL;
 	g_autoptr(GBytes) fw = NULL;
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) metadata = NULL;
 	g_autoptr(GRand) rand = g_rand_new_with_seed(0);
 	g_autoptr(GUdevClient) udev_client = g_udev_client_new(NULL);
 	g_autoptr(GUdevDevice) udev_device = NULL;
@@ -32,6 +38,9 @@ fu_test_mtd_device_func(void)
 	g_assert_no_error(error);
 	g_assert_true(ret);
 
+	/* count the erase ioctls and the bytes written */
+	fu_context_add_flag(ctx, FU_CONTEXT_FLAG_REPORT_IO_STATS);
+
 	udev_device =
 	    g_udev_client_query_by_sysfs_path(udev_client, "/sys/devices/virtual/mtd/mtd0");
 	if (udev_device == NULL) {
@@ -72,6 +81,44 @@ fu_test_mtd_device_func(void)
 	ret = fu_common_bytes_compare(fw, fw2, &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+
+	/* change a few bytes in one erase block and only write that */
+	buf = g_byte_array_new();
+	fu_byte_array_append_bytes(buf, fw);
+	for (gsize i = 0x12000; i < 0x12100; i++)
+		buf->data[i] ^= 0xFF;
+	fw3 = g_byte_array_free_to_bytes(g_steal_pointer(&buf));
+	fu_device_set_custom_flags(device, "skip-unchanged");
+	fu_device_clear_io_stats(device);
+	fu_progress_reset(progress);
+	ret = fu_device_write_firmware(device, fw3, progress, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* only the one changed erase block was erased and written */
+	ret = fu_udev_device_get_sysfs_attr_uint64(FU_UDEV_DEVICE(device),
+						   "erasesize",
+						   &erasesize,
+						   &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	erasesize_str = g_strdup_printf("%" G_GUINT64_FORMAT, erasesize);
+	metadata = fu_device_report_metadata_post(device);
+	g_assert_nonnull(metadata);
+	g_assert_cmpstr(g_hash_table_lookup(metadata, "IoIoctlTransfers"), ==, "1");
+	written = g_hash_table_lookup(metadata, "IoPwritevBytes");
+	if (written == NULL)
+		written = g_hash_table_lookup(metadata, "IoPwriteBytes");
+	g_assert_cmpstr(written, ==, erasesize_str);
+
+	/* dump back */
+	fu_progress_reset(progress);
+	fw4 = fu_device_dump_firmware(device, progress, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(fw4);
+	ret = fu_common_bytes_compare(fw3, fw4, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
 #else
 	g_test_skip("no GUdev support");
 #endif
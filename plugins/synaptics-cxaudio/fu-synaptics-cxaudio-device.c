@@ -837,11 +837,10 @@ fu_synaptics_cxaudio_device_set_quirk_kv(FuDevice *device,
 		self->eeprom_patch2_valid_addr = tmp;
 		return TRUE;
 	}
-	g_set_error_literal(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_NOT_SUPPORTED,
-			    "quirk key not supported");
-	return FALSE;
+
+	/* FuHidDevice->set_quirk_kv */
+	return FU_DEVICE_CLASS(fu_synaptics_cxaudio_device_parent_class)
+	    ->set_quirk_kv(device, key, value, error);
 }
 
 static void
@@ -314,6 +314,30 @@ fu_plugin_test_composite_cleanup(FuPlugin *plugin, GPtrArray *devices, GError **
 	return TRUE;
 }
 
+static void
+fu_plugin_test_add_security_attrs(FuPlugin *plugin, FuSecurityAttrs *attrs)
+{
+	const gchar *delay_ms = g_getenv("FWUPD_PLUGIN_TEST_HSI_DELAY_MS");
+	g_autofree gchar *hsi = g_strdup(g_getenv("FWUPD_PLUGIN_TEST_HSI"));
+	g_autoptr(FwupdSecurityAttr) attr = NULL;
+
+	/* only used by the self tests */
+	if (hsi == NULL)
+		return;
+	if (delay_ms != NULL)
+		g_usleep(g_ascii_strtoull(delay_ms, NULL, 10) * 1000);
+
+	attr = fwupd_security_attr_new(FWUPD_SECURITY_ATTR_ID_ENCRYPTED_RAM);
+	fwupd_security_attr_set_plugin(attr, fu_plugin_get_name(plugin));
+	if (g_strcmp0(hsi, "encrypted") == 0) {
+		fwupd_security_attr_add_flag(attr, FWUPD_SECURITY_ATTR_FLAG_SUCCESS);
+		fwupd_security_attr_set_result(attr, FWUPD_SECURITY_ATTR_RESULT_ENCRYPTED);
+	} else {
+		fwupd_security_attr_set_result(attr, FWUPD_SECURITY_ATTR_RESULT_NOT_ENCRYPTED);
+	}
+	fu_security_attrs_append(attrs, attr);
+}
+
 void
 fu_plugin_init_vfuncs(FuPluginVfuncs *vfuncs)
 {
@@ -329,4 +353,5 @@ fu_plugin_init_vfuncs(FuPluginVfuncs *vfuncs)
 	vfuncs->startup = fu_plugin_test_startup;
 	vfuncs->coldplug = fu_plugin_test_coldplug;
 	vfuncs->device_registered = fu_plugin_test_device_registered;
+	vfuncs->add_security_attrs = fu_plugin_test_add_security_attrs;
 }
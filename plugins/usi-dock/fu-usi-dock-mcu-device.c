@@ -401,74 +401,53 @@ fu_usi_dock_mcu_device_setup(FuDevice *device, GError **error)
 }
 
 static gboolean
-fu_usi_dock_mcu_device_write_chunk(FuUsiDockMcuDevice *self, FuChunk *chk, GError **error)
+fu_usi_dock_mcu_device_check_ack(FuUsiDockMcuDevice *self, GError **error)
 {
 	guint8 buf[64] = {0x0};
-	guint32 length = 0;
-	guint32 pagesize = fu_chunk_get_data_sz(chk);
-
-	while (pagesize != 0) {
-		memset(buf, 0x0, sizeof(buf));
-		buf[63] = TAG_TAG2_MASS_DATA_SPI;
-		buf[0] = USB_HID_REPORT_ID2;
-
-		/* set length and buffer */
-		if (pagesize >= TX_ISP_LENGTH) {
-			length = TX_ISP_LENGTH;
-			pagesize -= TX_ISP_LENGTH;
-		} else {
-			length = pagesize;
-			pagesize = 0;
-		}
-		buf[1] = length;
 
-		/* SetReport */
-		if (!fu_memcpy_safe(buf,
-				    sizeof(buf),
-				    0x2, /* dst */
-				    fu_chunk_get_data(chk),
-				    fu_chunk_get_data_sz(chk),
-				    fu_chunk_get_data_sz(chk) - pagesize - length, /* src */
-				    length,
-				    error))
-			return FALSE;
+	/* GetReport */
+	if (!fu_hid_device_get_report(FU_HID_DEVICE(self),
+				      USB_HID_REPORT_ID2,
+				      buf,
+				      sizeof(buf),
+				      FU_USI_DOCK_MCU_DEVICE_TIMEOUT,
+				      FU_HID_DEVICE_FLAG_NONE,
+				      error)) {
+		return FALSE;
+	}
+	if (buf[0] != USB_HID_REPORT_ID2) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_INVALID_DATA,
+			    "invalid ID, expected 0x%02x, got 0x%02x",
+			    USB_HID_REPORT_ID2,
+			    buf[0]);
+		return FALSE;
+	}
+	if (buf[63] != TAG_TAG2_CMD_SPI) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_INVALID_DATA,
+			    "invalid tag2, expected 0x%02x, got 0x%02x",
+			    (guint)TAG_TAG2_CMD_SPI,
+			    buf[63]);
+		return FALSE;
+	}
+	return TRUE;
+}
 
-		if (!fu_hid_device_set_report(FU_HID_DEVICE(self),
-					      USB_HID_REPORT_ID2,
-					      buf,
-					      sizeof(buf),
-					      FU_USI_DOCK_MCU_DEVICE_TIMEOUT,
-					      FU_HID_DEVICE_FLAG_NONE,
-					      error))
-			return FALSE;
+static gboolean
+fu_usi_dock_mcu_device_write_chunks_status_cb(FuHidDevice *device,
+					      guint count,
+					      gpointer user_data,
+					      GError **error)
+{
+	FuUsiDockMcuDevice *self = FU_USI_DOCK_MCU_DEVICE(device);
 
-		/* GetReport */
-		memset(buf, 0x0, sizeof(buf));
-		if (!fu_hid_device_get_report(FU_HID_DEVICE(self),
-					      USB_HID_REPORT_ID2,
-					      buf,
-					      sizeof(buf),
-					      FU_USI_DOCK_MCU_DEVICE_TIMEOUT,
-					      FU_HID_DEVICE_FLAG_NONE,
-					      error)) {
-			return FALSE;
-		}
-		if (buf[0] != USB_HID_REPORT_ID2) {
-			g_set_error(error,
-				    G_IO_ERROR,
-				    G_IO_ERROR_INVALID_DATA,
-				    "invalid ID, expected 0x%02x, got 0x%02x",
-				    USB_HID_REPORT_ID2,
-				    buf[0]);
-			return FALSE;
-		}
-		if (buf[63] != TAG_TAG2_CMD_SPI) {
-			g_set_error(error,
-				    G_IO_ERROR,
-				    G_IO_ERROR_INVALID_DATA,
-				    "invalid tag2, expected 0x%02x, got 0x%02x",
-				    (guint)TAG_TAG2_CMD_SPI,
-				    buf[58]);
+	/* every report is acknowledged */
+	for (guint i = 0; i < count; i++) {
+		if (!fu_usi_dock_mcu_device_check_ack(self, error)) {
+			g_prefix_error(error, "failed to get ack 0x%x: ", i);
 			return FALSE;
 		}
 	}
@@ -481,17 +460,44 @@ fu_usi_dock_mcu_device_write_chunks(FuUsiDockMcuDevice *self,
 				    FuProgress *progress,
 				    GError **error)
 {
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, chunks->len);
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GPtrArray) reports = NULL;
+
+	/* split each chunk into reports */
 	for (guint i = 0; i < chunks->len; i++) {
 		FuChunk *chk = g_ptr_array_index(chunks, i);
-		if (!fu_usi_dock_mcu_device_write_chunk(self, chk, error)) {
-			g_prefix_error(error, "failed to write chunk 0x%x", i);
-			return FALSE;
+		gsize chksz = fu_chunk_get_data_sz(chk);
+		for (gsize offset = 0; offset < chksz; offset += TX_ISP_LENGTH) {
+			gsize length = MIN(TX_ISP_LENGTH, chksz - offset);
+			guint8 report[64] = {0x0};
+
+			report[0] = USB_HID_REPORT_ID2;
+			report[1] = length;
+			report[63] = TAG_TAG2_MASS_DATA_SPI;
+			if (!fu_memcpy_safe(report,
+					    sizeof(report),
+					    0x2, /* dst */
+					    fu_chunk_get_data(chk),
+					    chksz,
+					    offset, /* src */
+					    length,
+					    error))
+				return FALSE;
+			g_byte_array_append(buf, report, sizeof(report));
 		}
-		fu_progress_step_done(progress);
 	}
-	return TRUE;
+
+	/* send with the flow control from the HidStatusInterval quirk */
+	reports = fu_chunk_array_mutable_new(buf->data, buf->len, 0x0, 0x0, 64);
+	return fu_hid_device_set_reports(FU_HID_DEVICE(self),
+					 USB_HID_REPORT_ID2,
+					 reports,
+					 FU_USI_DOCK_MCU_DEVICE_TIMEOUT,
+					 FU_HID_DEVICE_FLAG_NONE,
+					 fu_usi_dock_mcu_device_write_chunks_status_cb,
+					 NULL,
+					 progress,
+					 error);
 }
 
 static gboolean
@@ -158,7 +158,27 @@ fu_vli_device_spi_wait_finish(FuVliDevice *self, GError **error)
 gboolean
 fu_vli_device_spi_erase_sector(FuVliDevice *self, guint32 addr, GError **error)
 {
-	const guint32 bufsz = 0x1000;
+	FuVliDevicePrivate *priv = GET_PRIVATE(self);
+	guint32 bufsz = fu_cfi_device_get_sector_size(priv->cfi_device);
+
+	/* the sector erase command uses the geometry of the chip */
+	if (bufsz == 0 || bufsz % FU_VLI_DEVICE_TXSIZE != 0) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_NOT_SUPPORTED,
+			    "unsupported sector size 0x%x",
+			    bufsz);
+		return FALSE;
+	}
+	if (addr % bufsz != 0) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_INVALID_DATA,
+			    "address 0x%x is not aligned to sector size 0x%x",
+			    addr,
+			    bufsz);
+		return FALSE;
+	}
 
 	/* erase sector */
 	if (!fu_vli_device_spi_write_enable(self, error)) {
@@ -205,18 +225,19 @@ fu_vli_device_spi_erase_sector(FuVliDevice *self, guint32 addr, GError **error)
 	return TRUE;
 }
 
-GBytes *
-fu_vli_device_spi_read(FuVliDevice *self,
-		       guint32 address,
-		       gsize bufsz,
-		       FuProgress *progress,
-		       GError **error)
+static gboolean
+fu_vli_device_spi_read_cb(FuDevice *device,
+			  guint32 addr,
+			  guint8 *buf,
+			  gsize bufsz,
+			  FuProgress *progress,
+			  GError **error)
 {
-	g_autofree guint8 *buf = g_malloc0(bufsz);
+	FuVliDevice *self = FU_VLI_DEVICE(device);
 	g_autoptr(GPtrArray) chunks = NULL;
 
 	/* get data from hardware */
-	chunks = fu_chunk_array_mutable_new(buf, bufsz, address, 0x0, FU_VLI_DEVICE_TXSIZE);
+	chunks = fu_chunk_array_mutable_new(buf, bufsz, addr, 0x0, FU_VLI_DEVICE_TXSIZE);
 	fu_progress_set_steps(progress, chunks->len);
 	for (guint i = 0; i < chunks->len; i++) {
 		FuChunk *chk = g_ptr_array_index(chunks, i);
@@ -228,10 +249,23 @@ fu_vli_device_spi_read(FuVliDevice *self,
 			g_prefix_error(error,
 				       "SPI data read failed @0x%x: ",
 				       fu_chunk_get_address(chk));
-			return NULL;
+			return FALSE;
 		}
 		fu_progress_step_done(progress);
 	}
+	return TRUE;
+}
+
+GBytes *
+fu_vli_device_spi_read(FuVliDevice *self,
+		       guint32 address,
+		       gsize bufsz,
+		       FuProgress *progress,
+		       GError **error)
+{
+	g_autofree guint8 *buf = g_malloc0(bufsz);
+	if (!fu_vli_device_spi_read_cb(FU_DEVICE(self), address, buf, bufsz, progress, error))
+		return NULL;
 	return g_bytes_new_take(g_steal_pointer(&buf), bufsz);
 }
 
@@ -332,6 +366,125 @@ fu_vli_device_spi_write(FuVliDevice *self,
 	return TRUE;
 }
 
+static gboolean
+fu_vli_device_spi_write_cb(FuDevice *device,
+			   guint32 addr,
+			   const guint8 *buf,
+			   gsize bufsz,
+			   FuProgress *progress,
+			   GError **error)
+{
+	FuVliDevice *self = FU_VLI_DEVICE(device);
+	g_autoptr(GPtrArray) chunks = NULL;
+
+	/* each block is read back as soon as it is written */
+	chunks = fu_chunk_array_new(buf, bufsz, addr, 0x0, FU_VLI_DEVICE_TXSIZE);
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, chunks->len);
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
+		if (!fu_vli_device_spi_write_block(self,
+						   fu_chunk_get_address(chk),
+						   fu_chunk_get_data(chk),
+						   fu_chunk_get_data_sz(chk),
+						   fu_progress_get_child(progress),
+						   error)) {
+			g_prefix_error(error,
+				       "failed to write block @0x%x: ",
+				       fu_chunk_get_address(chk));
+			return FALSE;
+		}
+		fu_progress_step_done(progress);
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_vli_device_spi_erase_sector_cb(FuDevice *device, guint32 addr, GError **error)
+{
+	return fu_vli_device_spi_erase_sector(FU_VLI_DEVICE(device), addr, error);
+}
+
+static const FuCfiDeviceFuncs fu_vli_device_spi_funcs = {
+    .read = fu_vli_device_spi_read_cb,
+    .write = fu_vli_device_spi_write_cb,
+    .erase_sector = fu_vli_device_spi_erase_sector_cb,
+};
+
+/* only erases and writes the sectors that differ, with the first sector written last */
+gboolean
+fu_vli_device_spi_write_diff(FuVliDevice *self,
+			     guint32 address,
+			     const guint8 *buf,
+			     gsize bufsz,
+			     FuProgress *progress,
+			     GError **error)
+{
+	FuVliDevicePrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GBytes) fw = g_bytes_new_static(buf, bufsz);
+	g_debug("writing 0x%x bytes @0x%x", (guint)bufsz, address);
+	return fu_cfi_device_write_diff(priv->cfi_device,
+					FU_DEVICE(self),
+					&fu_vli_device_spi_funcs,
+					address,
+					fw,
+					progress,
+					error);
+}
+
+/* as fu_vli_device_spi_write_diff(), but also blanks the rest of the region after the image;
+ * if the region size is unknown the whole chip is erased before writing */
+gboolean
+fu_vli_device_spi_write_region(FuVliDevice *self,
+			       guint32 address,
+			       const guint8 *buf,
+			       gsize bufsz,
+			       gsize regionsz,
+			       FuProgress *progress,
+			       GError **error)
+{
+	FuVliDevicePrivate *priv = GET_PRIVATE(self);
+	guint64 flashsz = fu_cfi_device_get_size(priv->cfi_device);
+	gsize bufsz_region = MAX(bufsz, regionsz);
+	g_autofree guint8 *buf_region = NULL;
+
+	/* no region size */
+	if (regionsz == 0) {
+		fu_progress_set_id(progress, G_STRLOC);
+		fu_progress_add_flag(progress, FU_PROGRESS_FLAG_GUESSED);
+		fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 20);
+		fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 80);
+		if (!fu_vli_device_spi_erase_all(self, fu_progress_get_child(progress), error)) {
+			g_prefix_error(error, "failed to erase chip: ");
+			return FALSE;
+		}
+		fu_progress_step_done(progress);
+		if (!fu_vli_device_spi_write(self,
+					     address,
+					     buf,
+					     bufsz,
+					     fu_progress_get_child(progress),
+					     error))
+			return FALSE;
+		fu_progress_step_done(progress);
+		return TRUE;
+	}
+
+	/* the region starts at @address, so do not pad past the end of the chip */
+	if (flashsz > address && address + bufsz_region > flashsz)
+		bufsz_region = MAX(bufsz, flashsz - address);
+
+	buf_region = g_malloc(bufsz_region);
+	memset(buf_region, 0xFF, bufsz_region);
+	memcpy(buf_region, buf, bufsz);
+	return fu_vli_device_spi_write_diff(self,
+					    address,
+					    buf_region,
+					    bufsz_region,
+					    progress,
+					    error);
+}
+
 gboolean
 fu_vli_device_spi_erase_all(FuVliDevice *self, FuProgress *progress, GError **error)
 {
@@ -383,7 +536,18 @@ fu_vli_device_spi_erase(FuVliDevice *self,
 			FuProgress *progress,
 			GError **error)
 {
-	g_autoptr(GPtrArray) chunks = fu_chunk_array_new(NULL, sz, addr, 0x0, 0x1000);
+	FuVliDevicePrivate *priv = GET_PRIVATE(self);
+	guint32 sector_size = fu_cfi_device_get_sector_size(priv->cfi_device);
+	g_autoptr(GPtrArray) chunks = NULL;
+
+	if (sector_size == 0) {
+		g_set_error_literal(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_NOT_SUPPORTED,
+				    "sector size not set");
+		return FALSE;
+	}
+	chunks = fu_chunk_array_new(NULL, sz, addr, 0x0, sector_size);
 	g_debug("erasing 0x%x bytes @0x%x", (guint)sz, addr);
 	fu_progress_set_steps(progress, chunks->len);
 	for (guint i = 0; i < chunks->len; i++) {
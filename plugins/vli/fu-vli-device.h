@@ -81,3 +81,18 @@ fu_vli_device_spi_write(FuVliDevice *self,
 			gsize bufsz,
 			FuProgress *progress,
 			GError **error);
+gboolean
+fu_vli_device_spi_write_diff(FuVliDevice *self,
+			     guint32 address,
+			     const guint8 *buf,
+			     gsize bufsz,
+			     FuProgress *progress,
+			     GError **error);
+gboolean
+fu_vli_device_spi_write_region(FuVliDevice *self,
+			       guint32 address,
+			       const guint8 *buf,
+			       gsize bufsz,
+			       gsize regionsz,
+			       FuProgress *progress,
+			       GError **error);
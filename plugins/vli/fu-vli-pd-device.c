@@ -604,31 +604,15 @@ fu_vli_pd_device_write_firmware(FuDevice *device,
 	    fu_device_has_flag(device, FWUPD_DEVICE_FLAG_DUAL_IMAGE))
 		return fu_vli_pd_device_write_dual_firmware(self, fw, progress, error);
 
-	/* progress */
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 63);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 37);
-
-	/* erase */
-	if (!fu_vli_device_spi_erase_all(FU_VLI_DEVICE(self),
-					 fu_progress_get_child(progress),
-					 error))
-		return FALSE;
-	fu_progress_step_done(progress);
-
-	/* write in chunks */
+	/* erase and write the sectors that changed, and blank anything after the image */
 	buf = g_bytes_get_data(fw, &bufsz);
-	if (!fu_vli_device_spi_write(FU_VLI_DEVICE(self),
-				     fu_vli_device_get_offset(FU_VLI_DEVICE(self)),
-				     buf,
-				     bufsz,
-				     fu_progress_get_child(progress),
-				     error))
-		return FALSE;
-
-	/* success */
-	fu_progress_step_done(progress);
-	return TRUE;
+	return fu_vli_device_spi_write_region(FU_VLI_DEVICE(self),
+					      fu_vli_device_get_offset(FU_VLI_DEVICE(self)),
+					      buf,
+					      bufsz,
+					      fu_device_get_firmware_size_max(device),
+					      progress,
+					      error);
 }
 
 static gboolean
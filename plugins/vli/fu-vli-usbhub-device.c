@@ -867,39 +867,20 @@ fu_vli_usbhub_device_update_v1(FuVliUsbhubDevice *self,
 	const guint8 *buf;
 	g_autoptr(GBytes) fw = NULL;
 
-	/* progress */
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_GUESSED);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 20);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 80);
-
 	/* simple image */
 	fw = fu_firmware_get_bytes(firmware, error);
 	if (fw == NULL)
 		return FALSE;
 
-	/* erase */
-	if (!fu_vli_device_spi_erase_all(FU_VLI_DEVICE(self),
-					 fu_progress_get_child(progress),
-					 error)) {
-		g_prefix_error(error, "failed to erase chip: ");
-		return FALSE;
-	}
-	fu_progress_step_done(progress);
-
-	/* write in chunks */
+	/* erase and write the sectors that changed, and blank anything after the image */
 	buf = g_bytes_get_data(fw, &bufsz);
-	if (!fu_vli_device_spi_write(FU_VLI_DEVICE(self),
-				     0x0,
-				     buf,
-				     bufsz,
-				     fu_progress_get_child(progress),
-				     error))
-		return FALSE;
-
-	/* success */
-	fu_progress_step_done(progress);
-	return TRUE;
+	return fu_vli_device_spi_write_region(FU_VLI_DEVICE(self),
+					      0x0,
+					      buf,
+					      bufsz,
+					      fu_device_get_firmware_size_max(FU_DEVICE(self)),
+					      progress,
+					      error);
 }
 
 /* if no header1 or ROM code update, write data directly */
@@ -912,36 +893,13 @@ fu_vli_usbhub_device_update_v2_recovery(FuVliUsbhubDevice *self,
 	gsize bufsz = 0;
 	const guint8 *buf = g_bytes_get_data(fw, &bufsz);
 
-	/* progress */
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_GUESSED);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 20);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 80);
-
-	/* erase */
-	for (guint32 addr = 0; addr < bufsz; addr += 0x1000) {
-		if (!fu_vli_device_spi_erase_sector(FU_VLI_DEVICE(self), addr, error)) {
-			g_prefix_error(error, "failed to erase sector @0x%x: ", addr);
-			return FALSE;
-		}
-		fu_progress_set_percentage_full(fu_progress_get_child(progress),
-						(gsize)addr,
-						bufsz);
-	}
-	fu_progress_step_done(progress);
-
-	/* write in chunks */
-	if (!fu_vli_device_spi_write(FU_VLI_DEVICE(self),
-				     VLI_USBHUB_FLASHMAP_ADDR_HD1,
-				     buf,
-				     bufsz,
-				     fu_progress_get_child(progress),
-				     error))
-		return FALSE;
-	fu_progress_step_done(progress);
-
-	/* success */
-	return TRUE;
+	/* erase and write the sectors that changed */
+	return fu_vli_device_spi_write_diff(FU_VLI_DEVICE(self),
+					    VLI_USBHUB_FLASHMAP_ADDR_HD1,
+					    buf,
+					    bufsz,
+					    progress,
+					    error);
 }
 
 static gboolean
@@ -1086,26 +1044,16 @@ fu_vli_usbhub_device_update_v2(FuVliUsbhubDevice *self,
 
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 72);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 20);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 92);
 	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_BUSY, 8); /* HD2 */
 
-	/* make space */
-	if (!fu_vli_device_spi_erase(FU_VLI_DEVICE(self),
-				     hd2_fw_addr,
-				     hd2_fw_sz,
-				     fu_progress_get_child(progress),
-				     error))
-		return FALSE;
-	fu_progress_step_done(progress);
-
-	/* perform the actual write */
-	if (!fu_vli_device_spi_write(FU_VLI_DEVICE(self),
-				     hd2_fw_addr,
-				     buf_fw + hd2_fw_offset,
-				     hd2_fw_sz,
-				     fu_progress_get_child(progress),
-				     error)) {
+	/* perform the actual write, only erasing the sectors that changed */
+	if (!fu_vli_device_spi_write_diff(FU_VLI_DEVICE(self),
+					  hd2_fw_addr,
+					  buf_fw + hd2_fw_offset,
+					  hd2_fw_sz,
+					  fu_progress_get_child(progress),
+					  error)) {
 		g_prefix_error(error, "failed to write payload: ");
 		return FALSE;
 	}
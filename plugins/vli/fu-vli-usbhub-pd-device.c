@@ -199,11 +199,6 @@ fu_vli_usbhub_pd_device_write_firmware(FuDevice *device,
 	g_autoptr(FuDeviceLocker) locker = NULL;
 	g_autoptr(GBytes) fw = NULL;
 
-	/* progress */
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 78);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 22);
-
 	/* simple image */
 	fw = fu_firmware_get_bytes(firmware, error);
 	if (fw == NULL)
@@ -214,25 +209,15 @@ fu_vli_usbhub_pd_device_write_firmware(FuDevice *device,
 	if (locker == NULL)
 		return FALSE;
 
-	/* erase */
+	/* erase and write the sectors that changed */
 	buf = g_bytes_get_data(fw, &bufsz);
-	if (!fu_vli_device_spi_erase(FU_VLI_DEVICE(parent),
-				     fu_vli_common_device_kind_get_offset(self->device_kind),
-				     bufsz,
-				     fu_progress_get_child(progress),
-				     error))
-		return FALSE;
-	fu_progress_step_done(progress);
-
-	/* write */
-	if (!fu_vli_device_spi_write(FU_VLI_DEVICE(parent),
-				     fu_vli_common_device_kind_get_offset(self->device_kind),
-				     buf,
-				     bufsz,
-				     fu_progress_get_child(progress),
-				     error))
+	if (!fu_vli_device_spi_write_diff(FU_VLI_DEVICE(parent),
+					  fu_vli_common_device_kind_get_offset(self->device_kind),
+					  buf,
+					  bufsz,
+					  progress,
+					  error))
 		return FALSE;
-	fu_progress_step_done(progress);
 
 	/* success */
 	return TRUE;
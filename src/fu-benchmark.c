@@ -0,0 +1,381 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#include "config.h"
+
+#include <fwupdplugin.h>
+
+#include "fu-benchmark-common.h"
+#include "fu-device-list.h"
+#include "fu-emulation-backend.h"
+#include "fu-engine.h"
+#include "fu-plugin-private.h"
+
+#define FU_BENCHMARK_DEVICE_COUNT 1000
+
+typedef struct {
+	gchar *emulation_fn;
+	guint plugin_cnt;
+	FuDeviceList *device_list;
+	GPtrArray *devices;
+	GVariant *value;
+	guint idx;
+} FuBenchmarkHelper;
+
+static void
+fu_benchmark_helper_free(FuBenchmarkHelper *helper)
+{
+	g_free(helper->emulation_fn);
+	if (helper->device_list != NULL)
+		g_object_unref(helper->device_list);
+	if (helper->devices != NULL)
+		g_ptr_array_unref(helper->devices);
+	if (helper->value != NULL)
+		g_variant_unref(helper->value);
+	g_free(helper);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuBenchmarkHelper, fu_benchmark_helper_free)
+
+/* use a private tree so that nothing installed on the host is loaded */
+static gchar *
+fu_benchmark_mkroot(GError **error)
+{
+	g_autofree gchar *confdir = NULL;
+	g_autofree gchar *daemon_conf = NULL;
+	g_autofree gchar *remotesdir = NULL;
+	g_autofree gchar *localstatedir = NULL;
+	g_autofree gchar *plugindir = NULL;
+	g_autofree gchar *tmpdir = NULL;
+
+	tmpdir = g_dir_make_tmp("fwupd-benchmark-XXXXXX", error);
+	if (tmpdir == NULL)
+		return NULL;
+	confdir = g_build_filename(tmpdir, "etc", NULL);
+	remotesdir = g_build_filename(confdir, "remotes.d", NULL);
+	localstatedir = g_build_filename(tmpdir, "var", NULL);
+	plugindir = g_build_filename(tmpdir, "plugins", NULL);
+	if (g_mkdir_with_parents(remotesdir, 0755) != 0 ||
+	    g_mkdir_with_parents(localstatedir, 0755) != 0 ||
+	    g_mkdir_with_parents(plugindir, 0755) != 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_WRITE,
+			    "failed to create %s",
+			    tmpdir);
+		return NULL;
+	}
+	daemon_conf = g_build_filename(confdir, "daemon.conf", NULL);
+	if (!g_file_set_contents(daemon_conf, "[fwupd]\n", -1, error))
+		return NULL;
+	g_setenv("CONFIGURATION_DIRECTORY", confdir, TRUE);
+	g_setenv("FWUPD_DATADIR", tmpdir, TRUE);
+	g_setenv("FWUPD_PLUGINDIR", plugindir, TRUE);
+	g_setenv("FWUPD_LOCALSTATEDIR", localstatedir, TRUE);
+	return g_steal_pointer(&tmpdir);
+}
+
+static gboolean
+fu_benchmark_startup_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	g_autoptr(FuEngine) engine = fu_engine_new(FU_APP_FLAGS_NO_IDLE_SOURCES);
+
+	/* no hardware is used, but the backends are still set up and coldplugged */
+	if (!fu_engine_emulation_load(engine, helper->emulation_fn, error))
+		return FALSE;
+	for (guint i = 0; i < helper->plugin_cnt; i++) {
+		g_autofree gchar *name = g_strdup_printf("benchmark%04u", i);
+		g_autoptr(FuPlugin) plugin = fu_plugin_new(fu_engine_get_context(engine));
+		fu_plugin_set_name(plugin, name);
+		fu_engine_add_plugin(engine, plugin);
+	}
+	return fu_engine_load(engine,
+			      FU_ENGINE_LOAD_FLAG_COLDPLUG | FU_ENGINE_LOAD_FLAG_NO_CACHE |
+				  FU_ENGINE_LOAD_FLAG_READONLY,
+			      error);
+}
+
+static gboolean
+fu_benchmark_metadata_cb(gpointer user_data, GError **error)
+{
+	g_autoptr(FuEngine) engine = fu_engine_new(FU_APP_FLAGS_NO_IDLE_SOURCES);
+	return fu_engine_load(engine,
+			      FU_ENGINE_LOAD_FLAG_REMOTES | FU_ENGINE_LOAD_FLAG_NO_CACHE |
+				  FU_ENGINE_LOAD_FLAG_READONLY,
+			      error);
+}
+
+static gboolean
+fu_benchmark_device_list_add_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	g_autoptr(FuDeviceList) device_list = fu_device_list_new();
+	for (guint i = 0; i < helper->devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(helper->devices, i);
+		fu_device_list_add(device_list, device);
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_device_list_get_by_guid_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	FuDevice *device;
+	GPtrArray *guids;
+	g_autoptr(FuDevice) device_tmp = NULL;
+
+	/* vary the lookup so the result is not cached */
+	helper->idx = (helper->idx + 7919) % helper->devices->len;
+	device = g_ptr_array_index(helper->devices, helper->idx);
+	guids = fu_device_get_guids(device);
+	device_tmp = fu_device_list_get_by_guid(helper->device_list,
+						g_ptr_array_index(guids, 0),
+						error);
+	return device_tmp != NULL;
+}
+
+static gboolean
+fu_benchmark_device_list_get_all_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	g_autoptr(GPtrArray) devices = fu_device_list_get_all(helper->device_list);
+	return devices->len > 0;
+}
+
+static gboolean
+fu_benchmark_startup(FuBenchmark *benchmark, GError **error)
+{
+	guint plugin_cnts[] = {0, 50, 500};
+	g_autofree gchar *tmpdir = NULL;
+	g_autoptr(FuBenchmarkHelper) helper = g_new0(FuBenchmarkHelper, 1);
+	g_autoptr(GPtrArray) devices = g_ptr_array_new();
+
+	tmpdir = fu_benchmark_mkroot(error);
+	if (tmpdir == NULL)
+		return FALSE;
+	helper->emulation_fn = g_build_filename(tmpdir, "emulation.gvariant", NULL);
+	if (!fu_emulation_backend_save(devices, helper->emulation_fn, error))
+		return FALSE;
+	for (guint i = 0; i < G_N_ELEMENTS(plugin_cnts); i++) {
+		g_autofree gchar *name = g_strdup_printf("startup:plugins=%u", plugin_cnts[i]);
+		helper->plugin_cnt = plugin_cnts[i];
+		if (!fu_benchmark_run(benchmark, name, 5, fu_benchmark_startup_cb, helper, error))
+			return FALSE;
+	}
+	return fu_common_rmtree(tmpdir, error);
+}
+
+static gboolean
+fu_benchmark_metadata_write(const gchar *filename, guint component_cnt, GError **error)
+{
+	g_autoptr(GString) str = g_string_new("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+
+	g_string_append(str, "<components origin=\"benchmark\">\n");
+	for (guint i = 0; i < component_cnt; i++) {
+		g_autofree gchar *instance_id = g_strdup_printf("BENCHMARK\\ID_%06u", i);
+		g_autofree gchar *guid = fwupd_guid_hash_string(instance_id);
+		g_string_append(str, "  <component type=\"firmware\">\n");
+		g_string_append_printf(str, "    <id>org.fwupd.benchmark%06u.firmware</id>\n", i);
+		g_string_append_printf(str, "    <name>Benchmark Device %u</name>\n", i);
+		g_string_append(str, "    <summary>Firmware for a synthetic device</summary>\n");
+		g_string_append(str, "    <provides>\n");
+		g_string_append_printf(str,
+				       "      <firmware type=\"flashed\">%s</firmware>\n",
+				       guid);
+		g_string_append(str, "    </provides>\n");
+		g_string_append(str, "    <releases>\n");
+		g_string_append(str, "      <release version=\"1.2.3\" ");
+		g_string_append(str, "timestamp=\"1640995200\">\n");
+		g_string_append_printf(str,
+				       "        <location>https://example.com/%s.cab</location>\n",
+				       guid);
+		g_string_append(str, "        <checksum type=\"sha1\" target=\"container\">");
+		g_string_append(str, "9a6e8c2e8f0d8b4c4d7a5e0e1b9f3c2a1d0e4f5a</checksum>\n");
+		g_string_append(str, "        <size type=\"installed\">1048576</size>\n");
+		g_string_append(str, "      </release>\n");
+		g_string_append(str, "    </releases>\n");
+		g_string_append(str, "  </component>\n");
+	}
+	g_string_append(str, "</components>\n");
+	return g_file_set_contents(filename, str->str, str->len, error);
+}
+
+static gboolean
+fu_benchmark_metadata(FuBenchmark *benchmark, GError **error)
+{
+	guint component_cnts[] = {1000, 10000, 50000};
+
+	for (guint i = 0; i < G_N_ELEMENTS(component_cnts); i++) {
+		g_autofree gchar *metadata_fn = NULL;
+		g_autofree gchar *name = NULL;
+		g_autofree gchar *remote_conf = NULL;
+		g_autofree gchar *remote_fn = NULL;
+		g_autofree gchar *tmpdir = NULL;
+
+		/* a local remote with synthetic components */
+		tmpdir = fu_benchmark_mkroot(error);
+		if (tmpdir == NULL)
+			return FALSE;
+		metadata_fn = g_build_filename(tmpdir, "benchmark.xml", NULL);
+		if (!fu_benchmark_metadata_write(metadata_fn, component_cnts[i], error))
+			return FALSE;
+		remote_fn = g_build_filename(tmpdir, "etc", "remotes.d", "benchmark.conf", NULL);
+		remote_conf = g_strdup_printf("[fwupd Remote]\n"
+					      "Enabled=true\n"
+					      "MetadataURI=file://%s\n",
+					      metadata_fn);
+		if (!g_file_set_contents(remote_fn, remote_conf, -1, error))
+			return FALSE;
+
+		name = g_strdup_printf("load-metadata:components=%u", component_cnts[i]);
+		if (!fu_benchmark_run(benchmark, name, 3, fu_benchmark_metadata_cb, NULL, error))
+			return FALSE;
+		if (!fu_common_rmtree(tmpdir, error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_device_list(FuBenchmark *benchmark, GError **error)
+{
+	g_autoptr(FuBenchmarkHelper) helper = g_new0(FuBenchmarkHelper, 1);
+
+	helper->devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	for (guint i = 0; i < FU_BENCHMARK_DEVICE_COUNT; i++) {
+		g_autofree gchar *id = g_strdup_printf("benchmark-%04u", i);
+		g_autofree gchar *instance_id = g_strdup_printf("BENCHMARK\\ID_%06u", i);
+		FuDevice *device = fu_device_new();
+		fu_device_set_id(device, id);
+		fu_device_set_plugin(device, "benchmark");
+		fu_device_add_instance_id(device, instance_id);
+		fu_device_convert_instance_ids(device);
+		g_ptr_array_add(helper->devices, device);
+	}
+	helper->device_list = fu_device_list_new();
+	for (guint i = 0; i < helper->devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(helper->devices, i);
+		fu_device_list_add(helper->device_list, device);
+	}
+
+	if (!fu_benchmark_run(benchmark,
+			      "device-list:add",
+			      10,
+			      fu_benchmark_device_list_add_cb,
+			      helper,
+			      error))
+		return FALSE;
+	if (!fu_benchmark_run(benchmark,
+			      "device-list:get-by-guid",
+			      1000,
+			      fu_benchmark_device_list_get_by_guid_cb,
+			      helper,
+			      error))
+		return FALSE;
+	return fu_benchmark_run(benchmark,
+				"device-list:get-all",
+				1000,
+				fu_benchmark_device_list_get_all_cb,
+				helper,
+				error);
+}
+
+static gboolean
+fu_benchmark_device_array_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	g_autoptr(GPtrArray) devices = fwupd_device_array_from_variant(helper->value);
+	return devices->len > 0;
+}
+
+static gboolean
+fu_benchmark_device_array_get_name_cb(gpointer user_data, GError **error)
+{
+	FuBenchmarkHelper *helper = (FuBenchmarkHelper *)user_data;
+	g_autoptr(GPtrArray) devices = fwupd_device_array_from_variant(helper->value);
+
+	/* what a client listing the devices would typically do */
+	for (guint i = 0; i < devices->len; i++) {
+		FwupdDevice *device = g_ptr_array_index(devices, i);
+		if (fwupd_device_get_name(device) == NULL) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INTERNAL,
+					    "no device name");
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_benchmark_device_array(FuBenchmark *benchmark, GError **error)
+{
+	GVariantBuilder builder;
+	g_autoptr(FuBenchmarkHelper) helper = g_new0(FuBenchmarkHelper, 1);
+	g_autoptr(GString) description = g_string_new(NULL);
+
+	/* release notes are the largest part of what GetDevices returns */
+	for (guint i = 0; i < 50; i++)
+		g_string_append(description, "<p>This release fixes a synthetic problem.</p>");
+
+	/* what the daemon sends to a client calling GetDevices */
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+	for (guint i = 0; i < FU_BENCHMARK_DEVICE_COUNT; i++) {
+		g_autofree gchar *id = g_strdup_printf("benchmark-%04u", i);
+		g_autofree gchar *name = g_strdup_printf("Benchmark Device %u", i);
+		g_autoptr(FwupdDevice) device = fwupd_device_new();
+		fwupd_device_set_id(device, id);
+		fwupd_device_set_name(device, name);
+		fwupd_device_set_plugin(device, "benchmark");
+		fwupd_device_set_version(device, "1.2.3");
+		for (guint j = 0; j < 5; j++) {
+			g_autofree gchar *version = g_strdup_printf("1.2.%u", j + 4);
+			g_autoptr(FwupdRelease) release = fwupd_release_new();
+			fwupd_release_set_version(release, version);
+			fwupd_release_set_description(release, description->str);
+			fwupd_device_add_release(device, release);
+		}
+		g_variant_builder_add_value(&builder, fwupd_device_to_variant(device));
+	}
+	helper->value = g_variant_ref_sink(g_variant_new("(aa{sv})", &builder));
+
+	if (!fu_benchmark_run(benchmark,
+			      "device-array:from-variant",
+			      20,
+			      fu_benchmark_device_array_cb,
+			      helper,
+			      error))
+		return FALSE;
+	return fu_benchmark_run(benchmark,
+				"device-array:get-name",
+				20,
+				fu_benchmark_device_array_get_name_cb,
+				helper,
+				error);
+}
+
+int
+main(int argc, char **argv)
+{
+	g_autoptr(FuBenchmark) benchmark = fu_benchmark_new("daemon");
+	g_autoptr(GError) error = NULL;
+
+	/* only critical and error are fatal */
+	g_log_set_fatal_mask(NULL, G_LOG_LEVEL_ERROR | G_LOG_LEVEL_CRITICAL);
+
+	if (!fu_benchmark_device_list(benchmark, &error) ||
+	    !fu_benchmark_device_array(benchmark, &error) ||
+	    !fu_benchmark_startup(benchmark, &error) ||
+	    !fu_benchmark_metadata(benchmark, &error) ||
+	    !fu_benchmark_save(benchmark, &error)) {
+		g_printerr("%s\n", error->message);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -14,6 +14,8 @@
 #include "fu-common.h"
 #include "fu-config.h"
 
+#define FU_CONFIG_HOST_SECURITY_TIMEOUT_DEFAULT 5000 /* ms */
+
 enum { SIGNAL_CHANGED, SIGNAL_LAST };
 
 static guint signals[SIGNAL_LAST] = {0};
@@ -32,12 +34,15 @@ struct _FuConfig {
 	GPtrArray *filenames;	      /* (element-type utf-8) */
 	guint64 archive_size_max;
 	guint idle_timeout;
+	guint host_security_timeout;
 	gchar *host_bkc;
 	gboolean update_motd;
 	gboolean enumerate_all_devices;
 	gboolean ignore_power;
 	gboolean only_trusted;
 	gboolean show_device_private;
+	gboolean prefetch_firmware;
+	gboolean report_io_stats;
 };
 
 G_DEFINE_TYPE(FuConfig, fu_config, G_TYPE_OBJECT)
@@ -63,6 +68,7 @@ fu_config_reload(FuConfig *self, GError **error)
 	g_autofree gchar *host_bkc = NULL;
 	g_autoptr(GKeyFile) keyfile = g_key_file_new();
 	g_autoptr(GError) error_update_motd = NULL;
+	g_autoptr(GError) error_host_security_timeout = NULL;
 	g_autoptr(GError) error_ignore_power = NULL;
 	g_autoptr(GError) error_only_trusted = NULL;
 	g_autoptr(GError) error_show_device_private = NULL;
@@ -187,6 +193,14 @@ fu_config_reload(FuConfig *self, GError **error)
 	if (idle_timeout > 0)
 		self->idle_timeout = idle_timeout;
 
+	/* get the time budget for each plugin to add HSI attributes */
+	self->host_security_timeout = g_key_file_get_uint64(keyfile,
+							    "fwupd",
+							    "HostSecurityTimeout",
+							    &error_host_security_timeout);
+	if (error_host_security_timeout != NULL)
+		self->host_security_timeout = FU_CONFIG_HOST_SECURITY_TIMEOUT_DEFAULT;
+
 	/* get the domains to run in verbose */
 	domains = g_key_file_get_string(keyfile, "fwupd", "VerboseDomains", NULL);
 	if (domains != NULL && domains[0] != '\0')
@@ -217,6 +231,13 @@ fu_config_reload(FuConfig *self, GError **error)
 		self->ignore_power = FALSE;
 	}
 
+	/* whether to prepare approved upgrades in the background */
+	self->prefetch_firmware =
+	    g_key_file_get_boolean(keyfile, "fwupd", "PrefetchFirmware", NULL);
+
+	/* whether to add device transfer counts to the report metadata */
+	self->report_io_stats = g_key_file_get_boolean(keyfile, "fwupd", "ReportIoStats", NULL);
+
 	/* whether to allow untrusted firmware *at all* even with PolicyKit auth */
 	self->only_trusted =
 	    g_key_file_get_boolean(keyfile, "fwupd", "OnlyTrusted", &error_only_trusted);
@@ -325,6 +346,21 @@ fu_config_get_idle_timeout(FuConfig *self)
 	return self->idle_timeout;
 }
 
+guint
+fu_config_get_host_security_timeout(FuConfig *self)
+{
+	g_return_val_if_fail(FU_IS_CONFIG(self), 0);
+	return self->host_security_timeout;
+}
+
+/* for the self tests, as this is not written back to the config file */
+void
+fu_config_set_host_security_timeout(FuConfig *self, guint host_security_timeout)
+{
+	g_return_if_fail(FU_IS_CONFIG(self));
+	self->host_security_timeout = host_security_timeout;
+}
+
 GPtrArray *
 fu_config_get_disabled_devices(FuConfig *self)
 {
@@ -391,6 +427,20 @@ fu_config_get_ignore_power(FuConfig *self)
 	return self->ignore_power;
 }
 
+gboolean
+fu_config_get_prefetch_firmware(FuConfig *self)
+{
+	g_return_val_if_fail(FU_IS_CONFIG(self), FALSE);
+	return self->prefetch_firmware;
+}
+
+gboolean
+fu_config_get_report_io_stats(FuConfig *self)
+{
+	g_return_val_if_fail(FU_IS_CONFIG(self), FALSE);
+	return self->report_io_stats;
+}
+
 gboolean
 fu_config_get_only_trusted(FuConfig *self)
 {
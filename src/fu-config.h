@@ -24,6 +24,10 @@ guint64
 fu_config_get_archive_size_max(FuConfig *self);
 guint
 fu_config_get_idle_timeout(FuConfig *self);
+guint
+fu_config_get_host_security_timeout(FuConfig *self);
+void
+fu_config_set_host_security_timeout(FuConfig *self, guint host_security_timeout);
 GPtrArray *
 fu_config_get_disabled_devices(FuConfig *self);
 GPtrArray *
@@ -41,6 +45,10 @@ fu_config_get_enumerate_all_devices(FuConfig *self);
 gboolean
 fu_config_get_ignore_power(FuConfig *self);
 gboolean
+fu_config_get_prefetch_firmware(FuConfig *self);
+gboolean
+fu_config_get_report_io_stats(FuConfig *self);
+gboolean
 fu_config_get_only_trusted(FuConfig *self);
 gboolean
 fu_config_get_show_device_private(FuConfig *self);
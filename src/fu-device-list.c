@@ -683,6 +683,9 @@ fu_device_list_replace(FuDeviceList *self, FuDeviceItem *item, FuDevice *device)
 	/* copy the update state if known */
 	fu_device_incorporate_update_state(item->device, device);
 
+	/* keep the transfer counts from before the replug */
+	fu_device_incorporate_io_stats(device, item->device);
+
 	/* assign the new device */
 	g_set_object(&item->device_old, item->device);
 	fu_device_list_item_set_device(item, device);
@@ -735,6 +738,7 @@ fu_device_list_add(FuDeviceList *self, FuDevice *device)
 			if (device != item->device) {
 				fu_device_uninhibit(item->device, "unconnected");
 				fu_device_incorporate_update_state(device, item->device);
+				fu_device_incorporate_io_stats(device, item->device);
 				fu_device_list_item_set_device(item, device);
 			}
 			fu_device_list_clear_wait_for_replug(self, item);
@@ -748,6 +752,7 @@ fu_device_list_add(FuDeviceList *self, FuDevice *device)
 			g_debug("found old device %s, swapping", fu_device_get_id(device));
 			fu_device_uninhibit(item->device, "unconnected");
 			fu_device_incorporate_update_state(device, item->device);
+			fu_device_incorporate_io_stats(device, item->device);
 			g_set_object(&item->device_old, item->device);
 			fu_device_list_item_set_device(item, device);
 			fu_device_list_clear_wait_for_replug(self, item);
@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define G_LOG_DOMAIN "FuBackend"
+
+#include "config.h"
+
+#include "fwupd-device-private.h"
+
+#include "fu-common.h"
+#include "fu-device-private.h"
+#include "fu-emulation-backend.h"
+#include "fu-udev-device.h"
+#include "fu-usb-device.h"
+
+struct _FuEmulationBackend {
+	FuBackend parent_instance;
+	gchar *filename;
+};
+
+G_DEFINE_TYPE(FuEmulationBackend, fu_emulation_backend, FU_TYPE_BACKEND)
+
+#define FU_EMULATION_BACKEND_MAGIC	   "fwupd-emulation-v1"
+#define FU_EMULATION_BACKEND_FORMAT	   "(sa(sssssa{sv}a(sxxaysis)))"
+#define FU_EMULATION_BACKEND_FORMAT_DEVICE "(sssssa{sv}a(sxxaysis))"
+
+/* only devices that are created by a backend can be emulated */
+static GType
+fu_emulation_backend_get_donor_gtype(GType gtype)
+{
+	if (g_type_is_a(gtype, FU_TYPE_USB_DEVICE))
+		return FU_TYPE_USB_DEVICE;
+	if (g_type_is_a(gtype, FU_TYPE_UDEV_DEVICE))
+		return FU_TYPE_UDEV_DEVICE;
+	return G_TYPE_INVALID;
+}
+
+static FuDevice *
+fu_emulation_backend_device_from_variant(FuEmulationBackend *self,
+					 GVariant *value,
+					 GError **error)
+{
+	const gchar *gtype_name = NULL;
+	const gchar *plugin = NULL;
+	const gchar *physical_id = NULL;
+	const gchar *logical_id = NULL;
+	const gchar *backend_id = NULL;
+	GType gtype;
+	GType donor_gtype;
+	GVariant *event_value;
+	g_autoptr(FuDevice) donor = NULL;
+	g_autoptr(FwupdDevice) device_tmp = NULL;
+	g_autoptr(GVariant) props = NULL;
+	g_autoptr(GVariantIter) iter = NULL;
+
+	g_variant_get(value,
+		      "(&s&s&s&s&s@a{sv}a(sxxaysis))",
+		      &gtype_name,
+		      &plugin,
+		      &physical_id,
+		      &logical_id,
+		      &backend_id,
+		      &props,
+		      &iter);
+
+	/* the plugin has to be loaded for the GType to be registered */
+	gtype = g_type_from_name(gtype_name);
+	if (gtype == G_TYPE_INVALID) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_FOUND,
+			    "no GType %s, is the %s plugin enabled?",
+			    gtype_name,
+			    plugin);
+		return NULL;
+	}
+	donor_gtype = fu_emulation_backend_get_donor_gtype(gtype);
+	if (donor_gtype == G_TYPE_INVALID) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "%s cannot be emulated",
+			    gtype_name);
+		return NULL;
+	}
+
+	/* create a donor of the same type the real backend would have added */
+	donor = g_object_new(donor_gtype,
+			     "context",
+			     fu_backend_get_context(FU_BACKEND(self)),
+			     NULL);
+	fu_device_set_specialized_gtype(donor, gtype);
+	fu_device_add_possible_plugin(donor, plugin);
+	if (physical_id[0] != '\0')
+		fu_device_set_physical_id(donor, physical_id);
+	if (logical_id[0] != '\0')
+		fu_device_set_logical_id(donor, logical_id);
+	if (backend_id[0] != '\0')
+		fu_device_set_backend_id(donor, backend_id);
+	fu_device_add_internal_flag(donor, FU_DEVICE_INTERNAL_FLAG_EMULATED);
+
+	/* everything that would have been found by ->probe() */
+	device_tmp = fwupd_device_from_variant(props);
+	if (device_tmp == NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "failed to parse properties for %s",
+			    gtype_name);
+		return NULL;
+	}
+	fwupd_device_incorporate(FWUPD_DEVICE(donor), device_tmp);
+
+	/* the recorded hardware interactions */
+	while ((event_value = g_variant_iter_next_value(iter))) {
+		g_autoptr(GVariant) event_value_tmp = event_value;
+		g_autoptr(FuDeviceEvent) event = NULL;
+		event = fu_device_event_from_variant(event_value_tmp, error);
+		if (event == NULL)
+			return NULL;
+		fu_device_add_event(donor, event);
+	}
+
+	/* success */
+	return g_steal_pointer(&donor);
+}
+
+static gboolean
+fu_emulation_backend_coldplug(FuBackend *backend, GError **error)
+{
+	FuEmulationBackend *self = FU_EMULATION_BACKEND(backend);
+	const gchar *magic = NULL;
+	GVariant *device_value;
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GVariant) value = NULL;
+	g_autoptr(GVariantIter) iter = NULL;
+
+	/* load file */
+	blob = fu_common_get_contents_bytes(self->filename, error);
+	if (blob == NULL)
+		return FALSE;
+	value = g_variant_new_from_bytes(G_VARIANT_TYPE(FU_EMULATION_BACKEND_FORMAT), blob, TRUE);
+	if (!g_variant_is_normal_form(value)) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "%s is not a valid emulation file",
+			    self->filename);
+		return FALSE;
+	}
+	g_variant_get(value, "(&sa" FU_EMULATION_BACKEND_FORMAT_DEVICE ")", &magic, &iter);
+	if (g_strcmp0(magic, FU_EMULATION_BACKEND_MAGIC) != 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "%s has invalid magic %s",
+			    self->filename,
+			    magic);
+		return FALSE;
+	}
+
+	/* add each device as if it had just been plugged in */
+	while ((device_value = g_variant_iter_next_value(iter))) {
+		g_autoptr(GVariant) device_value_tmp = device_value;
+		g_autoptr(FuDevice) device = NULL;
+		device = fu_emulation_backend_device_from_variant(self, device_value_tmp, error);
+		if (device == NULL)
+			return FALSE;
+		fu_backend_device_added(backend, device);
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static GVariant *
+fu_emulation_backend_device_to_variant(FuDevice *device)
+{
+	GPtrArray *events = fu_device_get_events(device);
+	const gchar *plugin = fu_device_get_plugin(device);
+	GVariantBuilder builder;
+	g_autoptr(GPtrArray) possible_plugins = fu_device_get_possible_plugins(device);
+
+	/* the plugin is not set on the donor, so fall back to the quirk */
+	if (plugin == NULL && possible_plugins->len > 0)
+		plugin = g_ptr_array_index(possible_plugins, 0);
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("a(sxxaysis)"));
+	for (guint i = 0; events != NULL && i < events->len; i++) {
+		FuDeviceEvent *event = g_ptr_array_index(events, i);
+		g_variant_builder_add_value(&builder, fu_device_event_to_variant(event));
+	}
+	return g_variant_new("(sssss@a{sv}a(sxxaysis))",
+			     G_OBJECT_TYPE_NAME(device),
+			     plugin != NULL ? plugin : "",
+			     fu_device_get_physical_id(device) != NULL
+				 ? fu_device_get_physical_id(device)
+				 : "",
+			     fu_device_get_logical_id(device) != NULL
+				 ? fu_device_get_logical_id(device)
+				 : "",
+			     fu_device_get_backend_id(device) != NULL
+				 ? fu_device_get_backend_id(device)
+				 : "",
+			     fwupd_device_to_variant_full(FWUPD_DEVICE(device),
+							  FWUPD_DEVICE_FLAG_TRUSTED),
+			     &builder);
+}
+
+/**
+ * fu_emulation_backend_save:
+ * @devices: (element-type FuDevice): devices
+ * @filename: a filename
+ * @error: (nullable): optional return location for an error
+ *
+ * Saves the properties and events of each device so they can be loaded by the emulation backend
+ * without the hardware being present.
+ *
+ * Only devices that were added by a USB or udev backend are saved; child devices are created
+ * again when the parent device is set up.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_emulation_backend_save(GPtrArray *devices, const gchar *filename, GError **error)
+{
+	GVariantBuilder builder;
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GVariant) value = NULL;
+
+	g_return_val_if_fail(devices != NULL, FALSE);
+	g_return_val_if_fail(filename != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("a" FU_EMULATION_BACKEND_FORMAT_DEVICE));
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		if (fu_device_get_parent(device) != NULL)
+			continue;
+		if (fu_emulation_backend_get_donor_gtype(G_OBJECT_TYPE(device)) == G_TYPE_INVALID) {
+			g_debug("not saving %s as it cannot be emulated",
+				G_OBJECT_TYPE_NAME(device));
+			continue;
+		}
+		g_variant_builder_add_value(&builder,
+					    fu_emulation_backend_device_to_variant(device));
+	}
+	value = g_variant_ref_sink(g_variant_new("(s@a" FU_EMULATION_BACKEND_FORMAT_DEVICE ")",
+						 FU_EMULATION_BACKEND_MAGIC,
+						 g_variant_builder_end(&builder)));
+	blob = g_variant_get_data_as_bytes(value);
+	return fu_common_set_contents_bytes(filename, blob, error);
+}
+
+static void
+fu_emulation_backend_finalize(GObject *object)
+{
+	FuEmulationBackend *self = FU_EMULATION_BACKEND(object);
+	g_free(self->filename);
+	G_OBJECT_CLASS(fu_emulation_backend_parent_class)->finalize(object);
+}
+
+static void
+fu_emulation_backend_init(FuEmulationBackend *self)
+{
+}
+
+static void
+fu_emulation_backend_class_init(FuEmulationBackendClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	FuBackendClass *klass_backend = FU_BACKEND_CLASS(klass);
+	object_class->finalize = fu_emulation_backend_finalize;
+	klass_backend->coldplug = fu_emulation_backend_coldplug;
+}
+
+FuBackend *
+fu_emulation_backend_new(const gchar *filename)
+{
+	FuEmulationBackend *self =
+	    g_object_new(FU_TYPE_EMULATION_BACKEND, "name", "emulation", NULL);
+	self->filename = g_strdup(filename);
+	return FU_BACKEND(self);
+}
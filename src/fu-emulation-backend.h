@@ -0,0 +1,19 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include "fu-backend.h"
+
+#define FU_TYPE_EMULATION_BACKEND (fu_emulation_backend_get_type())
+G_DECLARE_FINAL_TYPE(FuEmulationBackend, fu_emulation_backend, FU, EMULATION_BACKEND, FuBackend)
+
+FuBackend *
+fu_emulation_backend_new(const gchar *filename);
+gboolean
+fu_emulation_backend_save(GPtrArray *devices,
+			  const gchar *filename,
+			  GError **error) G_GNUC_WARN_UNUSED_RESULT;
@@ -49,6 +49,7 @@
 #include "fu-efi-firmware-filesystem.h"
 #include "fu-efi-firmware-section.h"
 #include "fu-efi-firmware-volume.h"
+#include "fu-emulation-backend.h"
 #include "fu-engine-helper.h"
 #include "fu-engine-request.h"
 #include "fu-engine.h"
@@ -69,6 +70,7 @@
 #include "fu-remote-list.h"
 #include "fu-security-attr.h"
 #include "fu-security-attrs-private.h"
+#include "fu-trace-private.h"
 #include "fu-udev-device-private.h"
 #include "fu-uswid-firmware.h"
 #include "fu-version.h"
@@ -88,6 +90,7 @@
 #include "fu-dfuse-firmware.h"
 #include "fu-fmap-firmware.h"
 #include "fu-ihex-firmware.h"
+#include "fu-sfdp-firmware.h"
 #include "fu-srec-firmware.h"
 
 /* only needed until we hard depend on jcat 0.1.3 */
@@ -99,10 +102,20 @@
 
 #define MINIMUM_BATTERY_PERCENTAGE_FALLBACK 10
 
+/* seconds between preparing the firmware for each device while idle */
+#define FU_ENGINE_PREFETCH_INTERVAL 5
+
+/* the maximum total size of the cabinets kept prepared in memory */
+#define FU_ENGINE_PREFETCH_SIZE_MAX (256 * 1024 * 1024)
+
 static void
 fu_engine_finalize(GObject *obj);
 static void
 fu_engine_ensure_security_attrs(FuEngine *self);
+static void
+fu_engine_prefetch_schedule(FuEngine *self);
+static void
+fu_engine_set_subsystem_ready(FuEngine *self, FuEngineSubsystem subsystem);
 
 struct _FuEngine {
 	GObject parent_instance;
@@ -118,6 +131,7 @@ struct _FuEngine {
 	guint percentage;
 	FuHistory *history;
 	FuIdle *idle;
+	FuStatistics *statistics;
 	XbSilo *silo;
 	XbQuery *query_component_by_guid;
 	guint coldplug_id;
@@ -133,9 +147,29 @@ struct _FuEngine {
 	gboolean loaded;
 	gchar *host_security_id;
 	FuSecurityAttrs *host_security_attrs;
+	GHashTable *host_security_attrs_plugin;  /* (element-type utf8 FuSecurityAttrs) */
+	GHashTable *host_security_attrs_stale;   /* (element-type utf8 FuSecurityAttrs) */
+	GHashTable *host_security_attrs_running; /* (element-type utf8 helper) */
+	GHashTable *host_security_timings;       /* (element-type utf8 guint) */
+	GHashTable *host_security_disabled;      /* (element-type utf8): plugin names */
 	GPtrArray *local_monitors; /* (element-type GFileMonitor) */
+	FuEngineSubsystem subsystems_ready;
+	guint deferred_id;
+	guint deferred_idx;
+	guint prefetch_id;
+	GPtrArray *prefetch_queue;  /* (element-type utf8): device IDs */
+	GHashTable *prefetch_items; /* (element-type utf8 FuEnginePrefetchItem): by SHA-256 */
+	gsize prefetch_size;
+	guint prefetch_generation;
+	gboolean prefetch_running;
+	JcatContext *prefetch_jcat_context;
 };
 
+typedef struct {
+	XbSilo *silo;
+	gsize size;
+} FuEnginePrefetchItem;
+
 enum {
 	SIGNAL_CHANGED,
 	SIGNAL_DEVICE_ADDED,
@@ -143,6 +177,7 @@ enum {
 	SIGNAL_DEVICE_CHANGED,
 	SIGNAL_DEVICE_REQUEST,
 	SIGNAL_STATUS_CHANGED,
+	SIGNAL_SUBSYSTEMS_CHANGED,
 	SIGNAL_LAST
 };
 
@@ -164,11 +199,188 @@ fu_engine_emit_changed(FuEngine *self)
 	}
 }
 
+typedef enum {
+	FU_ENGINE_SECURITY_ATTRS_STATE_RUNNING,
+	FU_ENGINE_SECURITY_ATTRS_STATE_DONE,
+	FU_ENGINE_SECURITY_ATTRS_STATE_ABANDONED,
+	FU_ENGINE_SECURITY_ATTRS_STATE_LATE,
+} FuEngineSecurityAttrsState;
+
+typedef struct {
+	gint refcount; /* atomic */
+	gint state;    /* atomic, a FuEngineSecurityAttrsState */
+	GWeakRef engine;
+	gchar *name;
+	FuPlugin *plugin;   /* (nullable) */
+	GPtrArray *devices; /* (element-type FuDevice) */
+	FuSecurityAttrs *attrs;
+	GCancellable *cancellable;
+	GAsyncQueue *queue;
+	gint64 deadline; /* us, or 0 for never */
+	gint64 duration; /* us */
+} FuEngineSecurityAttrsHelper;
+
+static void
+fu_engine_security_attrs_helper_unref(FuEngineSecurityAttrsHelper *helper)
+{
+	if (!g_atomic_int_dec_and_test(&helper->refcount))
+		return;
+	if (helper->plugin != NULL)
+		g_object_unref(helper->plugin);
+	g_weak_ref_clear(&helper->engine);
+	g_free(helper->name);
+	g_ptr_array_unref(helper->devices);
+	g_object_unref(helper->attrs);
+	g_object_unref(helper->cancellable);
+	g_async_queue_unref(helper->queue);
+	g_free(helper);
+}
+
+/* results from a plugin that is still running after the time budget will not be used */
+static void
+fu_engine_security_attrs_cancel(FuEngine *self, const gchar *plugin_name)
+{
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+
+	g_hash_table_iter_init(&iter, self->host_security_attrs_running);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		FuEngineSecurityAttrsHelper *helper = (FuEngineSecurityAttrsHelper *)value;
+		if (plugin_name == NULL || g_strcmp0(key, plugin_name) == 0)
+			g_cancellable_cancel(helper->cancellable);
+	}
+}
+
+/* the old attributes are kept in case the plugin does not respond in time */
+static void
+fu_engine_invalidate_security_attrs_plugin(FuEngine *self, const gchar *plugin_name)
+{
+	FuSecurityAttrs *attrs = g_hash_table_lookup(self->host_security_attrs_plugin, plugin_name);
+
+	/* results still being collected are now out of date */
+	fu_engine_security_attrs_cancel(self, plugin_name);
+	if (attrs == NULL)
+		return;
+	g_hash_table_insert(self->host_security_attrs_stale,
+			    g_strdup(plugin_name),
+			    g_object_ref(attrs));
+	g_hash_table_remove(self->host_security_attrs_plugin, plugin_name);
+}
+
+/* if @plugin_name is NULL then all the attributes are refreshed */
+static void
+fu_engine_invalidate_security_attrs(FuEngine *self, const gchar *plugin_name)
+{
+	if (plugin_name == NULL) {
+		g_autoptr(GList) names = g_hash_table_get_keys(self->host_security_attrs_plugin);
+		for (GList *l = names; l != NULL; l = l->next) {
+			g_autofree gchar *name = g_strdup(l->data);
+			fu_engine_invalidate_security_attrs_plugin(self, name);
+		}
+		fu_engine_security_attrs_cancel(self, NULL);
+	} else {
+		fu_engine_invalidate_security_attrs_plugin(self, plugin_name);
+	}
+	g_clear_pointer(&self->host_security_id, g_free);
+}
+
+static gboolean
+fu_engine_security_attrs_has_guids(FuSecurityAttrs *attrs, GPtrArray *guids)
+{
+	g_autoptr(GPtrArray) items = fu_security_attrs_get_all(attrs);
+	for (guint i = 0; i < items->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(items, i);
+		for (guint j = 0; j < guids->len; j++) {
+			const gchar *guid = g_ptr_array_index(guids, j);
+			if (fwupd_security_attr_has_guid(attr, guid))
+				return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static void
+fu_engine_invalidate_security_attrs_for_device(FuEngine *self, FuDevice *device)
+{
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	GPtrArray *guids = fu_device_get_guids(device);
+
+	/* the plugin that created the device */
+	fu_engine_invalidate_security_attrs(self, fu_device_get_plugin(device));
+
+	/* other plugins that referenced the device, e.g. msr using the cpu device */
+	g_hash_table_iter_init(&iter, self->host_security_attrs_plugin);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		if (!fu_engine_security_attrs_has_guids(FU_SECURITY_ATTRS(value), guids))
+			continue;
+		g_hash_table_insert(self->host_security_attrs_stale,
+				    g_strdup(key),
+				    g_object_ref(value));
+		g_hash_table_iter_remove(&iter);
+	}
+}
+
+#ifdef HAVE_HSI
+/* drops cached attributes for plugins that have gone away, and invalidates plugins that have
+ * been disabled or enabled since they were last asked; returns %TRUE if anything changed */
+static gboolean
+fu_engine_security_attrs_prune(FuEngine *self)
+{
+	GPtrArray *plugins = fu_plugin_list_get_all(self->plugin_list);
+	GHashTable *tables[] = {self->host_security_attrs_plugin,
+				self->host_security_attrs_stale,
+				self->host_security_timings,
+				self->host_security_disabled};
+	gboolean changed = FALSE;
+	g_autoptr(GHashTable) names = g_hash_table_new(g_str_hash, g_str_equal);
+	g_autoptr(GPtrArray) devices = fu_device_list_get_all(self->device_list);
+
+	for (guint i = 0; i < plugins->len; i++) {
+		FuPlugin *plugin = g_ptr_array_index(plugins, i);
+		const gchar *name = fu_plugin_get_name(plugin);
+		gboolean disabled = fu_plugin_has_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
+
+		g_hash_table_add(names, (gpointer)name);
+		if (disabled == g_hash_table_contains(self->host_security_disabled, name))
+			continue;
+		if (disabled)
+			g_hash_table_add(self->host_security_disabled, g_strdup(name));
+		else
+			g_hash_table_remove(self->host_security_disabled, name);
+		if (g_hash_table_contains(self->host_security_attrs_plugin, name)) {
+			fu_engine_invalidate_security_attrs_plugin(self, name);
+			changed = TRUE;
+		}
+	}
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		const gchar *name = fu_device_get_plugin(device);
+		g_hash_table_add(names, (gpointer)(name != NULL ? name : ""));
+	}
+	for (guint i = 0; i < G_N_ELEMENTS(tables); i++) {
+		GHashTableIter iter;
+		gpointer key;
+		g_hash_table_iter_init(&iter, tables[i]);
+		while (g_hash_table_iter_next(&iter, &key, NULL)) {
+			if (g_hash_table_contains(names, key))
+				continue;
+			if (tables[i] == self->host_security_attrs_plugin)
+				changed = TRUE;
+			g_hash_table_iter_remove(&iter);
+		}
+	}
+	return changed;
+}
+#endif
+
 static void
 fu_engine_emit_device_changed_safe(FuEngine *self, FuDevice *device)
 {
 	/* invalidate host security attributes */
-	g_clear_pointer(&self->host_security_id, g_free);
+	fu_engine_invalidate_security_attrs_for_device(self, device);
 	g_signal_emit(self, signals[SIGNAL_DEVICE_CHANGED], 0, device);
 }
 
@@ -194,6 +406,12 @@ fu_engine_get_context(FuEngine *self)
 	return self->ctx;
 }
 
+FuStatistics *
+fu_engine_get_statistics(FuEngine *self)
+{
+	return self->statistics;
+}
+
 /**
  * fu_engine_get_status:
  * @self: a #FuEngine
@@ -414,6 +632,7 @@ fu_engine_add_local_release_metadata(FuEngine *self, FuRelease *release, GError
 #endif
 
 		/* bind GUID and then query */
+		FU_TRACE1(engine_query_entry, "release-tags");
 #if LIBXMLB_CHECK_VERSION(0, 3, 0)
 		xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
 		xb_value_bindings_bind_str(xb_query_context_get_bindings(&context),
@@ -432,6 +651,7 @@ fu_engine_add_local_release_metadata(FuEngine *self, FuRelease *release, GError
 		}
 		tags = xb_silo_query_full(self->silo, query, &error_local);
 #endif
+		FU_TRACE2(engine_query_exit, "release-tags", tags != NULL ? tags->len : 0);
 		if (tags == NULL) {
 			if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) ||
 			    g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
@@ -509,7 +729,9 @@ fu_engine_get_remote_id_for_checksum(FuEngine *self, const gchar *csum)
 				"checksum[@target='container'][text()='%s']/../../"
 				"../../custom/value[@key='fwupd::RemoteId']",
 				csum);
+	FU_TRACE1(engine_query_entry, "remote-id-for-checksum");
 	key = xb_silo_query_first(self->silo, xpath, NULL);
+	FU_TRACE2(engine_query_exit, "remote-id-for-checksum", key != NULL);
 	if (key == NULL)
 		return NULL;
 	return xb_node_get_text(key);
@@ -566,9 +788,12 @@ fu_engine_modify_config(FuEngine *self, const gchar *key, const gchar *value, GE
 			       "DisabledPlugins",
 			       "EnumerateAllDevices",
 			       "HostBkc",
+			       "HostSecurityTimeout",
 			       "IdleTimeout",
 			       "IgnorePower",
 			       "OnlyTrusted",
+			       "PrefetchFirmware",
+			       "ReportIoStats",
 			       "UpdateMotd",
 			       "UriSchemes",
 			       "VerboseDomains",
@@ -821,6 +1046,7 @@ fu_engine_get_component_by_guid(FuEngine *self, const gchar *guid)
 	if (self->query_component_by_guid == NULL)
 		return NULL;
 
+	FU_TRACE1(engine_query_entry, "component-by-guid");
 #if LIBXMLB_CHECK_VERSION(0, 3, 0)
 	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
 	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
@@ -836,6 +1062,7 @@ fu_engine_get_component_by_guid(FuEngine *self, const gchar *guid)
 	component =
 	    xb_silo_query_first_full(self->silo, self->query_component_by_guid, &error_local);
 #endif
+	FU_TRACE2(engine_query_exit, "component-by-guid", component != NULL);
 	if (component == NULL) {
 		if (!g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) &&
 		    !g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
@@ -926,6 +1153,7 @@ fu_engine_verify_from_system_metadata(FuEngine *self, FuDevice *device, GError *
 #endif
 
 		/* bind GUID and then query */
+		FU_TRACE1(engine_query_entry, "verify-releases");
 #if LIBXMLB_CHECK_VERSION(0, 3, 0)
 		xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
 		releases = xb_silo_query_with_context(self->silo, query, &context, &error_local);
@@ -936,6 +1164,9 @@ fu_engine_verify_from_system_metadata(FuEngine *self, FuDevice *device, GError *
 		}
 		releases = xb_silo_query_full(self->silo, query, &error_local);
 #endif
+		FU_TRACE2(engine_query_exit,
+			  "verify-releases",
+			  releases != NULL ? releases->len : 0);
 		if (releases == NULL) {
 			if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) ||
 			    g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
@@ -1820,6 +2051,7 @@ fu_engine_get_report_metadata(FuEngine *self, GError **error)
 	g_autoptr(GHashTable) hash = NULL;
 	g_autoptr(GList) compile_keys = g_hash_table_get_keys(self->compile_versions);
 	g_autoptr(GList) runtime_keys = g_hash_table_get_keys(self->runtime_versions);
+	g_autoptr(GList) timing_keys = g_hash_table_get_keys(self->host_security_timings);
 
 	/* convert all the runtime and compile-time versions */
 	hash = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
@@ -1837,6 +2069,16 @@ fu_engine_get_report_metadata(FuEngine *self, GError **error)
 				    g_strdup_printf("RuntimeVersion(%s)", id),
 				    g_strdup(version));
 	}
+
+	/* how long each plugin took to add the HSI attributes, in ms */
+	for (GList *l = timing_keys; l != NULL; l = l->next) {
+		const gchar *id = l->data;
+		guint ms = GPOINTER_TO_UINT(g_hash_table_lookup(self->host_security_timings, id));
+		g_hash_table_insert(hash,
+				    g_strdup_printf("HostSecurityDuration(%s)", id),
+				    g_strdup_printf("%u", ms));
+	}
+
 	if (!fu_engine_get_report_metadata_os_release(hash, error))
 		return NULL;
 	if (!fu_engine_get_report_metadata_kernel_cmdline(hash, error))
@@ -2049,6 +2291,35 @@ fu_engine_install_releases(FuEngine *self,
 	return TRUE;
 }
 
+/* for online updates, as the post-reboot metadata is added in fu_engine_update_history_device() */
+static gboolean
+fu_engine_add_history_metadata_post(FuEngine *self, FuDevice *device, GError **error)
+{
+	FwupdRelease *rel_history;
+	g_autoptr(FuDevice) dev_history = NULL;
+	g_autoptr(GHashTable) metadata_device = NULL;
+
+	metadata_device = fu_device_report_metadata_post(device);
+	if (metadata_device == NULL || g_hash_table_size(metadata_device) == 0)
+		return TRUE;
+	dev_history = fu_history_get_device_by_id(self->history, fu_device_get_id(device), error);
+	if (dev_history == NULL)
+		return FALSE;
+	rel_history = fu_device_get_release_default(dev_history);
+	if (rel_history == NULL) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "no release for history FuDevice");
+		return FALSE;
+	}
+	fwupd_release_add_metadata(rel_history, metadata_device);
+	return fu_history_set_device_metadata(self->history,
+					      fu_device_get_id(dev_history),
+					      fwupd_release_get_metadata(rel_history),
+					      error);
+}
+
 static gboolean
 fu_engine_add_release_metadata(FuEngine *self, FuRelease *release, FuPlugin *plugin, GError **error)
 {
@@ -2310,6 +2581,10 @@ fu_engine_install_release(FuEngine *self,
 	g_return_val_if_fail(blob_cab != NULL, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
+	/* the history database has to be up to date */
+	if (!fu_engine_ensure_subsystem(self, FU_ENGINE_SUBSYSTEM_HISTORY, error))
+		return FALSE;
+
 	/* optional for tests */
 	if (request != NULL)
 		feature_flags = fu_engine_request_get_feature_flags(request);
@@ -2438,6 +2713,13 @@ fu_engine_install_release(FuEngine *self,
 		fu_device_set_update_error(device, str);
 	}
 
+	/* save any additional report metadata, e.g. the transfer counts */
+	if ((flags & FWUPD_INSTALL_FLAG_NO_HISTORY) == 0) {
+		g_autoptr(GError) error_metadata = NULL;
+		if (!fu_engine_add_history_metadata_post(self, device, &error_metadata))
+			g_warning("failed to set metadata: %s", error_metadata->message);
+	}
+
 	/* mark success unless needs a reboot */
 	if (fu_device_get_update_state(device) != FWUPD_UPDATE_STATE_NEEDS_REBOOT)
 		fu_device_set_update_state(device, FWUPD_UPDATE_STATE_SUCCESS);
@@ -2856,6 +3138,11 @@ fu_engine_write_firmware(FuEngine *self,
 		}
 		return FALSE;
 	}
+	fu_statistics_add_counter(self->statistics,
+				  "fwupd_device_write_bytes",
+				  "device",
+				  device_id,
+				  g_bytes_get_size(blob_fw));
 
 	/* cleanup */
 	if (device_pending != NULL) {
@@ -2896,6 +3183,7 @@ fu_engine_firmware_dump(FuEngine *self,
 			GError **error)
 {
 	g_autoptr(FuDeviceLocker) locker = NULL;
+	g_autoptr(GBytes) fw = NULL;
 
 	/* open, read, close */
 	locker = fu_device_locker_new(device, error);
@@ -2903,20 +3191,41 @@ fu_engine_firmware_dump(FuEngine *self,
 		g_prefix_error(error, "failed to open device for firmware read: ");
 		return NULL;
 	}
-	return fu_device_dump_firmware(device, progress, error);
+	fw = fu_device_dump_firmware(device, progress, error);
+	if (fw == NULL)
+		return NULL;
+	fu_statistics_add_counter(self->statistics,
+				  "fwupd_device_read_bytes",
+				  "device",
+				  fu_device_get_id(device),
+				  g_bytes_get_size(fw));
+	return g_steal_pointer(&fw);
 }
 
-gboolean
-fu_engine_install_blob(FuEngine *self,
-		       FuDevice *device,
-		       GBytes *blob_fw,
-		       FuProgress *progress,
-		       FwupdInstallFlags flags,
-		       FwupdFeatureFlags feature_flags,
-		       GError **error)
+/* use the step durations from the last time a device of the same type was updated */
+static void
+fu_engine_load_progress_profile(FuEngine *self, FuDevice *device, FuProgress *progress)
+{
+	g_autoptr(GError) error_local = NULL;
+	if (!fu_history_load_progress_profile(self->history, device, progress, &error_local)) {
+		g_debug("not using progress profile: %s", error_local->message);
+		return;
+	}
+	fu_progress_remove_flag(progress, FU_PROGRESS_FLAG_GUESSED);
+}
+
+static gboolean
+fu_engine_install_blob_internal(FuEngine *self,
+				FuDevice *device,
+				GBytes *blob_fw,
+				FuProgress *progress,
+				FwupdInstallFlags flags,
+				FwupdFeatureFlags feature_flags,
+				GError **error)
 {
 	guint retries = 0;
 	g_autofree gchar *device_id = NULL;
+	g_autoptr(GError) error_local = NULL;
 	g_autoptr(GTimer) timer = g_timer_new();
 
 	/* test the firmware is not an empty blob */
@@ -2961,6 +3270,7 @@ fu_engine_install_blob(FuEngine *self,
 			fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_RESTART, 2); /* attach */
 			fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_BUSY, 2);	/* reload */
 		}
+		fu_engine_load_progress_profile(self, device, progress);
 
 		/* detach to bootloader mode */
 		if (!fu_engine_detach(self,
@@ -3009,6 +3319,10 @@ fu_engine_install_blob(FuEngine *self,
 	if (!fu_engine_cleanup(self, flags, device_id, error))
 		return FALSE;
 
+	/* save the step durations for next time */
+	if (!fu_history_add_progress_profile(self->history, device, progress, &error_local))
+		g_debug("failed to record progress profile: %s", error_local->message);
+
 	/* make the UI update */
 	fu_engine_emit_device_changed(self, device_id);
 	g_debug("Updating %s took %f seconds",
@@ -3017,6 +3331,57 @@ fu_engine_install_blob(FuEngine *self,
 	return TRUE;
 }
 
+static const gchar *
+fu_engine_error_to_reason(const GError *error)
+{
+	if (error->domain == FWUPD_ERROR)
+		return fwupd_error_to_string(error->code);
+	return g_quark_to_string(error->domain);
+}
+
+gboolean
+fu_engine_install_blob(FuEngine *self,
+		       FuDevice *device,
+		       GBytes *blob_fw,
+		       FuProgress *progress,
+		       FwupdInstallFlags flags,
+		       FwupdFeatureFlags feature_flags,
+		       GError **error)
+{
+	gint64 start = g_get_monotonic_time();
+	g_autofree gchar *plugin_name = g_strdup(fu_device_get_plugin(device));
+	g_autoptr(FuDevice) device_list = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	/* only report the transfers and retries done by this update */
+	fu_device_clear_io_stats(device);
+	device_list = fu_device_list_get_by_id(self->device_list, fu_device_get_id(device), NULL);
+	if (device_list != NULL && device_list != device)
+		fu_device_clear_io_stats(device_list);
+
+	if (!fu_engine_install_blob_internal(self,
+					     device,
+					     blob_fw,
+					     progress,
+					     flags,
+					     feature_flags,
+					     &error_local)) {
+		fu_statistics_add_counter(self->statistics,
+					  "fwupd_update_failures",
+					  "reason",
+					  fu_engine_error_to_reason(error_local),
+					  1);
+		g_propagate_error(error, g_steal_pointer(&error_local));
+		return FALSE;
+	}
+	fu_statistics_add_duration(self->statistics,
+				   "fwupd_update_duration_microseconds",
+				   "plugin",
+				   plugin_name,
+				   g_get_monotonic_time() - start);
+	return TRUE;
+}
+
 static FuDevice *
 fu_engine_get_item_by_id_fallback_history(FuEngine *self, const gchar *id, GError **error)
 {
@@ -3130,6 +3495,14 @@ fu_engine_set_silo(FuEngine *self, XbSilo *silo)
 		g_warning("failed to create indexes: %s", error_local->message);
 }
 
+/* for the self tests */
+void
+fu_engine_set_host_security_timeout(FuEngine *self, guint host_security_timeout)
+{
+	g_return_if_fail(FU_IS_ENGINE(self));
+	fu_config_set_host_security_timeout(self->config, host_security_timeout);
+}
+
 static gboolean
 fu_engine_appstream_upgrade_cb(XbBuilderFixup *self,
 			       XbBuilderNode *bn,
@@ -3541,6 +3914,7 @@ static gboolean
 fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **error)
 {
 	GPtrArray *remotes;
+	gint64 start = g_get_monotonic_time();
 	XbBuilderCompileFlags compile_flags = XB_BUILDER_COMPILE_FLAG_IGNORE_INVALID;
 	g_autoptr(GFile) xmlb = NULL;
 	g_autoptr(XbBuilder) builder = xb_builder_new();
@@ -3653,15 +4027,40 @@ fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **
 		g_prefix_error(error, "cannot create metadata.xmlb: ");
 		return FALSE;
 	}
+	if (!fu_engine_create_silo_index(self, error))
+		return FALSE;
 
 	/* success */
-	return fu_engine_create_silo_index(self, error);
+	fu_statistics_add_duration(self->statistics,
+				   "fwupd_metadata_load_duration_microseconds",
+				   NULL,
+				   NULL,
+				   g_get_monotonic_time() - start);
+	fu_statistics_set_gauge(self->statistics,
+				"fwupd_metadata_silo_bytes",
+				NULL,
+				NULL,
+				xb_silo_get_size(self->silo));
+	return TRUE;
+}
+
+static void
+fu_engine_ensure_context_flags(FuEngine *self)
+{
+	if (fu_config_get_report_io_stats(self->config))
+		fu_context_add_flag(self->ctx, FU_CONTEXT_FLAG_REPORT_IO_STATS);
+	else
+		fu_context_remove_flag(self->ctx, FU_CONTEXT_FLAG_REPORT_IO_STATS);
 }
 
 static void
 fu_engine_config_changed_cb(FuConfig *config, FuEngine *self)
 {
 	fu_idle_set_timeout(self->idle, fu_config_get_idle_timeout(config));
+	fu_engine_ensure_context_flags(self);
+
+	/* the limits or the approved firmware may have changed */
+	fu_engine_prefetch_schedule(self);
 }
 
 static void
@@ -3675,7 +4074,10 @@ fu_engine_metadata_changed(FuEngine *self)
 	fu_engine_md_refresh_devices(self);
 
 	/* invalidate host security attributes */
-	g_clear_pointer(&self->host_security_id, g_free);
+	fu_engine_invalidate_security_attrs(self, NULL);
+
+	/* the remotes or the keyrings may have changed */
+	fu_engine_prefetch_schedule(self);
 
 	/* make the UI update */
 	fu_engine_emit_changed(self);
@@ -3922,10 +4324,13 @@ fu_engine_update_metadata_bytes(FuEngine *self,
 	fu_engine_md_refresh_devices(self);
 
 	/* invalidate host security attributes */
-	g_clear_pointer(&self->host_security_id, g_free);
+	fu_engine_invalidate_security_attrs(self, NULL);
 
 	/* make the UI update */
 	fu_engine_emit_changed(self);
+
+	/* get the new upgrades ready while nothing else is happening */
+	fu_engine_prefetch_schedule(self);
 	return TRUE;
 }
 
@@ -3987,6 +4392,22 @@ fu_engine_update_metadata(FuEngine *self,
 #endif
 }
 
+/* does not use the engine, so that it can be called from a thread */
+static XbSilo *
+fu_engine_parse_cabinet_full(GBytes *blob_cab,
+			     JcatContext *jcat_context,
+			     guint64 size_max,
+			     GError **error)
+{
+	g_autoptr(FuCabinet) cabinet = fu_cabinet_new();
+
+	fu_cabinet_set_size_max(cabinet, size_max);
+	fu_cabinet_set_jcat_context(cabinet, jcat_context);
+	if (!fu_cabinet_parse(cabinet, blob_cab, FU_CABINET_PARSE_FLAG_NONE, error))
+		return NULL;
+	return fu_cabinet_get_silo(cabinet);
+}
+
 /**
  * fu_engine_get_silo_from_blob:
  * @self: a #FuEngine
@@ -4000,80 +4421,448 @@ fu_engine_update_metadata(FuEngine *self,
 XbSilo *
 fu_engine_get_silo_from_blob(FuEngine *self, GBytes *blob_cab, GError **error)
 {
-	g_autoptr(FuCabinet) cabinet = fu_cabinet_new();
-
 	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
 	g_return_val_if_fail(blob_cab != NULL, NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
 
+	/* already verified and parsed while idle */
+	if (g_hash_table_size(self->prefetch_items) > 0) {
+		FuEnginePrefetchItem *item;
+		g_autofree gchar *csum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, blob_cab);
+
+		item = g_hash_table_lookup(self->prefetch_items, csum);
+		if (item != NULL) {
+			g_autoptr(XbSilo) silo = g_object_ref(item->silo);
+			g_debug("using prefetched cabinet %s", csum);
+			self->prefetch_size -= item->size;
+			g_hash_table_remove(self->prefetch_items, csum);
+			return g_steal_pointer(&silo);
+		}
+	}
+
 	/* load file */
 	fu_engine_set_status(self, FWUPD_STATUS_DECOMPRESSING);
-	fu_cabinet_set_size_max(cabinet, fu_engine_get_archive_size_max(self));
-	fu_cabinet_set_jcat_context(cabinet, self->jcat_context);
-	if (!fu_cabinet_parse(cabinet, blob_cab, FU_CABINET_PARSE_FLAG_NONE, error))
-		return NULL;
-	return fu_cabinet_get_silo(cabinet);
+	return fu_engine_parse_cabinet_full(blob_cab,
+					    self->jcat_context,
+					    fu_engine_get_archive_size_max(self),
+					    error);
 }
 
-static FuDevice *
-fu_engine_get_result_from_component(FuEngine *self,
-				    FuEngineRequest *request,
-				    XbNode *component,
-				    GError **error)
+static void
+fu_engine_prefetch_item_free(FuEnginePrefetchItem *item)
 {
-	FwupdReleaseFlags release_flags = FWUPD_RELEASE_FLAG_NONE;
-	g_autofree gchar *description_xpath = NULL;
-	g_autoptr(FuDevice) dev = NULL;
-	g_autoptr(FuRelease) release = NULL;
-	g_autoptr(GError) error_local = NULL;
-	g_autoptr(GError) error_reqs = NULL;
-	g_autoptr(GPtrArray) provides = NULL;
-	g_autoptr(GPtrArray) tags = NULL;
-	g_autoptr(XbNode) description = NULL;
-	g_autoptr(XbNode) rel = NULL;
-#if LIBXMLB_CHECK_VERSION(0, 2, 0)
-	g_autoptr(XbQuery) query = NULL;
-#endif
+	g_object_unref(item->silo);
+	g_free(item);
+}
 
-	dev = fu_device_new_with_context(self->ctx);
-	provides = xb_node_query(component, "provides/firmware[@type=$'flashed']", 0, &error_local);
-	if (provides == NULL) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_INTERNAL,
-			    "failed to get release: %s",
-			    error_local->message);
-		return NULL;
-	}
-	for (guint i = 0; i < provides->len; i++) {
-		XbNode *prov = XB_NODE(g_ptr_array_index(provides, i));
-		const gchar *guid;
-		g_autoptr(FuDevice) device = NULL;
+typedef struct {
+	gchar *device_id;
+	gchar *filename;
+	GPtrArray *checksums; /* (element-type utf8) */
+	JcatContext *jcat_context;
+	guint64 archive_size_max;
+	guint generation;
+	gchar *csum;	/* out: SHA-256 of the cabinet */
+	XbSilo *silo;	/* out */
+} FuEnginePrefetchHelper;
 
-		/* is a online or offline update appropriate */
-		guid = xb_node_get_text(prov);
-		if (guid == NULL)
-			continue;
-		device = fu_device_list_get_by_guid(self->device_list, guid, NULL);
-		if (device != NULL) {
-			fu_device_set_name(dev, fu_device_get_name(device));
-			fu_device_set_flags(dev, fu_device_get_flags(device));
-			fu_device_set_internal_flags(dev, fu_device_get_internal_flags(device));
-			fu_device_set_id(dev, fu_device_get_id(device));
-			fu_device_set_version_raw(dev, fu_device_get_version_raw(device));
-			fu_device_set_version_format(dev, fu_device_get_version_format(device));
-			fu_device_set_version(dev, fu_device_get_version(device));
-		} else {
-			fu_device_inhibit(dev, "not-found", "Device was not found");
-		}
+static void
+fu_engine_prefetch_helper_free(FuEnginePrefetchHelper *helper)
+{
+	g_free(helper->device_id);
+	g_free(helper->filename);
+	g_free(helper->csum);
+	g_ptr_array_unref(helper->checksums);
+	g_object_unref(helper->jcat_context);
+	if (helper->silo != NULL)
+		g_object_unref(helper->silo);
+	g_free(helper);
+}
 
-		/* add GUID */
-		fu_device_add_guid(dev, guid);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuEnginePrefetchHelper, fu_engine_prefetch_helper_free)
+
+static gboolean
+fu_engine_prefetch_verify_checksum(GPtrArray *csums, GBytes *blob, GError **error)
+{
+	/* the metadata may also list checksums of the payload, so any match is fine */
+	for (guint i = 0; i < csums->len; i++) {
+		const gchar *csum = g_ptr_array_index(csums, i);
+		g_autofree gchar *csum_actual =
+		    g_compute_checksum_for_bytes(fwupd_checksum_guess_kind(csum), blob);
+		if (g_strcmp0(csum, csum_actual) == 0)
+			return TRUE;
 	}
-	if (fu_device_get_guids(dev)->len == 0) {
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "cabinet does not match any checksum in the metadata");
+	return FALSE;
+}
+
+static gchar *
+fu_engine_prefetch_get_filename(FuEngine *self, FuRelease *release, GError **error)
+{
+	FwupdRemote *remote;
+	GPtrArray *locations = fwupd_release_get_locations(FWUPD_RELEASE(release));
+	const gchar *location;
+
+	if (locations->len == 0) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
-				    FWUPD_ERROR_INTERNAL,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "release has no location");
+		return NULL;
+	}
+	location = g_ptr_array_index(locations, 0);
+
+	/* the daemon has no network access, so only local files can be prepared */
+	remote = fu_remote_list_get_by_id(self->remote_list,
+					  fwupd_release_get_remote_id(FWUPD_RELEASE(release)));
+	if (remote != NULL && fwupd_remote_get_kind(remote) == FWUPD_REMOTE_KIND_DIRECTORY &&
+	    g_str_has_prefix(location, "file://"))
+		return g_strdup(location + 7);
+	if (remote != NULL && fwupd_remote_get_kind(remote) == FWUPD_REMOTE_KIND_LOCAL &&
+	    g_strstr_len(location, -1, "://") == NULL) {
+		const gchar *fn_cache = fwupd_remote_get_filename_cache(remote);
+		g_autofree gchar *path = g_path_get_dirname(fn_cache);
+		return g_build_filename(path, location, NULL);
+	}
+	g_set_error(error,
+		    FWUPD_ERROR,
+		    FWUPD_ERROR_NOT_SUPPORTED,
+		    "%s is not available locally",
+		    location);
+	return NULL;
+}
+
+/* the requirement checks need the engine, so these are done on the main thread */
+static FuEnginePrefetchHelper *
+fu_engine_prefetch_helper_new(FuEngine *self, const gchar *device_id, GError **error)
+{
+	FuRelease *release;
+	g_autoptr(FuEnginePrefetchHelper) helper = g_new0(FuEnginePrefetchHelper, 1);
+	g_autoptr(FuEngineRequest) request = NULL;
+	g_autoptr(GPtrArray) releases = NULL;
+
+	/* the release the admin would install, which also honors ApprovedFirmware */
+	request = fu_engine_request_new(FU_ENGINE_REQUEST_KIND_ONLY_SUPPORTED);
+	fu_engine_request_set_feature_flags(request, ~0);
+	releases = fu_engine_get_upgrades(self, request, device_id, error);
+	if (releases == NULL)
+		return NULL;
+	release = g_ptr_array_index(releases, 0);
+	if (!fu_engine_check_requirements(self, release, FWUPD_INSTALL_FLAG_NONE, error))
+		return NULL;
+
+	/* everything the thread needs */
+	helper->device_id = g_strdup(device_id);
+	helper->filename = fu_engine_prefetch_get_filename(self, release, error);
+	if (helper->filename == NULL)
+		return NULL;
+	helper->checksums = g_ptr_array_ref(fu_release_get_checksums(release));
+	helper->jcat_context = g_object_ref(self->prefetch_jcat_context);
+	helper->archive_size_max = fu_engine_get_archive_size_max(self);
+	helper->generation = self->prefetch_generation;
+	return g_steal_pointer(&helper);
+}
+
+/* loading, verifying and parsing the cabinet is slow, so this runs in a thread */
+static gboolean
+fu_engine_prefetch_helper_run(FuEnginePrefetchHelper *helper, GError **error)
+{
+	g_autoptr(GBytes) blob = NULL;
+
+	blob = fu_common_get_contents_bytes(helper->filename, error);
+	if (blob == NULL)
+		return FALSE;
+	if (!fu_engine_prefetch_verify_checksum(helper->checksums, blob, error))
+		return FALSE;
+	helper->csum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, blob);
+	helper->silo = fu_engine_parse_cabinet_full(blob,
+						    helper->jcat_context,
+						    helper->archive_size_max,
+						    error);
+	return helper->silo != NULL;
+}
+
+/* the silo holds the decompressed payloads as well as the parsed metadata */
+static gsize
+fu_engine_prefetch_get_silo_size(XbSilo *silo)
+{
+	gsize size = xb_silo_get_size(silo);
+	g_autoptr(GPtrArray) rels = NULL;
+
+	rels = xb_silo_query(silo, "components/component/releases/release", 0, NULL);
+	if (rels == NULL)
+		return size;
+	for (guint i = 0; i < rels->len; i++) {
+		XbNode *rel = g_ptr_array_index(rels, i);
+		GBytes *blob = xb_node_get_data(rel, "fwupd::FirmwareBlob");
+		if (blob != NULL)
+			size += g_bytes_get_size(blob);
+	}
+	return size;
+}
+
+static gboolean
+fu_engine_prefetch_helper_commit(FuEngine *self, FuEnginePrefetchHelper *helper, GError **error)
+{
+	FuEnginePrefetchItem *item;
+	gsize size;
+
+	/* the config, remotes or metadata changed since this was started */
+	if (helper->generation != self->prefetch_generation) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "prefetched firmware is out of date");
+		return FALSE;
+	}
+	if (g_hash_table_contains(self->prefetch_items, helper->csum))
+		return TRUE;
+	size = fu_engine_prefetch_get_silo_size(helper->silo);
+	if (self->prefetch_size + size > FU_ENGINE_PREFETCH_SIZE_MAX) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "too much firmware prepared already");
+		return FALSE;
+	}
+
+	/* success */
+	g_debug("prefetched %s for %s", helper->filename, helper->device_id);
+	item = g_new0(FuEnginePrefetchItem, 1);
+	item->silo = g_steal_pointer(&helper->silo);
+	item->size = size;
+	self->prefetch_size += item->size;
+	g_hash_table_insert(self->prefetch_items, g_steal_pointer(&helper->csum), item);
+	return TRUE;
+}
+
+/**
+ * fu_engine_prefetch_device:
+ * @self: a #FuEngine
+ * @device_id: a device ID
+ * @error: (nullable): optional return location for an error
+ *
+ * Prepares the firmware for the upgrade of one device, all in the calling thread.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_engine_prefetch_device(FuEngine *self, const gchar *device_id, GError **error)
+{
+	g_autoptr(FuEnginePrefetchHelper) helper = NULL;
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
+	g_return_val_if_fail(device_id != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	helper = fu_engine_prefetch_helper_new(self, device_id, error);
+	if (helper == NULL)
+		return FALSE;
+	if (!fu_engine_prefetch_helper_run(helper, error))
+		return FALSE;
+	return fu_engine_prefetch_helper_commit(self, helper, error);
+}
+
+/* for the self tests */
+gsize
+fu_engine_get_prefetch_size(FuEngine *self)
+{
+	g_return_val_if_fail(FU_IS_ENGINE(self), 0);
+	return self->prefetch_size;
+}
+
+static void
+fu_engine_prefetch_thread_cb(GTask *task,
+			     gpointer source_object,
+			     gpointer task_data,
+			     GCancellable *cancellable)
+{
+	FuEnginePrefetchHelper *helper = (FuEnginePrefetchHelper *)task_data;
+	g_autoptr(GError) error_local = NULL;
+
+	if (!fu_engine_prefetch_helper_run(helper, &error_local)) {
+		g_task_return_error(task, g_steal_pointer(&error_local));
+		return;
+	}
+	g_task_return_boolean(task, TRUE);
+}
+
+static void
+fu_engine_prefetch_start(FuEngine *self);
+
+static void
+fu_engine_prefetch_ready_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FuEngine *self = FU_ENGINE(source);
+	FuEnginePrefetchHelper *helper = g_task_get_task_data(G_TASK(res));
+	g_autoptr(GError) error_local = NULL;
+
+	self->prefetch_running = FALSE;
+	if (!g_task_propagate_boolean(G_TASK(res), &error_local) ||
+	    !fu_engine_prefetch_helper_commit(self, helper, &error_local)) {
+		g_debug("not prefetching for %s: %s", helper->device_id, error_local->message);
+	}
+	fu_engine_prefetch_start(self);
+}
+
+static gboolean
+fu_engine_prefetch_cb(gpointer user_data)
+{
+	FuEngine *self = FU_ENGINE(user_data);
+	g_autofree gchar *device_id = NULL;
+	g_autoptr(FuEnginePrefetchHelper) helper = NULL;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GTask) task = NULL;
+
+	/* an update or a plugin is busy, so wait for FuIdle:inhibited to change */
+	self->prefetch_id = 0;
+	if (fu_idle_has_inhibit(self->idle))
+		return G_SOURCE_REMOVE;
+
+	/* one device each time, so the daemon stays responsive to clients */
+	device_id = g_strdup(g_ptr_array_index(self->prefetch_queue, 0));
+	g_ptr_array_remove_index(self->prefetch_queue, 0);
+	helper = fu_engine_prefetch_helper_new(self, device_id, &error_local);
+	if (helper == NULL) {
+		g_debug("not prefetching for %s: %s", device_id, error_local->message);
+		fu_engine_prefetch_start(self);
+		return G_SOURCE_REMOVE;
+	}
+
+	/* the next device is started when this one is done */
+	self->prefetch_running = TRUE;
+	task = g_task_new(self, NULL, fu_engine_prefetch_ready_cb, NULL);
+	g_task_set_task_data(task,
+			     g_steal_pointer(&helper),
+			     (GDestroyNotify)fu_engine_prefetch_helper_free);
+	g_task_run_in_thread(task, fu_engine_prefetch_thread_cb);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+fu_engine_prefetch_start(FuEngine *self)
+{
+	if (self->prefetch_id != 0 || self->prefetch_running)
+		return;
+	if (self->prefetch_queue->len == 0)
+		return;
+	if (fu_idle_has_inhibit(self->idle))
+		return;
+	self->prefetch_id =
+	    g_timeout_add_seconds(FU_ENGINE_PREFETCH_INTERVAL, fu_engine_prefetch_cb, self);
+}
+
+static gboolean
+fu_engine_prefetch_resume_cb(gpointer user_data)
+{
+	FuEngine *self = FU_ENGINE(user_data);
+	fu_engine_prefetch_start(self);
+	return G_SOURCE_REMOVE;
+}
+
+/* the idle inhibit can be changed from any thread */
+static void
+fu_engine_idle_inhibited_notify_cb(FuIdle *idle, GParamSpec *pspec, FuEngine *self)
+{
+	g_main_context_invoke_full(NULL,
+				   G_PRIORITY_DEFAULT,
+				   fu_engine_prefetch_resume_cb,
+				   g_object_ref(self),
+				   g_object_unref);
+}
+
+/* prepare the firmware for approved upgrades in the background */
+static void
+fu_engine_prefetch_schedule(FuEngine *self)
+{
+	g_autoptr(GPtrArray) devices = NULL;
+
+	/* the upgrades, trust or limits may be different, so drop anything in progress too */
+	g_hash_table_remove_all(self->prefetch_items);
+	self->prefetch_size = 0;
+	self->prefetch_generation++;
+	g_ptr_array_set_size(self->prefetch_queue, 0);
+	if (self->prefetch_id != 0) {
+		g_source_remove(self->prefetch_id);
+		self->prefetch_id = 0;
+	}
+	if ((self->app_flags & FU_APP_FLAGS_NO_IDLE_SOURCES) > 0)
+		return;
+	if (!fu_config_get_prefetch_firmware(self->config))
+		return;
+
+	devices = fu_device_list_get_active(self->device_list);
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		if (!fu_device_has_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE))
+			continue;
+		g_ptr_array_add(self->prefetch_queue, g_strdup(fu_device_get_id(device)));
+	}
+	fu_engine_prefetch_start(self);
+}
+
+static FuDevice *
+fu_engine_get_result_from_component(FuEngine *self,
+				    FuEngineRequest *request,
+				    XbNode *component,
+				    GError **error)
+{
+	FwupdReleaseFlags release_flags = FWUPD_RELEASE_FLAG_NONE;
+	g_autofree gchar *description_xpath = NULL;
+	g_autoptr(FuDevice) dev = NULL;
+	g_autoptr(FuRelease) release = NULL;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GError) error_reqs = NULL;
+	g_autoptr(GPtrArray) provides = NULL;
+	g_autoptr(GPtrArray) tags = NULL;
+	g_autoptr(XbNode) description = NULL;
+	g_autoptr(XbNode) rel = NULL;
+#if LIBXMLB_CHECK_VERSION(0, 2, 0)
+	g_autoptr(XbQuery) query = NULL;
+#endif
+
+	dev = fu_device_new_with_context(self->ctx);
+	provides = xb_node_query(component, "provides/firmware[@type=$'flashed']", 0, &error_local);
+	if (provides == NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "failed to get release: %s",
+			    error_local->message);
+		return NULL;
+	}
+	for (guint i = 0; i < provides->len; i++) {
+		XbNode *prov = XB_NODE(g_ptr_array_index(provides, i));
+		const gchar *guid;
+		g_autoptr(FuDevice) device = NULL;
+
+		/* is a online or offline update appropriate */
+		guid = xb_node_get_text(prov);
+		if (guid == NULL)
+			continue;
+		device = fu_device_list_get_by_guid(self->device_list, guid, NULL);
+		if (device != NULL) {
+			fu_device_set_name(dev, fu_device_get_name(device));
+			fu_device_set_flags(dev, fu_device_get_flags(device));
+			fu_device_set_internal_flags(dev, fu_device_get_internal_flags(device));
+			fu_device_set_id(dev, fu_device_get_id(device));
+			fu_device_set_version_raw(dev, fu_device_get_version_raw(device));
+			fu_device_set_version_format(dev, fu_device_get_version_format(device));
+			fu_device_set_version(dev, fu_device_get_version(device));
+		} else {
+			fu_device_inhibit(dev, "not-found", "Device was not found");
+		}
+
+		/* add GUID */
+		fu_device_add_guid(dev, guid);
+	}
+	if (fu_device_get_guids(dev)->len == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
 				    "component has no GUIDs");
 		return NULL;
 	}
@@ -4451,6 +5240,10 @@ fu_engine_get_history(FuEngine *self, GError **error)
 	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
 
+	/* the history database has to be up to date */
+	if (!fu_engine_ensure_subsystem(self, FU_ENGINE_SUBSYSTEM_HISTORY, error))
+		return NULL;
+
 	devices = fu_history_get_devices(self->history, error);
 	if (devices == NULL)
 		return NULL;
@@ -4788,7 +5581,11 @@ fu_engine_get_releases_for_device(FuEngine *self,
 				       "../..",
 				       guid);
 	}
+	FU_TRACE1(engine_query_entry, "components-for-device");
 	components = xb_silo_query(self->silo, xpath->str, 0, &error_local);
+	FU_TRACE2(engine_query_exit,
+		  "components-for-device",
+		  components != NULL ? components->len : 0);
 	if (components == NULL) {
 		if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) ||
 		    g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
@@ -5239,6 +6036,10 @@ fu_engine_clear_results(FuEngine *self, const gchar *device_id, GError **error)
 	g_return_val_if_fail(device_id != NULL, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
+	/* the history database has to be up to date */
+	if (!fu_engine_ensure_subsystem(self, FU_ENGINE_SUBSYSTEM_HISTORY, error))
+		return FALSE;
+
 	/* find the device */
 	device = fu_engine_get_item_by_id_fallback_history(self, device_id, error);
 	if (device == NULL)
@@ -5289,6 +6090,10 @@ fu_engine_get_results(FuEngine *self, const gchar *device_id, GError **error)
 	g_return_val_if_fail(device_id != NULL, NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
 
+	/* the history database has to be up to date */
+	if (!fu_engine_ensure_subsystem(self, FU_ENGINE_SUBSYSTEM_HISTORY, error))
+		return NULL;
+
 	/* find the device */
 	device = fu_engine_get_item_by_id_fallback_history(self, device_id, error);
 	if (device == NULL)
@@ -5316,7 +6121,14 @@ fu_engine_plugins_setup(FuEngine *self)
 	for (guint i = 0; i < plugins->len; i++) {
 		g_autoptr(GError) error = NULL;
 		FuPlugin *plugin = g_ptr_array_index(plugins, i);
-		if (!fu_plugin_runner_startup(plugin, &error)) {
+		gint64 start = g_get_monotonic_time();
+		gboolean ret = fu_plugin_runner_startup(plugin, &error);
+		fu_statistics_add_duration(self->statistics,
+					   "fwupd_plugin_startup_duration_microseconds",
+					   "plugin",
+					   fu_plugin_get_name(plugin),
+					   g_get_monotonic_time() - start);
+		if (!ret) {
 			fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
 			if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
 				fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_NO_HARDWARE);
@@ -5337,7 +6149,14 @@ fu_engine_plugins_coldplug(FuEngine *self)
 	for (guint i = 0; i < plugins->len; i++) {
 		g_autoptr(GError) error = NULL;
 		FuPlugin *plugin = g_ptr_array_index(plugins, i);
-		if (!fu_plugin_runner_coldplug(plugin, &error)) {
+		gint64 start = g_get_monotonic_time();
+		gboolean ret = fu_plugin_runner_coldplug(plugin, &error);
+		fu_statistics_add_duration(self->statistics,
+					   "fwupd_plugin_coldplug_duration_microseconds",
+					   "plugin",
+					   fu_plugin_get_name(plugin),
+					   g_get_monotonic_time() - start);
+		if (!ret) {
 			fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
 			g_message("disabling plugin because: %s", error->message);
 		}
@@ -5702,7 +6521,21 @@ fu_engine_context_security_changed_cb(FuContext *ctx, gpointer user_data)
 	FuEngine *self = FU_ENGINE(user_data);
 
 	/* invalidate host security attributes */
-	g_clear_pointer(&self->host_security_id, g_free);
+	fu_engine_invalidate_security_attrs(self, NULL);
+
+	/* make UI refresh */
+	fu_engine_emit_changed(self);
+}
+
+static void
+fu_engine_context_security_changed_full_cb(FuContext *ctx,
+					   const gchar *plugin_name,
+					   gpointer user_data)
+{
+	FuEngine *self = FU_ENGINE(user_data);
+
+	/* only the attributes from this plugin */
+	fu_engine_invalidate_security_attrs(self, plugin_name);
 
 	/* make UI refresh */
 	fu_engine_emit_changed(self);
@@ -5790,6 +6623,57 @@ fu_engine_is_plugin_name_enabled(FuEngine *self, const gchar *name)
 	return FALSE;
 }
 
+/* replaces all the other backends, and so must be called before fu_engine_load() */
+gboolean
+fu_engine_emulation_load(FuEngine *self, const gchar *filename, GError **error)
+{
+	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
+	g_return_val_if_fail(filename != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (self->loaded) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "cannot load emulation data after the engine is loaded");
+		return FALSE;
+	}
+	if (!g_file_test(filename, G_FILE_TEST_EXISTS)) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_FOUND,
+			    "%s does not exist",
+			    filename);
+		return FALSE;
+	}
+	for (guint i = 0; i < self->backends->len; i++) {
+		FuBackend *backend = g_ptr_array_index(self->backends, i);
+		fu_backend_set_enabled(backend, FALSE);
+	}
+	g_ptr_array_add(self->backends, fu_emulation_backend_new(filename));
+	return TRUE;
+}
+
+gboolean
+fu_engine_emulation_save(FuEngine *self, const gchar *filename, GError **error)
+{
+	g_autoptr(GPtrArray) devices = NULL;
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
+	g_return_val_if_fail(filename != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (!fu_context_has_flag(self->ctx, FU_CONTEXT_FLAG_SAVE_EVENTS)) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "device events are not being saved");
+		return FALSE;
+	}
+	devices = fu_device_list_get_all(self->device_list);
+	return fu_emulation_backend_save(devices, filename, error);
+}
+
 void
 fu_engine_add_plugin_filter(FuEngine *self, const gchar *plugin_glob)
 {
@@ -5813,7 +6697,9 @@ fu_engine_plugin_check_supported_cb(FuPlugin *plugin, const gchar *guid, FuEngin
 	xpath = g_strdup_printf("components/component[@type='firmware']/"
 				"provides/firmware[@type='flashed'][text()='%s']",
 				guid);
+	FU_TRACE1(engine_query_entry, "check-supported");
 	n = xb_silo_query_first(self->silo, xpath, NULL);
+	FU_TRACE2(engine_query_exit, "check-supported", n != NULL);
 	return n != NULL;
 }
 
@@ -5936,33 +6822,9 @@ static gboolean
 fu_engine_record_security_attrs(FuEngine *self, GError **error)
 {
 #if JSON_CHECK_VERSION(1, 6, 0)
-	g_autoptr(GPtrArray) attrs_array = NULL;
-	g_autofree gchar *json = NULL;
-
-	/* convert attrs to json string */
-	json = fu_security_attrs_to_json_string(self->host_security_attrs, error);
-	if (json == NULL) {
-		g_prefix_error(error, "cannot convert current attrs to string: ");
-		return FALSE;
-	}
-
-	/* check that we did not store this already last boot */
-	attrs_array = fu_history_get_security_attrs(self->history, 1, error);
-	if (attrs_array == NULL) {
-		g_prefix_error(error, "failed to get historical attr: ");
-		return FALSE;
-	}
-	if (attrs_array->len > 0) {
-		FuSecurityAttrs *attrs_tmp = g_ptr_array_index(attrs_array, 0);
-		if (fu_security_attrs_equal(attrs_tmp, self->host_security_attrs)) {
-			g_debug("skipping writing HSI attrs to database as unchanged");
-			return TRUE;
-		}
-	}
-
-	/* write new values */
+	/* write new values, which does nothing if unchanged since the last boot */
 	if (!fu_history_add_security_attribute(self->history,
-					       json,
+					       self->host_security_attrs,
 					       self->host_security_id,
 					       error)) {
 		g_prefix_error(error, "failed to write to DB: ");
@@ -5973,6 +6835,227 @@ fu_engine_record_security_attrs(FuEngine *self, GError **error)
 	/* success */
 	return TRUE;
 }
+
+static FuEngineSecurityAttrsHelper *
+fu_engine_security_attrs_helper_new(FuEngine *self,
+				    const gchar *name,
+				    FuPlugin *plugin,
+				    GAsyncQueue *queue)
+{
+	FuEngineSecurityAttrsHelper *helper = g_new0(FuEngineSecurityAttrsHelper, 1);
+	helper->refcount = 1;
+	helper->state = FU_ENGINE_SECURITY_ATTRS_STATE_RUNNING;
+	g_weak_ref_init(&helper->engine, self);
+	helper->name = g_strdup(name);
+	if (plugin != NULL)
+		helper->plugin = g_object_ref(plugin);
+	helper->devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	helper->attrs = fu_security_attrs_new();
+	helper->cancellable = g_cancellable_new();
+	helper->queue = g_async_queue_ref(queue);
+	return helper;
+}
+
+static FuEngineSecurityAttrsHelper *
+fu_engine_security_attrs_helper_ref(FuEngineSecurityAttrsHelper *helper)
+{
+	g_atomic_int_inc(&helper->refcount);
+	return helper;
+}
+
+/* runs in the main thread after the plugin finished outside the time budget */
+static gboolean
+fu_engine_security_attrs_late_cb(gpointer user_data)
+{
+	FuEngineSecurityAttrsHelper *helper = (FuEngineSecurityAttrsHelper *)user_data;
+	g_autoptr(FuEngine) self = g_weak_ref_get(&helper->engine);
+
+	/* engine has been destroyed */
+	if (self == NULL)
+		return G_SOURCE_REMOVE;
+
+	/* results are picked up next time, so make the UI refresh */
+	g_clear_pointer(&self->host_security_id, g_free);
+	fu_engine_emit_changed(self);
+	return G_SOURCE_REMOVE;
+}
+
+/* runs in a worker thread, and may outlive both the time budget and the engine */
+static void
+fu_engine_ensure_security_attrs_plugin_cb(gpointer data, gpointer user_data)
+{
+	FuEngineSecurityAttrsHelper *helper = (FuEngineSecurityAttrsHelper *)data;
+	gint64 start = g_get_monotonic_time();
+
+	/* the engine no longer cares */
+	if (!g_cancellable_is_cancelled(helper->cancellable)) {
+		/* call into devices */
+		for (guint i = 0; i < helper->devices->len; i++) {
+			FuDevice *device = g_ptr_array_index(helper->devices, i);
+			fu_device_add_security_attrs(device, helper->attrs);
+		}
+
+		/* call into plugin */
+		if (helper->plugin != NULL)
+			fu_plugin_runner_add_security_attrs(helper->plugin, helper->attrs);
+	}
+	helper->duration = g_get_monotonic_time() - start;
+
+	/* wake up the waiting thread, unless it already gave up on us */
+	if (g_atomic_int_compare_and_exchange(&helper->state,
+					      FU_ENGINE_SECURITY_ATTRS_STATE_RUNNING,
+					      FU_ENGINE_SECURITY_ATTRS_STATE_DONE)) {
+		g_async_queue_push(helper->queue, helper);
+	} else {
+		g_atomic_int_set(&helper->state, FU_ENGINE_SECURITY_ATTRS_STATE_LATE);
+		g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
+				fu_engine_security_attrs_late_cb,
+				fu_engine_security_attrs_helper_ref(helper),
+				(GDestroyNotify)fu_engine_security_attrs_helper_unref);
+	}
+	fu_engine_security_attrs_helper_unref(helper);
+}
+
+static void
+fu_engine_ensure_security_attrs_cache(FuEngine *self, FuEngineSecurityAttrsHelper *helper)
+{
+	g_debug("%s added security attrs in %.1fms", helper->name, helper->duration / 1000.f);
+	g_hash_table_insert(self->host_security_timings,
+			    g_strdup(helper->name),
+			    GUINT_TO_POINTER(helper->duration / 1000));
+
+	/* something was invalidated while the plugin was running */
+	if (g_cancellable_is_cancelled(helper->cancellable))
+		return;
+	g_hash_table_insert(self->host_security_attrs_plugin,
+			    g_strdup(helper->name),
+			    g_object_ref(helper->attrs));
+	g_hash_table_remove(self->host_security_attrs_stale, helper->name);
+}
+
+/* abandons the helpers that have used their time budget; returns the number abandoned */
+static guint
+fu_engine_ensure_security_attrs_abandon(FuEngine *self, GPtrArray *helpers, gint64 now)
+{
+	guint abandoned = 0;
+	for (guint i = 0; i < helpers->len; i++) {
+		FuEngineSecurityAttrsHelper *helper = g_ptr_array_index(helpers, i);
+		if (helper->deadline == 0 || helper->deadline > now)
+			continue;
+		if (!g_atomic_int_compare_and_exchange(&helper->state,
+						       FU_ENGINE_SECURITY_ATTRS_STATE_RUNNING,
+						       FU_ENGINE_SECURITY_ATTRS_STATE_ABANDONED))
+			continue;
+		g_debug("%s did not add security attrs in time", helper->name);
+		g_hash_table_insert(self->host_security_attrs_running,
+				    g_strdup(helper->name),
+				    fu_engine_security_attrs_helper_ref(helper));
+		abandoned++;
+	}
+	return abandoned;
+}
+
+/* each plugin only writes to its own attrs, so these can be run at the same time, and each one
+ * has its own time budget -- anything still running after that is left in the running table */
+static void
+fu_engine_ensure_security_attrs_refresh(FuEngine *self, GPtrArray *helpers, GAsyncQueue *queue)
+{
+	guint done = 0;
+	guint abandoned = 0;
+	guint timeout = fu_config_get_host_security_timeout(self->config);
+	GThreadPool *pool;
+	g_autoptr(GError) error = NULL;
+
+	/* one thread for each plugin so that a slow plugin cannot delay the others */
+	pool = g_thread_pool_new(fu_engine_ensure_security_attrs_plugin_cb,
+				 self,
+				 -1,
+				 FALSE,
+				 &error);
+	if (pool == NULL) {
+		g_warning("failed to create thread pool: %s", error->message);
+		timeout = 0;
+	}
+	for (guint i = 0; i < helpers->len; i++) {
+		FuEngineSecurityAttrsHelper *helper = g_ptr_array_index(helpers, i);
+		g_autoptr(GError) error_local = NULL;
+		if (timeout > 0)
+			helper->deadline = g_get_monotonic_time() + (gint64)timeout * 1000;
+		fu_engine_security_attrs_helper_ref(helper);
+		if (pool == NULL) {
+			fu_engine_ensure_security_attrs_plugin_cb(helper, self);
+			continue;
+		}
+		if (!g_thread_pool_push(pool, helper, &error_local)) {
+			g_warning("failed to push to thread pool: %s", error_local->message);
+			fu_engine_ensure_security_attrs_plugin_cb(helper, self);
+		}
+	}
+	if (pool != NULL)
+		g_thread_pool_free(pool, FALSE, FALSE);
+
+	/* wait for each plugin to either finish or use up its time budget */
+	while (done + abandoned < helpers->len) {
+		gint64 deadline = 0;
+		gint64 now = g_get_monotonic_time();
+		gpointer item;
+
+		for (guint i = 0; i < helpers->len; i++) {
+			FuEngineSecurityAttrsHelper *helper = g_ptr_array_index(helpers, i);
+			if (helper->deadline == 0)
+				continue;
+			if (g_atomic_int_get(&helper->state) !=
+			    FU_ENGINE_SECURITY_ATTRS_STATE_RUNNING)
+				continue;
+			if (deadline == 0 || helper->deadline < deadline)
+				deadline = helper->deadline;
+		}
+		if (deadline == 0) {
+			item = g_async_queue_pop(queue);
+		} else if (deadline > now) {
+			item = g_async_queue_timeout_pop(queue, deadline - now);
+		} else {
+			item = NULL;
+		}
+		if (item == NULL) {
+			now = g_get_monotonic_time();
+			abandoned += fu_engine_ensure_security_attrs_abandon(self, helpers, now);
+			continue;
+		}
+		fu_engine_ensure_security_attrs_cache(self, (FuEngineSecurityAttrsHelper *)item);
+		done++;
+	}
+}
+
+/* the last known attributes, but with an unknown result */
+static void
+fu_engine_ensure_security_attrs_stale(FuEngine *self, const gchar *name)
+{
+	FuSecurityAttrs *attrs = g_hash_table_lookup(self->host_security_attrs_stale, name);
+	g_autoptr(GPtrArray) items = NULL;
+
+	if (attrs == NULL)
+		return;
+	items = fu_security_attrs_get_all(attrs);
+	for (guint i = 0; i < items->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(items, i);
+		g_autoptr(FwupdSecurityAttr) attr_copy = fwupd_security_attr_copy(attr);
+		fwupd_security_attr_remove_flag(attr_copy, FWUPD_SECURITY_ATTR_FLAG_SUCCESS);
+		fwupd_security_attr_set_result(attr_copy, FWUPD_SECURITY_ATTR_RESULT_UNKNOWN);
+		fu_security_attrs_append_internal(self->host_security_attrs, attr_copy);
+	}
+}
+
+static void
+fu_engine_ensure_security_attrs_append(FuEngine *self, FuSecurityAttrs *attrs)
+{
+	g_autoptr(GPtrArray) items = fu_security_attrs_get_all(attrs);
+	for (guint i = 0; i < items->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(items, i);
+		g_autoptr(FwupdSecurityAttr) attr_copy = fwupd_security_attr_copy(attr);
+		fu_security_attrs_append_internal(self->host_security_attrs, attr_copy);
+	}
+}
 #endif
 
 static void
@@ -5980,31 +7063,94 @@ fu_engine_ensure_security_attrs(FuEngine *self)
 {
 #ifdef HAVE_HSI
 	GPtrArray *plugins = fu_plugin_list_get_all(self->plugin_list);
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	guint running;
 	g_autoptr(GPtrArray) devices = fu_device_list_get_all(self->device_list);
 	g_autoptr(GPtrArray) items = NULL;
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GAsyncQueue) queue = g_async_queue_new();
+	g_autoptr(GHashTable) helpers = g_hash_table_new(g_str_hash, g_str_equal);
+	g_autoptr(GPtrArray) helpers_array =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_security_attrs_helper_unref);
+
+	/* pick up any results from plugins that previously took too long */
+	g_hash_table_iter_init(&iter, self->host_security_attrs_running);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		FuEngineSecurityAttrsHelper *helper = (FuEngineSecurityAttrsHelper *)value;
+		if (g_atomic_int_get(&helper->state) != FU_ENGINE_SECURITY_ATTRS_STATE_LATE)
+			continue;
+		fu_engine_ensure_security_attrs_cache(self, helper);
+		g_hash_table_iter_remove(&iter);
+	}
+
+	/* plugins may have been disabled or devices removed since last time */
+	if (fu_engine_security_attrs_prune(self))
+		g_clear_pointer(&self->host_security_id, g_free);
 
 	/* already valid */
 	if (self->host_security_id != NULL)
 		return;
 
+	/* only the plugins that have been invalidated need to be run again, and a plugin that is
+	 * still busy from last time is not called into again until it has finished */
+	for (guint j = 0; j < plugins->len; j++) {
+		FuPlugin *plugin_tmp = g_ptr_array_index(plugins, j);
+		const gchar *name = fu_plugin_get_name(plugin_tmp);
+		FuEngineSecurityAttrsHelper *helper;
+		if (g_hash_table_contains(self->host_security_attrs_plugin, name))
+			continue;
+		if (g_hash_table_contains(self->host_security_attrs_running, name))
+			continue;
+		helper = fu_engine_security_attrs_helper_new(self, name, plugin_tmp, queue);
+		g_hash_table_insert(helpers, helper->name, helper);
+		g_ptr_array_add(helpers_array, helper);
+	}
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		const gchar *name = fu_device_get_plugin(device);
+		FuEngineSecurityAttrsHelper *helper;
+		if (name == NULL)
+			name = "";
+		if (g_hash_table_contains(self->host_security_attrs_plugin, name))
+			continue;
+		if (g_hash_table_contains(self->host_security_attrs_running, name))
+			continue;
+		helper = g_hash_table_lookup(helpers, name);
+		if (helper == NULL) {
+			helper = fu_engine_security_attrs_helper_new(self, name, NULL, queue);
+			g_hash_table_insert(helpers, helper->name, helper);
+			g_ptr_array_add(helpers_array, helper);
+		}
+		g_ptr_array_add(helper->devices, g_object_ref(device));
+	}
+	g_debug("refreshing security attrs for %u plugins", helpers_array->len);
+	fu_engine_ensure_security_attrs_refresh(self, helpers_array, queue);
+
 	/* clear old values */
 	fu_security_attrs_remove_all(self->host_security_attrs);
 
 	/* built in */
 	fu_engine_ensure_security_attrs_tainted(self);
 
-	/* call into devices */
-	for (guint i = 0; i < devices->len; i++) {
-		FuDevice *device = g_ptr_array_index(devices, i);
-		fu_device_add_security_attrs(device, self->host_security_attrs);
+	/* copy from each plugin as depsolving modifies the flags */
+	g_hash_table_iter_init(&iter, self->host_security_attrs_plugin);
+	while (g_hash_table_iter_next(&iter, NULL, &value))
+		fu_engine_ensure_security_attrs_append(self, FU_SECURITY_ATTRS(value));
+	for (guint i = 0; i < helpers_array->len; i++) {
+		FuEngineSecurityAttrsHelper *helper = g_ptr_array_index(helpers_array, i);
+		if (g_atomic_int_get(&helper->state) != FU_ENGINE_SECURITY_ATTRS_STATE_DONE)
+			continue;
+		if (!g_hash_table_contains(self->host_security_attrs_plugin, helper->name))
+			fu_engine_ensure_security_attrs_append(self, helper->attrs);
 	}
 
-	/* call into plugins */
-	for (guint j = 0; j < plugins->len; j++) {
-		FuPlugin *plugin_tmp = g_ptr_array_index(plugins, j);
-		fu_plugin_runner_add_security_attrs(plugin_tmp, self->host_security_attrs);
-	}
+	/* plugins that are still running report what they said last time */
+	running = g_hash_table_size(self->host_security_attrs_running);
+	g_hash_table_iter_init(&iter, self->host_security_attrs_running);
+	while (g_hash_table_iter_next(&iter, &key, NULL))
+		fu_engine_ensure_security_attrs_stale(self, key);
 
 	/* set the fallback names for clients without native translations */
 	items = fu_security_attrs_get_all(self->host_security_attrs);
@@ -6027,8 +7173,13 @@ fu_engine_ensure_security_attrs(FuEngine *self)
 	/* distil into one simple string */
 	g_free(self->host_security_id);
 	self->host_security_id = fu_engine_attrs_calculate_hsi_for_chassis(self);
+	fu_engine_set_subsystem_ready(self, FU_ENGINE_SUBSYSTEM_SECURITY);
 
-	/* record into the database (best effort) */
+	/* record into the database (best effort), but not if incomplete */
+	if (running > 0) {
+		g_debug("not recording HSI attributes as %u plugins are still running", running);
+		return;
+	}
 	if (!fu_engine_record_security_attrs(self, &error))
 		g_warning("failed to record HSI attributes: %s", error->message);
 #endif
@@ -6050,8 +7201,9 @@ fu_engine_get_host_security_attrs(FuEngine *self)
 	return g_object_ref(self->host_security_attrs);
 }
 
+/* @limit and @offset count changed attributes, not the boots where a snapshot was recorded */
 FuSecurityAttrs *
-fu_engine_get_host_security_events(FuEngine *self, guint limit, GError **error)
+fu_engine_get_host_security_events(FuEngine *self, guint limit, guint offset, GError **error)
 {
 	g_autoptr(FuSecurityAttrs) events = fu_security_attrs_new();
 #if JSON_CHECK_VERSION(1, 6, 0)
@@ -6059,17 +7211,13 @@ fu_engine_get_host_security_events(FuEngine *self, guint limit, GError **error)
 
 	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
 
-	attrs_array = fu_history_get_security_attrs(self->history, limit, error);
+	/* the deltas were computed when each snapshot was recorded */
+	attrs_array = fu_history_get_security_events(self->history, limit, offset, error);
 	if (attrs_array == NULL)
 		return NULL;
-	for (guint i = 1; i < attrs_array->len; i++) {
-		FuSecurityAttrs *attrs_new = g_ptr_array_index(attrs_array, i - 1);
-		FuSecurityAttrs *attrs_old = g_ptr_array_index(attrs_array, i - 0);
-		g_autoptr(GPtrArray) diffs = fu_security_attrs_compare(attrs_old, attrs_new);
-		for (guint j = 0; j < diffs->len; j++) {
-			FwupdSecurityAttr *attr = g_ptr_array_index(diffs, j);
-			fu_security_attrs_append_internal(events, attr);
-		}
+	for (guint i = 0; i < attrs_array->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(attrs_array, i);
+		fu_security_attrs_append_internal(events, attr);
 	}
 #endif
 
@@ -6244,6 +7392,8 @@ fu_engine_backend_device_removed_cb(FuBackend *backend, FuDevice *device, FuEngi
 static void
 fu_engine_backend_device_added_cb(FuBackend *backend, FuDevice *device, FuEngine *self)
 {
+	gboolean ret;
+	gint64 start;
 	g_autoptr(GError) error_local = NULL;
 	g_autoptr(GPtrArray) possible_plugins = NULL;
 
@@ -6255,7 +7405,14 @@ fu_engine_backend_device_added_cb(FuBackend *backend, FuDevice *device, FuEngine
 
 	/* add any extra quirks */
 	fu_device_set_context(device, self->ctx);
-	if (!fu_device_probe(device, &error_local)) {
+	start = g_get_monotonic_time();
+	ret = fu_device_probe(device, &error_local);
+	fu_statistics_add_duration(self->statistics,
+				   "fwupd_device_probe_duration_microseconds",
+				   "backend",
+				   fu_backend_get_name(backend),
+				   g_get_monotonic_time() - start);
+	if (!ret) {
 		if (!g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
 			g_warning("failed to probe device %s: %s",
 				  fu_device_get_backend_id(device),
@@ -6284,7 +7441,14 @@ fu_engine_backend_device_added_cb(FuBackend *backend, FuDevice *device, FuEngine
 		plugin = fu_plugin_list_find_by_name(self->plugin_list, plugin_name, NULL);
 		if (plugin == NULL)
 			continue;
-		if (!fu_plugin_runner_backend_device_added(plugin, device, &error)) {
+		start = g_get_monotonic_time();
+		ret = fu_plugin_runner_backend_device_added(plugin, device, &error);
+		fu_statistics_add_duration(self->statistics,
+					   "fwupd_device_setup_duration_microseconds",
+					   "plugin",
+					   plugin_name,
+					   g_get_monotonic_time() - start);
+		if (!ret) {
 			if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
 				if (g_getenv("FWUPD_PROBE_VERBOSE") != NULL) {
 					g_debug("%s ignoring: %s",
@@ -6628,6 +7792,151 @@ fu_common_win32_registry_get_string(HKEY hkey,
 }
 #endif
 
+/* in the order they are loaded after fu_engine_load_deferred() */
+static const FuEngineSubsystem fu_engine_subsystems_deferred[] = {
+    FU_ENGINE_SUBSYSTEM_HISTORY,
+    FU_ENGINE_SUBSYSTEM_LOCAL_METADATA,
+    FU_ENGINE_SUBSYSTEM_CERTIFICATE,
+    FU_ENGINE_SUBSYSTEM_SECURITY,
+};
+
+/**
+ * fu_engine_subsystem_to_string:
+ * @subsystem: a #FuEngineSubsystem, e.g. %FU_ENGINE_SUBSYSTEM_DEVICES
+ *
+ * Converts an engine subsystem to a string.
+ *
+ * Returns: identifier string, or %NULL if unknown
+ **/
+const gchar *
+fu_engine_subsystem_to_string(FuEngineSubsystem subsystem)
+{
+	if (subsystem == FU_ENGINE_SUBSYSTEM_REMOTES)
+		return "remotes";
+	if (subsystem == FU_ENGINE_SUBSYSTEM_DEVICES)
+		return "devices";
+	if (subsystem == FU_ENGINE_SUBSYSTEM_HISTORY)
+		return "history";
+	if (subsystem == FU_ENGINE_SUBSYSTEM_LOCAL_METADATA)
+		return "local-metadata";
+	if (subsystem == FU_ENGINE_SUBSYSTEM_CERTIFICATE)
+		return "certificate";
+	if (subsystem == FU_ENGINE_SUBSYSTEM_SECURITY)
+		return "security";
+	return NULL;
+}
+
+static void
+fu_engine_set_subsystem_ready(FuEngine *self, FuEngineSubsystem subsystem)
+{
+	if (self->subsystems_ready & subsystem)
+		return;
+	g_debug("%s ready", fu_engine_subsystem_to_string(subsystem));
+	self->subsystems_ready |= subsystem;
+	g_signal_emit(self, signals[SIGNAL_SUBSYSTEMS_CHANGED], 0);
+}
+
+/**
+ * fu_engine_get_subsystems_ready:
+ * @self: a #FuEngine
+ *
+ * Gets the subsystems that have finished loading.
+ *
+ * Returns: a #FuEngineSubsystem bitfield
+ **/
+FuEngineSubsystem
+fu_engine_get_subsystems_ready(FuEngine *self)
+{
+	g_return_val_if_fail(FU_IS_ENGINE(self), FU_ENGINE_SUBSYSTEM_NONE);
+	return self->subsystems_ready;
+}
+
+/**
+ * fu_engine_ensure_subsystem:
+ * @self: a #FuEngine
+ * @subsystem: a #FuEngineSubsystem, e.g. %FU_ENGINE_SUBSYSTEM_HISTORY
+ * @error: (nullable): optional return location for an error
+ *
+ * Loads a subsystem now if it was skipped using %FU_ENGINE_LOAD_FLAG_STAGED and has not yet
+ * been loaded by fu_engine_load_deferred().
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_engine_ensure_subsystem(FuEngine *self, FuEngineSubsystem subsystem, GError **error)
+{
+	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* already done */
+	if (self->subsystems_ready & subsystem)
+		return TRUE;
+
+	if (subsystem == FU_ENGINE_SUBSYSTEM_HISTORY) {
+		/* update the db for devices that were updated during the reboot */
+		if (!fu_engine_update_history_database(self, error))
+			return FALSE;
+	} else if (subsystem == FU_ENGINE_SUBSYSTEM_LOCAL_METADATA) {
+		/* delete old data files, then watch the local.d directories for changes */
+		if (!fu_engine_cleanup_state(error)) {
+			g_prefix_error(error, "Failed to clean up: ");
+			return FALSE;
+		}
+		if (!fu_engine_load_local_metadata_watches(self, error))
+			return FALSE;
+	} else if (subsystem == FU_ENGINE_SUBSYSTEM_CERTIFICATE) {
+		fu_engine_ensure_client_certificate(self);
+	} else if (subsystem == FU_ENGINE_SUBSYSTEM_SECURITY) {
+		fu_engine_ensure_security_attrs(self);
+	} else {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "subsystem %s can only be loaded by fu_engine_load()",
+			    fu_engine_subsystem_to_string(subsystem));
+		return FALSE;
+	}
+	fu_engine_set_subsystem_ready(self, subsystem);
+	return TRUE;
+}
+
+static gboolean
+fu_engine_load_deferred_cb(gpointer user_data)
+{
+	FuEngine *self = FU_ENGINE(user_data);
+	FuEngineSubsystem subsystem = fu_engine_subsystems_deferred[self->deferred_idx++];
+	g_autoptr(GError) error_local = NULL;
+
+	/* one subsystem each time the main loop is idle */
+	if (!fu_engine_ensure_subsystem(self, subsystem, &error_local)) {
+		g_warning("failed to load %s: %s",
+			  fu_engine_subsystem_to_string(subsystem),
+			  error_local->message);
+	}
+	if (self->deferred_idx < G_N_ELEMENTS(fu_engine_subsystems_deferred))
+		return G_SOURCE_CONTINUE;
+	self->deferred_id = 0;
+	return G_SOURCE_REMOVE;
+}
+
+/**
+ * fu_engine_load_deferred:
+ * @self: a #FuEngine
+ *
+ * Loads the subsystems that were skipped using %FU_ENGINE_LOAD_FLAG_STAGED, one at a time when
+ * there are no requests to answer. This should be called once the daemon has acquired the bus
+ * name, and any subsystem that a request needs before then is loaded on demand.
+ **/
+void
+fu_engine_load_deferred(FuEngine *self)
+{
+	g_return_if_fail(FU_IS_ENGINE(self));
+	if (self->deferred_id != 0 ||
+	    self->deferred_idx >= G_N_ELEMENTS(fu_engine_subsystems_deferred))
+		return;
+	self->deferred_id = g_idle_add_full(G_PRIORITY_LOW, fu_engine_load_deferred_cb, self, NULL);
+}
+
 /**
  * fu_engine_load:
  * @self: a #FuEngine
@@ -6698,6 +8007,7 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, GError **error)
 		g_prefix_error(error, "Failed to load config: ");
 		return FALSE;
 	}
+	fu_engine_ensure_context_flags(self);
 
 	/* read remotes */
 	if (flags & FU_ENGINE_LOAD_FLAG_REMOTES) {
@@ -6712,9 +8022,6 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, GError **error)
 		}
 	}
 
-	/* create client certificate */
-	fu_engine_ensure_client_certificate(self);
-
 	/* get hardcoded approved and blocked firmware */
 	checksums_approved = fu_config_get_approved_firmware(self->config);
 	for (guint i = 0; i < checksums_approved->len; i++) {
@@ -6764,10 +8071,7 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, GError **error)
 		g_prefix_error(error, "Failed to load AppStream data: ");
 		return FALSE;
 	}
-
-	/* watch the local.d directories for changes */
-	if (!fu_engine_load_local_metadata_watches(self, error))
-		return FALSE;
+	fu_engine_set_subsystem_ready(self, FU_ENGINE_SUBSYSTEM_REMOTES);
 
 	/* add the "built-in" firmware types */
 	fu_context_add_firmware_gtype(self->ctx, "raw", FU_TYPE_FIRMWARE);
@@ -6776,6 +8080,7 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, GError **error)
 	fu_context_add_firmware_gtype(self->ctx, "fmap", FU_TYPE_FMAP_FIRMWARE);
 	fu_context_add_firmware_gtype(self->ctx, "ihex", FU_TYPE_IHEX_FIRMWARE);
 	fu_context_add_firmware_gtype(self->ctx, "srec", FU_TYPE_SREC_FIRMWARE);
+	fu_context_add_firmware_gtype(self->ctx, "sfdp", FU_TYPE_SFDP_FIRMWARE);
 	fu_context_add_firmware_gtype(self->ctx, "archive", FU_TYPE_ARCHIVE_FIRMWARE);
 	fu_context_add_firmware_gtype(self->ctx, "smbios", FU_TYPE_SMBIOS);
 	fu_context_add_firmware_gtype(self->ctx, "efi-firmware-file", FU_TYPE_EFI_FIRMWARE_FILE);
@@ -6800,6 +8105,8 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, GError **error)
 		for (guint i = 0; i < self->backends->len; i++) {
 			FuBackend *backend = g_ptr_array_index(self->backends, i);
 			g_autoptr(GError) error_backend = NULL;
+			if (!fu_backend_get_enabled(backend))
+				continue;
 			if (!fu_backend_setup(backend, &error_backend)) {
 				g_debug("failed to setup backend %s: %s",
 					fu_backend_get_name(backend),
@@ -6817,12 +8124,6 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, GError **error)
 		}
 	}
 
-	/* delete old data files */
-	if (!fu_engine_cleanup_state(error)) {
-		g_prefix_error(error, "Failed to clean up: ");
-		return FALSE;
-	}
-
 	/* load plugin */
 	if (!fu_engine_load_plugins(self, error)) {
 		g_prefix_error(error, "Failed to load plugins: ");
@@ -6888,9 +8189,18 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, GError **error)
 		}
 	}
 
-	/* update the db for devices that were updated during the reboot */
-	if (!fu_engine_update_history_database(self, error))
-		return FALSE;
+	fu_engine_set_subsystem_ready(self, FU_ENGINE_SUBSYSTEM_DEVICES);
+
+	/* the daemon loads everything else once it is answering requests */
+	if ((flags & FU_ENGINE_LOAD_FLAG_STAGED) == 0) {
+		const FuEngineSubsystem subsystems[] = {FU_ENGINE_SUBSYSTEM_HISTORY,
+							FU_ENGINE_SUBSYSTEM_LOCAL_METADATA,
+							FU_ENGINE_SUBSYSTEM_CERTIFICATE};
+		for (guint i = 0; i < G_N_ELEMENTS(subsystems); i++) {
+			if (!fu_engine_ensure_subsystem(self, subsystems[i], error))
+				return FALSE;
+		}
+	}
 
 	fu_engine_set_status(self, FWUPD_STATUS_IDLE);
 	self->loaded = TRUE;
@@ -6898,6 +8208,9 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, GError **error)
 	/* let clients know engine finished starting up */
 	fu_engine_emit_changed(self);
 
+	/* get any upgrades ready while nothing else is happening */
+	fu_engine_prefetch_schedule(self);
+
 	/* success */
 	return TRUE;
 }
@@ -7010,6 +8323,21 @@ fu_engine_class_init(FuEngineClass *klass)
 						      G_TYPE_NONE,
 						      1,
 						      G_TYPE_UINT);
+	/**
+	 * FuEngine::subsystems-changed:
+	 * @self: the #FuEngine instance that emitted the signal
+	 *
+	 * The ::subsystems-changed signal is emitted when another subsystem has finished loading.
+	 **/
+	signals[SIGNAL_SUBSYSTEMS_CHANGED] = g_signal_new("subsystems-changed",
+							  G_TYPE_FROM_CLASS(object_class),
+							  G_SIGNAL_RUN_LAST,
+							  0,
+							  NULL,
+							  NULL,
+							  g_cclosure_marshal_VOID__VOID,
+							  G_TYPE_NONE,
+							  0);
 }
 
 void
@@ -7053,6 +8381,7 @@ fu_engine_init(FuEngine *self)
 	struct utsname uname_tmp;
 #endif
 	g_autofree gchar *keyring_path = NULL;
+	g_autofree gchar *keyring_path_prefetch = NULL;
 	g_autofree gchar *pkidir_fw = NULL;
 	g_autofree gchar *pkidir_md = NULL;
 	g_autofree gchar *sysconfdir = NULL;
@@ -7063,12 +8392,29 @@ fu_engine_init(FuEngine *self)
 	self->device_list = fu_device_list_new();
 	self->ctx = fu_context_new();
 	self->idle = fu_idle_new();
+	self->statistics = fu_statistics_new();
 	self->history = fu_history_new();
 	self->plugin_list = fu_plugin_list_new();
 	self->plugin_filter = g_ptr_array_new_with_free_func(g_free);
 	self->host_security_attrs = fu_security_attrs_new();
+	self->host_security_attrs_plugin =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_object_unref);
+	self->host_security_attrs_stale =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_object_unref);
+	self->host_security_attrs_running =
+	    g_hash_table_new_full(g_str_hash,
+				  g_str_equal,
+				  g_free,
+				  (GDestroyNotify)fu_engine_security_attrs_helper_unref);
+	self->host_security_timings = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	self->host_security_disabled = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	self->backends = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	self->local_monitors = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	self->prefetch_queue = g_ptr_array_new_with_free_func(g_free);
+	self->prefetch_items = g_hash_table_new_full(g_str_hash,
+						     g_str_equal,
+						     g_free,
+						     (GDestroyNotify)fu_engine_prefetch_item_free);
 	self->runtime_versions = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	self->compile_versions = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 
@@ -7079,6 +8425,10 @@ fu_engine_init(FuEngine *self)
 			 "security-changed",
 			 G_CALLBACK(fu_engine_context_security_changed_cb),
 			 self);
+	g_signal_connect(FU_CONTEXT(self->ctx),
+			 "security-changed-full",
+			 G_CALLBACK(fu_engine_context_security_changed_full_cb),
+			 self);
 	g_signal_connect(FU_CONTEXT(self->ctx),
 			 "notify::battery-state",
 			 G_CALLBACK(fu_engine_context_battery_changed_cb),
@@ -7109,6 +8459,10 @@ fu_engine_init(FuEngine *self)
 			 "notify::status",
 			 G_CALLBACK(fu_engine_idle_status_notify_cb),
 			 self);
+	g_signal_connect(FU_IDLE(self->idle),
+			 "notify::inhibited",
+			 G_CALLBACK(fu_engine_idle_inhibited_notify_cb),
+			 self);
 
 	/* backends */
 #ifdef HAVE_GUSB
@@ -7132,6 +8486,13 @@ fu_engine_init(FuEngine *self)
 	pkidir_md = g_build_filename(sysconfdir, "pki", "fwupd-metadata", NULL);
 	jcat_context_add_public_keys(self->jcat_context, pkidir_md);
 
+	/* the prefetch thread needs its own context, and keyring, with the same keys */
+	self->prefetch_jcat_context = jcat_context_new();
+	keyring_path_prefetch = g_build_filename(keyring_path, "prefetch", NULL);
+	jcat_context_set_keyring_path(self->prefetch_jcat_context, keyring_path_prefetch);
+	jcat_context_add_public_keys(self->prefetch_jcat_context, pkidir_fw);
+	jcat_context_add_public_keys(self->prefetch_jcat_context, pkidir_md);
+
 	/* add some runtime versions of things the daemon depends on */
 	fu_engine_add_runtime_version(self, "org.freedesktop.fwupd", VERSION);
 #if G_USB_CHECK_VERSION(0, 3, 1)
@@ -7183,6 +8544,10 @@ fu_engine_finalize(GObject *obj)
 		g_object_unref(self->query_component_by_guid);
 	if (self->coldplug_id != 0)
 		g_source_remove(self->coldplug_id);
+	if (self->deferred_id != 0)
+		g_source_remove(self->deferred_id);
+	if (self->prefetch_id != 0)
+		g_source_remove(self->prefetch_id);
 	if (self->approved_firmware != NULL)
 		g_hash_table_unref(self->approved_firmware);
 	if (self->blocked_firmware != NULL)
@@ -7191,16 +8556,25 @@ fu_engine_finalize(GObject *obj)
 	g_free(self->host_machine_id);
 	g_free(self->host_security_id);
 	g_object_unref(self->host_security_attrs);
+	g_hash_table_unref(self->host_security_attrs_plugin);
+	g_hash_table_unref(self->host_security_attrs_stale);
+	g_hash_table_unref(self->host_security_attrs_running);
+	g_hash_table_unref(self->host_security_timings);
+	g_hash_table_unref(self->host_security_disabled);
 	g_object_unref(self->idle);
+	g_object_unref(self->statistics);
 	g_object_unref(self->config);
 	g_object_unref(self->remote_list);
 	g_object_unref(self->ctx);
 	g_object_unref(self->history);
 	g_object_unref(self->device_list);
 	g_object_unref(self->jcat_context);
+	g_object_unref(self->prefetch_jcat_context);
 	g_ptr_array_unref(self->plugin_filter);
 	g_ptr_array_unref(self->backends);
 	g_ptr_array_unref(self->local_monitors);
+	g_ptr_array_unref(self->prefetch_queue);
+	g_hash_table_unref(self->prefetch_items);
 	g_hash_table_unref(self->runtime_versions);
 	g_hash_table_unref(self->compile_versions);
 	g_object_unref(self->plugin_list);
@@ -18,6 +18,7 @@
 #include "fu-plugin.h"
 #include "fu-release.h"
 #include "fu-security-attrs.h"
+#include "fu-statistics.h"
 
 #define FU_TYPE_ENGINE (fu_engine_get_type())
 G_DECLARE_FINAL_TYPE(FuEngine, fu_engine, FU, ENGINE, GObject)
@@ -30,6 +31,7 @@ G_DECLARE_FINAL_TYPE(FuEngine, fu_engine, FU, ENGINE, GObject)
  * @FU_ENGINE_LOAD_FLAG_REMOTES:	Enumerate remotes
  * @FU_ENGINE_LOAD_FLAG_HWINFO:		Load details about the hardware
  * @FU_ENGINE_LOAD_FLAG_NO_CACHE:	Do not save persistent xmlb silos
+ * @FU_ENGINE_LOAD_FLAG_STAGED:		Leave non-critical subsystems for fu_engine_load_deferred()
  *
  * The flags to use when loading the engine.
  **/
@@ -40,20 +42,58 @@ typedef enum {
 	FU_ENGINE_LOAD_FLAG_REMOTES = 1 << 2,
 	FU_ENGINE_LOAD_FLAG_HWINFO = 1 << 3,
 	FU_ENGINE_LOAD_FLAG_NO_CACHE = 1 << 4,
+	FU_ENGINE_LOAD_FLAG_STAGED = 1 << 5,
 	/*< private >*/
 	FU_ENGINE_LOAD_FLAG_LAST
 } FuEngineLoadFlags;
 
+/**
+ * FuEngineSubsystem:
+ * @FU_ENGINE_SUBSYSTEM_NONE:		No subsystems
+ * @FU_ENGINE_SUBSYSTEM_REMOTES:	Remotes and metadata are loaded
+ * @FU_ENGINE_SUBSYSTEM_DEVICES:	Plugins are loaded and devices enumerated
+ * @FU_ENGINE_SUBSYSTEM_HISTORY:	Updates that completed during the reboot are recorded
+ * @FU_ENGINE_SUBSYSTEM_LOCAL_METADATA:	The `local.d` directories are watched for changes
+ * @FU_ENGINE_SUBSYSTEM_CERTIFICATE:	The client certificate has been created
+ * @FU_ENGINE_SUBSYSTEM_SECURITY:	The host security attributes have been calculated
+ *
+ * The parts of the engine that may become ready after the daemon starts answering requests.
+ **/
+typedef enum {
+	FU_ENGINE_SUBSYSTEM_NONE = 0,
+	FU_ENGINE_SUBSYSTEM_REMOTES = 1 << 0,
+	FU_ENGINE_SUBSYSTEM_DEVICES = 1 << 1,
+	FU_ENGINE_SUBSYSTEM_HISTORY = 1 << 2,
+	FU_ENGINE_SUBSYSTEM_LOCAL_METADATA = 1 << 3,
+	FU_ENGINE_SUBSYSTEM_CERTIFICATE = 1 << 4,
+	FU_ENGINE_SUBSYSTEM_SECURITY = 1 << 5,
+	/*< private >*/
+	FU_ENGINE_SUBSYSTEM_LAST
+} FuEngineSubsystem;
+
+const gchar *
+fu_engine_subsystem_to_string(FuEngineSubsystem subsystem);
+
 FuEngine *
 fu_engine_new(FuAppFlags app_flags);
 void
 fu_engine_add_app_flag(FuEngine *self, FuAppFlags app_flags);
 void
 fu_engine_add_plugin_filter(FuEngine *self, const gchar *plugin_glob);
+gboolean
+fu_engine_emulation_load(FuEngine *self, const gchar *filename, GError **error);
+gboolean
+fu_engine_emulation_save(FuEngine *self, const gchar *filename, GError **error);
 void
 fu_engine_idle_reset(FuEngine *self);
 gboolean
 fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, GError **error);
+void
+fu_engine_load_deferred(FuEngine *self);
+gboolean
+fu_engine_ensure_subsystem(FuEngine *self, FuEngineSubsystem subsystem, GError **error);
+FuEngineSubsystem
+fu_engine_get_subsystems_ready(FuEngine *self);
 gboolean
 fu_engine_load_plugins(FuEngine *self, GError **error);
 gboolean
@@ -112,7 +152,7 @@ fu_engine_get_results(FuEngine *self, const gchar *device_id, GError **error);
 FuSecurityAttrs *
 fu_engine_get_host_security_attrs(FuEngine *self);
 FuSecurityAttrs *
-fu_engine_get_host_security_events(FuEngine *self, guint limit, GError **error);
+fu_engine_get_host_security_events(FuEngine *self, guint limit, guint offset, GError **error);
 GHashTable *
 fu_engine_get_report_metadata(FuEngine *self, GError **error);
 gboolean
@@ -205,6 +245,8 @@ gboolean
 fu_engine_modify_config(FuEngine *self, const gchar *key, const gchar *value, GError **error);
 FuContext *
 fu_engine_get_context(FuEngine *engine);
+FuStatistics *
+fu_engine_get_statistics(FuEngine *self);
 void
 fu_engine_md_refresh_device_from_component(FuEngine *self, FuDevice *device, XbNode *component);
 GPtrArray *
@@ -229,6 +271,12 @@ fu_engine_check_requirements(FuEngine *self,
 			     GError **error);
 void
 fu_engine_set_silo(FuEngine *self, XbSilo *silo);
+void
+fu_engine_set_host_security_timeout(FuEngine *self, guint host_security_timeout);
+gboolean
+fu_engine_prefetch_device(FuEngine *self, const gchar *device_id, GError **error);
+gsize
+fu_engine_get_prefetch_size(FuEngine *self);
 XbNode *
 fu_engine_get_component_by_guids(FuEngine *self, FuDevice *device);
 gboolean
@@ -26,7 +26,10 @@
 #include "fu-mutex.h"
 #include "fu-security-attr.h"
 
-#define FU_HISTORY_CURRENT_SCHEMA_VERSION 7
+#define FU_HISTORY_CURRENT_SCHEMA_VERSION 9
+
+/* only the latest profile of each plugin and device type is kept, so this is plenty */
+#define FU_HISTORY_PROGRESS_PROFILES_MAX_ROWS 1024
 
 static void
 fu_history_finalize(GObject *object);
@@ -161,6 +164,170 @@ fu_history_stmt_exec(FuHistory *self, sqlite3_stmt *stmt, GPtrArray *array, GErr
 	return TRUE;
 }
 
+static guint64
+fu_history_timestamp_to_unix(const gchar *timestamp)
+{
+	g_autoptr(GDateTime) created_dt = NULL;
+	g_autoptr(GTimeZone) tz_utc = g_time_zone_new_utc();
+
+	created_dt = g_date_time_new_from_iso8601(timestamp, tz_utc);
+	if (created_dt == NULL)
+		return 0;
+	return g_date_time_to_unix(created_dt);
+}
+
+static FuSecurityAttrs *
+fu_history_security_attrs_from_json_string(const gchar *json, GError **error)
+{
+	g_autoptr(FuSecurityAttrs) attrs = fu_security_attrs_new();
+	g_autoptr(JsonParser) parser = json_parser_new();
+
+	if (!json_parser_load_from_data(parser, json, -1, error))
+		return NULL;
+	if (!fu_security_attrs_from_json(attrs, json_parser_get_root(parser), error))
+		return NULL;
+	return g_steal_pointer(&attrs);
+}
+
+static gchar *
+fu_history_security_attr_to_json_string(FwupdSecurityAttr *attr)
+{
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+	g_autoptr(JsonGenerator) json_generator = json_generator_new();
+	g_autoptr(JsonNode) json_root = NULL;
+
+	json_builder_begin_object(builder);
+	fwupd_security_attr_to_json(attr, builder);
+	json_builder_end_object(builder);
+	json_root = json_builder_get_root(builder);
+	json_generator_set_root(json_generator, json_root);
+	return json_generator_to_data(json_generator, NULL);
+}
+
+/* snapshots are content-addressed so identical attribute sets are only stored once */
+static gboolean
+fu_history_add_security_snapshot(FuHistory *self,
+				 const gchar *checksum,
+				 const gchar *json,
+				 GError **error)
+{
+	gint rc;
+	g_autoptr(sqlite3_stmt) stmt = NULL;
+
+	rc = sqlite3_prepare_v2(self->db,
+				"INSERT OR IGNORE INTO hsi_snapshots (checksum, hsi_details) "
+				"VALUES (?1, ?2);",
+				-1,
+				&stmt,
+				NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to prepare SQL to write security snapshot: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	sqlite3_bind_text(stmt, 1, checksum, -1, SQLITE_STATIC);
+	sqlite3_bind_text(stmt, 2, json, -1, SQLITE_STATIC);
+	return fu_history_stmt_exec(self, stmt, NULL, error);
+}
+
+/* only the attributes that differ between the two snapshots are stored */
+static gboolean
+fu_history_add_security_events(FuHistory *self,
+			       FuSecurityAttrs *attrs_old,
+			       FuSecurityAttrs *attrs_new,
+			       const gchar *checksum_old,
+			       const gchar *checksum_new,
+			       const gchar *timestamp,
+			       GError **error)
+{
+	gint rc;
+	g_autoptr(GPtrArray) diffs = fu_security_attrs_compare(attrs_old, attrs_new);
+	g_autoptr(sqlite3_stmt) stmt = NULL;
+
+	if (diffs->len == 0)
+		return TRUE;
+	rc = sqlite3_prepare_v2(self->db,
+				"INSERT INTO hsi_events (timestamp, checksum_old, checksum_new, "
+				"appstream_id, event) "
+				"VALUES (COALESCE(?1, CURRENT_TIMESTAMP), ?2, ?3, ?4, ?5);",
+				-1,
+				&stmt,
+				NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to prepare SQL to write security event: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	for (guint i = 0; i < diffs->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(diffs, i);
+		g_autofree gchar *json = fu_history_security_attr_to_json_string(attr);
+		sqlite3_reset(stmt);
+		sqlite3_clear_bindings(stmt);
+		sqlite3_bind_text(stmt, 1, timestamp, -1, SQLITE_STATIC);
+		sqlite3_bind_text(stmt, 2, checksum_old, -1, SQLITE_STATIC);
+		sqlite3_bind_text(stmt, 3, checksum_new, -1, SQLITE_STATIC);
+		sqlite3_bind_text(stmt,
+				  4,
+				  fwupd_security_attr_get_appstream_id(attr),
+				  -1,
+				  SQLITE_STATIC);
+		sqlite3_bind_text(stmt, 5, json, -1, SQLITE_STATIC);
+		if (!fu_history_stmt_exec(self, stmt, NULL, error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/* the caller must hold the database lock */
+static gboolean
+fu_history_get_security_snapshot_latest(FuHistory *self,
+					gchar **checksum,
+					gchar **json,
+					GError **error)
+{
+	gint rc;
+	g_autoptr(sqlite3_stmt) stmt = NULL;
+
+	rc = sqlite3_prepare_v2(self->db,
+				"SELECT s.checksum, s.hsi_details FROM hsi_history h "
+				"JOIN hsi_snapshots s ON h.checksum = s.checksum "
+				"ORDER BY h.timestamp DESC, h.rowid DESC LIMIT 1;",
+				-1,
+				&stmt,
+				NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to prepare SQL to get security snapshot: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	rc = sqlite3_step(stmt);
+	if (rc == SQLITE_ROW) {
+		*checksum = g_strdup((const gchar *)sqlite3_column_text(stmt, 0));
+		*json = g_strdup((const gchar *)sqlite3_column_text(stmt, 1));
+		return TRUE;
+	}
+	if (rc != SQLITE_DONE) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_READ,
+			    "failed to execute prepared statement: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+
+	/* no snapshots yet */
+	return TRUE;
+}
+
 static gboolean
 fu_history_create_database(FuHistory *self, GError **error)
 {
@@ -195,7 +362,33 @@ fu_history_create_database(FuHistory *self, GError **error)
 			  "CREATE TABLE IF NOT EXISTS hsi_history ("
 			  "timestamp TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
 			  "hsi_details TEXT DEFAULT NULL,"
-			  "hsi_score TEXT DEFAULT NULL);"
+			  "hsi_score TEXT DEFAULT NULL,"
+			  "checksum TEXT DEFAULT NULL);"
+			  "CREATE TABLE IF NOT EXISTS hsi_snapshots ("
+			  "checksum TEXT PRIMARY KEY,"
+			  "hsi_details TEXT NOT NULL);"
+			  "CREATE TABLE IF NOT EXISTS hsi_events ("
+			  "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+			  "timestamp TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
+			  "checksum_old TEXT DEFAULT NULL,"
+			  "checksum_new TEXT DEFAULT NULL,"
+			  "appstream_id TEXT DEFAULT NULL,"
+			  "event TEXT DEFAULT NULL);"
+			  "CREATE INDEX IF NOT EXISTS hsi_history_timestamp "
+			  "ON hsi_history(timestamp);"
+			  "CREATE INDEX IF NOT EXISTS hsi_events_timestamp "
+			  "ON hsi_events(timestamp);"
+			  "CREATE TABLE IF NOT EXISTS progress_profiles ("
+			  "plugin TEXT NOT NULL,"
+			  "device_type TEXT NOT NULL,"
+			  "created INTEGER DEFAULT 0,"
+			  "step INTEGER DEFAULT 0,"
+			  "steps INTEGER DEFAULT 0,"
+			  "status INTEGER DEFAULT 0,"
+			  "duration REAL DEFAULT 0,"
+			  "bytes INTEGER DEFAULT 0);"
+			  "CREATE INDEX IF NOT EXISTS progress_profiles_plugin "
+			  "ON progress_profiles(plugin, device_type);"
 			  "COMMIT;",
 			  NULL,
 			  NULL,
@@ -343,6 +536,165 @@ fu_history_migrate_database_v6(FuHistory *self, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_history_migrate_database_v7(FuHistory *self, GError **error)
+{
+	gint rc;
+	g_autofree gchar *checksum_old = NULL;
+	g_autoptr(FuSecurityAttrs) attrs_old = NULL;
+	g_autoptr(GArray) rowids = g_array_new(FALSE, FALSE, sizeof(gint64));
+	g_autoptr(GPtrArray) timestamps = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(GPtrArray) jsons = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(sqlite3_stmt) stmt = NULL;
+	g_autoptr(sqlite3_stmt) stmt_update = NULL;
+
+	rc = sqlite3_exec(self->db,
+			  "ALTER TABLE hsi_history ADD COLUMN checksum TEXT DEFAULT NULL;"
+			  "CREATE TABLE IF NOT EXISTS hsi_snapshots ("
+			  "checksum TEXT PRIMARY KEY,"
+			  "hsi_details TEXT NOT NULL);"
+			  "CREATE TABLE IF NOT EXISTS hsi_events ("
+			  "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+			  "timestamp TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
+			  "checksum_old TEXT DEFAULT NULL,"
+			  "checksum_new TEXT DEFAULT NULL,"
+			  "appstream_id TEXT DEFAULT NULL,"
+			  "event TEXT DEFAULT NULL);"
+			  "CREATE INDEX IF NOT EXISTS hsi_history_timestamp "
+			  "ON hsi_history(timestamp);"
+			  "CREATE INDEX IF NOT EXISTS hsi_events_timestamp "
+			  "ON hsi_events(timestamp);",
+			  NULL,
+			  NULL,
+			  NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to alter database: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+
+	/* read all the full snapshots before modifying the table */
+	rc = sqlite3_prepare_v2(self->db,
+				"SELECT rowid, timestamp, hsi_details FROM hsi_history "
+				"WHERE hsi_details IS NOT NULL ORDER BY timestamp ASC, rowid ASC;",
+				-1,
+				&stmt,
+				NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to prepare SQL to get security attrs: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+		gint64 rowid = sqlite3_column_int64(stmt, 0);
+		g_array_append_val(rowids, rowid);
+		g_ptr_array_add(timestamps, g_strdup((const gchar *)sqlite3_column_text(stmt, 1)));
+		g_ptr_array_add(jsons, g_strdup((const gchar *)sqlite3_column_text(stmt, 2)));
+	}
+	if (rc != SQLITE_DONE) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_READ,
+			    "failed to execute prepared statement: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	if (jsons->len == 0)
+		return TRUE;
+
+	/* convert each snapshot into a content-addressed reference and a set of deltas */
+	g_debug("migrating %u HSI snapshots", jsons->len);
+	rc = sqlite3_prepare_v2(self->db,
+				"UPDATE hsi_history SET checksum = ?1, hsi_details = NULL "
+				"WHERE rowid = ?2;",
+				-1,
+				&stmt_update,
+				NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to prepare SQL to update security attrs: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	for (guint i = 0; i < jsons->len; i++) {
+		const gchar *json = g_ptr_array_index(jsons, i);
+		const gchar *timestamp = g_ptr_array_index(timestamps, i);
+		g_autofree gchar *checksum = NULL;
+		g_autoptr(FuSecurityAttrs) attrs = NULL;
+		g_autoptr(GError) error_local = NULL;
+
+		checksum = g_compute_checksum_for_string(G_CHECKSUM_SHA256, json, -1);
+		if (!fu_history_add_security_snapshot(self, checksum, json, error))
+			return FALSE;
+		sqlite3_reset(stmt_update);
+		sqlite3_bind_text(stmt_update, 1, checksum, -1, SQLITE_STATIC);
+		sqlite3_bind_int64(stmt_update, 2, g_array_index(rowids, gint64, i));
+		if (!fu_history_stmt_exec(self, stmt_update, NULL, error))
+			return FALSE;
+
+		/* the deltas are best effort */
+		attrs = fu_history_security_attrs_from_json_string(json, &error_local);
+		if (attrs == NULL) {
+			g_debug("ignoring invalid snapshot %s: %s",
+				timestamp,
+				error_local->message);
+			continue;
+		}
+		if (attrs_old != NULL && g_strcmp0(checksum_old, checksum) != 0) {
+			if (!fu_history_add_security_events(self,
+							    attrs_old,
+							    attrs,
+							    checksum_old,
+							    checksum,
+							    timestamp,
+							    error))
+				return FALSE;
+		}
+		g_set_object(&attrs_old, attrs);
+		g_free(checksum_old);
+		checksum_old = g_steal_pointer(&checksum);
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_history_migrate_database_v8(FuHistory *self, GError **error)
+{
+	gint rc;
+	rc = sqlite3_exec(self->db,
+			  "CREATE TABLE IF NOT EXISTS progress_profiles ("
+			  "plugin TEXT NOT NULL,"
+			  "device_type TEXT NOT NULL,"
+			  "created INTEGER DEFAULT 0,"
+			  "step INTEGER DEFAULT 0,"
+			  "steps INTEGER DEFAULT 0,"
+			  "status INTEGER DEFAULT 0,"
+			  "duration REAL DEFAULT 0,"
+			  "bytes INTEGER DEFAULT 0);"
+			  "CREATE INDEX IF NOT EXISTS progress_profiles_plugin "
+			  "ON progress_profiles(plugin, device_type);",
+			  NULL,
+			  NULL,
+			  NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to create table: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	return TRUE;
+}
+
 /* returns 0 if database is not initialized */
 static guint
 fu_history_get_schema_version(FuHistory *self)
@@ -403,6 +755,14 @@ fu_history_create_or_migrate(FuHistory *self, guint schema_ver, GError **error)
 	case 6:
 		if (!fu_history_migrate_database_v6(self, error))
 			return FALSE;
+	/* fall through */
+	case 7:
+		if (!fu_history_migrate_database_v7(self, error))
+			return FALSE;
+	/* fall through */
+	case 8:
+		if (!fu_history_migrate_database_v8(self, error))
+			return FALSE;
 		break;
 	default:
 		/* this is probably okay, but return an error if we ever delete
@@ -1325,26 +1685,103 @@ fu_history_add_blocked_firmware(FuHistory *self, const gchar *checksum, GError *
 #endif
 }
 
+/**
+ * fu_history_add_security_attribute:
+ * @self: a #FuHistory
+ * @attrs: a #FuSecurityAttrs
+ * @hsi_score: the HSI string, e.g. `HSI:1`
+ * @error: (nullable): optional return location for an error
+ *
+ * Adds a snapshot of the security attributes to the history database.
+ * Snapshots are stored by content checksum so identical sets are only saved once,
+ * and only the differences from the previous snapshot are recorded as events.
+ * Nothing is written if the attributes are unchanged since the last snapshot.
+ *
+ * Returns: #TRUE for success, #FALSE for failure
+ *
+ * Since: 1.7.1
+ **/
 gboolean
 fu_history_add_security_attribute(FuHistory *self,
-				  const gchar *security_attr_json,
+				  FuSecurityAttrs *attrs,
 				  const gchar *hsi_score,
 				  GError **error)
 {
 #ifdef HAVE_SQLITE
 	gint rc;
+	g_autofree gchar *checksum = NULL;
+	g_autofree gchar *checksum_old = NULL;
+	g_autofree gchar *json = NULL;
+	g_autofree gchar *json_old = NULL;
+	g_autoptr(FuSecurityAttrs) attrs_old = NULL;
 	g_autoptr(sqlite3_stmt) stmt = NULL;
 	g_autoptr(GRWLockWriterLocker) locker = NULL;
+
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+	g_return_val_if_fail(FU_IS_SECURITY_ATTRS(attrs), FALSE);
+
+	/* convert attrs to json string */
+	json = fu_security_attrs_to_json_string(attrs, error);
+	if (json == NULL) {
+		g_prefix_error(error, "cannot convert current attrs to string: ");
+		return FALSE;
+	}
+	checksum = g_compute_checksum_for_string(G_CHECKSUM_SHA256, json, -1);
 
 	/* lazy load */
 	if (!fu_history_load(self, error))
 		return FALSE;
-	/* remove entries */
+
+	/* check that we did not store this already last boot */
 	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
+	if (!fu_history_get_security_snapshot_latest(self, &checksum_old, &json_old, error))
+		return FALSE;
+	if (g_strcmp0(checksum_old, checksum) == 0) {
+		g_debug("skipping writing HSI attrs to database as unchanged");
+		return TRUE;
+	}
+	if (json_old != NULL) {
+		g_autoptr(GError) error_local = NULL;
+		attrs_old = fu_history_security_attrs_from_json_string(json_old, &error_local);
+		if (attrs_old == NULL) {
+			g_debug("ignoring invalid snapshot %s: %s",
+				checksum_old,
+				error_local->message);
+		} else if (fu_security_attrs_equal(attrs_old, attrs)) {
+			g_debug("skipping writing HSI attrs to database as unchanged");
+			return TRUE;
+		}
+	}
+
+	/* write snapshot, deltas and the new entry atomically */
+	rc = sqlite3_exec(self->db, "BEGIN TRANSACTION;", NULL, NULL, NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to begin transaction: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	if (!fu_history_add_security_snapshot(self, checksum, json, error)) {
+		sqlite3_exec(self->db, "ROLLBACK;", NULL, NULL, NULL);
+		return FALSE;
+	}
+	if (attrs_old != NULL) {
+		if (!fu_history_add_security_events(self,
+						    attrs_old,
+						    attrs,
+						    checksum_old,
+						    checksum,
+						    NULL,
+						    error)) {
+			sqlite3_exec(self->db, "ROLLBACK;", NULL, NULL, NULL);
+			return FALSE;
+		}
+	}
 	rc = sqlite3_prepare_v2(self->db,
-				"INSERT INTO hsi_history (hsi_details, hsi_score)"
+				"INSERT INTO hsi_history (hsi_score, checksum)"
 				"VALUES (?1, ?2)",
 				-1,
 				&stmt,
@@ -1355,11 +1792,25 @@ fu_history_add_security_attribute(FuHistory *self,
 			    FWUPD_ERROR_INTERNAL,
 			    "Failed to prepare SQL to write security attribute: %s",
 			    sqlite3_errmsg(self->db));
+		sqlite3_exec(self->db, "ROLLBACK;", NULL, NULL, NULL);
 		return FALSE;
 	}
-	sqlite3_bind_text(stmt, 1, security_attr_json, -1, SQLITE_STATIC);
-	sqlite3_bind_text(stmt, 2, hsi_score, -1, SQLITE_STATIC);
-	return fu_history_stmt_exec(self, stmt, NULL, error);
+	sqlite3_bind_text(stmt, 1, hsi_score, -1, SQLITE_STATIC);
+	sqlite3_bind_text(stmt, 2, checksum, -1, SQLITE_STATIC);
+	if (!fu_history_stmt_exec(self, stmt, NULL, error)) {
+		sqlite3_exec(self->db, "ROLLBACK;", NULL, NULL, NULL);
+		return FALSE;
+	}
+	rc = sqlite3_exec(self->db, "COMMIT;", NULL, NULL, NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_WRITE,
+			    "Failed to commit transaction: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	return TRUE;
 #else
 	g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no sqlite support");
 	return FALSE;
@@ -1386,7 +1837,7 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 #ifdef HAVE_SQLITE
 	g_autoptr(sqlite3_stmt) stmt = NULL;
 	gint rc;
-	guint old_hash = 0;
+	g_autofree gchar *checksum_old = NULL;
 	g_autoptr(GRWLockReaderLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
@@ -1397,12 +1848,13 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 			return NULL;
 	}
 
-	/* get all the devices */
+	/* get all the snapshots */
 	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
 	rc = sqlite3_prepare_v2(self->db,
-				"SELECT timestamp, hsi_details FROM hsi_history "
-				"ORDER BY timestamp DESC;",
+				"SELECT h.timestamp, s.checksum, s.hsi_details FROM hsi_history h "
+				"JOIN hsi_snapshots s ON h.checksum = s.checksum "
+				"ORDER BY h.timestamp DESC, h.rowid DESC;",
 				-1,
 				&stmt,
 				NULL);
@@ -1415,44 +1867,36 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 		return NULL;
 	}
 	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+		const gchar *checksum;
 		const gchar *json;
-		guint hash;
 		const gchar *timestamp;
-		g_autoptr(FuSecurityAttrs) attrs = fu_security_attrs_new();
-		g_autoptr(JsonParser) parser = NULL;
-		g_autoptr(GDateTime) created_dt = NULL;
-		g_autoptr(GTimeZone) tz_utc = g_time_zone_new_utc();
+		guint64 created_unix;
+		g_autoptr(FuSecurityAttrs) attrs = NULL;
 
 		/* old */
 		timestamp = (const gchar *)sqlite3_column_text(stmt, 0);
 		if (timestamp == NULL)
 			continue;
 
-		/* device_id */
-		json = (const gchar *)sqlite3_column_text(stmt, 1);
-		if (json == NULL)
-			continue;
-
 		/* do not create dups */
-		hash = g_str_hash(json);
-		if (hash == old_hash) {
+		checksum = (const gchar *)sqlite3_column_text(stmt, 1);
+		if (g_strcmp0(checksum, checksum_old) == 0) {
 			g_debug("skipping %s as unchanged", timestamp);
 			continue;
 		}
-		old_hash = hash;
+		g_free(checksum_old);
+		checksum_old = g_strdup(checksum);
 
 		/* parse JSON */
-		parser = json_parser_new();
+		json = (const gchar *)sqlite3_column_text(stmt, 2);
 		g_debug("parsing %s", timestamp);
-		if (!json_parser_load_from_data(parser, json, -1, error))
-			return NULL;
-		if (!fu_security_attrs_from_json(attrs, json_parser_get_root(parser), error))
+		attrs = fu_history_security_attrs_from_json_string(json, error);
+		if (attrs == NULL)
 			return NULL;
 
 		/* parse timestamp */
-		created_dt = g_date_time_new_from_iso8601(timestamp, tz_utc);
-		if (created_dt != NULL) {
-			guint64 created_unix = g_date_time_to_unix(created_dt);
+		created_unix = fu_history_timestamp_to_unix(timestamp);
+		if (created_unix != 0) {
 			g_autoptr(GPtrArray) attr_array = fu_security_attrs_get_all(attrs);
 			for (guint i = 0; i < attr_array->len; i++) {
 				FwupdSecurityAttr *attr = g_ptr_array_index(attr_array, i);
@@ -1479,6 +1923,356 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 	return g_steal_pointer(&array);
 }
 
+/**
+ * fu_history_get_security_events:
+ * @self: a #FuHistory
+ * @limit: maximum number of events to return, or 0 for no limit
+ * @offset: number of newer events to skip, typically used for pagination
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the security attribute changes recorded in the history database, newest first.
+ *
+ * Returns: (element-type #FwupdSecurityAttr) (transfer container): attrs
+ *
+ * Since: 1.8.0
+ **/
+GPtrArray *
+fu_history_get_security_events(FuHistory *self, guint limit, guint offset, GError **error)
+{
+	g_autoptr(GPtrArray) array = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+#ifdef HAVE_SQLITE
+	g_autoptr(sqlite3_stmt) stmt = NULL;
+	gint rc;
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
+
+	/* lazy load */
+	if (self->db == NULL) {
+		if (!fu_history_load(self, error))
+			return NULL;
+	}
+
+	/* get the page of events */
+	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
+	g_return_val_if_fail(locker != NULL, NULL);
+	rc = sqlite3_prepare_v2(self->db,
+				"SELECT timestamp, event FROM hsi_events "
+				"ORDER BY timestamp DESC, id ASC LIMIT ?1 OFFSET ?2;",
+				-1,
+				&stmt,
+				NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to prepare SQL to get security events: %s",
+			    sqlite3_errmsg(self->db));
+		return NULL;
+	}
+	sqlite3_bind_int64(stmt, 1, limit > 0 ? (gint64)limit : -1);
+	sqlite3_bind_int64(stmt, 2, offset);
+	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+		const gchar *json;
+		const gchar *timestamp;
+		g_autoptr(FwupdSecurityAttr) attr = fwupd_security_attr_new(NULL);
+		g_autoptr(JsonParser) parser = json_parser_new();
+
+		timestamp = (const gchar *)sqlite3_column_text(stmt, 0);
+		json = (const gchar *)sqlite3_column_text(stmt, 1);
+		if (timestamp == NULL || json == NULL)
+			continue;
+		if (!json_parser_load_from_data(parser, json, -1, error))
+			return NULL;
+		if (!fwupd_security_attr_from_json(attr, json_parser_get_root(parser), error))
+			return NULL;
+		fwupd_security_attr_set_created(attr, fu_history_timestamp_to_unix(timestamp));
+		g_ptr_array_add(array, g_steal_pointer(&attr));
+	}
+	if (rc != SQLITE_DONE) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_WRITE,
+			    "failed to execute prepared statement: %s",
+			    sqlite3_errmsg(self->db));
+		return NULL;
+	}
+#endif
+	return g_steal_pointer(&array);
+}
+
+static gboolean
+fu_history_exec_progress_profile_sql(FuHistory *self,
+				     const gchar *sql,
+				     const gchar *plugin,
+				     const gchar *device_type,
+				     GError **error)
+{
+	gint rc;
+	g_autoptr(sqlite3_stmt) stmt = NULL;
+
+	rc = sqlite3_prepare_v2(self->db, sql, -1, &stmt, NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to prepare SQL to delete progress profiles: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	if (plugin != NULL)
+		sqlite3_bind_text(stmt, 1, plugin, -1, SQLITE_STATIC);
+	if (device_type != NULL)
+		sqlite3_bind_text(stmt, 2, device_type, -1, SQLITE_STATIC);
+	return fu_history_stmt_exec(self, stmt, NULL, error);
+}
+
+static gboolean
+fu_history_add_progress_profile_steps(FuHistory *self,
+				      const gchar *plugin,
+				      const gchar *device_type,
+				      FuProgress *progress,
+				      GError **error)
+{
+	gint rc;
+	guint steps = fu_progress_get_steps(progress);
+	gint64 created = g_get_real_time() / G_USEC_PER_SEC;
+	g_autoptr(sqlite3_stmt) stmt = NULL;
+
+	/* only the latest profile is ever used */
+	if (!fu_history_exec_progress_profile_sql(
+		self,
+		"DELETE FROM progress_profiles WHERE plugin = ?1 AND device_type = ?2;",
+		plugin,
+		device_type,
+		error))
+		return FALSE;
+
+	rc = sqlite3_prepare_v2(self->db,
+				"INSERT INTO progress_profiles (plugin, device_type, created, "
+				"step, steps, status, duration, bytes) "
+				"VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8)",
+				-1,
+				&stmt,
+				NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to prepare SQL to insert progress profile: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	for (guint i = 0; i < steps; i++) {
+		sqlite3_reset(stmt);
+		sqlite3_bind_text(stmt, 1, plugin, -1, SQLITE_STATIC);
+		sqlite3_bind_text(stmt, 2, device_type, -1, SQLITE_STATIC);
+		sqlite3_bind_int64(stmt, 3, created);
+		sqlite3_bind_int(stmt, 4, i);
+		sqlite3_bind_int(stmt, 5, steps);
+		sqlite3_bind_int(stmt, 6, fu_progress_get_step_status(progress, i));
+		sqlite3_bind_double(stmt, 7, fu_progress_get_step_duration(progress, i));
+		sqlite3_bind_int64(stmt, 8, fu_progress_get_step_bytes(progress, i));
+		if (!fu_history_stmt_exec(self, stmt, NULL, error))
+			return FALSE;
+	}
+
+	/* drop the oldest rows; a profile left incomplete is not loaded as the steps differ */
+	return fu_history_exec_progress_profile_sql(
+	    self,
+	    "DELETE FROM progress_profiles WHERE rowid NOT IN "
+	    "(SELECT rowid FROM progress_profiles ORDER BY rowid DESC "
+	    "LIMIT " G_STRINGIFY(FU_HISTORY_PROGRESS_PROFILES_MAX_ROWS) ");",
+	    NULL,
+	    NULL,
+	    error);
+}
+
+/**
+ * fu_history_add_progress_profile:
+ * @self: a #FuHistory
+ * @device: a #FuDevice
+ * @progress: a #FuProgress with completed weighted steps
+ * @error: (nullable): optional return location for an error
+ *
+ * Records how long each step of a device update took, and how many bytes were transferred.
+ * The profile is shared by all devices of the same type from the same plugin, and replaces
+ * any profile recorded before.
+ *
+ * Returns: #TRUE for success, #FALSE for failure
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fu_history_add_progress_profile(FuHistory *self,
+				FuDevice *device,
+				FuProgress *progress,
+				GError **error)
+{
+#ifdef HAVE_SQLITE
+	gint rc;
+	g_autoptr(GRWLockWriterLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
+	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
+
+	/* nothing to record */
+	if (fu_progress_get_steps(progress) == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOTHING_TO_DO,
+				    "no steps to record");
+		return FALSE;
+	}
+	if (fu_device_get_plugin(device) == NULL) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "no plugin set for device");
+		return FALSE;
+	}
+
+	/* lazy load */
+	if (!fu_history_load(self, error))
+		return FALSE;
+
+	/* replace the profile atomically */
+	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	g_return_val_if_fail(locker != NULL, FALSE);
+	rc = sqlite3_exec(self->db, "BEGIN TRANSACTION;", NULL, NULL, NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to begin transaction: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	if (!fu_history_add_progress_profile_steps(self,
+						   fu_device_get_plugin(device),
+						   G_OBJECT_TYPE_NAME(device),
+						   progress,
+						   error)) {
+		sqlite3_exec(self->db, "ROLLBACK;", NULL, NULL, NULL);
+		return FALSE;
+	}
+	rc = sqlite3_exec(self->db, "COMMIT;", NULL, NULL, NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_WRITE,
+			    "Failed to commit transaction: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	return TRUE;
+#else
+	g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no sqlite support");
+	return FALSE;
+#endif
+}
+
+/**
+ * fu_history_load_progress_profile:
+ * @self: a #FuHistory
+ * @device: a #FuDevice
+ * @progress: a #FuProgress with weighted steps that have not yet been started
+ * @error: (nullable): optional return location for an error
+ *
+ * Sets the step weights using the durations recorded for the last update of a device of the
+ * same type from the same plugin, if the steps are the same as before.
+ *
+ * Returns: #TRUE if the weights were changed
+ *
+ * Since: 1.8.0
+ **/
+gboolean
+fu_history_load_progress_profile(FuHistory *self,
+				 FuDevice *device,
+				 FuProgress *progress,
+				 GError **error)
+{
+#ifdef HAVE_SQLITE
+	gint rc;
+	guint steps;
+	g_autoptr(GArray) durations = g_array_new(FALSE, FALSE, sizeof(gdouble));
+	g_autoptr(sqlite3_stmt) stmt = NULL;
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
+	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
+
+	/* lazy load */
+	if (self->db == NULL) {
+		if (!fu_history_load(self, error))
+			return FALSE;
+	}
+
+	/* there is only ever one profile */
+	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
+	g_return_val_if_fail(locker != NULL, FALSE);
+	rc = sqlite3_prepare_v2(self->db,
+				"SELECT step, steps, status, duration FROM progress_profiles "
+				"WHERE plugin = ?1 AND device_type = ?2 ORDER BY step ASC;",
+				-1,
+				&stmt,
+				NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to prepare SQL to get progress profile: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	sqlite3_bind_text(stmt, 1, fu_device_get_plugin(device), -1, SQLITE_STATIC);
+	sqlite3_bind_text(stmt, 2, G_OBJECT_TYPE_NAME(device), -1, SQLITE_STATIC);
+	steps = fu_progress_get_steps(progress);
+	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+		gdouble duration = sqlite3_column_double(stmt, 3);
+		if ((guint)sqlite3_column_int(stmt, 0) != durations->len ||
+		    (guint)sqlite3_column_int(stmt, 1) != steps ||
+		    (FwupdStatus)sqlite3_column_int(stmt, 2) !=
+			fu_progress_get_step_status(progress, durations->len)) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_NOT_FOUND,
+					    "progress steps have changed");
+			return FALSE;
+		}
+		g_array_append_val(durations, duration);
+	}
+	if (rc != SQLITE_DONE) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_WRITE,
+			    "failed to execute prepared statement: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	if (durations->len == 0 || durations->len != steps) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_FOUND,
+			    "no progress profile for %s",
+			    G_OBJECT_TYPE_NAME(device));
+		return FALSE;
+	}
+
+	/* use ms as the weighting, but do not allow a step to have no weight */
+	for (guint i = 0; i < durations->len; i++) {
+		gdouble duration = g_array_index(durations, gdouble, i);
+		fu_progress_set_step_value(progress, i, MAX((guint)(duration * 1000), 1));
+	}
+	return TRUE;
+#else
+	g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no sqlite support");
+	return FALSE;
+#endif
+}
+
 static void
 fu_history_class_init(FuHistoryClass *klass)
 {
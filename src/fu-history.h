@@ -48,8 +48,20 @@ GPtrArray *
 fu_history_get_blocked_firmware(FuHistory *self, GError **error);
 gboolean
 fu_history_add_security_attribute(FuHistory *self,
-				  const gchar *security_attr_json,
+				  FuSecurityAttrs *attrs,
 				  const gchar *hsi_score,
 				  GError **error);
 GPtrArray *
 fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error);
+GPtrArray *
+fu_history_get_security_events(FuHistory *self, guint limit, guint offset, GError **error);
+gboolean
+fu_history_add_progress_profile(FuHistory *self,
+				FuDevice *device,
+				FuProgress *progress,
+				GError **error);
+gboolean
+fu_history_load_progress_profile(FuHistory *self,
+				 FuDevice *device,
+				 FuProgress *progress,
+				 GError **error);
@@ -25,7 +25,7 @@ struct _FuIdle {
 	FwupdStatus status;
 };
 
-enum { PROP_0, PROP_STATUS, PROP_LAST };
+enum { PROP_0, PROP_STATUS, PROP_INHIBITED, PROP_LAST };
 
 static void
 fu_idle_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
@@ -35,6 +35,9 @@ fu_idle_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *
 	case PROP_STATUS:
 		g_value_set_uint(value, self->status);
 		break;
+	case PROP_INHIBITED:
+		g_value_set_boolean(value, fu_idle_has_inhibit(self));
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
 		break;
@@ -111,34 +114,43 @@ fu_idle_reset(FuIdle *self)
 		fu_idle_start(self);
 }
 
-void
-fu_idle_uninhibit(FuIdle *self, guint32 token)
+static gboolean
+fu_idle_remove_item(FuIdle *self, guint32 token)
 {
 	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new(&self->items_mutex);
 
-	g_return_if_fail(FU_IS_IDLE(self));
-	g_return_if_fail(token != 0);
-	g_return_if_fail(locker != NULL);
+	g_return_val_if_fail(locker != NULL, FALSE);
 
 	for (guint i = 0; i < self->items->len; i++) {
 		FuIdleItem *item = g_ptr_array_index(self->items, i);
 		if (item->token == token) {
 			g_debug("uninhibiting: %s", item->reason);
 			g_ptr_array_remove_index(self->items, i);
-			break;
+			fu_idle_reset(self);
+			return TRUE;
 		}
 	}
 	fu_idle_reset(self);
+	return FALSE;
 }
 
-guint32
-fu_idle_inhibit(FuIdle *self, const gchar *reason)
+void
+fu_idle_uninhibit(FuIdle *self, guint32 token)
+{
+	g_return_if_fail(FU_IS_IDLE(self));
+	g_return_if_fail(token != 0);
+
+	/* notify without the lock held, so that handlers can query the state */
+	if (fu_idle_remove_item(self, token))
+		g_object_notify(G_OBJECT(self), "inhibited");
+}
+
+static guint32
+fu_idle_add_item(FuIdle *self, const gchar *reason)
 {
 	FuIdleItem *item;
 	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new(&self->items_mutex);
 
-	g_return_val_if_fail(FU_IS_IDLE(self), 0);
-	g_return_val_if_fail(reason != NULL, 0);
 	g_return_val_if_fail(locker != NULL, 0);
 
 	g_debug("inhibiting: %s", reason);
@@ -150,6 +162,28 @@ fu_idle_inhibit(FuIdle *self, const gchar *reason)
 	return item->token;
 }
 
+guint32
+fu_idle_inhibit(FuIdle *self, const gchar *reason)
+{
+	guint32 token;
+
+	g_return_val_if_fail(FU_IS_IDLE(self), 0);
+	g_return_val_if_fail(reason != NULL, 0);
+
+	token = fu_idle_add_item(self, reason);
+	g_object_notify(G_OBJECT(self), "inhibited");
+	return token;
+}
+
+gboolean
+fu_idle_has_inhibit(FuIdle *self)
+{
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new(&self->items_mutex);
+	g_return_val_if_fail(FU_IS_IDLE(self), FALSE);
+	g_return_val_if_fail(locker != NULL, FALSE);
+	return self->items->len > 0;
+}
+
 void
 fu_idle_set_timeout(FuIdle *self, guint timeout)
 {
@@ -208,6 +242,18 @@ fu_idle_class_init(FuIdleClass *klass)
 				  FWUPD_STATUS_UNKNOWN,
 				  G_PARAM_READABLE | G_PARAM_STATIC_NAME);
 	g_object_class_install_property(object_class, PROP_STATUS, pspec);
+
+	/**
+	 * FuIdle:inhibited:
+	 *
+	 * If anything is inhibiting the idle monitor.
+	 */
+	pspec = g_param_spec_boolean("inhibited",
+				     NULL,
+				     NULL,
+				     FALSE,
+				     G_PARAM_READABLE | G_PARAM_STATIC_NAME);
+	g_object_class_install_property(object_class, PROP_INHIBITED, pspec);
 }
 
 static void
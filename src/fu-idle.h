@@ -20,6 +20,8 @@ guint32
 fu_idle_inhibit(FuIdle *self, const gchar *reason);
 void
 fu_idle_uninhibit(FuIdle *self, guint32 token);
+gboolean
+fu_idle_has_inhibit(FuIdle *self);
 void
 fu_idle_set_timeout(FuIdle *self, guint timeout);
 void
@@ -35,13 +35,16 @@
 #include "fwupd-request-private.h"
 #include "fwupd-resources.h"
 #include "fwupd-security-attr-private.h"
+#include "fwupd-statistic-private.h"
 
 #include "fu-common.h"
 #include "fu-debug.h"
 #include "fu-device-private.h"
+#include "fu-efivar.h"
 #include "fu-engine.h"
 #include "fu-release.h"
 #include "fu-security-attrs-private.h"
+#include "fu-trace-private.h"
 
 #ifdef HAVE_POLKIT
 #ifndef HAVE_POLKIT_0_114
@@ -53,6 +56,9 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC(PolkitSubject, g_object_unref)
 #endif /* HAVE_POLKIT_0_114 */
 #endif /* HAVE_POLKIT */
 
+/* clients only need a few updates a second */
+#define FU_MAIN_PROGRESS_THROTTLE 100 /* ms */
+
 typedef enum {
 	FU_MAIN_MACHINE_KIND_UNKNOWN,
 	FU_MAIN_MACHINE_KIND_PHYSICAL,
@@ -84,6 +90,10 @@ typedef struct {
 	gboolean update_in_progress;
 	gboolean pending_sigterm;
 	FuMainMachineKind machine_kind;
+	guint eta;
+	guint64 throughput;
+	guint64 efivar_cache_hits;   /* already added to the statistics */
+	guint64 efivar_cache_misses; /* already added to the statistics */
 } FuMainPrivate;
 
 static FuMainMachineKind
@@ -235,6 +245,31 @@ fu_main_set_status(FuMainPrivate *priv, FwupdStatus status)
 	fu_main_emit_property_changed(priv, "Status", g_variant_new_uint32(status));
 }
 
+static GVariant *
+fu_main_ready_subsystems_to_variant(FuMainPrivate *priv)
+{
+	FuEngineSubsystem subsystems = fu_engine_get_subsystems_ready(priv->engine);
+	GVariantBuilder builder;
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("as"));
+	for (guint i = 0; (1u << i) < FU_ENGINE_SUBSYSTEM_LAST; i++) {
+		FuEngineSubsystem subsystem = 1u << i;
+		if (subsystems & subsystem)
+			g_variant_builder_add(&builder,
+					      "s",
+					      fu_engine_subsystem_to_string(subsystem));
+	}
+	return g_variant_builder_end(&builder);
+}
+
+static void
+fu_main_engine_subsystems_changed_cb(FuEngine *engine, FuMainPrivate *priv)
+{
+	fu_main_emit_property_changed(priv,
+				      "ReadySubsystems",
+				      fu_main_ready_subsystems_to_variant(priv));
+}
+
 static void
 fu_main_engine_status_changed_cb(FuEngine *engine, FwupdStatus status, FuMainPrivate *priv)
 {
@@ -359,6 +394,18 @@ fu_main_remote_array_to_variant(GPtrArray *remotes)
 	return g_variant_new("(aa{sv})", &builder);
 }
 
+static GVariant *
+fu_main_statistic_array_to_variant(GPtrArray *statistics)
+{
+	GVariantBuilder builder;
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+	for (guint i = 0; i < statistics->len; i++) {
+		FwupdStatistic *statistic = g_ptr_array_index(statistics, i);
+		g_variant_builder_add_value(&builder, fwupd_statistic_to_variant(statistic));
+	}
+	return g_variant_new("(aa{sv})", &builder);
+}
+
 static GVariant *
 fu_main_result_array_to_variant(GPtrArray *results)
 {
@@ -634,6 +681,12 @@ fu_main_progress_percentage_changed_cb(FuProgress *progress, guint percentage, F
 {
 	g_debug("Emitting PropertyChanged('Percentage'='%u%%')", percentage);
 	fu_main_emit_property_changed(priv, "Percentage", g_variant_new_uint32(percentage));
+
+	/* also saved for GetProperty */
+	priv->eta = fu_progress_get_eta(progress);
+	priv->throughput = fu_progress_get_throughput(progress);
+	fu_main_emit_property_changed(priv, "Eta", g_variant_new_uint32(priv->eta));
+	fu_main_emit_property_changed(priv, "Throughput", g_variant_new_uint64(priv->throughput));
 }
 
 static void
@@ -661,6 +714,7 @@ fu_main_authorize_activate_cb(GObject *source, GAsyncResult *res, gpointer user_
 
 	/* progress */
 	fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
+	fu_progress_set_throttle(progress, FU_MAIN_PROGRESS_THROTTLE);
 	g_signal_connect(FU_PROGRESS(progress),
 			 "percentage-changed",
 			 G_CALLBACK(fu_main_progress_percentage_changed_cb),
@@ -705,6 +759,7 @@ fu_main_authorize_verify_update_cb(GObject *source, GAsyncResult *res, gpointer
 
 	/* progress */
 	fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
+	fu_progress_set_throttle(progress, FU_MAIN_PROGRESS_THROTTLE);
 	g_signal_connect(FU_PROGRESS(progress),
 			 "percentage-changed",
 			 G_CALLBACK(fu_main_progress_percentage_changed_cb),
@@ -814,6 +869,7 @@ fu_main_authorize_install_queue(FuMainAuthHelper *helper_ref)
 
 	/* all authenticated, so install all the things */
 	fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
+	fu_progress_set_throttle(progress, FU_MAIN_PROGRESS_THROTTLE);
 	g_signal_connect(FU_PROGRESS(progress),
 			 "percentage-changed",
 			 G_CALLBACK(fu_main_progress_percentage_changed_cb),
@@ -1106,14 +1162,14 @@ fu_main_schedule_process_quit(FuMainPrivate *priv)
 }
 
 static void
-fu_main_daemon_method_call(GDBusConnection *connection,
-			   const gchar *sender,
-			   const gchar *object_path,
-			   const gchar *interface_name,
-			   const gchar *method_name,
-			   GVariant *parameters,
-			   GDBusMethodInvocation *invocation,
-			   gpointer user_data)
+fu_main_daemon_method_call_internal(GDBusConnection *connection,
+				    const gchar *sender,
+				    const gchar *object_path,
+				    const gchar *interface_name,
+				    const gchar *method_name,
+				    GVariant *parameters,
+				    GDBusMethodInvocation *invocation,
+				    gpointer user_data)
 {
 	FuMainPrivate *priv = (FuMainPrivate *)user_data;
 	GVariant *val = NULL;
@@ -1133,6 +1189,13 @@ fu_main_daemon_method_call(GDBusConnection *connection,
 	if (g_strcmp0(method_name, "GetDevices") == 0) {
 		g_autoptr(GPtrArray) devices = NULL;
 		g_debug("Called %s()", method_name);
+		/* devices updated during the reboot need their update state */
+		if (!fu_engine_ensure_subsystem(priv->engine,
+						FU_ENGINE_SUBSYSTEM_HISTORY,
+						&error)) {
+			g_dbus_method_invocation_return_gerror(invocation, error);
+			return;
+		}
 		devices = fu_engine_get_devices(priv->engine, &error);
 		if (devices == NULL) {
 			g_dbus_method_invocation_return_gerror(invocation, error);
@@ -1215,6 +1278,31 @@ fu_main_daemon_method_call(GDBusConnection *connection,
 		g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
 		return;
 	}
+	if (g_strcmp0(method_name, "GetStatistics") == 0) {
+		FuStatistics *stats = fu_engine_get_statistics(priv->engine);
+		guint64 efivar_hits = 0;
+		guint64 efivar_misses = 0;
+		g_autoptr(GPtrArray) statistics = NULL;
+
+		/* the efivar cache is process-wide, so only add what changed since last asked */
+		fu_efivar_get_cache_stats(&efivar_hits, &efivar_misses);
+		fu_statistics_add_counter(stats,
+					  "fwupd_efivar_cache_reads",
+					  "result",
+					  "hit",
+					  efivar_hits - priv->efivar_cache_hits);
+		fu_statistics_add_counter(stats,
+					  "fwupd_efivar_cache_reads",
+					  "result",
+					  "miss",
+					  efivar_misses - priv->efivar_cache_misses);
+		priv->efivar_cache_hits = efivar_hits;
+		priv->efivar_cache_misses = efivar_misses;
+		statistics = fu_statistics_get_all(stats);
+		val = fu_main_statistic_array_to_variant(statistics);
+		g_dbus_method_invocation_return_value(invocation, val);
+		return;
+	}
 	if (g_strcmp0(method_name, "SetApprovedFirmware") == 0) {
 		g_autofree gchar *checksums_str = NULL;
 		g_auto(GStrv) checksums = NULL;
@@ -1375,6 +1463,13 @@ fu_main_daemon_method_call(GDBusConnection *connection,
 			g_dbus_method_invocation_return_gerror(invocation, error);
 			return;
 		}
+		/* a reboot may be pending for devices updated during the reboot */
+		if (!fu_engine_ensure_subsystem(priv->engine,
+						FU_ENGINE_SUBSYSTEM_HISTORY,
+						&error)) {
+			g_dbus_method_invocation_return_gerror(invocation, error);
+			return;
+		}
 		releases = fu_engine_get_upgrades(priv->engine, request, device_id, &error);
 		if (releases == NULL) {
 			g_dbus_method_invocation_return_gerror(invocation, error);
@@ -1435,18 +1530,23 @@ fu_main_daemon_method_call(GDBusConnection *connection,
 #endif
 		return;
 	}
-	if (g_strcmp0(method_name, "GetHostSecurityEvents") == 0) {
+	if (g_strcmp0(method_name, "GetHostSecurityEvents") == 0 ||
+	    g_strcmp0(method_name, "GetHostSecurityEventsFull") == 0) {
 		guint limit = 0;
+		guint offset = 0;
 		g_autoptr(FuSecurityAttrs) attrs = NULL;
-		g_variant_get(parameters, "(u)", &limit);
-		g_debug("Called %s(%u)", method_name, limit);
+		if (g_variant_is_of_type(parameters, G_VARIANT_TYPE("(uu)")))
+			g_variant_get(parameters, "(uu)", &limit, &offset);
+		else
+			g_variant_get(parameters, "(u)", &limit);
+		g_debug("Called %s(%u,%u)", method_name, limit, offset);
 #ifndef HAVE_HSI
 		g_dbus_method_invocation_return_error_literal(invocation,
 							      FWUPD_ERROR,
 							      FWUPD_ERROR_NOT_SUPPORTED,
 							      "HSI support not enabled");
 #else
-		attrs = fu_engine_get_host_security_events(priv->engine, limit, &error);
+		attrs = fu_engine_get_host_security_events(priv->engine, limit, offset, &error);
 		if (attrs == NULL) {
 			g_dbus_method_invocation_return_gerror(invocation, error);
 			return;
@@ -1735,6 +1835,7 @@ fu_main_daemon_method_call(GDBusConnection *connection,
 
 		/* progress */
 		fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
+		fu_progress_set_throttle(progress, FU_MAIN_PROGRESS_THROTTLE);
 		g_signal_connect(FU_PROGRESS(progress),
 				 "percentage-changed",
 				 G_CALLBACK(fu_main_progress_percentage_changed_cb),
@@ -1916,6 +2017,37 @@ fu_main_daemon_method_call(GDBusConnection *connection,
 	g_dbus_method_invocation_return_gerror(invocation, error);
 }
 
+static void
+fu_main_daemon_method_call(GDBusConnection *connection,
+			   const gchar *sender,
+			   const gchar *object_path,
+			   const gchar *interface_name,
+			   const gchar *method_name,
+			   GVariant *parameters,
+			   GDBusMethodInvocation *invocation,
+			   gpointer user_data)
+{
+	FuMainPrivate *priv = (FuMainPrivate *)user_data;
+	gint64 start = g_get_monotonic_time();
+
+	/* for async methods this only measures the time taken to dispatch the request */
+	FU_TRACE2(dbus_method_entry, method_name, sender);
+	fu_main_daemon_method_call_internal(connection,
+					    sender,
+					    object_path,
+					    interface_name,
+					    method_name,
+					    parameters,
+					    invocation,
+					    user_data);
+	FU_TRACE2(dbus_method_exit, method_name, sender);
+	fu_statistics_add_duration(fu_engine_get_statistics(priv->engine),
+				   "fwupd_dbus_method_duration_microseconds",
+				   "method",
+				   method_name,
+				   g_get_monotonic_time() - start);
+}
+
 static GVariant *
 fu_main_daemon_get_property(GDBusConnection *connection_,
 			    const gchar *sender,
@@ -1977,6 +2109,15 @@ fu_main_daemon_get_property(GDBusConnection *connection_,
 	if (g_strcmp0(property_name, "OnlyTrusted") == 0)
 		return g_variant_new_boolean(fu_engine_get_only_trusted(priv->engine));
 
+	if (g_strcmp0(property_name, "ReadySubsystems") == 0)
+		return fu_main_ready_subsystems_to_variant(priv);
+
+	if (g_strcmp0(property_name, "Eta") == 0)
+		return g_variant_new_uint32(priv->eta);
+
+	if (g_strcmp0(property_name, "Throughput") == 0)
+		return g_variant_new_uint64(priv->throughput);
+
 	/* return an error */
 	g_set_error(error,
 		    G_DBUS_ERROR,
@@ -2033,7 +2174,11 @@ fu_main_dbus_bus_acquired_cb(GDBusConnection *connection, const gchar *name, gpo
 static void
 fu_main_dbus_name_acquired_cb(GDBusConnection *connection, const gchar *name, gpointer user_data)
 {
+	FuMainPrivate *priv = (FuMainPrivate *)user_data;
 	g_debug("acquired name: %s", name);
+
+	/* clients can now talk to us, so load everything that was not required to reply */
+	fu_engine_load_deferred(priv->engine);
 }
 
 static void
@@ -2296,9 +2441,13 @@ main(int argc, char *argv[])
 			 "status-changed",
 			 G_CALLBACK(fu_main_engine_status_changed_cb),
 			 priv);
+	g_signal_connect(FU_ENGINE(priv->engine),
+			 "subsystems-changed",
+			 G_CALLBACK(fu_main_engine_subsystems_changed_cb),
+			 priv);
 	if (!fu_engine_load(priv->engine,
 			    FU_ENGINE_LOAD_FLAG_COLDPLUG | FU_ENGINE_LOAD_FLAG_HWINFO |
-				FU_ENGINE_LOAD_FLAG_REMOTES,
+				FU_ENGINE_LOAD_FLAG_REMOTES | FU_ENGINE_LOAD_FLAG_STAGED,
 			    &error)) {
 		g_printerr("Failed to load engine: %s\n", error->message);
 		return EXIT_FAILURE;
@@ -2365,6 +2514,7 @@ main(int argc, char *argv[])
 				 "new-connection",
 				 G_CALLBACK(fu_main_dbus_new_connection_cb),
 				 priv);
+		fu_engine_load_deferred(priv->engine);
 	} else {
 		priv->owner_id = g_bus_own_name(G_BUS_TYPE_SYSTEM,
 						FWUPD_DBUS_SERVICE,
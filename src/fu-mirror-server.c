@@ -0,0 +1,1026 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define G_LOG_DOMAIN "FuMirrorServer"
+
+#include "config.h"
+
+#include <gio/gio.h>
+#include <glib/gstdio.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef HAVE_SENDFILE
+#include <sys/sendfile.h>
+#endif
+
+#include "fu-mirror-server.h"
+
+/* each connection uses one thread for as long as it is open */
+#define FU_MIRROR_SERVER_THREADS_MAX 16
+
+/* so that one host cannot use all of the threads */
+#define FU_MIRROR_SERVER_CONNECTIONS_PER_PEER_MAX 4
+
+/* idle keep-alive connections are closed after this long */
+#define FU_MIRROR_SERVER_IDLE_TIMEOUT 5 /* s */
+
+/* the whole request has to arrive in this time, however slowly it is sent */
+#define FU_MIRROR_SERVER_REQUEST_TIMEOUT 10 /* s */
+
+/* a stalled client is disconnected after this long when sending the response */
+#define FU_MIRROR_SERVER_TIMEOUT 30 /* s */
+
+/* requests with more headers than this are refused */
+#define FU_MIRROR_SERVER_HEADERS_MAX 64
+
+/* requests for missing files only rescan the directory this often */
+#define FU_MIRROR_SERVER_RESCAN_INTERVAL 5 /* s */
+
+struct _FuMirrorServer {
+	GObject parent_instance;
+	gchar *path;
+	GSocketService *service;
+	guint16 port;
+	GRWLock items_mutex;	       /* for @items_by_basename and @items_by_checksum */
+	GHashTable *items_by_basename; /* (element-type utf8 FuMirrorServerItem) */
+	GHashTable *items_by_checksum; /* (element-type utf8 FuMirrorServerItem) */
+	GMutex rescan_mutex;	       /* for @rescan_last */
+	gint64 rescan_last;	       /* monotonic, us */
+	GMutex peers_mutex;	       /* for @peers */
+	GHashTable *peers;	       /* (element-type utf8 guint): address to connections */
+};
+
+typedef struct {
+	gchar *filename;
+	gchar *basename;
+	gchar *checksum_sha1;
+	gchar *checksum_sha256; /* also used as the ETag */
+	gchar *checksum_sha512;
+	guint64 size;
+	gint64 mtime;
+	gboolean content_addressed; /* looked up using the checksum */
+} FuMirrorServerItem;
+
+typedef struct {
+	gchar *method;
+	gchar *path;
+	gboolean keep_alive;
+	GHashTable *headers; /* (element-type utf8 utf8): lowercase name to value */
+} FuMirrorServerRequest;
+
+typedef enum {
+	FU_MIRROR_SERVER_RANGE_IGNORE,
+	FU_MIRROR_SERVER_RANGE_VALID,
+	FU_MIRROR_SERVER_RANGE_UNSATISFIABLE,
+} FuMirrorServerRange;
+
+G_DEFINE_TYPE(FuMirrorServer, fu_mirror_server, G_TYPE_OBJECT)
+
+static void
+fu_mirror_server_item_free(FuMirrorServerItem *item)
+{
+	g_free(item->filename);
+	g_free(item->basename);
+	g_free(item->checksum_sha1);
+	g_free(item->checksum_sha256);
+	g_free(item->checksum_sha512);
+	g_free(item);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuMirrorServerItem, fu_mirror_server_item_free)
+
+static FuMirrorServerItem *
+fu_mirror_server_item_copy(FuMirrorServerItem *item)
+{
+	FuMirrorServerItem *item_new = g_new0(FuMirrorServerItem, 1);
+	item_new->filename = g_strdup(item->filename);
+	item_new->basename = g_strdup(item->basename);
+	item_new->checksum_sha1 = g_strdup(item->checksum_sha1);
+	item_new->checksum_sha256 = g_strdup(item->checksum_sha256);
+	item_new->checksum_sha512 = g_strdup(item->checksum_sha512);
+	item_new->size = item->size;
+	item_new->mtime = item->mtime;
+	return item_new;
+}
+
+static void
+fu_mirror_server_swap_tables(GHashTable **a, GHashTable **b)
+{
+	GHashTable *tmp = *a;
+	*a = *b;
+	*b = tmp;
+}
+
+static gboolean
+fu_mirror_server_item_ensure_checksums(FuMirrorServerItem *item, GError **error)
+{
+	guint8 buf[32 * 1024];
+	g_autoptr(GChecksum) csum_sha1 = g_checksum_new(G_CHECKSUM_SHA1);
+	g_autoptr(GChecksum) csum_sha256 = g_checksum_new(G_CHECKSUM_SHA256);
+	g_autoptr(GChecksum) csum_sha512 = g_checksum_new(G_CHECKSUM_SHA512);
+	g_autoptr(GFile) file = g_file_new_for_path(item->filename);
+	g_autoptr(GFileInputStream) stream = NULL;
+
+	/* cabinets can be large, so do not load them into memory */
+	stream = g_file_read(file, NULL, error);
+	if (stream == NULL)
+		return FALSE;
+	for (;;) {
+		gssize rc;
+		rc = g_input_stream_read(G_INPUT_STREAM(stream), buf, sizeof(buf), NULL, error);
+		if (rc < 0)
+			return FALSE;
+		if (rc == 0)
+			break;
+		g_checksum_update(csum_sha1, buf, rc);
+		g_checksum_update(csum_sha256, buf, rc);
+		g_checksum_update(csum_sha512, buf, rc);
+	}
+	item->checksum_sha1 = g_strdup(g_checksum_get_string(csum_sha1));
+	item->checksum_sha256 = g_strdup(g_checksum_get_string(csum_sha256));
+	item->checksum_sha512 = g_strdup(g_checksum_get_string(csum_sha512));
+	return TRUE;
+}
+
+/* files that have not changed are not hashed again, and new files are hashed without holding
+ * the lock so that lookups are not blocked by a large cabinet being added */
+static gboolean
+fu_mirror_server_rescan(FuMirrorServer *self, GError **error)
+{
+	const gchar *fn;
+	g_autoptr(GDir) dir = NULL;
+	g_autoptr(GHashTable) items_by_basename = NULL;
+	g_autoptr(GHashTable) items_by_checksum = NULL;
+	g_autoptr(GRWLockWriterLocker) locker = NULL;
+
+	dir = g_dir_open(self->path, 0, error);
+	if (dir == NULL)
+		return FALSE;
+	items_by_basename = g_hash_table_new_full(g_str_hash,
+						  g_str_equal,
+						  NULL,
+						  (GDestroyNotify)fu_mirror_server_item_free);
+	items_by_checksum = g_hash_table_new(g_str_hash, g_str_equal);
+	while ((fn = g_dir_read_name(dir)) != NULL) {
+		FuMirrorServerItem *item = NULL;
+		FuMirrorServerItem *item_old;
+		GStatBuf st = {0};
+		g_autofree gchar *filename = NULL;
+		g_autoptr(GError) error_local = NULL;
+
+		/* hidden files and partial downloads */
+		if (fn[0] == '.' || g_str_has_suffix(fn, ".part"))
+			continue;
+		filename = g_build_filename(self->path, fn, NULL);
+		if (!g_file_test(filename, G_FILE_TEST_IS_REGULAR))
+			continue;
+		if (g_stat(filename, &st) != 0)
+			continue;
+		g_rw_lock_reader_lock(&self->items_mutex);
+		item_old = g_hash_table_lookup(self->items_by_basename, fn);
+		if (item_old != NULL && item_old->size == (guint64)st.st_size &&
+		    item_old->mtime == (gint64)st.st_mtime)
+			item = fu_mirror_server_item_copy(item_old);
+		g_rw_lock_reader_unlock(&self->items_mutex);
+		if (item == NULL) {
+			item = g_new0(FuMirrorServerItem, 1);
+			item->filename = g_steal_pointer(&filename);
+			item->basename = g_strdup(fn);
+			item->size = st.st_size;
+			item->mtime = st.st_mtime;
+			if (!fu_mirror_server_item_ensure_checksums(item, &error_local)) {
+				g_warning("ignoring %s: %s", fn, error_local->message);
+				fu_mirror_server_item_free(item);
+				continue;
+			}
+			g_debug("added %s with SHA256 %s", fn, item->checksum_sha256);
+		}
+		g_hash_table_insert(items_by_basename, item->basename, item);
+		g_hash_table_insert(items_by_checksum, item->checksum_sha1, item);
+		g_hash_table_insert(items_by_checksum, item->checksum_sha256, item);
+		g_hash_table_insert(items_by_checksum, item->checksum_sha512, item);
+	}
+
+	/* only swap the tables with the writer lock held, and free the old items after */
+	locker = g_rw_lock_writer_locker_new(&self->items_mutex);
+	fu_mirror_server_swap_tables(&self->items_by_checksum, &items_by_checksum);
+	fu_mirror_server_swap_tables(&self->items_by_basename, &items_by_basename);
+	g_clear_pointer(&locker, g_rw_lock_writer_locker_free);
+	return TRUE;
+}
+
+/* the caller must hold a lock */
+static FuMirrorServerItem *
+fu_mirror_server_lookup_locked(FuMirrorServer *self, const gchar *path)
+{
+	FuMirrorServerItem *item;
+	GStatBuf st = {0};
+
+	if (g_str_has_prefix(path, "/checksum/")) {
+		g_autofree gchar *checksum = g_ascii_strdown(path + 10, -1);
+		item = g_hash_table_lookup(self->items_by_checksum, checksum);
+	} else {
+		item = g_hash_table_lookup(self->items_by_basename, path + 1);
+	}
+	if (item == NULL)
+		return NULL;
+
+	/* deleted or replaced since the last scan */
+	if (g_stat(item->filename, &st) != 0)
+		return NULL;
+	if (item->size != (guint64)st.st_size || item->mtime != (gint64)st.st_mtime)
+		return NULL;
+	item = fu_mirror_server_item_copy(item);
+	item->content_addressed = g_str_has_prefix(path, "/checksum/");
+	return item;
+}
+
+static gboolean
+fu_mirror_server_rescan_is_due(FuMirrorServer *self)
+{
+	gint64 now = g_get_monotonic_time();
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->rescan_mutex);
+	if (now - self->rescan_last < FU_MIRROR_SERVER_RESCAN_INTERVAL * G_USEC_PER_SEC)
+		return FALSE;
+	self->rescan_last = now;
+	return TRUE;
+}
+
+static FuMirrorServerItem *
+fu_mirror_server_lookup(FuMirrorServer *self, const gchar *path)
+{
+	FuMirrorServerItem *item;
+	g_autoptr(GError) error_local = NULL;
+
+	/* typical case */
+	g_rw_lock_reader_lock(&self->items_mutex);
+	item = fu_mirror_server_lookup_locked(self, path);
+	g_rw_lock_reader_unlock(&self->items_mutex);
+	if (item != NULL)
+		return item;
+
+	/* the directory may have changed since it was last scanned, but do not let clients
+	 * asking for files that do not exist rescan it on every request */
+	if (!fu_mirror_server_rescan_is_due(self))
+		return NULL;
+	if (!fu_mirror_server_rescan(self, &error_local))
+		g_warning("failed to scan %s: %s", self->path, error_local->message);
+	g_rw_lock_reader_lock(&self->items_mutex);
+	item = fu_mirror_server_lookup_locked(self, path);
+	g_rw_lock_reader_unlock(&self->items_mutex);
+	return item;
+}
+
+static void
+fu_mirror_server_request_free(FuMirrorServerRequest *request)
+{
+	g_free(request->method);
+	g_free(request->path);
+	g_hash_table_unref(request->headers);
+	g_free(request);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuMirrorServerRequest, fu_mirror_server_request_free)
+
+/* returns %NULL without setting @error when the client closed the connection; the socket is
+ * only read when it will not block, so that a client sending one byte at a time cannot keep
+ * the thread past @deadline */
+static gchar *
+fu_mirror_server_read_line(GDataInputStream *istream,
+			   GSocket *socket,
+			   gint64 deadline,
+			   GError **error)
+{
+	GBufferedInputStream *bstream = G_BUFFERED_INPUT_STREAM(istream);
+
+	for (;;) {
+		gint64 timeout;
+		gsize bufsz = 0;
+		gssize rc;
+		const guint8 *buf = g_buffered_input_stream_peek_buffer(bstream, &bufsz);
+
+		if (bufsz > 0 && memchr(buf, '\n', bufsz) != NULL)
+			return g_data_input_stream_read_line(istream, NULL, NULL, error);
+		if (bufsz >= g_buffered_input_stream_get_buffer_size(bstream)) {
+			g_set_error_literal(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_INVALID_DATA,
+					    "request line too long");
+			return NULL;
+		}
+		timeout = deadline - g_get_monotonic_time();
+		if (timeout <= 0) {
+			g_set_error_literal(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_TIMED_OUT,
+					    "request not received in time");
+			return NULL;
+		}
+		if (!g_socket_condition_timed_wait(socket, G_IO_IN, timeout, NULL, error))
+			return NULL;
+		rc = g_buffered_input_stream_fill(bstream, -1, NULL, error);
+		if (rc < 0)
+			return NULL;
+		if (rc == 0) {
+			if (bufsz > 0) {
+				g_set_error_literal(error,
+						    G_IO_ERROR,
+						    G_IO_ERROR_PARTIAL_INPUT,
+						    "connection closed in request line");
+			}
+			return NULL;
+		}
+	}
+}
+
+/* returns %FALSE without setting @error if the client did not send anything in time */
+static gboolean
+fu_mirror_server_wait_for_request(GDataInputStream *istream, GSocket *socket, GError **error)
+{
+	gsize bufsz = 0;
+	g_autoptr(GError) error_local = NULL;
+
+	g_buffered_input_stream_peek_buffer(G_BUFFERED_INPUT_STREAM(istream), &bufsz);
+	if (bufsz > 0)
+		return TRUE;
+	if (!g_socket_condition_timed_wait(socket,
+					   G_IO_IN,
+					   FU_MIRROR_SERVER_IDLE_TIMEOUT * G_USEC_PER_SEC,
+					   NULL,
+					   &error_local)) {
+		if (!g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_TIMED_OUT))
+			g_propagate_error(error, g_steal_pointer(&error_local));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* returns %NULL without setting @error when the client closed the connection */
+static FuMirrorServerRequest *
+fu_mirror_server_read_request(GDataInputStream *istream, GSocket *socket, GError **error)
+{
+	const gchar *connection;
+	gint64 deadline;
+	g_autofree gchar *line = NULL;
+	g_auto(GStrv) split = NULL;
+	g_autoptr(FuMirrorServerRequest) request = g_new0(FuMirrorServerRequest, 1);
+
+	request->headers = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+
+	/* keep-alive connections are only kept open for a short time between requests */
+	if (!fu_mirror_server_wait_for_request(istream, socket, error))
+		return NULL;
+	deadline = g_get_monotonic_time() + FU_MIRROR_SERVER_REQUEST_TIMEOUT * G_USEC_PER_SEC;
+
+	/* e.g. `GET /checksum/abcdef HTTP/1.1` */
+	line = fu_mirror_server_read_line(istream, socket, deadline, error);
+	if (line == NULL)
+		return NULL;
+	split = g_strsplit(g_strchomp(line), " ", -1);
+	if (g_strv_length(split) != 3 || split[1][0] != '/' ||
+	    !g_str_has_prefix(split[2], "HTTP/1.")) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_INVALID_DATA,
+			    "invalid request: %s",
+			    line);
+		return NULL;
+	}
+	request->method = g_strdup(split[0]);
+	request->path = g_strndup(split[1], strcspn(split[1], "?#"));
+
+	/* headers, until the empty line */
+	for (guint i = 0;; i++) {
+		gchar *sep;
+		g_autofree gchar *header = NULL;
+
+		header = fu_mirror_server_read_line(istream, socket, deadline, error);
+		if (header == NULL) {
+			if (error != NULL && *error == NULL) {
+				g_set_error_literal(error,
+						    G_IO_ERROR,
+						    G_IO_ERROR_PARTIAL_INPUT,
+						    "connection closed in headers");
+			}
+			return NULL;
+		}
+		g_strchomp(header);
+		if (header[0] == '\0')
+			break;
+		sep = strchr(header, ':');
+		if (sep == NULL || i >= FU_MIRROR_SERVER_HEADERS_MAX) {
+			g_set_error(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_INVALID_DATA,
+				    "invalid header: %s",
+				    header);
+			return NULL;
+		}
+		*sep = '\0';
+		g_hash_table_insert(request->headers,
+				    g_ascii_strdown(header, -1),
+				    g_strdup(g_strstrip(sep + 1)));
+	}
+
+	/* HTTP/1.1 connections are persistent unless asked otherwise */
+	connection = g_hash_table_lookup(request->headers, "connection");
+	if (g_strcmp0(split[2], "HTTP/1.0") == 0) {
+		request->keep_alive =
+		    connection != NULL && g_ascii_strcasecmp(connection, "keep-alive") == 0;
+	} else {
+		request->keep_alive =
+		    connection == NULL || g_ascii_strcasecmp(connection, "close") != 0;
+	}
+	return g_steal_pointer(&request);
+}
+
+static gboolean
+fu_mirror_server_parse_uint64(const gchar *str, guint64 *value)
+{
+	if (str[0] == '\0')
+		return FALSE;
+	for (guint i = 0; str[i] != '\0'; i++) {
+		if (!g_ascii_isdigit(str[i]))
+			return FALSE;
+	}
+	errno = 0;
+	*value = g_ascii_strtoull(str, NULL, 10);
+	return errno == 0;
+}
+
+/* only a single range is supported, the whole file is sent for anything else */
+static FuMirrorServerRange
+fu_mirror_server_parse_range(const gchar *value, guint64 size, guint64 *offset, guint64 *length)
+{
+	guint64 start = 0;
+	guint64 end = 0;
+	g_auto(GStrv) split = NULL;
+
+	if (!g_str_has_prefix(value, "bytes=") || strchr(value, ',') != NULL)
+		return FU_MIRROR_SERVER_RANGE_IGNORE;
+	split = g_strsplit(value + 6, "-", -1);
+	if (g_strv_length(split) != 2)
+		return FU_MIRROR_SERVER_RANGE_IGNORE;
+
+	/* the last N bytes */
+	if (split[0][0] == '\0') {
+		if (!fu_mirror_server_parse_uint64(split[1], &end))
+			return FU_MIRROR_SERVER_RANGE_IGNORE;
+		if (end == 0 || size == 0)
+			return FU_MIRROR_SERVER_RANGE_UNSATISFIABLE;
+		*length = MIN(end, size);
+		*offset = size - *length;
+		return FU_MIRROR_SERVER_RANGE_VALID;
+	}
+
+	/* from the start, optionally to the end */
+	if (!fu_mirror_server_parse_uint64(split[0], &start))
+		return FU_MIRROR_SERVER_RANGE_IGNORE;
+	if (split[1][0] == '\0') {
+		end = size - 1;
+	} else {
+		if (!fu_mirror_server_parse_uint64(split[1], &end) || end < start)
+			return FU_MIRROR_SERVER_RANGE_IGNORE;
+	}
+	if (start >= size)
+		return FU_MIRROR_SERVER_RANGE_UNSATISFIABLE;
+	end = MIN(end, size - 1);
+	*offset = start;
+	*length = end - start + 1;
+	return FU_MIRROR_SERVER_RANGE_VALID;
+}
+
+static const gchar *
+fu_mirror_server_status_to_string(guint status_code)
+{
+	if (status_code == 200)
+		return "OK";
+	if (status_code == 206)
+		return "Partial Content";
+	if (status_code == 304)
+		return "Not Modified";
+	if (status_code == 400)
+		return "Bad Request";
+	if (status_code == 404)
+		return "Not Found";
+	if (status_code == 405)
+		return "Method Not Allowed";
+	if (status_code == 416)
+		return "Range Not Satisfiable";
+	if (status_code == 503)
+		return "Service Unavailable";
+	return "Internal Server Error";
+}
+
+static const gchar *
+fu_mirror_server_content_type_from_basename(const gchar *basename)
+{
+	if (g_str_has_suffix(basename, ".cab"))
+		return "application/vnd.ms-cab-compressed";
+	if (g_str_has_suffix(basename, ".gz"))
+		return "application/gzip";
+	if (g_str_has_suffix(basename, ".xz"))
+		return "application/x-xz";
+	if (g_str_has_suffix(basename, ".zst"))
+		return "application/zstd";
+	if (g_str_has_suffix(basename, ".xml"))
+		return "application/xml";
+	return "application/octet-stream";
+}
+
+static GString *
+fu_mirror_server_response_new(guint status_code, gboolean keep_alive)
+{
+	GString *str = g_string_new(NULL);
+	g_string_append_printf(str,
+			       "HTTP/1.1 %u %s\r\n",
+			       status_code,
+			       fu_mirror_server_status_to_string(status_code));
+	g_string_append_printf(str, "Server: fwupd/%s\r\n", PACKAGE_VERSION);
+	if (!keep_alive)
+		g_string_append(str, "Connection: close\r\n");
+	return str;
+}
+
+static gboolean
+fu_mirror_server_write_string(GSocketConnection *connection, GString *str, GError **error)
+{
+	GOutputStream *ostream = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+	return g_output_stream_write_all(ostream, str->str, str->len, NULL, NULL, error);
+}
+
+static gboolean
+fu_mirror_server_write_error(GSocketConnection *connection,
+			     guint status_code,
+			     gboolean keep_alive,
+			     GError **error)
+{
+	const gchar *msg = fu_mirror_server_status_to_string(status_code);
+	g_autoptr(GString) str = fu_mirror_server_response_new(status_code, keep_alive);
+
+	if (status_code == 405)
+		g_string_append(str, "Allow: GET, HEAD\r\n");
+	g_string_append(str, "Content-Type: text/plain\r\n");
+	g_string_append_printf(str, "Content-Length: %u\r\n\r\n", (guint)strlen(msg) + 1);
+	g_string_append_printf(str, "%s\n", msg);
+	return fu_mirror_server_write_string(connection, str, error);
+}
+
+/* the headers have already been written, and the socket output stream is not buffered */
+static gboolean
+fu_mirror_server_send_file(GSocketConnection *connection,
+			   const gchar *filename,
+			   guint64 offset,
+			   guint64 length,
+			   GError **error)
+{
+	gint fd;
+	gboolean ret = FALSE;
+#ifdef HAVE_SENDFILE
+	GSocket *socket = g_socket_connection_get_socket(connection);
+	off_t off = offset;
+#else
+	GOutputStream *ostream = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+	guint8 buf[32 * 1024];
+#endif
+
+	fd = g_open(filename, O_RDONLY, 0);
+	if (fd < 0) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    g_io_error_from_errno(errno),
+			    "failed to open %s: %s",
+			    filename,
+			    g_strerror(errno));
+		return FALSE;
+	}
+
+#ifdef HAVE_SENDFILE
+	/* zero-copy from the page cache into the socket */
+	while (length > 0) {
+		gsize chunksz = MIN(length, (guint64)G_MAXSSIZE);
+		gssize rc = sendfile(g_socket_get_fd(socket), fd, &off, chunksz);
+		if (rc < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				if (!g_socket_condition_wait(socket, G_IO_OUT, NULL, error))
+					goto out;
+				continue;
+			}
+			g_set_error(error,
+				    G_IO_ERROR,
+				    g_io_error_from_errno(errno),
+				    "failed to send %s: %s",
+				    filename,
+				    g_strerror(errno));
+			goto out;
+		}
+		if (rc == 0) {
+			g_set_error(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_PARTIAL_INPUT,
+				    "%s was truncated",
+				    filename);
+			goto out;
+		}
+		length -= rc;
+	}
+#else
+	if (lseek(fd, offset, SEEK_SET) < 0) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    g_io_error_from_errno(errno),
+			    "failed to seek %s: %s",
+			    filename,
+			    g_strerror(errno));
+		goto out;
+	}
+	while (length > 0) {
+		gssize rc = read(fd, buf, MIN(length, sizeof(buf)));
+		if (rc < 0 && errno == EINTR)
+			continue;
+		if (rc <= 0) {
+			g_set_error(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_PARTIAL_INPUT,
+				    "failed to read %s",
+				    filename);
+			goto out;
+		}
+		if (!g_output_stream_write_all(ostream, buf, rc, NULL, NULL, error))
+			goto out;
+		length -= rc;
+	}
+#endif
+
+	/* success */
+	ret = TRUE;
+out:
+	g_close(fd, NULL);
+	return ret;
+}
+
+static gboolean
+fu_mirror_server_handle_request(FuMirrorServer *self,
+				GSocketConnection *connection,
+				FuMirrorServerRequest *request,
+				GError **error)
+{
+	const gchar *if_none_match;
+	const gchar *if_range;
+	const gchar *range;
+	guint status_code = 200;
+	guint64 offset = 0;
+	guint64 length;
+	g_autofree gchar *etag = NULL;
+	g_autoptr(FuMirrorServerItem) item = NULL;
+	g_autoptr(GString) str = NULL;
+
+	if (g_strcmp0(request->method, "GET") != 0 && g_strcmp0(request->method, "HEAD") != 0)
+		return fu_mirror_server_write_error(connection, 405, request->keep_alive, error);
+
+	/* only files at the top level of the directory */
+	if (strstr(request->path, "..") != NULL ||
+	    (strchr(request->path + 1, '/') != NULL &&
+	     !g_str_has_prefix(request->path, "/checksum/"))) {
+		return fu_mirror_server_write_error(connection, 404, request->keep_alive, error);
+	}
+	item = fu_mirror_server_lookup(self, request->path);
+	if (item == NULL) {
+		g_debug("%s %s: not found", request->method, request->path);
+		return fu_mirror_server_write_error(connection, 404, request->keep_alive, error);
+	}
+
+	/* the client already has this version */
+	etag = g_strdup_printf("\"%s\"", item->checksum_sha256);
+	if_none_match = g_hash_table_lookup(request->headers, "if-none-match");
+	if (if_none_match != NULL &&
+	    (g_strcmp0(if_none_match, "*") == 0 || strstr(if_none_match, etag) != NULL)) {
+		str = fu_mirror_server_response_new(304, request->keep_alive);
+		g_string_append_printf(str, "ETag: %s\r\n\r\n", etag);
+		g_debug("%s %s: not modified", request->method, request->path);
+		return fu_mirror_server_write_string(connection, str, error);
+	}
+
+	/* resuming a partial download */
+	length = item->size;
+	range = g_hash_table_lookup(request->headers, "range");
+	if_range = g_hash_table_lookup(request->headers, "if-range");
+	if (range != NULL && (if_range == NULL || g_strcmp0(if_range, etag) == 0)) {
+		FuMirrorServerRange rc;
+		rc = fu_mirror_server_parse_range(range, item->size, &offset, &length);
+		if (rc == FU_MIRROR_SERVER_RANGE_UNSATISFIABLE) {
+			str = fu_mirror_server_response_new(416, request->keep_alive);
+			g_string_append_printf(str,
+					       "Content-Range: bytes */%" G_GUINT64_FORMAT "\r\n",
+					       item->size);
+			g_string_append(str, "Content-Length: 0\r\n\r\n");
+			return fu_mirror_server_write_string(connection, str, error);
+		}
+		if (rc == FU_MIRROR_SERVER_RANGE_VALID)
+			status_code = 206;
+	}
+
+	/* headers */
+	str = fu_mirror_server_response_new(status_code, request->keep_alive);
+	g_string_append_printf(str,
+			       "Content-Type: %s\r\n",
+			       fu_mirror_server_content_type_from_basename(item->basename));
+	g_string_append_printf(str, "Content-Length: %" G_GUINT64_FORMAT "\r\n", length);
+	if (status_code == 206) {
+		g_string_append_printf(str,
+				       "Content-Range: bytes %" G_GUINT64_FORMAT
+				       "-%" G_GUINT64_FORMAT "/%" G_GUINT64_FORMAT "\r\n",
+				       offset,
+				       offset + length - 1,
+				       item->size);
+	}
+	g_string_append_printf(str, "ETag: %s\r\n", etag);
+	g_string_append(str, "Accept-Ranges: bytes\r\n");
+	if (item->content_addressed)
+		g_string_append(str, "Cache-Control: public, max-age=31536000, immutable\r\n");
+	else
+		g_string_append(str, "Cache-Control: no-cache\r\n");
+	g_string_append(str, "\r\n");
+	g_debug("%s %s: %u, %" G_GUINT64_FORMAT " bytes",
+		request->method,
+		request->path,
+		status_code,
+		length);
+	if (!fu_mirror_server_write_string(connection, str, error))
+		return FALSE;
+
+	/* body */
+	if (g_strcmp0(request->method, "HEAD") == 0 || length == 0)
+		return TRUE;
+	return fu_mirror_server_send_file(connection, item->filename, offset, length, error);
+}
+
+static gchar *
+fu_mirror_server_get_peer(GSocketConnection *connection)
+{
+	GInetAddress *address;
+	g_autoptr(GSocketAddress) socket_address = NULL;
+
+	socket_address = g_socket_connection_get_remote_address(connection, NULL);
+	if (socket_address == NULL || !G_IS_INET_SOCKET_ADDRESS(socket_address))
+		return g_strdup("unknown");
+	address = g_inet_socket_address_get_address(G_INET_SOCKET_ADDRESS(socket_address));
+	return g_inet_address_to_string(address);
+}
+
+static gboolean
+fu_mirror_server_peer_add(FuMirrorServer *self, const gchar *peer)
+{
+	guint cnt;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->peers_mutex);
+
+	cnt = GPOINTER_TO_UINT(g_hash_table_lookup(self->peers, peer));
+	if (cnt >= FU_MIRROR_SERVER_CONNECTIONS_PER_PEER_MAX)
+		return FALSE;
+	g_hash_table_insert(self->peers, g_strdup(peer), GUINT_TO_POINTER(cnt + 1));
+	return TRUE;
+}
+
+static void
+fu_mirror_server_peer_remove(FuMirrorServer *self, const gchar *peer)
+{
+	guint cnt;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->peers_mutex);
+
+	cnt = GPOINTER_TO_UINT(g_hash_table_lookup(self->peers, peer));
+	if (cnt <= 1) {
+		g_hash_table_remove(self->peers, peer);
+		return;
+	}
+	g_hash_table_insert(self->peers, g_strdup(peer), GUINT_TO_POINTER(cnt - 1));
+}
+
+/* runs in a worker thread */
+static gboolean
+fu_mirror_server_run_cb(GThreadedSocketService *service,
+			GSocketConnection *connection,
+			GObject *source_object,
+			gpointer user_data)
+{
+	FuMirrorServer *self = FU_MIRROR_SERVER(user_data);
+	GInputStream *istream = g_io_stream_get_input_stream(G_IO_STREAM(connection));
+	GSocket *socket = g_socket_connection_get_socket(connection);
+	g_autofree gchar *peer = fu_mirror_server_get_peer(connection);
+	g_autoptr(GDataInputStream) data_istream = NULL;
+
+	/* the requests are read with their own deadlines, this is for the responses */
+	g_socket_set_timeout(socket, FU_MIRROR_SERVER_TIMEOUT);
+	if (!fu_mirror_server_peer_add(self, peer)) {
+		g_debug("too many connections from %s", peer);
+		fu_mirror_server_write_error(connection, 503, FALSE, NULL);
+		g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
+		return TRUE;
+	}
+
+	data_istream = g_data_input_stream_new(istream);
+	g_data_input_stream_set_newline_type(data_istream, G_DATA_STREAM_NEWLINE_TYPE_LF);
+	g_filter_input_stream_set_close_base_stream(G_FILTER_INPUT_STREAM(data_istream), FALSE);
+	for (;;) {
+		g_autoptr(FuMirrorServerRequest) request = NULL;
+		g_autoptr(GError) error_local = NULL;
+
+		request = fu_mirror_server_read_request(data_istream, socket, &error_local);
+		if (request == NULL) {
+			if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_DATA)) {
+				g_debug("%s", error_local->message);
+				fu_mirror_server_write_error(connection, 400, FALSE, NULL);
+			}
+			break;
+		}
+		if (!fu_mirror_server_handle_request(self, connection, request, &error_local)) {
+			g_debug("failed to handle %s: %s", request->path, error_local->message);
+			break;
+		}
+		if (!request->keep_alive)
+			break;
+	}
+	fu_mirror_server_peer_remove(self, peer);
+	g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
+	return TRUE;
+}
+
+static gboolean
+fu_mirror_server_listen_address(GSocketListener *listener,
+				const gchar *address,
+				guint16 *port,
+				GError **error)
+{
+	g_autoptr(GInetAddress) inet_address = g_inet_address_new_from_string(address);
+	g_autoptr(GSocketAddress) socket_address = NULL;
+	g_autoptr(GSocketAddress) socket_address_effective = NULL;
+
+	if (inet_address == NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_ARGS,
+			    "%s is not an IP address",
+			    address);
+		return FALSE;
+	}
+	socket_address = g_inet_socket_address_new(inet_address, *port);
+	if (!g_socket_listener_add_address(listener,
+					   socket_address,
+					   G_SOCKET_TYPE_STREAM,
+					   G_SOCKET_PROTOCOL_TCP,
+					   NULL,
+					   &socket_address_effective,
+					   error))
+		return FALSE;
+
+	/* if 0 was used, a free port was chosen */
+	*port = g_inet_socket_address_get_port(G_INET_SOCKET_ADDRESS(socket_address_effective));
+	return TRUE;
+}
+
+/**
+ * fu_mirror_server_start:
+ * @self: a #FuMirrorServer
+ * @address: (nullable): an IP address, e.g. `192.168.1.2`, or %NULL for all interfaces
+ * @port: a TCP port, or 0 to choose one that is not in use
+ * @error: (nullable): optional return location for an error
+ *
+ * Scans the directory and starts listening. The connections are handled in worker threads,
+ * but the listening socket is attached to the thread-default main context.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_mirror_server_start(FuMirrorServer *self, const gchar *address, guint16 port, GError **error)
+{
+	g_autoptr(GSocketService) service = NULL;
+
+	g_return_val_if_fail(FU_IS_MIRROR_SERVER(self), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (self->service != NULL) {
+		g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "already started");
+		return FALSE;
+	}
+
+	/* so the first requests do not have to wait */
+	if (!fu_mirror_server_rescan(self, error))
+		return FALSE;
+	fu_mirror_server_rescan_is_due(self);
+
+	service = g_threaded_socket_service_new(FU_MIRROR_SERVER_THREADS_MAX);
+	if (address != NULL) {
+		if (!fu_mirror_server_listen_address(G_SOCKET_LISTENER(service),
+						     address,
+						     &port,
+						     error))
+			return FALSE;
+	} else if (port == 0) {
+		port = g_socket_listener_add_any_inet_port(G_SOCKET_LISTENER(service), NULL, error);
+		if (port == 0)
+			return FALSE;
+	} else {
+		if (!g_socket_listener_add_inet_port(G_SOCKET_LISTENER(service), port, NULL, error))
+			return FALSE;
+	}
+	g_signal_connect(service, "run", G_CALLBACK(fu_mirror_server_run_cb), self);
+	g_socket_service_start(service);
+	self->service = g_steal_pointer(&service);
+	self->port = port;
+	return TRUE;
+}
+
+/**
+ * fu_mirror_server_stop:
+ * @self: a #FuMirrorServer
+ *
+ * Stops accepting new connections.
+ **/
+void
+fu_mirror_server_stop(FuMirrorServer *self)
+{
+	g_return_if_fail(FU_IS_MIRROR_SERVER(self));
+	if (self->service == NULL)
+		return;
+	g_socket_service_stop(self->service);
+	g_socket_listener_close(G_SOCKET_LISTENER(self->service));
+	g_clear_object(&self->service);
+	self->port = 0;
+}
+
+/**
+ * fu_mirror_server_get_port:
+ * @self: a #FuMirrorServer
+ *
+ * Gets the TCP port the server is listening on.
+ *
+ * Returns: a port, or 0 if not started
+ **/
+guint16
+fu_mirror_server_get_port(FuMirrorServer *self)
+{
+	g_return_val_if_fail(FU_IS_MIRROR_SERVER(self), 0);
+	return self->port;
+}
+
+static void
+fu_mirror_server_init(FuMirrorServer *self)
+{
+	g_rw_lock_init(&self->items_mutex);
+	g_mutex_init(&self->rescan_mutex);
+	g_mutex_init(&self->peers_mutex);
+	self->peers = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	self->items_by_basename = g_hash_table_new(g_str_hash, g_str_equal);
+	self->items_by_checksum = g_hash_table_new(g_str_hash, g_str_equal);
+}
+
+static void
+fu_mirror_server_finalize(GObject *obj)
+{
+	FuMirrorServer *self = FU_MIRROR_SERVER(obj);
+
+	fu_mirror_server_stop(self);
+	g_rw_lock_clear(&self->items_mutex);
+	g_mutex_clear(&self->rescan_mutex);
+	g_mutex_clear(&self->peers_mutex);
+	g_hash_table_unref(self->peers);
+	g_hash_table_unref(self->items_by_checksum);
+	g_hash_table_unref(self->items_by_basename);
+	g_free(self->path);
+
+	G_OBJECT_CLASS(fu_mirror_server_parent_class)->finalize(obj);
+}
+
+static void
+fu_mirror_server_class_init(FuMirrorServerClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_mirror_server_finalize;
+}
+
+/**
+ * fu_mirror_server_new:
+ * @path: a directory of cabinet archives and metadata
+ *
+ * Creates a HTTP server for other hosts on the local network. Each file is available by name,
+ * e.g. `/firmware.xml.gz`, and by the SHA-1, SHA-256 or SHA-512 checksum of the contents, e.g.
+ * `/checksum/9a6e8c2e8f0d8b4c4d7a5e0e1b9f3c2a1d0e4f5a`. The SHA-256 checksum is also used as
+ * the ETag so that clients can resume downloads using ranges.
+ *
+ * Returns: a #FuMirrorServer
+ **/
+FuMirrorServer *
+fu_mirror_server_new(const gchar *path)
+{
+	FuMirrorServer *self;
+	self = g_object_new(FU_TYPE_MIRROR_SERVER, NULL);
+	self->path = g_strdup(path);
+	return FU_MIRROR_SERVER(self);
+}
@@ -0,0 +1,21 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include <fwupd.h>
+
+#define FU_TYPE_MIRROR_SERVER (fu_mirror_server_get_type())
+G_DECLARE_FINAL_TYPE(FuMirrorServer, fu_mirror_server, FU, MIRROR_SERVER, GObject)
+
+FuMirrorServer *
+fu_mirror_server_new(const gchar *path);
+gboolean
+fu_mirror_server_start(FuMirrorServer *self, const gchar *address, guint16 port, GError **error);
+void
+fu_mirror_server_stop(FuMirrorServer *self);
+guint16
+fu_mirror_server_get_port(FuMirrorServer *self);
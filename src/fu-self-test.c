@@ -21,14 +21,17 @@
 #include "fu-context-private.h"
 #include "fu-device-list.h"
 #include "fu-device-private.h"
+#include "fu-emulation-backend.h"
 #include "fu-engine.h"
 #include "fu-hash.h"
 #include "fu-history.h"
+#include "fu-mirror-server.h"
 #include "fu-plugin-list.h"
 #include "fu-plugin-private.h"
 #include "fu-progressbar.h"
 #include "fu-security-attr.h"
 #include "fu-smbios-private.h"
+#include "fu-statistics.h"
 
 typedef struct {
 	FuPlugin *plugin;
@@ -1744,6 +1747,72 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	g_assert_cmpstr(fwupd_release_get_version(rel), ==, "1.2.2");
 }
 
+static void
+fu_engine_prefetch_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(FuDevice) device = fu_device_new_with_context(self->ctx);
+	g_autoptr(FuDevice) device2 = fu_device_new_with_context(self->ctx);
+	g_autoptr(FuEngine) engine = fu_engine_new(FU_APP_FLAGS_NONE);
+	g_autoptr(GBytes) blob_cab = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(XbSilo) silo = NULL;
+
+	/* put cab file where the directory remote finds it */
+	filename =
+	    g_test_build_filename(G_TEST_DIST, "tests", "colorhug", "colorhug-als-3.0.2.cab", NULL);
+	blob_cab = fu_common_get_contents_bytes(filename, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_cab);
+	ret = fu_common_set_contents_bytes("/tmp/fwupd-self-test/var/cache/fwupd/foo.cab",
+					   blob_cab,
+					   &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_engine_load(engine,
+			     FU_ENGINE_LOAD_FLAG_REMOTES | FU_ENGINE_LOAD_FLAG_NO_CACHE,
+			     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* one device with an upgrade, and one without */
+	fu_device_set_id(device, "prefetch_device");
+	fu_device_set_name(device, "Prefetch Device");
+	fu_device_set_version_format(device, FWUPD_VERSION_FORMAT_TRIPLET);
+	fu_device_set_version(device, "1.2.3");
+	fu_device_add_guid(device, "12345678-1234-1234-1234-123456789012");
+	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE);
+	fu_engine_add_device(engine, device);
+	fu_device_set_id(device2, "prefetch_device2");
+	fu_device_set_name(device2, "Prefetch Device 2");
+	fu_device_set_version_format(device2, FWUPD_VERSION_FORMAT_TRIPLET);
+	fu_device_set_version(device2, "1.2.3");
+	fu_device_add_guid(device2, "87654321-1234-1234-1234-123456789012");
+	fu_device_add_flag(device2, FWUPD_DEVICE_FLAG_UPDATABLE);
+	fu_engine_add_device(engine, device2);
+
+	/* nothing to prepare */
+	ret = fu_engine_prefetch_device(engine, fu_device_get_id(device2), &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO);
+	g_assert_false(ret);
+	g_clear_error(&error);
+	g_assert_cmpint(fu_engine_get_prefetch_size(engine), ==, 0);
+
+	/* the parsed silo and the decompressed payload are both counted */
+	ret = fu_engine_prefetch_device(engine, fu_device_get_id(device), &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_engine_get_prefetch_size(engine), >, 0);
+
+	/* installing the same cabinet uses the prepared silo, only once */
+	silo = fu_engine_get_silo_from_blob(engine, blob_cab, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(silo);
+	g_assert_cmpint(fu_engine_get_prefetch_size(engine), ==, 0);
+}
+
 static void
 fu_engine_install_duration_func(gconstpointer user_data)
 {
@@ -1977,6 +2046,186 @@ fu_engine_history_func(gconstpointer user_data)
 	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO);
 }
 
+static FuPlugin *
+fu_engine_security_attrs_plugin_new(FuEngine *engine, const gchar *name)
+{
+	gboolean ret;
+	g_autofree gchar *pluginfn = NULL;
+	g_autoptr(FuPlugin) plugin = fu_plugin_new(fu_engine_get_context(engine));
+	g_autoptr(GError) error = NULL;
+
+	pluginfn = g_test_build_filename(G_TEST_BUILT,
+					 "..",
+					 "plugins",
+					 "test",
+					 "libfu_plugin_test." G_MODULE_SUFFIX,
+					 NULL);
+	ret = fu_plugin_open(plugin, pluginfn, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_plugin_set_name(plugin, name);
+	fu_engine_add_plugin(engine, plugin);
+	return g_steal_pointer(&plugin);
+}
+
+static FwupdSecurityAttrResult
+fu_engine_security_attrs_get_result(FuEngine *engine, const gchar *plugin_name)
+{
+	g_autoptr(FuSecurityAttrs) attrs = fu_engine_get_host_security_attrs(engine);
+	g_autoptr(GPtrArray) items = fu_security_attrs_get_all(attrs);
+	for (guint i = 0; i < items->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(items, i);
+		if (g_strcmp0(fwupd_security_attr_get_plugin(attr), plugin_name) == 0)
+			return fwupd_security_attr_get_result(attr);
+	}
+	return FWUPD_SECURITY_ATTR_RESULT_LAST;
+}
+
+static void
+fu_engine_security_attrs_func(gconstpointer user_data)
+{
+	gboolean ret;
+	gint64 start;
+	g_autoptr(FuEngine) engine = fu_engine_new(FU_APP_FLAGS_NONE);
+	g_autoptr(FuPlugin) plugin1 = NULL;
+	g_autoptr(FuPlugin) plugin2 = NULL;
+	g_autoptr(GError) error = NULL;
+
+#ifndef HAVE_HSI
+	g_test_skip("no HSI support");
+	return;
+#endif
+
+	ret = fu_engine_load(engine, FU_ENGINE_LOAD_FLAG_NO_CACHE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	plugin1 = fu_engine_security_attrs_plugin_new(engine, "test");
+	plugin2 = fu_engine_security_attrs_plugin_new(engine, "test2");
+
+	/* both plugins are asked */
+	g_setenv("FWUPD_PLUGIN_TEST_HSI", "not-encrypted", TRUE);
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_NOT_ENCRYPTED);
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test2"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_NOT_ENCRYPTED);
+
+	/* only the plugin that was invalidated is asked again */
+	g_setenv("FWUPD_PLUGIN_TEST_HSI", "encrypted", TRUE);
+	fu_context_security_changed_full(fu_engine_get_context(engine), "test2");
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_NOT_ENCRYPTED);
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test2"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_ENCRYPTED);
+
+	/* a plugin that has been disabled is asked again */
+	fu_plugin_add_flag(plugin1, FWUPD_PLUGIN_FLAG_DISABLED);
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_ENCRYPTED);
+
+	/* everything is asked again */
+	g_setenv("FWUPD_PLUGIN_TEST_HSI", "not-encrypted", TRUE);
+	fu_context_security_changed(fu_engine_get_context(engine));
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_NOT_ENCRYPTED);
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test2"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_NOT_ENCRYPTED);
+
+	/* both plugins take too long, so the old results are marked as unknown */
+	g_setenv("FWUPD_PLUGIN_TEST_HSI", "encrypted", TRUE);
+	g_setenv("FWUPD_PLUGIN_TEST_HSI_DELAY_MS", "200", TRUE);
+	fu_engine_set_host_security_timeout(engine, 10);
+	fu_context_security_changed(fu_engine_get_context(engine));
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_UNKNOWN);
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test2"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_UNKNOWN);
+
+	/* the late results are used once the plugins finish */
+	while (fu_engine_security_attrs_get_result(engine, "test") ==
+		   FWUPD_SECURITY_ATTR_RESULT_UNKNOWN ||
+	       fu_engine_security_attrs_get_result(engine, "test2") ==
+		   FWUPD_SECURITY_ATTR_RESULT_UNKNOWN)
+		g_main_context_iteration(NULL, TRUE);
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_ENCRYPTED);
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test2"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_ENCRYPTED);
+
+	/* a late result is not used if the plugin was invalidated while it was running */
+	g_setenv("FWUPD_PLUGIN_TEST_HSI", "not-encrypted", TRUE);
+	fu_context_security_changed_full(fu_engine_get_context(engine), "test");
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_UNKNOWN);
+	g_setenv("FWUPD_PLUGIN_TEST_HSI", "encrypted", TRUE);
+	fu_context_security_changed_full(fu_engine_get_context(engine), "test");
+	fu_engine_set_host_security_timeout(engine, 0);
+	while (fu_engine_security_attrs_get_result(engine, "test") ==
+	       FWUPD_SECURITY_ATTR_RESULT_UNKNOWN)
+		g_main_context_iteration(NULL, TRUE);
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_ENCRYPTED);
+
+	/* independent plugins are asked at the same time */
+	fu_context_security_changed(fu_engine_get_context(engine));
+	start = g_get_monotonic_time();
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_ENCRYPTED);
+	g_assert_cmpint(fu_engine_security_attrs_get_result(engine, "test2"),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_ENCRYPTED);
+	g_assert_cmpint(g_get_monotonic_time() - start, <, 2 * 200 * 1000);
+	g_unsetenv("FWUPD_PLUGIN_TEST_HSI_DELAY_MS");
+	g_unsetenv("FWUPD_PLUGIN_TEST_HSI");
+}
+
+static void
+fu_engine_staged_func(gconstpointer user_data)
+{
+	gboolean ret;
+	g_autoptr(FuEngine) engine = fu_engine_new(FU_APP_FLAGS_NONE);
+	g_autoptr(GError) error = NULL;
+
+	/* only the core is loaded */
+	ret = fu_engine_load(engine,
+			     FU_ENGINE_LOAD_FLAG_NO_CACHE | FU_ENGINE_LOAD_FLAG_STAGED,
+			     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_engine_get_subsystems_ready(engine),
+			==,
+			FU_ENGINE_SUBSYSTEM_REMOTES | FU_ENGINE_SUBSYSTEM_DEVICES);
+
+	/* loaded on demand */
+	ret = fu_engine_ensure_subsystem(engine, FU_ENGINE_SUBSYSTEM_HISTORY, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_engine_get_subsystems_ready(engine) & FU_ENGINE_SUBSYSTEM_HISTORY,
+			==,
+			FU_ENGINE_SUBSYSTEM_HISTORY);
+
+	/* the rest are loaded when idle */
+	fu_engine_load_deferred(engine);
+	while (g_main_context_iteration(NULL, FALSE))
+		;
+	g_assert_cmpint(fu_engine_get_subsystems_ready(engine),
+			==,
+			FU_ENGINE_SUBSYSTEM_LAST - 1);
+}
+
 static void
 fu_engine_multiple_rels_func(gconstpointer user_data)
 {
@@ -3073,6 +3322,7 @@ fu_plugin_module_func(gconstpointer user_data)
 	g_autofree gchar *mapped_file_fn = NULL;
 	g_autofree gchar *pending_cap = NULL;
 	g_autofree gchar *history_db = NULL;
+	g_autofree gchar *str = NULL;
 	g_autoptr(FuDevice) device = NULL;
 	g_autoptr(FuDevice) device2 = NULL;
 	g_autoptr(FuDevice) device3 = NULL;
@@ -3160,6 +3410,9 @@ fu_plugin_module_func(gconstpointer user_data)
 	/* save this; we'll need to delete it later */
 	pending_cap = g_strdup(fwupd_release_get_filename(release));
 
+	/* transfers from before the update are not part of the report */
+	fu_device_add_io_stats(device, "Coldplug", 4, 10);
+
 	/* lets do this online */
 	fu_engine_add_device(engine, device);
 	fu_engine_add_plugin(engine, self->plugin);
@@ -3173,6 +3426,8 @@ fu_plugin_module_func(gconstpointer user_data)
 	g_assert_no_error(error);
 	g_assert_true(ret);
 	g_assert_cmpint(cnt, ==, 8);
+	str = fu_device_to_string(device);
+	g_assert_null(g_strstr_len(str, -1, "IoColdplug"));
 
 	/* check the new version */
 	g_assert_cmpstr(fu_device_get_version(device), ==, "1.2.3");
@@ -3345,6 +3600,174 @@ fu_history_func(gconstpointer user_data)
 	g_assert_cmpstr(g_ptr_array_index(approved_firmware, 1), ==, "bar");
 }
 
+static void
+fu_history_security_attrs_func(gconstpointer user_data)
+{
+	gboolean ret;
+	g_autofree gchar *dirname = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(FuHistory) history = NULL;
+	g_autoptr(FuSecurityAttrs) attrs1 = fu_security_attrs_new();
+	g_autoptr(FuSecurityAttrs) attrs2 = fu_security_attrs_new();
+	g_autoptr(FwupdSecurityAttr) attr1 = fwupd_security_attr_new("org.fwupd.hsi.foo");
+	g_autoptr(FwupdSecurityAttr) attr2 = fwupd_security_attr_new("org.fwupd.hsi.foo");
+	g_autoptr(FwupdSecurityAttr) attr3 = fwupd_security_attr_new("org.fwupd.hsi.bar");
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) events = NULL;
+	g_autoptr(GPtrArray) snapshots = NULL;
+
+#ifndef HAVE_SQLITE
+	g_test_skip("no sqlite support");
+	return;
+#endif
+
+	/* delete the database */
+	dirname = fu_common_get_path(FU_PATH_KIND_LOCALSTATEDIR_PKG);
+	if (!g_file_test(dirname, G_FILE_TEST_IS_DIR))
+		return;
+	filename = g_build_filename(dirname, "pending.db", NULL);
+	g_unlink(filename);
+	history = fu_history_new();
+
+	/* attrs1 has foo(enabled), attrs2 has foo(~enabled) and bar */
+	fwupd_security_attr_set_plugin(attr1, "foo");
+	fwupd_security_attr_set_result(attr1, FWUPD_SECURITY_ATTR_RESULT_ENABLED);
+	fu_security_attrs_append(attrs1, attr1);
+	fwupd_security_attr_set_plugin(attr2, "foo");
+	fwupd_security_attr_set_result(attr2, FWUPD_SECURITY_ATTR_RESULT_NOT_ENABLED);
+	fu_security_attrs_append(attrs2, attr2);
+	fwupd_security_attr_set_plugin(attr3, "bar");
+	fwupd_security_attr_set_result(attr3, FWUPD_SECURITY_ATTR_RESULT_LOCKED);
+	fu_security_attrs_append(attrs2, attr3);
+
+	/* the same snapshot is only stored once */
+	ret = fu_history_add_security_attribute(history, attrs1, "HSI:1", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_history_add_security_attribute(history, attrs1, "HSI:1", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	snapshots = fu_history_get_security_attrs(history, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(snapshots);
+	g_assert_cmpint(snapshots->len, ==, 1);
+	g_clear_pointer(&snapshots, g_ptr_array_unref);
+
+	/* first snapshot has no events */
+	events = fu_history_get_security_events(history, 0, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(events);
+	g_assert_cmpint(events->len, ==, 0);
+	g_clear_pointer(&events, g_ptr_array_unref);
+
+	/* only the deltas are recorded */
+	ret = fu_history_add_security_attribute(history, attrs2, "HSI:0", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	snapshots = fu_history_get_security_attrs(history, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(snapshots);
+	g_assert_cmpint(snapshots->len, ==, 2);
+	events = fu_history_get_security_events(history, 0, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(events);
+	g_assert_cmpint(events->len, ==, 2);
+	g_clear_pointer(&events, g_ptr_array_unref);
+
+	/* paginated */
+	events = fu_history_get_security_events(history, 1, 1, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(events);
+	g_assert_cmpint(events->len, ==, 1);
+}
+
+static void
+fu_history_progress_profile_func(gconstpointer user_data)
+{
+	gboolean ret;
+	g_autofree gchar *dirname = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(FuDevice) device = fu_device_new();
+	g_autoptr(FuDevice) device_other = fu_device_new();
+	g_autoptr(FuHistory) history = NULL;
+	g_autoptr(FuProgress) progress1 = fu_progress_new(G_STRLOC);
+	g_autoptr(FuProgress) progress2 = fu_progress_new(G_STRLOC);
+	g_autoptr(FuProgress) progress3 = fu_progress_new(G_STRLOC);
+	g_autoptr(FuProgress) progress4 = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+
+#ifndef HAVE_SQLITE
+	g_test_skip("no sqlite support");
+	return;
+#endif
+
+	/* delete the database */
+	dirname = fu_common_get_path(FU_PATH_KIND_LOCALSTATEDIR_PKG);
+	if (!g_file_test(dirname, G_FILE_TEST_IS_DIR))
+		return;
+	filename = g_build_filename(dirname, "pending.db", NULL);
+	g_unlink(filename);
+	history = fu_history_new();
+	fu_device_set_plugin(device, "test");
+	fu_device_set_plugin(device_other, "other");
+
+	/* write 0x4000 bytes then restart */
+	fu_progress_add_step(progress1, FWUPD_STATUS_DEVICE_WRITE, 50);
+	fu_progress_add_step(progress1, FWUPD_STATUS_DEVICE_RESTART, 50);
+	fu_progress_set_percentage_full(fu_progress_get_child(progress1), 0x2000, 0x4000);
+	fu_progress_set_percentage_full(fu_progress_get_child(progress1), 0x4000, 0x4000);
+	fu_progress_step_done(progress1);
+	fu_progress_step_done(progress1);
+	g_assert_cmpint(fu_progress_get_step_bytes(progress1, 0), ==, 0x4000);
+	g_assert_cmpint(fu_progress_get_step_bytes(progress1, 1), ==, 0);
+	g_assert_cmpint(fu_progress_get_bytes(progress1), ==, 0x4000);
+	ret = fu_history_add_progress_profile(history, device, progress1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* same steps */
+	fu_progress_add_step(progress2, FWUPD_STATUS_DEVICE_WRITE, 50);
+	fu_progress_add_step(progress2, FWUPD_STATUS_DEVICE_RESTART, 50);
+	ret = fu_history_load_progress_profile(history, device, progress2, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* same steps, but a different plugin */
+	ret = fu_history_load_progress_profile(history, device_other, progress2, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_false(ret);
+	g_clear_error(&error);
+
+	/* different steps */
+	fu_progress_add_step(progress3, FWUPD_STATUS_DEVICE_ERASE, 50);
+	fu_progress_add_step(progress3, FWUPD_STATUS_DEVICE_RESTART, 50);
+	ret = fu_history_load_progress_profile(history, device, progress3, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_false(ret);
+	g_clear_error(&error);
+
+	/* a new profile replaces the old one */
+	fu_progress_add_step(progress4, FWUPD_STATUS_DEVICE_ERASE, 50);
+	fu_progress_add_step(progress4, FWUPD_STATUS_DEVICE_RESTART, 50);
+	fu_progress_step_done(progress4);
+	fu_progress_step_done(progress4);
+	ret = fu_history_add_progress_profile(history, device, progress4, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_progress_reset(progress3);
+	fu_progress_add_step(progress3, FWUPD_STATUS_DEVICE_ERASE, 50);
+	fu_progress_add_step(progress3, FWUPD_STATUS_DEVICE_RESTART, 50);
+	ret = fu_history_load_progress_profile(history, device, progress3, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_progress_reset(progress2);
+	fu_progress_add_step(progress2, FWUPD_STATUS_DEVICE_WRITE, 50);
+	fu_progress_add_step(progress2, FWUPD_STATUS_DEVICE_RESTART, 50);
+	ret = fu_history_load_progress_profile(history, device, progress2, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_false(ret);
+}
+
 static GBytes *
 _build_cab(GCabCompression compression, ...)
 {
@@ -3578,6 +4001,295 @@ fu_plugin_composite_func(gconstpointer user_data)
 	}
 }
 
+#ifdef HAVE_PWRITE
+static void
+fu_emulation_backend_added_cb(FuBackend *backend, FuDevice *device, gpointer user_data)
+{
+	FuDevice **device_out = (FuDevice **)user_data;
+	g_set_object(device_out, device);
+}
+
+static void
+fu_emulation_backend_func(gconstpointer user_data)
+{
+	gboolean ret;
+	gint fd;
+	guint8 buf[3] = {0x0};
+	g_autofree gchar *filename = NULL;
+	g_autofree gchar *filename_emulation = NULL;
+	g_autoptr(FuBackend) backend = NULL;
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuDevice) device_emulated = NULL;
+	g_autoptr(FuUdevDevice) device = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) devices = g_ptr_array_new_with_free_func(g_object_unref);
+
+	/* record a write, a read and a failed read */
+	fu_context_add_flag(ctx, FU_CONTEXT_FLAG_SAVE_EVENTS);
+	device = g_object_new(FU_TYPE_UDEV_DEVICE, "context", ctx, NULL);
+	fu_device_set_physical_id(FU_DEVICE(device), "/dev/foo");
+	fu_device_add_possible_plugin(FU_DEVICE(device), "test");
+	fd = g_file_open_tmp("fwupd-self-test-XXXXXX", &filename, &error);
+	g_assert_no_error(error);
+	g_assert_cmpint(fd, >, 0);
+	fu_udev_device_set_fd(device, fd);
+	ret = fu_udev_device_pwrite_full(device, 0x0, (const guint8 *)"abc", 3, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_udev_device_pread_full(device, 0x0, buf, sizeof(buf), &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_udev_device_pread_full(device, 0x100, buf, sizeof(buf), &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_FAILED);
+	g_assert_false(ret);
+	g_clear_error(&error);
+	g_assert_cmpint(fu_device_get_events(FU_DEVICE(device))->len, ==, 3);
+
+	/* save */
+	g_ptr_array_add(devices, g_object_ref(device));
+	filename_emulation = g_strdup_printf("%s.emulation", filename);
+	ret = fu_emulation_backend_save(devices, filename_emulation, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* load */
+	backend = fu_emulation_backend_new(filename_emulation);
+	g_signal_connect(backend,
+			 "device-added",
+			 G_CALLBACK(fu_emulation_backend_added_cb),
+			 &device_emulated);
+	ret = fu_backend_coldplug(backend, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_nonnull(device_emulated);
+	g_assert_true(FU_IS_UDEV_DEVICE(device_emulated));
+	g_assert_cmpstr(fu_device_get_physical_id(device_emulated), ==, "/dev/foo");
+	g_assert_cmpint(fu_device_get_events(device_emulated)->len, ==, 3);
+
+	/* replay, without the file */
+	g_unlink(filename);
+	ret = fu_udev_device_pwrite_full(FU_UDEV_DEVICE(device_emulated),
+					 0x0,
+					 (const guint8 *)"abc",
+					 3,
+					 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	memset(buf, 0x0, sizeof(buf));
+	ret = fu_udev_device_pread_full(FU_UDEV_DEVICE(device_emulated),
+					0x0,
+					buf,
+					sizeof(buf),
+					&error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(memcmp(buf, "abc", 3), ==, 0);
+	ret = fu_udev_device_pread_full(FU_UDEV_DEVICE(device_emulated),
+					0x100,
+					buf,
+					sizeof(buf),
+					&error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_FAILED);
+	g_assert_false(ret);
+	g_unlink(filename_emulation);
+}
+#endif
+
+static void
+fu_statistics_func(gconstpointer user_data)
+{
+	FwupdStatistic *statistic;
+	guint64 upper = 0;
+	guint64 count = 0;
+	g_autoptr(FuStatistics) statistics = fu_statistics_new();
+	g_autoptr(GPtrArray) array = NULL;
+
+	fu_statistics_add_counter(statistics, "fwupd_update_failures", "reason", "foo", 1);
+	fu_statistics_add_counter(statistics, "fwupd_update_failures", "reason", "foo", 2);
+	fu_statistics_set_gauge(statistics, "fwupd_metadata_silo_bytes", NULL, NULL, 123);
+	fu_statistics_set_gauge(statistics, "fwupd_metadata_silo_bytes", NULL, NULL, 456);
+	fu_statistics_add_duration(statistics, "fwupd_dbus_method_duration", "method", "A", 1);
+	fu_statistics_add_duration(statistics, "fwupd_dbus_method_duration", "method", "A", 3);
+	fu_statistics_add_duration(statistics, "fwupd_dbus_method_duration", "method", "A", 1000);
+
+	/* sorted by name */
+	array = fu_statistics_get_all(statistics);
+	g_assert_nonnull(array);
+	g_assert_cmpint(array->len, ==, 3);
+	statistic = g_ptr_array_index(array, 0);
+	g_assert_cmpstr(fwupd_statistic_get_name(statistic), ==, "fwupd_dbus_method_duration");
+	g_assert_cmpint(fwupd_statistic_get_kind(statistic), ==, FWUPD_STATISTIC_KIND_HISTOGRAM);
+	g_assert_cmpstr(fwupd_statistic_get_label(statistic, "method"), ==, "A");
+	g_assert_cmpint(fwupd_statistic_get_count(statistic), ==, 3);
+	g_assert_cmpint(fwupd_statistic_get_value(statistic), ==, 1004);
+
+	/* buckets are cumulative and stop at the largest one used */
+	g_assert_cmpint(fwupd_statistic_get_n_buckets(statistic), ==, 11);
+	g_assert_true(fwupd_statistic_get_bucket(statistic, 0, &upper, &count));
+	g_assert_cmpint(upper, ==, 1);
+	g_assert_cmpint(count, ==, 1);
+	g_assert_true(fwupd_statistic_get_bucket(statistic, 2, &upper, &count));
+	g_assert_cmpint(upper, ==, 4);
+	g_assert_cmpint(count, ==, 2);
+	g_assert_true(fwupd_statistic_get_bucket(statistic, 10, &upper, &count));
+	g_assert_cmpint(upper, ==, 1024);
+	g_assert_cmpint(count, ==, 3);
+	g_assert_false(fwupd_statistic_get_bucket(statistic, 11, &upper, &count));
+
+	statistic = g_ptr_array_index(array, 1);
+	g_assert_cmpstr(fwupd_statistic_get_name(statistic), ==, "fwupd_metadata_silo_bytes");
+	g_assert_cmpint(fwupd_statistic_get_kind(statistic), ==, FWUPD_STATISTIC_KIND_GAUGE);
+	g_assert_cmpint(fwupd_statistic_get_value(statistic), ==, 456);
+	statistic = g_ptr_array_index(array, 2);
+	g_assert_cmpstr(fwupd_statistic_get_name(statistic), ==, "fwupd_update_failures");
+	g_assert_cmpint(fwupd_statistic_get_kind(statistic), ==, FWUPD_STATISTIC_KIND_COUNTER);
+	g_assert_cmpint(fwupd_statistic_get_value(statistic), ==, 3);
+}
+
+typedef struct {
+	guint16 port;
+	gchar *checksum;
+	gchar *checksum_sha512;
+	GPtrArray *responses; /* (element-type utf8) */
+	gint done;
+} FuMirrorServerHelper;
+
+static gchar *
+fu_mirror_server_request(guint16 port, const gchar *path, const gchar *headers)
+{
+	gboolean ret;
+	GString *str = g_string_new(NULL);
+	g_autofree gchar *request = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GSocketClient) client = g_socket_client_new();
+	g_autoptr(GSocketConnection) connection = NULL;
+
+	connection = g_socket_client_connect_to_host(client, "127.0.0.1", port, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(connection);
+	request = g_strdup_printf("GET %s HTTP/1.1\r\n"
+				  "Host: localhost\r\n"
+				  "Connection: close\r\n"
+				  "%s\r\n",
+				  path,
+				  headers != NULL ? headers : "");
+	ret = g_output_stream_write_all(g_io_stream_get_output_stream(G_IO_STREAM(connection)),
+					request,
+					strlen(request),
+					NULL,
+					NULL,
+					&error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	for (;;) {
+		gchar buf[1024];
+		GInputStream *istream = g_io_stream_get_input_stream(G_IO_STREAM(connection));
+		gssize sz = g_input_stream_read(istream, buf, sizeof(buf), NULL, &error);
+		g_assert_no_error(error);
+		if (sz <= 0)
+			break;
+		g_string_append_len(str, buf, sz);
+	}
+	return g_string_free(str, FALSE);
+}
+
+static gpointer
+fu_mirror_server_thread_cb(gpointer user_data)
+{
+	FuMirrorServerHelper *helper = (FuMirrorServerHelper *)user_data;
+	g_autofree gchar *path = g_strdup_printf("/checksum/%s", helper->checksum);
+	g_autofree gchar *path_sha512 = g_strdup_printf("/checksum/%s", helper->checksum_sha512);
+	g_autofree gchar *etag = g_strdup_printf("If-None-Match: \"%s\"\r\n", helper->checksum);
+
+	g_ptr_array_add(helper->responses, fu_mirror_server_request(helper->port, path, NULL));
+	g_ptr_array_add(helper->responses,
+			fu_mirror_server_request(helper->port, path, "Range: bytes=2-4\r\n"));
+	g_ptr_array_add(helper->responses, fu_mirror_server_request(helper->port, path, etag));
+	g_ptr_array_add(helper->responses,
+			fu_mirror_server_request(helper->port, "/firmware.bin", NULL));
+	g_ptr_array_add(helper->responses,
+			fu_mirror_server_request(helper->port, "/checksum/deadbeef", NULL));
+	g_ptr_array_add(helper->responses,
+			fu_mirror_server_request(helper->port, path_sha512, NULL));
+	g_atomic_int_set(&helper->done, TRUE);
+	return NULL;
+}
+
+static void
+fu_mirror_server_func(gconstpointer user_data)
+{
+	const gchar *blob = "0123456789";
+	const gchar *response;
+	gboolean ret;
+	g_autofree gchar *tmpdir = NULL;
+	g_autofree gchar *fn = NULL;
+	g_autoptr(FuMirrorServer) server = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GThread) thread = NULL;
+	g_autoptr(GPtrArray) responses = g_ptr_array_new_with_free_func(g_free);
+	FuMirrorServerHelper helper = {.responses = responses};
+
+	tmpdir = g_dir_make_tmp("fwupd-mirror-XXXXXX", &error);
+	g_assert_no_error(error);
+	fn = g_build_filename(tmpdir, "firmware.bin", NULL);
+	ret = g_file_set_contents(fn, blob, -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	helper.checksum = g_compute_checksum_for_string(G_CHECKSUM_SHA256, blob, -1);
+	helper.checksum_sha512 = g_compute_checksum_for_string(G_CHECKSUM_SHA512, blob, -1);
+
+	/* listen on any free port of the loopback interface only */
+	server = fu_mirror_server_new(tmpdir);
+	ret = fu_mirror_server_start(server, "127.0.0.1", 0, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	helper.port = fu_mirror_server_get_port(server);
+	g_assert_cmpint(helper.port, !=, 0);
+
+	/* the listening socket is dispatched from this context */
+	thread = g_thread_new("mirror-client", fu_mirror_server_thread_cb, &helper);
+	while (!g_atomic_int_get(&helper.done))
+		g_main_context_iteration(NULL, FALSE);
+	g_thread_join(g_steal_pointer(&thread));
+	fu_mirror_server_stop(server);
+
+	/* the responses are all saved, so clean up before anything can fail */
+	ret = fu_common_rmtree(tmpdir, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* content addressed */
+	response = g_ptr_array_index(responses, 0);
+	g_assert_true(g_str_has_prefix(response, "HTTP/1.1 200 "));
+	g_assert_true(g_str_has_suffix(response, "\r\n\r\n0123456789"));
+
+	/* partial */
+	response = g_ptr_array_index(responses, 1);
+	g_assert_true(g_str_has_prefix(response, "HTTP/1.1 206 "));
+	g_assert_nonnull(g_strstr_len(response, -1, "Content-Range: bytes 2-4/10\r\n"));
+	g_assert_true(g_str_has_suffix(response, "\r\n\r\n234"));
+
+	/* unchanged */
+	response = g_ptr_array_index(responses, 2);
+	g_assert_true(g_str_has_prefix(response, "HTTP/1.1 304 "));
+
+	/* by basename */
+	response = g_ptr_array_index(responses, 3);
+	g_assert_true(g_str_has_prefix(response, "HTTP/1.1 200 "));
+
+	/* unknown */
+	response = g_ptr_array_index(responses, 4);
+	g_assert_true(g_str_has_prefix(response, "HTTP/1.1 404 "));
+
+	/* the best checksum the client would use */
+	response = g_ptr_array_index(responses, 5);
+	g_assert_true(g_str_has_prefix(response, "HTTP/1.1 200 "));
+	g_assert_true(g_str_has_suffix(response, "\r\n\r\n0123456789"));
+
+	g_free(helper.checksum);
+	g_free(helper.checksum_sha512);
+}
+
 static void
 fu_security_attrs_func(gconstpointer user_data)
 {
@@ -3887,6 +4599,11 @@ main(int argc, char **argv)
 	g_test_add_data_func("/fwupd/memcpy", self, fu_memcpy_func);
 	g_test_add_data_func("/fwupd/security-attr", self, fu_security_attr_func);
 	g_test_add_data_func("/fwupd/security-attrs", self, fu_security_attrs_func);
+	g_test_add_data_func("/fwupd/statistics", self, fu_statistics_func);
+#ifdef HAVE_PWRITE
+	g_test_add_data_func("/fwupd/emulation-backend", self, fu_emulation_backend_func);
+#endif
+	g_test_add_data_func("/fwupd/mirror-server", self, fu_mirror_server_func);
 	g_test_add_data_func("/fwupd/device-list", self, fu_device_list_func);
 	g_test_add_data_func("/fwupd/device-list{delay}", self, fu_device_list_delay_func);
 	g_test_add_data_func("/fwupd/device-list{no-auto-remove-children}",
@@ -3900,6 +4617,10 @@ main(int argc, char **argv)
 			     fu_device_list_remove_chain_func);
 	g_test_add_data_func("/fwupd/release{compare}", self, fu_release_compare_func);
 	g_test_add_data_func("/fwupd/engine{device-unlock}", self, fu_engine_device_unlock_func);
+	g_test_add_data_func("/fwupd/engine{staged}", self, fu_engine_staged_func);
+	g_test_add_data_func("/fwupd/engine{security-attrs}",
+			     self,
+			     fu_engine_security_attrs_func);
 	g_test_add_data_func("/fwupd/engine{multiple-releases}",
 			     self,
 			     fu_engine_multiple_rels_func);
@@ -3977,6 +4698,7 @@ main(int argc, char **argv)
 	g_test_add_data_func("/fwupd/engine{device-auto-parent-guid}",
 			     self,
 			     fu_engine_device_parent_guid_func);
+	g_test_add_data_func("/fwupd/engine{prefetch}", self, fu_engine_prefetch_func);
 	g_test_add_data_func("/fwupd/engine{install-duration}",
 			     self,
 			     fu_engine_install_duration_func);
@@ -3990,6 +4712,12 @@ main(int argc, char **argv)
 	g_test_add_data_func("/fwupd/plugin{composite}", self, fu_plugin_composite_func);
 	g_test_add_data_func("/fwupd/history", self, fu_history_func);
 	g_test_add_data_func("/fwupd/history{migrate}", self, fu_history_migrate_func);
+	g_test_add_data_func("/fwupd/history{security-attrs}",
+			     self,
+			     fu_history_security_attrs_func);
+	g_test_add_data_func("/fwupd/history{progress-profile}",
+			     self,
+			     fu_history_progress_profile_func);
 	g_test_add_data_func("/fwupd/plugin-list", self, fu_plugin_list_func);
 	g_test_add_data_func("/fwupd/plugin-list{depsolve}", self, fu_plugin_list_depsolve_func);
 	return g_test_run();
@@ -0,0 +1,316 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define G_LOG_DOMAIN "FuStatistics"
+
+#include "config.h"
+
+#include "fu-mutex.h"
+#include "fu-statistics.h"
+
+/* bucket N holds durations of up to 2^N µs, so the last one is about 36 minutes */
+#define FU_STATISTICS_BUCKETS_MAX 32
+
+struct _FuStatistics {
+	GObject parent_instance;
+	GHashTable *items; /* (element-type utf8 FuStatisticsItem) */
+	GRWLock items_mutex;
+};
+
+typedef struct {
+	FwupdStatisticKind kind;
+	gchar *name;
+	gchar *label_key;   /* (nullable) */
+	gchar *label_value; /* (nullable) */
+	guint64 value;      /* counter, gauge or sum of the histogram */
+	guint64 count;
+	guint64 buckets[FU_STATISTICS_BUCKETS_MAX]; /* not cumulative */
+} FuStatisticsItem;
+
+G_DEFINE_TYPE(FuStatistics, fu_statistics, G_TYPE_OBJECT)
+
+static void
+fu_statistics_item_free(FuStatisticsItem *item)
+{
+	g_free(item->name);
+	g_free(item->label_key);
+	g_free(item->label_value);
+	g_free(item);
+}
+
+/* the caller must hold the writer lock */
+static FuStatisticsItem *
+fu_statistics_ensure_item(FuStatistics *self,
+			  FwupdStatisticKind kind,
+			  const gchar *name,
+			  const gchar *label_key,
+			  const gchar *label_value)
+{
+	FuStatisticsItem *item;
+	gchar key[256];
+	gint keysz;
+	g_autofree gchar *key_heap = NULL;
+	const gchar *key_str = key;
+
+	/* avoid a heap allocation for each observation in the common case */
+	keysz = g_snprintf(key,
+			   sizeof(key),
+			   "%s|%s=%s",
+			   name,
+			   label_key != NULL ? label_key : "",
+			   label_value != NULL ? label_value : "");
+	if ((gsize)keysz >= sizeof(key)) {
+		key_heap = g_strdup_printf("%s|%s=%s",
+					   name,
+					   label_key != NULL ? label_key : "",
+					   label_value != NULL ? label_value : "");
+		key_str = key_heap;
+	}
+	item = g_hash_table_lookup(self->items, key_str);
+	if (item != NULL) {
+		if (item->kind != kind) {
+			g_critical("statistic %s is %s, not %s",
+				   name,
+				   fwupd_statistic_kind_to_string(item->kind),
+				   fwupd_statistic_kind_to_string(kind));
+			return NULL;
+		}
+		return item;
+	}
+
+	/* first observation */
+	item = g_new0(FuStatisticsItem, 1);
+	item->kind = kind;
+	item->name = g_strdup(name);
+	item->label_key = g_strdup(label_key);
+	item->label_value = g_strdup(label_value);
+	g_hash_table_insert(self->items, g_strdup(key_str), item);
+	return item;
+}
+
+/**
+ * fu_statistics_add_counter:
+ * @self: a #FuStatistics
+ * @name: a statistic name, e.g. `fwupd_update_failures`
+ * @label_key: (nullable): a label key, e.g. `reason`
+ * @label_value: (nullable): a label value, e.g. `not-supported`
+ * @value: the amount to add
+ *
+ * Increments a counter, creating it if required.
+ **/
+void
+fu_statistics_add_counter(FuStatistics *self,
+			  const gchar *name,
+			  const gchar *label_key,
+			  const gchar *label_value,
+			  guint64 value)
+{
+	FuStatisticsItem *item;
+	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new(&self->items_mutex);
+
+	g_return_if_fail(FU_IS_STATISTICS(self));
+	g_return_if_fail(name != NULL);
+
+	item = fu_statistics_ensure_item(self,
+					 FWUPD_STATISTIC_KIND_COUNTER,
+					 name,
+					 label_key,
+					 label_value);
+	if (item == NULL)
+		return;
+	item->value += value;
+}
+
+/**
+ * fu_statistics_set_gauge:
+ * @self: a #FuStatistics
+ * @name: a statistic name, e.g. `fwupd_metadata_silo_bytes`
+ * @label_key: (nullable): a label key
+ * @label_value: (nullable): a label value
+ * @value: the new value
+ *
+ * Sets a gauge, creating it if required.
+ **/
+void
+fu_statistics_set_gauge(FuStatistics *self,
+			const gchar *name,
+			const gchar *label_key,
+			const gchar *label_value,
+			guint64 value)
+{
+	FuStatisticsItem *item;
+	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new(&self->items_mutex);
+
+	g_return_if_fail(FU_IS_STATISTICS(self));
+	g_return_if_fail(name != NULL);
+
+	item = fu_statistics_ensure_item(self,
+					 FWUPD_STATISTIC_KIND_GAUGE,
+					 name,
+					 label_key,
+					 label_value);
+	if (item == NULL)
+		return;
+	item->value = value;
+}
+
+/**
+ * fu_statistics_add_duration:
+ * @self: a #FuStatistics
+ * @name: a statistic name, e.g. `fwupd_dbus_method_duration_microseconds`
+ * @label_key: (nullable): a label key, e.g. `method`
+ * @label_value: (nullable): a label value, e.g. `GetDevices`
+ * @duration: the observed duration in µs
+ *
+ * Adds a duration to a histogram, creating it if required.
+ **/
+void
+fu_statistics_add_duration(FuStatistics *self,
+			   const gchar *name,
+			   const gchar *label_key,
+			   const gchar *label_value,
+			   gint64 duration)
+{
+	FuStatisticsItem *item;
+	guint idx = 0;
+	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new(&self->items_mutex);
+
+	g_return_if_fail(FU_IS_STATISTICS(self));
+	g_return_if_fail(name != NULL);
+
+	/* the monotonic clock never goes backwards, but be careful anyway */
+	if (duration < 0)
+		duration = 0;
+
+	item = fu_statistics_ensure_item(self,
+					 FWUPD_STATISTIC_KIND_HISTOGRAM,
+					 name,
+					 label_key,
+					 label_value);
+	if (item == NULL)
+		return;
+	item->value += (guint64)duration;
+	item->count++;
+
+	/* anything larger than the last bucket is only counted in +Inf */
+	if (duration > 1)
+		idx = g_bit_storage((guint64)duration - 1);
+	if (idx < FU_STATISTICS_BUCKETS_MAX)
+		item->buckets[idx]++;
+}
+
+static FwupdStatistic *
+fu_statistics_item_to_statistic(FuStatisticsItem *item)
+{
+	FwupdStatistic *statistic = fwupd_statistic_new();
+
+	fwupd_statistic_set_name(statistic, item->name);
+	fwupd_statistic_set_kind(statistic, item->kind);
+	if (item->label_key != NULL && item->label_value != NULL)
+		fwupd_statistic_add_label(statistic, item->label_key, item->label_value);
+	fwupd_statistic_set_value(statistic, item->value);
+	if (item->kind == FWUPD_STATISTIC_KIND_HISTOGRAM) {
+		guint idx_max = 0;
+		guint64 cumulative = 0;
+
+		/* only export up to the largest bucket that has been used */
+		for (guint i = 0; i < FU_STATISTICS_BUCKETS_MAX; i++) {
+			if (item->buckets[i] > 0)
+				idx_max = i;
+		}
+		for (guint i = 0; i <= idx_max; i++) {
+			cumulative += item->buckets[i];
+			fwupd_statistic_add_bucket(statistic, (guint64)1 << i, cumulative);
+		}
+		fwupd_statistic_set_count(statistic, item->count);
+	}
+	return statistic;
+}
+
+static gint
+fu_statistics_sort_cb(gconstpointer a, gconstpointer b)
+{
+	FuStatisticsItem *item1 = *((FuStatisticsItem **)a);
+	FuStatisticsItem *item2 = *((FuStatisticsItem **)b);
+	gint rc = g_strcmp0(item1->name, item2->name);
+	if (rc != 0)
+		return rc;
+	return g_strcmp0(item1->label_value, item2->label_value);
+}
+
+/**
+ * fu_statistics_get_all:
+ * @self: a #FuStatistics
+ *
+ * Gets a snapshot of all the statistics, sorted by name.
+ *
+ * Returns: (transfer container) (element-type FwupdStatistic): statistics
+ **/
+GPtrArray *
+fu_statistics_get_all(FuStatistics *self)
+{
+	GPtrArray *array;
+	g_autoptr(GList) values = NULL;
+	g_autoptr(GPtrArray) items = g_ptr_array_new();
+	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new(&self->items_mutex);
+
+	g_return_val_if_fail(FU_IS_STATISTICS(self), NULL);
+
+	values = g_hash_table_get_values(self->items);
+	for (GList *l = values; l != NULL; l = l->next)
+		g_ptr_array_add(items, l->data);
+	g_ptr_array_sort(items, fu_statistics_sort_cb);
+	array = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	for (guint i = 0; i < items->len; i++) {
+		FuStatisticsItem *item = g_ptr_array_index(items, i);
+		g_ptr_array_add(array, fu_statistics_item_to_statistic(item));
+	}
+	return array;
+}
+
+static void
+fu_statistics_init(FuStatistics *self)
+{
+	self->items = g_hash_table_new_full(g_str_hash,
+					    g_str_equal,
+					    g_free,
+					    (GDestroyNotify)fu_statistics_item_free);
+	g_rw_lock_init(&self->items_mutex);
+}
+
+static void
+fu_statistics_finalize(GObject *obj)
+{
+	FuStatistics *self = FU_STATISTICS(obj);
+
+	g_rw_lock_clear(&self->items_mutex);
+	g_hash_table_unref(self->items);
+
+	G_OBJECT_CLASS(fu_statistics_parent_class)->finalize(obj);
+}
+
+static void
+fu_statistics_class_init(FuStatisticsClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_statistics_finalize;
+}
+
+/**
+ * fu_statistics_new:
+ *
+ * Creates a new statistics store. Recording an observation is a single hash table lookup, and
+ * the exported snapshot is only built when fu_statistics_get_all() is called.
+ *
+ * Returns: a #FuStatistics
+ **/
+FuStatistics *
+fu_statistics_new(void)
+{
+	FuStatistics *self;
+	self = g_object_new(FU_TYPE_STATISTICS, NULL);
+	return FU_STATISTICS(self);
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2022 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include <fwupd.h>
+
+#define FU_TYPE_STATISTICS (fu_statistics_get_type())
+G_DECLARE_FINAL_TYPE(FuStatistics, fu_statistics, FU, STATISTICS, GObject)
+
+FuStatistics *
+fu_statistics_new(void);
+void
+fu_statistics_add_counter(FuStatistics *self,
+			  const gchar *name,
+			  const gchar *label_key,
+			  const gchar *label_value,
+			  guint64 value);
+void
+fu_statistics_set_gauge(FuStatistics *self,
+			const gchar *name,
+			const gchar *label_key,
+			const gchar *label_value,
+			guint64 value);
+void
+fu_statistics_add_duration(FuStatistics *self,
+			   const gchar *name,
+			   const gchar *label_key,
+			   const gchar *label_value,
+			   gint64 duration);
+GPtrArray *
+fu_statistics_get_all(FuStatistics *self);
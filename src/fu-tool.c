@@ -32,6 +32,7 @@
 #include "fu-engine.h"
 #include "fu-history.h"
 #include "fu-hwids.h"
+#include "fu-mirror-server.h"
 #include "fu-plugin-private.h"
 #include "fu-progressbar.h"
 #include "fu-security-attr.h"
@@ -2862,7 +2863,7 @@ fu_util_security(FuUtilPrivate *priv, gchar **values, GError **error)
 	g_print("%s\n", str);
 
 	/* print the "when" */
-	events = fu_engine_get_host_security_events(priv->engine, 10, error);
+	events = fu_engine_get_host_security_events(priv->engine, 10, 0, error);
 	if (events == NULL)
 		return FALSE;
 	events_array = fu_security_attrs_get_all(attrs);
@@ -2965,6 +2966,75 @@ fu_util_esp_unmount(FuUtilPrivate *priv, gchar **values, GError **error)
 	return fu_volume_unmount(volume, error);
 }
 
+static gboolean
+fu_util_build_metadata_chunks(FuUtilPrivate *priv, gchar **values, GError **error)
+{
+	g_autofree gchar *filename = NULL;
+	g_autofree gchar *index = NULL;
+	g_autoptr(GBytes) blob = NULL;
+
+	/* check args */
+	if (g_strv_length(values) != 1) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_ARGS,
+				    "Invalid arguments, expected FILENAME");
+		return FALSE;
+	}
+	blob = fu_common_get_contents_bytes(values[0], error);
+	if (blob == NULL)
+		return FALSE;
+
+	/* clients download this from the same location as the metadata */
+	index = fwupd_common_chunk_index_build(blob);
+	filename = g_strdup_printf("%s.chunks", values[0]);
+	return g_file_set_contents(filename, index, -1, error);
+}
+
+static gboolean
+fu_util_serve_mirror(FuUtilPrivate *priv, gchar **values, GError **error)
+{
+	guint64 port = 8080;
+	const gchar *address = NULL;
+	g_autoptr(FuMirrorServer) server = NULL;
+
+	/* check args */
+	if (g_strv_length(values) < 1 || g_strv_length(values) > 3) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_ARGS,
+				    "Invalid arguments, expected DIRECTORY [PORT] [ADDRESS]");
+		return FALSE;
+	}
+	if (!g_file_test(values[0], G_FILE_TEST_IS_DIR)) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_ARGS,
+			    "%s is not a directory",
+			    values[0]);
+		return FALSE;
+	}
+	if (values[1] != NULL) {
+		if (!fu_common_strtoull_full(values[1], &port, 1, G_MAXUINT16, error))
+			return FALSE;
+		address = values[2];
+	}
+
+	/* the listening socket is attached to the thread-default context */
+	server = fu_mirror_server_new(values[0]);
+	g_main_context_push_thread_default(priv->main_ctx);
+	if (!fu_mirror_server_start(server, address, (guint16)port, error)) {
+		g_main_context_pop_thread_default(priv->main_ctx);
+		return FALSE;
+	}
+	/* TRANSLATORS: the port is the TCP port number used by the HTTP server */
+	g_print("%s %u…\n", _("Serving firmware on port"), fu_mirror_server_get_port(server));
+	g_main_loop_run(priv->loop);
+	fu_mirror_server_stop(server);
+	g_main_context_pop_thread_default(priv->main_ctx);
+	return TRUE;
+}
+
 static gboolean
 fu_util_esp_list(FuUtilPrivate *priv, gchar **values, GError **error)
 {
@@ -3177,6 +3247,7 @@ main(int argc, char *argv[])
 	gboolean version = FALSE;
 	gboolean ignore_checksum = FALSE;
 	gboolean ignore_vid_pid = FALSE;
+	gboolean emulation_realtime = FALSE;
 	g_auto(GStrv) plugin_glob = NULL;
 	g_autoptr(FuUtilPrivate) priv = g_new0(FuUtilPrivate, 1);
 	g_autoptr(GError) error_console = NULL;
@@ -3184,6 +3255,8 @@ main(int argc, char *argv[])
 	g_autoptr(GPtrArray) cmd_array = fu_util_cmd_array_new();
 	g_autofree gchar *cmd_descriptions = NULL;
 	g_autofree gchar *filter = NULL;
+	g_autofree gchar *emulation_record = NULL;
+	g_autofree gchar *emulation_replay = NULL;
 	const GOptionEntry options[] = {
 	    {"version",
 	     '\0',
@@ -3297,6 +3370,30 @@ main(int argc, char *argv[])
 	     /* TRANSLATORS: command line option */
 	     N_("Manually enable specific plugins"),
 	     NULL},
+	    {"emulation-record",
+	     '\0',
+	     0,
+	     G_OPTION_ARG_FILENAME,
+	     &emulation_record,
+	     /* TRANSLATORS: command line option */
+	     N_("Save all device interactions so the devices can be emulated"),
+	     NULL},
+	    {"emulation-replay",
+	     '\0',
+	     0,
+	     G_OPTION_ARG_FILENAME,
+	     &emulation_replay,
+	     /* TRANSLATORS: command line option */
+	     N_("Emulate devices using previously saved device interactions"),
+	     NULL},
+	    {"emulation-realtime",
+	     '\0',
+	     0,
+	     G_OPTION_ARG_NONE,
+	     &emulation_realtime,
+	     /* TRANSLATORS: command line option */
+	     N_("Emulate devices with the same timing as when they were saved"),
+	     NULL},
 	    {"prepare",
 	     '\0',
 	     0,
@@ -3634,6 +3731,20 @@ main(int argc, char *argv[])
 			      /* TRANSLATORS: command description */
 			      _("Lists files on the ESP"),
 			      fu_util_esp_list);
+	fu_util_cmd_array_add(cmd_array,
+			      "build-metadata-chunks",
+			      /* TRANSLATORS: command argument: uppercase, spaces->dashes */
+			      _("FILENAME"),
+			      /* TRANSLATORS: command description */
+			      _("Index metadata so clients only download the parts that change"),
+			      fu_util_build_metadata_chunks);
+	fu_util_cmd_array_add(cmd_array,
+			      "serve-mirror",
+			      /* TRANSLATORS: command argument: uppercase, spaces->dashes */
+			      _("DIRECTORY [PORT] [ADDRESS]"),
+			      /* TRANSLATORS: command description */
+			      _("Share a directory of firmware with other hosts on the network"),
+			      fu_util_serve_mirror);
 	fu_util_cmd_array_add(cmd_array,
 			      "switch-branch",
 			      /* TRANSLATORS: command argument: uppercase, spaces->dashes */
@@ -3767,6 +3878,22 @@ main(int argc, char *argv[])
 	for (guint i = 0; plugin_glob != NULL && plugin_glob[i] != NULL; i++)
 		fu_engine_add_plugin_filter(priv->engine, plugin_glob[i]);
 
+	/* save or load all the device interactions */
+	if (emulation_record != NULL) {
+		fu_context_add_flag(fu_engine_get_context(priv->engine),
+				    FU_CONTEXT_FLAG_SAVE_EVENTS);
+	}
+	if (emulation_realtime) {
+		fu_context_add_flag(fu_engine_get_context(priv->engine),
+				    FU_CONTEXT_FLAG_EMULATION_REALTIME);
+	}
+	if (emulation_replay != NULL) {
+		if (!fu_engine_emulation_load(priv->engine, emulation_replay, &error)) {
+			g_printerr("%s\n", error->message);
+			return EXIT_FAILURE;
+		}
+	}
+
 	/* run the specified command */
 	ret = fu_util_cmd_array_run(cmd_array, priv, argv[1], (gchar **)&argv[2], &error);
 	if (!ret) {
@@ -3788,6 +3915,14 @@ main(int argc, char *argv[])
 		return EXIT_FAILURE;
 	}
 
+	/* save the devices so they can be emulated */
+	if (emulation_record != NULL) {
+		if (!fu_engine_emulation_save(priv->engine, emulation_record, &error)) {
+			g_printerr("%s\n", error->message);
+			return EXIT_FAILURE;
+		}
+	}
+
 	/* success */
 	return EXIT_SUCCESS;
 }
@@ -2872,3 +2872,108 @@ fu_util_project_versions_to_string(GHashTable *metadata)
 	}
 	return g_string_free(g_steal_pointer(&str), FALSE);
 }
+
+static void
+fu_util_openmetrics_append_labels(GString *str, FwupdStatistic *statistic, const gchar *le)
+{
+	GHashTable *labels = fwupd_statistic_get_labels(statistic);
+	guint cnt = 0;
+	g_autoptr(GList) keys = g_hash_table_get_keys(labels);
+
+	if (keys == NULL && le == NULL)
+		return;
+	keys = g_list_sort(keys, (GCompareFunc)g_strcmp0);
+	g_string_append(str, "{");
+	for (GList *l = keys; l != NULL; l = l->next) {
+		const gchar *key = l->data;
+		const gchar *value = g_hash_table_lookup(labels, key);
+
+		if (cnt++ > 0)
+			g_string_append(str, ",");
+		g_string_append_printf(str, "%s=\"", key);
+		for (const gchar *tmp = value; *tmp != '\0'; tmp++) {
+			if (*tmp == '\\' || *tmp == '"') {
+				g_string_append_c(str, '\\');
+				g_string_append_c(str, *tmp);
+			} else if (*tmp == '\n') {
+				g_string_append(str, "\\n");
+			} else {
+				g_string_append_c(str, *tmp);
+			}
+		}
+		g_string_append(str, "\"");
+	}
+	if (le != NULL) {
+		if (cnt > 0)
+			g_string_append(str, ",");
+		g_string_append_printf(str, "le=\"%s\"", le);
+	}
+	g_string_append(str, "}");
+}
+
+gchar *
+fu_util_statistics_to_openmetrics(GPtrArray *statistics)
+{
+	const gchar *name_last = NULL;
+	g_autoptr(GString) str = g_string_new(NULL);
+
+	/* the daemon sorts by name, so each metric family is contiguous */
+	for (guint i = 0; i < statistics->len; i++) {
+		FwupdStatistic *statistic = g_ptr_array_index(statistics, i);
+		FwupdStatisticKind kind = fwupd_statistic_get_kind(statistic);
+		const gchar *name = fwupd_statistic_get_name(statistic);
+
+		if (g_strcmp0(name, name_last) != 0) {
+			g_string_append_printf(str,
+					       "# TYPE %s %s\n",
+					       name,
+					       fwupd_statistic_kind_to_string(kind));
+			name_last = name;
+		}
+		if (kind == FWUPD_STATISTIC_KIND_COUNTER) {
+			g_string_append_printf(str, "%s_total", name);
+			fu_util_openmetrics_append_labels(str, statistic, NULL);
+			g_string_append_printf(str,
+					       " %" G_GUINT64_FORMAT "\n",
+					       fwupd_statistic_get_value(statistic));
+			continue;
+		}
+		if (kind == FWUPD_STATISTIC_KIND_HISTOGRAM) {
+			for (guint j = 0; j < fwupd_statistic_get_n_buckets(statistic); j++) {
+				guint64 upper = 0;
+				guint64 count = 0;
+				g_autofree gchar *le = NULL;
+
+				if (!fwupd_statistic_get_bucket(statistic, j, &upper, &count))
+					continue;
+				le = g_strdup_printf("%" G_GUINT64_FORMAT, upper);
+				g_string_append_printf(str, "%s_bucket", name);
+				fu_util_openmetrics_append_labels(str, statistic, le);
+				g_string_append_printf(str, " %" G_GUINT64_FORMAT "\n", count);
+			}
+			g_string_append_printf(str, "%s_bucket", name);
+			fu_util_openmetrics_append_labels(str, statistic, "+Inf");
+			g_string_append_printf(str,
+					       " %" G_GUINT64_FORMAT "\n",
+					       fwupd_statistic_get_count(statistic));
+			g_string_append_printf(str, "%s_count", name);
+			fu_util_openmetrics_append_labels(str, statistic, NULL);
+			g_string_append_printf(str,
+					       " %" G_GUINT64_FORMAT "\n",
+					       fwupd_statistic_get_count(statistic));
+			g_string_append_printf(str, "%s_sum", name);
+			fu_util_openmetrics_append_labels(str, statistic, NULL);
+			g_string_append_printf(str,
+					       " %" G_GUINT64_FORMAT "\n",
+					       fwupd_statistic_get_value(statistic));
+			continue;
+		}
+		g_string_append(str, name);
+		fu_util_openmetrics_append_labels(str, statistic, NULL);
+		g_string_append_printf(str,
+				       " %" G_GUINT64_FORMAT "\n",
+				       fwupd_statistic_get_value(statistic));
+	}
+	g_string_append(str, "# EOF\n");
+	return g_string_free(g_steal_pointer(&str), FALSE);
+}
@@ -156,3 +156,5 @@ gchar *
 fu_util_project_versions_to_string(GHashTable *metadata);
 gboolean
 fu_util_project_versions_as_json(GHashTable *metadata, GError **error);
+gchar *
+fu_util_statistics_to_openmetrics(GPtrArray *statistics);
@@ -27,6 +27,7 @@
 #include "fwupd-plugin-private.h"
 #include "fwupd-release-private.h"
 #include "fwupd-remote-private.h"
+#include "fwupd-statistic-private.h"
 
 #include "fu-plugin-private.h"
 #include "fu-polkit-agent.h"
@@ -637,6 +638,44 @@ fu_util_get_plugins(FuUtilPrivate *priv, gchar **values, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_util_get_statistics_as_json(FuUtilPrivate *priv, GPtrArray *statistics, GError **error)
+{
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+	json_builder_begin_object(builder);
+
+	json_builder_set_member_name(builder, "Statistics");
+	json_builder_begin_array(builder);
+	for (guint i = 0; i < statistics->len; i++) {
+		FwupdStatistic *statistic = g_ptr_array_index(statistics, i);
+		json_builder_begin_object(builder);
+		fwupd_statistic_to_json(statistic, builder);
+		json_builder_end_object(builder);
+	}
+	json_builder_end_array(builder);
+	json_builder_end_object(builder);
+	return fu_util_print_builder(builder, error);
+}
+
+static gboolean
+fu_util_get_statistics(FuUtilPrivate *priv, gchar **values, GError **error)
+{
+	g_autofree gchar *str = NULL;
+	g_autoptr(GPtrArray) statistics = NULL;
+
+	/* get results from daemon */
+	statistics = fwupd_client_get_statistics(priv->client, priv->cancellable, error);
+	if (statistics == NULL)
+		return FALSE;
+	if (priv->as_json)
+		return fu_util_get_statistics_as_json(priv, statistics, error);
+
+	/* print in the OpenMetrics text format */
+	str = fu_util_statistics_to_openmetrics(statistics);
+	g_print("%s", str);
+	return TRUE;
+}
+
 static gchar *
 fu_util_download_if_required(FuUtilPrivate *priv, const gchar *perhapsfn, GError **error)
 {
@@ -1597,6 +1636,7 @@ fu_util_download_metadata(FuUtilPrivate *priv, GError **error)
 	guint devices_supported_cnt = 0;
 	g_autoptr(GPtrArray) devs = NULL;
 	g_autoptr(GPtrArray) remotes = NULL;
+	g_autoptr(GPtrArray) remotes_download = g_ptr_array_new();
 	g_autoptr(GString) str = g_string_new(NULL);
 
 	/* metadata refreshed recently */
@@ -1631,7 +1671,13 @@ fu_util_download_metadata(FuUtilPrivate *priv, GError **error)
 			continue;
 		download_remote_enabled = TRUE;
 		g_print("%s %s\n", _("Updating"), fwupd_remote_get_id(remote));
-		if (!fwupd_client_refresh_remote(priv->client, remote, priv->cancellable, error))
+		g_ptr_array_add(remotes_download, remote);
+	}
+	if (remotes_download->len > 0) {
+		if (!fwupd_client_refresh_remotes(priv->client,
+						  remotes_download,
+						  priv->cancellable,
+						  error))
 			return FALSE;
 	}
 
@@ -4095,6 +4141,12 @@ main(int argc, char *argv[])
 			      /* TRANSLATORS: command description */
 			      _("Gets the configured remotes"),
 			      fu_util_get_remotes);
+	fu_util_cmd_array_add(cmd_array,
+			      "get-statistics",
+			      NULL,
+			      /* TRANSLATORS: command description */
+			      _("Gets runtime statistics from the daemon"),
+			      fu_util_get_statistics);
 	fu_util_cmd_array_add(cmd_array,
 			      "downgrade",
 			      /* TRANSLATORS: command argument: uppercase, spaces->dashes */